@@ -0,0 +1,306 @@
+#ifndef _POSIX_C_SOURCE
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../include/cjson.h"
+
+/*
+	Benchmark harness
+
+	Every input file is parsed (in streaming mode, so NDJSON works
+	as well), the parsed documents are serialized again and the raw
+	text is minified by the transcoder. Each phase is repeated for
+	the requested number of iterations. One JSON object per file is
+	written to stdout:
+
+		file					Input file name
+		bytes, documents		Size of the input and documents it contains
+		iterations
+		parse_mb_s, parse_docs_s
+		serialize_mb_s, serialize_docs_s	MB/s relative to the input size
+		transcode_mb_s
+		allocs_per_doc, alloc_bytes_per_doc	Allocations done by the parser
+		peak_rss_kb				Peak resident set size while processing the file
+
+	Every file is processed in a child process of its own so the peak
+	resident set size is measured per file and not across all files.
+*/
+
+#define BENCH_DEFAULTITERATIONS 3
+
+/*
+	Allocator counting calls and requested bytes
+*/
+struct benchAllocator {
+	struct cjsonSystemAPI base;
+	unsigned long int dwAllocations;
+	unsigned long long int qwBytes;
+};
+static enum cjsonError benchAllocator_Alloc(
+	struct cjsonSystemAPI* lpSelf,
+	unsigned long int dwSize,
+	void** lpDataOut
+) {
+	struct benchAllocator* lpAllocator = (struct benchAllocator*)lpSelf;
+
+	(*lpDataOut) = malloc(dwSize);
+	if((*lpDataOut) == NULL) { return cjsonE_OutOfMemory; }
+	lpAllocator->dwAllocations = lpAllocator->dwAllocations + 1;
+	lpAllocator->qwBytes = lpAllocator->qwBytes + dwSize;
+	return cjsonE_Ok;
+}
+static enum cjsonError benchAllocator_Free(
+	struct cjsonSystemAPI* lpSelf,
+	void* lpObject
+) {
+	free(lpObject);
+	return cjsonE_Ok;
+}
+
+/*
+	Document sinks: either release every document or keep them
+*/
+struct benchDocuments {
+	struct cjsonValue** lpDocuments;
+	unsigned long int dwCount;
+	unsigned long int dwCapacity;
+	int bKeep;
+};
+static enum cjsonError benchDocumentReady(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	struct benchDocuments* lpDocs = (struct benchDocuments*)lpFreeParam;
+	struct cjsonValue** lpNew;
+
+	if(lpDocs->bKeep == 0) {
+		cjsonReleaseValue(lpDocument);
+		lpDocs->dwCount = lpDocs->dwCount + 1;
+		return cjsonE_Ok;
+	}
+
+	if(lpDocs->dwCount == lpDocs->dwCapacity) {
+		lpNew = (struct cjsonValue**)realloc(lpDocs->lpDocuments, sizeof(struct cjsonValue*) * ((lpDocs->dwCapacity == 0) ? 64 : lpDocs->dwCapacity * 2));
+		if(lpNew == NULL) {
+			cjsonReleaseValue(lpDocument);
+			return cjsonE_OutOfMemory;
+		}
+		lpDocs->lpDocuments = lpNew;
+		lpDocs->dwCapacity = (lpDocs->dwCapacity == 0) ? 64 : lpDocs->dwCapacity * 2;
+	}
+	lpDocs->lpDocuments[lpDocs->dwCount] = lpDocument;
+	lpDocs->dwCount = lpDocs->dwCount + 1;
+	return cjsonE_Ok;
+}
+
+/*
+	Output sink that only counts bytes
+*/
+static enum cjsonError benchNullWriter(
+	char* lpData,
+	unsigned long int dwBytesToWrite,
+	unsigned long int* lpBytesWrittenOut,
+	void* lpFreeParam
+) {
+	(*((unsigned long long int*)lpFreeParam)) += dwBytesToWrite;
+	(*lpBytesWrittenOut) = dwBytesToWrite;
+	return cjsonE_Ok;
+}
+
+static double benchNow(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+static long benchPeakRSS(void) {
+	struct rusage usage;
+
+	if(getrusage(RUSAGE_SELF, &usage) != 0) { return 0; }
+	return usage.ru_maxrss;
+}
+
+static enum cjsonError benchParse(const char* lpData, unsigned long int dwLength, struct benchDocuments* lpDocs, struct cjsonSystemAPI* lpSystem) {
+	struct cjsonParser* lpParser;
+	enum cjsonError e;
+	unsigned long int i;
+
+	e = cjsonParserCreate(&lpParser, CJSON_PARSER_FLAG__STREAMINGMODE, &benchDocumentReady, (void*)lpDocs, lpSystem);
+	if(e != cjsonE_Ok) { return e; }
+	for(i = 0; i < dwLength; i=i+1) {
+		e = cjsonParserProcessByte(lpParser, lpData[i]);
+		if(e != cjsonE_Ok) { break; }
+	}
+	cjsonParserRelease(lpParser);
+	return e;
+}
+
+static char* benchReadFile(const char* lpFilename, unsigned long int* lpLengthOut) {
+	FILE* fIn;
+	char* lpData;
+	long lSize;
+
+	fIn = fopen(lpFilename, "rb");
+	if(fIn == NULL) { return NULL; }
+	fseek(fIn, 0, SEEK_END);
+	lSize = ftell(fIn);
+	fseek(fIn, 0, SEEK_SET);
+	lpData = (lSize > 0) ? (char*)malloc((size_t)lSize) : NULL;
+	if((lpData == NULL) || (fread(lpData, 1, (size_t)lSize, fIn) != (size_t)lSize)) {
+		free(lpData);
+		fclose(fIn);
+		return NULL;
+	}
+	fclose(fIn);
+	(*lpLengthOut) = (unsigned long int)lSize;
+	return lpData;
+}
+
+static int benchFile(const char* lpFilename, unsigned long int dwIterations) {
+	struct benchAllocator allocator;
+	struct benchDocuments docs = { NULL, 0, 0, 0 };
+	struct cjsonSerializer* lpSerializer;
+	struct cjsonTranscoder* lpTranscoder;
+	unsigned long long int qwWritten = 0;
+	unsigned long int dwLength = 0;
+	unsigned long int dwDocuments;
+	unsigned long int i;
+	unsigned long int j;
+	enum cjsonError e = cjsonE_Ok;
+	double dStart, dParse, dSerialize, dTranscode, dMB;
+	const char* lpName;
+	char* lpData;
+
+	lpData = benchReadFile(lpFilename, &dwLength);
+	if(lpData == NULL) {
+		fprintf(stderr, "Failed to read %s\n", lpFilename);
+		return 0;
+	}
+	lpName = strrchr(lpFilename, '/');
+	lpName = (lpName == NULL) ? lpFilename : lpName + 1;
+	dMB = (double)dwLength * (double)dwIterations / 1e6;
+
+	/* Parse, documents are released as they arrive */
+	allocator.base.alloc = &benchAllocator_Alloc;
+	allocator.base.free = &benchAllocator_Free;
+	allocator.dwAllocations = 0;
+	allocator.qwBytes = 0;
+	dStart = benchNow();
+	for(i = 0; (i < dwIterations) && (e == cjsonE_Ok); i=i+1) {
+		e = benchParse(lpData, dwLength, &docs, &(allocator.base));
+	}
+	dParse = benchNow() - dStart;
+	dwDocuments = docs.dwCount / dwIterations;
+	if((e != cjsonE_Ok) || (dwDocuments == 0)) {
+		fprintf(stderr, "Failed to parse %s (error %u)\n", lpFilename, (unsigned int)e);
+		free(lpData);
+		return 0;
+	}
+
+	/* Serialize the documents of one parse */
+	docs.dwCount = 0;
+	docs.bKeep = 1;
+	e = benchParse(lpData, dwLength, &docs, NULL);
+	dStart = benchNow();
+	for(i = 0; (i < dwIterations) && (e == cjsonE_Ok); i=i+1) {
+		for(j = 0; (j < docs.dwCount) && (e == cjsonE_Ok); j=j+1) {
+			e = cjsonSerializer_Create(&lpSerializer, &benchNullWriter, (void*)&qwWritten, 0, NULL);
+			if(e != cjsonE_Ok) { break; }
+			e = cjsonSerializer_Serialize(lpSerializer, docs.lpDocuments[j]);
+			cjsonSerializer_Release(lpSerializer);
+		}
+	}
+	dSerialize = benchNow() - dStart;
+	for(j = 0; j < docs.dwCount; j=j+1) { cjsonReleaseValue(docs.lpDocuments[j]); }
+	free(docs.lpDocuments);
+	if(e != cjsonE_Ok) {
+		fprintf(stderr, "Failed to serialize %s (error %u)\n", lpFilename, (unsigned int)e);
+		free(lpData);
+		return 0;
+	}
+
+	/* Minify without building a tree */
+	dStart = benchNow();
+	for(i = 0; (i < dwIterations) && (e == cjsonE_Ok); i=i+1) {
+		e = cjsonTranscoder_Create(&lpTranscoder, &benchNullWriter, (void*)&qwWritten, CJSON_TRANSCODER_FLAG__STREAMINGMODE, NULL);
+		if(e != cjsonE_Ok) { break; }
+		e = cjsonTranscoder_ProcessBytes(lpTranscoder, lpData, dwLength);
+		if(e == cjsonE_Ok) { e = cjsonTranscoder_Finish(lpTranscoder); }
+		cjsonTranscoder_Release(lpTranscoder);
+	}
+	dTranscode = benchNow() - dStart;
+	free(lpData);
+	if(e != cjsonE_Ok) {
+		fprintf(stderr, "Failed to transcode %s (error %u)\n", lpFilename, (unsigned int)e);
+		return 0;
+	}
+
+	printf("{\"file\":\"%s\",\"bytes\":%lu,\"documents\":%lu,\"iterations\":%lu,"
+		"\"parse_mb_s\":%.2f,\"parse_docs_s\":%.1f,"
+		"\"serialize_mb_s\":%.2f,\"serialize_docs_s\":%.1f,"
+		"\"transcode_mb_s\":%.2f,"
+		"\"allocs_per_doc\":%.2f,\"alloc_bytes_per_doc\":%.1f,"
+		"\"peak_rss_kb\":%ld}\n",
+		lpName, dwLength, dwDocuments, dwIterations,
+		dMB / dParse, (double)(dwDocuments * dwIterations) / dParse,
+		dMB / dSerialize, (double)(dwDocuments * dwIterations) / dSerialize,
+		dMB / dTranscode,
+		(double)allocator.dwAllocations / (double)(dwDocuments * dwIterations),
+		(double)allocator.qwBytes / (double)(dwDocuments * dwIterations),
+		benchPeakRSS());
+	fflush(stdout);
+	return 1;
+}
+
+/*
+	Runs benchFile in a forked child so getrusage(RUSAGE_SELF) only
+	sees the memory used for this file
+*/
+static int benchFileIsolated(const char* lpFilename, unsigned long int dwIterations) {
+	pid_t pid;
+	int iStatus;
+
+	fflush(stdout);
+	fflush(stderr);
+	pid = fork();
+	if(pid < 0) {
+		fprintf(stderr, "Failed to fork for %s\n", lpFilename);
+		return 0;
+	}
+	if(pid == 0) {
+		exit((benchFile(lpFilename, dwIterations) != 0) ? 0 : 1);
+	}
+
+	if(waitpid(pid, &iStatus, 0) != pid) { return 0; }
+	return (WIFEXITED(iStatus) && (WEXITSTATUS(iStatus) == 0)) ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+	unsigned long int dwIterations = BENCH_DEFAULTITERATIONS;
+	int iFirst = 1;
+	int bOk = 1;
+	int i;
+
+	if((argc > 2) && (strcmp(argv[1], "-i") == 0)) {
+		dwIterations = strtoul(argv[2], NULL, 10);
+		iFirst = 3;
+	}
+	if((iFirst >= argc) || (dwIterations == 0)) {
+		fprintf(stderr, "Usage: %s [-i ITERATIONS] FILE...\n", argv[0]);
+		return 1;
+	}
+
+	for(i = iFirst; i < argc; i=i+1) {
+		if(benchFileIsolated(argv[i], dwIterations) == 0) { bOk = 0; }
+	}
+	return (bOk != 0) ? 0 : 1;
+}
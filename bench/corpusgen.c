@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+	Deterministic synthetic benchmark corpus
+
+	Writes one file per workload into the output directory. All
+	content is derived from a fixed seed so every run (and every
+	machine) benchmarks the same bytes. The scale argument is the
+	approximate size of every file in MiB.
+
+		twitter.json	Search result with nested user and entity objects
+		numbers.json	Array of integers, negative numbers and doubles
+		deep.json		Array of documents nested 48 levels deep
+		strings.json	Array of long strings with occasional escapes
+		wide.json		Single object with a very large number of keys
+		records.ndjson	One log record per line
+*/
+
+#define CORPUS_SEED 0x9E3779B97F4A7C15ULL
+#define CORPUS_DEEPLEVELS 48
+
+static uint64_t qwState = CORPUS_SEED;
+
+static uint64_t corpusRandom(void) {
+	/* xorshift64* */
+	qwState ^= qwState >> 12;
+	qwState ^= qwState << 25;
+	qwState ^= qwState >> 27;
+	return qwState * 0x2545F4914F6CDD1DULL;
+}
+static unsigned long int corpusRange(unsigned long int dwMax) {
+	return (unsigned long int)(corpusRandom() % dwMax);
+}
+
+static const char* lpWords[] = {
+	"lorem", "ipsum", "dolor", "sit", "amet", "json", "parser", "stream", "buffer", "object",
+	"array", "value", "fast", "small", "memory", "thread", "cache", "vector", "token", "hello"
+};
+#define CORPUS_WORDS (sizeof(lpWords) / sizeof(lpWords[0]))
+
+static void corpusWords(FILE* fOut, unsigned long int dwCount, int bEscapes) {
+	unsigned long int i;
+
+	for(i = 0; i < dwCount; i=i+1) {
+		if(i > 0) { fputc(' ', fOut); }
+		fputs(lpWords[corpusRange(CORPUS_WORDS)], fOut);
+		if((bEscapes != 0) && (corpusRange(16) == 0)) {
+			switch(corpusRange(4)) {
+				case 0:		fputs("\\\"quoted\\\"", fOut); break;
+				case 1:		fputs("\\n", fOut); break;
+				case 2:		fputs("\\u00e9t\\u00e9", fOut); break;
+				default:	fputs("\\\\", fOut); break;
+			}
+		}
+	}
+}
+
+static void corpusTweet(FILE* fOut, unsigned long int dwIndex) {
+	unsigned long int dwHashtags = corpusRange(4);
+	unsigned long int i;
+	unsigned long int dwStart;
+
+	fprintf(fOut, "{\"created_at\":\"Sun Aug 31 00:%02lu:%02lu +0000 2014\",\"id\":%llu,\"id_str\":\"%llu\",\"text\":\"",
+		corpusRange(60), corpusRange(60), 505874924095815680ULL + dwIndex, 505874924095815680ULL + dwIndex);
+	corpusWords(fOut, 6 + corpusRange(14), 1);
+	fprintf(fOut, "\",\"truncated\":false,\"in_reply_to_status_id\":null,\"user\":{\"id\":%lu,\"name\":\"", 1186275104UL + corpusRange(100000));
+	corpusWords(fOut, 2, 0);
+	fprintf(fOut, "\",\"screen_name\":\"user%lu\",\"description\":\"", corpusRange(100000));
+	corpusWords(fOut, corpusRange(12), 1);
+	fprintf(fOut, "\",\"followers_count\":%lu,\"friends_count\":%lu,\"verified\":%s,\"profile_background_color\":\"C0DEED\",\"lang\":\"ja\"},",
+		corpusRange(50000), corpusRange(2000), (corpusRange(10) == 0) ? "true" : "false");
+	fprintf(fOut, "\"geo\":null,\"coordinates\":null,\"entities\":{\"hashtags\":[");
+	for(i = 0; i < dwHashtags; i=i+1) {
+		dwStart = corpusRange(100);
+		fprintf(fOut, "%s{\"text\":\"%s\",\"indices\":[%lu,%lu]}", (i == 0) ? "" : ",", lpWords[corpusRange(CORPUS_WORDS)], dwStart, dwStart + 5);
+	}
+	fprintf(fOut, "],\"urls\":[],\"user_mentions\":[]},\"retweet_count\":%lu,\"favorite_count\":%lu,\"favorited\":false,\"retweeted\":false,\"lang\":\"en\"}",
+		corpusRange(1000), corpusRange(1000));
+}
+
+static void corpusTwitter(FILE* fOut, unsigned long int dwBytes) {
+	unsigned long int i;
+
+	fputs("{\"statuses\":[", fOut);
+	for(i = 0; (unsigned long int)ftell(fOut) < dwBytes; i=i+1) {
+		if(i > 0) { fputc(',', fOut); }
+		corpusTweet(fOut, i);
+	}
+	fprintf(fOut, "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,\"count\":%lu}}", i);
+}
+
+static void corpusNumbers(FILE* fOut, unsigned long int dwBytes) {
+	unsigned long int i;
+
+	fputc('[', fOut);
+	for(i = 0; (unsigned long int)ftell(fOut) < dwBytes; i=i+1) {
+		if(i > 0) { fputc(',', fOut); }
+		switch(corpusRange(4)) {
+			case 0:		fprintf(fOut, "%lu", corpusRange(4000000000UL)); break;
+			case 1:		fprintf(fOut, "-%lu", corpusRange(100000)); break;
+			case 2:		fprintf(fOut, "%lu.%04lu", corpusRange(1000), corpusRange(10000)); break;
+			default:	fprintf(fOut, "%lu.%03lue-%lu", 1 + corpusRange(9), corpusRange(1000), corpusRange(20)); break;
+		}
+	}
+	fputc(']', fOut);
+}
+
+static void corpusDeep(FILE* fOut, unsigned long int dwBytes) {
+	unsigned long int i;
+	unsigned long int j;
+
+	fputc('[', fOut);
+	for(i = 0; (unsigned long int)ftell(fOut) < dwBytes; i=i+1) {
+		if(i > 0) { fputc(',', fOut); }
+		for(j = 0; j < CORPUS_DEEPLEVELS; j=j+1) {
+			if((j % 2) == 0) { fprintf(fOut, "{\"level\":%lu,\"child\":", j); } else { fputc('[', fOut); }
+		}
+		fprintf(fOut, "%lu", i);
+		for(j = CORPUS_DEEPLEVELS; j > 0; j=j-1) {
+			if(((j - 1) % 2) == 0) { fputc('}', fOut); } else { fputs(",null]", fOut); }
+		}
+	}
+	fputc(']', fOut);
+}
+
+static void corpusStrings(FILE* fOut, unsigned long int dwBytes) {
+	unsigned long int i;
+
+	fputc('[', fOut);
+	for(i = 0; (unsigned long int)ftell(fOut) < dwBytes; i=i+1) {
+		if(i > 0) { fputc(',', fOut); }
+		fputc('"', fOut);
+		corpusWords(fOut, 500 + corpusRange(8000), 1);
+		fputc('"', fOut);
+	}
+	fputc(']', fOut);
+}
+
+static void corpusWide(FILE* fOut, unsigned long int dwBytes) {
+	unsigned long int i;
+
+	fputc('{', fOut);
+	for(i = 0; (unsigned long int)ftell(fOut) < dwBytes; i=i+1) {
+		if(i > 0) { fputc(',', fOut); }
+		fprintf(fOut, "\"field_%08lu\":", i);
+		switch(corpusRange(3)) {
+			case 0:		fprintf(fOut, "%lu", corpusRange(1000000)); break;
+			case 1:		fprintf(fOut, "\"%s\"", lpWords[corpusRange(CORPUS_WORDS)]); break;
+			default:	fputs((corpusRange(2) == 0) ? "true" : "null", fOut); break;
+		}
+	}
+	fputc('}', fOut);
+}
+
+static void corpusRecords(FILE* fOut, unsigned long int dwBytes) {
+	unsigned long int i;
+
+	for(i = 0; (unsigned long int)ftell(fOut) < dwBytes; i=i+1) {
+		fprintf(fOut, "{\"ts\":%lu,\"level\":\"%s\",\"host\":\"node-%02lu\",\"latency_ms\":%lu.%02lu,\"status\":%lu,\"msg\":\"",
+			1700000000UL + i, (corpusRange(8) == 0) ? "warn" : "info", corpusRange(32), corpusRange(500), corpusRange(100), (corpusRange(20) == 0) ? 500UL : 200UL);
+		corpusWords(fOut, 3 + corpusRange(10), 1);
+		fprintf(fOut, "\",\"tags\":[\"%s\",\"%s\"]}\n", lpWords[corpusRange(CORPUS_WORDS)], lpWords[corpusRange(CORPUS_WORDS)]);
+	}
+}
+
+static int corpusWrite(const char* lpDirectory, const char* lpName, void (*lpfnGenerate)(FILE*, unsigned long int), unsigned long int dwBytes) {
+	char bPath[1024];
+	FILE* fOut;
+
+	if(snprintf(bPath, sizeof(bPath), "%s/%s", lpDirectory, lpName) >= (int)sizeof(bPath)) { return 0; }
+	fOut = fopen(bPath, "wb");
+	if(fOut == NULL) {
+		fprintf(stderr, "Failed to create %s\n", bPath);
+		return 0;
+	}
+	lpfnGenerate(fOut, dwBytes);
+	fclose(fOut);
+	return 1;
+}
+
+int main(int argc, char* argv[]) {
+	unsigned long int dwBytes;
+	int bOk = 1;
+
+	if((argc < 2) || (argc > 3)) {
+		fprintf(stderr, "Usage: %s OUTPUTDIRECTORY [MIBPERFILE]\n", argv[0]);
+		return 1;
+	}
+	dwBytes = ((argc == 3) ? strtoul(argv[2], NULL, 10) : 1) * 1024UL * 1024UL;
+
+	if(corpusWrite(argv[1], "twitter.json", &corpusTwitter, dwBytes) == 0) { bOk = 0; }
+	if(corpusWrite(argv[1], "numbers.json", &corpusNumbers, dwBytes) == 0) { bOk = 0; }
+	if(corpusWrite(argv[1], "deep.json", &corpusDeep, dwBytes) == 0) { bOk = 0; }
+	if(corpusWrite(argv[1], "strings.json", &corpusStrings, dwBytes) == 0) { bOk = 0; }
+	if(corpusWrite(argv[1], "wide.json", &corpusWide, dwBytes) == 0) { bOk = 0; }
+	if(corpusWrite(argv[1], "records.ndjson", &corpusRecords, dwBytes) == 0) { bOk = 0; }
+
+	return (bOk != 0) ? 0 : 1;
+}
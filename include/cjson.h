@@ -10,6 +10,30 @@
 
 #include <stdint.h>
 
+/*
+	Software prefetch hint used on pointer chasing hot paths
+*/
+#if defined(__GNUC__) || defined(__clang__)
+	#define CJSON_PREFETCH(_x) __builtin_prefetch((const void*)(_x))
+#else
+	#define CJSON_PREFETCH(_x)
+#endif
+
+/*
+	Atomic reference count access (modifications evaluate to the new value).
+	Without compiler support shared values must not be released
+	concurrently from different threads.
+*/
+#if defined(__GNUC__) || defined(__clang__)
+	#define CJSON_ATOMIC_LOAD(_x) __atomic_load_n(&(_x), __ATOMIC_ACQUIRE)
+	#define CJSON_ATOMIC_INCREMENT(_x) __atomic_add_fetch(&(_x), 1, __ATOMIC_RELAXED)
+	#define CJSON_ATOMIC_DECREMENT(_x) __atomic_sub_fetch(&(_x), 1, __ATOMIC_ACQ_REL)
+#else
+	#define CJSON_ATOMIC_LOAD(_x) (_x)
+	#define CJSON_ATOMIC_INCREMENT(_x) ((_x) = (_x) + 1)
+	#define CJSON_ATOMIC_DECREMENT(_x) ((_x) = (_x) - 1)
+#endif
+
 #ifdef __cplusplus
 	extern "C" {
 #endif
@@ -39,6 +63,8 @@ enum cjsonError {
 	cjsonE_Finished								= 6,
 	cjsonE_OkRedeliver							= 7,
 	cjsonE_InvalidState							= 8,
+	cjsonE_TestFailed							= 9,	/* A JSON patch test operation did not match */
+	cjsonE_SchemaViolation						= 10,	/* The parsed document does not match the schema of the parser */
 
 	cjsonE_ImplementationError,
 };
@@ -63,11 +89,249 @@ struct cjsonSystemAPI {
 	cjsonSystemAPI_Free							free;
 };
 
+/*
+	Allocation call sites. The library passes the site of its hot
+	allocations to cjsonSystemAPI_AllocAt which forwards them to
+	an allocation profiler (see below). Any other system API is
+	called as usual.
+*/
+enum cjsonAllocSite {
+	cjsonAllocSite__Other							= 0,
+	cjsonAllocSite__ObjectCreate					= 1,	/* cjsonObject_Create */
+	cjsonAllocSite__ObjectSet						= 2,	/* Bucket entries created by cjsonObject_Set */
+	cjsonAllocSite__ArrayPush						= 3,	/* Array pages */
+	cjsonAllocSite__String							= 4,	/* cjsonString_Create and strings finished by the parser */
+	cjsonAllocSite__ParserStack						= 5,	/* Parser state stack elements */
+	cjsonAllocSite__ParserBuffer					= 6,	/* Parser buffer chain pages and key buffers */
+	cjsonAllocSite__SerializerStack					= 7,	/* Serializer stack entries */
+
+	cjsonAllocSite__Count
+};
+
+enum cjsonError cjsonSystemAPI_AllocAt(
+	struct cjsonSystemAPI* lpSystem,		/* Must not be NULL */
+	enum cjsonAllocSite eSite,
+	unsigned long int dwSize,
+	void** lpDataOut
+);
+
+/*
+	Worker pool used by all parallel operations. The pool
+	itself is opaque (it's implemented on top of the platforms
+	thread library), jobs are described by cjsonWorkerPool_Job
+	structures owned by the submitter.
+
+	Any cjsonSystemAPI used together with a worker pool has to be
+	thread safe.
+*/
+struct cjsonWorkerPool; /* Forward declaration, opaque */
+
+typedef void (*cjsonWorkerPool_JobFunction)(
+	void*										lpParam
+);
+struct cjsonWorkerPool_Job {
+	struct cjsonWorkerPool_Job*					lpNext;
+	cjsonWorkerPool_JobFunction					lpfnJob;
+	void*										lpParam;
+
+	int											bDone;		/* Set by the pool (protected by the pool lock) */
+	int											bDetached;
+};
+
+enum cjsonError cjsonWorkerPool_Create(
+	struct cjsonWorkerPool** lpOut,
+	unsigned long int dwThreadCount,	/* 0 uses one thread per online processor */
+	struct cjsonSystemAPI* lpSystem
+);
+unsigned long int cjsonWorkerPool_ThreadCount(
+	const struct cjsonWorkerPool* lpPool
+);
+enum cjsonError cjsonWorkerPool_Submit(
+	struct cjsonWorkerPool* lpPool,
+	struct cjsonWorkerPool_Job* lpJob
+);
+enum cjsonError cjsonWorkerPool_SubmitDetached(
+	struct cjsonWorkerPool* lpPool,
+	cjsonWorkerPool_JobFunction lpfnJob,
+	void* lpParam
+);
+enum cjsonError cjsonWorkerPool_Wait(
+	struct cjsonWorkerPool* lpPool,
+	struct cjsonWorkerPool_Job* lpJob
+);
+enum cjsonError cjsonWorkerPool_Release(
+	struct cjsonWorkerPool* lpPool
+);
+
+/*
+	Arena allocator. The arena implements cjsonSystemAPI as a bump
+	allocator on top of large blocks requested from the parent
+	system (malloc if NULL). Freeing single allocations is a no-op,
+	all memory is returned at once by cjsonArena_Reset or
+	cjsonArena_Release. An arena is not thread safe.
+*/
+#ifndef CJSON_ARENA_ALIGNMENT
+	#define CJSON_ARENA_ALIGNMENT 16
+#endif
+#define CJSON_ARENA_ALIGN(_x) (((_x) + (CJSON_ARENA_ALIGNMENT - 1)) & ~((unsigned long int)(CJSON_ARENA_ALIGNMENT - 1)))
+
+struct cjsonArena; /* Forward declaration, opaque */
+
+enum cjsonError cjsonArena_Create(
+	struct cjsonArena** lpOut,
+	unsigned long int dwBlockSize,			/* 0 uses the default block size */
+	struct cjsonSystemAPI* lpParentSystem
+);
+struct cjsonSystemAPI* cjsonArena_System(
+	struct cjsonArena* lpArena
+);
+struct cjsonArena* cjsonArena_FromSystem(
+	struct cjsonSystemAPI* lpSystem			/* Returns NULL if the system API is not an arena */
+);
+enum cjsonError cjsonArena_Reserve(
+	struct cjsonArena* lpArena,
+	unsigned long int dwBytes
+);
+unsigned long int cjsonArena_BytesUsed(
+	const struct cjsonArena* lpArena
+);
+void cjsonArena_Reset(
+	struct cjsonArena* lpArena
+);
+enum cjsonError cjsonArena_Release(
+	struct cjsonArena* lpArena
+);
+
+/*
+	Scratch memory of the library internals. Temporary memory (stacks
+	of the tree walks, work lists, lookup tables) is allocated from
+	the system API of the values being processed. Arenas only return
+	memory on reset, so cjsonScratch_System selects the default
+	allocator (NULL) for values inside an arena instead.
+
+	cjsonScratch_Stack is a stack of fixed size frames used by the
+	tree walks instead of recursion. The first segment is supplied
+	by the caller (usually located on the C stack), deeper trees
+	allocate additional segments from the scratch system. Segments
+	are released as soon as they run empty (to the system they have
+	been allocated from), frames never move while they are on the
+	stack.
+*/
+struct cjsonScratch_Segment {
+	struct cjsonScratch_Segment*					lpPrev;
+	struct cjsonSystemAPI*							lpSystem;
+	char*											lpFrames;
+	unsigned long int								dwUsed;
+	unsigned long int								dwCapacity;
+};
+struct cjsonScratch_Stack {
+	struct cjsonScratch_Segment*					lpTop;
+	struct cjsonScratch_Segment						base;
+	struct cjsonSystemAPI*							lpSystem;			/* Scratch system of the next additional segment, may change between pushes */
+	unsigned long int								dwFrameSize;
+	unsigned long int								dwSegmentFrames;
+};
+
+#define CJSON_SCRATCH_EMPTY(_stack)		((_stack)->lpTop->dwUsed == 0)
+#define CJSON_SCRATCH_TOP(_stack)		((void*)((_stack)->lpTop->lpFrames + ((_stack)->lpTop->dwUsed - 1) * (_stack)->dwFrameSize))
+
+struct cjsonSystemAPI* cjsonScratch_System(
+	struct cjsonSystemAPI* lpSystem
+);
+enum cjsonError cjsonScratch_Alloc(
+	struct cjsonSystemAPI* lpScratchSystem,		/* As returned by cjsonScratch_System, NULL uses malloc */
+	unsigned long int dwSize,
+	void** lpOut
+);
+void cjsonScratch_Free(
+	struct cjsonSystemAPI* lpScratchSystem,
+	void* lpBlock								/* NULL is ignored */
+);
+void cjsonScratch_StackInit(
+	struct cjsonScratch_Stack* lpStack,
+	void* lpFirstFrames,						/* Storage of the first segment */
+	unsigned long int dwFrameSize,
+	unsigned long int dwSegmentFrames,			/* Frames of the first and every additional segment */
+	struct cjsonSystemAPI* lpSystem				/* System API of the walked values */
+);
+void* cjsonScratch_Push(
+	struct cjsonScratch_Stack* lpStack			/* Returns the new (uninitialized) top frame, NULL if no segment could be allocated */
+);
+void cjsonScratch_Pop(
+	struct cjsonScratch_Stack* lpStack
+);
+void cjsonScratch_StackRelease(
+	struct cjsonScratch_Stack* lpStack			/* Drops all frames and releases additional segments */
+);
+
+/*
+	Allocation profiler. The profiler implements cjsonSystemAPI on
+	top of a parent system (malloc if NULL) and records allocations
+	by call site: number of allocations and frees, requested bytes,
+	live and peak live bytes and a histogram of power of two size
+	classes (up to 16 bytes, up to 32 bytes, ... the last class
+	collects everything larger).
+
+	With a sample rate of N only allocations whose address hashes
+	into one of N classes are recorded (the decision is made again
+	on free so no header is required), unsampled calls are passed
+	through without taking the profiler lock. Counters are not
+	scaled, multiply by dwSampleRate for estimates. A rate of 1
+	records every allocation exactly.
+
+	The profiler is thread safe. It has to outlive every block
+	allocated through it.
+*/
+#define CJSON_PROFILER_SIZECLASSES				16
+
+struct cjsonProfiler; /* Forward declaration, opaque */
+
+struct cjsonProfiler_SiteStats {
+	uint64_t										qwAllocations;
+	uint64_t										qwFrees;
+	uint64_t										qwBytes;
+	uint64_t										qwLiveBytes;
+	uint64_t										qwPeakLiveBytes;
+	uint64_t										qwSizeClasses[CJSON_PROFILER_SIZECLASSES];
+};
+struct cjsonProfiler_Stats {
+	unsigned long int								dwSampleRate;
+	uint64_t										qwLiveBytes;		/* All sites */
+	uint64_t										qwPeakLiveBytes;
+	struct cjsonProfiler_SiteStats					sites[cjsonAllocSite__Count];
+};
+
+enum cjsonError cjsonProfiler_Create(
+	struct cjsonProfiler** lpOut,
+	unsigned long int dwSampleRate,			/* 1 records every allocation */
+	struct cjsonSystemAPI* lpParentSystem
+);
+struct cjsonSystemAPI* cjsonProfiler_System(
+	struct cjsonProfiler* lpProfiler
+);
+struct cjsonProfiler* cjsonProfiler_FromSystem(
+	struct cjsonSystemAPI* lpSystem			/* Returns NULL if the system API is not a profiler */
+);
+enum cjsonError cjsonProfiler_GetStats(
+	struct cjsonProfiler* lpProfiler,
+	struct cjsonProfiler_Stats* lpStatsOut
+);
+void cjsonProfiler_Reset(
+	struct cjsonProfiler* lpProfiler		/* Clears counters and peaks, live bytes are kept */
+);
+const char* cjsonProfiler_SiteName(
+	enum cjsonAllocSite eSite
+);
+enum cjsonError cjsonProfiler_Release(
+	struct cjsonProfiler* lpProfiler
+);
+
 /*
 	cjsonValue is the base type of all objects.
 */
 struct cjsonValue {
 	enum cjsonElementType				type;					/* Type can be used to cast to the correct type */
+	uint32_t							dwRefCount;				/* Number of owners, 1 unless the value is shared */
 	struct cjsonSystemAPI* 				lpSystem;				/* Reference to system is required to correctly release that object */
 };
 
@@ -106,6 +370,10 @@ struct cjsonString {
 	insertion and deletion than a normal array at
 	only a smaller tradeof for random access. Iteration
 	is nearly as performant as on normal arrays.
+
+	The first page is sized by the expected element count
+	passed at creation, all following pages use the page
+	size of the array.
 */
 struct cjsonArray_Page {
 	struct {
@@ -113,25 +381,57 @@ struct cjsonArray_Page {
 		struct cjsonArray_Page*			lpPrev;
 	} pageList;
 
+	unsigned long int					dwCapacity;
 	unsigned long int					dwUsedEntries;
 	struct cjsonValue*					entries[];
 };
+
+/*
+	Hooks are notified about every element that enters or leaves
+	an array through the cjsonArray_* functions (replacing an
+	element reports the old one as removed before it is released)
+	and once when the array itself is released. They are used to
+	maintain secondary indices and are not copied with the array.
+*/
+enum cjsonArray_HookEvent {
+	cjsonArray_HookEvent__Added,
+	cjsonArray_HookEvent__Removed,
+	cjsonArray_HookEvent__Released				/* The hook has already been detached, the element is NULL */
+};
+struct cjsonArray_Hook;
+typedef void (*cjsonArray_Hook_Callback)(
+	struct cjsonArray_Hook* lpHook,
+	enum cjsonArray_HookEvent event,
+	struct cjsonValue* lpElement
+);
+struct cjsonArray_Hook {
+	struct cjsonArray_Hook*				lpNext;
+	cjsonArray_Hook_Callback			callback;
+};
+
 struct cjsonArray {
 	struct cjsonValue					base;
 
 	unsigned long int 					dwPageSize;
+	unsigned long int					dwFirstPageSize;		/* Capacity of the next first page, reset to dwPageSize once used */
 	unsigned long int					dwElementCount;
 	struct {
 		struct cjsonArray_Page*			lpFirstPage;
 		struct cjsonArray_Page*			lpLastPage;
 	} pageList;
+	struct cjsonArray_Hook*				lpHooks;
 };
 
 /*
 	Objects are key/value stores. Each key has to
 	be unique. They are implemented as hashmaps
 	with a fixed bucket count (at object creation).
+	Keys are hashed with FNV-1a independent of the
+	bucket count, the hash is kept in every entry.
 */
+#define CJSON_OBJECT_HASH_INIT					2166136261U
+#define CJSON_OBJECT_HASH_STEP(_hash, _byte)	((uint32_t)(((_hash) ^ (uint32_t)((uint8_t)(_byte))) * 16777619U))
+
 struct cjsonObject_BucketEntry {
 	struct {
 		struct cjsonObject_BucketEntry	*lpNext;
@@ -139,6 +439,7 @@ struct cjsonObject_BucketEntry {
 	} bucketList;
 
 	struct cjsonValue*					lpValue;
+	uint32_t							dwKeyHash;
 	unsigned long int					dwKeyLength;
 	char								bKey[];
 };
@@ -149,8 +450,7 @@ struct cjsonObject {
 		HashMap implementation
 	*/
 	unsigned long int					dwElementCount;
-	unsigned long int					dwBucketCount;
-	unsigned long int					dwBucketShiftBytes;
+	unsigned long int					dwBucketCount;			/* Always a power of two */
 	struct cjsonObject_BucketEntry*		buckets[];
 };
 
@@ -172,6 +472,45 @@ struct cjsonObject {
 void cjsonReleaseValue(
 	struct cjsonValue* lpValue
 );
+enum cjsonError cjsonReleaseValueAsync(
+	struct cjsonValue* lpValue,
+	struct cjsonWorkerPool* lpReclaimer		/* Released synchronously if NULL */
+);
+
+/*
+	Shared values. A value referenced by more than one owner
+	has to be treated as immutable, cjsonValue_Unshare replaces
+	the passed reference by a private shallow copy (children
+	stay shared) if required.
+*/
+struct cjsonValue* cjsonValue_Retain(
+	struct cjsonValue* lpValue
+);
+unsigned long int cjsonValue_RefCount(
+	const struct cjsonValue* lpValue
+);
+enum cjsonError cjsonValue_Unshare(
+	struct cjsonValue** lpValueInOut
+);
+
+/*
+	Structural comparison. Objects compare independent of their
+	bucket layout, numbers by value independent of their type.
+	Equal values always have equal hashes (for the same seed).
+*/
+int cjsonValue_Equals(
+	const struct cjsonValue* lpA,
+	const struct cjsonValue* lpB
+);
+uint64_t cjsonValue_Hash(
+	const struct cjsonValue* lpValue,
+	uint64_t qwSeed
+);
+enum cjsonError cjsonValue_Clone(
+	const struct cjsonValue* lpSource,
+	struct cjsonSystemAPI* lpSystem,		/* System used for the copy (may be an arena) */
+	struct cjsonValue** lpOut
+);
 
 /*
 	JSON Array access
@@ -180,6 +519,11 @@ enum cjsonError cjsonArray_Create(
 	struct cjsonValue**	lpArrayOut,
 	struct cjsonSystemAPI* lpSystem
 );
+enum cjsonError cjsonArray_CreateSized(
+	struct cjsonValue**	lpArrayOut,
+	unsigned long int dwExpectedElements,	/* Capacity of the first page, 0 uses the default */
+	struct cjsonSystemAPI* lpSystem
+);
 unsigned long int cjsonArray_Length(
 	const struct cjsonValue* lpArray
 );
@@ -197,6 +541,29 @@ enum cjsonError cjsonArray_Push(
 	struct cjsonValue* 	lpArray,
 	struct cjsonValue* 	lpValue
 );
+enum cjsonError cjsonArray_Insert(
+	struct cjsonValue* 	lpArray,
+	unsigned long int 	idx,				/* May be equal to the length to append */
+	struct cjsonValue* 	lpValue
+);
+enum cjsonError cjsonArray_Remove(
+	struct cjsonValue* 	lpArray,
+	unsigned long int 	idx,
+	struct cjsonValue** lpOut				/* Receives the detached value, released if NULL */
+);
+enum cjsonError cjsonArray_PushShared(
+	struct cjsonValue* 	lpArray,
+	struct cjsonValue* 	lpValue			/* Retained, the caller keeps its reference */
+);
+enum cjsonError cjsonArray_Concat(
+	struct cjsonValue* 	lpArray,
+	struct cjsonValue* 	lpOther			/* Ownership is transferred, its elements are appended */
+);
+enum cjsonError cjsonArray_GetMutable(
+	struct cjsonValue* 	lpArray,
+	unsigned long int 	idx,
+	struct cjsonValue** lpOut			/* Unshared before it's returned */
+);
 typedef enum cjsonError (*cjsonArray_Iterate_Callback)(
 	unsigned long int index,
 	struct cjsonValue* lpValue,
@@ -207,6 +574,14 @@ enum cjsonError cjsonArray_Iterate(
 	cjsonArray_Iterate_Callback callback,
 	void* lpFreeParam
 );
+enum cjsonError cjsonArray_AttachHook(
+	struct cjsonValue* lpArray,
+	struct cjsonArray_Hook* lpHook			/* Owned by the caller, has to stay valid until detached or released */
+);
+enum cjsonError cjsonArray_DetachHook(
+	struct cjsonValue* lpArray,
+	struct cjsonArray_Hook* lpHook
+);
 
 /*
 	JSON object access
@@ -215,23 +590,136 @@ enum cjsonError cjsonObject_Create(
 	struct cjsonValue** lpOut,
 	struct cjsonSystemAPI* lpSystem
 );
+enum cjsonError cjsonObject_CreateSized(
+	struct cjsonValue** lpOut,
+	unsigned long int dwExpectedElements,	/* Bucket count is the next power of two */
+	struct cjsonSystemAPI* lpSystem
+);
 enum cjsonError cjsonObject_Set(
 	struct cjsonValue* lpObject,
 	const char* lpKey,
 	unsigned long int dwKeyLength,
 	struct cjsonValue* lpValue
 );
+enum cjsonError cjsonObject_Remove(
+	struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	struct cjsonValue** lpValueOut		/* Receives the detached value, released if NULL */
+);
+enum cjsonError cjsonObject_SetShared(
+	struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	struct cjsonValue* lpValue			/* Retained, the caller keeps its reference */
+);
 enum cjsonError cjsonObject_Get(
 	const struct cjsonValue* lpObject,
 	const char* lpKey,
 	unsigned long int dwKeyLength,
 	struct cjsonValue** lpValueOut
 );
+enum cjsonError cjsonObject_GetMutable(
+	struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	struct cjsonValue** lpValueOut		/* Unshared before it's returned */
+);
 enum cjsonError cjsonObject_HasKey(
 	const struct cjsonValue* lpObject,
 	const char* lpKey,
 	unsigned long int dwKeyLength
 );
+
+/*
+	Prehashed access. The hash has to be the one returned by
+	cjsonObject_HashKey (or built with CJSON_OBJECT_HASH_STEP
+	from CJSON_OBJECT_HASH_INIT), it does not depend on the
+	object so it can be computed once for hot keys. The parser
+	hashes keys while scanning them.
+*/
+uint32_t cjsonObject_HashKey(
+	const char* lpKey,
+	unsigned long int dwKeyLength
+);
+enum cjsonError cjsonObject_SetPrehashed(
+	struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	uint32_t dwKeyHash,
+	struct cjsonValue* lpValue
+);
+enum cjsonError cjsonObject_GetPrehashed(
+	const struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	uint32_t dwKeyHash,
+	struct cjsonValue** lpValueOut
+);
+
+/*
+	Key handles bundle a key with its hash for keys that are looked
+	up repeatedly. The key bytes are referenced, not copied, so they
+	have to outlive the handle (typically a string literal).
+
+	cjsonObject_GetKeys resolves several handles against one object.
+	Small objects are walked once comparing every entry against the
+	handles, for larger ones all bucket heads are prefetched before
+	the chains are walked. Values of missing keys are set to NULL and
+	cjsonE_IndexOutOfBounds is returned after all handles have been
+	resolved.
+*/
+struct cjsonKey {
+	const char*							lpKey;
+	unsigned long int					dwKeyLength;
+	uint32_t							dwKeyHash;
+};
+
+void cjsonKey_Init(
+	struct cjsonKey* lpKeyOut,
+	const char* lpKey,
+	unsigned long int dwKeyLength
+);
+enum cjsonError cjsonObject_GetKey(
+	const struct cjsonValue* lpObject,
+	const struct cjsonKey* lpKey,
+	struct cjsonValue** lpValueOut
+);
+enum cjsonError cjsonObject_ContainsKey(
+	const struct cjsonValue* lpObject,
+	const struct cjsonKey* lpKey
+);
+enum cjsonError cjsonObject_SetKey(
+	struct cjsonValue* lpObject,
+	const struct cjsonKey* lpKey,
+	struct cjsonValue* lpValue
+);
+enum cjsonError cjsonObject_GetKeys(
+	const struct cjsonValue* lpObject,
+	const struct cjsonKey* lpKeys,
+	unsigned long int dwKeyCount,
+	struct cjsonValue** lpValuesOut		/* One slot per handle */
+);
+
+/*
+	Entry level access. Detached entries keep their key and value and
+	can be attached to another object without reallocation as long as
+	both objects use the same system API. The key of an attached entry
+	must not be present in the object.
+*/
+struct cjsonObject_BucketEntry* cjsonObject_FindEntry(
+	const struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength
+);
+void cjsonObject_DetachEntry(
+	struct cjsonValue* lpObject,
+	struct cjsonObject_BucketEntry* lpEntry
+);
+void cjsonObject_AttachEntry(
+	struct cjsonValue* lpObject,
+	struct cjsonObject_BucketEntry* lpEntry
+);
 typedef enum cjsonError (*cjsonObject_Iterate_Callback)(
 	char* lpKey,
 	unsigned long int dwKeyLength,
@@ -278,7 +766,7 @@ enum cjsonError cjsonNumber_SetDouble(
 */
 enum cjsonError cjsonString_Create(
 	struct cjsonValue** lpStringOut,
-	const char* lpData,
+	const char* lpData,						/* If NULL the content is left uninitialized */
 	unsigned long int dwDataLength,
 	struct cjsonSystemAPI* lpSystem
 );
@@ -309,12 +797,303 @@ enum cjsonError cjsonBoolean_Set(
 	int value
 );
 
+/*
+	JSON Patch (RFC 6902). Patches are arrays of operation objects.
+	Operations are applied in place and values are shared with the
+	patch document (no copies). If an operation fails processing
+	stops, previously applied operations are not reverted.
+
+	cjsonDiff creates a patch that transforms A into B. Values in
+	the patch are shared with B.
+*/
+enum cjsonError cjsonPatch_Apply(
+	struct cjsonValue** lpTarget,			/* The root may be replaced */
+	struct cjsonValue* lpPatch
+);
+enum cjsonError cjsonDiff(
+	const struct cjsonValue* lpA,
+	struct cjsonValue* lpB,
+	struct cjsonValue** lpPatchOut,
+	struct cjsonSystemAPI* lpSystem
+);
+
+/*
+	JSON Merge Patch (RFC 7386). The patch is consumed in any case:
+	its members are moved into the target instead of being copied.
+	A patch that is not an object replaces the whole target.
+*/
+enum cjsonError cjsonMergePatch(
+	struct cjsonValue** lpTarget,			/* The root may be replaced */
+	struct cjsonValue* lpPatch				/* Ownership is transferred */
+);
+
+/*
+	Compiled path queries. An expression is either a JSON pointer
+	(RFC 6901, empty or starting with '/') or a JSONPath subset
+	starting with '$':
+
+		.name ['name']		Member of an object
+		[2] [-1]			Array element, negative indices count from the end
+		.* [*]				Every member of an object or element of an array
+		[start:end:step]	Array slice, all parts are optional, step has to be positive
+		..					Recursive descent: the following selector is applied to
+							the value and all of its descendants ($..id, $..*, $..[0])
+
+	Keys are decoded and hashed while compiling, so a compiled path
+	can be evaluated any number of times (also concurrently) without
+	touching the expression again. Arrays are walked page by page
+	instead of by index. Evaluation stacks deeper than one segment
+	are allocated from the system API the path has been compiled
+	with.
+
+	Matches are passed to the callback in document order (object
+	members in bucket order). Any error returned by the callback
+	stops the evaluation and is returned, cjsonE_Finished stops it
+	and is reported as cjsonE_Ok.
+*/
+struct cjsonPath; /* Forward declaration, opaque */
+
+typedef enum cjsonError (*cjsonPath_Callback)(
+	struct cjsonValue* lpValue,
+	void* lpFreeParam
+);
+
+enum cjsonError cjsonPath_Compile(
+	struct cjsonPath** lpOut,
+	const char* lpExpression,
+	unsigned long int dwExpressionLength,
+	struct cjsonSystemAPI* lpSystem
+);
+void cjsonPath_Release(
+	struct cjsonPath* lpPath
+);
+enum cjsonError cjsonPath_Eval(
+	const struct cjsonPath* lpPath,
+	struct cjsonValue* lpRoot,
+	cjsonPath_Callback callback,
+	void* lpFreeParam
+);
+
+/*
+	Secondary indices over arrays (usually arrays of objects). The
+	key of every element is the first match of a path (see above)
+	evaluated relative to the element, elements without a match are
+	not indexed. Keys are compared with cjsonValue_Equals, so numbers
+	match independent of their representation.
+
+	The index attaches a hook to the array and is updated with every
+	element added or removed by the cjsonArray_* functions. Keys that
+	are modified inside an indexed element are not noticed, call
+	cjsonIndex_Rebuild afterwards. If an incremental update fails the
+	index is rebuilt by the next lookup. After the array has been
+	released lookups fail with cjsonE_InvalidState. If several
+	elements share a key one of them is returned.
+*/
+struct cjsonIndex; /* Forward declaration, opaque */
+
+enum cjsonError cjsonIndex_Build(
+	struct cjsonIndex** lpOut,
+	struct cjsonValue* lpArray,
+	const char* lpKeyPath,					/* Relative to the elements, i.e. "/id" or "$.id" */
+	unsigned long int dwKeyPathLength,
+	struct cjsonSystemAPI* lpSystem
+);
+enum cjsonError cjsonIndex_Rebuild(
+	struct cjsonIndex* lpIndex
+);
+void cjsonIndex_Release(
+	struct cjsonIndex* lpIndex				/* Detaches the index from its array */
+);
+enum cjsonError cjsonIndex_Lookup(
+	struct cjsonIndex* lpIndex,
+	const struct cjsonValue* lpKey,
+	struct cjsonValue** lpElementOut		/* cjsonE_IndexOutOfBounds if no element has this key */
+);
+
+/*
+	Columnar representation of arrays of objects (struct of arrays).
+	Every key that occurs in any row becomes a column, its type is
+	chosen from all values of that key:
+
+		Boolean			Only true and false, one byte per row
+		UnsignedLong	Only non negative integers
+		SignedLong		Integers that all fit into a signed long
+		Double			Any other mix of numbers in which all integers
+						are exactly representable (magnitude up to 2^53),
+						other mixes are stored as Value
+		String			Offsets (row count + 1) into one blob, row r spans
+						lpStringBlob[offset[r]] up to lpStringBlob[offset[r+1]]
+		Value			Everything else, values are shared with the source
+		Null			The key only has null values
+
+	Null and missing keys are rows without value. The validity bitmap
+	has a bit set (LSB first) for every row with value and is NULL if
+	all rows have one. The missing bitmap marks rows that don't have
+	the key at all so the inverse conversion restores them as absent
+	instead of null, it's NULL if all rows have the key. Typed vectors
+	contain 0 for rows without value.
+
+	Selections used by the filters are bitmaps of the same layout.
+	Filters clear the bit of every row that does not match, so a
+	selection initialized with all bits set (see
+	CJSON_COLUMN_BITMAPBYTES) can be narrowed by several filters.
+	Rows without value never match.
+*/
+enum cjsonColumn_Type {
+	cjsonColumn_Type__Null,
+	cjsonColumn_Type__Boolean,
+	cjsonColumn_Type__UnsignedLong,
+	cjsonColumn_Type__SignedLong,
+	cjsonColumn_Type__Double,
+	cjsonColumn_Type__String,
+	cjsonColumn_Type__Value
+};
+
+#define CJSON_COLUMN_BITMAPBYTES(_rows)			(((_rows) + 7) / 8)
+#define CJSON_COLUMN_ISSET(_bitmap, _row)		((((_bitmap)[(_row) >> 3]) >> ((_row) & 7)) & 1)
+#define CJSON_COLUMN_HASVALUE(_column, _row)	(((_column)->lpValid == NULL) || CJSON_COLUMN_ISSET((_column)->lpValid, (_row)))
+
+struct cjsonColumn {
+	struct cjsonKey						key;			/* Column name, stored with the column set */
+	enum cjsonColumn_Type				type;
+	unsigned long int					dwRowCount;
+	unsigned long int					dwValueCount;	/* Rows with value */
+
+	uint8_t*							lpValid;
+	uint8_t*							lpMissing;
+	union {
+		uint8_t*						lpBoolean;
+		unsigned long int*				lpULong;
+		signed long int*				lpSLong;
+		double*							lpDouble;
+		unsigned long int*				lpStringOffsets;
+		struct cjsonValue**				lpValue;
+	} data;
+	char*								lpStringBlob;
+};
+struct cjsonColumns {
+	struct cjsonSystemAPI*				lpSystem;
+	unsigned long int					dwRowCount;
+	unsigned long int					dwColumnCount;
+	struct cjsonColumn*					lpColumns;
+	char*								lpNames;
+};
+
+enum cjsonColumn_Compare {
+	cjsonColumn_Compare__Less,
+	cjsonColumn_Compare__LessEqual,
+	cjsonColumn_Compare__Equal,
+	cjsonColumn_Compare__NotEqual,
+	cjsonColumn_Compare__GreaterEqual,
+	cjsonColumn_Compare__Greater
+};
+struct cjsonColumn_Aggregate {
+	unsigned long int					dwCount;		/* Rows with value, minimum and maximum are 0 if there are none */
+	double								dSum;
+	double								dMin;
+	double								dMax;
+};
+
+enum cjsonError cjsonColumns_FromArray(
+	struct cjsonColumns** lpOut,
+	const struct cjsonValue* lpArray,		/* All elements have to be objects */
+	struct cjsonSystemAPI* lpSystem
+);
+enum cjsonError cjsonColumns_ToArray(
+	const struct cjsonColumns* lpColumns,
+	struct cjsonValue** lpArrayOut,
+	struct cjsonSystemAPI* lpSystem
+);
+void cjsonColumns_Release(
+	struct cjsonColumns* lpColumns
+);
+const struct cjsonColumn* cjsonColumns_Find(
+	const struct cjsonColumns* lpColumns,
+	const char* lpName,
+	unsigned long int dwNameLength		/* Returns NULL if there is no such column */
+);
+
+enum cjsonError cjsonColumn_Aggregate(
+	const struct cjsonColumn* lpColumn,		/* Numeric or boolean */
+	const uint8_t* lpSelection,				/* Optional, only selected rows are aggregated */
+	struct cjsonColumn_Aggregate* lpOut
+);
+enum cjsonError cjsonColumn_FilterNumber(
+	const struct cjsonColumn* lpColumn,		/* Numeric or boolean */
+	enum cjsonColumn_Compare eCompare,
+	double dOperand,
+	uint8_t* lpSelection,
+	unsigned long int* lpSelectedOut		/* Optional, selected rows after filtering */
+);
+enum cjsonError cjsonColumn_FilterString(
+	const struct cjsonColumn* lpColumn,
+	const char* lpString,
+	unsigned long int dwStringLength,
+	int bEqual,								/* Keep equal rows if not 0, different rows otherwise */
+	uint8_t* lpSelection,
+	unsigned long int* lpSelectedOut
+);
+
+/*
+	Aggregates over the numeric elements of an array. Elements that
+	are not numbers are skipped. Elements are gathered page by page
+	into blocks of doubles (with a typed loop if a block contains
+	only one kind of number) and aggregated by branch free loops.
+
+	If a worker pool is passed and the array contains at least
+	CJSON_AGGREGATE_PARALLELMINELEMENTS elements the array is split
+	into element ranges that are aggregated in parallel. Partial
+	results are merged in array order, the result does not depend
+	on scheduling.
+
+	Min, Max and Mean fail with cjsonE_IndexOutOfBounds if there
+	is no numeric element.
+*/
+enum cjsonError cjsonArray_Aggregate(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,			/* May be NULL */
+	struct cjsonColumn_Aggregate* lpOut
+);
+enum cjsonError cjsonArray_Sum(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	double* lpSumOut
+);
+enum cjsonError cjsonArray_Min(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	double* lpMinOut
+);
+enum cjsonError cjsonArray_Max(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	double* lpMaxOut
+);
+enum cjsonError cjsonArray_Mean(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	double* lpMeanOut
+);
+enum cjsonError cjsonArray_Count(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	unsigned long int* lpCountOut			/* Numeric elements */
+);
+enum cjsonError cjsonArray_CountIf(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	enum cjsonColumn_Compare eCompare,		/* Numeric element compared to dOperand */
+	double dOperand,
+	unsigned long int* lpCountOut
+);
+
 /*
 	Parser (Deserializer)
 */
 #define CJSON_PARSER_FLAG__STREAMINGMODE		0x00000001	/* Streaming mode allows multiple "root" objects but requires an document callback */
 /* Note that duplicate keys are NOT SUPPORTED CURRENTLY! */
 #define CJSON_PARSER_FLAG__ALLOWDUPLICATEKEYS	0x00000002	/* Silently ignore duplicate keys inside objects and always use the last one. If not set raise an parser error on duplicate keys */
+#define CJSON_PARSER_FLAG__STATISTICS			0x00000004	/* Maintain the statistics block readable by cjsonParser_GetStats */
 
 #define CJSON_PARSER_FLAG__INTERNAL_DONE		0x80000000	/* Used to signal that we are not in streaming mode and have already finished */
 
@@ -328,6 +1107,7 @@ struct cjsonParser_BufferChain {
 	struct cjsonParser_BufferChain_Entry*		lpLast;
 	unsigned long int							dwPageSize;
 	unsigned long int							dwBytesUsed;
+	uint32_t									dwHash;				/* Object key hash of the bytes pushed so far */
 };
 
 enum cjsonParser_StateStackType {
@@ -335,7 +1115,9 @@ enum cjsonParser_StateStackType {
 	cjsonParser_StateStackType__Array,
 	cjsonParser_StateStackType__Number,
 	cjsonParser_StateStackType__String,
-	cjsonParser_StateStackType__Constant
+	cjsonParser_StateStackType__Constant,
+
+	cjsonParser_StateStackType__Count
 };
 
 struct cjsonParser_StateStackElement {
@@ -369,6 +1151,8 @@ struct cjsonParser_StateStackElement_Array {
 	struct cjsonParser_StateStackElement			base;
 	struct cjsonValue*								lpArrayObject;
 	enum cjsonParser_StateStackElement_Array_State	state;
+
+	unsigned long int								dwItemsSchemaNode;	/* Schema of the elements, CJSON_SCHEMA_NODE_ANY without schema */
 };
 
 enum cjsonParser_StateStackElement_Object_State {
@@ -385,6 +1169,11 @@ struct cjsonParser_StateStackElement_Object {
 
 	char*											lpCurrentKey;
 	unsigned long int								dwCurrentKeyLength;
+	uint32_t										dwCurrentKeyHash;
+
+	unsigned long int								dwSchemaNode;		/* Schema of the object, CJSON_SCHEMA_NODE_ANY without schema */
+	unsigned long int								dwValueSchemaNode;	/* Schema of the value of the current key */
+	uint64_t										qwRequiredSeen;		/* Required properties that have been seen */
 };
 
 
@@ -421,6 +1210,39 @@ typedef enum cjsonError (*lpfnCJSONCallback_DocumentReady)(
 	void* lpFreeParam
 );
 
+/*
+	Parser statistics (CJSON_PARSER_FLAG__STATISTICS). Values are
+	counted by their element type when complete, object keys are
+	counted separately. String bytes are the decoded bytes of all
+	strings and keys. Redeliveries are bytes handed to a second
+	state after the first one finished (numbers and their
+	terminating symbol).
+
+	If the library is built with CJSON_PARSER_CYCLECOUNTERS the
+	calls and cycles (rdtsc on x86, nanoseconds elsewhere) of every
+	state handler are measured as well, indexed by
+	cjsonParser_StateStackType with the last entry being the
+	universe between documents. Time spent popping finished
+	children is accounted to the handler that received the byte.
+*/
+#define CJSON_PARSER_STATS_TYPES				(cjsonNull + 1)
+#define CJSON_PARSER_STATS_HANDLERS				6
+
+struct cjsonParser_Stats {
+	uint64_t									qwBytes;
+	uint64_t									qwDocuments;
+	uint64_t									qwValues[CJSON_PARSER_STATS_TYPES];		/* Indexed by enum cjsonElementType */
+	uint64_t									qwKeys;
+	uint64_t									qwStringBytes;
+	uint64_t									qwRedeliveries;
+	unsigned long int							dwMaxStateStackDepth;
+
+	uint64_t									qwHandlerCalls[CJSON_PARSER_STATS_HANDLERS];	/* Only with CJSON_PARSER_CYCLECOUNTERS */
+	uint64_t									qwHandlerCycles[CJSON_PARSER_STATS_HANDLERS];
+};
+
+struct cjsonSchema; /* Forward declaration, see JSON Schema validation */
+
 struct cjsonParser {
 	/*
 		Parser state stack.
@@ -428,12 +1250,23 @@ struct cjsonParser {
 	struct cjsonParser_StateStackElement*		lpStateStack;
 	unsigned long int							dwStateStackDepth;
 	struct cjsonValue*							lpChildResult;		/* The result of the last child parsed (if any). Also used for the last document (!) */
+	uint32_t									dwChildKeyHash;		/* Object key hash of lpChildResult if it's a string */
 
 	/* Configuration */
 	uint32_t									dwFlags;
 	struct cjsonSystemAPI*						lpSystem;
 	lpfnCJSONCallback_DocumentReady 			callbackDocumentReady;
 	void* 										callbackDocumentReadyFreeParam;
+	const struct cjsonSchema*					lpSchema;			/* Validated while parsing if not NULL */
+
+	struct cjsonParser_Stats					stats;				/* Only maintained with CJSON_PARSER_FLAG__STATISTICS */
+
+	/* Scratch that is recycled instead of released, kept by cjsonParserReset */
+	struct cjsonParser_StateStackElement*		lpFreeStates[cjsonParser_StateStackType__Count];
+	struct cjsonParser_BufferChain_Entry*		lpFreePages;
+	unsigned long int							dwFreePages;
+
+	struct cjsonParser*							lpPoolNext;			/* Used by the thread local parser pool */
 };
 
 
@@ -453,6 +1286,170 @@ enum cjsonError cjsonParserProcessByte(
 enum cjsonError cjsonParserRelease(
 	struct cjsonParser* lpParser
 );
+/*
+	Returns the parser to the state right after creation. A partially
+	parsed document is dropped, statistics are cleared. Flags,
+	callback and schema are kept as well as the recycled state stack
+	elements and string pages, so a reset parser parses the next
+	document without allocating scratch memory.
+*/
+enum cjsonError cjsonParserReset(
+	struct cjsonParser* lpParser
+);
+enum cjsonError cjsonParserSetSchema(
+	struct cjsonParser* lpParser,
+	const struct cjsonSchema* lpSchema		/* Has to stay valid while the parser is used, NULL disables validation */
+);
+enum cjsonError cjsonParser_GetStats(
+	const struct cjsonParser* lpParser,
+	struct cjsonParser_Stats* lpStatsOut	/* Fails with cjsonE_InvalidState without CJSON_PARSER_FLAG__STATISTICS */
+);
+
+/*
+	Thread local parser pool. Acquire hands out a warm parser of the
+	calling thread that has been created with the same system API
+	(or creates a new one) and configures it like cjsonParserCreate.
+	Return resets the parser and keeps a few of them per thread,
+	they are released when the thread exits or by Flush. Flush has
+	to be called before a system API that's used by cached parsers
+	is destroyed.
+*/
+enum cjsonError cjsonParserPool_Acquire(
+	struct cjsonParser** lpOut,
+	uint32_t dwFlags,
+
+	lpfnCJSONCallback_DocumentReady callbackDocumentReady,
+	void* callbackDocumentReadyFreeParam,
+
+	struct cjsonSystemAPI* lpSystem
+);
+enum cjsonError cjsonParserPool_Return(
+	struct cjsonParser* lpParser
+);
+void cjsonParserPool_Flush(void);
+
+/*
+	Parallel NDJSON parsing. The buffer (for example a mapped file)
+	is cut into chunks at newlines. A first parallel pass tracks
+	string state for every chunk so only newlines outside of
+	strings are used as boundaries. Every chunk is then parsed by
+	its own streaming parser on the worker pool. Records must not
+	span lines: a newline outside of a string that doesn't complete
+	a record is reported as cjsonE_EncodingError, independent of
+	how the buffer has been split.
+
+	With CJSON_PARALLELPARSER_FLAG__ORDERED documents are collected
+	per chunk and passed to the callback in input order on the
+	calling thread. Without it the callback is invoked directly by
+	the workers as soon as a document is complete, concurrently and
+	in any order, so it has to be thread safe. The system API has
+	to be thread safe as well. Without worker pool the buffer is
+	parsed on the calling thread.
+*/
+#define CJSON_PARALLELPARSER_FLAG__ORDERED				0x00000001
+#define CJSON_PARALLELPARSER_FLAG__ALLOWDUPLICATEKEYS	CJSON_PARSER_FLAG__ALLOWDUPLICATEKEYS
+
+enum cjsonError cjsonParallelParser_ParseNdjson(
+	const char* lpData,
+	unsigned long int dwLength,
+	uint32_t dwFlags,
+
+	lpfnCJSONCallback_DocumentReady callbackDocumentReady,
+	void* callbackDocumentReadyFreeParam,
+
+	struct cjsonWorkerPool* lpPool,			/* May be NULL */
+	struct cjsonSystemAPI* lpSystem
+);
+
+/*
+	Parallel parsing of a single large top-level array. A structural
+	pass tracks string state and nesting depth per chunk so the
+	buffer can be split at commas between top-level elements. Every
+	range of elements is parsed on the worker pool into an array of
+	its own.
+
+	With lpArrayOut the ranges are stitched in input order into one
+	array by moving their pages. Otherwise every element is passed
+	to callbackElement, either in order on the calling thread
+	(CJSON_PARALLELPARSER_FLAG__ORDERED) or concurrently by the
+	workers. Exactly one of lpArrayOut and callbackElement has to be
+	set.
+*/
+enum cjsonError cjsonParallelParser_ParseArray(
+	const char* lpData,
+	unsigned long int dwLength,
+	uint32_t dwFlags,
+
+	struct cjsonValue** lpArrayOut,
+	lpfnCJSONCallback_DocumentReady callbackElement,
+	void* callbackElementFreeParam,
+
+	struct cjsonWorkerPool* lpPool,			/* May be NULL */
+	struct cjsonSystemAPI* lpSystem
+);
+
+/*
+	JSON Schema validation
+
+	A schema document is compiled once into a table of nodes and
+	attached to any number of parsers. The parser checks every value
+	against its node while reading: the type when the first byte
+	of a value is seen, keys (additionalProperties) as soon as they
+	are complete, scalar constraints and enum when a value is
+	complete and required properties at the end of an object. The
+	first violation aborts the parse with cjsonE_SchemaViolation.
+
+	Supported keywords are type, properties, required,
+	additionalProperties, items (single schema), enum, const,
+	minimum, maximum, exclusiveMinimum, exclusiveMaximum (numeric)
+	and maxLength. Annotations ($schema, $id, $comment, title,
+	description, default, examples, format) are ignored, any other
+	keyword fails compilation with cjsonE_InvalidParam.
+*/
+#define CJSON_SCHEMA_NODE_ANY					(~0UL)			/* Accepts everything (true schema) */
+#define CJSON_SCHEMA_NODE_NONE					(~0UL - 1)		/* Rejects everything (false schema) */
+#define CJSON_SCHEMA_MAXREQUIRED				64				/* Required properties per object */
+#define CJSON_SCHEMA_MAXDEPTH					64				/* Nesting of schema objects */
+
+enum cjsonError cjsonSchema_Compile(
+	struct cjsonSchema** lpOut,
+	const struct cjsonValue* lpSchemaDocument,
+	struct cjsonSystemAPI* lpSystem
+);
+void cjsonSchema_Release(
+	struct cjsonSchema* lpSchema
+);
+
+/*
+	Node level checks used by the parser. The root node is 0.
+*/
+enum cjsonError cjsonSchema_CheckStart(
+	const struct cjsonSchema* lpSchema,
+	unsigned long int dwNode,
+	enum cjsonElementType eType				/* Numbers are passed as cjsonNumber_Double */
+);
+enum cjsonError cjsonSchema_CheckKey(
+	const struct cjsonSchema* lpSchema,
+	unsigned long int dwNode,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	unsigned long int* lpValueNodeOut,
+	uint64_t* lpRequiredSeenInOut
+);
+enum cjsonError cjsonSchema_CheckRequired(
+	const struct cjsonSchema* lpSchema,
+	unsigned long int dwNode,
+	uint64_t qwRequiredSeen
+);
+enum cjsonError cjsonSchema_CheckValue(
+	const struct cjsonSchema* lpSchema,
+	unsigned long int dwNode,
+	const struct cjsonValue* lpValue
+);
+unsigned long int cjsonSchema_Items(
+	const struct cjsonSchema* lpSchema,
+	unsigned long int dwNode
+);
 
 /*
 	Serializer
@@ -463,7 +1460,8 @@ enum cjsonSerializer_StackEntryType {
 	cjsonSerializer_StackEntryType__Constant,
 	cjsonSerializer_StackEntryType__Number,
 	cjsonSerializer_StackEntryType__Object,
-	cjsonSerializer_StackEntryType__String
+	cjsonSerializer_StackEntryType__String,
+	cjsonSerializer_StackEntryType__Parallel
 };
 struct cjsonSerializer_StackEntry {
 	enum cjsonSerializer_StackEntryType				type;
@@ -536,6 +1534,60 @@ struct cjsonSerializer_Number {
 	char											bString[];
 };
 
+/*
+	Parallel serialization of large arrays and objects. The
+	container is split into chunks (ranges of array pages or
+	object buckets) that are serialized into private buffers
+	by the worker pool. The buffers are then passed to the
+	write callback in order so the output is byte identical
+	to the sequential path.
+*/
+enum cjsonSerializer_Parallel_State {
+	cjsonSerializer_Parallel_State__Header,
+	cjsonSerializer_Parallel_State__Separator,
+	cjsonSerializer_Parallel_State__Chunk,
+	cjsonSerializer_Parallel_State__Trailer
+};
+struct cjsonSerializer_ParallelChunk {
+	struct cjsonWorkerPool_Job						job;
+	struct cjsonSerializer*							lpSerializer;		/* Parent serializer (flags, system API) */
+	struct cjsonValue*								lpContainer;
+	unsigned long int								dwDepth;			/* State stack depth of the container */
+
+	/* Range of an array chunk */
+	struct cjsonArray_Page*							lpFirstPage;
+	unsigned long int								dwFirstEntry;
+	unsigned long int								dwElementCount;
+
+	/* Range of an object chunk */
+	unsigned long int								dwFirstBucket;
+	unsigned long int								dwBucketCount;
+
+	char*											lpBuffer;
+	unsigned long int								dwBufferSize;
+	unsigned long int								dwBufferUsed;
+	enum cjsonError									eResult;
+	int												bSubmitted;
+};
+struct cjsonSerializer_Parallel {
+	struct cjsonSerializer_StackEntry				base;
+	struct cjsonValue*								lpContainer;
+	enum cjsonSerializer_Parallel_State				state;
+	unsigned long int								dwBytesWritten;		/* Used for header, separator, chunk and trailer */
+	int												bChunkWritten;		/* At least one non empty chunk has been emitted */
+
+	unsigned long int								dwChunkCount;
+	unsigned long int								dwNextSubmit;
+	unsigned long int								dwNextWrite;
+
+	/* Cursor used to cut the next array chunk */
+	struct cjsonArray_Page*							lpCursorPage;
+	unsigned long int								dwCursorEntry;
+
+	unsigned long int								dwWindow;			/* Number of chunks that may be in flight */
+	struct cjsonSerializer_ParallelChunk			chunks[];			/* Ring buffer indexed by chunk number modulo dwWindow */
+};
+
 struct cjsonSerializer {
 	struct cjsonSerializer_StackEntry*				lpTopOfStack;
 	struct cjsonSystemAPI*							lpSystem;
@@ -544,6 +1596,8 @@ struct cjsonSerializer {
 
 	cjsonSerializer_Callback_WriteBytes				callbackWriteBytes;
 	void*											callbackWriteBytesParam;
+
+	struct cjsonWorkerPool*							lpWorkerPool;		/* If set large containers are serialized in parallel */
 };
 
 enum cjsonError cjsonSerializer_Create(
@@ -560,10 +1614,582 @@ enum cjsonError cjsonSerializer_Serialize(
 enum cjsonError cjsonSerializer_Continue(
 	struct cjsonSerializer* lpSerializer
 );
+enum cjsonError cjsonSerializer_SetWorkerPool(
+	struct cjsonSerializer* lpSerializer,
+	struct cjsonWorkerPool* lpPool		/* NULL disables parallel serialization */
+);
 enum cjsonError cjsonSerializer_Release(
 	struct cjsonSerializer* lpSerializer
 );
 
+/*
+	CBOR (RFC 8949) encoder and decoder
+
+	The encoder follows the serializer model: the write callback may
+	accept less bytes than offered and return an error, encoding is
+	then resumed by cjsonCborEncoder_Continue. Containers are always
+	encoded with definite length, doubles that are exactly
+	representable as single precision floats are stored as such.
+
+	The decoder accepts bytes incrementally like the parser and
+	delivers every finished document to the document callback.
+	Indefinite length arrays, maps and text strings are supported,
+	tags are skipped. Byte strings and non text map keys have no JSON
+	representation and are rejected with cjsonE_EncodingError. Text
+	strings are allocated when their length is announced, strings
+	longer than CJSON_CBOR_MAXTEXTLENGTH are rejected the same way.
+*/
+#define CJSON_CBOR_FLAG__STREAMINGMODE			0x00000001	/* Accept a CBOR sequence (RFC 8742) instead of a single document */
+#define CJSON_CBOR_FLAG__INTERNAL_DONE			0x80000000	/* Not in streaming mode and the document has been delivered */
+
+struct cjsonCborEncoder_Frame {
+	struct cjsonValue*								lpContainer;
+
+	/* Array cursor */
+	struct cjsonArray_Page*							lpPage;
+	unsigned long int								dwEntry;
+
+	/* Object cursor (entry whose key has been written last) */
+	unsigned long int								dwBucket;
+	struct cjsonObject_BucketEntry*					lpEntry;
+};
+struct cjsonCborEncoder {
+	struct cjsonCborEncoder_Frame*					lpFrames;
+	unsigned long int								dwFrameCount;
+	unsigned long int								dwFrameCapacity;
+
+	/* Pending output: header of the current item followed by its payload */
+	uint8_t											bHeader[9];
+	unsigned long int								dwHeaderLength;
+	unsigned long int								dwHeaderWritten;
+	const char*										lpPayload;
+	unsigned long int								dwPayloadLength;
+	unsigned long int								dwPayloadWritten;
+	struct cjsonValue*								lpPendingValue;		/* Value following the key that is currently written */
+
+	uint32_t										dwFlags;
+	struct cjsonSystemAPI*							lpSystem;
+	cjsonSerializer_Callback_WriteBytes				callbackWriteBytes;
+	void*											callbackWriteBytesParam;
+};
+
+enum cjsonCborDecoder_State {
+	cjsonCborDecoder_State__Header,
+	cjsonCborDecoder_State__Argument,
+	cjsonCborDecoder_State__Payload
+};
+enum cjsonCborDecoder_FrameType {
+	cjsonCborDecoder_FrameType__Array,
+	cjsonCborDecoder_FrameType__Map,
+	cjsonCborDecoder_FrameType__Text				/* Chunks of an indefinite length text string */
+};
+struct cjsonCborDecoder_Frame {
+	enum cjsonCborDecoder_FrameType					type;
+	int												bIndefinite;
+	uint64_t										qwRemaining;		/* Items (arrays) or pairs (maps) left for definite length containers */
+
+	struct cjsonValue*								lpContainer;
+	struct cjsonValue*								lpKey;				/* Key string waiting for its value */
+
+	char*											lpBuffer;			/* Concatenated text chunks */
+	unsigned long int								dwBufferUsed;
+	unsigned long int								dwBufferSize;
+};
+struct cjsonCborDecoder {
+	struct cjsonCborDecoder_Frame*					lpFrames;
+	unsigned long int								dwFrameCount;
+	unsigned long int								dwFrameCapacity;
+
+	enum cjsonCborDecoder_State						state;
+	uint8_t											bInitialByte;
+	unsigned long int								dwArgumentBytes;	/* Argument bytes still missing */
+	uint64_t										qwArgument;
+
+	struct cjsonValue*								lpString;			/* Definite length string that is filled */
+	char*											lpPayloadTarget;
+	unsigned long int								dwPayloadLength;
+	unsigned long int								dwPayloadUsed;
+
+	uint32_t										dwFlags;
+	struct cjsonSystemAPI*							lpSystem;
+	lpfnCJSONCallback_DocumentReady					callbackDocumentReady;
+	void*											callbackDocumentReadyFreeParam;
+};
+
+enum cjsonError cjsonCborEncoder_Create(
+	struct cjsonCborEncoder** lpOut,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam,
+	uint32_t dwFlags,
+	struct cjsonSystemAPI* lpSystem
+);
+enum cjsonError cjsonCborEncoder_Encode(
+	struct cjsonCborEncoder* lpEncoder,
+	struct cjsonValue* lpValue
+);
+enum cjsonError cjsonCborEncoder_Continue(
+	struct cjsonCborEncoder* lpEncoder
+);
+enum cjsonError cjsonCborEncoder_Release(
+	struct cjsonCborEncoder* lpEncoder
+);
+
+enum cjsonError cjsonCborDecoder_Create(
+	struct cjsonCborDecoder** lpOut,
+	uint32_t dwFlags,
+	lpfnCJSONCallback_DocumentReady callbackDocumentReady,
+	void* callbackDocumentReadyFreeParam,
+	struct cjsonSystemAPI* lpSystem
+);
+enum cjsonError cjsonCborDecoder_ProcessByte(
+	struct cjsonCborDecoder* lpDecoder,
+	char bByte
+);
+enum cjsonError cjsonCborDecoder_ProcessBytes(
+	struct cjsonCborDecoder* lpDecoder,
+	const char* lpData,
+	unsigned long int dwDataLength
+);
+enum cjsonError cjsonCborDecoder_Release(
+	struct cjsonCborDecoder* lpDecoder
+);
+
+/*
+	MessagePack encoder and decoder
+
+	The encoder collects output in an internal buffer that is passed
+	to the write callback whenever it's full (long strings are passed
+	directly). The callback contract is the same as for the serializer,
+	cjsonMsgpackEncoder_Continue resumes after a partial write.
+
+	The decoder accepts input across arbitrary byte boundaries.
+	Unsigned formats (positive fixint, uint 8 to 64) are decoded as
+	unsigned long, signed formats (negative fixint, int 8 to 64) as
+	signed long. Binary and extension types as well as non string map
+	keys are rejected with cjsonE_EncodingError. Strings announcing
+	more than CJSON_MSGPACK_MAXSTRLENGTH bytes are rejected the same way.
+*/
+#define CJSON_MSGPACK_FLAG__STREAMINGMODE		0x00000001	/* Accept a stream of concatenated messages */
+#define CJSON_MSGPACK_FLAG__INTERNAL_DONE		0x80000000	/* Not in streaming mode and the message has been delivered */
+
+#ifndef CJSON_MSGPACK_BUFFERSIZE
+	#define CJSON_MSGPACK_BUFFERSIZE 4096		/* Size of the encoder output buffer */
+#endif
+
+struct cjsonMsgpackEncoder_Frame {
+	struct cjsonValue*								lpContainer;
+
+	/* Array cursor */
+	struct cjsonArray_Page*							lpPage;
+	unsigned long int								dwEntry;
+
+	/* Object cursor */
+	unsigned long int								dwBucket;
+	struct cjsonObject_BucketEntry*					lpEntry;
+	int												bValuePending;		/* Key of lpEntry has been written */
+};
+struct cjsonMsgpackEncoder {
+	struct cjsonMsgpackEncoder_Frame*				lpFrames;
+	unsigned long int								dwFrameCount;
+	unsigned long int								dwFrameCapacity;
+
+	/* Buffered output, long strings are written directly after the buffer has been flushed */
+	char											bBuffer[CJSON_MSGPACK_BUFFERSIZE];
+	unsigned long int								dwBufferUsed;
+	unsigned long int								dwBufferWritten;
+	const char*										lpPayload;
+	unsigned long int								dwPayloadLength;
+	unsigned long int								dwPayloadWritten;
+
+	uint32_t										dwFlags;
+	struct cjsonSystemAPI*							lpSystem;
+	cjsonSerializer_Callback_WriteBytes				callbackWriteBytes;
+	void*											callbackWriteBytesParam;
+};
+
+enum cjsonMsgpackDecoder_State {
+	cjsonMsgpackDecoder_State__Header,
+	cjsonMsgpackDecoder_State__Argument,
+	cjsonMsgpackDecoder_State__Payload
+};
+struct cjsonMsgpackDecoder_Frame {
+	struct cjsonValue*								lpContainer;		/* Array or object */
+	struct cjsonValue*								lpKey;				/* Key string waiting for its value */
+	unsigned long int								dwRemaining;		/* Elements (arrays) or pairs (maps) left */
+};
+struct cjsonMsgpackDecoder {
+	struct cjsonMsgpackDecoder_Frame*				lpFrames;
+	unsigned long int								dwFrameCount;
+	unsigned long int								dwFrameCapacity;
+
+	enum cjsonMsgpackDecoder_State					state;
+	uint8_t											bFormat;
+	unsigned long int								dwArgumentBytes;	/* Argument bytes still missing */
+	uint64_t										qwArgument;
+
+	struct cjsonValue*								lpString;			/* String that is filled */
+	unsigned long int								dwPayloadUsed;
+
+	uint32_t										dwFlags;
+	struct cjsonSystemAPI*							lpSystem;
+	lpfnCJSONCallback_DocumentReady					callbackDocumentReady;
+	void*											callbackDocumentReadyFreeParam;
+};
+
+enum cjsonError cjsonMsgpackEncoder_Create(
+	struct cjsonMsgpackEncoder** lpOut,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam,
+	uint32_t dwFlags,
+	struct cjsonSystemAPI* lpSystem
+);
+enum cjsonError cjsonMsgpackEncoder_Encode(
+	struct cjsonMsgpackEncoder* lpEncoder,
+	struct cjsonValue* lpValue
+);
+enum cjsonError cjsonMsgpackEncoder_Continue(
+	struct cjsonMsgpackEncoder* lpEncoder
+);
+enum cjsonError cjsonMsgpackEncoder_Release(
+	struct cjsonMsgpackEncoder* lpEncoder
+);
+
+enum cjsonError cjsonMsgpackDecoder_Create(
+	struct cjsonMsgpackDecoder** lpOut,
+	uint32_t dwFlags,
+	lpfnCJSONCallback_DocumentReady callbackDocumentReady,
+	void* callbackDocumentReadyFreeParam,
+	struct cjsonSystemAPI* lpSystem
+);
+enum cjsonError cjsonMsgpackDecoder_ProcessByte(
+	struct cjsonMsgpackDecoder* lpDecoder,
+	char bByte
+);
+enum cjsonError cjsonMsgpackDecoder_ProcessBytes(
+	struct cjsonMsgpackDecoder* lpDecoder,
+	const char* lpData,
+	unsigned long int dwDataLength
+);
+enum cjsonError cjsonMsgpackDecoder_Release(
+	struct cjsonMsgpackDecoder* lpDecoder
+);
+
+/*
+	Binary snapshots
+
+	A snapshot is a position independent image of a tree that can be
+	mapped read-only into memory (or read into any 8 byte aligned
+	buffer) and queried without building the tree. All references are
+	byte offsets from the start of the image, arrays store their
+	element references contiguously and objects store a key table
+	sorted by key that is searched by bisection.
+
+	Snapshots are written in host byte order, opening an image written
+	on a machine with different byte order fails with
+	cjsonE_EncodingError. Values inside a snapshot are identified by
+	their offset (uint64_t), the root is available via qwRoot.
+
+	The writer passes the image to the serializer write callback. It
+	is written in a single call to cjsonSnapshot_Write, an error
+	returned by the callback aborts the snapshot.
+*/
+#define CJSON_SNAPSHOT_MAGIC					"CJSNAP01"
+#define CJSON_SNAPSHOT_BYTEORDER				0x01020304
+
+struct cjsonSnapshot {
+	const char*										lpData;
+	uint64_t										qwSize;
+	uint64_t										qwRoot;
+};
+
+enum cjsonError cjsonSnapshot_Write(
+	const struct cjsonValue* lpRoot,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam,
+	struct cjsonSystemAPI* lpSystem		/* Used for temporary buffers only */
+);
+enum cjsonError cjsonSnapshot_Open(
+	struct cjsonSnapshot* lpOut,
+	const void* lpData,					/* Has to be 8 byte aligned and outlive the snapshot */
+	unsigned long int dwSize
+);
+
+enum cjsonElementType cjsonSnapshot_Type(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwValue						/* Returns cjsonUnknown for invalid references */
+);
+unsigned long int cjsonSnapshotArray_Length(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwArray
+);
+enum cjsonError cjsonSnapshotArray_Get(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwArray,
+	unsigned long int idx,
+	uint64_t* lpValueOut
+);
+unsigned long int cjsonSnapshotObject_Length(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwObject
+);
+enum cjsonError cjsonSnapshotObject_Get(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	uint64_t* lpValueOut
+);
+enum cjsonError cjsonSnapshotObject_GetEntry(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwObject,
+	unsigned long int idx,				/* Entries are ordered by key */
+	const char** lpKeyOut,
+	unsigned long int* lpKeyLengthOut,
+	uint64_t* lpValueOut
+);
+enum cjsonError cjsonSnapshotString_Get(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwString,
+	const char** lpDataOut,				/* Zero terminated */
+	unsigned long int* lpLengthOut
+);
+enum cjsonError cjsonSnapshotNumber_GetULong(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwNumber,
+	unsigned long int* lpOut
+);
+enum cjsonError cjsonSnapshotNumber_GetSLong(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwNumber,
+	signed long int* lpOut
+);
+enum cjsonError cjsonSnapshotNumber_GetDouble(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwNumber,
+	double* lpOut						/* Integers are converted */
+);
+
+/*
+	Reader and writer primitives
+
+	Used by code emitted by the schema code generator (cjsongen) to
+	parse JSON text directly into C structures and to write them
+	back without building a tree. The reader works on a complete
+	buffer, the writer buffers its output and passes it to a
+	serializer write callback.
+
+	Object keys are reported together with their hash
+	(cjsonReader_HashKey) so generated code can dispatch with a
+	switch on precomputed constants. Escaped keys are decoded into
+	the readers key buffer, keys longer than CJSON_READER_KEYSIZE
+	can't match any schema key and are reported with length
+	CJSON_READER_KEYSIZE and hash 0.
+
+	Writer errors are sticky: after the first failure every call
+	returns the same error without writing, so the status can be
+	checked once at cjsonWriter_Flush.
+*/
+#ifndef CJSON_READER_KEYSIZE
+	#define CJSON_READER_KEYSIZE 256
+#endif
+#ifndef CJSON_READER_SKIPDEPTH
+	#define CJSON_READER_SKIPDEPTH 1024			/* Deepest nesting accepted by cjsonReader_Skip (multiple of 8) */
+#endif
+#ifndef CJSON_WRITER_BUFFERSIZE
+	#define CJSON_WRITER_BUFFERSIZE 4096
+#endif
+
+struct cjsonReader {
+	const char*										lpData;
+	unsigned long int								dwLength;
+	unsigned long int								dwPosition;
+
+	char											bKey[CJSON_READER_KEYSIZE];
+};
+struct cjsonWriter {
+	cjsonSerializer_Callback_WriteBytes				callback;
+	void*											callbackFreeParam;
+	enum cjsonError									eStatus;
+
+	unsigned long int								dwBufferUsed;
+	char											bBuffer[CJSON_WRITER_BUFFERSIZE];
+};
+
+uint32_t cjsonReader_HashKey(
+	const char* lpKey,
+	unsigned long int dwKeyLength
+);
+
+void cjsonReader_Init(
+	struct cjsonReader* lpReader,
+	const char* lpData,
+	unsigned long int dwLength
+);
+enum cjsonError cjsonReader_Finish(
+	struct cjsonReader* lpReader		/* Only whitespace may follow */
+);
+enum cjsonError cjsonReader_ObjectNext(
+	struct cjsonReader* lpReader,
+	unsigned long int* lpIndex,			/* 0 before the opening brace, incremented for every key */
+	const char** lpKeyOut,
+	unsigned long int* lpKeyLengthOut,
+	uint32_t* lpKeyHashOut				/* Returns cjsonE_Finished after the closing brace */
+);
+enum cjsonError cjsonReader_ArrayNext(
+	struct cjsonReader* lpReader,
+	unsigned long int* lpIndex			/* 0 before the opening bracket, returns cjsonE_Finished after the closing bracket */
+);
+int cjsonReader_IsNull(
+	struct cjsonReader* lpReader		/* Consumes null and returns 1 if the next value is null */
+);
+enum cjsonError cjsonReader_ULong(
+	struct cjsonReader* lpReader,
+	unsigned long int* lpOut
+);
+enum cjsonError cjsonReader_SLong(
+	struct cjsonReader* lpReader,
+	signed long int* lpOut
+);
+enum cjsonError cjsonReader_Double(
+	struct cjsonReader* lpReader,
+	double* lpOut
+);
+enum cjsonError cjsonReader_Bool(
+	struct cjsonReader* lpReader,
+	int* lpOut
+);
+enum cjsonError cjsonReader_String(
+	struct cjsonReader* lpReader,
+	char* lpBuffer,						/* Zero terminated, cjsonE_IndexOutOfBounds if longer than dwBufferSize-1 */
+	unsigned long int dwBufferSize,
+	unsigned long int* lpLengthOut
+);
+enum cjsonError cjsonReader_Skip(
+	struct cjsonReader* lpReader		/* Validates the skipped value, nesting deeper than CJSON_READER_SKIPDEPTH is rejected */
+);
+
+void cjsonWriter_Init(
+	struct cjsonWriter* lpWriter,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam
+);
+enum cjsonError cjsonWriter_Raw(
+	struct cjsonWriter* lpWriter,
+	const char* lpData,
+	unsigned long int dwLength
+);
+enum cjsonError cjsonWriter_String(
+	struct cjsonWriter* lpWriter,
+	const char* lpData,
+	unsigned long int dwLength
+);
+enum cjsonError cjsonWriter_ULong(
+	struct cjsonWriter* lpWriter,
+	unsigned long int dwValue
+);
+enum cjsonError cjsonWriter_SLong(
+	struct cjsonWriter* lpWriter,
+	signed long int iValue
+);
+enum cjsonError cjsonWriter_Double(
+	struct cjsonWriter* lpWriter,
+	double dValue						/* Shortest representation that reads back exactly, null if not finite */
+);
+enum cjsonError cjsonWriter_Bool(
+	struct cjsonWriter* lpWriter,
+	int bValue
+);
+enum cjsonError cjsonWriter_Flush(
+	struct cjsonWriter* lpWriter
+);
+
+/*
+	Streaming transcoder
+
+	Reformats JSON text without building a tree: the tokenizer
+	validates the input byte by byte and passes every token directly
+	to a buffered writer. Memory use is constant except for one bit
+	per nesting level. Strings (including their escape sequences)
+	and numbers are copied verbatim, runs of plain string characters
+	and digits are copied as a whole.
+
+	Without flags the output is minified. With
+	CJSON_SERIALIZER__FLAG__PRETTYPRINT the layout of the serializer
+	is reproduced: every array element and object member is written
+	on its own line, members are indented by one tab per nesting
+	level and array elements by a single tab.
+	In streaming mode any number of documents is accepted and every
+	document is terminated by a linebreak (NDJSON output).
+
+	Input errors are reported as cjsonE_EncodingError, errors are
+	sticky. Output is buffered and passed to the serializer write
+	callback, cjsonTranscoder_Finish completes a trailing top level
+	number, checks that the last document is complete and flushes.
+*/
+#define CJSON_TRANSCODER_FLAG__STREAMINGMODE	0x00000002	/* Accept multiple documents, 0x00000001 is CJSON_SERIALIZER__FLAG__PRETTYPRINT */
+
+enum cjsonTranscoder_State {
+	cjsonTranscoder_State__Value,
+	cjsonTranscoder_State__ValueOrClose,		/* After [ */
+	cjsonTranscoder_State__KeyOrClose,			/* After { */
+	cjsonTranscoder_State__Key,					/* After a comma inside an object */
+	cjsonTranscoder_State__Colon,
+	cjsonTranscoder_State__CommaOrClose,
+	cjsonTranscoder_State__String,
+	cjsonTranscoder_State__StringEscape,
+	cjsonTranscoder_State__StringUnicode,
+	cjsonTranscoder_State__Literal,
+	cjsonTranscoder_State__NumberSign,
+	cjsonTranscoder_State__NumberZero,
+	cjsonTranscoder_State__NumberInt,
+	cjsonTranscoder_State__NumberFracStart,
+	cjsonTranscoder_State__NumberFrac,
+	cjsonTranscoder_State__NumberExpStart,
+	cjsonTranscoder_State__NumberExpSign,
+	cjsonTranscoder_State__NumberExp,
+	cjsonTranscoder_State__Done
+};
+struct cjsonTranscoder {
+	struct cjsonWriter								writer;
+	enum cjsonTranscoder_State						state;
+	enum cjsonError									eStatus;			/* Sticky input error */
+	uint32_t										dwFlags;
+
+	int												bKey;				/* Current string is an object key */
+	const char*										lpLiteral;			/* true, false or null */
+	unsigned long int								dwAux;				/* Literal bytes or unicode digits seen */
+
+	uint8_t*										lpStack;			/* One bit per nesting level, set for objects */
+	unsigned long int								dwDepth;
+	unsigned long int								dwStackSize;		/* Bytes */
+
+	unsigned long int								dwDocuments;		/* Completed documents */
+	struct cjsonSystemAPI*							lpSystem;
+};
+
+enum cjsonError cjsonTranscoder_Create(
+	struct cjsonTranscoder** lpOut,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam,
+	uint32_t dwFlags,
+	struct cjsonSystemAPI* lpSystem
+);
+enum cjsonError cjsonTranscoder_ProcessByte(
+	struct cjsonTranscoder* lpTranscoder,
+	char bByte
+);
+enum cjsonError cjsonTranscoder_ProcessBytes(
+	struct cjsonTranscoder* lpTranscoder,
+	const char* lpData,
+	unsigned long int dwDataLength
+);
+enum cjsonError cjsonTranscoder_Finish(
+	struct cjsonTranscoder* lpTranscoder
+);
+enum cjsonError cjsonTranscoder_Release(
+	struct cjsonTranscoder* lpTranscoder
+);
+
 #ifdef __cplusplus
 	} /* extern "C" { */
 #endif
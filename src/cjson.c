@@ -5,75 +5,342 @@
 	extern "C" {
 #endif
 
+#ifndef CJSON_RELEASE_STACKSEGMENT
+	#define CJSON_RELEASE_STACKSEGMENT 32			/* Frames per segment of the release stack */
+#endif
+#ifndef CJSON_RELEASE_PREFETCHDISTANCE
+	#define CJSON_RELEASE_PREFETCHDISTANCE 4		/* Number of array entries we prefetch ahead */
+#endif
+
+/*
+	The release function walks the tree with an explicit stack
+	instead of recursion. Each frame references a container and the
+	position (page entry or bucket index) at which we continue after
+	a nested container has been released. Pages and bucket entries
+	are released as soon as we've passed them so the container
+	always starts at the current position.
+
+	The stack is a cjsonScratch_Stack whose first segment is located
+	on the C stack, deeper trees take additional segments from the
+	scratch system of the container that didn't fit anymore.
+*/
+struct cjsonRelease_Frame {
+	struct cjsonValue*							lpValue;
+	unsigned long int							dwCursor;
+};
+
+static inline void cjsonReleaseValue_Free(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+static inline void cjsonReleaseValue_FreeBlock(
+	struct cjsonValue* lpOwner,
+	void* lpBlock
+) {
+	cjsonReleaseValue_Free(lpOwner->lpSystem, lpBlock);
+}
+
+/*
+	Drops one reference. Returns 1 if this has been the last
+	reference and the value has to be released. Values with a
+	single owner don't require the atomic operation.
+*/
+static inline int cjsonReleaseValue_DropReference(
+	struct cjsonValue* lpValue
+) {
+	if(CJSON_ATOMIC_LOAD(lpValue->dwRefCount) == 1) { return 1; }
+	return (CJSON_ATOMIC_DECREMENT(lpValue->dwRefCount) == 0) ? 1 : 0;
+}
+
+static inline int cjsonReleaseValue_IsContainer(
+	const struct cjsonValue* lpValue
+) {
+	return ((lpValue->type == cjsonObject) || (lpValue->type == cjsonArray)) ? 1 : 0;
+}
+
+/*
+	Pushes a container onto the release stack. Returns 0 if no
+	additional stack segment could be allocated. A new segment is
+	scratch memory of the pushed container.
+*/
+static inline int cjsonReleaseValue_Push(
+	struct cjsonScratch_Stack* lpStack,
+	struct cjsonValue* lpValue
+) {
+	struct cjsonRelease_Frame* lpFrame;
+
+	lpStack->lpSystem = cjsonScratch_System(lpValue->lpSystem);
+	lpFrame = (struct cjsonRelease_Frame*)cjsonScratch_Push(lpStack);
+	if(lpFrame == NULL) { return 0; }
+
+	lpFrame->lpValue = lpValue;
+	lpFrame->dwCursor = 0;
+	return 1;
+}
+
+/*
+	Descends into a nested container. If the stack cannot grow we
+	fall back to a nested call that starts with a fresh segment
+	on the C stack.
+*/
+static inline int cjsonReleaseValue_Descend(
+	struct cjsonScratch_Stack* lpStack,
+	struct cjsonValue* lpChild
+) {
+	if(cjsonReleaseValue_Push(lpStack, lpChild) != 0) { return 1; }
+
+	/* Our reference has already been dropped, hand the last one to the nested call */
+	lpChild->dwRefCount = 1;
+	cjsonReleaseValue(lpChild);
+	return 0;
+}
+
+/*
+	Hooks of an array are told about its release before any of
+	its elements is released
+*/
+static void cjsonReleaseValue_DetachHooks(
+	struct cjsonArray* lpArray
+) {
+	struct cjsonArray_Hook* lpHook;
+
+	while((lpHook = lpArray->lpHooks) != NULL) {
+		lpArray->lpHooks = lpHook->lpNext;
+		lpHook->lpNext = NULL;
+		lpHook->callback(lpHook, cjsonArray_HookEvent__Released, NULL);
+	}
+}
+
 /*
 	Release function used for ALL supported values
 */
 void cjsonReleaseValue(
 	struct cjsonValue* lpValue
 ) {
+	struct cjsonRelease_Frame stackBase[CJSON_RELEASE_STACKSEGMENT];
+	struct cjsonScratch_Stack stack;
+	struct cjsonRelease_Frame* lpFrame;
+	struct cjsonArray* lpArray;
+	struct cjsonArray_Page* lpPage;
+	struct cjsonObject* lpObject;
+	struct cjsonObject_BucketEntry* lpEntry;
+	struct cjsonValue* lpChild;
 	unsigned long int i;
-	void* lpPageRelease;
-	struct cjsonArray_Page* lpArrayPage;
-	struct cjsonObject_BucketEntry* lpBucketEntry;
+	int bDescended;
 
 	if(lpValue == NULL) { return; }
+	if(cjsonReleaseValue_DropReference(lpValue) == 0) { return; }
+
+	/* Scalars only consist of the value structure */
+	if(cjsonReleaseValue_IsContainer(lpValue) == 0) {
+		cjsonReleaseValue_FreeBlock(lpValue, (void*)lpValue);
+		return;
+	}
+
+	cjsonScratch_StackInit(&stack, (void*)stackBase, sizeof(struct cjsonRelease_Frame), CJSON_RELEASE_STACKSEGMENT, lpValue->lpSystem);
+	cjsonReleaseValue_Push(&stack, lpValue);
 
-	switch(lpValue->type) {
-		case cjsonObject:
+	while(!CJSON_SCRATCH_EMPTY(&stack)) {
+		lpFrame = (struct cjsonRelease_Frame*)CJSON_SCRATCH_TOP(&stack);
+		bDescended = 0;
+
+		if(lpFrame->lpValue->type == cjsonArray) {
 			/*
-				At the object we have to iterate over all buckets and
-				release all contained elements recursively
+				Release all pages. Leafs are released directly while we
+				prefetch the next entries, nested containers are pushed
+				and we continue at the next entry after they've been
+				released.
 			*/
-			for(i = 0; i < ((struct cjsonObject*)lpValue)->dwBucketCount; i=i+1) {
-				lpBucketEntry = ((struct cjsonObject*)lpValue)->buckets[i];
-				while(lpBucketEntry != NULL) {
-					lpPageRelease = (void*)lpBucketEntry;
-					cjsonReleaseValue(lpBucketEntry->lpValue);
-
-					lpBucketEntry = lpBucketEntry->bucketList.lpNext;
-					if(lpValue->lpSystem == NULL) { free(lpPageRelease); } else { lpValue->lpSystem->free(lpValue->lpSystem, lpPageRelease); }
+			lpArray = (struct cjsonArray*)(lpFrame->lpValue);
+			if(lpArray->lpHooks != NULL) { cjsonReleaseValue_DetachHooks(lpArray); }
+			while((lpPage = lpArray->pageList.lpFirstPage) != NULL) {
+				if(lpPage->pageList.lpNext != NULL) { CJSON_PREFETCH(lpPage->pageList.lpNext); }
+
+				for(i = lpFrame->dwCursor; i < lpPage->dwUsedEntries; i=i+1) {
+					if(i + CJSON_RELEASE_PREFETCHDISTANCE < lpPage->dwUsedEntries) {
+						CJSON_PREFETCH(lpPage->entries[i + CJSON_RELEASE_PREFETCHDISTANCE]);
+					}
+
+					lpChild = lpPage->entries[i]; /* Note that NULL entries are possible */
+					if(lpChild == NULL) { continue; }
+					if(cjsonReleaseValue_DropReference(lpChild) == 0) { continue; }
+
+					if(cjsonReleaseValue_IsContainer(lpChild) != 0) {
+						lpFrame->dwCursor = i + 1;
+						if(cjsonReleaseValue_Descend(&stack, lpChild) != 0) {
+							bDescended = 1;
+							break;
+						}
+					} else {
+						cjsonReleaseValue_FreeBlock(lpChild, (void*)lpChild);
+					}
 				}
-			}
-			if(lpValue->lpSystem == NULL) { free(lpValue); } else { lpValue->lpSystem->free(lpValue->lpSystem, lpValue); }
-			return;
+				if(bDescended != 0) { break; }
 
-		case cjsonArray:
+				lpArray->pageList.lpFirstPage = lpPage->pageList.lpNext;
+				lpFrame->dwCursor = 0;
+				cjsonReleaseValue_FreeBlock(&(lpArray->base), (void*)lpPage);
+			}
+			if(bDescended != 0) { continue; }
+		} else {
 			/*
-				We have to iterate over all pages and release all
-				contained elements recursively
+				Iterate over all buckets and release the bucket entries
+				while we walk the chains. The cursor is the current bucket,
+				it's head always is the next entry that has to be released.
 			*/
-			lpArrayPage = ((struct cjsonArray*)lpValue)->pageList.lpFirstPage;
-			while(lpArrayPage != NULL) {
-				for(i = 0; i < lpArrayPage->dwUsedEntries; i=i+1) {
-					cjsonReleaseValue(lpArrayPage->entries[i]); /* Note that NULL is also correctly accepted as argument, there is no missing check */
-				}
-				lpPageRelease = (void*)lpArrayPage;
-				lpArrayPage = lpArrayPage->pageList.lpNext;
+			lpObject = (struct cjsonObject*)(lpFrame->lpValue);
+			for(; lpFrame->dwCursor < lpObject->dwBucketCount; lpFrame->dwCursor = lpFrame->dwCursor + 1) {
+				while((lpEntry = lpObject->buckets[lpFrame->dwCursor]) != NULL) {
+					if(lpEntry->bucketList.lpNext != NULL) {
+						CJSON_PREFETCH(lpEntry->bucketList.lpNext);
+					} else if((lpFrame->dwCursor + 1 < lpObject->dwBucketCount) && (lpObject->buckets[lpFrame->dwCursor + 1] != NULL)) {
+						CJSON_PREFETCH(lpObject->buckets[lpFrame->dwCursor + 1]);
+					}
+
+					lpChild = lpEntry->lpValue;
+					lpObject->buckets[lpFrame->dwCursor] = lpEntry->bucketList.lpNext;
+					cjsonReleaseValue_FreeBlock(&(lpObject->base), (void*)lpEntry);
 
-				if(lpValue->lpSystem == NULL) { free(lpPageRelease); } else { lpValue->lpSystem->free(lpValue->lpSystem, lpPageRelease); }
+					if(lpChild == NULL) { continue; }
+					if(cjsonReleaseValue_DropReference(lpChild) == 0) { continue; }
+					if(cjsonReleaseValue_IsContainer(lpChild) != 0) {
+						if(cjsonReleaseValue_Descend(&stack, lpChild) != 0) {
+							bDescended = 1;
+							break;
+						}
+					} else {
+						cjsonReleaseValue_FreeBlock(lpChild, (void*)lpChild);
+					}
+				}
+				if(bDescended != 0) { break; }
 			}
-			if(lpValue->lpSystem == NULL) { free(lpValue); } else { lpValue->lpSystem->free(lpValue->lpSystem, lpValue); }
-			return;
-
-		case cjsonString:
-		case cjsonNumber_UnsignedLong:
-		case cjsonNumber_SignedLong:
-		case cjsonNumber_Double:
-		case cjsonTrue:
-		case cjsonFalse:
-		case cjsonNull:
-			/* This types only consist of the value structrue */
-			if(lpValue->lpSystem == NULL) {
-				free((void*)lpValue);
-			} else {
-				lpValue->lpSystem->free(lpValue->lpSystem, (void*)lpValue);
+			if(bDescended != 0) { continue; }
+		}
+
+		/* All children are gone, release the container itself */
+		lpChild = lpFrame->lpValue;
+		cjsonScratch_Pop(&stack);
+		cjsonReleaseValue_FreeBlock(lpChild, (void*)lpChild);
+	}
+}
+
+/*
+	Asynchronous release via a worker pool (usually a pool with
+	a single thread used as reclaimer)
+*/
+static void cjsonReleaseValue_Job(
+	void* lpParam
+) {
+	cjsonReleaseValue((struct cjsonValue*)lpParam);
+}
+enum cjsonError cjsonReleaseValueAsync(
+	struct cjsonValue* lpValue,
+	struct cjsonWorkerPool* lpReclaimer
+) {
+	if(lpValue == NULL) { return cjsonE_Ok; }
+
+	/* Shared values are only queued once the last reference is dropped */
+	if(cjsonReleaseValue_DropReference(lpValue) == 0) { return cjsonE_Ok; }
+	lpValue->dwRefCount = 1;
+
+	/*
+		Scalars are cheaper to release than to queue. If the
+		tree cannot be queued we release it synchronously so
+		it never leaks.
+	*/
+	if((lpReclaimer == NULL) || (cjsonReleaseValue_IsContainer(lpValue) == 0)) {
+		cjsonReleaseValue(lpValue);
+		return cjsonE_Ok;
+	}
+
+	if(cjsonWorkerPool_SubmitDetached(lpReclaimer, &cjsonReleaseValue_Job, (void*)lpValue) != cjsonE_Ok) {
+		cjsonReleaseValue(lpValue);
+	}
+	return cjsonE_Ok;
+}
+
+/*
+	Reference counting
+*/
+struct cjsonValue* cjsonValue_Retain(
+	struct cjsonValue* lpValue
+) {
+	if(lpValue == NULL) { return NULL; }
+	CJSON_ATOMIC_INCREMENT(lpValue->dwRefCount);
+	return lpValue;
+}
+unsigned long int cjsonValue_RefCount(
+	const struct cjsonValue* lpValue
+) {
+	if(lpValue == NULL) { return 0; }
+	return (unsigned long int)CJSON_ATOMIC_LOAD(lpValue->dwRefCount);
+}
+
+/*
+	Copy on write. If the value is shared it's replaced by a
+	shallow copy owned by the caller. Children of containers are
+	retained so they stay shared until they're unshared themselves
+	(for example via cjsonObject_GetMutable or cjsonArray_GetMutable).
+*/
+enum cjsonError cjsonValue_Unshare(
+	struct cjsonValue** lpValueInOut
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpValue;
+	struct cjsonValue* lpCopy;
+	struct cjsonArray_Page* lpPage;
+	struct cjsonObject* lpObject;
+	struct cjsonObject_BucketEntry* lpEntry;
+	unsigned long int i;
+
+	if(lpValueInOut == NULL) { return cjsonE_InvalidParam; }
+	if((lpValue = (*lpValueInOut)) == NULL) { return cjsonE_InvalidParam; }
+
+	if(CJSON_ATOMIC_LOAD(lpValue->dwRefCount) == 1) { return cjsonE_Ok; }
+
+	if(lpValue->type == cjsonArray) {
+		e = cjsonArray_CreateSized(&lpCopy, ((struct cjsonArray*)lpValue)->dwElementCount, lpValue->lpSystem);
+		if(e != cjsonE_Ok) { return e; }
+
+		for(lpPage = ((struct cjsonArray*)lpValue)->pageList.lpFirstPage; lpPage != NULL; lpPage = lpPage->pageList.lpNext) {
+			for(i = 0; i < lpPage->dwUsedEntries; i=i+1) {
+				e = cjsonArray_Push(lpCopy, cjsonValue_Retain(lpPage->entries[i]));
+				if(e != cjsonE_Ok) {
+					cjsonReleaseValue(lpPage->entries[i]);
+					cjsonReleaseValue(lpCopy);
+					return e;
+				}
 			}
-			return;
+		}
+	} else if(lpValue->type == cjsonObject) {
+		lpObject = (struct cjsonObject*)lpValue;
+		e = cjsonObject_CreateSized(&lpCopy, lpObject->dwElementCount, lpValue->lpSystem);
+		if(e != cjsonE_Ok) { return e; }
 
-		default:
-			/* This should NEVER happen */
-			return;
+		for(i = 0; i < lpObject->dwBucketCount; i=i+1) {
+			for(lpEntry = lpObject->buckets[i]; lpEntry != NULL; lpEntry = lpEntry->bucketList.lpNext) {
+				e = cjsonObject_SetShared(lpCopy, lpEntry->bKey, lpEntry->dwKeyLength, lpEntry->lpValue);
+				if(e != cjsonE_Ok) {
+					cjsonReleaseValue(lpCopy);
+					return e;
+				}
+			}
+		}
+	} else {
+		e = cjsonValue_Clone(lpValue, lpValue->lpSystem, &lpCopy);
+		if(e != cjsonE_Ok) { return e; }
 	}
+
+	/* Drop our reference to the shared value */
+	cjsonReleaseValue(lpValue);
+	(*lpValueInOut) = lpCopy;
+	return cjsonE_Ok;
 }
 
 #ifdef __cplusplus
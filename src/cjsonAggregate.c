@@ -0,0 +1,444 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_AGGREGATE_BLOCKSIZE
+	#define CJSON_AGGREGATE_BLOCKSIZE 256					/* Elements gathered into one block of doubles */
+#endif
+#ifndef CJSON_AGGREGATE_PARALLELMINELEMENTS
+	#define CJSON_AGGREGATE_PARALLELMINELEMENTS 262144		/* Smaller arrays are aggregated on the calling thread */
+#endif
+#ifndef CJSON_AGGREGATE_MINCHUNKELEMENTS
+	#define CJSON_AGGREGATE_MINCHUNKELEMENTS 65536			/* Smaller ranges are not worth a job */
+#endif
+#ifndef CJSON_AGGREGATE_CHUNKSPERTHREAD
+	#define CJSON_AGGREGATE_CHUNKSPERTHREAD 4				/* Targeted number of ranges per worker for load balancing */
+#endif
+
+struct cjsonAggregate_Context {
+	int												bCountIf;
+	enum cjsonColumn_Compare						eCompare;
+	double											dOperand;
+};
+
+struct cjsonAggregate_Result {
+	unsigned long int								dwCount;
+	unsigned long int								dwMatches;			/* Only counted for CountIf */
+	double											dSum;
+	double											dMin;
+	double											dMax;
+};
+
+struct cjsonAggregate_Chunk {
+	struct cjsonWorkerPool_Job						job;
+	const struct cjsonAggregate_Context*			lpContext;
+
+	const struct cjsonArray_Page*					lpFirstPage;
+	unsigned long int								dwFirstEntry;
+	unsigned long int								dwElements;
+
+	struct cjsonAggregate_Result					result;
+	int												bSubmitted;
+};
+
+/*
+	Copies the numeric elements of a run of entries into a block
+	of doubles and returns their number. A block that contains
+	only one kind of number is converted without any per element
+	dispatch.
+*/
+static unsigned long int cjsonAggregate_Gather(
+	struct cjsonValue* const* lpEntries,
+	unsigned long int dwCount,
+	double* lpBlock
+) {
+	unsigned long int i;
+	unsigned long int dwNumbers;
+	uint32_t dwTypes = 0;
+
+	for(i = 0; i < dwCount; i=i+1) {
+		dwTypes = dwTypes | ((lpEntries[i] != NULL) ? (1U << lpEntries[i]->type) : (1U << cjsonUnknown));
+	}
+
+	if(dwTypes == (1U << cjsonNumber_Double)) {
+		for(i = 0; i < dwCount; i=i+1) { lpBlock[i] = ((const struct cjsonNumber*)(lpEntries[i]))->value.dbl; }
+		return dwCount;
+	}
+	if(dwTypes == (1U << cjsonNumber_UnsignedLong)) {
+		for(i = 0; i < dwCount; i=i+1) { lpBlock[i] = (double)(((const struct cjsonNumber*)(lpEntries[i]))->value.ulong); }
+		return dwCount;
+	}
+	if(dwTypes == (1U << cjsonNumber_SignedLong)) {
+		for(i = 0; i < dwCount; i=i+1) { lpBlock[i] = (double)(((const struct cjsonNumber*)(lpEntries[i]))->value.slong); }
+		return dwCount;
+	}
+
+	/* Mixed block */
+	dwNumbers = 0;
+	for(i = 0; i < dwCount; i=i+1) {
+		if(lpEntries[i] == NULL) { continue; }
+		switch(lpEntries[i]->type) {
+			case cjsonNumber_UnsignedLong:	lpBlock[dwNumbers] = (double)(((const struct cjsonNumber*)(lpEntries[i]))->value.ulong); break;
+			case cjsonNumber_SignedLong:	lpBlock[dwNumbers] = (double)(((const struct cjsonNumber*)(lpEntries[i]))->value.slong); break;
+			case cjsonNumber_Double:		lpBlock[dwNumbers] = ((const struct cjsonNumber*)(lpEntries[i]))->value.dbl; break;
+			default:						continue;
+		}
+		dwNumbers = dwNumbers + 1;
+	}
+	return dwNumbers;
+}
+
+static inline void cjsonAggregate_Merge(
+	struct cjsonAggregate_Result* lpResult,
+	const struct cjsonAggregate_Result* lpPartial
+) {
+	if(lpPartial->dwCount == 0) { return; }
+
+	if(lpResult->dwCount == 0) {
+		lpResult->dMin = lpPartial->dMin;
+		lpResult->dMax = lpPartial->dMax;
+	} else {
+		lpResult->dMin = (lpPartial->dMin < lpResult->dMin) ? lpPartial->dMin : lpResult->dMin;
+		lpResult->dMax = (lpPartial->dMax > lpResult->dMax) ? lpPartial->dMax : lpResult->dMax;
+	}
+	lpResult->dwCount = lpResult->dwCount + lpPartial->dwCount;
+	lpResult->dwMatches = lpResult->dwMatches + lpPartial->dwMatches;
+	lpResult->dSum = lpResult->dSum + lpPartial->dSum;
+}
+
+/*
+	Kernels over one block. These are plain scalar loops, there is
+	no explicit SIMD code: the sum uses four independent accumulators
+	to break the dependency chain, minimum, maximum and the predicate
+	are evaluated without branches so the compiler may vectorize
+	them. Gather converts element by element as well.
+*/
+static void cjsonAggregate_Block(
+	const double* lpBlock,
+	unsigned long int dwCount,
+	const struct cjsonAggregate_Context* lpContext,
+	struct cjsonAggregate_Result* lpResult
+) {
+	struct cjsonAggregate_Result partial;
+	double dSum[4] = { 0, 0, 0, 0 };
+	double dMin;
+	double dMax;
+	unsigned long int dwMatches = 0;
+	unsigned long int i;
+
+	if(dwCount == 0) { return; }
+
+	partial.dwCount = dwCount;
+	partial.dwMatches = 0;
+	partial.dSum = 0;
+	partial.dMin = 0;
+	partial.dMax = 0;
+
+	if(lpContext->bCountIf != 0) {
+		switch(lpContext->eCompare) {
+			case cjsonColumn_Compare__Less:			for(i = 0; i < dwCount; i=i+1) { dwMatches = dwMatches + ((lpBlock[i] < lpContext->dOperand) ? 1 : 0); } break;
+			case cjsonColumn_Compare__LessEqual:	for(i = 0; i < dwCount; i=i+1) { dwMatches = dwMatches + ((lpBlock[i] <= lpContext->dOperand) ? 1 : 0); } break;
+			case cjsonColumn_Compare__Equal:		for(i = 0; i < dwCount; i=i+1) { dwMatches = dwMatches + ((lpBlock[i] == lpContext->dOperand) ? 1 : 0); } break;
+			case cjsonColumn_Compare__NotEqual:		for(i = 0; i < dwCount; i=i+1) { dwMatches = dwMatches + ((lpBlock[i] != lpContext->dOperand) ? 1 : 0); } break;
+			case cjsonColumn_Compare__GreaterEqual:	for(i = 0; i < dwCount; i=i+1) { dwMatches = dwMatches + ((lpBlock[i] >= lpContext->dOperand) ? 1 : 0); } break;
+			default:								for(i = 0; i < dwCount; i=i+1) { dwMatches = dwMatches + ((lpBlock[i] > lpContext->dOperand) ? 1 : 0); } break;
+		}
+		partial.dwMatches = dwMatches;
+		cjsonAggregate_Merge(lpResult, &partial);
+		return;
+	}
+
+	for(i = 0; i + 4 <= dwCount; i=i+4) {
+		dSum[0] = dSum[0] + lpBlock[i];
+		dSum[1] = dSum[1] + lpBlock[i+1];
+		dSum[2] = dSum[2] + lpBlock[i+2];
+		dSum[3] = dSum[3] + lpBlock[i+3];
+	}
+	for(; i < dwCount; i=i+1) { dSum[0] = dSum[0] + lpBlock[i]; }
+
+	dMin = lpBlock[0];
+	dMax = lpBlock[0];
+	for(i = 1; i < dwCount; i=i+1) {
+		dMin = (lpBlock[i] < dMin) ? lpBlock[i] : dMin;
+		dMax = (lpBlock[i] > dMax) ? lpBlock[i] : dMax;
+	}
+
+	partial.dSum = (dSum[0] + dSum[1]) + (dSum[2] + dSum[3]);
+	partial.dMin = dMin;
+	partial.dMax = dMax;
+	cjsonAggregate_Merge(lpResult, &partial);
+}
+
+/*
+	Aggregates dwElements elements starting at the given entry of
+	a page, continuing over the following pages
+*/
+static void cjsonAggregate_Range(
+	const struct cjsonArray_Page* lpPage,
+	unsigned long int dwEntry,
+	unsigned long int dwElements,
+	const struct cjsonAggregate_Context* lpContext,
+	struct cjsonAggregate_Result* lpResult
+) {
+	double dBlock[CJSON_AGGREGATE_BLOCKSIZE];
+	unsigned long int dwRun;
+
+	while((dwElements > 0) && (lpPage != NULL)) {
+		if(dwEntry >= lpPage->dwUsedEntries) {
+			lpPage = lpPage->pageList.lpNext;
+			dwEntry = 0;
+			if((lpPage != NULL) && (lpPage->pageList.lpNext != NULL)) { CJSON_PREFETCH(lpPage->pageList.lpNext); }
+			continue;
+		}
+
+		dwRun = lpPage->dwUsedEntries - dwEntry;
+		if(dwRun > dwElements) { dwRun = dwElements; }
+		if(dwRun > CJSON_AGGREGATE_BLOCKSIZE) { dwRun = CJSON_AGGREGATE_BLOCKSIZE; }
+
+		cjsonAggregate_Block(dBlock, cjsonAggregate_Gather(&(lpPage->entries[dwEntry]), dwRun, dBlock), lpContext, lpResult);
+		dwEntry = dwEntry + dwRun;
+		dwElements = dwElements - dwRun;
+	}
+}
+
+static void cjsonAggregate_Worker(
+	void* lpParam
+) {
+	struct cjsonAggregate_Chunk* lpChunk = (struct cjsonAggregate_Chunk*)lpParam;
+
+	cjsonAggregate_Range(lpChunk->lpFirstPage, lpChunk->dwFirstEntry, lpChunk->dwElements, lpChunk->lpContext, &(lpChunk->result));
+}
+
+/*
+	Splits the array into element ranges of similar size (ranges
+	may start and end inside a page, so arrays created with a
+	single large page are split too). The chunk table is scratch
+	memory of the array. If it cannot be allocated or a job cannot
+	be submitted the work is done on the calling thread.
+*/
+static enum cjsonError cjsonAggregate_Run(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	const struct cjsonAggregate_Context* lpContext,
+	struct cjsonAggregate_Result* lpResult
+) {
+	const struct cjsonArray* lpThis = (const struct cjsonArray*)lpArray;
+	const struct cjsonArray_Page* lpPage;
+	struct cjsonAggregate_Chunk* lpChunks = NULL;
+	struct cjsonSystemAPI* lpSystem = NULL;
+	unsigned long int dwChunkSize = 0;
+	unsigned long int dwChunkCount = 0;
+	unsigned long int dwEntry;
+	unsigned long int dwSkip;
+	unsigned long int i;
+
+	if(lpArray == NULL) { return cjsonE_InvalidParam; }
+	if(lpArray->type != cjsonArray) { return cjsonE_InvalidParam; }
+
+	memset(lpResult, 0, sizeof(struct cjsonAggregate_Result));
+
+	if((lpPool != NULL) && (lpThis->dwElementCount >= CJSON_AGGREGATE_PARALLELMINELEMENTS)) {
+		dwChunkSize = lpThis->dwElementCount / (cjsonWorkerPool_ThreadCount(lpPool) * CJSON_AGGREGATE_CHUNKSPERTHREAD);
+		if(dwChunkSize < CJSON_AGGREGATE_MINCHUNKELEMENTS) { dwChunkSize = CJSON_AGGREGATE_MINCHUNKELEMENTS; }
+		dwChunkCount = (lpThis->dwElementCount + dwChunkSize - 1) / dwChunkSize;
+		lpSystem = cjsonScratch_System(lpThis->base.lpSystem);
+		if(cjsonScratch_Alloc(lpSystem, sizeof(struct cjsonAggregate_Chunk) * dwChunkCount, (void**)&lpChunks) != cjsonE_Ok) { lpChunks = NULL; }
+	}
+	if(lpChunks == NULL) {
+		cjsonAggregate_Range(lpThis->pageList.lpFirstPage, 0, lpThis->dwElementCount, lpContext, lpResult);
+		return cjsonE_Ok;
+	}
+
+	lpPage = lpThis->pageList.lpFirstPage;
+	dwEntry = 0;
+	for(i = 0; i < dwChunkCount; i=i+1) {
+		memset(&(lpChunks[i]), 0, sizeof(struct cjsonAggregate_Chunk));
+		lpChunks[i].lpContext = lpContext;
+		lpChunks[i].lpFirstPage = lpPage;
+		lpChunks[i].dwFirstEntry = dwEntry;
+		lpChunks[i].dwElements = (lpThis->dwElementCount - i * dwChunkSize < dwChunkSize) ? lpThis->dwElementCount - i * dwChunkSize : dwChunkSize;
+		lpChunks[i].job.lpfnJob = &cjsonAggregate_Worker;
+		lpChunks[i].job.lpParam = (void*)(&(lpChunks[i]));
+
+		/* Advance to the first element of the next range */
+		for(dwSkip = lpChunks[i].dwElements; (dwSkip > 0) && (lpPage != NULL); ) {
+			if(dwSkip < lpPage->dwUsedEntries - dwEntry) {
+				dwEntry = dwEntry + dwSkip;
+				dwSkip = 0;
+			} else {
+				dwSkip = dwSkip - (lpPage->dwUsedEntries - dwEntry);
+				lpPage = lpPage->pageList.lpNext;
+				dwEntry = 0;
+			}
+		}
+
+		if(cjsonWorkerPool_Submit(lpPool, &(lpChunks[i].job)) == cjsonE_Ok) {
+			lpChunks[i].bSubmitted = 1;
+		} else {
+			cjsonAggregate_Worker((void*)(&(lpChunks[i])));
+		}
+	}
+
+	for(i = 0; i < dwChunkCount; i=i+1) {
+		if(lpChunks[i].bSubmitted != 0) { cjsonWorkerPool_Wait(lpPool, &(lpChunks[i].job)); }
+		cjsonAggregate_Merge(lpResult, &(lpChunks[i].result));
+	}
+	cjsonScratch_Free(lpSystem, lpChunks);
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonArray_Aggregate(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	struct cjsonColumn_Aggregate* lpOut
+) {
+	struct cjsonAggregate_Context context;
+	struct cjsonAggregate_Result result;
+	enum cjsonError e;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+
+	context.bCountIf = 0;
+	context.eCompare = cjsonColumn_Compare__Equal;
+	context.dOperand = 0;
+
+	e = cjsonAggregate_Run(lpArray, lpPool, &context, &result);
+	if(e != cjsonE_Ok) { return e; }
+
+	lpOut->dwCount = result.dwCount;
+	lpOut->dSum = result.dSum;
+	lpOut->dMin = result.dMin;
+	lpOut->dMax = result.dMax;
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonArray_Sum(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	double* lpSumOut
+) {
+	struct cjsonColumn_Aggregate aggregate;
+	enum cjsonError e;
+
+	if(lpSumOut == NULL) { return cjsonE_InvalidParam; }
+
+	e = cjsonArray_Aggregate(lpArray, lpPool, &aggregate);
+	if(e != cjsonE_Ok) { return e; }
+
+	(*lpSumOut) = aggregate.dSum;
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonArray_Min(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	double* lpMinOut
+) {
+	struct cjsonColumn_Aggregate aggregate;
+	enum cjsonError e;
+
+	if(lpMinOut == NULL) { return cjsonE_InvalidParam; }
+
+	e = cjsonArray_Aggregate(lpArray, lpPool, &aggregate);
+	if(e != cjsonE_Ok) { return e; }
+	if(aggregate.dwCount == 0) { return cjsonE_IndexOutOfBounds; }
+
+	(*lpMinOut) = aggregate.dMin;
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonArray_Max(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	double* lpMaxOut
+) {
+	struct cjsonColumn_Aggregate aggregate;
+	enum cjsonError e;
+
+	if(lpMaxOut == NULL) { return cjsonE_InvalidParam; }
+
+	e = cjsonArray_Aggregate(lpArray, lpPool, &aggregate);
+	if(e != cjsonE_Ok) { return e; }
+	if(aggregate.dwCount == 0) { return cjsonE_IndexOutOfBounds; }
+
+	(*lpMaxOut) = aggregate.dMax;
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonArray_Mean(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	double* lpMeanOut
+) {
+	struct cjsonColumn_Aggregate aggregate;
+	enum cjsonError e;
+
+	if(lpMeanOut == NULL) { return cjsonE_InvalidParam; }
+
+	e = cjsonArray_Aggregate(lpArray, lpPool, &aggregate);
+	if(e != cjsonE_Ok) { return e; }
+	if(aggregate.dwCount == 0) { return cjsonE_IndexOutOfBounds; }
+
+	(*lpMeanOut) = aggregate.dSum / (double)(aggregate.dwCount);
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonArray_Count(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	unsigned long int* lpCountOut
+) {
+	const struct cjsonArray_Page* lpPage;
+	unsigned long int dwCount;
+	unsigned long int i;
+
+	if(lpCountOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpCountOut) = 0;
+	if(lpArray == NULL) { return cjsonE_InvalidParam; }
+	if(lpArray->type != cjsonArray) { return cjsonE_InvalidParam; }
+
+	/* Only the type tags are read, a single pass is memory bound */
+	(void)lpPool;
+	dwCount = 0;
+	for(lpPage = ((const struct cjsonArray*)lpArray)->pageList.lpFirstPage; lpPage != NULL; lpPage = lpPage->pageList.lpNext) {
+		for(i = 0; i < lpPage->dwUsedEntries; i=i+1) {
+			dwCount = dwCount + (((lpPage->entries[i] != NULL) && cjsonIsNumeric(lpPage->entries[i])) ? 1 : 0);
+		}
+	}
+
+	(*lpCountOut) = dwCount;
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonArray_CountIf(
+	const struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	enum cjsonColumn_Compare eCompare,
+	double dOperand,
+	unsigned long int* lpCountOut
+) {
+	struct cjsonAggregate_Context context;
+	struct cjsonAggregate_Result result;
+	enum cjsonError e;
+
+	if(lpCountOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpCountOut) = 0;
+
+	context.bCountIf = 1;
+	context.eCompare = eCompare;
+	context.dOperand = dOperand;
+
+	e = cjsonAggregate_Run(lpArray, lpPool, &context, &result);
+	if(e != cjsonE_Ok) { return e; }
+
+	(*lpCountOut) = result.dwMatches;
+	return cjsonE_Ok;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,268 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_ARENA_DEFAULTBLOCKSIZE
+	#define CJSON_ARENA_DEFAULTBLOCKSIZE 65536
+#endif
+
+/*
+	Blocks are kept in a singly linked list. The head of the list
+	is the block served by the bump allocator, allocations that
+	don't fit into a standard block get a dedicated block that is
+	linked behind the head so the head keeps serving small requests.
+*/
+struct cjsonArena_Block {
+	struct cjsonArena_Block*					lpNext;
+	unsigned long int							dwSize;
+	unsigned long int							dwUsed;
+	char										bData[];
+};
+
+struct cjsonArena {
+	struct cjsonSystemAPI						base;			/* Has to be the first member, handed out as system API */
+	struct cjsonSystemAPI*						lpParentSystem;
+
+	unsigned long int							dwBlockSize;
+	unsigned long int							dwBytesUsed;
+	struct cjsonArena_Block*					lpBlocks;
+};
+
+static inline enum cjsonError cjsonArena_MallocHelper(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpSystem->alloc(lpSystem, dwSize, lpOut);
+	}
+}
+static inline void cjsonArena_FreeHelper(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+
+/*
+	Number of bytes required to align the next allocation inside
+	the block (alignment is relative to the address since the parent
+	allocator may not guarantee our alignment)
+*/
+static inline unsigned long int cjsonArena_Padding(
+	const struct cjsonArena_Block* lpBlock
+) {
+	uintptr_t dwAddress = (uintptr_t)(&(lpBlock->bData[lpBlock->dwUsed]));
+	return (unsigned long int)((CJSON_ARENA_ALIGNMENT - (dwAddress % CJSON_ARENA_ALIGNMENT)) % CJSON_ARENA_ALIGNMENT);
+}
+
+static enum cjsonError cjsonArena_NewBlock(
+	struct cjsonArena* lpArena,
+	unsigned long int dwSize,
+	struct cjsonArena_Block** lpOut
+) {
+	enum cjsonError e;
+	struct cjsonArena_Block* lpNew;
+
+	/* Allow for the worst case alignment padding */
+	dwSize = dwSize + CJSON_ARENA_ALIGNMENT;
+
+	e = cjsonArena_MallocHelper(lpArena->lpParentSystem, sizeof(struct cjsonArena_Block)+dwSize, (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpNew->lpNext = NULL;
+	lpNew->dwSize = dwSize;
+	lpNew->dwUsed = 0;
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonArena_Alloc(
+	struct cjsonSystemAPI* lpSelf,
+	unsigned long int dwSize,
+	void** lpDataOut
+) {
+	enum cjsonError e;
+	struct cjsonArena* lpArena = (struct cjsonArena*)lpSelf;
+	struct cjsonArena_Block* lpBlock;
+	unsigned long int dwPadding;
+
+	if(lpDataOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpDataOut) = NULL;
+
+	lpBlock = lpArena->lpBlocks;
+	if(lpBlock != NULL) {
+		dwPadding = cjsonArena_Padding(lpBlock);
+		if(lpBlock->dwUsed + dwPadding + dwSize <= lpBlock->dwSize) {
+			(*lpDataOut) = (void*)(&(lpBlock->bData[lpBlock->dwUsed + dwPadding]));
+			lpBlock->dwUsed = lpBlock->dwUsed + dwPadding + dwSize;
+			lpArena->dwBytesUsed = lpArena->dwBytesUsed + dwSize;
+			return cjsonE_Ok;
+		}
+	}
+
+	if(dwSize > lpArena->dwBlockSize / 4) {
+		/* Large allocation, use a dedicated block behind the current one */
+		e = cjsonArena_NewBlock(lpArena, dwSize, &lpBlock);
+		if(e != cjsonE_Ok) { return e; }
+
+		if(lpArena->lpBlocks == NULL) {
+			lpArena->lpBlocks = lpBlock;
+		} else {
+			lpBlock->lpNext = lpArena->lpBlocks->lpNext;
+			lpArena->lpBlocks->lpNext = lpBlock;
+		}
+	} else {
+		e = cjsonArena_NewBlock(lpArena, lpArena->dwBlockSize, &lpBlock);
+		if(e != cjsonE_Ok) { return e; }
+
+		lpBlock->lpNext = lpArena->lpBlocks;
+		lpArena->lpBlocks = lpBlock;
+	}
+
+	dwPadding = cjsonArena_Padding(lpBlock);
+	(*lpDataOut) = (void*)(&(lpBlock->bData[lpBlock->dwUsed + dwPadding]));
+	lpBlock->dwUsed = lpBlock->dwUsed + dwPadding + dwSize;
+	lpArena->dwBytesUsed = lpArena->dwBytesUsed + dwSize;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonArena_Free(
+	struct cjsonSystemAPI* lpSelf,
+	void* lpObject
+) {
+	(void)lpSelf;
+	(void)lpObject;
+
+	/* Memory is only returned when the whole arena is reset or released */
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonArena_Create(
+	struct cjsonArena** lpOut,
+	unsigned long int dwBlockSize,
+	struct cjsonSystemAPI* lpParentSystem
+) {
+	enum cjsonError e;
+	struct cjsonArena* lpNew;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+
+	e = cjsonArena_MallocHelper(lpParentSystem, sizeof(struct cjsonArena), (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpNew->base.alloc = &cjsonArena_Alloc;
+	lpNew->base.free = &cjsonArena_Free;
+	lpNew->lpParentSystem = lpParentSystem;
+	lpNew->dwBlockSize = (dwBlockSize == 0) ? CJSON_ARENA_DEFAULTBLOCKSIZE : dwBlockSize;
+	lpNew->dwBytesUsed = 0;
+	lpNew->lpBlocks = NULL;
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+struct cjsonSystemAPI* cjsonArena_System(
+	struct cjsonArena* lpArena
+) {
+	if(lpArena == NULL) { return NULL; }
+	return &(lpArena->base);
+}
+struct cjsonArena* cjsonArena_FromSystem(
+	struct cjsonSystemAPI* lpSystem
+) {
+	if(lpSystem == NULL) { return NULL; }
+	if(lpSystem->alloc != &cjsonArena_Alloc) { return NULL; }
+	return (struct cjsonArena*)lpSystem;
+}
+
+/*
+	Makes sure the next dwBytes (including alignment of each
+	allocation) are served from a single contiguous block
+*/
+enum cjsonError cjsonArena_Reserve(
+	struct cjsonArena* lpArena,
+	unsigned long int dwBytes
+) {
+	enum cjsonError e;
+	struct cjsonArena_Block* lpBlock;
+
+	if(lpArena == NULL) { return cjsonE_InvalidParam; }
+
+	if(lpArena->lpBlocks != NULL) {
+		if(lpArena->lpBlocks->dwUsed + cjsonArena_Padding(lpArena->lpBlocks) + dwBytes <= lpArena->lpBlocks->dwSize) {
+			return cjsonE_Ok;
+		}
+	}
+
+	e = cjsonArena_NewBlock(lpArena, (dwBytes > lpArena->dwBlockSize) ? dwBytes : lpArena->dwBlockSize, &lpBlock);
+	if(e != cjsonE_Ok) { return e; }
+
+	lpBlock->lpNext = lpArena->lpBlocks;
+	lpArena->lpBlocks = lpBlock;
+	return cjsonE_Ok;
+}
+unsigned long int cjsonArena_BytesUsed(
+	const struct cjsonArena* lpArena
+) {
+	if(lpArena == NULL) { return 0; }
+	return lpArena->dwBytesUsed;
+}
+
+/*
+	Invalidates all allocations. The current block is kept for
+	reuse, all other blocks are returned to the parent system
+*/
+void cjsonArena_Reset(
+	struct cjsonArena* lpArena
+) {
+	struct cjsonArena_Block* lpCur;
+	struct cjsonArena_Block* lpNext;
+
+	if(lpArena == NULL) { return; }
+	if(lpArena->lpBlocks == NULL) { return; }
+
+	lpCur = lpArena->lpBlocks->lpNext;
+	while(lpCur != NULL) {
+		lpNext = lpCur->lpNext;
+		cjsonArena_FreeHelper(lpArena->lpParentSystem, (void*)lpCur);
+		lpCur = lpNext;
+	}
+
+	lpArena->lpBlocks->lpNext = NULL;
+	lpArena->lpBlocks->dwUsed = 0;
+	lpArena->dwBytesUsed = 0;
+}
+enum cjsonError cjsonArena_Release(
+	struct cjsonArena* lpArena
+) {
+	struct cjsonArena_Block* lpCur;
+	struct cjsonArena_Block* lpNext;
+
+	if(lpArena == NULL) { return cjsonE_Ok; }
+
+	lpCur = lpArena->lpBlocks;
+	while(lpCur != NULL) {
+		lpNext = lpCur->lpNext;
+		cjsonArena_FreeHelper(lpArena->lpParentSystem, (void*)lpCur);
+		lpCur = lpNext;
+	}
+
+	cjsonArena_FreeHelper(lpArena->lpParentSystem, (void*)lpArena);
+	return cjsonE_Ok;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -1,5 +1,6 @@
 #include "../include/cjson.h"
 #include <stdlib.h>
+#include <string.h>	/* used for memmove */
 
 #ifndef CJSON_BLOCKSIZE_ARRAY
 	#define CJSON_BLOCKSIZE_ARRAY 64
@@ -11,8 +12,9 @@
 
 const unsigned long int cjsonArray_BlockSize = CJSON_BLOCKSIZE_ARRAY;
 
-enum cjsonError cjsonArray_Create(
+enum cjsonError cjsonArray_CreateSized(
 	struct cjsonValue**	lpArrayOut,
+	unsigned long int dwExpectedElements,
 	struct cjsonSystemAPI* lpSystem
 ) {
 	enum cjsonError e;
@@ -29,14 +31,73 @@ enum cjsonError cjsonArray_Create(
 	}
 
 	((struct cjsonArray*)(*lpArrayOut))->base.type = cjsonArray;
-	((struct cjsonArray*)(*lpArrayOut))->base.lpSystem = NULL;
+	((struct cjsonArray*)(*lpArrayOut))->base.lpSystem = lpSystem;
+	((struct cjsonArray*)(*lpArrayOut))->base.dwRefCount = 1;
 	((struct cjsonArray*)(*lpArrayOut))->dwPageSize = CJSON_BLOCKSIZE_ARRAY;
+	((struct cjsonArray*)(*lpArrayOut))->dwFirstPageSize = (dwExpectedElements > 0) ? dwExpectedElements : CJSON_BLOCKSIZE_ARRAY;
 	((struct cjsonArray*)(*lpArrayOut))->dwElementCount = 0;
 	((struct cjsonArray*)(*lpArrayOut))->pageList.lpFirstPage = NULL;
 	((struct cjsonArray*)(*lpArrayOut))->pageList.lpLastPage = NULL;
+	((struct cjsonArray*)(*lpArrayOut))->lpHooks = NULL;
+
+	return cjsonE_Ok;
+}
+/*
+	Hooks are only looked at if one is attached, callbacks may
+	detach their own hook.
+*/
+static void cjsonArray_Notify(
+	struct cjsonArray* lpThis,
+	enum cjsonArray_HookEvent event,
+	struct cjsonValue* lpElement
+) {
+	struct cjsonArray_Hook* lpHook;
+	struct cjsonArray_Hook* lpNext;
+
+	if(lpElement == NULL) { return; }
+	for(lpHook = lpThis->lpHooks; lpHook != NULL; lpHook = lpNext) {
+		lpNext = lpHook->lpNext;
+		lpHook->callback(lpHook, event, lpElement);
+	}
+}
+
+/*
+	Allocates an empty page. Every page records its own capacity,
+	the size hint given at creation only applies to the first one.
+*/
+static enum cjsonError cjsonArray_AllocPage(
+	struct cjsonArray* lpThis,
+	unsigned long int dwCapacity,
+	struct cjsonArray_Page** lpPageOut
+) {
+	enum cjsonError e;
+	struct cjsonArray_Page* lpNewPage;
+	unsigned long int i;
+
+	if(lpThis->base.lpSystem == NULL) {
+		lpNewPage = (struct cjsonArray_Page*)malloc(sizeof(struct cjsonArray_Page)+sizeof(struct cjsonValue*)*dwCapacity);
+		if(lpNewPage == NULL) { return cjsonE_OutOfMemory; }
+	} else {
+		e = cjsonSystemAPI_AllocAt(lpThis->base.lpSystem, cjsonAllocSite__ArrayPush, sizeof(struct cjsonArray_Page)+sizeof(struct cjsonValue*)*dwCapacity, (void**)(&lpNewPage));
+		if(e != cjsonE_Ok) { return e; }
+	}
+
+	lpNewPage->pageList.lpNext = NULL;
+	lpNewPage->pageList.lpPrev = NULL;
+	lpNewPage->dwCapacity = dwCapacity;
+	lpNewPage->dwUsedEntries = 0;
+	for(i = 0; i < dwCapacity; i=i+1) { lpNewPage->entries[i] = NULL; }
 
+	(*lpPageOut) = lpNewPage;
 	return cjsonE_Ok;
 }
+
+enum cjsonError cjsonArray_Create(
+	struct cjsonValue**	lpArrayOut,
+	struct cjsonSystemAPI* lpSystem
+) {
+	return cjsonArray_CreateSized(lpArrayOut, CJSON_BLOCKSIZE_ARRAY, lpSystem);
+}
 unsigned long int cjsonArray_Length(
 	const struct cjsonValue* lpArray
 ) {
@@ -104,16 +165,19 @@ enum cjsonError cjsonArray_Set(
 
 	lpOld = lpCurPage->entries[idx-dwCurBase];
 	lpCurPage->entries[idx-dwCurBase] = lpIn;
+	if(lpThis->lpHooks != NULL) {
+		cjsonArray_Notify(lpThis, cjsonArray_HookEvent__Removed, lpOld);
+		cjsonArray_Notify(lpThis, cjsonArray_HookEvent__Added, lpIn);
+	}
 	if(lpOld != NULL) { cjsonReleaseValue(lpOld); } /* Release old entry */
 
 	return cjsonE_Ok;
 }
-enum cjsonError cjsonArray_Push(
+static enum cjsonError cjsonArray_PushEntry(
 	struct cjsonValue* 	lpArray,
 	struct cjsonValue* 	lpValue
 ) {
 	enum cjsonError e;
-	unsigned long int i;
 	struct cjsonArray* lpThis = (struct cjsonArray*)lpArray;
 	struct cjsonArray_Page* lpNewPage;
 
@@ -122,17 +186,10 @@ enum cjsonError cjsonArray_Push(
 
 	if(lpThis->pageList.lpLastPage == NULL) {
 		/* We insert the first page ... */
-		if(lpThis->base.lpSystem == NULL) {
-			lpNewPage = (struct cjsonArray_Page*)malloc(sizeof(struct cjsonArray_Page)+sizeof(struct cjsonValue*)*lpThis->dwPageSize);
-			if(lpNewPage == NULL) { return cjsonE_OutOfMemory; }
-		} else {
-			e = lpThis->base.lpSystem->alloc(lpThis->base.lpSystem, sizeof(struct cjsonArray_Page)+sizeof(struct cjsonValue*)*lpThis->dwPageSize, (void**)(&lpNewPage));
-			if(e != cjsonE_Ok) { return e; }
-		}
-		lpNewPage->pageList.lpNext = NULL;
-		lpNewPage->pageList.lpPrev = NULL;
+		e = cjsonArray_AllocPage(lpThis, lpThis->dwFirstPageSize, &lpNewPage);
+		if(e != cjsonE_Ok) { return e; }
+		lpThis->dwFirstPageSize = lpThis->dwPageSize;
 		lpNewPage->dwUsedEntries = 1;
-		for(i = 1; i < lpThis->dwPageSize; i=i+1) { lpNewPage->entries[i] = NULL; }
 		lpNewPage->entries[0] = lpValue;
 
 		lpThis->pageList.lpFirstPage = lpNewPage;
@@ -141,7 +198,7 @@ enum cjsonError cjsonArray_Push(
 		return cjsonE_Ok;
 	}
 
-	if(lpThis->pageList.lpLastPage->dwUsedEntries < lpThis->dwPageSize) {
+	if(lpThis->pageList.lpLastPage->dwUsedEntries < lpThis->pageList.lpLastPage->dwCapacity) {
 		/* There are entries available in the last element */
 		lpThis->pageList.lpLastPage->entries[lpThis->pageList.lpLastPage->dwUsedEntries] = lpValue;
 		lpThis->pageList.lpLastPage->dwUsedEntries = lpThis->pageList.lpLastPage->dwUsedEntries + 1;
@@ -149,17 +206,10 @@ enum cjsonError cjsonArray_Push(
 		return cjsonE_Ok;
 	} else {
 		/* We need a new page that will be appended */
-		if(lpThis->base.lpSystem == NULL) {
-			lpNewPage = (struct cjsonArray_Page*)malloc(sizeof(struct cjsonArray_Page)+sizeof(struct cjsonValue*)*lpThis->dwPageSize);
-			if(lpNewPage == NULL) { return cjsonE_OutOfMemory; }
-		} else {
-			e = lpThis->base.lpSystem->alloc(lpThis->base.lpSystem, sizeof(struct cjsonArray_Page)+sizeof(struct cjsonValue*)*lpThis->dwPageSize, (void**)(&lpNewPage));
-			if(e != cjsonE_Ok) { return e; }
-		}
-		lpNewPage->pageList.lpNext = NULL;
+		e = cjsonArray_AllocPage(lpThis, lpThis->dwPageSize, &lpNewPage);
+		if(e != cjsonE_Ok) { return e; }
 		lpNewPage->pageList.lpPrev = lpThis->pageList.lpLastPage;
 		lpNewPage->dwUsedEntries = 1;
-		for(i = 1; i < lpThis->dwPageSize; i=i+1) { lpNewPage->entries[i] = NULL; }
 		lpNewPage->entries[0] = lpValue;
 
 		lpThis->pageList.lpLastPage->pageList.lpNext = lpNewPage;
@@ -168,6 +218,257 @@ enum cjsonError cjsonArray_Push(
 		return cjsonE_Ok;
 	}
 }
+enum cjsonError cjsonArray_Push(
+	struct cjsonValue* 	lpArray,
+	struct cjsonValue* 	lpValue
+) {
+	enum cjsonError e;
+
+	e = cjsonArray_PushEntry(lpArray, lpValue);
+	if((e == cjsonE_Ok) && (((struct cjsonArray*)lpArray)->lpHooks != NULL)) {
+		cjsonArray_Notify((struct cjsonArray*)lpArray, cjsonArray_HookEvent__Added, lpValue);
+	}
+	return e;
+}
+/*
+	Insertion and removal only touch the page that contains the
+	index. A full page is split in half, empty pages are released.
+*/
+static enum cjsonError cjsonArray_LocatePage(
+	struct cjsonArray* lpThis,
+	unsigned long int idx,
+	struct cjsonArray_Page** lpPageOut,
+	unsigned long int* lpOffsetOut
+) {
+	struct cjsonArray_Page* lpCurPage;
+	unsigned long int dwCurBase;
+
+	lpCurPage = lpThis->pageList.lpFirstPage;
+	if(lpCurPage == NULL) { return cjsonE_ImplementationError; }
+	dwCurBase = 0;
+
+	while(idx >= dwCurBase+lpCurPage->dwUsedEntries) {
+		dwCurBase = dwCurBase + lpCurPage->dwUsedEntries;
+		lpCurPage = lpCurPage->pageList.lpNext;
+		if(lpCurPage == NULL) { return cjsonE_ImplementationError; }
+	}
+
+	(*lpPageOut) = lpCurPage;
+	(*lpOffsetOut) = idx - dwCurBase;
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonArray_Insert(
+	struct cjsonValue* 	lpArray,
+	unsigned long int 	idx,
+	struct cjsonValue* 	lpValue
+) {
+	enum cjsonError e;
+	struct cjsonArray* lpThis = (struct cjsonArray*)lpArray;
+	struct cjsonArray_Page* lpPage;
+	struct cjsonArray_Page* lpNewPage;
+	unsigned long int dwOffset;
+	unsigned long int dwMove;
+
+	if(lpArray == NULL) { return cjsonE_InvalidParam; }
+	if(lpArray->type != cjsonArray) { return cjsonE_InvalidParam; }
+
+	if(idx > lpThis->dwElementCount) { return cjsonE_IndexOutOfBounds; }
+	if(idx == lpThis->dwElementCount) { return cjsonArray_Push(lpArray, lpValue); }
+
+	e = cjsonArray_LocatePage(lpThis, idx, &lpPage, &dwOffset);
+	if(e != cjsonE_Ok) { return e; }
+
+	if(lpPage->dwUsedEntries == lpPage->dwCapacity) {
+		/* Split the page, the upper half is moved into a new page behind it (with room for the inserted element) */
+		dwMove = (lpPage->dwUsedEntries + 1) / 2;
+		e = cjsonArray_AllocPage(lpThis, (dwMove < lpThis->dwPageSize) ? lpThis->dwPageSize : dwMove + 1, &lpNewPage);
+		if(e != cjsonE_Ok) { return e; }
+
+		memcpy(lpNewPage->entries, &(lpPage->entries[lpPage->dwUsedEntries - dwMove]), sizeof(struct cjsonValue*)*dwMove);
+		lpNewPage->dwUsedEntries = dwMove;
+		lpPage->dwUsedEntries = lpPage->dwUsedEntries - dwMove;
+
+		lpNewPage->pageList.lpPrev = lpPage;
+		lpNewPage->pageList.lpNext = lpPage->pageList.lpNext;
+		if(lpPage->pageList.lpNext != NULL) { lpPage->pageList.lpNext->pageList.lpPrev = lpNewPage; } else { lpThis->pageList.lpLastPage = lpNewPage; }
+		lpPage->pageList.lpNext = lpNewPage;
+
+		if(dwOffset > lpPage->dwUsedEntries) {
+			dwOffset = dwOffset - lpPage->dwUsedEntries;
+			lpPage = lpNewPage;
+		}
+	}
+
+	memmove(&(lpPage->entries[dwOffset+1]), &(lpPage->entries[dwOffset]), sizeof(struct cjsonValue*)*(lpPage->dwUsedEntries - dwOffset));
+	lpPage->entries[dwOffset] = lpValue;
+	lpPage->dwUsedEntries = lpPage->dwUsedEntries + 1;
+	lpThis->dwElementCount = lpThis->dwElementCount + 1;
+	if(lpThis->lpHooks != NULL) { cjsonArray_Notify(lpThis, cjsonArray_HookEvent__Added, lpValue); }
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonArray_Remove(
+	struct cjsonValue* 	lpArray,
+	unsigned long int 	idx,
+	struct cjsonValue** lpOut
+) {
+	enum cjsonError e;
+	struct cjsonArray* lpThis = (struct cjsonArray*)lpArray;
+	struct cjsonArray_Page* lpPage;
+	struct cjsonValue* lpOld;
+	unsigned long int dwOffset;
+
+	if(lpOut != NULL) { (*lpOut) = NULL; }
+
+	if(lpArray == NULL) { return cjsonE_InvalidParam; }
+	if(lpArray->type != cjsonArray) { return cjsonE_InvalidParam; }
+
+	if(idx >= lpThis->dwElementCount) { return cjsonE_IndexOutOfBounds; }
+
+	e = cjsonArray_LocatePage(lpThis, idx, &lpPage, &dwOffset);
+	if(e != cjsonE_Ok) { return e; }
+
+	lpOld = lpPage->entries[dwOffset];
+	memmove(&(lpPage->entries[dwOffset]), &(lpPage->entries[dwOffset+1]), sizeof(struct cjsonValue*)*(lpPage->dwUsedEntries - dwOffset - 1));
+	lpPage->dwUsedEntries = lpPage->dwUsedEntries - 1;
+	lpPage->entries[lpPage->dwUsedEntries] = NULL;
+	lpThis->dwElementCount = lpThis->dwElementCount - 1;
+
+	if(lpPage->dwUsedEntries == 0) {
+		if(lpPage->pageList.lpPrev != NULL) { lpPage->pageList.lpPrev->pageList.lpNext = lpPage->pageList.lpNext; } else { lpThis->pageList.lpFirstPage = lpPage->pageList.lpNext; }
+		if(lpPage->pageList.lpNext != NULL) { lpPage->pageList.lpNext->pageList.lpPrev = lpPage->pageList.lpPrev; } else { lpThis->pageList.lpLastPage = lpPage->pageList.lpPrev; }
+
+		if(lpThis->base.lpSystem == NULL) {
+			free((void*)lpPage);
+		} else {
+			lpThis->base.lpSystem->free(lpThis->base.lpSystem, (void*)lpPage);
+		}
+	}
+
+	if(lpThis->lpHooks != NULL) { cjsonArray_Notify(lpThis, cjsonArray_HookEvent__Removed, lpOld); }
+
+	/* Either hand the value to the caller or release it */
+	if(lpOut != NULL) {
+		(*lpOut) = lpOld;
+	} else if(lpOld != NULL) {
+		cjsonReleaseValue(lpOld);
+	}
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonArray_PushShared(
+	struct cjsonValue* 	lpArray,
+	struct cjsonValue* 	lpValue
+) {
+	enum cjsonError e;
+
+	if(lpValue == NULL) { return cjsonE_InvalidParam; }
+
+	cjsonValue_Retain(lpValue);
+	e = cjsonArray_Push(lpArray, lpValue);
+	if(e != cjsonE_Ok) {
+		/* The caller still owns a reference, this can never drop to zero */
+		CJSON_ATOMIC_DECREMENT(lpValue->dwRefCount);
+	}
+	return e;
+}
+/*
+	Pages are moved if both arrays use the same system API (pages
+	of different capacity and partially used pages in the middle
+	are fine), otherwise the elements are pushed one by one.
+*/
+enum cjsonError cjsonArray_Concat(
+	struct cjsonValue* 	lpArray,
+	struct cjsonValue* 	lpOther
+) {
+	enum cjsonError e;
+	struct cjsonArray* lpThis = (struct cjsonArray*)lpArray;
+	struct cjsonArray* lpSource = (struct cjsonArray*)lpOther;
+	struct cjsonArray_Page* lpCurPage;
+	unsigned long int i;
+
+	if((lpArray == NULL) || (lpOther == NULL)) { return cjsonE_InvalidParam; }
+	if((lpArray->type != cjsonArray) || (lpOther->type != cjsonArray)) { return cjsonE_InvalidParam; }
+	if(lpArray == lpOther) { return cjsonE_InvalidParam; }
+
+	if((lpSource->base.dwRefCount == 1) && (lpSource->base.lpSystem == lpThis->base.lpSystem)) {
+		if(lpSource->pageList.lpFirstPage != NULL) {
+			if(lpThis->lpHooks != NULL) {
+				for(lpCurPage = lpSource->pageList.lpFirstPage; lpCurPage != NULL; lpCurPage = lpCurPage->pageList.lpNext) {
+					for(i = 0; i < lpCurPage->dwUsedEntries; i=i+1) { cjsonArray_Notify(lpThis, cjsonArray_HookEvent__Added, lpCurPage->entries[i]); }
+				}
+			}
+			if(lpThis->pageList.lpLastPage == NULL) {
+				lpThis->pageList.lpFirstPage = lpSource->pageList.lpFirstPage;
+			} else {
+				lpThis->pageList.lpLastPage->pageList.lpNext = lpSource->pageList.lpFirstPage;
+				lpSource->pageList.lpFirstPage->pageList.lpPrev = lpThis->pageList.lpLastPage;
+			}
+			lpThis->pageList.lpLastPage = lpSource->pageList.lpLastPage;
+			lpThis->dwElementCount = lpThis->dwElementCount + lpSource->dwElementCount;
+
+			lpSource->pageList.lpFirstPage = NULL;
+			lpSource->pageList.lpLastPage = NULL;
+			lpSource->dwElementCount = 0;
+		}
+		cjsonReleaseValue(lpOther);
+		return cjsonE_Ok;
+	}
+
+	/* Shared or incompatible: every element gets a new reference from us */
+	for(lpCurPage = lpSource->pageList.lpFirstPage; lpCurPage != NULL; lpCurPage = lpCurPage->pageList.lpNext) {
+		for(i = 0; i < lpCurPage->dwUsedEntries; i=i+1) {
+			if(lpCurPage->entries[i] == NULL) { continue; }
+			e = cjsonArray_PushShared(lpArray, lpCurPage->entries[i]);
+			if(e != cjsonE_Ok) { return e; }
+		}
+	}
+	cjsonReleaseValue(lpOther);
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonArray_GetMutable(
+	struct cjsonValue* 	lpArray,
+	unsigned long int 	idx,
+	struct cjsonValue** lpOut
+) {
+	enum cjsonError e;
+	struct cjsonArray* lpThis = (struct cjsonArray*)lpArray;
+	struct cjsonArray_Page* lpCurPage;
+	struct cjsonValue* lpOld;
+	unsigned long int dwCurBase;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+
+	if(lpArray == NULL) { return cjsonE_InvalidParam; }
+	if(lpArray->type != cjsonArray) { return cjsonE_InvalidParam; }
+
+	if(idx >= lpThis->dwElementCount) { return cjsonE_IndexOutOfBounds; }
+
+	/* Locate the page this entry is located at */
+	lpCurPage = lpThis->pageList.lpFirstPage;
+	if(lpCurPage == NULL) { return cjsonE_ImplementationError; }
+	dwCurBase = 0;
+
+	while(idx >= dwCurBase+lpCurPage->dwUsedEntries) {
+		dwCurBase = dwCurBase + lpCurPage->dwUsedEntries;
+		lpCurPage = lpCurPage->pageList.lpNext;
+		if(lpCurPage == NULL) { return cjsonE_ImplementationError; }
+	}
+
+	lpOld = lpCurPage->entries[idx-dwCurBase];
+	if(lpOld != NULL) {
+		e = cjsonValue_Unshare(&(lpCurPage->entries[idx-dwCurBase]));
+		if(e != cjsonE_Ok) { return e; }
+
+		/* The old value is still referenced by its other owners */
+		if((lpThis->lpHooks != NULL) && (lpCurPage->entries[idx-dwCurBase] != lpOld)) {
+			cjsonArray_Notify(lpThis, cjsonArray_HookEvent__Removed, lpOld);
+			cjsonArray_Notify(lpThis, cjsonArray_HookEvent__Added, lpCurPage->entries[idx-dwCurBase]);
+		}
+	}
+
+	(*lpOut) = lpCurPage->entries[idx-dwCurBase];
+	return cjsonE_Ok;
+}
 
 enum cjsonError cjsonArray_Iterate(
 	struct cjsonValue* lpArray,
@@ -200,6 +501,38 @@ enum cjsonError cjsonArray_Iterate(
 	return cjsonE_Ok;
 }
 
+enum cjsonError cjsonArray_AttachHook(
+	struct cjsonValue* lpArray,
+	struct cjsonArray_Hook* lpHook
+) {
+	struct cjsonArray* lpThis = (struct cjsonArray*)lpArray;
+
+	if((lpArray == NULL) || (lpHook == NULL) || (lpHook->callback == NULL)) { return cjsonE_InvalidParam; }
+	if(lpArray->type != cjsonArray) { return cjsonE_InvalidParam; }
+
+	lpHook->lpNext = lpThis->lpHooks;
+	lpThis->lpHooks = lpHook;
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonArray_DetachHook(
+	struct cjsonValue* lpArray,
+	struct cjsonArray_Hook* lpHook
+) {
+	struct cjsonArray_Hook** lpLink;
+
+	if((lpArray == NULL) || (lpHook == NULL)) { return cjsonE_InvalidParam; }
+	if(lpArray->type != cjsonArray) { return cjsonE_InvalidParam; }
+
+	for(lpLink = &(((struct cjsonArray*)lpArray)->lpHooks); (*lpLink) != NULL; lpLink = &((*lpLink)->lpNext)) {
+		if((*lpLink) == lpHook) {
+			(*lpLink) = lpHook->lpNext;
+			lpHook->lpNext = NULL;
+			return cjsonE_Ok;
+		}
+	}
+	return cjsonE_IndexOutOfBounds;
+}
+
 #ifdef __cplusplus
 	} /* extern "C" { */
 #endif
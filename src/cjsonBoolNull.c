@@ -24,6 +24,7 @@ enum cjsonError cjsonTrue_Create(
 
 	(*lpOut)->type 		= cjsonTrue;
 	(*lpOut)->lpSystem 	= lpSystem;
+	(*lpOut)->dwRefCount 	= 1;
 
 	return cjsonE_Ok;
 }
@@ -46,6 +47,7 @@ enum cjsonError cjsonFalse_Create(
 
 	(*lpOut)->type 		= cjsonFalse;
 	(*lpOut)->lpSystem 	= lpSystem;
+	(*lpOut)->dwRefCount 	= 1;
 
 	return cjsonE_Ok;
 }
@@ -68,6 +70,7 @@ enum cjsonError cjsonNull_Create(
 
 	(*lpOut)->type 		= cjsonNull;
 	(*lpOut)->lpSystem 	= lpSystem;
+	(*lpOut)->dwRefCount 	= 1;
 
 	return cjsonE_Ok;
 }
@@ -0,0 +1,827 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_CBOR_INITIALFRAMES
+	#define CJSON_CBOR_INITIALFRAMES 16				/* Initial capacity of the encoder and decoder stacks */
+#endif
+#ifndef CJSON_CBOR_MAXSIZEHINT
+	#define CJSON_CBOR_MAXSIZEHINT 4096				/* Largest announced container size used to presize arrays and objects */
+#endif
+#ifndef CJSON_CBOR_TEXTBUFFER
+	#define CJSON_CBOR_TEXTBUFFER 64				/* Initial buffer size for indefinite length text strings */
+#endif
+#ifndef CJSON_CBOR_MAXTEXTLENGTH
+	#define CJSON_CBOR_MAXTEXTLENGTH 67108864		/* Longest accepted text string, longer announced lengths are rejected before allocating */
+#endif
+
+#define CJSON_CBOR_MAJOR_UNSIGNED		0
+#define CJSON_CBOR_MAJOR_NEGATIVE		1
+#define CJSON_CBOR_MAJOR_BYTES			2
+#define CJSON_CBOR_MAJOR_TEXT			3
+#define CJSON_CBOR_MAJOR_ARRAY			4
+#define CJSON_CBOR_MAJOR_MAP			5
+#define CJSON_CBOR_MAJOR_TAG			6
+#define CJSON_CBOR_MAJOR_SIMPLE			7
+
+#define CJSON_CBOR_SIMPLE_FALSE			0xF4
+#define CJSON_CBOR_SIMPLE_TRUE			0xF5
+#define CJSON_CBOR_SIMPLE_NULL			0xF6
+#define CJSON_CBOR_SIMPLE_UNDEFINED		0xF7
+#define CJSON_CBOR_FLOAT16				0xF9
+#define CJSON_CBOR_FLOAT32				0xFA
+#define CJSON_CBOR_FLOAT64				0xFB
+#define CJSON_CBOR_BREAK				0xFF
+
+/*
+	Malloc and free abstraction
+*/
+static inline enum cjsonError cjsonCbor_Alloc(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpSystem->alloc(lpSystem, dwSize, lpOut);
+	}
+}
+static inline void cjsonCbor_Free(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+
+/*
+	Grows a stack of dwFrameSize byte frames to at least one free slot
+*/
+static enum cjsonError cjsonCbor_GrowStack(
+	struct cjsonSystemAPI* lpSystem,
+	void** lpFrames,
+	unsigned long int dwFrameCount,
+	unsigned long int* lpFrameCapacity,
+	unsigned long int dwFrameSize
+) {
+	enum cjsonError e;
+	unsigned long int dwNewCapacity;
+	void* lpNew;
+
+	if(dwFrameCount < (*lpFrameCapacity)) { return cjsonE_Ok; }
+
+	dwNewCapacity = ((*lpFrameCapacity) == 0) ? CJSON_CBOR_INITIALFRAMES : (*lpFrameCapacity) * 2;
+	e = cjsonCbor_Alloc(lpSystem, dwNewCapacity * dwFrameSize, &lpNew);
+	if(e != cjsonE_Ok) { return e; }
+
+	if((*lpFrames) != NULL) {
+		memcpy(lpNew, (*lpFrames), dwFrameCount * dwFrameSize);
+		cjsonCbor_Free(lpSystem, (*lpFrames));
+	}
+	(*lpFrames) = lpNew;
+	(*lpFrameCapacity) = dwNewCapacity;
+	return cjsonE_Ok;
+}
+
+/*
+	Encoder
+*/
+static void cjsonCborEncoder_Header(
+	struct cjsonCborEncoder* lpEncoder,
+	unsigned int dwMajor,
+	uint64_t qwArgument
+) {
+	unsigned long int dwBytes;
+	unsigned long int i;
+
+	dwMajor = dwMajor << 5;
+	if(qwArgument < 24) {
+		lpEncoder->bHeader[0] = (uint8_t)(dwMajor | qwArgument);
+		lpEncoder->dwHeaderLength = 1;
+	} else {
+		if(qwArgument <= 0xFF) { dwBytes = 1; lpEncoder->bHeader[0] = (uint8_t)(dwMajor | 24); }
+		else if(qwArgument <= 0xFFFF) { dwBytes = 2; lpEncoder->bHeader[0] = (uint8_t)(dwMajor | 25); }
+		else if(qwArgument <= 0xFFFFFFFFULL) { dwBytes = 4; lpEncoder->bHeader[0] = (uint8_t)(dwMajor | 26); }
+		else { dwBytes = 8; lpEncoder->bHeader[0] = (uint8_t)(dwMajor | 27); }
+
+		/* Arguments are big endian */
+		for(i = 0; i < dwBytes; i=i+1) {
+			lpEncoder->bHeader[dwBytes - i] = (uint8_t)(qwArgument >> (8 * i));
+		}
+		lpEncoder->dwHeaderLength = dwBytes + 1;
+	}
+	lpEncoder->dwHeaderWritten = 0;
+}
+static void cjsonCborEncoder_Double(
+	struct cjsonCborEncoder* lpEncoder,
+	double dValue
+) {
+	float fValue = (float)dValue;
+	uint64_t qwBits;
+	uint32_t dwBits;
+	unsigned long int i;
+
+	if((double)fValue == dValue) {
+		memcpy(&dwBits, &fValue, sizeof(dwBits));
+		lpEncoder->bHeader[0] = CJSON_CBOR_FLOAT32;
+		for(i = 0; i < 4; i=i+1) { lpEncoder->bHeader[4 - i] = (uint8_t)(dwBits >> (8 * i)); }
+		lpEncoder->dwHeaderLength = 5;
+	} else {
+		/* Also used for NaN since the comparison above fails */
+		memcpy(&qwBits, &dValue, sizeof(qwBits));
+		lpEncoder->bHeader[0] = CJSON_CBOR_FLOAT64;
+		for(i = 0; i < 8; i=i+1) { lpEncoder->bHeader[8 - i] = (uint8_t)(qwBits >> (8 * i)); }
+		lpEncoder->dwHeaderLength = 9;
+	}
+	lpEncoder->dwHeaderWritten = 0;
+}
+
+/*
+	Prepares the output of a single value. Non empty containers are
+	pushed onto the stack and emit their children afterwards.
+*/
+static enum cjsonError cjsonCborEncoder_Emit(
+	struct cjsonCborEncoder* lpEncoder,
+	struct cjsonValue* lpValue
+) {
+	enum cjsonError e;
+	struct cjsonCborEncoder_Frame* lpFrame;
+	unsigned long int dwCount;
+
+	if(lpValue == NULL) {
+		lpEncoder->bHeader[0] = CJSON_CBOR_SIMPLE_NULL;
+		lpEncoder->dwHeaderLength = 1;
+		lpEncoder->dwHeaderWritten = 0;
+		return cjsonE_Ok;
+	}
+
+	switch(lpValue->type) {
+		case cjsonNumber_UnsignedLong:
+			cjsonCborEncoder_Header(lpEncoder, CJSON_CBOR_MAJOR_UNSIGNED, (uint64_t)(((struct cjsonNumber*)lpValue)->value.ulong));
+			return cjsonE_Ok;
+		case cjsonNumber_SignedLong:
+			if(((struct cjsonNumber*)lpValue)->value.slong >= 0) {
+				cjsonCborEncoder_Header(lpEncoder, CJSON_CBOR_MAJOR_UNSIGNED, (uint64_t)(((struct cjsonNumber*)lpValue)->value.slong));
+			} else {
+				cjsonCborEncoder_Header(lpEncoder, CJSON_CBOR_MAJOR_NEGATIVE, (uint64_t)(-1 - ((struct cjsonNumber*)lpValue)->value.slong));
+			}
+			return cjsonE_Ok;
+		case cjsonNumber_Double:
+			cjsonCborEncoder_Double(lpEncoder, ((struct cjsonNumber*)lpValue)->value.dbl);
+			return cjsonE_Ok;
+		case cjsonTrue:
+		case cjsonFalse:
+		case cjsonNull:
+			lpEncoder->bHeader[0] = (lpValue->type == cjsonTrue) ? CJSON_CBOR_SIMPLE_TRUE : ((lpValue->type == cjsonFalse) ? CJSON_CBOR_SIMPLE_FALSE : CJSON_CBOR_SIMPLE_NULL);
+			lpEncoder->dwHeaderLength = 1;
+			lpEncoder->dwHeaderWritten = 0;
+			return cjsonE_Ok;
+		case cjsonString:
+			cjsonCborEncoder_Header(lpEncoder, CJSON_CBOR_MAJOR_TEXT, (uint64_t)(((struct cjsonString*)lpValue)->dwStrlen));
+			lpEncoder->lpPayload = ((struct cjsonString*)lpValue)->bData;
+			lpEncoder->dwPayloadLength = ((struct cjsonString*)lpValue)->dwStrlen;
+			lpEncoder->dwPayloadWritten = 0;
+			return cjsonE_Ok;
+		case cjsonArray:
+		case cjsonObject:
+			dwCount = (lpValue->type == cjsonArray) ? ((struct cjsonArray*)lpValue)->dwElementCount : ((struct cjsonObject*)lpValue)->dwElementCount;
+			if(dwCount > 0) {
+				e = cjsonCbor_GrowStack(lpEncoder->lpSystem, (void**)(&(lpEncoder->lpFrames)), lpEncoder->dwFrameCount, &(lpEncoder->dwFrameCapacity), sizeof(struct cjsonCborEncoder_Frame));
+				if(e != cjsonE_Ok) { return e; }
+
+				lpFrame = &(lpEncoder->lpFrames[lpEncoder->dwFrameCount]);
+				lpFrame->lpContainer = lpValue;
+				lpFrame->lpPage = (lpValue->type == cjsonArray) ? ((struct cjsonArray*)lpValue)->pageList.lpFirstPage : NULL;
+				lpFrame->dwEntry = 0;
+				lpFrame->dwBucket = 0;
+				lpFrame->lpEntry = NULL;
+				lpEncoder->dwFrameCount = lpEncoder->dwFrameCount + 1;
+			}
+			cjsonCborEncoder_Header(lpEncoder, (lpValue->type == cjsonArray) ? CJSON_CBOR_MAJOR_ARRAY : CJSON_CBOR_MAJOR_MAP, (uint64_t)dwCount);
+			return cjsonE_Ok;
+		default:
+			return cjsonE_ImplementationError;
+	}
+}
+
+/*
+	Selects the next item of the top container. Returns cjsonE_Finished
+	if the stack is empty.
+*/
+static enum cjsonError cjsonCborEncoder_Next(
+	struct cjsonCborEncoder* lpEncoder
+) {
+	struct cjsonCborEncoder_Frame* lpFrame;
+	struct cjsonObject* lpObject;
+
+	while(lpEncoder->dwFrameCount > 0) {
+		lpFrame = &(lpEncoder->lpFrames[lpEncoder->dwFrameCount - 1]);
+
+		if(lpFrame->lpContainer->type == cjsonArray) {
+			while((lpFrame->lpPage != NULL) && (lpFrame->dwEntry >= lpFrame->lpPage->dwUsedEntries)) {
+				lpFrame->lpPage = lpFrame->lpPage->pageList.lpNext;
+				lpFrame->dwEntry = 0;
+			}
+			if(lpFrame->lpPage != NULL) {
+				lpFrame->dwEntry = lpFrame->dwEntry + 1;
+				return cjsonCborEncoder_Emit(lpEncoder, lpFrame->lpPage->entries[lpFrame->dwEntry - 1]);
+			}
+		} else {
+			lpObject = (struct cjsonObject*)(lpFrame->lpContainer);
+			if(lpFrame->lpEntry != NULL) { lpFrame->lpEntry = lpFrame->lpEntry->bucketList.lpNext; }
+			while((lpFrame->lpEntry == NULL) && (lpFrame->dwBucket < lpObject->dwBucketCount)) {
+				lpFrame->lpEntry = lpObject->buckets[lpFrame->dwBucket];
+				lpFrame->dwBucket = lpFrame->dwBucket + 1;
+			}
+			if(lpFrame->lpEntry != NULL) {
+				/* Key first, the value is emitted after the key has been written */
+				cjsonCborEncoder_Header(lpEncoder, CJSON_CBOR_MAJOR_TEXT, (uint64_t)(lpFrame->lpEntry->dwKeyLength));
+				lpEncoder->lpPayload = lpFrame->lpEntry->bKey;
+				lpEncoder->dwPayloadLength = lpFrame->lpEntry->dwKeyLength;
+				lpEncoder->dwPayloadWritten = 0;
+				lpEncoder->lpPendingValue = lpFrame->lpEntry->lpValue;
+				return cjsonE_Ok;
+			}
+		}
+
+		/* Container is done */
+		lpEncoder->dwFrameCount = lpEncoder->dwFrameCount - 1;
+	}
+	return cjsonE_Finished;
+}
+
+enum cjsonError cjsonCborEncoder_Create(
+	struct cjsonCborEncoder** lpOut,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam,
+	uint32_t dwFlags,
+	struct cjsonSystemAPI* lpSystem
+) {
+	enum cjsonError e;
+	struct cjsonCborEncoder* lpNew;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+
+	if(callback == NULL) { return cjsonE_InvalidParam; }
+	if(dwFlags != 0) { return cjsonE_InvalidParam; }
+
+	e = cjsonCbor_Alloc(lpSystem, sizeof(struct cjsonCborEncoder), (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpNew->lpFrames					= NULL;
+	lpNew->dwFrameCount				= 0;
+	lpNew->dwFrameCapacity			= 0;
+	lpNew->dwHeaderLength			= 0;
+	lpNew->dwHeaderWritten			= 0;
+	lpNew->lpPayload				= NULL;
+	lpNew->dwPayloadLength			= 0;
+	lpNew->dwPayloadWritten			= 0;
+	lpNew->lpPendingValue			= NULL;
+	lpNew->dwFlags					= dwFlags;
+	lpNew->lpSystem					= lpSystem;
+	lpNew->callbackWriteBytes		= callback;
+	lpNew->callbackWriteBytesParam	= callbackFreeParam;
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonCborEncoder_Encode(
+	struct cjsonCborEncoder* lpEncoder,
+	struct cjsonValue* lpValue
+) {
+	enum cjsonError e;
+
+	if(lpEncoder == NULL) { return cjsonE_InvalidParam; }
+	if(lpValue == NULL) { return cjsonE_InvalidParam; }
+
+	/* The previous document has to be finished */
+	if((lpEncoder->dwFrameCount != 0) || (lpEncoder->dwHeaderWritten < lpEncoder->dwHeaderLength) || (lpEncoder->dwPayloadWritten < lpEncoder->dwPayloadLength) || (lpEncoder->lpPendingValue != NULL)) {
+		return cjsonE_InvalidState;
+	}
+
+	e = cjsonCborEncoder_Emit(lpEncoder, lpValue);
+	if(e != cjsonE_Ok) { return e; }
+	return cjsonCborEncoder_Continue(lpEncoder);
+}
+enum cjsonError cjsonCborEncoder_Continue(
+	struct cjsonCborEncoder* lpEncoder
+) {
+	enum cjsonError e;
+	unsigned long int dwBytesWritten;
+	struct cjsonValue* lpValue;
+
+	if(lpEncoder == NULL) { return cjsonE_InvalidParam; }
+
+	for(;;) {
+		while(lpEncoder->dwHeaderWritten < lpEncoder->dwHeaderLength) {
+			dwBytesWritten = 0;
+			e = lpEncoder->callbackWriteBytes((char*)&(lpEncoder->bHeader[lpEncoder->dwHeaderWritten]), lpEncoder->dwHeaderLength - lpEncoder->dwHeaderWritten, &dwBytesWritten, lpEncoder->callbackWriteBytesParam);
+			lpEncoder->dwHeaderWritten = lpEncoder->dwHeaderWritten + dwBytesWritten;
+			if(e != cjsonE_Ok) { return e; }
+		}
+		while(lpEncoder->dwPayloadWritten < lpEncoder->dwPayloadLength) {
+			dwBytesWritten = 0;
+			e = lpEncoder->callbackWriteBytes((char*)&(lpEncoder->lpPayload[lpEncoder->dwPayloadWritten]), lpEncoder->dwPayloadLength - lpEncoder->dwPayloadWritten, &dwBytesWritten, lpEncoder->callbackWriteBytesParam);
+			lpEncoder->dwPayloadWritten = lpEncoder->dwPayloadWritten + dwBytesWritten;
+			if(e != cjsonE_Ok) { return e; }
+		}
+		lpEncoder->dwPayloadLength = 0;
+		lpEncoder->dwPayloadWritten = 0;
+
+		if(lpEncoder->lpPendingValue != NULL) {
+			lpValue = lpEncoder->lpPendingValue;
+			lpEncoder->lpPendingValue = NULL;
+			e = cjsonCborEncoder_Emit(lpEncoder, lpValue);
+		} else {
+			e = cjsonCborEncoder_Next(lpEncoder);
+		}
+		if(e == cjsonE_Finished) { return cjsonE_Ok; }
+		if(e != cjsonE_Ok) { return e; }
+	}
+}
+enum cjsonError cjsonCborEncoder_Release(
+	struct cjsonCborEncoder* lpEncoder
+) {
+	if(lpEncoder == NULL) { return cjsonE_InvalidParam; }
+
+	if(lpEncoder->lpFrames != NULL) { cjsonCbor_Free(lpEncoder->lpSystem, (void*)(lpEncoder->lpFrames)); }
+	cjsonCbor_Free(lpEncoder->lpSystem, (void*)lpEncoder);
+	return cjsonE_Ok;
+}
+
+/*
+	Decoder
+*/
+static double cjsonCborDecoder_HalfToDouble(
+	uint64_t qwHalf
+) {
+	unsigned long int dwExponent = (unsigned long int)((qwHalf >> 10) & 0x1F);
+	unsigned long int dwMantissa = (unsigned long int)(qwHalf & 0x3FF);
+	double dValue;
+
+	if(dwExponent == 0) {
+		dValue = (double)dwMantissa / 16777216.0;					/* 2^-24 */
+	} else if(dwExponent != 31) {
+		dValue = (double)(dwMantissa + 1024) / 1024.0;
+		while(dwExponent > 15) { dValue = dValue * 2.0; dwExponent = dwExponent - 1; }
+		while(dwExponent < 15) { dValue = dValue / 2.0; dwExponent = dwExponent + 1; }
+	} else if(dwMantissa == 0) {
+		dValue = INFINITY;
+	} else {
+		dValue = NAN;
+	}
+	return ((qwHalf & 0x8000) != 0) ? -dValue : dValue;
+}
+
+static enum cjsonError cjsonCborDecoder_PushFrame(
+	struct cjsonCborDecoder* lpDecoder,
+	enum cjsonCborDecoder_FrameType type,
+	struct cjsonValue* lpContainer,
+	int bIndefinite,
+	uint64_t qwRemaining
+) {
+	enum cjsonError e;
+	struct cjsonCborDecoder_Frame* lpFrame;
+
+	e = cjsonCbor_GrowStack(lpDecoder->lpSystem, (void**)(&(lpDecoder->lpFrames)), lpDecoder->dwFrameCount, &(lpDecoder->dwFrameCapacity), sizeof(struct cjsonCborDecoder_Frame));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpFrame = &(lpDecoder->lpFrames[lpDecoder->dwFrameCount]);
+	lpFrame->type = type;
+	lpFrame->bIndefinite = bIndefinite;
+	lpFrame->qwRemaining = qwRemaining;
+	lpFrame->lpContainer = lpContainer;
+	lpFrame->lpKey = NULL;
+	lpFrame->lpBuffer = NULL;
+	lpFrame->dwBufferUsed = 0;
+	lpFrame->dwBufferSize = 0;
+	lpDecoder->dwFrameCount = lpDecoder->dwFrameCount + 1;
+	return cjsonE_Ok;
+}
+static void cjsonCborDecoder_ReleaseFrame(
+	struct cjsonCborDecoder* lpDecoder,
+	struct cjsonCborDecoder_Frame* lpFrame
+) {
+	if(lpFrame->lpContainer != NULL) { cjsonReleaseValue(lpFrame->lpContainer); }
+	if(lpFrame->lpKey != NULL) { cjsonReleaseValue(lpFrame->lpKey); }
+	if(lpFrame->lpBuffer != NULL) { cjsonCbor_Free(lpDecoder->lpSystem, (void*)(lpFrame->lpBuffer)); }
+}
+
+/*
+	Stores a finished value in its parent container. Containers that
+	are complete afterwards are finished themselves, a finished root
+	is passed to the document callback.
+*/
+static enum cjsonError cjsonCborDecoder_Complete(
+	struct cjsonCborDecoder* lpDecoder,
+	struct cjsonValue* lpValue
+) {
+	enum cjsonError e;
+	struct cjsonCborDecoder_Frame* lpFrame;
+
+	for(;;) {
+		if(lpDecoder->dwFrameCount == 0) {
+			if((lpDecoder->dwFlags & CJSON_CBOR_FLAG__STREAMINGMODE) == 0) {
+				lpDecoder->dwFlags = lpDecoder->dwFlags | CJSON_CBOR_FLAG__INTERNAL_DONE;
+			}
+			return lpDecoder->callbackDocumentReady(lpValue, lpDecoder->callbackDocumentReadyFreeParam);
+		}
+
+		lpFrame = &(lpDecoder->lpFrames[lpDecoder->dwFrameCount - 1]);
+		if(lpFrame->type == cjsonCborDecoder_FrameType__Array) {
+			e = cjsonArray_Push(lpFrame->lpContainer, lpValue);
+			if(e != cjsonE_Ok) { cjsonReleaseValue(lpValue); return e; }
+		} else {
+			if(lpFrame->lpKey == NULL) {
+				/* Key type has been checked when its header was read */
+				lpFrame->lpKey = lpValue;
+				return cjsonE_Ok;
+			}
+			e = cjsonObject_Set(lpFrame->lpContainer, ((struct cjsonString*)(lpFrame->lpKey))->bData, ((struct cjsonString*)(lpFrame->lpKey))->dwStrlen, lpValue);
+			cjsonReleaseValue(lpFrame->lpKey);
+			lpFrame->lpKey = NULL;
+			if(e != cjsonE_Ok) { cjsonReleaseValue(lpValue); return e; }
+		}
+
+		if(lpFrame->bIndefinite != 0) { return cjsonE_Ok; }
+		lpFrame->qwRemaining = lpFrame->qwRemaining - 1;
+		if(lpFrame->qwRemaining > 0) { return cjsonE_Ok; }
+
+		/* The container is complete and stored in its parent */
+		lpValue = lpFrame->lpContainer;
+		lpDecoder->dwFrameCount = lpDecoder->dwFrameCount - 1;
+	}
+}
+
+/*
+	Handles a break code (end of an indefinite length item)
+*/
+static enum cjsonError cjsonCborDecoder_Break(
+	struct cjsonCborDecoder* lpDecoder
+) {
+	enum cjsonError e;
+	struct cjsonCborDecoder_Frame* lpFrame;
+	struct cjsonValue* lpValue;
+
+	if(lpDecoder->dwFrameCount == 0) { return cjsonE_EncodingError; }
+	lpFrame = &(lpDecoder->lpFrames[lpDecoder->dwFrameCount - 1]);
+	if(lpFrame->bIndefinite == 0) { return cjsonE_EncodingError; }
+	if(lpFrame->lpKey != NULL) { return cjsonE_EncodingError; }		/* Map key without value */
+
+	if(lpFrame->type == cjsonCborDecoder_FrameType__Text) {
+		e = cjsonString_Create(&lpValue, lpFrame->lpBuffer, lpFrame->dwBufferUsed, lpDecoder->lpSystem);
+		if(e != cjsonE_Ok) { return e; }
+		if(lpFrame->lpBuffer != NULL) { cjsonCbor_Free(lpDecoder->lpSystem, (void*)(lpFrame->lpBuffer)); }
+	} else {
+		lpValue = lpFrame->lpContainer;
+	}
+
+	lpDecoder->dwFrameCount = lpDecoder->dwFrameCount - 1;
+	return cjsonCborDecoder_Complete(lpDecoder, lpValue);
+}
+
+/*
+	Starts the payload of a definite length text string
+*/
+static enum cjsonError cjsonCborDecoder_Text(
+	struct cjsonCborDecoder* lpDecoder,
+	uint64_t qwLength
+) {
+	enum cjsonError e;
+	struct cjsonCborDecoder_Frame* lpFrame;
+	unsigned long int dwNewSize;
+	char* lpNewBuffer;
+	struct cjsonValue* lpValue;
+
+	/* The payload is allocated before it arrives, so announced lengths are limited */
+	if(qwLength > (uint64_t)CJSON_CBOR_MAXTEXTLENGTH) { return cjsonE_EncodingError; }
+
+	lpFrame = (lpDecoder->dwFrameCount > 0) ? &(lpDecoder->lpFrames[lpDecoder->dwFrameCount - 1]) : NULL;
+	if((lpFrame != NULL) && (lpFrame->type == cjsonCborDecoder_FrameType__Text)) {
+		/* Chunk of an indefinite length string, appended to the frame buffer */
+		if(qwLength > (uint64_t)(ULONG_MAX - lpFrame->dwBufferUsed)) { return cjsonE_EncodingError; }
+		if(lpFrame->dwBufferUsed + qwLength > (uint64_t)CJSON_CBOR_MAXTEXTLENGTH) { return cjsonE_EncodingError; }
+		if(lpFrame->dwBufferUsed + qwLength > lpFrame->dwBufferSize) {
+			dwNewSize = (lpFrame->dwBufferSize == 0) ? CJSON_CBOR_TEXTBUFFER : lpFrame->dwBufferSize;
+			while(dwNewSize < lpFrame->dwBufferUsed + qwLength) {
+				if(dwNewSize > ULONG_MAX / 2) {
+					dwNewSize = lpFrame->dwBufferUsed + (unsigned long int)qwLength;
+					break;
+				}
+				dwNewSize = dwNewSize * 2;
+			}
+
+			e = cjsonCbor_Alloc(lpDecoder->lpSystem, dwNewSize, (void**)(&lpNewBuffer));
+			if(e != cjsonE_Ok) { return e; }
+			if(lpFrame->lpBuffer != NULL) {
+				memcpy(lpNewBuffer, lpFrame->lpBuffer, lpFrame->dwBufferUsed);
+				cjsonCbor_Free(lpDecoder->lpSystem, (void*)(lpFrame->lpBuffer));
+			}
+			lpFrame->lpBuffer = lpNewBuffer;
+			lpFrame->dwBufferSize = dwNewSize;
+		}
+		lpDecoder->lpString = NULL;
+		lpDecoder->lpPayloadTarget = &(lpFrame->lpBuffer[lpFrame->dwBufferUsed]);
+	} else {
+		/* The string is filled in place */
+		e = cjsonString_Create(&lpValue, NULL, (unsigned long int)qwLength, lpDecoder->lpSystem);
+		if(e != cjsonE_Ok) { return e; }
+		if(qwLength == 0) { return cjsonCborDecoder_Complete(lpDecoder, lpValue); }
+
+		lpDecoder->lpString = lpValue;
+		lpDecoder->lpPayloadTarget = ((struct cjsonString*)lpValue)->bData;
+	}
+
+	if(qwLength == 0) { return cjsonE_Ok; }
+	lpDecoder->dwPayloadLength = (unsigned long int)qwLength;
+	lpDecoder->dwPayloadUsed = 0;
+	lpDecoder->state = cjsonCborDecoder_State__Payload;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonCborDecoder_PayloadDone(
+	struct cjsonCborDecoder* lpDecoder
+) {
+	struct cjsonValue* lpValue;
+
+	lpDecoder->state = cjsonCborDecoder_State__Header;
+	if(lpDecoder->lpString == NULL) {
+		lpDecoder->lpFrames[lpDecoder->dwFrameCount - 1].dwBufferUsed = lpDecoder->lpFrames[lpDecoder->dwFrameCount - 1].dwBufferUsed + lpDecoder->dwPayloadLength;
+		return cjsonE_Ok;
+	}
+
+	lpValue = lpDecoder->lpString;
+	lpDecoder->lpString = NULL;
+	return cjsonCborDecoder_Complete(lpDecoder, lpValue);
+}
+
+/*
+	Processes a data item once its initial byte and argument are known
+*/
+static enum cjsonError cjsonCborDecoder_Item(
+	struct cjsonCborDecoder* lpDecoder
+) {
+	enum cjsonError e;
+	unsigned int dwMajor = lpDecoder->bInitialByte >> 5;
+	unsigned int dwInfo = lpDecoder->bInitialByte & 0x1F;
+	uint64_t qwArgument = lpDecoder->qwArgument;
+	struct cjsonValue* lpValue;
+	uint32_t dwSingle;
+	float fValue;
+	double dValue;
+	unsigned long int dwSizeHint;
+
+	lpDecoder->state = cjsonCborDecoder_State__Header;
+
+	switch(dwMajor) {
+		case CJSON_CBOR_MAJOR_UNSIGNED:
+			e = cjsonNumber_Create(&lpValue, lpDecoder->lpSystem);
+			if(e != cjsonE_Ok) { return e; }
+			if(qwArgument <= (uint64_t)ULONG_MAX) {
+				cjsonNumber_SetULong(lpValue, (unsigned long int)qwArgument);
+			} else {
+				cjsonNumber_SetDouble(lpValue, (double)qwArgument);
+			}
+			return cjsonCborDecoder_Complete(lpDecoder, lpValue);
+
+		case CJSON_CBOR_MAJOR_NEGATIVE:
+			e = cjsonNumber_Create(&lpValue, lpDecoder->lpSystem);
+			if(e != cjsonE_Ok) { return e; }
+			if(qwArgument <= (uint64_t)LONG_MAX) {
+				cjsonNumber_SetSLong(lpValue, -1 - (signed long int)qwArgument);
+			} else {
+				cjsonNumber_SetDouble(lpValue, -1.0 - (double)qwArgument);
+			}
+			return cjsonCborDecoder_Complete(lpDecoder, lpValue);
+
+		case CJSON_CBOR_MAJOR_TEXT:
+			if(dwInfo == 31) {
+				return cjsonCborDecoder_PushFrame(lpDecoder, cjsonCborDecoder_FrameType__Text, NULL, 1, 0);
+			}
+			return cjsonCborDecoder_Text(lpDecoder, qwArgument);
+
+		case CJSON_CBOR_MAJOR_ARRAY:
+		case CJSON_CBOR_MAJOR_MAP:
+			/* Announced sizes are untrusted input, they are only used as a bounded hint */
+			dwSizeHint = (dwInfo == 31) ? 0 : ((qwArgument > CJSON_CBOR_MAXSIZEHINT) ? CJSON_CBOR_MAXSIZEHINT : (unsigned long int)qwArgument);
+			if(dwMajor == CJSON_CBOR_MAJOR_ARRAY) {
+				e = cjsonArray_CreateSized(&lpValue, dwSizeHint, lpDecoder->lpSystem);
+			} else {
+				e = cjsonObject_CreateSized(&lpValue, (dwSizeHint == 0) ? CJSON_BLOCKSIZE_OBJECT : dwSizeHint, lpDecoder->lpSystem);
+			}
+			if(e != cjsonE_Ok) { return e; }
+
+			if((dwInfo != 31) && (qwArgument == 0)) { return cjsonCborDecoder_Complete(lpDecoder, lpValue); }
+
+			e = cjsonCborDecoder_PushFrame(lpDecoder, (dwMajor == CJSON_CBOR_MAJOR_ARRAY) ? cjsonCborDecoder_FrameType__Array : cjsonCborDecoder_FrameType__Map, lpValue, (dwInfo == 31) ? 1 : 0, qwArgument);
+			if(e != cjsonE_Ok) { cjsonReleaseValue(lpValue); }
+			return e;
+
+		case CJSON_CBOR_MAJOR_TAG:
+			/* Tags are skipped, the tagged item follows */
+			return cjsonE_Ok;
+
+		case CJSON_CBOR_MAJOR_SIMPLE:
+			switch(dwInfo) {
+				case 20:	e = cjsonFalse_Create(&lpValue, lpDecoder->lpSystem); break;
+				case 21:	e = cjsonTrue_Create(&lpValue, lpDecoder->lpSystem); break;
+				case 22:
+				case 23:	e = cjsonNull_Create(&lpValue, lpDecoder->lpSystem); break;
+				case 25:
+				case 26:
+				case 27:
+					if(dwInfo == 25) {
+						dValue = cjsonCborDecoder_HalfToDouble(qwArgument);
+					} else if(dwInfo == 26) {
+						dwSingle = (uint32_t)qwArgument;
+						memcpy(&fValue, &dwSingle, sizeof(fValue));
+						dValue = (double)fValue;
+					} else {
+						memcpy(&dValue, &qwArgument, sizeof(dValue));
+					}
+					e = cjsonNumber_Create(&lpValue, lpDecoder->lpSystem);
+					if(e != cjsonE_Ok) { return e; }
+					cjsonNumber_SetDouble(lpValue, dValue);
+					break;
+				case 31:
+					return cjsonCborDecoder_Break(lpDecoder);
+				default:
+					return cjsonE_EncodingError;
+			}
+			if(e != cjsonE_Ok) { return e; }
+			return cjsonCborDecoder_Complete(lpDecoder, lpValue);
+
+		default:
+			/* Byte strings have no JSON representation */
+			return cjsonE_EncodingError;
+	}
+}
+
+/*
+	Validates an initial byte against the current context
+*/
+static enum cjsonError cjsonCborDecoder_Initial(
+	struct cjsonCborDecoder* lpDecoder,
+	uint8_t bByte
+) {
+	struct cjsonCborDecoder_Frame* lpFrame;
+	unsigned int dwMajor = bByte >> 5;
+	unsigned int dwInfo = bByte & 0x1F;
+
+	if((lpDecoder->dwFlags & CJSON_CBOR_FLAG__INTERNAL_DONE) != 0) { return cjsonE_AlreadyFinished; }
+
+	if(lpDecoder->dwFrameCount > 0) {
+		lpFrame = &(lpDecoder->lpFrames[lpDecoder->dwFrameCount - 1]);
+		if(bByte != CJSON_CBOR_BREAK) {
+			if(lpFrame->type == cjsonCborDecoder_FrameType__Text) {
+				/* Only definite length text chunks */
+				if((dwMajor != CJSON_CBOR_MAJOR_TEXT) || (dwInfo == 31)) { return cjsonE_EncodingError; }
+			} else if((lpFrame->type == cjsonCborDecoder_FrameType__Map) && (lpFrame->lpKey == NULL)) {
+				if((dwMajor != CJSON_CBOR_MAJOR_TEXT) && (dwMajor != CJSON_CBOR_MAJOR_TAG)) { return cjsonE_EncodingError; }
+			}
+		}
+	}
+
+	if((dwInfo >= 28) && (dwInfo <= 30)) { return cjsonE_EncodingError; }
+	if((dwInfo == 31) && ((dwMajor < CJSON_CBOR_MAJOR_BYTES) || (dwMajor == CJSON_CBOR_MAJOR_TAG))) { return cjsonE_EncodingError; }
+
+	lpDecoder->bInitialByte = bByte;
+	if(dwInfo < 24) {
+		lpDecoder->qwArgument = dwInfo;
+		return cjsonCborDecoder_Item(lpDecoder);
+	}
+	if(dwInfo == 31) {
+		lpDecoder->qwArgument = 0;
+		return cjsonCborDecoder_Item(lpDecoder);
+	}
+
+	lpDecoder->qwArgument = 0;
+	lpDecoder->dwArgumentBytes = 1UL << (dwInfo - 24);
+	lpDecoder->state = cjsonCborDecoder_State__Argument;
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonCborDecoder_Create(
+	struct cjsonCborDecoder** lpOut,
+	uint32_t dwFlags,
+	lpfnCJSONCallback_DocumentReady callbackDocumentReady,
+	void* callbackDocumentReadyFreeParam,
+	struct cjsonSystemAPI* lpSystem
+) {
+	enum cjsonError e;
+	struct cjsonCborDecoder* lpNew;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+
+	if((dwFlags & ~(CJSON_CBOR_FLAG__STREAMINGMODE)) != 0) { return cjsonE_InvalidParam; }
+	if(callbackDocumentReady == NULL) { return cjsonE_InvalidParam; }
+
+	e = cjsonCbor_Alloc(lpSystem, sizeof(struct cjsonCborDecoder), (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpNew->lpFrames							= NULL;
+	lpNew->dwFrameCount						= 0;
+	lpNew->dwFrameCapacity					= 0;
+	lpNew->state							= cjsonCborDecoder_State__Header;
+	lpNew->bInitialByte						= 0;
+	lpNew->dwArgumentBytes					= 0;
+	lpNew->qwArgument						= 0;
+	lpNew->lpString							= NULL;
+	lpNew->lpPayloadTarget					= NULL;
+	lpNew->dwPayloadLength					= 0;
+	lpNew->dwPayloadUsed					= 0;
+	lpNew->dwFlags							= dwFlags;
+	lpNew->lpSystem							= lpSystem;
+	lpNew->callbackDocumentReady			= callbackDocumentReady;
+	lpNew->callbackDocumentReadyFreeParam	= callbackDocumentReadyFreeParam;
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonCborDecoder_ProcessByte(
+	struct cjsonCborDecoder* lpDecoder,
+	char bByte
+) {
+	if(lpDecoder == NULL) { return cjsonE_InvalidParam; }
+
+	switch(lpDecoder->state) {
+		case cjsonCborDecoder_State__Header:
+			return cjsonCborDecoder_Initial(lpDecoder, (uint8_t)bByte);
+		case cjsonCborDecoder_State__Argument:
+			lpDecoder->qwArgument = (lpDecoder->qwArgument << 8) | (uint64_t)((uint8_t)bByte);
+			lpDecoder->dwArgumentBytes = lpDecoder->dwArgumentBytes - 1;
+			if(lpDecoder->dwArgumentBytes == 0) { return cjsonCborDecoder_Item(lpDecoder); }
+			return cjsonE_Ok;
+		case cjsonCborDecoder_State__Payload:
+			lpDecoder->lpPayloadTarget[lpDecoder->dwPayloadUsed] = bByte;
+			lpDecoder->dwPayloadUsed = lpDecoder->dwPayloadUsed + 1;
+			if(lpDecoder->dwPayloadUsed == lpDecoder->dwPayloadLength) { return cjsonCborDecoder_PayloadDone(lpDecoder); }
+			return cjsonE_Ok;
+		default:
+			return cjsonE_ImplementationError;
+	}
+}
+enum cjsonError cjsonCborDecoder_ProcessBytes(
+	struct cjsonCborDecoder* lpDecoder,
+	const char* lpData,
+	unsigned long int dwDataLength
+) {
+	enum cjsonError e;
+	unsigned long int dwPos = 0;
+	unsigned long int dwChunk;
+
+	if(lpDecoder == NULL) { return cjsonE_InvalidParam; }
+	if((lpData == NULL) && (dwDataLength > 0)) { return cjsonE_InvalidParam; }
+
+	while(dwPos < dwDataLength) {
+		if(lpDecoder->state == cjsonCborDecoder_State__Payload) {
+			/* String payloads are copied as a whole */
+			dwChunk = lpDecoder->dwPayloadLength - lpDecoder->dwPayloadUsed;
+			if(dwChunk > dwDataLength - dwPos) { dwChunk = dwDataLength - dwPos; }
+			memcpy(&(lpDecoder->lpPayloadTarget[lpDecoder->dwPayloadUsed]), &(lpData[dwPos]), dwChunk);
+			lpDecoder->dwPayloadUsed = lpDecoder->dwPayloadUsed + dwChunk;
+			dwPos = dwPos + dwChunk;
+			if(lpDecoder->dwPayloadUsed == lpDecoder->dwPayloadLength) {
+				e = cjsonCborDecoder_PayloadDone(lpDecoder);
+				if(e != cjsonE_Ok) { return e; }
+			}
+		} else {
+			e = cjsonCborDecoder_ProcessByte(lpDecoder, lpData[dwPos]);
+			if(e != cjsonE_Ok) { return e; }
+			dwPos = dwPos + 1;
+		}
+	}
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonCborDecoder_Release(
+	struct cjsonCborDecoder* lpDecoder
+) {
+	unsigned long int i;
+
+	if(lpDecoder == NULL) { return cjsonE_Ok; }
+
+	if(lpDecoder->lpString != NULL) { cjsonReleaseValue(lpDecoder->lpString); }
+	for(i = 0; i < lpDecoder->dwFrameCount; i=i+1) {
+		cjsonCborDecoder_ReleaseFrame(lpDecoder, &(lpDecoder->lpFrames[i]));
+	}
+	if(lpDecoder->lpFrames != NULL) { cjsonCbor_Free(lpDecoder->lpSystem, (void*)(lpDecoder->lpFrames)); }
+	cjsonCbor_Free(lpDecoder->lpSystem, (void*)lpDecoder);
+	return cjsonE_Ok;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
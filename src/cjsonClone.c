@@ -0,0 +1,305 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_CLONE_STACKSEGMENT
+	#define CJSON_CLONE_STACKSEGMENT 32				/* Frames per segment of the clone stack */
+#endif
+
+/*
+	Cloning walks the source tree with an explicit stack. Each frame
+	references a source container, the already created (and already
+	linked) target container and the position of the next child.
+	Target containers are created with their final size so arrays
+	get a single page and objects a bucket table matching their
+	element count.
+
+	The same walk (without targets) is used to calculate the size
+	of the copy so an arena can reserve a single block up front.
+
+	The stack is a cjsonScratch_Stack whose first segment is located
+	on the C stack, deeper trees take additional segments from the
+	scratch system of the target system API.
+*/
+struct cjsonClone_Frame {
+	const struct cjsonValue*					lpSource;
+	struct cjsonValue*							lpTarget;		/* NULL while sizing */
+
+	const struct cjsonArray_Page*				lpPage;			/* Arrays: current page */
+	const struct cjsonObject_BucketEntry*		lpEntry;		/* Objects: next entry of the current chain */
+	unsigned long int							dwCursor;		/* Arrays: entry inside page, Objects: next bucket */
+};
+static inline int cjsonClone_IsContainer(
+	const struct cjsonValue* lpValue
+) {
+	return ((lpValue->type == cjsonObject) || (lpValue->type == cjsonArray)) ? 1 : 0;
+}
+
+static enum cjsonError cjsonClone_Push(
+	struct cjsonScratch_Stack* lpStack,
+	const struct cjsonValue* lpSource,
+	struct cjsonValue* lpTarget
+) {
+	struct cjsonClone_Frame* lpFrame;
+
+	lpFrame = (struct cjsonClone_Frame*)cjsonScratch_Push(lpStack);
+	if(lpFrame == NULL) { return cjsonE_OutOfMemory; }
+
+	lpFrame->lpSource = lpSource;
+	lpFrame->lpTarget = lpTarget;
+	lpFrame->lpPage = (lpSource->type == cjsonArray) ? ((const struct cjsonArray*)lpSource)->pageList.lpFirstPage : NULL;
+	lpFrame->lpEntry = NULL;
+	lpFrame->dwCursor = 0;
+	return cjsonE_Ok;
+}
+
+/*
+	Fetches the next child of the frames container. Returns 0
+	if all children have been visited. Objects never contain
+	NULL values, arrays may. For objects the source bucket entry
+	is returned too (so key and hash can be reused), for arrays
+	it is NULL.
+*/
+static int cjsonClone_NextChild(
+	struct cjsonClone_Frame* lpFrame,
+	const struct cjsonObject_BucketEntry** lpEntryOut,
+	const struct cjsonValue** lpChildOut
+) {
+	const struct cjsonObject* lpObject;
+
+	if(lpFrame->lpSource->type == cjsonArray) {
+		while(lpFrame->lpPage != NULL) {
+			if(lpFrame->dwCursor < lpFrame->lpPage->dwUsedEntries) {
+				(*lpEntryOut) = NULL;
+				(*lpChildOut) = lpFrame->lpPage->entries[lpFrame->dwCursor];
+				lpFrame->dwCursor = lpFrame->dwCursor + 1;
+				return 1;
+			}
+			lpFrame->lpPage = lpFrame->lpPage->pageList.lpNext;
+			lpFrame->dwCursor = 0;
+		}
+		return 0;
+	}
+
+	lpObject = (const struct cjsonObject*)(lpFrame->lpSource);
+	while(lpFrame->lpEntry == NULL) {
+		if(lpFrame->dwCursor >= lpObject->dwBucketCount) { return 0; }
+		lpFrame->lpEntry = lpObject->buckets[lpFrame->dwCursor];
+		lpFrame->dwCursor = lpFrame->dwCursor + 1;
+	}
+
+	(*lpEntryOut) = lpFrame->lpEntry;
+	(*lpChildOut) = lpFrame->lpEntry->lpValue;
+	lpFrame->lpEntry = lpFrame->lpEntry->bucketList.lpNext;
+	if(lpFrame->lpEntry != NULL) { CJSON_PREFETCH(lpFrame->lpEntry); }
+	return 1;
+}
+
+/*
+	Size of all allocations done for a single node (including
+	bucket entries and array pages) as served by an arena
+*/
+static unsigned long int cjsonClone_NodeSize(
+	const struct cjsonValue* lpValue
+) {
+	unsigned long int dwCount;
+	unsigned long int dwBuckets;
+
+	switch(lpValue->type) {
+		case cjsonString:
+			return CJSON_ARENA_ALIGN(sizeof(struct cjsonString) + ((const struct cjsonString*)lpValue)->dwStrlen);
+		case cjsonNumber_UnsignedLong:
+		case cjsonNumber_SignedLong:
+		case cjsonNumber_Double:
+			return CJSON_ARENA_ALIGN(sizeof(struct cjsonNumber));
+		case cjsonArray:
+			dwCount = ((const struct cjsonArray*)lpValue)->dwElementCount;
+			return CJSON_ARENA_ALIGN(sizeof(struct cjsonArray))
+				+ ((dwCount > 0) ? CJSON_ARENA_ALIGN(sizeof(struct cjsonArray_Page) + sizeof(struct cjsonValue*)*dwCount) : 0);
+		case cjsonObject:
+			dwCount = ((const struct cjsonObject*)lpValue)->dwElementCount;
+			dwBuckets = 1;
+			while(dwBuckets < dwCount) { dwBuckets = dwBuckets << 1; }
+			return CJSON_ARENA_ALIGN(sizeof(struct cjsonObject) + sizeof(struct cjsonObject_BucketEntry*)*dwBuckets);
+		default:
+			return CJSON_ARENA_ALIGN(sizeof(struct cjsonValue));
+	}
+}
+static enum cjsonError cjsonClone_TreeSize(
+	const struct cjsonValue* lpRoot,
+	unsigned long int* lpSizeOut
+) {
+	enum cjsonError e;
+	struct cjsonClone_Frame stackBase[CJSON_CLONE_STACKSEGMENT];
+	struct cjsonScratch_Stack stack;
+	const struct cjsonValue* lpChild;
+	const struct cjsonObject_BucketEntry* lpEntry;
+	unsigned long int dwSize;
+
+	dwSize = cjsonClone_NodeSize(lpRoot);
+	if(cjsonClone_IsContainer(lpRoot) == 0) {
+		(*lpSizeOut) = dwSize;
+		return cjsonE_Ok;
+	}
+
+	/* Only used for copies into an arena, their scratch system is the default allocator */
+	cjsonScratch_StackInit(&stack, (void*)stackBase, sizeof(struct cjsonClone_Frame), CJSON_CLONE_STACKSEGMENT, NULL);
+	cjsonClone_Push(&stack, lpRoot, NULL);
+
+	while(!CJSON_SCRATCH_EMPTY(&stack)) {
+		if(cjsonClone_NextChild((struct cjsonClone_Frame*)CJSON_SCRATCH_TOP(&stack), &lpEntry, &lpChild) == 0) {
+			cjsonScratch_Pop(&stack);
+			continue;
+		}
+
+		if(lpEntry != NULL) {
+			if(lpChild == NULL) { continue; }
+			dwSize = dwSize + CJSON_ARENA_ALIGN(sizeof(struct cjsonObject_BucketEntry) + lpEntry->dwKeyLength);
+		}
+		if(lpChild == NULL) { continue; }
+
+		dwSize = dwSize + cjsonClone_NodeSize(lpChild);
+		if(cjsonClone_IsContainer(lpChild) != 0) {
+			e = cjsonClone_Push(&stack, lpChild, NULL);
+			if(e != cjsonE_Ok) {
+				cjsonScratch_StackRelease(&stack);
+				return e;
+			}
+		}
+	}
+
+	(*lpSizeOut) = dwSize;
+	return cjsonE_Ok;
+}
+
+/*
+	Copies a scalar or creates an empty container sized for
+	the source containers content
+*/
+static enum cjsonError cjsonClone_Node(
+	const struct cjsonValue* lpSource,
+	struct cjsonSystemAPI* lpSystem,
+	struct cjsonValue** lpOut
+) {
+	enum cjsonError e;
+
+	switch(lpSource->type) {
+		case cjsonObject:
+			return cjsonObject_CreateSized(lpOut, ((const struct cjsonObject*)lpSource)->dwElementCount, lpSystem);
+		case cjsonArray:
+			return cjsonArray_CreateSized(lpOut, ((const struct cjsonArray*)lpSource)->dwElementCount, lpSystem);
+		case cjsonString:
+			return cjsonString_Create(lpOut, ((const struct cjsonString*)lpSource)->bData, ((const struct cjsonString*)lpSource)->dwStrlen, lpSystem);
+		case cjsonNumber_UnsignedLong:
+		case cjsonNumber_SignedLong:
+		case cjsonNumber_Double:
+			e = cjsonNumber_Create(lpOut, lpSystem);
+			if(e != cjsonE_Ok) { return e; }
+			(*lpOut)->type = lpSource->type;
+			((struct cjsonNumber*)(*lpOut))->value = ((const struct cjsonNumber*)lpSource)->value;
+			return cjsonE_Ok;
+		case cjsonTrue:
+			return cjsonTrue_Create(lpOut, lpSystem);
+		case cjsonFalse:
+			return cjsonFalse_Create(lpOut, lpSystem);
+		case cjsonNull:
+			return cjsonNull_Create(lpOut, lpSystem);
+		default:
+			return cjsonE_InvalidParam;
+	}
+}
+
+/*
+	Deep copy of an value. If the target system is an arena the
+	required size is calculated first and reserved so the whole
+	copy ends up in a single block.
+*/
+enum cjsonError cjsonValue_Clone(
+	const struct cjsonValue* lpSource,
+	struct cjsonSystemAPI* lpSystem,
+	struct cjsonValue** lpOut
+) {
+	enum cjsonError e;
+	struct cjsonArena* lpArena;
+	struct cjsonClone_Frame stackBase[CJSON_CLONE_STACKSEGMENT];
+	struct cjsonScratch_Stack stack;
+	struct cjsonClone_Frame* lpFrame;
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpCopy;
+	const struct cjsonValue* lpChild;
+	const struct cjsonObject_BucketEntry* lpEntry;
+	unsigned long int dwSize;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+	if(lpSource == NULL) { return cjsonE_InvalidParam; }
+
+	if((lpArena = cjsonArena_FromSystem(lpSystem)) != NULL) {
+		e = cjsonClone_TreeSize(lpSource, &dwSize);
+		if(e != cjsonE_Ok) { return e; }
+		e = cjsonArena_Reserve(lpArena, dwSize);
+		if(e != cjsonE_Ok) { return e; }
+	}
+
+	e = cjsonClone_Node(lpSource, lpSystem, &lpRoot);
+	if(e != cjsonE_Ok) { return e; }
+	if(cjsonClone_IsContainer(lpSource) == 0) {
+		(*lpOut) = lpRoot;
+		return cjsonE_Ok;
+	}
+
+	cjsonScratch_StackInit(&stack, (void*)stackBase, sizeof(struct cjsonClone_Frame), CJSON_CLONE_STACKSEGMENT, lpSystem);
+	cjsonClone_Push(&stack, lpSource, lpRoot);
+
+	while(!CJSON_SCRATCH_EMPTY(&stack)) {
+		lpFrame = (struct cjsonClone_Frame*)CJSON_SCRATCH_TOP(&stack);
+		if(cjsonClone_NextChild(lpFrame, &lpEntry, &lpChild) == 0) {
+			cjsonScratch_Pop(&stack);
+			continue;
+		}
+
+		if(lpChild == NULL) {
+			if(lpFrame->lpSource->type == cjsonArray) {
+				e = cjsonArray_Push(lpFrame->lpTarget, NULL);
+				if(e != cjsonE_Ok) { break; }
+			}
+			continue;
+		}
+
+		e = cjsonClone_Node(lpChild, lpSystem, &lpCopy);
+		if(e != cjsonE_Ok) { break; }
+
+		if(lpFrame->lpSource->type == cjsonArray) {
+			e = cjsonArray_Push(lpFrame->lpTarget, lpCopy);
+		} else {
+			/* The source entry already carries the hash of its key */
+			e = cjsonObject_SetPrehashed(lpFrame->lpTarget, lpEntry->bKey, lpEntry->dwKeyLength, lpEntry->dwKeyHash, lpCopy);
+		}
+		if(e != cjsonE_Ok) {
+			cjsonReleaseValue(lpCopy);
+			break;
+		}
+
+		/* The copy is already linked into its parent, fill it next */
+		if(cjsonClone_IsContainer(lpChild) != 0) {
+			e = cjsonClone_Push(&stack, lpChild, lpCopy);
+			if(e != cjsonE_Ok) { break; }
+		}
+	}
+
+	if(e != cjsonE_Ok) {
+		cjsonScratch_StackRelease(&stack);
+		cjsonReleaseValue(lpRoot);
+		return e;
+	}
+
+	(*lpOut) = lpRoot;
+	return cjsonE_Ok;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,775 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_COLUMNS_EXPECTEDCOLUMNS
+	#define CJSON_COLUMNS_EXPECTEDCOLUMNS 16			/* Initial size of the column dictionary */
+#endif
+
+/*
+	Value kinds collected per column while scanning the rows
+*/
+#define CJSON_COLUMNS_SEEN__BOOLEAN					0x00000001
+#define CJSON_COLUMNS_SEEN__ULONG					0x00000002	/* Fits into a signed long */
+#define CJSON_COLUMNS_SEEN__ULONGLARGE				0x00000004
+#define CJSON_COLUMNS_SEEN__SLONG					0x00000008	/* Negative */
+#define CJSON_COLUMNS_SEEN__DOUBLE					0x00000010
+#define CJSON_COLUMNS_SEEN__STRING					0x00000020
+#define CJSON_COLUMNS_SEEN__OTHER					0x00000040	/* Objects and arrays */
+#define CJSON_COLUMNS_SEEN__WIDE					0x00000080	/* Integer with a magnitude above 2^53, set together with its kind */
+
+#define CJSON_COLUMNS_SEEN__NUMBERS					(CJSON_COLUMNS_SEEN__ULONG|CJSON_COLUMNS_SEEN__ULONGLARGE|CJSON_COLUMNS_SEEN__SLONG|CJSON_COLUMNS_SEEN__DOUBLE|CJSON_COLUMNS_SEEN__WIDE)
+
+#define CJSON_COLUMNS_EXACTINTEGER					(((uint64_t)1) << 53)	/* Largest magnitude up to which all integers are exact doubles */
+
+struct cjsonColumns_Stats {
+	uint32_t									dwSeen;
+	unsigned long int							dwPresent;		/* Rows containing the key */
+	unsigned long int							dwValues;		/* Rows with a non null value */
+	unsigned long int							dwStringBytes;
+};
+
+/*
+	Malloc and free abstraction
+*/
+static inline enum cjsonError cjsonColumns_Alloc(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(dwSize == 0) { dwSize = 1; }
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpSystem->alloc(lpSystem, dwSize, lpOut);
+	}
+}
+static inline void cjsonColumns_Free(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpBlock == NULL) { return; }
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+static inline enum cjsonError cjsonColumns_AllocFilled(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	int iFill,
+	void** lpOut
+) {
+	enum cjsonError e;
+
+	e = cjsonColumns_Alloc(lpSystem, dwSize, lpOut);
+	if(e != cjsonE_Ok) { return e; }
+	memset(*lpOut, iFill, dwSize);
+	return cjsonE_Ok;
+}
+
+static inline uint32_t cjsonColumns_Kind(
+	const struct cjsonValue* lpValue
+) {
+	unsigned long int dwUnsigned;
+	signed long int iSigned;
+	uint32_t dwWide;
+
+	switch(lpValue->type) {
+		case cjsonTrue:
+		case cjsonFalse:
+			return CJSON_COLUMNS_SEEN__BOOLEAN;
+		case cjsonNumber_UnsignedLong:
+			dwUnsigned = ((const struct cjsonNumber*)lpValue)->value.ulong;
+			dwWide = (((uint64_t)dwUnsigned) > CJSON_COLUMNS_EXACTINTEGER) ? CJSON_COLUMNS_SEEN__WIDE : 0;
+			return ((dwUnsigned > (unsigned long int)LONG_MAX) ? CJSON_COLUMNS_SEEN__ULONGLARGE : CJSON_COLUMNS_SEEN__ULONG) | dwWide;
+		case cjsonNumber_SignedLong:
+			iSigned = ((const struct cjsonNumber*)lpValue)->value.slong;
+			if(iSigned >= 0) {
+				dwWide = (((uint64_t)iSigned) > CJSON_COLUMNS_EXACTINTEGER) ? CJSON_COLUMNS_SEEN__WIDE : 0;
+				return CJSON_COLUMNS_SEEN__ULONG | dwWide;
+			}
+			dwWide = (((uint64_t)(-(iSigned + 1))) >= CJSON_COLUMNS_EXACTINTEGER) ? CJSON_COLUMNS_SEEN__WIDE : 0;
+			return CJSON_COLUMNS_SEEN__SLONG | dwWide;
+		case cjsonNumber_Double:
+			return CJSON_COLUMNS_SEEN__DOUBLE;
+		case cjsonString:
+			return CJSON_COLUMNS_SEEN__STRING;
+		default:
+			return CJSON_COLUMNS_SEEN__OTHER;
+	}
+}
+static enum cjsonColumn_Type cjsonColumns_TypeOf(
+	uint32_t dwSeen
+) {
+	if(dwSeen == 0) { return cjsonColumn_Type__Null; }
+	if(dwSeen == CJSON_COLUMNS_SEEN__BOOLEAN) { return cjsonColumn_Type__Boolean; }
+	if(dwSeen == CJSON_COLUMNS_SEEN__STRING) { return cjsonColumn_Type__String; }
+	if((dwSeen & ~(CJSON_COLUMNS_SEEN__ULONG|CJSON_COLUMNS_SEEN__ULONGLARGE|CJSON_COLUMNS_SEEN__WIDE)) == 0) { return cjsonColumn_Type__UnsignedLong; }
+	if((dwSeen & ~(CJSON_COLUMNS_SEEN__ULONG|CJSON_COLUMNS_SEEN__SLONG|CJSON_COLUMNS_SEEN__WIDE)) == 0) { return cjsonColumn_Type__SignedLong; }
+
+	/* Mixed numbers are narrowed to double only if every integer is exactly representable */
+	if(((dwSeen & ~CJSON_COLUMNS_SEEN__NUMBERS) == 0) && ((dwSeen & CJSON_COLUMNS_SEEN__WIDE) == 0)) { return cjsonColumn_Type__Double; }
+	return cjsonColumn_Type__Value;
+}
+
+/*
+	Conversion from arrays of objects
+
+	The first pass assigns a column to every key (using an object
+	as dictionary, keys are looked up with the hash stored in the
+	row entries) and collects the value kinds, the second pass
+	fills the vectors row by row.
+*/
+static enum cjsonError cjsonColumns_Scan(
+	struct cjsonSystemAPI* lpScratchSystem,
+	const struct cjsonArray* lpArray,
+	struct cjsonValue* lpDictionary,
+	struct cjsonColumns_Stats** lpStatsInOut,
+	unsigned long int* lpCapacityInOut,
+	unsigned long int* lpColumnCountOut,
+	unsigned long int* lpNameBytesOut
+) {
+	const struct cjsonArray_Page* lpPage;
+	const struct cjsonObject* lpRow;
+	const struct cjsonObject_BucketEntry* lpEntry;
+	struct cjsonColumns_Stats* lpStats;
+	struct cjsonValue* lpColumnIndex;
+	unsigned long int dwColumn;
+	unsigned long int i, j;
+	enum cjsonError e;
+
+	(*lpColumnCountOut) = 0;
+	(*lpNameBytesOut) = 0;
+
+	for(lpPage = lpArray->pageList.lpFirstPage; lpPage != NULL; lpPage = lpPage->pageList.lpNext) {
+		for(i = 0; i < lpPage->dwUsedEntries; i=i+1) {
+			if((lpPage->entries[i] == NULL) || (lpPage->entries[i]->type != cjsonObject)) { return cjsonE_InvalidParam; }
+			lpRow = (const struct cjsonObject*)(lpPage->entries[i]);
+
+			for(j = 0; j < lpRow->dwBucketCount; j=j+1) {
+				for(lpEntry = lpRow->buckets[j]; lpEntry != NULL; lpEntry = lpEntry->bucketList.lpNext) {
+					if(cjsonObject_GetPrehashed(lpDictionary, lpEntry->bKey, lpEntry->dwKeyLength, lpEntry->dwKeyHash, &lpColumnIndex) == cjsonE_Ok) {
+						dwColumn = cjsonObject_GetAsULong(lpColumnIndex);
+					} else {
+						/* First occurrence of this key */
+						dwColumn = (*lpColumnCountOut);
+						if(dwColumn == (*lpCapacityInOut)) {
+							e = cjsonColumns_Alloc(lpScratchSystem, sizeof(struct cjsonColumns_Stats) * (*lpCapacityInOut) * 2, (void**)&lpStats);
+							if(e != cjsonE_Ok) { return e; }
+							memcpy(lpStats, (*lpStatsInOut), sizeof(struct cjsonColumns_Stats) * (*lpCapacityInOut));
+							cjsonColumns_Free(lpScratchSystem, (*lpStatsInOut));
+							(*lpStatsInOut) = lpStats;
+							(*lpCapacityInOut) = (*lpCapacityInOut) * 2;
+						}
+						memset(&((*lpStatsInOut)[dwColumn]), 0, sizeof(struct cjsonColumns_Stats));
+
+						e = cjsonNumber_Create(&lpColumnIndex, lpScratchSystem);
+						if(e != cjsonE_Ok) { return e; }
+						cjsonNumber_SetULong(lpColumnIndex, dwColumn);
+						e = cjsonObject_SetPrehashed(lpDictionary, lpEntry->bKey, lpEntry->dwKeyLength, lpEntry->dwKeyHash, lpColumnIndex);
+						if(e != cjsonE_Ok) {
+							cjsonReleaseValue(lpColumnIndex);
+							return e;
+						}
+						(*lpColumnCountOut) = dwColumn + 1;
+						(*lpNameBytesOut) = (*lpNameBytesOut) + lpEntry->dwKeyLength;
+					}
+
+					lpStats = &((*lpStatsInOut)[dwColumn]);
+					lpStats->dwPresent = lpStats->dwPresent + 1;
+					if((lpEntry->lpValue == NULL) || (lpEntry->lpValue->type == cjsonNull)) { continue; }
+					lpStats->dwValues = lpStats->dwValues + 1;
+					lpStats->dwSeen = lpStats->dwSeen | cjsonColumns_Kind(lpEntry->lpValue);
+					if(lpEntry->lpValue->type == cjsonString) { lpStats->dwStringBytes = lpStats->dwStringBytes + ((const struct cjsonString*)(lpEntry->lpValue))->dwStrlen; }
+				}
+			}
+		}
+	}
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonColumns_AllocColumn(
+	struct cjsonColumns* lpColumns,
+	struct cjsonColumn* lpColumn,
+	const struct cjsonColumns_Stats* lpStats
+) {
+	struct cjsonSystemAPI* lpSystem = lpColumns->lpSystem;
+	unsigned long int dwRows = lpColumns->dwRowCount;
+	unsigned long int dwBitmapBytes = CJSON_COLUMN_BITMAPBYTES(dwRows);
+	enum cjsonError e;
+
+	lpColumn->type = cjsonColumns_TypeOf(lpStats->dwSeen);
+	lpColumn->dwRowCount = dwRows;
+	lpColumn->dwValueCount = lpStats->dwValues;
+
+	/* Validity bits are set while filling, missing bits are cleared */
+	if(lpStats->dwValues < dwRows) {
+		e = cjsonColumns_AllocFilled(lpSystem, dwBitmapBytes, 0x00, (void**)&(lpColumn->lpValid));
+		if(e != cjsonE_Ok) { return e; }
+	}
+	if(lpStats->dwPresent < dwRows) {
+		e = cjsonColumns_AllocFilled(lpSystem, dwBitmapBytes, 0xFF, (void**)&(lpColumn->lpMissing));
+		if(e != cjsonE_Ok) { return e; }
+	}
+
+	switch(lpColumn->type) {
+		case cjsonColumn_Type__Boolean:
+			return cjsonColumns_AllocFilled(lpSystem, sizeof(uint8_t) * dwRows, 0, (void**)&(lpColumn->data.lpBoolean));
+		case cjsonColumn_Type__UnsignedLong:
+			return cjsonColumns_AllocFilled(lpSystem, sizeof(unsigned long int) * dwRows, 0, (void**)&(lpColumn->data.lpULong));
+		case cjsonColumn_Type__SignedLong:
+			return cjsonColumns_AllocFilled(lpSystem, sizeof(signed long int) * dwRows, 0, (void**)&(lpColumn->data.lpSLong));
+		case cjsonColumn_Type__Double:
+			e = cjsonColumns_Alloc(lpSystem, sizeof(double) * dwRows, (void**)&(lpColumn->data.lpDouble));
+			if(e == cjsonE_Ok) {
+				unsigned long int i;
+				for(i = 0; i < dwRows; i=i+1) { lpColumn->data.lpDouble[i] = 0; }
+			}
+			return e;
+		case cjsonColumn_Type__String:
+			e = cjsonColumns_AllocFilled(lpSystem, sizeof(unsigned long int) * (dwRows + 1), 0, (void**)&(lpColumn->data.lpStringOffsets));
+			if(e != cjsonE_Ok) { return e; }
+			return cjsonColumns_Alloc(lpSystem, lpStats->dwStringBytes, (void**)&(lpColumn->lpStringBlob));
+		case cjsonColumn_Type__Value:
+			e = cjsonColumns_Alloc(lpSystem, sizeof(struct cjsonValue*) * dwRows, (void**)&(lpColumn->data.lpValue));
+			if(e == cjsonE_Ok) {
+				unsigned long int i;
+				for(i = 0; i < dwRows; i=i+1) { lpColumn->data.lpValue[i] = NULL; }
+			}
+			return e;
+		default:
+			return cjsonE_Ok;
+	}
+}
+
+static void cjsonColumns_Store(
+	struct cjsonColumn* lpColumn,
+	unsigned long int dwRow,
+	struct cjsonValue* lpValue,
+	unsigned long int* lpBlobUsed
+) {
+	const struct cjsonNumber* lpNumber = (const struct cjsonNumber*)lpValue;
+	unsigned long int dwLength;
+
+	if(lpColumn->lpMissing != NULL) { lpColumn->lpMissing[dwRow >> 3] = (uint8_t)(lpColumn->lpMissing[dwRow >> 3] & ~(1 << (dwRow & 7))); }
+	if((lpValue == NULL) || (lpValue->type == cjsonNull)) { return; }
+	if(lpColumn->lpValid != NULL) { lpColumn->lpValid[dwRow >> 3] = (uint8_t)(lpColumn->lpValid[dwRow >> 3] | (1 << (dwRow & 7))); }
+
+	switch(lpColumn->type) {
+		case cjsonColumn_Type__Boolean:
+			lpColumn->data.lpBoolean[dwRow] = (lpValue->type == cjsonTrue) ? 1 : 0;
+			break;
+		case cjsonColumn_Type__UnsignedLong:
+			lpColumn->data.lpULong[dwRow] = lpNumber->value.ulong;
+			break;
+		case cjsonColumn_Type__SignedLong:
+			lpColumn->data.lpSLong[dwRow] = (lpValue->type == cjsonNumber_SignedLong) ? lpNumber->value.slong : (signed long int)(lpNumber->value.ulong);
+			break;
+		case cjsonColumn_Type__Double:
+			switch(lpValue->type) {
+				case cjsonNumber_UnsignedLong:	lpColumn->data.lpDouble[dwRow] = (double)(lpNumber->value.ulong); break;
+				case cjsonNumber_SignedLong:	lpColumn->data.lpDouble[dwRow] = (double)(lpNumber->value.slong); break;
+				default:						lpColumn->data.lpDouble[dwRow] = lpNumber->value.dbl; break;
+			}
+			break;
+		case cjsonColumn_Type__String:
+			/* Only the end is stored, rows without value are patched later */
+			dwLength = ((const struct cjsonString*)lpValue)->dwStrlen;
+			memcpy(&(lpColumn->lpStringBlob[*lpBlobUsed]), ((const struct cjsonString*)lpValue)->bData, dwLength);
+			(*lpBlobUsed) = (*lpBlobUsed) + dwLength;
+			lpColumn->data.lpStringOffsets[dwRow + 1] = (*lpBlobUsed);
+			break;
+		case cjsonColumn_Type__Value:
+			lpColumn->data.lpValue[dwRow] = cjsonValue_Retain(lpValue);
+			break;
+		default:
+			break;
+	}
+}
+
+static enum cjsonError cjsonColumns_Fill(
+	struct cjsonSystemAPI* lpScratchSystem,
+	struct cjsonColumns* lpColumns,
+	const struct cjsonArray* lpArray,
+	struct cjsonValue* lpDictionary
+) {
+	const struct cjsonArray_Page* lpPage;
+	const struct cjsonObject* lpRow;
+	const struct cjsonObject_BucketEntry* lpEntry;
+	struct cjsonColumn* lpColumn;
+	struct cjsonValue* lpColumnIndex;
+	unsigned long int* lpBlobUsed;
+	unsigned long int dwRow;
+	unsigned long int i, j;
+	enum cjsonError e;
+
+	/* Fill position of every string blob */
+	e = cjsonColumns_AllocFilled(lpScratchSystem, sizeof(unsigned long int) * (lpColumns->dwColumnCount + 1), 0, (void**)&lpBlobUsed);
+	if(e != cjsonE_Ok) { return e; }
+
+	dwRow = 0;
+	for(lpPage = lpArray->pageList.lpFirstPage; lpPage != NULL; lpPage = lpPage->pageList.lpNext) {
+		if(lpPage->pageList.lpNext != NULL) { CJSON_PREFETCH(lpPage->pageList.lpNext); }
+		for(i = 0; i < lpPage->dwUsedEntries; i=i+1) {
+			lpRow = (const struct cjsonObject*)(lpPage->entries[i]);
+			for(j = 0; j < lpRow->dwBucketCount; j=j+1) {
+				for(lpEntry = lpRow->buckets[j]; lpEntry != NULL; lpEntry = lpEntry->bucketList.lpNext) {
+					if(cjsonObject_GetPrehashed(lpDictionary, lpEntry->bKey, lpEntry->dwKeyLength, lpEntry->dwKeyHash, &lpColumnIndex) != cjsonE_Ok) {
+						cjsonColumns_Free(lpScratchSystem, lpBlobUsed);
+						return cjsonE_ImplementationError;
+					}
+					lpColumn = &(lpColumns->lpColumns[cjsonObject_GetAsULong(lpColumnIndex)]);
+					cjsonColumns_Store(lpColumn, dwRow, lpEntry->lpValue, &(lpBlobUsed[cjsonObject_GetAsULong(lpColumnIndex)]));
+				}
+			}
+			dwRow = dwRow + 1;
+		}
+	}
+	cjsonColumns_Free(lpScratchSystem, lpBlobUsed);
+
+	/* Rows without string start and end where the previous row ended */
+	for(i = 0; i < lpColumns->dwColumnCount; i=i+1) {
+		lpColumn = &(lpColumns->lpColumns[i]);
+		if((lpColumn->type != cjsonColumn_Type__String) || (lpColumn->lpValid == NULL)) { continue; }
+		for(dwRow = 0; dwRow < lpColumns->dwRowCount; dwRow=dwRow+1) {
+			if(CJSON_COLUMN_ISSET(lpColumn->lpValid, dwRow) == 0) { lpColumn->data.lpStringOffsets[dwRow + 1] = lpColumn->data.lpStringOffsets[dwRow]; }
+		}
+	}
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonColumns_FromArray(
+	struct cjsonColumns** lpOut,
+	const struct cjsonValue* lpArray,
+	struct cjsonSystemAPI* lpSystem
+) {
+	struct cjsonColumns* lpNew = NULL;
+	struct cjsonColumns_Stats* lpStats;
+	struct cjsonValue* lpDictionary;
+	struct cjsonObject_BucketEntry* lpEntry;
+	struct cjsonColumn* lpColumn;
+	struct cjsonSystemAPI* lpScratchSystem;
+	unsigned long int dwCapacity;
+	unsigned long int dwColumnCount;
+	unsigned long int dwNameBytes;
+	unsigned long int dwNamesUsed;
+	unsigned long int i;
+	enum cjsonError e;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+	if(lpArray == NULL) { return cjsonE_InvalidParam; }
+	if(lpArray->type != cjsonArray) { return cjsonE_InvalidParam; }
+
+	/* Dictionary, statistics and fill positions are scratch memory of the result system */
+	lpScratchSystem = cjsonScratch_System(lpSystem);
+	e = cjsonObject_CreateSized(&lpDictionary, CJSON_COLUMNS_EXPECTEDCOLUMNS, lpScratchSystem);
+	if(e != cjsonE_Ok) { return e; }
+	dwCapacity = CJSON_COLUMNS_EXPECTEDCOLUMNS;
+	e = cjsonColumns_Alloc(lpScratchSystem, sizeof(struct cjsonColumns_Stats) * dwCapacity, (void**)&lpStats);
+	if(e != cjsonE_Ok) {
+		cjsonReleaseValue(lpDictionary);
+		return e;
+	}
+
+	e = cjsonColumns_Scan(lpScratchSystem, (const struct cjsonArray*)lpArray, lpDictionary, &lpStats, &dwCapacity, &dwColumnCount, &dwNameBytes);
+	if(e != cjsonE_Ok) { goto cleanup; }
+
+	e = cjsonColumns_Alloc(lpSystem, sizeof(struct cjsonColumns), (void**)&lpNew);
+	if(e != cjsonE_Ok) { goto cleanup; }
+	lpNew->lpSystem = lpSystem;
+	lpNew->dwRowCount = ((const struct cjsonArray*)lpArray)->dwElementCount;
+	lpNew->dwColumnCount = 0;
+	lpNew->lpColumns = NULL;
+	lpNew->lpNames = NULL;
+
+	e = cjsonColumns_Alloc(lpSystem, sizeof(struct cjsonColumn) * dwColumnCount, (void**)&(lpNew->lpColumns));
+	if(e == cjsonE_Ok) { e = cjsonColumns_Alloc(lpSystem, dwNameBytes, (void**)&(lpNew->lpNames)); }
+	if(e != cjsonE_Ok) { goto cleanup; }
+
+	/* Names are copied from the dictionary, columns keep their first seen order */
+	dwNamesUsed = 0;
+	for(i = 0; i < ((struct cjsonObject*)lpDictionary)->dwBucketCount; i=i+1) {
+		for(lpEntry = ((struct cjsonObject*)lpDictionary)->buckets[i]; lpEntry != NULL; lpEntry = lpEntry->bucketList.lpNext) {
+			lpColumn = &(lpNew->lpColumns[cjsonObject_GetAsULong(lpEntry->lpValue)]);
+			memcpy(&(lpNew->lpNames[dwNamesUsed]), lpEntry->bKey, lpEntry->dwKeyLength);
+			lpColumn->key.lpKey = &(lpNew->lpNames[dwNamesUsed]);
+			lpColumn->key.dwKeyLength = lpEntry->dwKeyLength;
+			lpColumn->key.dwKeyHash = lpEntry->dwKeyHash;
+			dwNamesUsed = dwNamesUsed + lpEntry->dwKeyLength;
+		}
+	}
+	for(i = 0; i < dwColumnCount; i=i+1) {
+		lpColumn = &(lpNew->lpColumns[i]);
+		lpColumn->type = cjsonColumn_Type__Null;
+		lpColumn->lpValid = NULL;
+		lpColumn->lpMissing = NULL;
+		lpColumn->data.lpValue = NULL;
+		lpColumn->lpStringBlob = NULL;
+		lpNew->dwColumnCount = i + 1;
+
+		e = cjsonColumns_AllocColumn(lpNew, lpColumn, &(lpStats[i]));
+		if(e != cjsonE_Ok) { goto cleanup; }
+	}
+
+	e = cjsonColumns_Fill(lpScratchSystem, lpNew, (const struct cjsonArray*)lpArray, lpDictionary);
+
+cleanup:
+	cjsonColumns_Free(lpScratchSystem, lpStats);
+	cjsonReleaseValue(lpDictionary);
+	if(e != cjsonE_Ok) {
+		cjsonColumns_Release(lpNew);
+		return e;
+	}
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+
+void cjsonColumns_Release(
+	struct cjsonColumns* lpColumns
+) {
+	struct cjsonColumn* lpColumn;
+	unsigned long int i, j;
+
+	if(lpColumns == NULL) { return; }
+
+	for(i = 0; i < lpColumns->dwColumnCount; i=i+1) {
+		lpColumn = &(lpColumns->lpColumns[i]);
+		if((lpColumn->type == cjsonColumn_Type__Value) && (lpColumn->data.lpValue != NULL)) {
+			for(j = 0; j < lpColumn->dwRowCount; j=j+1) {
+				if(lpColumn->data.lpValue[j] != NULL) { cjsonReleaseValue(lpColumn->data.lpValue[j]); }
+			}
+		}
+		cjsonColumns_Free(lpColumns->lpSystem, lpColumn->lpValid);
+		cjsonColumns_Free(lpColumns->lpSystem, lpColumn->lpMissing);
+		cjsonColumns_Free(lpColumns->lpSystem, lpColumn->data.lpValue);
+		cjsonColumns_Free(lpColumns->lpSystem, lpColumn->lpStringBlob);
+	}
+	cjsonColumns_Free(lpColumns->lpSystem, lpColumns->lpColumns);
+	cjsonColumns_Free(lpColumns->lpSystem, lpColumns->lpNames);
+	cjsonColumns_Free(lpColumns->lpSystem, lpColumns);
+}
+
+const struct cjsonColumn* cjsonColumns_Find(
+	const struct cjsonColumns* lpColumns,
+	const char* lpName,
+	unsigned long int dwNameLength
+) {
+	uint32_t dwHash;
+	unsigned long int i;
+
+	if((lpColumns == NULL) || ((lpName == NULL) && (dwNameLength > 0))) { return NULL; }
+
+	dwHash = cjsonObject_HashKey(lpName, dwNameLength);
+	for(i = 0; i < lpColumns->dwColumnCount; i=i+1) {
+		if(lpColumns->lpColumns[i].key.dwKeyHash != dwHash) { continue; }
+		if(lpColumns->lpColumns[i].key.dwKeyLength != dwNameLength) { continue; }
+		if(memcmp(lpColumns->lpColumns[i].key.lpKey, lpName, dwNameLength) != 0) { continue; }
+		return &(lpColumns->lpColumns[i]);
+	}
+	return NULL;
+}
+
+/*
+	Inverse conversion
+*/
+static enum cjsonError cjsonColumns_Load(
+	const struct cjsonColumn* lpColumn,
+	unsigned long int dwRow,
+	struct cjsonSystemAPI* lpSystem,
+	struct cjsonValue** lpOut
+) {
+	enum cjsonError e;
+
+	if(CJSON_COLUMN_HASVALUE(lpColumn, dwRow) == 0) { return cjsonNull_Create(lpOut, lpSystem); }
+
+	switch(lpColumn->type) {
+		case cjsonColumn_Type__Boolean:
+			return (lpColumn->data.lpBoolean[dwRow] != 0) ? cjsonTrue_Create(lpOut, lpSystem) : cjsonFalse_Create(lpOut, lpSystem);
+		case cjsonColumn_Type__String:
+			return cjsonString_Create(lpOut, &(lpColumn->lpStringBlob[lpColumn->data.lpStringOffsets[dwRow]]), lpColumn->data.lpStringOffsets[dwRow + 1] - lpColumn->data.lpStringOffsets[dwRow], lpSystem);
+		case cjsonColumn_Type__Value:
+			(*lpOut) = cjsonValue_Retain(lpColumn->data.lpValue[dwRow]);
+			return cjsonE_Ok;
+		case cjsonColumn_Type__UnsignedLong:
+		case cjsonColumn_Type__SignedLong:
+		case cjsonColumn_Type__Double:
+			e = cjsonNumber_Create(lpOut, lpSystem);
+			if(e != cjsonE_Ok) { return e; }
+			if(lpColumn->type == cjsonColumn_Type__UnsignedLong) { return cjsonNumber_SetULong(*lpOut, lpColumn->data.lpULong[dwRow]); }
+			if(lpColumn->type == cjsonColumn_Type__SignedLong) { return cjsonNumber_SetSLong(*lpOut, lpColumn->data.lpSLong[dwRow]); }
+			return cjsonNumber_SetDouble(*lpOut, lpColumn->data.lpDouble[dwRow]);
+		default:
+			return cjsonE_ImplementationError;
+	}
+}
+
+enum cjsonError cjsonColumns_ToArray(
+	const struct cjsonColumns* lpColumns,
+	struct cjsonValue** lpArrayOut,
+	struct cjsonSystemAPI* lpSystem
+) {
+	struct cjsonValue* lpArray;
+	struct cjsonValue* lpRow;
+	struct cjsonValue* lpValue;
+	const struct cjsonColumn* lpColumn;
+	unsigned long int dwRow;
+	unsigned long int i;
+	enum cjsonError e;
+
+	if(lpArrayOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpArrayOut) = NULL;
+	if(lpColumns == NULL) { return cjsonE_InvalidParam; }
+
+	e = cjsonArray_CreateSized(&lpArray, lpColumns->dwRowCount, lpSystem);
+	if(e != cjsonE_Ok) { return e; }
+
+	for(dwRow = 0; dwRow < lpColumns->dwRowCount; dwRow=dwRow+1) {
+		e = cjsonObject_CreateSized(&lpRow, lpColumns->dwColumnCount, lpSystem);
+		if(e != cjsonE_Ok) { break; }
+		e = cjsonArray_Push(lpArray, lpRow);
+		if(e != cjsonE_Ok) {
+			cjsonReleaseValue(lpRow);
+			break;
+		}
+
+		for(i = 0; i < lpColumns->dwColumnCount; i=i+1) {
+			lpColumn = &(lpColumns->lpColumns[i]);
+			if((lpColumn->lpMissing != NULL) && (CJSON_COLUMN_ISSET(lpColumn->lpMissing, dwRow) != 0)) { continue; }
+
+			e = cjsonColumns_Load(lpColumn, dwRow, lpSystem, &lpValue);
+			if(e != cjsonE_Ok) { break; }
+			e = cjsonObject_SetKey(lpRow, &(lpColumn->key), lpValue);
+			if(e != cjsonE_Ok) {
+				cjsonReleaseValue(lpValue);
+				break;
+			}
+		}
+		if(e != cjsonE_Ok) { break; }
+	}
+	if(e != cjsonE_Ok) {
+		cjsonReleaseValue(lpArray);
+		return e;
+	}
+
+	(*lpArrayOut) = lpArray;
+	return cjsonE_Ok;
+}
+
+/*
+	Scans. Each kernel runs over one typed vector without any
+	per row type dispatch, rows without value are excluded with
+	the validity bitmap.
+*/
+static inline int cjsonColumns_IsNumeric(
+	const struct cjsonColumn* lpColumn
+) {
+	switch(lpColumn->type) {
+		case cjsonColumn_Type__Boolean:
+		case cjsonColumn_Type__UnsignedLong:
+		case cjsonColumn_Type__SignedLong:
+		case cjsonColumn_Type__Double:
+			return 1;
+		default:
+			return 0;
+	}
+}
+static inline double cjsonColumns_NumberAt(
+	const struct cjsonColumn* lpColumn,
+	unsigned long int dwRow
+) {
+	switch(lpColumn->type) {
+		case cjsonColumn_Type__Boolean:			return (double)(lpColumn->data.lpBoolean[dwRow]);
+		case cjsonColumn_Type__UnsignedLong:	return (double)(lpColumn->data.lpULong[dwRow]);
+		case cjsonColumn_Type__SignedLong:		return (double)(lpColumn->data.lpSLong[dwRow]);
+		default:								return lpColumn->data.lpDouble[dwRow];
+	}
+}
+
+#define CJSON_COLUMNS_AGGREGATELOOP(_vector) \
+	for(i = 0; i < lpColumn->dwRowCount; i=i+1) { \
+		dValue = (double)((_vector)[i]); \
+		dSum = dSum + dValue; \
+		dMin = (dValue < dMin) ? dValue : dMin; \
+		dMax = (dValue > dMax) ? dValue : dMax; \
+	}
+
+enum cjsonError cjsonColumn_Aggregate(
+	const struct cjsonColumn* lpColumn,
+	const uint8_t* lpSelection,
+	struct cjsonColumn_Aggregate* lpOut
+) {
+	unsigned long int i;
+	unsigned long int dwCount;
+	double dValue;
+	double dSum = 0;
+	double dMin = 0;
+	double dMax = 0;
+
+	if((lpColumn == NULL) || (lpOut == NULL)) { return cjsonE_InvalidParam; }
+	if(cjsonColumns_IsNumeric(lpColumn) == 0) { return cjsonE_InvalidParam; }
+
+	lpOut->dwCount = 0;
+	lpOut->dSum = 0;
+	lpOut->dMin = 0;
+	lpOut->dMax = 0;
+	if(lpColumn->dwRowCount == 0) { return cjsonE_Ok; }
+
+	if((lpColumn->lpValid == NULL) && (lpSelection == NULL)) {
+		/* Dense vectors, the loops do not branch and can be vectorized */
+		dMin = cjsonColumns_NumberAt(lpColumn, 0);
+		dMax = dMin;
+		switch(lpColumn->type) {
+			case cjsonColumn_Type__Boolean:			CJSON_COLUMNS_AGGREGATELOOP(lpColumn->data.lpBoolean); break;
+			case cjsonColumn_Type__UnsignedLong:	CJSON_COLUMNS_AGGREGATELOOP(lpColumn->data.lpULong); break;
+			case cjsonColumn_Type__SignedLong:		CJSON_COLUMNS_AGGREGATELOOP(lpColumn->data.lpSLong); break;
+			default:								CJSON_COLUMNS_AGGREGATELOOP(lpColumn->data.lpDouble); break;
+		}
+		dwCount = lpColumn->dwRowCount;
+	} else {
+		dwCount = 0;
+		for(i = 0; i < lpColumn->dwRowCount; i=i+1) {
+			if(CJSON_COLUMN_HASVALUE(lpColumn, i) == 0) { continue; }
+			if((lpSelection != NULL) && (CJSON_COLUMN_ISSET(lpSelection, i) == 0)) { continue; }
+
+			dValue = cjsonColumns_NumberAt(lpColumn, i);
+			if(dwCount == 0) {
+				dMin = dValue;
+				dMax = dValue;
+			}
+			dSum = dSum + dValue;
+			dMin = (dValue < dMin) ? dValue : dMin;
+			dMax = (dValue > dMax) ? dValue : dMax;
+			dwCount = dwCount + 1;
+		}
+	}
+
+	lpOut->dwCount = dwCount;
+	lpOut->dSum = dSum;
+	if(dwCount > 0) {
+		lpOut->dMin = dMin;
+		lpOut->dMax = dMax;
+	}
+	return cjsonE_Ok;
+}
+
+/*
+	Filters compare eight rows at a time and merge the resulting
+	byte into the selection together with the validity bits.
+*/
+static inline uint8_t cjsonColumns_CompareBlock(
+	const double* lpValues,
+	unsigned long int dwCount,
+	enum cjsonColumn_Compare eCompare,
+	double dOperand
+) {
+	unsigned long int i;
+	unsigned int dwBits = 0;
+
+	switch(eCompare) {
+		case cjsonColumn_Compare__Less:			for(i = 0; i < dwCount; i=i+1) { dwBits = dwBits | ((lpValues[i] < dOperand) ? (1U << i) : 0); } break;
+		case cjsonColumn_Compare__LessEqual:	for(i = 0; i < dwCount; i=i+1) { dwBits = dwBits | ((lpValues[i] <= dOperand) ? (1U << i) : 0); } break;
+		case cjsonColumn_Compare__Equal:		for(i = 0; i < dwCount; i=i+1) { dwBits = dwBits | ((lpValues[i] == dOperand) ? (1U << i) : 0); } break;
+		case cjsonColumn_Compare__NotEqual:		for(i = 0; i < dwCount; i=i+1) { dwBits = dwBits | ((lpValues[i] != dOperand) ? (1U << i) : 0); } break;
+		case cjsonColumn_Compare__GreaterEqual:	for(i = 0; i < dwCount; i=i+1) { dwBits = dwBits | ((lpValues[i] >= dOperand) ? (1U << i) : 0); } break;
+		default:								for(i = 0; i < dwCount; i=i+1) { dwBits = dwBits | ((lpValues[i] > dOperand) ? (1U << i) : 0); } break;
+	}
+	return (uint8_t)dwBits;
+}
+static unsigned long int cjsonColumns_FinishSelection(
+	const struct cjsonColumn* lpColumn,
+	uint8_t* lpSelection
+) {
+	unsigned long int dwBytes = CJSON_COLUMN_BITMAPBYTES(lpColumn->dwRowCount);
+	unsigned long int dwSelected = 0;
+	unsigned long int i;
+	uint8_t bByte;
+
+	for(i = 0; i < dwBytes; i=i+1) {
+		if(lpColumn->lpValid != NULL) { lpSelection[i] = (uint8_t)(lpSelection[i] & lpColumn->lpValid[i]); }
+		if((i == dwBytes - 1) && ((lpColumn->dwRowCount & 7) != 0)) { lpSelection[i] = (uint8_t)(lpSelection[i] & ((1U << (lpColumn->dwRowCount & 7)) - 1)); }
+
+		for(bByte = lpSelection[i]; bByte != 0; bByte = (uint8_t)(bByte & (bByte - 1))) { dwSelected = dwSelected + 1; }
+	}
+	return dwSelected;
+}
+
+enum cjsonError cjsonColumn_FilterNumber(
+	const struct cjsonColumn* lpColumn,
+	enum cjsonColumn_Compare eCompare,
+	double dOperand,
+	uint8_t* lpSelection,
+	unsigned long int* lpSelectedOut
+) {
+	double dBlock[8];
+	unsigned long int dwRow;
+	unsigned long int dwCount;
+	unsigned long int i;
+	unsigned long int dwSelected;
+
+	if(lpSelectedOut != NULL) { (*lpSelectedOut) = 0; }
+	if((lpColumn == NULL) || (lpSelection == NULL)) { return cjsonE_InvalidParam; }
+	if(cjsonColumns_IsNumeric(lpColumn) == 0) { return cjsonE_InvalidParam; }
+
+	for(dwRow = 0; dwRow < lpColumn->dwRowCount; dwRow=dwRow+8) {
+		dwCount = (lpColumn->dwRowCount - dwRow < 8) ? lpColumn->dwRowCount - dwRow : 8;
+		if(lpSelection[dwRow >> 3] == 0) { continue; }
+
+		if(lpColumn->type == cjsonColumn_Type__Double) {
+			lpSelection[dwRow >> 3] = (uint8_t)(lpSelection[dwRow >> 3] & cjsonColumns_CompareBlock(&(lpColumn->data.lpDouble[dwRow]), dwCount, eCompare, dOperand));
+		} else {
+			for(i = 0; i < dwCount; i=i+1) { dBlock[i] = cjsonColumns_NumberAt(lpColumn, dwRow + i); }
+			lpSelection[dwRow >> 3] = (uint8_t)(lpSelection[dwRow >> 3] & cjsonColumns_CompareBlock(dBlock, dwCount, eCompare, dOperand));
+		}
+	}
+
+	dwSelected = cjsonColumns_FinishSelection(lpColumn, lpSelection);
+	if(lpSelectedOut != NULL) { (*lpSelectedOut) = dwSelected; }
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonColumn_FilterString(
+	const struct cjsonColumn* lpColumn,
+	const char* lpString,
+	unsigned long int dwStringLength,
+	int bEqual,
+	uint8_t* lpSelection,
+	unsigned long int* lpSelectedOut
+) {
+	const unsigned long int* lpOffsets;
+	unsigned long int dwRow;
+	unsigned long int dwSelected;
+	int bMatch;
+
+	if(lpSelectedOut != NULL) { (*lpSelectedOut) = 0; }
+	if((lpColumn == NULL) || (lpSelection == NULL) || ((lpString == NULL) && (dwStringLength > 0))) { return cjsonE_InvalidParam; }
+	if(lpColumn->type != cjsonColumn_Type__String) { return cjsonE_InvalidParam; }
+
+	lpOffsets = lpColumn->data.lpStringOffsets;
+	for(dwRow = 0; dwRow < lpColumn->dwRowCount; dwRow=dwRow+1) {
+		if(CJSON_COLUMN_ISSET(lpSelection, dwRow) == 0) { continue; }
+
+		/* Lengths are compared before the bytes are touched */
+		bMatch = ((lpOffsets[dwRow + 1] - lpOffsets[dwRow] == dwStringLength) && (memcmp(&(lpColumn->lpStringBlob[lpOffsets[dwRow]]), lpString, dwStringLength) == 0)) ? 1 : 0;
+		if(bMatch != ((bEqual != 0) ? 1 : 0)) {
+			lpSelection[dwRow >> 3] = (uint8_t)(lpSelection[dwRow >> 3] & ~(1 << (dwRow & 7)));
+		}
+	}
+
+	dwSelected = cjsonColumns_FinishSelection(lpColumn, lpSelection);
+	if(lpSelectedOut != NULL) { (*lpSelectedOut) = dwSelected; }
+	return cjsonE_Ok;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,433 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_COMPARE_STACKSEGMENT
+	#define CJSON_COMPARE_STACKSEGMENT 32			/* Frames per segment of the compare and hash stacks */
+#endif
+
+/*
+	Equality and hashing work on the logical content of values:
+
+	- Objects are compared by looking up each key of the first
+	  object in the second one and hashed by summing up the hashes
+	  of their entries, so the bucket layout (and thus iteration
+	  order) does not matter.
+	- Numbers are compared by their numeric value. An unsigned
+	  long, signed long and double representing the same value are
+	  equal and hash identical.
+
+	Both walk the trees with explicit stacks (cjsonScratch_Stack)
+	that take additional segments from the scratch system of the
+	first value. If a stack segment cannot be allocated we fall
+	back to a nested call.
+*/
+#define CJSON_HASH_K0 0x9e3779b97f4a7c15ULL
+#define CJSON_HASH_K1 0xff51afd7ed558ccdULL
+#define CJSON_HASH_K2 0xc4ceb9fe1a85ec53ULL
+
+enum cjsonHash_Tag {
+	cjsonHash_Tag__Missing			= 1,		/* NULL array entries */
+	cjsonHash_Tag__Object,
+	cjsonHash_Tag__Array,
+	cjsonHash_Tag__String,
+	cjsonHash_Tag__Integer,
+	cjsonHash_Tag__NegativeInteger,
+	cjsonHash_Tag__Double,
+	cjsonHash_Tag__True,
+	cjsonHash_Tag__False,
+	cjsonHash_Tag__Null
+};
+
+static inline uint64_t cjsonHash_Finalize(
+	uint64_t qwValue
+) {
+	qwValue = qwValue ^ (qwValue >> 33);
+	qwValue = qwValue * CJSON_HASH_K1;
+	qwValue = qwValue ^ (qwValue >> 33);
+	qwValue = qwValue * CJSON_HASH_K2;
+	qwValue = qwValue ^ (qwValue >> 33);
+	return qwValue;
+}
+static inline uint64_t cjsonHash_Combine(
+	uint64_t qwHash,
+	uint64_t qwValue
+) {
+	return cjsonHash_Finalize((qwHash ^ qwValue) + CJSON_HASH_K0 + (qwHash << 6) + (qwHash >> 2));
+}
+static uint64_t cjsonHash_Bytes(
+	const char* lpData,
+	unsigned long int dwLength,
+	uint64_t qwSeed
+) {
+	uint64_t qwHash = qwSeed ^ ((uint64_t)dwLength * CJSON_HASH_K0);
+	uint64_t qwWord;
+	unsigned long int i;
+
+	for(i = 0; i + 8 <= dwLength; i = i + 8) {
+		memcpy(&qwWord, &(lpData[i]), 8);
+		qwHash = (qwHash ^ qwWord) * CJSON_HASH_K1;
+		qwHash = (qwHash << 31) | (qwHash >> 33);
+	}
+	if(i < dwLength) {
+		qwWord = 0;
+		memcpy(&qwWord, &(lpData[i]), dwLength - i);
+		qwHash = (qwHash ^ qwWord) * CJSON_HASH_K2;
+	}
+	return cjsonHash_Finalize(qwHash);
+}
+
+/*
+	Numbers are mapped to a canonical representation: integral values
+	that fit an unsigned long or a negative signed long are hashed as
+	integers independent of their storage type.
+*/
+static uint64_t cjsonHash_Number(
+	const struct cjsonNumber* lpNumber,
+	uint64_t qwSeed
+) {
+	double dValue;
+
+	switch(lpNumber->base.type) {
+		case cjsonNumber_UnsignedLong:
+			return cjsonHash_Combine(qwSeed ^ cjsonHash_Tag__Integer, (uint64_t)lpNumber->value.ulong);
+		case cjsonNumber_SignedLong:
+			if(lpNumber->value.slong >= 0) {
+				return cjsonHash_Combine(qwSeed ^ cjsonHash_Tag__Integer, (uint64_t)lpNumber->value.slong);
+			}
+			return cjsonHash_Combine(qwSeed ^ cjsonHash_Tag__NegativeInteger, (uint64_t)lpNumber->value.slong);
+		default:
+			dValue = lpNumber->value.dbl;
+			if((dValue >= 0) && (dValue < (double)ULONG_MAX + 1.0) && ((double)((unsigned long int)dValue) == dValue)) {
+				return cjsonHash_Combine(qwSeed ^ cjsonHash_Tag__Integer, (uint64_t)((unsigned long int)dValue));
+			}
+			if((dValue < 0) && (dValue >= (double)LONG_MIN) && ((double)((signed long int)dValue) == dValue)) {
+				return cjsonHash_Combine(qwSeed ^ cjsonHash_Tag__NegativeInteger, (uint64_t)((signed long int)dValue));
+			}
+			return cjsonHash_Bytes((const char*)&dValue, sizeof(double), qwSeed ^ cjsonHash_Tag__Double);
+	}
+}
+
+static int cjsonEquals_Numbers(
+	const struct cjsonNumber* lpA,
+	const struct cjsonNumber* lpB
+) {
+	const struct cjsonNumber* lpSwap;
+	double dValue;
+
+	/* Order the pair so we only have to handle one direction */
+	if(lpA->base.type > lpB->base.type) {
+		lpSwap = lpA;
+		lpA = lpB;
+		lpB = lpSwap;
+	}
+
+	if(lpA->base.type == lpB->base.type) {
+		switch(lpA->base.type) {
+			case cjsonNumber_UnsignedLong:	return (lpA->value.ulong == lpB->value.ulong) ? 1 : 0;
+			case cjsonNumber_SignedLong:	return (lpA->value.slong == lpB->value.slong) ? 1 : 0;
+			default:						return (lpA->value.dbl == lpB->value.dbl) ? 1 : 0;
+		}
+	}
+
+	if(lpB->base.type != cjsonNumber_Double) {
+		/* Unsigned and signed long */
+		return ((lpB->value.slong >= 0) && ((unsigned long int)(lpB->value.slong) == lpA->value.ulong)) ? 1 : 0;
+	}
+
+	dValue = lpB->value.dbl;
+	if(lpA->base.type == cjsonNumber_UnsignedLong) {
+		if((dValue < 0) || (dValue >= (double)ULONG_MAX + 1.0)) { return 0; }
+		return (((unsigned long int)dValue == lpA->value.ulong) && ((double)((unsigned long int)dValue) == dValue)) ? 1 : 0;
+	} else {
+		if((dValue < (double)LONG_MIN) || (dValue >= -((double)LONG_MIN))) { return 0; }
+		return (((signed long int)dValue == lpA->value.slong) && ((double)((signed long int)dValue) == dValue)) ? 1 : 0;
+	}
+}
+
+/*
+	Child iteration shared by both walks. Returns 0 if all
+	children of the container have been visited.
+*/
+struct cjsonCompare_Cursor {
+	const struct cjsonArray_Page*				lpPage;			/* Arrays: current page */
+	const struct cjsonObject_BucketEntry*		lpEntry;		/* Objects: next entry of the current chain */
+	unsigned long int							dwIndex;		/* Arrays: entry inside page, Objects: next bucket */
+};
+
+static inline void cjsonCompare_CursorInit(
+	struct cjsonCompare_Cursor* lpCursor,
+	const struct cjsonValue* lpContainer
+) {
+	lpCursor->lpPage = (lpContainer->type == cjsonArray) ? ((const struct cjsonArray*)lpContainer)->pageList.lpFirstPage : NULL;
+	lpCursor->lpEntry = NULL;
+	lpCursor->dwIndex = 0;
+}
+static inline int cjsonCompare_NextChild(
+	struct cjsonCompare_Cursor* lpCursor,
+	const struct cjsonValue* lpContainer,
+	const struct cjsonObject_BucketEntry** lpEntryOut,
+	const struct cjsonValue** lpChildOut
+) {
+	const struct cjsonObject* lpObject;
+
+	if(lpContainer->type == cjsonArray) {
+		while(lpCursor->lpPage != NULL) {
+			if(lpCursor->dwIndex < lpCursor->lpPage->dwUsedEntries) {
+				(*lpChildOut) = lpCursor->lpPage->entries[lpCursor->dwIndex];
+				lpCursor->dwIndex = lpCursor->dwIndex + 1;
+				return 1;
+			}
+			lpCursor->lpPage = lpCursor->lpPage->pageList.lpNext;
+			lpCursor->dwIndex = 0;
+		}
+		return 0;
+	}
+
+	lpObject = (const struct cjsonObject*)lpContainer;
+	while(lpCursor->lpEntry == NULL) {
+		if(lpCursor->dwIndex >= lpObject->dwBucketCount) { return 0; }
+		lpCursor->lpEntry = lpObject->buckets[lpCursor->dwIndex];
+		lpCursor->dwIndex = lpCursor->dwIndex + 1;
+	}
+
+	(*lpEntryOut) = lpCursor->lpEntry;
+	(*lpChildOut) = lpCursor->lpEntry->lpValue;
+	lpCursor->lpEntry = lpCursor->lpEntry->bucketList.lpNext;
+	if(lpCursor->lpEntry != NULL) { CJSON_PREFETCH(lpCursor->lpEntry); }
+	return 1;
+}
+
+static inline int cjsonCompare_IsContainer(
+	const struct cjsonValue* lpValue
+) {
+	return ((lpValue->type == cjsonObject) || (lpValue->type == cjsonArray)) ? 1 : 0;
+}
+
+/*
+	Equality
+*/
+struct cjsonEquals_Frame {
+	const struct cjsonValue*					lpA;
+	const struct cjsonValue*					lpB;
+	struct cjsonCompare_Cursor					cursorA;
+	struct cjsonCompare_Cursor					cursorB;		/* Only used for arrays */
+};
+/*
+	Compares everything that can be compared without descending.
+	Returns 0 if the values differ, 1 if they're equal and 2 if
+	both are containers of the same type and size that have to be
+	compared element by element.
+*/
+static int cjsonEquals_Shallow(
+	const struct cjsonValue* lpA,
+	const struct cjsonValue* lpB
+) {
+	if(lpA == lpB) { return 1; } /* Identical (or shared) values */
+	if((lpA == NULL) || (lpB == NULL)) { return 0; }
+
+	if(cjsonIsNumeric(lpA) && cjsonIsNumeric(lpB)) {
+		return cjsonEquals_Numbers((const struct cjsonNumber*)lpA, (const struct cjsonNumber*)lpB);
+	}
+	if(lpA->type != lpB->type) { return 0; }
+
+	switch(lpA->type) {
+		case cjsonString:
+			if(((const struct cjsonString*)lpA)->dwStrlen != ((const struct cjsonString*)lpB)->dwStrlen) { return 0; }
+			return (memcmp(((const struct cjsonString*)lpA)->bData, ((const struct cjsonString*)lpB)->bData, ((const struct cjsonString*)lpA)->dwStrlen) == 0) ? 1 : 0;
+		case cjsonArray:
+			return (((const struct cjsonArray*)lpA)->dwElementCount == ((const struct cjsonArray*)lpB)->dwElementCount) ? 2 : 0;
+		case cjsonObject:
+			return (((const struct cjsonObject*)lpA)->dwElementCount == ((const struct cjsonObject*)lpB)->dwElementCount) ? 2 : 0;
+		default:
+			return 1;
+	}
+}
+
+static int cjsonEquals_Push(
+	struct cjsonScratch_Stack* lpStack,
+	const struct cjsonValue* lpA,
+	const struct cjsonValue* lpB
+) {
+	struct cjsonEquals_Frame* lpFrame;
+
+	lpFrame = (struct cjsonEquals_Frame*)cjsonScratch_Push(lpStack);
+	if(lpFrame == NULL) { return 0; }
+
+	lpFrame->lpA = lpA;
+	lpFrame->lpB = lpB;
+	cjsonCompare_CursorInit(&(lpFrame->cursorA), lpA);
+	cjsonCompare_CursorInit(&(lpFrame->cursorB), lpB);
+	return 1;
+}
+
+int cjsonValue_Equals(
+	const struct cjsonValue* lpA,
+	const struct cjsonValue* lpB
+) {
+	struct cjsonEquals_Frame stackBase[CJSON_COMPARE_STACKSEGMENT];
+	struct cjsonScratch_Stack stack;
+	struct cjsonEquals_Frame* lpFrame;
+	const struct cjsonObject_BucketEntry* lpEntry;
+	const struct cjsonValue* lpChildA;
+	const struct cjsonValue* lpChildB;
+	struct cjsonValue* lpLookup;
+	int r;
+
+	r = cjsonEquals_Shallow(lpA, lpB);
+	if(r != 2) { return r; }
+
+	cjsonScratch_StackInit(&stack, (void*)stackBase, sizeof(struct cjsonEquals_Frame), CJSON_COMPARE_STACKSEGMENT, lpA->lpSystem);
+	cjsonEquals_Push(&stack, lpA, lpB);
+
+	while(!CJSON_SCRATCH_EMPTY(&stack)) {
+		lpFrame = (struct cjsonEquals_Frame*)CJSON_SCRATCH_TOP(&stack);
+
+		if(cjsonCompare_NextChild(&(lpFrame->cursorA), lpFrame->lpA, &lpEntry, &lpChildA) == 0) {
+			/* Sizes are equal so the second container is exhausted too */
+			cjsonScratch_Pop(&stack);
+			continue;
+		}
+
+		if(lpFrame->lpA->type == cjsonArray) {
+			cjsonCompare_NextChild(&(lpFrame->cursorB), lpFrame->lpB, &lpEntry, &lpChildB);
+		} else {
+			if(cjsonObject_Get(lpFrame->lpB, lpEntry->bKey, lpEntry->dwKeyLength, &lpLookup) != cjsonE_Ok) {
+				cjsonScratch_StackRelease(&stack);
+				return 0;
+			}
+			lpChildB = lpLookup;
+		}
+
+		r = cjsonEquals_Shallow(lpChildA, lpChildB);
+		if(r == 2) {
+			if(cjsonEquals_Push(&stack, lpChildA, lpChildB) == 0) {
+				r = cjsonValue_Equals(lpChildA, lpChildB);
+			}
+		}
+		if(r == 0) {
+			cjsonScratch_StackRelease(&stack);
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*
+	Hashing. Each frame accumulates the hash of its container,
+	finished containers are folded into their parent frame.
+*/
+struct cjsonHash_Frame {
+	const struct cjsonValue*					lpValue;
+	struct cjsonCompare_Cursor					cursor;
+	uint64_t									qwAccumulator;
+	uint64_t									qwKeyHash;		/* Objects: key of the entry we descended into */
+};
+static uint64_t cjsonHash_Scalar(
+	const struct cjsonValue* lpValue,
+	uint64_t qwSeed
+) {
+	if(lpValue == NULL) { return cjsonHash_Combine(qwSeed, cjsonHash_Tag__Missing); }
+
+	switch(lpValue->type) {
+		case cjsonString:
+			return cjsonHash_Bytes(((const struct cjsonString*)lpValue)->bData, ((const struct cjsonString*)lpValue)->dwStrlen, qwSeed ^ cjsonHash_Tag__String);
+		case cjsonNumber_UnsignedLong:
+		case cjsonNumber_SignedLong:
+		case cjsonNumber_Double:
+			return cjsonHash_Number((const struct cjsonNumber*)lpValue, qwSeed);
+		case cjsonTrue:		return cjsonHash_Combine(qwSeed, cjsonHash_Tag__True);
+		case cjsonFalse:	return cjsonHash_Combine(qwSeed, cjsonHash_Tag__False);
+		default:			return cjsonHash_Combine(qwSeed, cjsonHash_Tag__Null);
+	}
+}
+static inline void cjsonHash_Fold(
+	struct cjsonHash_Frame* lpFrame,
+	uint64_t qwChildHash
+) {
+	if(lpFrame->lpValue->type == cjsonArray) {
+		lpFrame->qwAccumulator = cjsonHash_Combine(lpFrame->qwAccumulator, qwChildHash);
+	} else {
+		/* Commutative so the bucket order does not matter */
+		lpFrame->qwAccumulator = lpFrame->qwAccumulator + cjsonHash_Combine(lpFrame->qwKeyHash, qwChildHash);
+	}
+}
+static inline uint64_t cjsonHash_FinishContainer(
+	const struct cjsonHash_Frame* lpFrame,
+	uint64_t qwSeed
+) {
+	if(lpFrame->lpValue->type == cjsonArray) {
+		return cjsonHash_Combine(lpFrame->qwAccumulator, ((const struct cjsonArray*)(lpFrame->lpValue))->dwElementCount);
+	} else {
+		return cjsonHash_Combine(qwSeed ^ cjsonHash_Tag__Object, lpFrame->qwAccumulator + ((const struct cjsonObject*)(lpFrame->lpValue))->dwElementCount);
+	}
+}
+static int cjsonHash_Push(
+	struct cjsonScratch_Stack* lpStack,
+	const struct cjsonValue* lpValue,
+	uint64_t qwSeed
+) {
+	struct cjsonHash_Frame* lpFrame;
+
+	lpFrame = (struct cjsonHash_Frame*)cjsonScratch_Push(lpStack);
+	if(lpFrame == NULL) { return 0; }
+
+	lpFrame->lpValue = lpValue;
+	cjsonCompare_CursorInit(&(lpFrame->cursor), lpValue);
+	lpFrame->qwAccumulator = (lpValue->type == cjsonArray) ? (qwSeed ^ cjsonHash_Tag__Array) : 0;
+	lpFrame->qwKeyHash = 0;
+	return 1;
+}
+
+uint64_t cjsonValue_Hash(
+	const struct cjsonValue* lpValue,
+	uint64_t qwSeed
+) {
+	struct cjsonHash_Frame stackBase[CJSON_COMPARE_STACKSEGMENT];
+	struct cjsonScratch_Stack stack;
+	struct cjsonHash_Frame* lpFrame;
+	const struct cjsonObject_BucketEntry* lpEntry;
+	const struct cjsonValue* lpChild;
+	uint64_t qwHash;
+
+	if((lpValue == NULL) || (cjsonCompare_IsContainer(lpValue) == 0)) {
+		return cjsonHash_Scalar(lpValue, qwSeed);
+	}
+
+	cjsonScratch_StackInit(&stack, (void*)stackBase, sizeof(struct cjsonHash_Frame), CJSON_COMPARE_STACKSEGMENT, lpValue->lpSystem);
+	cjsonHash_Push(&stack, lpValue, qwSeed);
+
+	for(;;) {
+		lpFrame = (struct cjsonHash_Frame*)CJSON_SCRATCH_TOP(&stack);
+
+		if(cjsonCompare_NextChild(&(lpFrame->cursor), lpFrame->lpValue, &lpEntry, &lpChild) == 0) {
+			qwHash = cjsonHash_FinishContainer(lpFrame, qwSeed);
+			cjsonScratch_Pop(&stack);
+			if(CJSON_SCRATCH_EMPTY(&stack)) { return qwHash; }
+			cjsonHash_Fold((struct cjsonHash_Frame*)CJSON_SCRATCH_TOP(&stack), qwHash);
+			continue;
+		}
+
+		if(lpFrame->lpValue->type == cjsonObject) {
+			lpFrame->qwKeyHash = cjsonHash_Bytes(lpEntry->bKey, lpEntry->dwKeyLength, qwSeed);
+		}
+
+		if((lpChild != NULL) && (cjsonCompare_IsContainer(lpChild) != 0)) {
+			if(cjsonHash_Push(&stack, lpChild, qwSeed) == 0) {
+				cjsonHash_Fold(lpFrame, cjsonValue_Hash(lpChild, qwSeed));
+			}
+		} else {
+			cjsonHash_Fold(lpFrame, cjsonHash_Scalar(lpChild, qwSeed));
+		}
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
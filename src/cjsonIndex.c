@@ -0,0 +1,370 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_INDEX_HASHSEED
+	#define CJSON_INDEX_HASHSEED 0x3c6ef372fe94f82bULL	/* Seed passed to cjsonValue_Hash for key values */
+#endif
+#ifndef CJSON_INDEX_MINBUCKETS
+	#define CJSON_INDEX_MINBUCKETS 16					/* Bucket count of indices over small arrays */
+#endif
+
+#define CJSON_INDEX_NOENTRY								(~0UL)
+
+/*
+	Entries live in a single table and are chained by their
+	position, removed entries are kept in a free list. The key
+	value is referenced inside the element, so it's only valid as
+	long as the element is not modified.
+*/
+struct cjsonIndex_Entry {
+	uint64_t									qwHash;
+	struct cjsonValue*							lpElement;
+	const struct cjsonValue*					lpKey;
+	unsigned long int							dwNext;		/* Next entry of the bucket or of the free list */
+};
+
+struct cjsonIndex {
+	struct cjsonArray_Hook						hook;		/* Has to be the first member */
+	struct cjsonSystemAPI*						lpSystem;
+	struct cjsonValue*							lpArray;	/* NULL after the array has been released */
+	struct cjsonPath*							lpKeyPath;
+	int											bStale;		/* Rebuilt on the next lookup */
+
+	unsigned long int*							lpBuckets;
+	unsigned long int							dwBucketCount;	/* Power of two */
+
+	struct cjsonIndex_Entry*					lpEntries;
+	unsigned long int							dwEntryCapacity;
+	unsigned long int							dwEntriesUsed;	/* High water mark of the table */
+	unsigned long int							dwEntryCount;	/* Entries in buckets */
+	unsigned long int							dwFreeEntry;
+};
+
+/*
+	Malloc and free abstraction
+*/
+static inline enum cjsonError cjsonIndex_Alloc(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpSystem->alloc(lpSystem, dwSize, lpOut);
+	}
+}
+static inline void cjsonIndex_Free(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpBlock == NULL) { return; }
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+
+static enum cjsonError cjsonIndex_FirstMatch(
+	struct cjsonValue* lpValue,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpValue;
+	return cjsonE_Finished;
+}
+static struct cjsonValue* cjsonIndex_KeyOf(
+	const struct cjsonIndex* lpIndex,
+	struct cjsonValue* lpElement
+) {
+	struct cjsonValue* lpKey = NULL;
+
+	if(cjsonPath_Eval(lpIndex->lpKeyPath, lpElement, &cjsonIndex_FirstMatch, (void*)&lpKey) != cjsonE_Ok) { return NULL; }
+	return lpKey;
+}
+
+/*
+	Hash table maintenance
+*/
+static enum cjsonError cjsonIndex_Resize(
+	struct cjsonIndex* lpIndex,
+	unsigned long int dwBucketCount
+) {
+	unsigned long int* lpBuckets;
+	unsigned long int i;
+	unsigned long int dwBucket;
+	enum cjsonError e;
+
+	e = cjsonIndex_Alloc(lpIndex->lpSystem, sizeof(unsigned long int) * dwBucketCount, (void**)&lpBuckets);
+	if(e != cjsonE_Ok) { return e; }
+	for(i = 0; i < dwBucketCount; i=i+1) { lpBuckets[i] = CJSON_INDEX_NOENTRY; }
+
+	/* Free entries have no element, all others are moved into the new buckets */
+	for(i = 0; i < lpIndex->dwEntriesUsed; i=i+1) {
+		if(lpIndex->lpEntries[i].lpElement == NULL) { continue; }
+		dwBucket = (unsigned long int)(lpIndex->lpEntries[i].qwHash & (dwBucketCount - 1));
+		lpIndex->lpEntries[i].dwNext = lpBuckets[dwBucket];
+		lpBuckets[dwBucket] = i;
+	}
+
+	cjsonIndex_Free(lpIndex->lpSystem, lpIndex->lpBuckets);
+	lpIndex->lpBuckets = lpBuckets;
+	lpIndex->dwBucketCount = dwBucketCount;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonIndex_GrowEntries(
+	struct cjsonIndex* lpIndex
+) {
+	struct cjsonIndex_Entry* lpEntries;
+	unsigned long int dwCapacity;
+	enum cjsonError e;
+
+	dwCapacity = (lpIndex->dwEntryCapacity > 0) ? lpIndex->dwEntryCapacity * 2 : CJSON_INDEX_MINBUCKETS;
+	e = cjsonIndex_Alloc(lpIndex->lpSystem, sizeof(struct cjsonIndex_Entry) * dwCapacity, (void**)&lpEntries);
+	if(e != cjsonE_Ok) { return e; }
+	if(lpIndex->dwEntriesUsed > 0) { memcpy(lpEntries, lpIndex->lpEntries, sizeof(struct cjsonIndex_Entry) * lpIndex->dwEntriesUsed); }
+
+	cjsonIndex_Free(lpIndex->lpSystem, lpIndex->lpEntries);
+	lpIndex->lpEntries = lpEntries;
+	lpIndex->dwEntryCapacity = dwCapacity;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonIndex_Insert(
+	struct cjsonIndex* lpIndex,
+	struct cjsonValue* lpElement
+) {
+	struct cjsonIndex_Entry* lpEntry;
+	const struct cjsonValue* lpKey;
+	unsigned long int dwEntry;
+	unsigned long int dwBucket;
+	enum cjsonError e;
+
+	/* Elements without key are not indexed */
+	lpKey = cjsonIndex_KeyOf(lpIndex, lpElement);
+	if(lpKey == NULL) { return cjsonE_Ok; }
+
+	/* Load factor of at most 3/4 */
+	if((lpIndex->dwEntryCount + 1) * 4 > lpIndex->dwBucketCount * 3) {
+		e = cjsonIndex_Resize(lpIndex, lpIndex->dwBucketCount * 2);
+		if(e != cjsonE_Ok) { return e; }
+	}
+
+	if(lpIndex->dwFreeEntry != CJSON_INDEX_NOENTRY) {
+		dwEntry = lpIndex->dwFreeEntry;
+		lpIndex->dwFreeEntry = lpIndex->lpEntries[dwEntry].dwNext;
+	} else {
+		if(lpIndex->dwEntriesUsed == lpIndex->dwEntryCapacity) {
+			e = cjsonIndex_GrowEntries(lpIndex);
+			if(e != cjsonE_Ok) { return e; }
+		}
+		dwEntry = lpIndex->dwEntriesUsed;
+		lpIndex->dwEntriesUsed = lpIndex->dwEntriesUsed + 1;
+	}
+
+	lpEntry = &(lpIndex->lpEntries[dwEntry]);
+	lpEntry->qwHash = cjsonValue_Hash(lpKey, CJSON_INDEX_HASHSEED);
+	lpEntry->lpElement = lpElement;
+	lpEntry->lpKey = lpKey;
+
+	dwBucket = (unsigned long int)(lpEntry->qwHash & (lpIndex->dwBucketCount - 1));
+	lpEntry->dwNext = lpIndex->lpBuckets[dwBucket];
+	lpIndex->lpBuckets[dwBucket] = dwEntry;
+	lpIndex->dwEntryCount = lpIndex->dwEntryCount + 1;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonIndex_Remove(
+	struct cjsonIndex* lpIndex,
+	struct cjsonValue* lpElement
+) {
+	const struct cjsonValue* lpKey;
+	unsigned long int* lpLink;
+	unsigned long int dwEntry;
+
+	lpKey = cjsonIndex_KeyOf(lpIndex, lpElement);
+	if(lpKey == NULL) { return cjsonE_Ok; }
+
+	lpLink = &(lpIndex->lpBuckets[cjsonValue_Hash(lpKey, CJSON_INDEX_HASHSEED) & (lpIndex->dwBucketCount - 1)]);
+	while((dwEntry = (*lpLink)) != CJSON_INDEX_NOENTRY) {
+		if(lpIndex->lpEntries[dwEntry].lpElement == lpElement) {
+			(*lpLink) = lpIndex->lpEntries[dwEntry].dwNext;
+			lpIndex->lpEntries[dwEntry].lpElement = NULL;
+			lpIndex->lpEntries[dwEntry].lpKey = NULL;
+			lpIndex->lpEntries[dwEntry].dwNext = lpIndex->dwFreeEntry;
+			lpIndex->dwFreeEntry = dwEntry;
+			lpIndex->dwEntryCount = lpIndex->dwEntryCount - 1;
+			return cjsonE_Ok;
+		}
+		lpLink = &(lpIndex->lpEntries[dwEntry].dwNext);
+	}
+
+	/* The key of the element has been modified after it has been indexed */
+	return cjsonE_InvalidState;
+}
+
+/*
+	Hook attached to the array. Failed incremental updates mark
+	the index stale, the next lookup rebuilds it.
+*/
+static void cjsonIndex_ArrayChanged(
+	struct cjsonArray_Hook* lpHook,
+	enum cjsonArray_HookEvent event,
+	struct cjsonValue* lpElement
+) {
+	struct cjsonIndex* lpIndex = (struct cjsonIndex*)lpHook;
+
+	switch(event) {
+		case cjsonArray_HookEvent__Added:
+			if(lpIndex->bStale != 0) { return; }
+			if(cjsonIndex_Insert(lpIndex, lpElement) != cjsonE_Ok) { lpIndex->bStale = 1; }
+			return;
+		case cjsonArray_HookEvent__Removed:
+			if(lpIndex->bStale != 0) { return; }
+			if(cjsonIndex_Remove(lpIndex, lpElement) != cjsonE_Ok) { lpIndex->bStale = 1; }
+			return;
+		default:
+			lpIndex->lpArray = NULL;
+			lpIndex->bStale = 1;
+			return;
+	}
+}
+
+enum cjsonError cjsonIndex_Rebuild(
+	struct cjsonIndex* lpIndex
+) {
+	const struct cjsonArray_Page* lpPage;
+	unsigned long int dwBucketCount;
+	unsigned long int i;
+	enum cjsonError e;
+
+	if(lpIndex == NULL) { return cjsonE_InvalidParam; }
+	if(lpIndex->lpArray == NULL) { return cjsonE_InvalidState; }
+
+	lpIndex->bStale = 1;
+	lpIndex->dwEntriesUsed = 0;
+	lpIndex->dwEntryCount = 0;
+	lpIndex->dwFreeEntry = CJSON_INDEX_NOENTRY;
+
+	/* Size the table for the current length so the build never rehashes */
+	dwBucketCount = CJSON_INDEX_MINBUCKETS;
+	while(dwBucketCount * 3 < ((struct cjsonArray*)(lpIndex->lpArray))->dwElementCount * 4) { dwBucketCount = dwBucketCount * 2; }
+	if(dwBucketCount != lpIndex->dwBucketCount) {
+		e = cjsonIndex_Resize(lpIndex, dwBucketCount);
+		if(e != cjsonE_Ok) { return e; }
+	} else {
+		for(i = 0; i < dwBucketCount; i=i+1) { lpIndex->lpBuckets[i] = CJSON_INDEX_NOENTRY; }
+	}
+
+	for(lpPage = ((struct cjsonArray*)(lpIndex->lpArray))->pageList.lpFirstPage; lpPage != NULL; lpPage = lpPage->pageList.lpNext) {
+		if(lpPage->pageList.lpNext != NULL) { CJSON_PREFETCH(lpPage->pageList.lpNext); }
+		for(i = 0; i < lpPage->dwUsedEntries; i=i+1) {
+			if(lpPage->entries[i] == NULL) { continue; }
+			e = cjsonIndex_Insert(lpIndex, lpPage->entries[i]);
+			if(e != cjsonE_Ok) { return e; }
+		}
+	}
+
+	lpIndex->bStale = 0;
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonIndex_Build(
+	struct cjsonIndex** lpOut,
+	struct cjsonValue* lpArray,
+	const char* lpKeyPath,
+	unsigned long int dwKeyPathLength,
+	struct cjsonSystemAPI* lpSystem
+) {
+	struct cjsonIndex* lpNew;
+	enum cjsonError e;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+	if(lpArray == NULL) { return cjsonE_InvalidParam; }
+	if(lpArray->type != cjsonArray) { return cjsonE_InvalidParam; }
+
+	e = cjsonIndex_Alloc(lpSystem, sizeof(struct cjsonIndex), (void**)&lpNew);
+	if(e != cjsonE_Ok) { return e; }
+	lpNew->hook.lpNext = NULL;
+	lpNew->hook.callback = &cjsonIndex_ArrayChanged;
+	lpNew->lpSystem = lpSystem;
+	lpNew->lpArray = lpArray;
+	lpNew->bStale = 1;
+	lpNew->lpBuckets = NULL;
+	lpNew->dwBucketCount = 0;
+	lpNew->lpEntries = NULL;
+	lpNew->dwEntryCapacity = 0;
+	lpNew->dwEntriesUsed = 0;
+	lpNew->dwEntryCount = 0;
+	lpNew->dwFreeEntry = CJSON_INDEX_NOENTRY;
+
+	e = cjsonPath_Compile(&(lpNew->lpKeyPath), lpKeyPath, dwKeyPathLength, lpSystem);
+	if(e != cjsonE_Ok) {
+		cjsonIndex_Free(lpSystem, lpNew);
+		return e;
+	}
+
+	e = cjsonIndex_Rebuild(lpNew);
+	if(e == cjsonE_Ok) { e = cjsonArray_AttachHook(lpArray, &(lpNew->hook)); }
+	if(e != cjsonE_Ok) {
+		lpNew->lpArray = NULL;
+		cjsonIndex_Release(lpNew);
+		return e;
+	}
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+void cjsonIndex_Release(
+	struct cjsonIndex* lpIndex
+) {
+	if(lpIndex == NULL) { return; }
+
+	if(lpIndex->lpArray != NULL) { cjsonArray_DetachHook(lpIndex->lpArray, &(lpIndex->hook)); }
+	cjsonPath_Release(lpIndex->lpKeyPath);
+	cjsonIndex_Free(lpIndex->lpSystem, lpIndex->lpBuckets);
+	cjsonIndex_Free(lpIndex->lpSystem, lpIndex->lpEntries);
+	cjsonIndex_Free(lpIndex->lpSystem, lpIndex);
+}
+
+enum cjsonError cjsonIndex_Lookup(
+	struct cjsonIndex* lpIndex,
+	const struct cjsonValue* lpKey,
+	struct cjsonValue** lpElementOut
+) {
+	const struct cjsonIndex_Entry* lpEntry;
+	unsigned long int dwEntry;
+	uint64_t qwHash;
+	enum cjsonError e;
+
+	if(lpElementOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpElementOut) = NULL;
+	if((lpIndex == NULL) || (lpKey == NULL)) { return cjsonE_InvalidParam; }
+
+	if(lpIndex->bStale != 0) {
+		e = cjsonIndex_Rebuild(lpIndex);
+		if(e != cjsonE_Ok) { return e; }
+	}
+
+	qwHash = cjsonValue_Hash(lpKey, CJSON_INDEX_HASHSEED);
+	for(dwEntry = lpIndex->lpBuckets[qwHash & (lpIndex->dwBucketCount - 1)]; dwEntry != CJSON_INDEX_NOENTRY; dwEntry = lpEntry->dwNext) {
+		lpEntry = &(lpIndex->lpEntries[dwEntry]);
+		if(lpEntry->qwHash != qwHash) { continue; }
+		if(cjsonValue_Equals(lpEntry->lpKey, lpKey) == 0) { continue; }
+
+		(*lpElementOut) = lpEntry->lpElement;
+		return cjsonE_Ok;
+	}
+	return cjsonE_IndexOutOfBounds;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,754 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_MSGPACK_INITIALFRAMES
+	#define CJSON_MSGPACK_INITIALFRAMES 16			/* Initial capacity of the encoder and decoder stacks */
+#endif
+#ifndef CJSON_MSGPACK_MAXSIZEHINT
+	#define CJSON_MSGPACK_MAXSIZEHINT 4096			/* Largest announced container size used to presize arrays and objects */
+#endif
+#ifndef CJSON_MSGPACK_MAXSTRLENGTH
+	#define CJSON_MSGPACK_MAXSTRLENGTH 67108864		/* Longest accepted string, longer announced lengths are rejected before allocating */
+#endif
+
+#define CJSON_MSGPACK_MAXHEADER			9			/* Longest format byte plus argument */
+
+#define CJSON_MSGPACK_NIL				0xC0
+#define CJSON_MSGPACK_FALSE				0xC2
+#define CJSON_MSGPACK_TRUE				0xC3
+#define CJSON_MSGPACK_FLOAT32			0xCA
+#define CJSON_MSGPACK_FLOAT64			0xCB
+#define CJSON_MSGPACK_UINT8				0xCC
+#define CJSON_MSGPACK_UINT16			0xCD
+#define CJSON_MSGPACK_UINT32			0xCE
+#define CJSON_MSGPACK_UINT64			0xCF
+#define CJSON_MSGPACK_INT8				0xD0
+#define CJSON_MSGPACK_INT16				0xD1
+#define CJSON_MSGPACK_INT32				0xD2
+#define CJSON_MSGPACK_INT64				0xD3
+#define CJSON_MSGPACK_STR8				0xD9
+#define CJSON_MSGPACK_STR16				0xDA
+#define CJSON_MSGPACK_STR32				0xDB
+#define CJSON_MSGPACK_ARRAY16			0xDC
+#define CJSON_MSGPACK_ARRAY32			0xDD
+#define CJSON_MSGPACK_MAP16				0xDE
+#define CJSON_MSGPACK_MAP32				0xDF
+
+/*
+	Malloc and free abstraction
+*/
+static inline enum cjsonError cjsonMsgpack_Alloc(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpSystem->alloc(lpSystem, dwSize, lpOut);
+	}
+}
+static inline void cjsonMsgpack_Free(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+static enum cjsonError cjsonMsgpack_GrowStack(
+	struct cjsonSystemAPI* lpSystem,
+	void** lpFrames,
+	unsigned long int dwFrameCount,
+	unsigned long int* lpFrameCapacity,
+	unsigned long int dwFrameSize
+) {
+	enum cjsonError e;
+	unsigned long int dwNewCapacity;
+	void* lpNew;
+
+	if(dwFrameCount < (*lpFrameCapacity)) { return cjsonE_Ok; }
+
+	dwNewCapacity = ((*lpFrameCapacity) == 0) ? CJSON_MSGPACK_INITIALFRAMES : (*lpFrameCapacity) * 2;
+	e = cjsonMsgpack_Alloc(lpSystem, dwNewCapacity * dwFrameSize, &lpNew);
+	if(e != cjsonE_Ok) { return e; }
+
+	if((*lpFrames) != NULL) {
+		memcpy(lpNew, (*lpFrames), dwFrameCount * dwFrameSize);
+		cjsonMsgpack_Free(lpSystem, (*lpFrames));
+	}
+	(*lpFrames) = lpNew;
+	(*lpFrameCapacity) = dwNewCapacity;
+	return cjsonE_Ok;
+}
+
+/*
+	Encoder. Every emitted item fits into the remaining buffer space
+	(at least CJSON_MSGPACK_MAXHEADER bytes are free before an item is
+	emitted) except string payloads which are written directly if they
+	don't fit.
+*/
+static inline void cjsonMsgpackEncoder_Put(
+	struct cjsonMsgpackEncoder* lpEncoder,
+	uint8_t bFormat,
+	uint64_t qwArgument,
+	unsigned long int dwArgumentBytes
+) {
+	unsigned long int i;
+
+	lpEncoder->bBuffer[lpEncoder->dwBufferUsed] = (char)bFormat;
+	for(i = 0; i < dwArgumentBytes; i=i+1) {
+		lpEncoder->bBuffer[lpEncoder->dwBufferUsed + dwArgumentBytes - i] = (char)((uint8_t)(qwArgument >> (8 * i)));
+	}
+	lpEncoder->dwBufferUsed = lpEncoder->dwBufferUsed + 1 + dwArgumentBytes;
+}
+static void cjsonMsgpackEncoder_Unsigned(
+	struct cjsonMsgpackEncoder* lpEncoder,
+	uint64_t qwValue
+) {
+	if(qwValue < 0x80) { cjsonMsgpackEncoder_Put(lpEncoder, (uint8_t)qwValue, 0, 0); }
+	else if(qwValue <= 0xFF) { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_UINT8, qwValue, 1); }
+	else if(qwValue <= 0xFFFF) { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_UINT16, qwValue, 2); }
+	else if(qwValue <= 0xFFFFFFFFULL) { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_UINT32, qwValue, 4); }
+	else { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_UINT64, qwValue, 8); }
+}
+static void cjsonMsgpackEncoder_Signed(
+	struct cjsonMsgpackEncoder* lpEncoder,
+	int64_t iValue
+) {
+	if(iValue >= 0) { cjsonMsgpackEncoder_Unsigned(lpEncoder, (uint64_t)iValue); }
+	else if(iValue >= -32) { cjsonMsgpackEncoder_Put(lpEncoder, (uint8_t)iValue, 0, 0); }
+	else if(iValue >= -128) { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_INT8, (uint64_t)iValue, 1); }
+	else if(iValue >= -32768) { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_INT16, (uint64_t)iValue, 2); }
+	else if(iValue >= -2147483647LL - 1) { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_INT32, (uint64_t)iValue, 4); }
+	else { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_INT64, (uint64_t)iValue, 8); }
+}
+static void cjsonMsgpackEncoder_Double(
+	struct cjsonMsgpackEncoder* lpEncoder,
+	double dValue
+) {
+	float fValue = (float)dValue;
+	uint32_t dwBits;
+	uint64_t qwBits;
+
+	if((double)fValue == dValue) {
+		memcpy(&dwBits, &fValue, sizeof(dwBits));
+		cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_FLOAT32, dwBits, 4);
+	} else {
+		memcpy(&qwBits, &dValue, sizeof(qwBits));
+		cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_FLOAT64, qwBits, 8);
+	}
+}
+static void cjsonMsgpackEncoder_String(
+	struct cjsonMsgpackEncoder* lpEncoder,
+	const char* lpData,
+	unsigned long int dwLength
+) {
+	if(dwLength < 32) { cjsonMsgpackEncoder_Put(lpEncoder, (uint8_t)(0xA0 | dwLength), 0, 0); }
+	else if(dwLength <= 0xFF) { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_STR8, dwLength, 1); }
+	else if(dwLength <= 0xFFFF) { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_STR16, dwLength, 2); }
+	else { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_STR32, dwLength, 4); }
+
+	if(dwLength <= CJSON_MSGPACK_BUFFERSIZE - lpEncoder->dwBufferUsed) {
+		memcpy(&(lpEncoder->bBuffer[lpEncoder->dwBufferUsed]), lpData, dwLength);
+		lpEncoder->dwBufferUsed = lpEncoder->dwBufferUsed + dwLength;
+	} else {
+		lpEncoder->lpPayload = lpData;
+		lpEncoder->dwPayloadLength = dwLength;
+		lpEncoder->dwPayloadWritten = 0;
+	}
+}
+
+static enum cjsonError cjsonMsgpackEncoder_Emit(
+	struct cjsonMsgpackEncoder* lpEncoder,
+	struct cjsonValue* lpValue
+) {
+	enum cjsonError e;
+	struct cjsonMsgpackEncoder_Frame* lpFrame;
+	unsigned long int dwCount;
+
+	if(lpValue == NULL) {
+		cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_NIL, 0, 0);
+		return cjsonE_Ok;
+	}
+
+	switch(lpValue->type) {
+		case cjsonNumber_UnsignedLong:	cjsonMsgpackEncoder_Unsigned(lpEncoder, (uint64_t)(((struct cjsonNumber*)lpValue)->value.ulong)); return cjsonE_Ok;
+		case cjsonNumber_SignedLong:	cjsonMsgpackEncoder_Signed(lpEncoder, (int64_t)(((struct cjsonNumber*)lpValue)->value.slong)); return cjsonE_Ok;
+		case cjsonNumber_Double:		cjsonMsgpackEncoder_Double(lpEncoder, ((struct cjsonNumber*)lpValue)->value.dbl); return cjsonE_Ok;
+		case cjsonTrue:					cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_TRUE, 0, 0); return cjsonE_Ok;
+		case cjsonFalse:				cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_FALSE, 0, 0); return cjsonE_Ok;
+		case cjsonNull:					cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_NIL, 0, 0); return cjsonE_Ok;
+		case cjsonString:
+			cjsonMsgpackEncoder_String(lpEncoder, ((struct cjsonString*)lpValue)->bData, ((struct cjsonString*)lpValue)->dwStrlen);
+			return cjsonE_Ok;
+		case cjsonArray:
+		case cjsonObject:
+			dwCount = (lpValue->type == cjsonArray) ? ((struct cjsonArray*)lpValue)->dwElementCount : ((struct cjsonObject*)lpValue)->dwElementCount;
+			if(dwCount > 0) {
+				e = cjsonMsgpack_GrowStack(lpEncoder->lpSystem, (void**)(&(lpEncoder->lpFrames)), lpEncoder->dwFrameCount, &(lpEncoder->dwFrameCapacity), sizeof(struct cjsonMsgpackEncoder_Frame));
+				if(e != cjsonE_Ok) { return e; }
+
+				lpFrame = &(lpEncoder->lpFrames[lpEncoder->dwFrameCount]);
+				lpFrame->lpContainer = lpValue;
+				lpFrame->lpPage = (lpValue->type == cjsonArray) ? ((struct cjsonArray*)lpValue)->pageList.lpFirstPage : NULL;
+				lpFrame->dwEntry = 0;
+				lpFrame->dwBucket = 0;
+				lpFrame->lpEntry = NULL;
+				lpFrame->bValuePending = 0;
+				lpEncoder->dwFrameCount = lpEncoder->dwFrameCount + 1;
+			}
+
+			if(lpValue->type == cjsonArray) {
+				if(dwCount < 16) { cjsonMsgpackEncoder_Put(lpEncoder, (uint8_t)(0x90 | dwCount), 0, 0); }
+				else if(dwCount <= 0xFFFF) { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_ARRAY16, dwCount, 2); }
+				else { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_ARRAY32, dwCount, 4); }
+			} else {
+				if(dwCount < 16) { cjsonMsgpackEncoder_Put(lpEncoder, (uint8_t)(0x80 | dwCount), 0, 0); }
+				else if(dwCount <= 0xFFFF) { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_MAP16, dwCount, 2); }
+				else { cjsonMsgpackEncoder_Put(lpEncoder, CJSON_MSGPACK_MAP32, dwCount, 4); }
+			}
+			return cjsonE_Ok;
+		default:
+			return cjsonE_ImplementationError;
+	}
+}
+
+/*
+	Emits the next item of the top container. Returns cjsonE_Finished
+	if the stack is empty.
+*/
+static enum cjsonError cjsonMsgpackEncoder_Next(
+	struct cjsonMsgpackEncoder* lpEncoder
+) {
+	struct cjsonMsgpackEncoder_Frame* lpFrame;
+	struct cjsonObject* lpObject;
+
+	while(lpEncoder->dwFrameCount > 0) {
+		lpFrame = &(lpEncoder->lpFrames[lpEncoder->dwFrameCount - 1]);
+
+		if(lpFrame->lpContainer->type == cjsonArray) {
+			while((lpFrame->lpPage != NULL) && (lpFrame->dwEntry >= lpFrame->lpPage->dwUsedEntries)) {
+				lpFrame->lpPage = lpFrame->lpPage->pageList.lpNext;
+				lpFrame->dwEntry = 0;
+			}
+			if(lpFrame->lpPage != NULL) {
+				lpFrame->dwEntry = lpFrame->dwEntry + 1;
+				return cjsonMsgpackEncoder_Emit(lpEncoder, lpFrame->lpPage->entries[lpFrame->dwEntry - 1]);
+			}
+		} else {
+			if(lpFrame->bValuePending != 0) {
+				lpFrame->bValuePending = 0;
+				return cjsonMsgpackEncoder_Emit(lpEncoder, lpFrame->lpEntry->lpValue);
+			}
+
+			lpObject = (struct cjsonObject*)(lpFrame->lpContainer);
+			if(lpFrame->lpEntry != NULL) { lpFrame->lpEntry = lpFrame->lpEntry->bucketList.lpNext; }
+			while((lpFrame->lpEntry == NULL) && (lpFrame->dwBucket < lpObject->dwBucketCount)) {
+				lpFrame->lpEntry = lpObject->buckets[lpFrame->dwBucket];
+				lpFrame->dwBucket = lpFrame->dwBucket + 1;
+			}
+			if(lpFrame->lpEntry != NULL) {
+				cjsonMsgpackEncoder_String(lpEncoder, lpFrame->lpEntry->bKey, lpFrame->lpEntry->dwKeyLength);
+				lpFrame->bValuePending = 1;
+				return cjsonE_Ok;
+			}
+		}
+
+		/* Container is done */
+		lpEncoder->dwFrameCount = lpEncoder->dwFrameCount - 1;
+	}
+	return cjsonE_Finished;
+}
+
+/*
+	Passes the buffer and a pending string payload to the callback
+*/
+static enum cjsonError cjsonMsgpackEncoder_Flush(
+	struct cjsonMsgpackEncoder* lpEncoder
+) {
+	enum cjsonError e;
+	unsigned long int dwBytesWritten;
+
+	while(lpEncoder->dwBufferWritten < lpEncoder->dwBufferUsed) {
+		dwBytesWritten = 0;
+		e = lpEncoder->callbackWriteBytes(&(lpEncoder->bBuffer[lpEncoder->dwBufferWritten]), lpEncoder->dwBufferUsed - lpEncoder->dwBufferWritten, &dwBytesWritten, lpEncoder->callbackWriteBytesParam);
+		lpEncoder->dwBufferWritten = lpEncoder->dwBufferWritten + dwBytesWritten;
+		if(e != cjsonE_Ok) { return e; }
+	}
+	lpEncoder->dwBufferUsed = 0;
+	lpEncoder->dwBufferWritten = 0;
+
+	if(lpEncoder->lpPayload != NULL) {
+		while(lpEncoder->dwPayloadWritten < lpEncoder->dwPayloadLength) {
+			dwBytesWritten = 0;
+			e = lpEncoder->callbackWriteBytes((char*)&(lpEncoder->lpPayload[lpEncoder->dwPayloadWritten]), lpEncoder->dwPayloadLength - lpEncoder->dwPayloadWritten, &dwBytesWritten, lpEncoder->callbackWriteBytesParam);
+			lpEncoder->dwPayloadWritten = lpEncoder->dwPayloadWritten + dwBytesWritten;
+			if(e != cjsonE_Ok) { return e; }
+		}
+		lpEncoder->lpPayload = NULL;
+	}
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonMsgpackEncoder_Create(
+	struct cjsonMsgpackEncoder** lpOut,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam,
+	uint32_t dwFlags,
+	struct cjsonSystemAPI* lpSystem
+) {
+	enum cjsonError e;
+	struct cjsonMsgpackEncoder* lpNew;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+
+	if(callback == NULL) { return cjsonE_InvalidParam; }
+	if(dwFlags != 0) { return cjsonE_InvalidParam; }
+
+	e = cjsonMsgpack_Alloc(lpSystem, sizeof(struct cjsonMsgpackEncoder), (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpNew->lpFrames					= NULL;
+	lpNew->dwFrameCount				= 0;
+	lpNew->dwFrameCapacity			= 0;
+	lpNew->dwBufferUsed				= 0;
+	lpNew->dwBufferWritten			= 0;
+	lpNew->lpPayload				= NULL;
+	lpNew->dwPayloadLength			= 0;
+	lpNew->dwPayloadWritten			= 0;
+	lpNew->dwFlags					= dwFlags;
+	lpNew->lpSystem					= lpSystem;
+	lpNew->callbackWriteBytes		= callback;
+	lpNew->callbackWriteBytesParam	= callbackFreeParam;
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonMsgpackEncoder_Encode(
+	struct cjsonMsgpackEncoder* lpEncoder,
+	struct cjsonValue* lpValue
+) {
+	enum cjsonError e;
+
+	if(lpEncoder == NULL) { return cjsonE_InvalidParam; }
+	if(lpValue == NULL) { return cjsonE_InvalidParam; }
+
+	/* The previous message has to be finished */
+	if((lpEncoder->dwFrameCount != 0) || (lpEncoder->dwBufferUsed != 0) || (lpEncoder->lpPayload != NULL)) { return cjsonE_InvalidState; }
+
+	e = cjsonMsgpackEncoder_Emit(lpEncoder, lpValue);
+	if(e != cjsonE_Ok) { return e; }
+	return cjsonMsgpackEncoder_Continue(lpEncoder);
+}
+enum cjsonError cjsonMsgpackEncoder_Continue(
+	struct cjsonMsgpackEncoder* lpEncoder
+) {
+	enum cjsonError e;
+
+	if(lpEncoder == NULL) { return cjsonE_InvalidParam; }
+
+	for(;;) {
+		if((lpEncoder->lpPayload != NULL) || (CJSON_MSGPACK_BUFFERSIZE - lpEncoder->dwBufferUsed < CJSON_MSGPACK_MAXHEADER)) {
+			e = cjsonMsgpackEncoder_Flush(lpEncoder);
+			if(e != cjsonE_Ok) { return e; }
+		}
+
+		e = cjsonMsgpackEncoder_Next(lpEncoder);
+		if(e == cjsonE_Finished) { return cjsonMsgpackEncoder_Flush(lpEncoder); }
+		if(e != cjsonE_Ok) { return e; }
+	}
+}
+enum cjsonError cjsonMsgpackEncoder_Release(
+	struct cjsonMsgpackEncoder* lpEncoder
+) {
+	if(lpEncoder == NULL) { return cjsonE_InvalidParam; }
+
+	if(lpEncoder->lpFrames != NULL) { cjsonMsgpack_Free(lpEncoder->lpSystem, (void*)(lpEncoder->lpFrames)); }
+	cjsonMsgpack_Free(lpEncoder->lpSystem, (void*)lpEncoder);
+	return cjsonE_Ok;
+}
+
+/*
+	Decoder
+*/
+static enum cjsonError cjsonMsgpackDecoder_Complete(
+	struct cjsonMsgpackDecoder* lpDecoder,
+	struct cjsonValue* lpValue
+) {
+	enum cjsonError e;
+	struct cjsonMsgpackDecoder_Frame* lpFrame;
+
+	for(;;) {
+		if(lpDecoder->dwFrameCount == 0) {
+			if((lpDecoder->dwFlags & CJSON_MSGPACK_FLAG__STREAMINGMODE) == 0) {
+				lpDecoder->dwFlags = lpDecoder->dwFlags | CJSON_MSGPACK_FLAG__INTERNAL_DONE;
+			}
+			return lpDecoder->callbackDocumentReady(lpValue, lpDecoder->callbackDocumentReadyFreeParam);
+		}
+
+		lpFrame = &(lpDecoder->lpFrames[lpDecoder->dwFrameCount - 1]);
+		if(lpFrame->lpContainer->type == cjsonArray) {
+			e = cjsonArray_Push(lpFrame->lpContainer, lpValue);
+			if(e != cjsonE_Ok) { cjsonReleaseValue(lpValue); return e; }
+		} else {
+			if(lpFrame->lpKey == NULL) {
+				/* Key type has been checked when its format byte was read */
+				lpFrame->lpKey = lpValue;
+				return cjsonE_Ok;
+			}
+			e = cjsonObject_Set(lpFrame->lpContainer, ((struct cjsonString*)(lpFrame->lpKey))->bData, ((struct cjsonString*)(lpFrame->lpKey))->dwStrlen, lpValue);
+			cjsonReleaseValue(lpFrame->lpKey);
+			lpFrame->lpKey = NULL;
+			if(e != cjsonE_Ok) { cjsonReleaseValue(lpValue); return e; }
+		}
+
+		lpFrame->dwRemaining = lpFrame->dwRemaining - 1;
+		if(lpFrame->dwRemaining > 0) { return cjsonE_Ok; }
+
+		lpValue = lpFrame->lpContainer;
+		lpDecoder->dwFrameCount = lpDecoder->dwFrameCount - 1;
+	}
+}
+
+static enum cjsonError cjsonMsgpackDecoder_Number(
+	struct cjsonMsgpackDecoder* lpDecoder,
+	int bSigned,
+	unsigned long int dwBits,
+	uint64_t qwValue
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpValue;
+	int64_t iValue;
+
+	e = cjsonNumber_Create(&lpValue, lpDecoder->lpSystem);
+	if(e != cjsonE_Ok) { return e; }
+
+	if(bSigned == 0) {
+		if(qwValue <= (uint64_t)ULONG_MAX) {
+			cjsonNumber_SetULong(lpValue, (unsigned long int)qwValue);
+		} else {
+			cjsonNumber_SetDouble(lpValue, (double)qwValue);
+		}
+	} else {
+		/* Sign extension of the transmitted width */
+		if((dwBits < 64) && ((qwValue & (1ULL << (dwBits - 1))) != 0)) {
+			qwValue = qwValue | ~((1ULL << dwBits) - 1);
+		}
+		iValue = (int64_t)qwValue;
+		if((iValue >= (int64_t)LONG_MIN) && (iValue <= (int64_t)LONG_MAX)) {
+			cjsonNumber_SetSLong(lpValue, (signed long int)iValue);
+		} else {
+			cjsonNumber_SetDouble(lpValue, (double)iValue);
+		}
+	}
+	return cjsonMsgpackDecoder_Complete(lpDecoder, lpValue);
+}
+static enum cjsonError cjsonMsgpackDecoder_Container(
+	struct cjsonMsgpackDecoder* lpDecoder,
+	int bMap,
+	uint64_t qwCount
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpValue;
+	struct cjsonMsgpackDecoder_Frame* lpFrame;
+	unsigned long int dwSizeHint;
+
+	/* Announced sizes are untrusted input, they are only used as a bounded hint */
+	dwSizeHint = (qwCount > CJSON_MSGPACK_MAXSIZEHINT) ? CJSON_MSGPACK_MAXSIZEHINT : (unsigned long int)qwCount;
+	if(bMap == 0) {
+		e = cjsonArray_CreateSized(&lpValue, dwSizeHint, lpDecoder->lpSystem);
+	} else {
+		e = cjsonObject_CreateSized(&lpValue, (dwSizeHint == 0) ? CJSON_BLOCKSIZE_OBJECT : dwSizeHint, lpDecoder->lpSystem);
+	}
+	if(e != cjsonE_Ok) { return e; }
+
+	if(qwCount == 0) { return cjsonMsgpackDecoder_Complete(lpDecoder, lpValue); }
+
+	e = cjsonMsgpack_GrowStack(lpDecoder->lpSystem, (void**)(&(lpDecoder->lpFrames)), lpDecoder->dwFrameCount, &(lpDecoder->dwFrameCapacity), sizeof(struct cjsonMsgpackDecoder_Frame));
+	if(e != cjsonE_Ok) { cjsonReleaseValue(lpValue); return e; }
+
+	lpFrame = &(lpDecoder->lpFrames[lpDecoder->dwFrameCount]);
+	lpFrame->lpContainer = lpValue;
+	lpFrame->lpKey = NULL;
+	lpFrame->dwRemaining = (unsigned long int)qwCount;
+	lpDecoder->dwFrameCount = lpDecoder->dwFrameCount + 1;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonMsgpackDecoder_String(
+	struct cjsonMsgpackDecoder* lpDecoder,
+	uint64_t qwLength
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpValue;
+
+	/* The string is allocated before its payload arrives */
+	if(qwLength > (uint64_t)CJSON_MSGPACK_MAXSTRLENGTH) { return cjsonE_EncodingError; }
+
+	/* The string is filled in place */
+	e = cjsonString_Create(&lpValue, NULL, (unsigned long int)qwLength, lpDecoder->lpSystem);
+	if(e != cjsonE_Ok) { return e; }
+	if(qwLength == 0) { return cjsonMsgpackDecoder_Complete(lpDecoder, lpValue); }
+
+	lpDecoder->lpString = lpValue;
+	lpDecoder->dwPayloadUsed = 0;
+	lpDecoder->state = cjsonMsgpackDecoder_State__Payload;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonMsgpackDecoder_PayloadDone(
+	struct cjsonMsgpackDecoder* lpDecoder
+) {
+	struct cjsonValue* lpValue = lpDecoder->lpString;
+
+	lpDecoder->lpString = NULL;
+	lpDecoder->state = cjsonMsgpackDecoder_State__Header;
+	return cjsonMsgpackDecoder_Complete(lpDecoder, lpValue);
+}
+
+/*
+	Processes a format byte with its (complete) argument
+*/
+static enum cjsonError cjsonMsgpackDecoder_Item(
+	struct cjsonMsgpackDecoder* lpDecoder
+) {
+	enum cjsonError e;
+	uint8_t bFormat = lpDecoder->bFormat;
+	uint64_t qwArgument = lpDecoder->qwArgument;
+	struct cjsonValue* lpValue;
+	uint32_t dwSingle;
+	float fValue;
+	double dValue;
+
+	lpDecoder->state = cjsonMsgpackDecoder_State__Header;
+
+	if(bFormat < 0x80) { return cjsonMsgpackDecoder_Number(lpDecoder, 0, 8, bFormat); }
+	if(bFormat >= 0xE0) { return cjsonMsgpackDecoder_Number(lpDecoder, 1, 8, bFormat); }
+	if(bFormat < 0x90) { return cjsonMsgpackDecoder_Container(lpDecoder, 1, bFormat & 0x0F); }
+	if(bFormat < 0xA0) { return cjsonMsgpackDecoder_Container(lpDecoder, 0, bFormat & 0x0F); }
+	if(bFormat < 0xC0) { return cjsonMsgpackDecoder_String(lpDecoder, bFormat & 0x1F); }
+
+	switch(bFormat) {
+		case CJSON_MSGPACK_NIL:		e = cjsonNull_Create(&lpValue, lpDecoder->lpSystem); break;
+		case CJSON_MSGPACK_FALSE:	e = cjsonFalse_Create(&lpValue, lpDecoder->lpSystem); break;
+		case CJSON_MSGPACK_TRUE:	e = cjsonTrue_Create(&lpValue, lpDecoder->lpSystem); break;
+		case CJSON_MSGPACK_FLOAT32:
+		case CJSON_MSGPACK_FLOAT64:
+			if(bFormat == CJSON_MSGPACK_FLOAT32) {
+				dwSingle = (uint32_t)qwArgument;
+				memcpy(&fValue, &dwSingle, sizeof(fValue));
+				dValue = (double)fValue;
+			} else {
+				memcpy(&dValue, &qwArgument, sizeof(dValue));
+			}
+			e = cjsonNumber_Create(&lpValue, lpDecoder->lpSystem);
+			if(e != cjsonE_Ok) { return e; }
+			cjsonNumber_SetDouble(lpValue, dValue);
+			break;
+
+		case CJSON_MSGPACK_UINT8:	return cjsonMsgpackDecoder_Number(lpDecoder, 0, 8, qwArgument);
+		case CJSON_MSGPACK_UINT16:	return cjsonMsgpackDecoder_Number(lpDecoder, 0, 16, qwArgument);
+		case CJSON_MSGPACK_UINT32:	return cjsonMsgpackDecoder_Number(lpDecoder, 0, 32, qwArgument);
+		case CJSON_MSGPACK_UINT64:	return cjsonMsgpackDecoder_Number(lpDecoder, 0, 64, qwArgument);
+		case CJSON_MSGPACK_INT8:	return cjsonMsgpackDecoder_Number(lpDecoder, 1, 8, qwArgument);
+		case CJSON_MSGPACK_INT16:	return cjsonMsgpackDecoder_Number(lpDecoder, 1, 16, qwArgument);
+		case CJSON_MSGPACK_INT32:	return cjsonMsgpackDecoder_Number(lpDecoder, 1, 32, qwArgument);
+		case CJSON_MSGPACK_INT64:	return cjsonMsgpackDecoder_Number(lpDecoder, 1, 64, qwArgument);
+
+		case CJSON_MSGPACK_STR8:
+		case CJSON_MSGPACK_STR16:
+		case CJSON_MSGPACK_STR32:	return cjsonMsgpackDecoder_String(lpDecoder, qwArgument);
+
+		case CJSON_MSGPACK_ARRAY16:
+		case CJSON_MSGPACK_ARRAY32:	return cjsonMsgpackDecoder_Container(lpDecoder, 0, qwArgument);
+		case CJSON_MSGPACK_MAP16:
+		case CJSON_MSGPACK_MAP32:	return cjsonMsgpackDecoder_Container(lpDecoder, 1, qwArgument);
+
+		default:
+			/* Binary, extension types and the unused 0xC1 */
+			return cjsonE_EncodingError;
+	}
+	if(e != cjsonE_Ok) { return e; }
+	return cjsonMsgpackDecoder_Complete(lpDecoder, lpValue);
+}
+
+/*
+	Number of argument bytes following a format byte
+*/
+static unsigned long int cjsonMsgpackDecoder_ArgumentBytes(
+	uint8_t bFormat
+) {
+	switch(bFormat) {
+		case CJSON_MSGPACK_UINT8:
+		case CJSON_MSGPACK_INT8:
+		case CJSON_MSGPACK_STR8:	return 1;
+		case CJSON_MSGPACK_UINT16:
+		case CJSON_MSGPACK_INT16:
+		case CJSON_MSGPACK_STR16:
+		case CJSON_MSGPACK_ARRAY16:
+		case CJSON_MSGPACK_MAP16:	return 2;
+		case CJSON_MSGPACK_FLOAT32:
+		case CJSON_MSGPACK_UINT32:
+		case CJSON_MSGPACK_INT32:
+		case CJSON_MSGPACK_STR32:
+		case CJSON_MSGPACK_ARRAY32:
+		case CJSON_MSGPACK_MAP32:	return 4;
+		case CJSON_MSGPACK_FLOAT64:
+		case CJSON_MSGPACK_UINT64:
+		case CJSON_MSGPACK_INT64:	return 8;
+		default:					return 0;
+	}
+}
+static enum cjsonError cjsonMsgpackDecoder_Format(
+	struct cjsonMsgpackDecoder* lpDecoder,
+	uint8_t bFormat
+) {
+	struct cjsonMsgpackDecoder_Frame* lpFrame;
+
+	if((lpDecoder->dwFlags & CJSON_MSGPACK_FLAG__INTERNAL_DONE) != 0) { return cjsonE_AlreadyFinished; }
+
+	/* Map keys have to be strings */
+	if(lpDecoder->dwFrameCount > 0) {
+		lpFrame = &(lpDecoder->lpFrames[lpDecoder->dwFrameCount - 1]);
+		if((lpFrame->lpContainer->type == cjsonObject) && (lpFrame->lpKey == NULL)) {
+			if(((bFormat < 0xA0) || (bFormat > 0xBF)) && (bFormat != CJSON_MSGPACK_STR8) && (bFormat != CJSON_MSGPACK_STR16) && (bFormat != CJSON_MSGPACK_STR32)) {
+				return cjsonE_EncodingError;
+			}
+		}
+	}
+
+	lpDecoder->bFormat = bFormat;
+	lpDecoder->qwArgument = 0;
+	lpDecoder->dwArgumentBytes = ((bFormat >= 0xC0) && (bFormat < 0xE0)) ? cjsonMsgpackDecoder_ArgumentBytes(bFormat) : 0;
+	if(lpDecoder->dwArgumentBytes == 0) { return cjsonMsgpackDecoder_Item(lpDecoder); }
+
+	lpDecoder->state = cjsonMsgpackDecoder_State__Argument;
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonMsgpackDecoder_Create(
+	struct cjsonMsgpackDecoder** lpOut,
+	uint32_t dwFlags,
+	lpfnCJSONCallback_DocumentReady callbackDocumentReady,
+	void* callbackDocumentReadyFreeParam,
+	struct cjsonSystemAPI* lpSystem
+) {
+	enum cjsonError e;
+	struct cjsonMsgpackDecoder* lpNew;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+
+	if((dwFlags & ~(CJSON_MSGPACK_FLAG__STREAMINGMODE)) != 0) { return cjsonE_InvalidParam; }
+	if(callbackDocumentReady == NULL) { return cjsonE_InvalidParam; }
+
+	e = cjsonMsgpack_Alloc(lpSystem, sizeof(struct cjsonMsgpackDecoder), (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpNew->lpFrames							= NULL;
+	lpNew->dwFrameCount						= 0;
+	lpNew->dwFrameCapacity					= 0;
+	lpNew->state							= cjsonMsgpackDecoder_State__Header;
+	lpNew->bFormat							= 0;
+	lpNew->dwArgumentBytes					= 0;
+	lpNew->qwArgument						= 0;
+	lpNew->lpString							= NULL;
+	lpNew->dwPayloadUsed					= 0;
+	lpNew->dwFlags							= dwFlags;
+	lpNew->lpSystem							= lpSystem;
+	lpNew->callbackDocumentReady			= callbackDocumentReady;
+	lpNew->callbackDocumentReadyFreeParam	= callbackDocumentReadyFreeParam;
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonMsgpackDecoder_ProcessByte(
+	struct cjsonMsgpackDecoder* lpDecoder,
+	char bByte
+) {
+	struct cjsonString* lpString;
+
+	if(lpDecoder == NULL) { return cjsonE_InvalidParam; }
+
+	switch(lpDecoder->state) {
+		case cjsonMsgpackDecoder_State__Header:
+			return cjsonMsgpackDecoder_Format(lpDecoder, (uint8_t)bByte);
+		case cjsonMsgpackDecoder_State__Argument:
+			lpDecoder->qwArgument = (lpDecoder->qwArgument << 8) | (uint64_t)((uint8_t)bByte);
+			lpDecoder->dwArgumentBytes = lpDecoder->dwArgumentBytes - 1;
+			if(lpDecoder->dwArgumentBytes == 0) { return cjsonMsgpackDecoder_Item(lpDecoder); }
+			return cjsonE_Ok;
+		case cjsonMsgpackDecoder_State__Payload:
+			lpString = (struct cjsonString*)(lpDecoder->lpString);
+			lpString->bData[lpDecoder->dwPayloadUsed] = bByte;
+			lpDecoder->dwPayloadUsed = lpDecoder->dwPayloadUsed + 1;
+			if(lpDecoder->dwPayloadUsed == lpString->dwStrlen) { return cjsonMsgpackDecoder_PayloadDone(lpDecoder); }
+			return cjsonE_Ok;
+		default:
+			return cjsonE_ImplementationError;
+	}
+}
+enum cjsonError cjsonMsgpackDecoder_ProcessBytes(
+	struct cjsonMsgpackDecoder* lpDecoder,
+	const char* lpData,
+	unsigned long int dwDataLength
+) {
+	enum cjsonError e;
+	unsigned long int dwPos = 0;
+	unsigned long int dwChunk;
+	struct cjsonString* lpString;
+
+	if(lpDecoder == NULL) { return cjsonE_InvalidParam; }
+	if((lpData == NULL) && (dwDataLength > 0)) { return cjsonE_InvalidParam; }
+
+	while(dwPos < dwDataLength) {
+		if(lpDecoder->state == cjsonMsgpackDecoder_State__Payload) {
+			/* String payloads are copied as a whole */
+			lpString = (struct cjsonString*)(lpDecoder->lpString);
+			dwChunk = lpString->dwStrlen - lpDecoder->dwPayloadUsed;
+			if(dwChunk > dwDataLength - dwPos) { dwChunk = dwDataLength - dwPos; }
+			memcpy(&(lpString->bData[lpDecoder->dwPayloadUsed]), &(lpData[dwPos]), dwChunk);
+			lpDecoder->dwPayloadUsed = lpDecoder->dwPayloadUsed + dwChunk;
+			dwPos = dwPos + dwChunk;
+			if(lpDecoder->dwPayloadUsed == lpString->dwStrlen) {
+				e = cjsonMsgpackDecoder_PayloadDone(lpDecoder);
+				if(e != cjsonE_Ok) { return e; }
+			}
+		} else {
+			e = cjsonMsgpackDecoder_ProcessByte(lpDecoder, lpData[dwPos]);
+			if(e != cjsonE_Ok) { return e; }
+			dwPos = dwPos + 1;
+		}
+	}
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonMsgpackDecoder_Release(
+	struct cjsonMsgpackDecoder* lpDecoder
+) {
+	unsigned long int i;
+
+	if(lpDecoder == NULL) { return cjsonE_Ok; }
+
+	if(lpDecoder->lpString != NULL) { cjsonReleaseValue(lpDecoder->lpString); }
+	for(i = 0; i < lpDecoder->dwFrameCount; i=i+1) {
+		cjsonReleaseValue(lpDecoder->lpFrames[i].lpContainer);
+		if(lpDecoder->lpFrames[i].lpKey != NULL) { cjsonReleaseValue(lpDecoder->lpFrames[i].lpKey); }
+	}
+	if(lpDecoder->lpFrames != NULL) { cjsonMsgpack_Free(lpDecoder->lpSystem, (void*)(lpDecoder->lpFrames)); }
+	cjsonMsgpack_Free(lpDecoder->lpSystem, (void*)lpDecoder);
+	return cjsonE_Ok;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
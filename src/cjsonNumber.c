@@ -24,6 +24,7 @@ enum cjsonError cjsonNumber_Create(
 
 	lpNew->base.type = cjsonNumber_UnsignedLong;
 	lpNew->base.lpSystem = lpSystem;
+	lpNew->base.dwRefCount = 1;
 	lpNew->value.ulong = 0;
 	(*lpOut) = (struct cjsonValue*)lpNew;
 	return cjsonE_Ok;
@@ -5,6 +5,9 @@
 #ifndef CJSON_BLOCKSIZE_OBJECT
 	#define CJSON_BLOCKSIZE_OBJECT 64
 #endif
+#ifndef CJSON_OBJECT_BATCHSCANFACTOR
+	#define CJSON_OBJECT_BATCHSCANFACTOR 4			/* Batch lookups walk all entries if there are at most this many per requested key */
+#endif
 
 #ifdef __cplusplus
 	extern "C" {
@@ -12,70 +15,81 @@
 
 const unsigned long int cjsonObject_BlockSize = CJSON_BLOCKSIZE_OBJECT;
 
-enum cjsonError cjsonObject_Create(
+enum cjsonError cjsonObject_CreateSized(
 	struct cjsonValue** lpOut,
+	unsigned long int dwExpectedElements,
 	struct cjsonSystemAPI* lpSystem
 ) {
 	enum cjsonError e;
 	struct cjsonObject* lpNew;
-	unsigned long int dwIndexBitCount;
-	unsigned long int dwIndexTest;
+	unsigned long int dwBucketCount;
 	unsigned long int i;
 
 	if(lpOut == NULL) { return cjsonE_InvalidParam; }
 	(*lpOut) = NULL;
 
+	/* Use the next power of two so we get at most one element per bucket on average */
+	dwBucketCount = 1;
+	while(dwBucketCount < dwExpectedElements) { dwBucketCount = dwBucketCount << 1; }
+
 	if(lpSystem == NULL) {
-		lpNew = (struct cjsonObject*)malloc(sizeof(struct cjsonObject)+sizeof(struct cjsonObject_BucketEntry)*CJSON_BLOCKSIZE_OBJECT);
+		lpNew = (struct cjsonObject*)malloc(sizeof(struct cjsonObject)+sizeof(struct cjsonObject_BucketEntry*)*dwBucketCount);
 		if(lpNew == NULL) { return cjsonE_OutOfMemory; }
 	} else {
-		e = lpSystem->alloc(lpSystem, sizeof(struct cjsonObject)+sizeof(struct cjsonObject_BucketEntry)*CJSON_BLOCKSIZE_OBJECT, (void**)(&lpNew));
+		e = cjsonSystemAPI_AllocAt(lpSystem, cjsonAllocSite__ObjectCreate, sizeof(struct cjsonObject)+sizeof(struct cjsonObject_BucketEntry*)*dwBucketCount, (void**)(&lpNew));
 		if(e != cjsonE_Ok) { return e; }
 	}
 
 	lpNew->base.type 		= cjsonObject;
 	lpNew->base.lpSystem 	= lpSystem;
-	lpNew->dwBucketCount 	= CJSON_BLOCKSIZE_OBJECT;
+	lpNew->base.dwRefCount 	= 1;
+	lpNew->dwBucketCount 	= dwBucketCount;
 	lpNew->dwElementCount	= 0;
 
-	dwIndexTest = 1;
-	dwIndexBitCount = 0;
-	while(dwIndexTest < CJSON_BLOCKSIZE_OBJECT) {
-		dwIndexTest = dwIndexTest << 1;
-		dwIndexBitCount = dwIndexBitCount + 1;
-	}
-
-	lpNew->dwBucketShiftBytes = (dwIndexBitCount / 8) + ((dwIndexBitCount % 8 == 0) ? 0 : 1);
-
-	for(i = 0; i < CJSON_BLOCKSIZE_OBJECT; i=i+1) { lpNew->buckets[i] = NULL; }
+	for(i = 0; i < dwBucketCount; i=i+1) { lpNew->buckets[i] = NULL; }
 
 	(*lpOut) = (struct cjsonValue*)lpNew;
 	return cjsonE_Ok;
 }
+enum cjsonError cjsonObject_Create(
+	struct cjsonValue** lpOut,
+	struct cjsonSystemAPI* lpSystem
+) {
+	return cjsonObject_CreateSized(lpOut, CJSON_BLOCKSIZE_OBJECT, lpSystem);
+}
 
-static unsigned long int getHashIndex(
-	const struct cjsonObject* lpObj,
+uint32_t cjsonObject_HashKey(
 	const char* lpKey,
-	unsigned long int dwKeyLen
+	unsigned long int dwKeyLength
 ) {
-	unsigned long int dwKeyIndex;
-	unsigned long int dwShiftReg = 0;
-	unsigned long int dwResult = 0;
-	unsigned long int cnt = 0;
-
-	for(dwKeyIndex = 0; dwKeyIndex < dwKeyLen; dwKeyIndex = dwKeyIndex + 1) {
-		dwShiftReg = (dwShiftReg << 8) | ((unsigned long int)(lpKey[dwKeyIndex]));
-		if((cnt = cnt + 1) >= lpObj->dwBucketShiftBytes) {
-			dwResult = dwResult ^ dwShiftReg;
-			dwShiftReg = 0;
-			cnt = 0;
-		}
-	}
-	if(cnt > 0) {
-		dwResult = dwResult ^ dwShiftReg;
+	uint32_t dwHash = CJSON_OBJECT_HASH_INIT;
+	unsigned long int i;
+
+	for(i = 0; i < dwKeyLength; i=i+1) {
+		dwHash = CJSON_OBJECT_HASH_STEP(dwHash, lpKey[i]);
 	}
+	return dwHash;
+}
 
-	return dwResult % lpObj->dwBucketCount;
+/*
+	The bucket count is a power of two, the upper half of the
+	hash is folded in since small objects only use the low bits
+*/
+static inline unsigned long int getHashIndex(
+	const struct cjsonObject* lpObj,
+	uint32_t dwKeyHash
+) {
+	return (unsigned long int)(dwKeyHash ^ (dwKeyHash >> 16)) & (lpObj->dwBucketCount - 1);
+}
+static inline int entryMatches(
+	const struct cjsonObject_BucketEntry* lpEntry,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	uint32_t dwKeyHash
+) {
+	if(lpEntry->dwKeyHash != dwKeyHash) { return 0; }
+	if(lpEntry->dwKeyLength != dwKeyLength) { return 0; }
+	return (memcmp(lpEntry->bKey, lpKey, dwKeyLength) == 0) ? 1 : 0;
 }
 
 enum cjsonError cjsonObject_Set(
@@ -83,6 +97,15 @@ enum cjsonError cjsonObject_Set(
 	const char* lpKey,
 	unsigned long int dwKeyLength,
 	struct cjsonValue* lpValue
+) {
+	return cjsonObject_SetPrehashed(lpObject, lpKey, dwKeyLength, cjsonObject_HashKey(lpKey, dwKeyLength), lpValue);
+}
+enum cjsonError cjsonObject_SetPrehashed(
+	struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	uint32_t dwKeyHash,
+	struct cjsonValue* lpValue
 ) {
 	enum cjsonError e;
 	unsigned long int idx;
@@ -101,19 +124,20 @@ enum cjsonError cjsonObject_Set(
 			lpNewEnt = (struct cjsonObject_BucketEntry*)malloc(sizeof(struct cjsonObject_BucketEntry)+dwKeyLength);
 			if(lpNewEnt == NULL) { return cjsonE_OutOfMemory; }
 		} else {
-			e = lpObj->base.lpSystem->alloc(lpObj->base.lpSystem, sizeof(struct cjsonObject_BucketEntry)+dwKeyLength, (void**)(&lpNewEnt));
+			e = cjsonSystemAPI_AllocAt(lpObj->base.lpSystem, cjsonAllocSite__ObjectSet, sizeof(struct cjsonObject_BucketEntry)+dwKeyLength, (void**)(&lpNewEnt));
 			if(e != cjsonE_Ok) { return e; }
 		}
 		lpNewEnt->bucketList.lpNext = NULL;
 		lpNewEnt->bucketList.lpPrev = NULL;
 		lpNewEnt->lpValue = lpValue;
+		lpNewEnt->dwKeyHash = dwKeyHash;
 		lpNewEnt->dwKeyLength = dwKeyLength;
 		memcpy(lpNewEnt->bKey, lpKey, dwKeyLength);
 	} else {
 		lpNewEnt = NULL;
 	}
 
-	idx = getHashIndex(lpObj, lpKey, dwKeyLength);
+	idx = getHashIndex(lpObj, dwKeyHash);
 
 	if(lpObj->buckets[idx] == NULL) {
 		if(lpNewEnt == NULL) { return cjsonE_Ok; }
@@ -127,45 +151,43 @@ enum cjsonError cjsonObject_Set(
 		lpCurPrev = NULL;
 		lpCur = lpObj->buckets[idx];
 		while(lpCur != NULL) {
-			if(lpCur->dwKeyLength == lpNewEnt->dwKeyLength) {
-				if(memcmp(lpCur->bKey, lpNewEnt->bKey, lpCur->dwKeyLength) == 0) {
-					/* Matching key already exists ... overwrite or release */
-					if(lpNewEnt == NULL) {
-						/* Release the entry without replacing it ... */
-						cjsonReleaseValue(lpCur->lpValue);
-
-						/* Unlink descriptor from bucket list */
-						if(lpCur->bucketList.lpPrev == NULL) {
-							lpObj->buckets[idx] = lpCur->bucketList.lpNext;
-						} else {
-							lpCur->bucketList.lpPrev->bucketList.lpNext = lpCur->bucketList.lpNext;
-						}
-						if(lpCur->bucketList.lpNext != NULL) {
-							lpCur->bucketList.lpNext->bucketList.lpPrev = lpCur->bucketList.lpPrev;
-						}
-
-						if(lpObj->base.lpSystem == NULL) {
-							free((void*)lpCur);
-						} else {
-							lpObj->base.lpSystem->free(lpObj->base.lpSystem, (void*)lpCur);
-						}
-
-						lpObj->dwElementCount = lpObj->dwElementCount - 1;
-						return cjsonE_Ok;
+			if(entryMatches(lpCur, lpKey, dwKeyLength, dwKeyHash) != 0) {
+				/* Matching key already exists ... overwrite or release */
+				if(lpNewEnt == NULL) {
+					/* Release the entry without replacing it ... */
+					cjsonReleaseValue(lpCur->lpValue);
+
+					/* Unlink descriptor from bucket list */
+					if(lpCur->bucketList.lpPrev == NULL) {
+						lpObj->buckets[idx] = lpCur->bucketList.lpNext;
+					} else {
+						lpCur->bucketList.lpPrev->bucketList.lpNext = lpCur->bucketList.lpNext;
+					}
+					if(lpCur->bucketList.lpNext != NULL) {
+						lpCur->bucketList.lpNext->bucketList.lpPrev = lpCur->bucketList.lpPrev;
+					}
+
+					if(lpObj->base.lpSystem == NULL) {
+						free((void*)lpCur);
+					} else {
+						lpObj->base.lpSystem->free(lpObj->base.lpSystem, (void*)lpCur);
+					}
+
+					lpObj->dwElementCount = lpObj->dwElementCount - 1;
+					return cjsonE_Ok;
+				} else {
+					/* Overwrite the entry after releasing the old one */
+					cjsonReleaseValue(lpCur->lpValue);
+					lpCur->lpValue = lpValue;
+
+					/* We don't need the new descriptor, we keep the old one ... */
+					if(lpObj->base.lpSystem == NULL) {
+						free((void*)lpNewEnt);
 					} else {
-						/* Overwrite the entry after releasing the old one */
-						cjsonReleaseValue(lpCur->lpValue);
-						lpCur->lpValue = lpValue;
-
-						/* We don't need the new descriptor, we keep the old one ... */
-						if(lpObj->base.lpSystem == NULL) {
-							free((void*)lpNewEnt);
-						} else {
-							lpObj->base.lpSystem->free(lpObj->base.lpSystem, (void*)lpNewEnt);
-						}
-
-						return cjsonE_Ok;
+						lpObj->base.lpSystem->free(lpObj->base.lpSystem, (void*)lpNewEnt);
 					}
+
+					return cjsonE_Ok;
 				}
 			}
 			lpCurPrev = lpCur;
@@ -173,72 +195,296 @@ enum cjsonError cjsonObject_Set(
 		}
 
 		/* No matching entry exists, append ourself to the list */
+		if(lpNewEnt == NULL) { return cjsonE_Ok; }
 		lpNewEnt->bucketList.lpPrev = lpCurPrev;
 		lpCurPrev->bucketList.lpNext = lpNewEnt;
 		lpObj->dwElementCount = lpObj->dwElementCount + 1;
 		return cjsonE_Ok;
 	}
 }
-enum cjsonError cjsonObject_Get(
-	const struct cjsonValue* lpObject,
+enum cjsonError cjsonObject_Remove(
+	struct cjsonValue* lpObject,
 	const char* lpKey,
 	unsigned long int dwKeyLength,
 	struct cjsonValue** lpValueOut
 ) {
 	unsigned long int idx;
-	const struct cjsonObject_BucketEntry* lpCur;
+	uint32_t dwKeyHash;
+	struct cjsonObject_BucketEntry* lpCur;
 
-	const struct cjsonObject* lpObj = (const struct cjsonObject*)lpObject;
+	struct cjsonObject* lpObj = (struct cjsonObject*)lpObject;
 
-	if(lpValueOut == NULL) { return cjsonE_InvalidParam; }
-	(*lpValueOut) = NULL;
+	if(lpValueOut != NULL) { (*lpValueOut) = NULL; }
 
-	/* Determine hashtable index */
-	idx = getHashIndex(lpObj, lpKey, dwKeyLength);
+	if(lpObject == NULL) { return cjsonE_InvalidParam; }
+	if(lpObject->type != cjsonObject) { return cjsonE_InvalidParam; }
 
-	if(lpObj->buckets[idx] == NULL) { return cjsonE_IndexOutOfBounds; }
+	dwKeyHash = cjsonObject_HashKey(lpKey, dwKeyLength);
+	idx = getHashIndex(lpObj, dwKeyHash);
 
 	lpCur = lpObj->buckets[idx];
 	while(lpCur != NULL) {
-		if(lpCur->dwKeyLength == dwKeyLength) {
-			if(memcmp(lpCur->bKey, lpKey, dwKeyLength) == 0) {
-				/* Matching key */
+		if(entryMatches(lpCur, lpKey, dwKeyLength, dwKeyHash) != 0) {
+			/* Unlink descriptor from bucket list */
+			if(lpCur->bucketList.lpPrev == NULL) {
+				lpObj->buckets[idx] = lpCur->bucketList.lpNext;
+			} else {
+				lpCur->bucketList.lpPrev->bucketList.lpNext = lpCur->bucketList.lpNext;
+			}
+			if(lpCur->bucketList.lpNext != NULL) {
+				lpCur->bucketList.lpNext->bucketList.lpPrev = lpCur->bucketList.lpPrev;
+			}
+			lpObj->dwElementCount = lpObj->dwElementCount - 1;
+
+			/* Either hand the value to the caller or release it */
+			if(lpValueOut != NULL) {
 				(*lpValueOut) = lpCur->lpValue;
-				return cjsonE_Ok;
+			} else {
+				cjsonReleaseValue(lpCur->lpValue);
+			}
+
+			if(lpObj->base.lpSystem == NULL) {
+				free((void*)lpCur);
+			} else {
+				lpObj->base.lpSystem->free(lpObj->base.lpSystem, (void*)lpCur);
 			}
+			return cjsonE_Ok;
+		}
+		lpCur = lpCur->bucketList.lpNext;
+	}
+
+	return cjsonE_IndexOutOfBounds;
+}
+enum cjsonError cjsonObject_SetShared(
+	struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	struct cjsonValue* lpValue
+) {
+	enum cjsonError e;
+
+	if(lpValue == NULL) { return cjsonE_InvalidParam; }
+
+	cjsonValue_Retain(lpValue);
+	e = cjsonObject_Set(lpObject, lpKey, dwKeyLength, lpValue);
+	if(e != cjsonE_Ok) {
+		/* The caller still owns a reference, this can never drop to zero */
+		CJSON_ATOMIC_DECREMENT(lpValue->dwRefCount);
+	}
+	return e;
+}
+enum cjsonError cjsonObject_Get(
+	const struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	struct cjsonValue** lpValueOut
+) {
+	return cjsonObject_GetPrehashed(lpObject, lpKey, dwKeyLength, cjsonObject_HashKey(lpKey, dwKeyLength), lpValueOut);
+}
+enum cjsonError cjsonObject_GetPrehashed(
+	const struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	uint32_t dwKeyHash,
+	struct cjsonValue** lpValueOut
+) {
+	const struct cjsonObject_BucketEntry* lpCur;
+
+	const struct cjsonObject* lpObj = (const struct cjsonObject*)lpObject;
+
+	if(lpValueOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpValueOut) = NULL;
+
+	lpCur = lpObj->buckets[getHashIndex(lpObj, dwKeyHash)];
+	while(lpCur != NULL) {
+		if(entryMatches(lpCur, lpKey, dwKeyLength, dwKeyHash) != 0) {
+			(*lpValueOut) = lpCur->lpValue;
+			return cjsonE_Ok;
 		}
 		lpCur = lpCur->bucketList.lpNext;
 	}
 
 	return cjsonE_IndexOutOfBounds;
 }
+enum cjsonError cjsonObject_GetMutable(
+	struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	struct cjsonValue** lpValueOut
+) {
+	enum cjsonError e;
+	struct cjsonObject_BucketEntry* lpCur;
+
+	if(lpValueOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpValueOut) = NULL;
+
+	if(lpObject == NULL) { return cjsonE_InvalidParam; }
+	if(lpObject->type != cjsonObject) { return cjsonE_InvalidParam; }
+
+	lpCur = cjsonObject_FindEntry(lpObject, lpKey, dwKeyLength);
+	if(lpCur == NULL) { return cjsonE_IndexOutOfBounds; }
+
+	/* Matching key, replace a shared value by our private copy */
+	e = cjsonValue_Unshare(&(lpCur->lpValue));
+	if(e != cjsonE_Ok) { return e; }
+
+	(*lpValueOut) = lpCur->lpValue;
+	return cjsonE_Ok;
+}
 enum cjsonError cjsonObject_HasKey(
 	const struct cjsonValue* lpObject,
 	const char* lpKey,
 	unsigned long int dwKeyLength
 ) {
-	unsigned long int idx;
+	struct cjsonValue* lpValue;
+
+	return cjsonObject_GetPrehashed(lpObject, lpKey, dwKeyLength, cjsonObject_HashKey(lpKey, dwKeyLength), &lpValue);
+}
+
+void cjsonKey_Init(
+	struct cjsonKey* lpKeyOut,
+	const char* lpKey,
+	unsigned long int dwKeyLength
+) {
+	lpKeyOut->lpKey = lpKey;
+	lpKeyOut->dwKeyLength = dwKeyLength;
+	lpKeyOut->dwKeyHash = cjsonObject_HashKey(lpKey, dwKeyLength);
+}
+enum cjsonError cjsonObject_GetKey(
+	const struct cjsonValue* lpObject,
+	const struct cjsonKey* lpKey,
+	struct cjsonValue** lpValueOut
+) {
+	if(lpKey == NULL) { return cjsonE_InvalidParam; }
+	return cjsonObject_GetPrehashed(lpObject, lpKey->lpKey, lpKey->dwKeyLength, lpKey->dwKeyHash, lpValueOut);
+}
+enum cjsonError cjsonObject_ContainsKey(
+	const struct cjsonValue* lpObject,
+	const struct cjsonKey* lpKey
+) {
+	struct cjsonValue* lpValue;
+
+	if(lpKey == NULL) { return cjsonE_InvalidParam; }
+	return cjsonObject_GetPrehashed(lpObject, lpKey->lpKey, lpKey->dwKeyLength, lpKey->dwKeyHash, &lpValue);
+}
+enum cjsonError cjsonObject_SetKey(
+	struct cjsonValue* lpObject,
+	const struct cjsonKey* lpKey,
+	struct cjsonValue* lpValue
+) {
+	if(lpKey == NULL) { return cjsonE_InvalidParam; }
+	return cjsonObject_SetPrehashed(lpObject, lpKey->lpKey, lpKey->dwKeyLength, lpKey->dwKeyHash, lpValue);
+}
+enum cjsonError cjsonObject_GetKeys(
+	const struct cjsonValue* lpObject,
+	const struct cjsonKey* lpKeys,
+	unsigned long int dwKeyCount,
+	struct cjsonValue** lpValuesOut
+) {
 	const struct cjsonObject_BucketEntry* lpCur;
+	unsigned long int dwFound;
+	unsigned long int i;
+	unsigned long int j;
 
 	const struct cjsonObject* lpObj = (const struct cjsonObject*)lpObject;
 
-	/* Determine hashtable index */
-	idx = getHashIndex(lpObj, lpKey, dwKeyLength);
+	if((lpKeys == NULL) && (dwKeyCount > 0)) { return cjsonE_InvalidParam; }
+	if((lpValuesOut == NULL) && (dwKeyCount > 0)) { return cjsonE_InvalidParam; }
+	for(j = 0; j < dwKeyCount; j=j+1) { lpValuesOut[j] = NULL; }
 
-	if(lpObj->buckets[idx] == NULL) { return cjsonE_IndexOutOfBounds; }
+	if(lpObject == NULL) { return cjsonE_InvalidParam; }
+	if(lpObject->type != cjsonObject) { return cjsonE_InvalidParam; }
 
-	lpCur = lpObj->buckets[idx];
-	while(lpCur != NULL) {
-		if(lpCur->dwKeyLength == dwKeyLength) {
-			if(memcmp(lpCur->bKey, lpKey, dwKeyLength) == 0) {
-				/* Matching key */
-				return cjsonE_Ok;
+	dwFound = 0;
+	if(lpObj->dwElementCount <= dwKeyCount * CJSON_OBJECT_BATCHSCANFACTOR) {
+		/* Single pass over all entries, stops as soon as every handle has been resolved */
+		for(i = 0; (i < lpObj->dwBucketCount) && (dwFound < dwKeyCount); i=i+1) {
+			for(lpCur = lpObj->buckets[i]; lpCur != NULL; lpCur = lpCur->bucketList.lpNext) {
+				for(j = 0; j < dwKeyCount; j=j+1) {
+					if((lpValuesOut[j] == NULL) && (entryMatches(lpCur, lpKeys[j].lpKey, lpKeys[j].dwKeyLength, lpKeys[j].dwKeyHash) != 0)) {
+						lpValuesOut[j] = lpCur->lpValue;
+						dwFound = dwFound + 1;
+					}
+				}
+			}
+		}
+	} else {
+		/* Issue all bucket loads before the first chain is walked */
+		for(j = 0; j < dwKeyCount; j=j+1) {
+			lpCur = lpObj->buckets[getHashIndex(lpObj, lpKeys[j].dwKeyHash)];
+			if(lpCur != NULL) { CJSON_PREFETCH(lpCur); }
+		}
+		for(j = 0; j < dwKeyCount; j=j+1) {
+			for(lpCur = lpObj->buckets[getHashIndex(lpObj, lpKeys[j].dwKeyHash)]; lpCur != NULL; lpCur = lpCur->bucketList.lpNext) {
+				if(entryMatches(lpCur, lpKeys[j].lpKey, lpKeys[j].dwKeyLength, lpKeys[j].dwKeyHash) != 0) {
+					lpValuesOut[j] = lpCur->lpValue;
+					dwFound = dwFound + 1;
+					break;
+				}
 			}
 		}
+	}
+
+	return (dwFound == dwKeyCount) ? cjsonE_Ok : cjsonE_IndexOutOfBounds;
+}
+
+struct cjsonObject_BucketEntry* cjsonObject_FindEntry(
+	const struct cjsonValue* lpObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength
+) {
+	struct cjsonObject_BucketEntry* lpCur;
+	uint32_t dwKeyHash;
+
+	const struct cjsonObject* lpObj = (const struct cjsonObject*)lpObject;
+
+	if(lpObject == NULL) { return NULL; }
+	if(lpObject->type != cjsonObject) { return NULL; }
+
+	dwKeyHash = cjsonObject_HashKey(lpKey, dwKeyLength);
+	lpCur = lpObj->buckets[getHashIndex(lpObj, dwKeyHash)];
+	while(lpCur != NULL) {
+		if(entryMatches(lpCur, lpKey, dwKeyLength, dwKeyHash) != 0) {
+			return lpCur;
+		}
 		lpCur = lpCur->bucketList.lpNext;
 	}
+	return NULL;
+}
+void cjsonObject_DetachEntry(
+	struct cjsonValue* lpObject,
+	struct cjsonObject_BucketEntry* lpEntry
+) {
+	struct cjsonObject* lpObj = (struct cjsonObject*)lpObject;
 
-	return cjsonE_IndexOutOfBounds;
+	if(lpEntry->bucketList.lpPrev == NULL) {
+		lpObj->buckets[getHashIndex(lpObj, lpEntry->dwKeyHash)] = lpEntry->bucketList.lpNext;
+	} else {
+		lpEntry->bucketList.lpPrev->bucketList.lpNext = lpEntry->bucketList.lpNext;
+	}
+	if(lpEntry->bucketList.lpNext != NULL) {
+		lpEntry->bucketList.lpNext->bucketList.lpPrev = lpEntry->bucketList.lpPrev;
+	}
+	lpEntry->bucketList.lpNext = NULL;
+	lpEntry->bucketList.lpPrev = NULL;
+	lpObj->dwElementCount = lpObj->dwElementCount - 1;
+}
+void cjsonObject_AttachEntry(
+	struct cjsonValue* lpObject,
+	struct cjsonObject_BucketEntry* lpEntry
+) {
+	unsigned long int idx;
+	struct cjsonObject* lpObj = (struct cjsonObject*)lpObject;
+
+	/* Order inside a bucket is irrelevant so we prepend */
+	idx = getHashIndex(lpObj, lpEntry->dwKeyHash);
+	lpEntry->bucketList.lpPrev = NULL;
+	lpEntry->bucketList.lpNext = lpObj->buckets[idx];
+	if(lpEntry->bucketList.lpNext != NULL) {
+		lpEntry->bucketList.lpNext->bucketList.lpPrev = lpEntry;
+	}
+	lpObj->buckets[idx] = lpEntry;
+	lpObj->dwElementCount = lpObj->dwElementCount + 1;
 }
 
 enum cjsonError cjsonObject_Iterate(
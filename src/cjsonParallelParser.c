@@ -0,0 +1,683 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_PARALLELPARSER_MINCHUNKSIZE
+	#define CJSON_PARALLELPARSER_MINCHUNKSIZE 65536				/* Smaller chunks are not worth a job */
+#endif
+#ifndef CJSON_PARALLELPARSER_MAXCHUNKSIZE
+	#define CJSON_PARALLELPARSER_MAXCHUNKSIZE 4194304			/* Limits the documents buffered per chunk in ordered mode */
+#endif
+#ifndef CJSON_PARALLELPARSER_CHUNKSPERTHREAD
+	#define CJSON_PARALLELPARSER_CHUNKSPERTHREAD 4				/* Targeted number of chunks per worker for load balancing */
+#endif
+
+#define CJSON_PARALLELPARSER_NONE			(~0UL)
+
+/*
+	String state at a given offset. A chunk is scanned once for
+	every possible state at its start since the real state is
+	only known after all previous chunks have been scanned.
+*/
+enum cjsonParallelParser_StringState {
+	cjsonParallelParser_StringState__Outside = 0,
+	cjsonParallelParser_StringState__Inside = 1,
+	cjsonParallelParser_StringState__Escaped = 2,
+
+	cjsonParallelParser_StringState__Count
+};
+
+struct cjsonParallelParser_Context {
+	const char*										lpData;
+	unsigned long int								dwLength;
+	uint32_t										dwFlags;
+
+	lpfnCJSONCallback_DocumentReady					callbackDocumentReady;
+	void*											callbackDocumentReadyFreeParam;
+
+	struct cjsonValue*								lpResult;			/* Stitched array (ParseArray without callback) */
+	unsigned long int								dwRanges;			/* Number of element ranges (ParseArray) */
+	struct cjsonSystemAPI*							lpSystem;
+};
+
+struct cjsonParallelParser_Chunk {
+	struct cjsonWorkerPool_Job						job;
+	struct cjsonParallelParser_Context*				lpContext;
+
+	unsigned long int								dwBegin;
+	unsigned long int								dwEnd;
+
+	/* Scan result for every possible state at dwBegin */
+	unsigned long int								dwFirstNewline[cjsonParallelParser_StringState__Count];
+	signed long int									dwDepthDelta[cjsonParallelParser_StringState__Count];
+	enum cjsonParallelParser_StringState			endState[cjsonParallelParser_StringState__Count];
+
+	/* Parse result, documents are only collected in ordered mode */
+	enum cjsonError									eResult;
+	struct cjsonValue**								lpDocuments;
+	unsigned long int								dwDocuments;
+	unsigned long int								dwDocumentCapacity;
+	struct cjsonValue*								lpArray;			/* Elements of an array range */
+	int												bSubmitted;
+};
+
+typedef enum cjsonError (*cjsonParallelParser_Finish)(
+	struct cjsonParallelParser_Chunk* lpChunk,
+	enum cjsonError eStatus					/* Anything but cjsonE_Ok only releases the chunk */
+);
+
+static inline enum cjsonError cjsonParallelParser_Alloc(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return cjsonSystemAPI_AllocAt(lpSystem, cjsonAllocSite__Other, dwSize, lpOut);
+	}
+}
+static inline void cjsonParallelParser_Free(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpObject
+) {
+	if(lpSystem == NULL) {
+		free(lpObject);
+	} else {
+		lpSystem->free(lpSystem, lpObject);
+	}
+}
+
+static void cjsonParallelParser_InitChunk(
+	struct cjsonParallelParser_Chunk* lpChunk,
+	struct cjsonParallelParser_Context* lpContext,
+	unsigned long int dwBegin,
+	unsigned long int dwEnd
+) {
+	lpChunk->lpContext = lpContext;
+	lpChunk->dwBegin = dwBegin;
+	lpChunk->dwEnd = dwEnd;
+	lpChunk->eResult = cjsonE_Ok;
+	lpChunk->lpDocuments = NULL;
+	lpChunk->dwDocuments = 0;
+	lpChunk->dwDocumentCapacity = 0;
+	lpChunk->lpArray = NULL;
+	lpChunk->bSubmitted = 0;
+}
+
+/*
+	Structural scan. Raw newlines are never valid inside JSON
+	strings but the parser tolerates them, so the string state
+	is tracked to never cut a string in half. Brackets outside of
+	strings give the nesting depth relative to the chunk start.
+*/
+static void cjsonParallelParser_ScanWorker(
+	void* lpParam
+) {
+	struct cjsonParallelParser_Chunk* lpChunk = (struct cjsonParallelParser_Chunk*)lpParam;
+	const char* lpData = lpChunk->lpContext->lpData;
+	enum cjsonParallelParser_StringState eStart;
+	enum cjsonParallelParser_StringState eState;
+	unsigned long int dwFirstNewline;
+	signed long int dwDepth;
+	unsigned long int i;
+
+	for(eStart = cjsonParallelParser_StringState__Outside; eStart < cjsonParallelParser_StringState__Count; eStart = (enum cjsonParallelParser_StringState)(eStart + 1)) {
+		eState = eStart;
+		dwFirstNewline = CJSON_PARALLELPARSER_NONE;
+		dwDepth = 0;
+		for(i = lpChunk->dwBegin; i < lpChunk->dwEnd; i=i+1) {
+			switch(eState) {
+				case cjsonParallelParser_StringState__Outside:
+					switch(lpData[i]) {
+						case '"':	eState = cjsonParallelParser_StringState__Inside; break;
+						case '[':
+						case '{':	dwDepth = dwDepth + 1; break;
+						case ']':
+						case '}':	dwDepth = dwDepth - 1; break;
+						case '\n':	if(dwFirstNewline == CJSON_PARALLELPARSER_NONE) { dwFirstNewline = i; } break;
+						default:	break;
+					}
+					break;
+				case cjsonParallelParser_StringState__Inside:
+					if(lpData[i] == '"') {
+						eState = cjsonParallelParser_StringState__Outside;
+					} else if(lpData[i] == '\\') {
+						eState = cjsonParallelParser_StringState__Escaped;
+					}
+					break;
+				default:
+					eState = cjsonParallelParser_StringState__Inside;
+					break;
+			}
+		}
+		lpChunk->dwFirstNewline[eStart] = dwFirstNewline;
+		lpChunk->dwDepthDelta[eStart] = dwDepth;
+		lpChunk->endState[eStart] = eState;
+	}
+}
+
+/*
+	Splits [dwBegin, dwEnd) into chunks and scans them on the pool.
+	Returns the number of chunks in lpChunkCountOut, the caller
+	releases lpChunksOut.
+*/
+static enum cjsonError cjsonParallelParser_Scan(
+	struct cjsonParallelParser_Context* lpContext,
+	struct cjsonWorkerPool* lpPool,
+	unsigned long int dwBegin,
+	unsigned long int dwEnd,
+	struct cjsonParallelParser_Chunk** lpChunksOut,
+	unsigned long int* lpChunkCountOut
+) {
+	struct cjsonParallelParser_Chunk* lpChunks;
+	unsigned long int dwChunkSize;
+	unsigned long int dwChunkCount;
+	unsigned long int i;
+	enum cjsonError e;
+
+	dwChunkSize = (dwEnd - dwBegin) / (cjsonWorkerPool_ThreadCount(lpPool) * CJSON_PARALLELPARSER_CHUNKSPERTHREAD);
+	if(dwChunkSize < CJSON_PARALLELPARSER_MINCHUNKSIZE) { dwChunkSize = CJSON_PARALLELPARSER_MINCHUNKSIZE; }
+	if(dwChunkSize > CJSON_PARALLELPARSER_MAXCHUNKSIZE) { dwChunkSize = CJSON_PARALLELPARSER_MAXCHUNKSIZE; }
+	dwChunkCount = (dwEnd - dwBegin + dwChunkSize - 1) / dwChunkSize;
+	if(dwChunkCount < 1) { dwChunkCount = 1; }
+
+	e = cjsonParallelParser_Alloc(lpContext->lpSystem, sizeof(struct cjsonParallelParser_Chunk) * dwChunkCount, (void**)(&lpChunks));
+	if(e != cjsonE_Ok) { return e; }
+
+	for(i = 0; i < dwChunkCount; i=i+1) {
+		cjsonParallelParser_InitChunk(&(lpChunks[i]), lpContext, dwBegin + i * dwChunkSize, (dwBegin + (i + 1) * dwChunkSize < dwEnd) ? dwBegin + (i + 1) * dwChunkSize : dwEnd);
+		lpChunks[i].job.lpfnJob = &cjsonParallelParser_ScanWorker;
+		lpChunks[i].job.lpParam = (void*)(&(lpChunks[i]));
+		if(e == cjsonE_Ok) {
+			e = cjsonWorkerPool_Submit(lpPool, &(lpChunks[i].job));
+			if(e == cjsonE_Ok) { lpChunks[i].bSubmitted = 1; }
+		}
+	}
+	for(i = 0; i < dwChunkCount; i=i+1) {
+		if(lpChunks[i].bSubmitted != 0) {
+			cjsonWorkerPool_Wait(lpPool, &(lpChunks[i].job));
+			lpChunks[i].bSubmitted = 0;
+		}
+	}
+	if(e != cjsonE_Ok) {
+		cjsonParallelParser_Free(lpContext->lpSystem, (void*)lpChunks);
+		return e;
+	}
+
+	(*lpChunksOut) = lpChunks;
+	(*lpChunkCountOut) = dwChunkCount;
+	return cjsonE_Ok;
+}
+
+/*
+	Runs the parse jobs of all chunks in order. Only a window of
+	chunks is in flight so ordered mode never buffers more than a
+	few chunks of documents. Every chunk is finished in order on
+	the calling thread, after the first error the remaining chunks
+	are only drained.
+*/
+static enum cjsonError cjsonParallelParser_Run(
+	struct cjsonWorkerPool* lpPool,
+	struct cjsonParallelParser_Chunk* lpChunks,
+	unsigned long int dwChunkCount,
+	cjsonWorkerPool_JobFunction lpfnParse,
+	cjsonParallelParser_Finish lpfnFinish
+) {
+	unsigned long int dwWindow;
+	unsigned long int dwNextSubmit;
+	unsigned long int i;
+	enum cjsonError e;
+
+	dwWindow = 2 * cjsonWorkerPool_ThreadCount(lpPool);
+	if(dwWindow < 2) { dwWindow = 2; }
+
+	e = cjsonE_Ok;
+	dwNextSubmit = 0;
+	for(i = 0; i < dwChunkCount; i=i+1) {
+		while((e == cjsonE_Ok) && (dwNextSubmit < dwChunkCount) && (dwNextSubmit < i + dwWindow)) {
+			lpChunks[dwNextSubmit].job.lpfnJob = lpfnParse;
+			lpChunks[dwNextSubmit].job.lpParam = (void*)(&(lpChunks[dwNextSubmit]));
+			e = cjsonWorkerPool_Submit(lpPool, &(lpChunks[dwNextSubmit].job));
+			if(e != cjsonE_Ok) { break; }
+			lpChunks[dwNextSubmit].bSubmitted = 1;
+			dwNextSubmit = dwNextSubmit + 1;
+		}
+
+		if(lpChunks[i].bSubmitted == 0) { continue; }
+		cjsonWorkerPool_Wait(lpPool, &(lpChunks[i].job));
+		lpChunks[i].bSubmitted = 0;
+
+		if(e == cjsonE_Ok) { e = lpChunks[i].eResult; }
+		e = lpfnFinish(&(lpChunks[i]), e);
+	}
+	return e;
+}
+
+/*
+	NDJSON chunks
+*/
+static enum cjsonError cjsonParallelParser_Collect(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	struct cjsonParallelParser_Chunk* lpChunk = (struct cjsonParallelParser_Chunk*)lpFreeParam;
+	struct cjsonValue** lpNew;
+	unsigned long int dwNewCapacity;
+	enum cjsonError e;
+
+	if(lpChunk->dwDocuments == lpChunk->dwDocumentCapacity) {
+		dwNewCapacity = (lpChunk->dwDocumentCapacity == 0) ? 64 : lpChunk->dwDocumentCapacity * 2;
+		e = cjsonParallelParser_Alloc(lpChunk->lpContext->lpSystem, sizeof(struct cjsonValue*) * dwNewCapacity, (void**)(&lpNew));
+		if(e != cjsonE_Ok) {
+			cjsonReleaseValue(lpDocument);
+			return e;
+		}
+		if(lpChunk->lpDocuments != NULL) {
+			memcpy(lpNew, lpChunk->lpDocuments, sizeof(struct cjsonValue*) * lpChunk->dwDocuments);
+			cjsonParallelParser_Free(lpChunk->lpContext->lpSystem, (void*)(lpChunk->lpDocuments));
+		}
+		lpChunk->lpDocuments = lpNew;
+		lpChunk->dwDocumentCapacity = dwNewCapacity;
+	}
+
+	lpChunk->lpDocuments[lpChunk->dwDocuments] = lpDocument;
+	lpChunk->dwDocuments = lpChunk->dwDocuments + 1;
+	return cjsonE_Ok;
+}
+static void cjsonParallelParser_NdjsonWorker(
+	void* lpParam
+) {
+	struct cjsonParallelParser_Chunk* lpChunk = (struct cjsonParallelParser_Chunk*)lpParam;
+	struct cjsonParallelParser_Context* lpContext = lpChunk->lpContext;
+	struct cjsonParser* lpParser;
+	enum cjsonParallelParser_StringState eState;
+	unsigned long int i;
+	enum cjsonError e;
+	char bByte;
+
+	if((lpContext->dwFlags & CJSON_PARALLELPARSER_FLAG__ORDERED) != 0) {
+		e = cjsonParserCreate(&lpParser, CJSON_PARSER_FLAG__STREAMINGMODE | (lpContext->dwFlags & CJSON_PARALLELPARSER_FLAG__ALLOWDUPLICATEKEYS), &cjsonParallelParser_Collect, (void*)lpChunk, lpContext->lpSystem);
+	} else {
+		e = cjsonParserCreate(&lpParser, CJSON_PARSER_FLAG__STREAMINGMODE | (lpContext->dwFlags & CJSON_PARALLELPARSER_FLAG__ALLOWDUPLICATEKEYS), lpContext->callbackDocumentReady, lpContext->callbackDocumentReadyFreeParam, lpContext->lpSystem);
+	}
+	if(e != cjsonE_Ok) {
+		lpChunk->eResult = e;
+		return;
+	}
+
+	/*
+		Records must not span lines. A newline outside of a string
+		has to complete the current record, otherwise multi line
+		records would only be rejected where they cross a chunk
+		boundary. Raw newlines inside strings are tolerated like the
+		parser does.
+	*/
+	eState = cjsonParallelParser_StringState__Outside;
+	for(i = lpChunk->dwBegin; i < lpChunk->dwEnd; i=i+1) {
+		bByte = lpContext->lpData[i];
+		e = cjsonParserProcessByte(lpParser, bByte);
+		if(e != cjsonE_Ok) { break; }
+
+		if(eState == cjsonParallelParser_StringState__Outside) {
+			if(bByte == '"') {
+				eState = cjsonParallelParser_StringState__Inside;
+			} else if((bByte == '\n') && (lpParser->lpStateStack != NULL)) {
+				e = cjsonE_EncodingError;
+				break;
+			}
+		} else if(eState == cjsonParallelParser_StringState__Inside) {
+			if(bByte == '"') {
+				eState = cjsonParallelParser_StringState__Outside;
+			} else if(bByte == '\\') {
+				eState = cjsonParallelParser_StringState__Escaped;
+			}
+		} else {
+			eState = cjsonParallelParser_StringState__Inside;
+		}
+	}
+
+	/* A number at the end of the input is only complete after a delimiter */
+	if(e == cjsonE_Ok) { e = cjsonParserProcessByte(lpParser, '\n'); }
+
+	/* Anything left open at the end of the input is truncated */
+	if((e == cjsonE_Ok) && (lpParser->lpStateStack != NULL)) { e = cjsonE_EncodingError; }
+
+	cjsonParserRelease(lpParser);
+	lpChunk->eResult = e;
+}
+static enum cjsonError cjsonParallelParser_NdjsonFinish(
+	struct cjsonParallelParser_Chunk* lpChunk,
+	enum cjsonError eStatus
+) {
+	struct cjsonParallelParser_Context* lpContext = lpChunk->lpContext;
+	unsigned long int i;
+
+	/* Ownership passes to the callback even if it fails */
+	for(i = 0; (i < lpChunk->dwDocuments) && (eStatus == cjsonE_Ok); i=i+1) {
+		eStatus = lpContext->callbackDocumentReady(lpChunk->lpDocuments[i], lpContext->callbackDocumentReadyFreeParam);
+	}
+	for(; i < lpChunk->dwDocuments; i=i+1) {
+		cjsonReleaseValue(lpChunk->lpDocuments[i]);
+	}
+	if(lpChunk->lpDocuments != NULL) {
+		cjsonParallelParser_Free(lpContext->lpSystem, (void*)(lpChunk->lpDocuments));
+	}
+	lpChunk->lpDocuments = NULL;
+	lpChunk->dwDocuments = 0;
+	lpChunk->dwDocumentCapacity = 0;
+	return eStatus;
+}
+
+enum cjsonError cjsonParallelParser_ParseNdjson(
+	const char* lpData,
+	unsigned long int dwLength,
+	uint32_t dwFlags,
+
+	lpfnCJSONCallback_DocumentReady callbackDocumentReady,
+	void* callbackDocumentReadyFreeParam,
+
+	struct cjsonWorkerPool* lpPool,
+	struct cjsonSystemAPI* lpSystem
+) {
+	struct cjsonParallelParser_Context context;
+	struct cjsonParallelParser_Chunk single;
+	struct cjsonParallelParser_Chunk* lpChunks;
+	enum cjsonParallelParser_StringState eState;
+	unsigned long int dwChunkCount;
+	unsigned long int dwUsed;
+	unsigned long int dwNewline;
+	unsigned long int i;
+	enum cjsonError e;
+
+	if((lpData == NULL) && (dwLength > 0)) { return cjsonE_InvalidParam; }
+	if(callbackDocumentReady == NULL) { return cjsonE_InvalidParam; }
+	if((dwFlags & ~(CJSON_PARALLELPARSER_FLAG__ORDERED|CJSON_PARALLELPARSER_FLAG__ALLOWDUPLICATEKEYS)) != 0) { return cjsonE_InvalidParam; }
+
+	context.lpData = lpData;
+	context.dwLength = dwLength;
+	context.dwFlags = dwFlags;
+	context.callbackDocumentReady = callbackDocumentReady;
+	context.callbackDocumentReadyFreeParam = callbackDocumentReadyFreeParam;
+	context.lpResult = NULL;
+	context.dwRanges = 0;
+	context.lpSystem = lpSystem;
+
+	if((lpPool == NULL) || (dwLength <= CJSON_PARALLELPARSER_MINCHUNKSIZE)) {
+		/* Not worth splitting: parse on the calling thread */
+		cjsonParallelParser_InitChunk(&single, &context, 0, dwLength);
+		cjsonParallelParser_NdjsonWorker((void*)&single);
+		return cjsonParallelParser_NdjsonFinish(&single, single.eResult);
+	}
+
+	e = cjsonParallelParser_Scan(&context, lpPool, 0, dwLength, &lpChunks, &dwChunkCount);
+	if(e != cjsonE_Ok) { return e; }
+
+	/*
+		Chain the string states from the start of the buffer. Every
+		chunk starts behind the first newline outside of a string of
+		its scan range, ranges without such a newline are merged into
+		the previous chunk. Chunks are compacted in place, the scan
+		result of a range is read before its slot can be reused.
+	*/
+	eState = cjsonParallelParser_StringState__Outside;
+	dwUsed = 1;
+	for(i = 0; i < dwChunkCount; i=i+1) {
+		dwNewline = lpChunks[i].dwFirstNewline[eState];
+		eState = lpChunks[i].endState[eState];
+		if((i > 0) && (dwNewline != CJSON_PARALLELPARSER_NONE)) {
+			lpChunks[dwUsed - 1].dwEnd = dwNewline + 1;
+			lpChunks[dwUsed].dwBegin = dwNewline + 1;
+			dwUsed = dwUsed + 1;
+		}
+	}
+	lpChunks[dwUsed - 1].dwEnd = dwLength;
+
+	e = cjsonParallelParser_Run(lpPool, lpChunks, dwUsed, &cjsonParallelParser_NdjsonWorker, &cjsonParallelParser_NdjsonFinish);
+	cjsonParallelParser_Free(lpSystem, (void*)lpChunks);
+	return e;
+}
+
+/*
+	Array ranges. Every range is a comma separated list of
+	elements, it's parsed as an array of its own by wrapping it in
+	brackets.
+*/
+static enum cjsonError cjsonParallelParser_Store(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	((struct cjsonParallelParser_Chunk*)lpFreeParam)->lpArray = lpDocument;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonParallelParser_DeliverElements(
+	struct cjsonParallelParser_Chunk* lpChunk
+) {
+	struct cjsonParallelParser_Context* lpContext = lpChunk->lpContext;
+	struct cjsonArray_Page* lpPage;
+	struct cjsonValue* lpElement;
+	unsigned long int i;
+	enum cjsonError e;
+
+	/* Entries are detached before they are passed on, the emptied container is released by the caller */
+	for(lpPage = ((struct cjsonArray*)(lpChunk->lpArray))->pageList.lpFirstPage; lpPage != NULL; lpPage = lpPage->pageList.lpNext) {
+		for(i = 0; i < lpPage->dwUsedEntries; i=i+1) {
+			if((lpElement = lpPage->entries[i]) == NULL) { continue; }
+			lpPage->entries[i] = NULL;
+			e = lpContext->callbackDocumentReady(lpElement, lpContext->callbackDocumentReadyFreeParam);
+			if(e != cjsonE_Ok) { return e; }
+		}
+	}
+	return cjsonE_Ok;
+}
+static void cjsonParallelParser_ArrayWorker(
+	void* lpParam
+) {
+	struct cjsonParallelParser_Chunk* lpChunk = (struct cjsonParallelParser_Chunk*)lpParam;
+	struct cjsonParallelParser_Context* lpContext = lpChunk->lpContext;
+	struct cjsonParser* lpParser;
+	unsigned long int i;
+	enum cjsonError e;
+
+	e = cjsonParserCreate(&lpParser, lpContext->dwFlags & CJSON_PARALLELPARSER_FLAG__ALLOWDUPLICATEKEYS, &cjsonParallelParser_Store, (void*)lpChunk, lpContext->lpSystem);
+	if(e != cjsonE_Ok) {
+		lpChunk->eResult = e;
+		return;
+	}
+
+	e = cjsonParserProcessByte(lpParser, '[');
+	for(i = lpChunk->dwBegin; (i < lpChunk->dwEnd) && (e == cjsonE_Ok); i=i+1) {
+		e = cjsonParserProcessByte(lpParser, lpContext->lpData[i]);
+	}
+	if(e == cjsonE_Ok) { e = cjsonParserProcessByte(lpParser, ']'); }
+	cjsonParserRelease(lpParser);
+
+	/* Closing the wrapped range early means the range was not a plain element list */
+	if(e == cjsonE_AlreadyFinished) { e = cjsonE_EncodingError; }
+	if((e == cjsonE_Ok) && (lpChunk->lpArray == NULL)) { e = cjsonE_EncodingError; }
+
+	/* Only a sole range may be empty, anything else is a stray comma */
+	if((e == cjsonE_Ok) && (lpContext->dwRanges > 1) && (((struct cjsonArray*)(lpChunk->lpArray))->dwElementCount == 0)) {
+		e = cjsonE_EncodingError;
+	}
+
+	if((e == cjsonE_Ok) && (lpContext->callbackDocumentReady != NULL) && ((lpContext->dwFlags & CJSON_PARALLELPARSER_FLAG__ORDERED) == 0)) {
+		e = cjsonParallelParser_DeliverElements(lpChunk);
+	}
+	lpChunk->eResult = e;
+}
+static enum cjsonError cjsonParallelParser_ArrayFinish(
+	struct cjsonParallelParser_Chunk* lpChunk,
+	enum cjsonError eStatus
+) {
+	struct cjsonParallelParser_Context* lpContext = lpChunk->lpContext;
+
+	if((eStatus == cjsonE_Ok) && (lpChunk->lpArray != NULL)) {
+		if(lpContext->callbackDocumentReady == NULL) {
+			/* Stitch the pages of the range behind the previous ranges */
+			if(lpContext->lpResult == NULL) {
+				lpContext->lpResult = lpChunk->lpArray;
+				lpChunk->lpArray = NULL;
+				return cjsonE_Ok;
+			}
+			eStatus = cjsonArray_Concat(lpContext->lpResult, lpChunk->lpArray);
+			if(eStatus == cjsonE_Ok) { lpChunk->lpArray = NULL; }
+		} else if((lpContext->dwFlags & CJSON_PARALLELPARSER_FLAG__ORDERED) != 0) {
+			eStatus = cjsonParallelParser_DeliverElements(lpChunk);
+		}
+	}
+
+	if(lpChunk->lpArray != NULL) {
+		cjsonReleaseValue(lpChunk->lpArray);
+		lpChunk->lpArray = NULL;
+	}
+	return eStatus;
+}
+
+static int cjsonParallelParser_IsWhitespace(
+	char c
+) {
+	return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+}
+
+enum cjsonError cjsonParallelParser_ParseArray(
+	const char* lpData,
+	unsigned long int dwLength,
+	uint32_t dwFlags,
+
+	struct cjsonValue** lpArrayOut,
+	lpfnCJSONCallback_DocumentReady callbackElement,
+	void* callbackElementFreeParam,
+
+	struct cjsonWorkerPool* lpPool,
+	struct cjsonSystemAPI* lpSystem
+) {
+	struct cjsonParallelParser_Context context;
+	struct cjsonParallelParser_Chunk single;
+	struct cjsonParallelParser_Chunk* lpChunks;
+	enum cjsonParallelParser_StringState eState;
+	enum cjsonParallelParser_StringState eChunkState;
+	unsigned long int dwOpen;
+	unsigned long int dwClose;
+	unsigned long int dwChunkCount;
+	unsigned long int dwUsed;
+	unsigned long int dwComma;
+	unsigned long int dwScanned;
+	signed long int dwDepth;
+	signed long int dwChunkDepth;
+	unsigned long int i;
+	unsigned long int j;
+	enum cjsonError e;
+
+	if((lpData == NULL) && (dwLength > 0)) { return cjsonE_InvalidParam; }
+	if((lpArrayOut == NULL) == (callbackElement == NULL)) { return cjsonE_InvalidParam; }
+	if((dwFlags & ~(CJSON_PARALLELPARSER_FLAG__ORDERED|CJSON_PARALLELPARSER_FLAG__ALLOWDUPLICATEKEYS)) != 0) { return cjsonE_InvalidParam; }
+	if(lpArrayOut != NULL) { (*lpArrayOut) = NULL; }
+
+	/* The elements are everything between the outermost brackets */
+	for(dwOpen = 0; (dwOpen < dwLength) && cjsonParallelParser_IsWhitespace(lpData[dwOpen]); dwOpen=dwOpen+1) { }
+	for(dwClose = dwLength; (dwClose > dwOpen) && cjsonParallelParser_IsWhitespace(lpData[dwClose - 1]); dwClose=dwClose-1) { }
+	if((dwClose - dwOpen < 2) || (lpData[dwOpen] != '[') || (lpData[dwClose - 1] != ']')) { return cjsonE_EncodingError; }
+	dwOpen = dwOpen + 1;
+	dwClose = dwClose - 1;
+
+	context.lpData = lpData;
+	context.dwLength = dwLength;
+	context.dwFlags = dwFlags;
+	context.callbackDocumentReady = callbackElement;
+	context.callbackDocumentReadyFreeParam = callbackElementFreeParam;
+	context.lpResult = NULL;
+	context.dwRanges = 1;
+	context.lpSystem = lpSystem;
+
+	if((lpPool == NULL) || (dwClose - dwOpen <= CJSON_PARALLELPARSER_MINCHUNKSIZE)) {
+		/* Not worth splitting: parse on the calling thread */
+		cjsonParallelParser_InitChunk(&single, &context, dwOpen, dwClose);
+		cjsonParallelParser_ArrayWorker((void*)&single);
+		e = cjsonParallelParser_ArrayFinish(&single, single.eResult);
+	} else {
+		e = cjsonParallelParser_Scan(&context, lpPool, dwOpen, dwClose, &lpChunks, &dwChunkCount);
+		if(e != cjsonE_Ok) { return e; }
+
+		/*
+			Chain string state and nesting depth from the opening
+			bracket. Every chunk starts behind the first comma on
+			depth zero outside of a string in its scan range. Only
+			that prefix is rescanned on the calling thread since the
+			state at the start of every scan range is known now.
+			Ranges without such a comma are merged into the previous
+			chunk, the slots are compacted in place.
+		*/
+		eState = cjsonParallelParser_StringState__Outside;
+		dwDepth = 0;
+		dwScanned = dwOpen;
+		dwUsed = 1;
+		for(i = 0; (i < dwChunkCount) && (e == cjsonE_Ok); i=i+1) {
+			eChunkState = eState;
+			dwChunkDepth = dwDepth;
+			dwComma = CJSON_PARALLELPARSER_NONE;
+			if((i > 0) && (lpChunks[i].dwBegin >= dwScanned)) {
+				for(j = lpChunks[i].dwBegin; j < lpChunks[i].dwEnd; j=j+1) {
+					if(eChunkState == cjsonParallelParser_StringState__Outside) {
+						if(lpData[j] == '"') {
+							eChunkState = cjsonParallelParser_StringState__Inside;
+						} else if((lpData[j] == '[') || (lpData[j] == '{')) {
+							dwChunkDepth = dwChunkDepth + 1;
+						} else if((lpData[j] == ']') || (lpData[j] == '}')) {
+							dwChunkDepth = dwChunkDepth - 1;
+							if(dwChunkDepth < 0) { e = cjsonE_EncodingError; break; }
+						} else if((lpData[j] == ',') && (dwChunkDepth == 0)) {
+							dwComma = j;
+							break;
+						}
+					} else if(eChunkState == cjsonParallelParser_StringState__Inside) {
+						if(lpData[j] == '"') {
+							eChunkState = cjsonParallelParser_StringState__Outside;
+						} else if(lpData[j] == '\\') {
+							eChunkState = cjsonParallelParser_StringState__Escaped;
+						}
+					} else {
+						eChunkState = cjsonParallelParser_StringState__Inside;
+					}
+				}
+			}
+			dwDepth = dwDepth + lpChunks[i].dwDepthDelta[eState];
+			eState = lpChunks[i].endState[eState];
+			if(dwComma != CJSON_PARALLELPARSER_NONE) {
+				lpChunks[dwUsed - 1].dwEnd = dwComma;
+				lpChunks[dwUsed].dwBegin = dwComma + 1;
+				dwUsed = dwUsed + 1;
+				dwScanned = dwComma + 1;
+			}
+		}
+		lpChunks[dwUsed - 1].dwEnd = dwClose;
+		context.dwRanges = dwUsed;
+
+		/* Brackets have to balance, the parser validates everything else */
+		if((e == cjsonE_Ok) && ((eState != cjsonParallelParser_StringState__Outside) || (dwDepth != 0))) { e = cjsonE_EncodingError; }
+
+		if(e == cjsonE_Ok) {
+			e = cjsonParallelParser_Run(lpPool, lpChunks, dwUsed, &cjsonParallelParser_ArrayWorker, &cjsonParallelParser_ArrayFinish);
+		}
+		cjsonParallelParser_Free(lpSystem, (void*)lpChunks);
+	}
+
+	if(context.lpResult != NULL) {
+		if(e != cjsonE_Ok) {
+			cjsonReleaseValue(context.lpResult);
+		} else {
+			(*lpArrayOut) = context.lpResult;
+		}
+	}
+	return e;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -1,7 +1,14 @@
+#if defined(CJSON_PARSER_CYCLECOUNTERS) && !defined(_POSIX_C_SOURCE)
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "../include/cjson.h"
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#ifdef CJSON_PARSER_CYCLECOUNTERS
+	#include <time.h>
+#endif
 
 #ifdef __cplusplus
 	extern "C" {
@@ -10,6 +17,9 @@
 #ifndef CJSON_PARSER_BLOCKSIZE_STRING
 	#define CJSON_PARSER_BLOCKSIZE_STRING 512
 #endif
+#ifndef CJSON_PARSER_MAXFREEPAGES
+	#define CJSON_PARSER_MAXFREEPAGES 16			/* String pages kept for reuse, longer strings release their excess pages */
+#endif
 
 /*
 	Some constants
@@ -18,13 +28,30 @@ static const char* strTrue 		= "true";
 static const char* strFalse 	= "false";
 static const char* strNull 		= "null";
 
+#define CJSON_PARSER_STATS_HANDLER_UNIVERSE		(CJSON_PARSER_STATS_HANDLERS - 1)
+
+#ifdef CJSON_PARSER_CYCLECOUNTERS
+	static inline uint64_t cjsonParser_Cycles(void) {
+		#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+			return (uint64_t)__builtin_ia32_rdtsc();
+		#else
+			struct timespec ts;
+
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+		#endif
+	}
+#endif
+
 /*
 	And forward declarations for this local file
 */
 struct cjsonParser;
 
-static inline enum cjsonError cjsonParserMallocHelper(struct cjsonParser* lpParser, unsigned long int dwSize, void** lpOut);
+static inline enum cjsonError cjsonParserMallocHelper(struct cjsonParser* lpParser, enum cjsonAllocSite eSite, unsigned long int dwSize, void** lpOut);
 static inline void cjsonParserFreeHelper(struct cjsonParser* lpParser, void* lpArea);
+static inline enum cjsonError cjsonParser_StateAlloc(struct cjsonParser* lpParser, enum cjsonParser_StateStackType eType, unsigned long int dwSize, void** lpOut);
+static inline void cjsonParser_StateRecycle(struct cjsonParser* lpParser, struct cjsonParser_StateStackElement* lpElm);
 
 static enum cjsonError cjsonParser_Constant_Push(struct cjsonParser* lpParser, enum cjsonElementType eType);
 static enum cjsonError cjsonParser_String_Push(struct cjsonParser* lpParser);
@@ -58,6 +85,7 @@ static inline void cjsonParser_BufferChain_Init(
 	lpChain->lpLast = NULL;
 	lpChain->dwPageSize = dwPageSize;
 	lpChain->dwBytesUsed = 0;
+	lpChain->dwHash = CJSON_OBJECT_HASH_INIT;
 	return;
 }
 static inline void cjsonParser_BufferChain_Release(
@@ -70,12 +98,31 @@ static inline void cjsonParser_BufferChain_Release(
 	lpCur = lpChain->lpFirst;
 	while(lpCur != NULL) {
 		lpNext = lpCur->lpNext;
-		cjsonParserFreeHelper(lpParser, (void*)lpCur);
+		if((lpChain->dwPageSize == CJSON_PARSER_BLOCKSIZE_STRING) && (lpParser->dwFreePages < CJSON_PARSER_MAXFREEPAGES)) {
+			lpCur->lpNext = lpParser->lpFreePages;
+			lpParser->lpFreePages = lpCur;
+			lpParser->dwFreePages = lpParser->dwFreePages + 1;
+		} else {
+			cjsonParserFreeHelper(lpParser, (void*)lpCur);
+		}
 		lpCur = lpNext;
 	}
 	lpChain->lpFirst = NULL;
 	lpChain->lpLast = NULL;
 }
+static inline enum cjsonError cjsonParser_BufferChain_AllocPage(
+	struct cjsonParser* lpParser,
+	struct cjsonParser_BufferChain* lpChain,
+	struct cjsonParser_BufferChain_Entry** lpOut
+) {
+	if((lpParser->lpFreePages != NULL) && (lpChain->dwPageSize == CJSON_PARSER_BLOCKSIZE_STRING)) {
+		(*lpOut) = lpParser->lpFreePages;
+		lpParser->lpFreePages = (*lpOut)->lpNext;
+		lpParser->dwFreePages = lpParser->dwFreePages - 1;
+		return cjsonE_Ok;
+	}
+	return cjsonParserMallocHelper(lpParser, cjsonAllocSite__ParserBuffer, sizeof(struct cjsonParser_BufferChain_Entry)+lpChain->dwPageSize, (void**)lpOut);
+}
 static enum cjsonError cjsonParser_BufferChain_PushByte(
 	struct cjsonParser* lpParser,
 	struct cjsonParser_BufferChain* lpChain,
@@ -84,9 +131,12 @@ static enum cjsonError cjsonParser_BufferChain_PushByte(
 	enum cjsonError e;
 	struct cjsonParser_BufferChain_Entry* lpPage;
 
+	/* Hashed while scanning so object keys never have to be hashed again */
+	lpChain->dwHash = CJSON_OBJECT_HASH_STEP(lpChain->dwHash, bData);
+
 	if(lpChain->lpFirst == NULL) {
 		/* This is the first page */
-		e = cjsonParserMallocHelper(lpParser, sizeof(struct cjsonParser_BufferChain_Entry)+lpChain->dwPageSize, (void**)(&lpPage));
+		e = cjsonParser_BufferChain_AllocPage(lpParser, lpChain, &lpPage);
 		if(e != cjsonE_Ok) { return e; }
 
 		lpPage->lpNext = NULL;
@@ -106,7 +156,7 @@ static enum cjsonError cjsonParser_BufferChain_PushByte(
 		}
 
 		/* We have to expand with a new page */
-		e = cjsonParserMallocHelper(lpParser, sizeof(struct cjsonParser_BufferChain_Entry)+lpChain->dwPageSize, (void**)(&lpPage));
+		e = cjsonParser_BufferChain_AllocPage(lpParser, lpChain, &lpPage);
 		if(e != cjsonE_Ok) { return e; }
 
 		lpPage->lpNext = NULL;
@@ -155,10 +205,42 @@ static inline void cjsonParser_BufferChain_MemcpyOut(
 }
 
 /*
-	State stack pop helper. Note that popping REQUIRES the previous
-	state to have released ALL resources except the struct
-	cjsonParser_StateStackElement on top of the stack.
+	State stack push and pop helpers. Push functions link their
+	element themselves and notify afterwards. Note that popping
+	REQUIRES the previous state to have released ALL resources
+	except the struct cjsonParser_StateStackElement on top of the
+	stack.
 */
+static inline void cjsonParser_StateStackPushed(
+	struct cjsonParser* lpParser
+) {
+	lpParser->dwStateStackDepth = lpParser->dwStateStackDepth + 1;
+	if(lpParser->dwStateStackDepth > lpParser->stats.dwMaxStateStackDepth) {
+		lpParser->stats.dwMaxStateStackDepth = lpParser->dwStateStackDepth;
+	}
+}
+static void cjsonParser_StateStackPop_Stats(
+	struct cjsonParser* lpParser,
+	struct cjsonParser_StateStackElement* lpElm
+) {
+	struct cjsonParser_StateStackElement* lpParent = lpElm->lpNext;
+
+	if(lpParser->lpChildResult == NULL) { return; }
+
+	if(lpParser->lpChildResult->type == cjsonString) {
+		lpParser->stats.qwStringBytes = lpParser->stats.qwStringBytes + cjsonString_Strlen(lpParser->lpChildResult);
+	}
+	if((lpParent != NULL) && (lpParent->type == cjsonParser_StateStackType__Object) && (((struct cjsonParser_StateStackElement_Object*)lpParent)->state == cjsonParser_StateStackElement_Object_State__ReadKey)) {
+		lpParser->stats.qwKeys = lpParser->stats.qwKeys + 1;
+		return;
+	}
+	if(lpParser->lpChildResult->type < CJSON_PARSER_STATS_TYPES) {
+		lpParser->stats.qwValues[lpParser->lpChildResult->type] = lpParser->stats.qwValues[lpParser->lpChildResult->type] + 1;
+	}
+	if(lpParent == NULL) {
+		lpParser->stats.qwDocuments = lpParser->stats.qwDocuments + 1;
+	}
+}
 static enum cjsonError cjsonParser_StateStackPop(
 	struct cjsonParser* lpParser
 ) {
@@ -167,9 +249,11 @@ static enum cjsonError cjsonParser_StateStackPop(
 	if(lpParser->lpStateStack == NULL) { return cjsonE_InvalidParam; }
 
 	lpElm = lpParser->lpStateStack;
+	if((lpParser->dwFlags & CJSON_PARSER_FLAG__STATISTICS) != 0) { cjsonParser_StateStackPop_Stats(lpParser, lpElm); }
 	lpParser->lpStateStack = lpElm->lpNext;
+	lpParser->dwStateStackDepth = lpParser->dwStateStackDepth - 1;
 
-	cjsonParserFreeHelper(lpParser, (void*)lpElm);
+	cjsonParser_StateRecycle(lpParser, lpElm);
 
 	if(lpParser->lpStateStack == NULL) { 			return cjsonParser_Universe_PopNotify(lpParser); }
 
@@ -189,6 +273,7 @@ static enum cjsonError cjsonParser_StateStackPop(
 
 static inline enum cjsonError cjsonParserMallocHelper(
 	struct cjsonParser* lpParser,
+	enum cjsonAllocSite eSite,
 	unsigned long int dwSize,
 	void** lpOut
 ) {
@@ -197,7 +282,7 @@ static inline enum cjsonError cjsonParserMallocHelper(
 		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
 		return cjsonE_Ok;
 	} else {
-		return lpParser->lpSystem->alloc(lpParser->lpSystem, dwSize, lpOut);
+		return cjsonSystemAPI_AllocAt(lpParser->lpSystem, eSite, dwSize, lpOut);
 	}
 }
 
@@ -212,6 +297,69 @@ static inline void cjsonParserFreeHelper(
 	}
 }
 
+/*
+	State stack elements are kept in a free list per type. The
+	number of elements is bounded by the maximum nesting depth
+	seen so far, they are only released with the parser.
+*/
+static inline enum cjsonError cjsonParser_StateAlloc(
+	struct cjsonParser* lpParser,
+	enum cjsonParser_StateStackType eType,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpParser->lpFreeStates[eType] != NULL) {
+		(*lpOut) = (void*)(lpParser->lpFreeStates[eType]);
+		lpParser->lpFreeStates[eType] = lpParser->lpFreeStates[eType]->lpNext;
+		return cjsonE_Ok;
+	}
+	return cjsonParserMallocHelper(lpParser, cjsonAllocSite__ParserStack, dwSize, lpOut);
+}
+static inline void cjsonParser_StateRecycle(
+	struct cjsonParser* lpParser,
+	struct cjsonParser_StateStackElement* lpElm
+) {
+	lpElm->lpNext = lpParser->lpFreeStates[lpElm->type];
+	lpParser->lpFreeStates[lpElm->type] = lpElm;
+}
+
+/*
+	Schema validation helpers. The schema node of a value is
+	determined by its parent: the root node for documents, the
+	items node of arrays and the node of the current key for
+	objects. Without schema every node is CJSON_SCHEMA_NODE_ANY.
+*/
+static enum cjsonError cjsonParser_Schema_Start(
+	struct cjsonParser* lpParser,
+	enum cjsonElementType eType,
+	unsigned long int* lpNodeOut
+) {
+	struct cjsonParser_StateStackElement_Object* lpObject;
+
+	(*lpNodeOut) = CJSON_SCHEMA_NODE_ANY;
+	if(lpParser->lpSchema == NULL) { return cjsonE_Ok; }
+
+	if(lpParser->lpStateStack == NULL) {
+		(*lpNodeOut) = 0;
+	} else if(lpParser->lpStateStack->type == cjsonParser_StateStackType__Array) {
+		(*lpNodeOut) = ((struct cjsonParser_StateStackElement_Array*)(lpParser->lpStateStack))->dwItemsSchemaNode;
+	} else if(lpParser->lpStateStack->type == cjsonParser_StateStackType__Object) {
+		lpObject = (struct cjsonParser_StateStackElement_Object*)(lpParser->lpStateStack);
+		if(lpObject->state == cjsonParser_StateStackElement_Object_State__ReadKey) { return cjsonE_Ok; }	/* Keys are checked when complete */
+		(*lpNodeOut) = lpObject->dwValueSchemaNode;
+	}
+
+	if((*lpNodeOut) == CJSON_SCHEMA_NODE_ANY) { return cjsonE_Ok; }
+	return cjsonSchema_CheckStart(lpParser->lpSchema, (*lpNodeOut), eType);
+}
+static inline enum cjsonError cjsonParser_Schema_End(
+	struct cjsonParser* lpParser,
+	unsigned long int dwNode
+) {
+	if(dwNode == CJSON_SCHEMA_NODE_ANY) { return cjsonE_Ok; }
+	return cjsonSchema_CheckValue(lpParser->lpSchema, dwNode, lpParser->lpChildResult);
+}
+
 /*
 	Parser for undefined state (JSONDocument "universe")
 */
@@ -279,6 +427,14 @@ static enum cjsonError cjsonParser_Universe_PopNotify(
 		We have returned from our child ... we
 		now notify the registered callback (if any)
 	*/
+	if((lpParser->lpSchema != NULL) && (lpParser->lpChildResult != NULL)) {
+		e = cjsonParser_Schema_End(lpParser, 0);
+		if(e != cjsonE_Ok) {
+			cjsonReleaseValue(lpParser->lpChildResult);
+			lpParser->lpChildResult = NULL;
+			return e;
+		}
+	}
 	if((lpParser->callbackDocumentReady != NULL) && (lpParser->lpChildResult != NULL)) {
 		e = lpParser->callbackDocumentReady(lpParser->lpChildResult, lpParser->callbackDocumentReadyFreeParam);
 		lpParser->lpChildResult = NULL;
@@ -300,8 +456,12 @@ static enum cjsonError cjsonParser_Constant_Push(
 ) {
 	enum cjsonError e;
 	struct cjsonParser_StateStackElement_Constant* lpNewConst;
+	unsigned long int dwSchemaNode;
 
-	e = cjsonParserMallocHelper(lpParser, sizeof(struct cjsonParser_StateStackElement_Constant), (void**)(&lpNewConst));
+	e = cjsonParser_Schema_Start(lpParser, eType, &dwSchemaNode);
+	if(e != cjsonE_Ok) { return e; }
+
+	e = cjsonParser_StateAlloc(lpParser, cjsonParser_StateStackType__Constant, sizeof(struct cjsonParser_StateStackElement_Constant), (void**)(&lpNewConst));
 	if(e != cjsonE_Ok) { return e; }
 
 	switch(eType) {
@@ -317,6 +477,7 @@ static enum cjsonError cjsonParser_Constant_Push(
 
 	 /* Push to top of state stack */
 	 lpParser->lpStateStack = (struct cjsonParser_StateStackElement*)lpNewConst;
+	 cjsonParser_StateStackPushed(lpParser);
 	 return cjsonE_Ok;
 }
 static enum cjsonError cjsonParser_Constant_ProcessByte(
@@ -382,8 +543,12 @@ static enum cjsonError cjsonParser_String_Push(
 ) {
 	enum cjsonError e;
 	struct cjsonParser_StateStackElement_String* lpNewStr;
+	unsigned long int dwSchemaNode;
+
+	e = cjsonParser_Schema_Start(lpParser, cjsonString, &dwSchemaNode);
+	if(e != cjsonE_Ok) { return e; }
 
-	e = cjsonParserMallocHelper(lpParser, sizeof(struct cjsonParser_StateStackElement_String), (void**)(&lpNewStr));
+	e = cjsonParser_StateAlloc(lpParser, cjsonParser_StateStackType__String, sizeof(struct cjsonParser_StateStackElement_String), (void**)(&lpNewStr));
 	if(e != cjsonE_Ok) { return e; }
 
 	lpNewStr->base.type = cjsonParser_StateStackType__String;
@@ -393,6 +558,7 @@ static enum cjsonError cjsonParser_String_Push(
 	cjsonParser_BufferChain_Init(lpParser, &(lpNewStr->buf), CJSON_PARSER_BLOCKSIZE_STRING);
 
 	lpParser->lpStateStack = (struct cjsonParser_StateStackElement*)lpNewStr;
+	cjsonParser_StateStackPushed(lpParser);
 	return cjsonE_Ok;
 }
 static enum cjsonError cjsonParser_String_ProcessByte(
@@ -415,21 +581,24 @@ static enum cjsonError cjsonParser_String_ProcessByte(
 		}
 
 		/* End of string ... */
-		e = cjsonParserMallocHelper(lpParser, sizeof(struct cjsonString)+cjsonParser_BufferChain_Length(lpParser, &(lpStr->buf)), (void**)(&lpValue));
+		e = cjsonParserMallocHelper(lpParser, cjsonAllocSite__String, sizeof(struct cjsonString)+cjsonParser_BufferChain_Length(lpParser, &(lpStr->buf)), (void**)(&lpValue));
 		if(e != cjsonE_Ok) { return e; }
 
 		cjsonParser_BufferChain_MemcpyOut(lpParser, &(lpStr->buf), lpValue->bData, cjsonParser_BufferChain_Length(lpParser, &(lpStr->buf)));
 		lpValue->dwStrlen = cjsonParser_BufferChain_Length(lpParser, &(lpStr->buf));
 		lpValue->base.lpSystem = lpParser->lpSystem;
 		lpValue->base.type = cjsonString;
+		lpValue->base.dwRefCount = 1;
 
 		if(lpParser->lpChildResult != NULL) { cjsonReleaseValue(lpParser->lpChildResult); lpParser->lpChildResult = NULL; }
 		lpParser->lpChildResult = (struct cjsonValue*)lpValue;
+		lpParser->dwChildKeyHash = lpStr->buf.dwHash;
 
 		cjsonParser_BufferChain_Release(lpParser, &(lpStr->buf));
 		return cjsonParser_StateStackPop(lpParser);
 	} else if(lpStr->state == cjsonParser_StateStackElement_String_State__Escaped) {
 		switch(bData) {
+			case '"':		e = cjsonParser_BufferChain_PushByte(lpParser, &(lpStr->buf), '"'); lpStr->state = cjsonParser_StateStackElement_String_State__Normal; return e;
 			case '\\':		e = cjsonParser_BufferChain_PushByte(lpParser, &(lpStr->buf), '\\'); lpStr->state = cjsonParser_StateStackElement_String_State__Normal; return e;
 			case '/':		e = cjsonParser_BufferChain_PushByte(lpParser, &(lpStr->buf), '/'); lpStr->state = cjsonParser_StateStackElement_String_State__Normal; return e;
 			case 'b':		e = cjsonParser_BufferChain_PushByte(lpParser, &(lpStr->buf), '\b'); lpStr->state = cjsonParser_StateStackElement_String_State__Normal; return e;
@@ -503,8 +672,12 @@ static enum cjsonError cjsonParser_Number_Push(
 ) {
 	struct cjsonParser_StateStackElement_Number* lpNew;
 	enum cjsonError e;
+	unsigned long int dwSchemaNode;
 
-	e = cjsonParserMallocHelper(lpParser, sizeof(struct cjsonParser_StateStackElement_Number), (void**)(&lpNew));
+	e = cjsonParser_Schema_Start(lpParser, cjsonNumber_Double, &dwSchemaNode);
+	if(e != cjsonE_Ok) { return e; }
+
+	e = cjsonParser_StateAlloc(lpParser, cjsonParser_StateStackType__Number, sizeof(struct cjsonParser_StateStackElement_Number), (void**)(&lpNew));
 	if(e != cjsonE_Ok) { return e; }
 
 	lpNew->base.type = cjsonParser_StateStackType__Number;
@@ -518,6 +691,7 @@ static enum cjsonError cjsonParser_Number_Push(
 	lpNew->state = cjsonParser_StateStackElement_Number_State__FirstSymbol;
 
 	lpParser->lpStateStack = (struct cjsonParser_StateStackElement*)lpNew;
+	cjsonParser_StateStackPushed(lpParser);
 	return cjsonE_Ok;
 }
 static enum cjsonError cjsonParser_Number_ProcessByte(
@@ -605,7 +779,9 @@ static enum cjsonError cjsonParser_Number_ProcessByte(
 					if(e != cjsonE_Ok) { return e; }
 					cjsonNumber_SetDouble(lpParser->lpChildResult, lpState->currentValue.dDouble * (double)(lpState->dwSignBase));
 				}
-				cjsonParser_StateStackPop(lpParser);
+				/* Errors of the parent (schema violations, out of memory) abort, the end of a document doesn't */
+				e = cjsonParser_StateStackPop(lpParser);
+				if((e != cjsonE_Ok) && (e != cjsonE_Finished)) { return e; }
 				return cjsonE_OkRedeliver; /* Redeliver the symbol to the parent ... */
 			}
 		case cjsonParser_StateStackElement_Number_State__FractionalDigitsFirst:
@@ -632,7 +808,8 @@ static enum cjsonError cjsonParser_Number_ProcessByte(
 			e = cjsonNumber_Create(&(lpParser->lpChildResult), lpParser->lpSystem);
 			if(e != cjsonE_Ok) { return e; }
 			cjsonNumber_SetDouble(lpParser->lpChildResult, lpState->currentValue.dDouble * (double)(lpState->dwSignBase) * lpState->dCurrentMultiplier);
-			cjsonParser_StateStackPop(lpParser);
+			e = cjsonParser_StateStackPop(lpParser);
+			if((e != cjsonE_Ok) && (e != cjsonE_Finished)) { return e; }
 			return cjsonE_OkRedeliver;
 
 		case cjsonParser_StateStackElement_Number_State__ExponentFirst:
@@ -675,7 +852,8 @@ static enum cjsonError cjsonParser_Number_ProcessByte(
 				while(lpState->dwCurrentExponent > 0) { dTemp = dTemp / 10.0; lpState->dwCurrentExponent = lpState->dwCurrentExponent - 1; }
 			}
 			cjsonNumber_SetDouble(lpParser->lpChildResult, dTemp);
-			cjsonParser_StateStackPop(lpParser);
+			e = cjsonParser_StateStackPop(lpParser);
+			if((e != cjsonE_Ok) && (e != cjsonE_Finished)) { return e; }
 			return cjsonE_OkRedeliver;
 
 		default:
@@ -697,8 +875,12 @@ static enum cjsonError cjsonParser_Object_Push(
 ) {
 	enum cjsonError e;
 	struct cjsonParser_StateStackElement_Object* lpNewObj;
+	unsigned long int dwSchemaNode;
+
+	e = cjsonParser_Schema_Start(lpParser, cjsonObject, &dwSchemaNode);
+	if(e != cjsonE_Ok) { return e; }
 
-	e = cjsonParserMallocHelper(lpParser, sizeof(struct cjsonParser_StateStackElement_Object), (void**)(&lpNewObj));
+	e = cjsonParser_StateAlloc(lpParser, cjsonParser_StateStackType__Object, sizeof(struct cjsonParser_StateStackElement_Object), (void**)(&lpNewObj));
 	if(e != cjsonE_Ok) { return e; }
 
 	e = cjsonObject_Create(&(lpNewObj->lpObjectObject), lpParser->lpSystem);
@@ -715,7 +897,12 @@ static enum cjsonError cjsonParser_Object_Push(
 	lpNewObj->lpCurrentKey = NULL;
 	lpNewObj->dwCurrentKeyLength = 0;
 
+	lpNewObj->dwSchemaNode = dwSchemaNode;
+	lpNewObj->dwValueSchemaNode = CJSON_SCHEMA_NODE_ANY;
+	lpNewObj->qwRequiredSeen = 0;
+
 	lpParser->lpStateStack = (struct cjsonParser_StateStackElement*)lpNewObj;
+	cjsonParser_StateStackPushed(lpParser);
 	return cjsonE_Ok;
 }
 static enum cjsonError cjsonParser_Object_ProcessByte(
@@ -744,6 +931,10 @@ static enum cjsonError cjsonParser_Object_ProcessByte(
 			/* End of object */
 			case '}':
 				if(lpState->dwReadObjects == 0) {
+					if(lpState->dwSchemaNode != CJSON_SCHEMA_NODE_ANY) {
+						e = cjsonSchema_CheckRequired(lpParser->lpSchema, lpState->dwSchemaNode, lpState->qwRequiredSeen);
+						if(e != cjsonE_Ok) { return e; }
+					}
 					lpParser->lpChildResult = lpState->lpObjectObject;
 					return cjsonParser_StateStackPop(lpParser);
 				} else {
@@ -816,7 +1007,13 @@ static enum cjsonError cjsonParser_Object_ProcessByte(
 		*/
 		switch(bData) {
 			case ',':		lpState->state = cjsonParser_StateStackElement_Object_State__ExpectKey; return cjsonE_Ok;
-			case '}':		lpParser->lpChildResult = lpState->lpObjectObject; return cjsonParser_StateStackPop(lpParser);
+			case '}':
+				if(lpState->dwSchemaNode != CJSON_SCHEMA_NODE_ANY) {
+					e = cjsonSchema_CheckRequired(lpParser->lpSchema, lpState->dwSchemaNode, lpState->qwRequiredSeen);
+					if(e != cjsonE_Ok) { return e; }
+				}
+				lpParser->lpChildResult = lpState->lpObjectObject;
+				return cjsonParser_StateStackPop(lpParser);
 
 			/* Whitespace as specified */
 			case 0x09:		return cjsonE_Ok;
@@ -845,14 +1042,21 @@ static enum cjsonError cjsonParser_Object_PopNotify(
 	if(lpState->state == cjsonParser_StateStackElement_Object_State__ReadKey) {
 		/* The child object is a jsonValue that contains a string. This will be used as key */
 		lpState->dwCurrentKeyLength = cjsonString_Strlen(lpParser->lpChildResult);
-		e = cjsonParserMallocHelper(lpParser, sizeof(char)*lpState->dwCurrentKeyLength, (void**)(&(lpState->lpCurrentKey)));
+		e = cjsonParserMallocHelper(lpParser, cjsonAllocSite__ParserBuffer, sizeof(char)*lpState->dwCurrentKeyLength, (void**)(&(lpState->lpCurrentKey)));
 		if(e != cjsonE_Ok) { return e; }
 		memcpy(lpState->lpCurrentKey, cjsonString_Get(lpParser->lpChildResult), lpState->dwCurrentKeyLength);
+		lpState->dwCurrentKeyHash = lpParser->dwChildKeyHash;
 		cjsonReleaseValue(lpParser->lpChildResult); lpParser->lpChildResult = NULL;
+		if(lpState->dwSchemaNode != CJSON_SCHEMA_NODE_ANY) {
+			return cjsonSchema_CheckKey(lpParser->lpSchema, lpState->dwSchemaNode, lpState->lpCurrentKey, lpState->dwCurrentKeyLength, &(lpState->dwValueSchemaNode), &(lpState->qwRequiredSeen));
+		}
 		return cjsonE_Ok;
 	} else if(lpState->state == cjsonParser_StateStackElement_Object_State__ReadObject) {
 		/* The child object is anything ... */
-		e = cjsonObject_Set(lpState->lpObjectObject, lpState->lpCurrentKey, lpState->dwCurrentKeyLength, lpParser->lpChildResult);
+		e = cjsonParser_Schema_End(lpParser, lpState->dwValueSchemaNode);
+		if(e == cjsonE_Ok) {
+			e = cjsonObject_SetPrehashed(lpState->lpObjectObject, lpState->lpCurrentKey, lpState->dwCurrentKeyLength, lpState->dwCurrentKeyHash, lpParser->lpChildResult);
+		}
 		cjsonParserFreeHelper(lpParser, (void*)(lpState->lpCurrentKey));
 		lpState->lpCurrentKey = NULL; lpState->dwCurrentKeyLength = 0;
 		if(e != cjsonE_Ok) {
@@ -873,13 +1077,18 @@ static enum cjsonError cjsonParser_Array_Push(
 ) {
 	enum cjsonError e;
 	struct cjsonParser_StateStackElement_Array* lpNew;
+	unsigned long int dwSchemaNode;
 
-	e = cjsonParserMallocHelper(lpParser, sizeof(struct cjsonParser_StateStackElement_Array), (void**)(&lpNew));
+	e = cjsonParser_Schema_Start(lpParser, cjsonArray, &dwSchemaNode);
+	if(e != cjsonE_Ok) { return e; }
+
+	e = cjsonParser_StateAlloc(lpParser, cjsonParser_StateStackType__Array, sizeof(struct cjsonParser_StateStackElement_Array), (void**)(&lpNew));
 	if(e != cjsonE_Ok) { return e; }
 
 	lpNew->base.type = cjsonParser_StateStackType__Array;
 	lpNew->base.lpNext = lpParser->lpStateStack;
 	lpNew->state = cjsonParser_StateStackElement_Array_State_NoComma;
+	lpNew->dwItemsSchemaNode = (dwSchemaNode == CJSON_SCHEMA_NODE_ANY) ? CJSON_SCHEMA_NODE_ANY : cjsonSchema_Items(lpParser->lpSchema, dwSchemaNode);
 
 	e = cjsonArray_Create(&(lpNew->lpArrayObject), lpParser->lpSystem);
 	if(e != cjsonE_Ok) {
@@ -888,6 +1097,7 @@ static enum cjsonError cjsonParser_Array_Push(
 	}
 
 	lpParser->lpStateStack = (struct cjsonParser_StateStackElement*)lpNew;
+	cjsonParser_StateStackPushed(lpParser);
 	return cjsonE_Ok;
 }
 static enum cjsonError cjsonParser_Array_ProcessByte(
@@ -982,6 +1192,12 @@ static enum cjsonError cjsonParser_Array_PopNotify(
 	/* A chlid has been parsed ... put it into our array */
 	lpStackElm = (struct cjsonParser_StateStackElement_Array*)(lpParser->lpStateStack);
 	if(lpParser->lpChildResult != NULL) {
+		e = cjsonParser_Schema_End(lpParser, lpStackElm->dwItemsSchemaNode);
+		if(e != cjsonE_Ok) {
+			cjsonReleaseValue(lpParser->lpChildResult);
+			lpParser->lpChildResult = NULL;
+			return e;
+		}
 		e = cjsonArray_Push(lpStackElm->lpArrayObject, lpParser->lpChildResult);
 		lpParser->lpChildResult = NULL;
 		return e;
@@ -1003,11 +1219,12 @@ enum cjsonError cjsonParserCreate(
 ) {
 	enum cjsonError e;
 	struct cjsonParser* lpNew;
+	unsigned long int i;
 
 	if(lpOut == NULL) { return cjsonE_InvalidParam; }
 	(*lpOut) = NULL;
 
-	if((dwFlags & ~(CJSON_PARSER_FLAG__STREAMINGMODE|CJSON_PARSER_FLAG__ALLOWDUPLICATEKEYS)) != 0) { return cjsonE_InvalidParam; }
+	if((dwFlags & ~(CJSON_PARSER_FLAG__STREAMINGMODE|CJSON_PARSER_FLAG__ALLOWDUPLICATEKEYS|CJSON_PARSER_FLAG__STATISTICS)) != 0) { return cjsonE_InvalidParam; }
 	if(((dwFlags & CJSON_PARSER_FLAG__STREAMINGMODE) != 0) && (callbackDocumentRead == NULL)) { return cjsonE_InvalidParam; }
 
 	if(lpSystem == NULL) {
@@ -1021,10 +1238,17 @@ enum cjsonError cjsonParserCreate(
 	lpNew->lpStateStack = NULL;
 	lpNew->dwStateStackDepth = 0;
 	lpNew->lpChildResult = NULL;
+	lpNew->dwChildKeyHash = CJSON_OBJECT_HASH_INIT;
 	lpNew->dwFlags = dwFlags;
 	lpNew->lpSystem = lpSystem;
 	lpNew->callbackDocumentReady = callbackDocumentRead;
 	lpNew->callbackDocumentReadyFreeParam = callbackDocumentReadyFreeParam;
+	lpNew->lpSchema = NULL;
+	memset(&(lpNew->stats), 0, sizeof(lpNew->stats));
+	for(i = 0; i < cjsonParser_StateStackType__Count; i=i+1) { lpNew->lpFreeStates[i] = NULL; }
+	lpNew->lpFreePages = NULL;
+	lpNew->dwFreePages = 0;
+	lpNew->lpPoolNext = NULL;
 
 	(*lpOut) = lpNew;
 	return cjsonE_Ok;
@@ -1034,13 +1258,24 @@ enum cjsonError cjsonParserProcessByte(
 	char bByte
 ) {
 	enum cjsonError e;
+	#ifdef CJSON_PARSER_CYCLECOUNTERS
+		unsigned long int dwHandler;
+		uint64_t qwStart;
+	#endif
 
 	/* Pass to current stack element - if any; the element MAY return an ok-redeliver (used internally) */
 	if((bByte != 0x09) && (bByte != 0x0A) && (bByte != 0x0D) && (bByte != 0x20)) {
 		if((lpParser->dwFlags & CJSON_PARSER_FLAG__INTERNAL_DONE) != 0) { return cjsonE_AlreadyFinished; }
 	}
+	if((lpParser->dwFlags & CJSON_PARSER_FLAG__STATISTICS) != 0) {
+		lpParser->stats.qwBytes = lpParser->stats.qwBytes + 1;
+	}
 
 	for(;;) {
+		#ifdef CJSON_PARSER_CYCLECOUNTERS
+			dwHandler = (lpParser->lpStateStack == NULL) ? CJSON_PARSER_STATS_HANDLER_UNIVERSE : (unsigned long int)lpParser->lpStateStack->type;
+			qwStart = cjsonParser_Cycles();
+		#endif
 		if(lpParser->lpStateStack == NULL) {
 			e = cjsonParser_Universe_ProcessByte(lpParser, bByte);
 		} else {
@@ -1053,22 +1288,56 @@ enum cjsonError cjsonParserProcessByte(
 				default:									return cjsonE_ImplementationError;
 			}
 		}
-		if(e == cjsonE_OkRedeliver) { continue; }
+		#ifdef CJSON_PARSER_CYCLECOUNTERS
+			if((lpParser->dwFlags & CJSON_PARSER_FLAG__STATISTICS) != 0) {
+				lpParser->stats.qwHandlerCycles[dwHandler] = lpParser->stats.qwHandlerCycles[dwHandler] + (cjsonParser_Cycles() - qwStart);
+				lpParser->stats.qwHandlerCalls[dwHandler] = lpParser->stats.qwHandlerCalls[dwHandler] + 1;
+			}
+		#endif
+		if(e == cjsonE_OkRedeliver) {
+			if((lpParser->dwFlags & CJSON_PARSER_FLAG__STATISTICS) != 0) {
+				lpParser->stats.qwRedeliveries = lpParser->stats.qwRedeliveries + 1;
+			}
+			continue;
+		}
 		break;
 	}
 	return e;
 }
 
-enum cjsonError cjsonParserRelease(
+enum cjsonError cjsonParser_GetStats(
+	const struct cjsonParser* lpParser,
+	struct cjsonParser_Stats* lpStatsOut
+) {
+	if((lpParser == NULL) || (lpStatsOut == NULL)) { return cjsonE_InvalidParam; }
+	if((lpParser->dwFlags & CJSON_PARSER_FLAG__STATISTICS) == 0) { return cjsonE_InvalidState; }
+
+	memcpy(lpStatsOut, &(lpParser->stats), sizeof(struct cjsonParser_Stats));
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonParserSetSchema(
+	struct cjsonParser* lpParser,
+	const struct cjsonSchema* lpSchema
+) {
+	if(lpParser == NULL) { return cjsonE_InvalidParam; }
+
+	/* Switching in the middle of a document would mix node tables */
+	if(lpParser->lpStateStack != NULL) { return cjsonE_InvalidState; }
+
+	lpParser->lpSchema = lpSchema;
+	return cjsonE_Ok;
+}
+
+/*
+	Drops a partially parsed document. The state stack elements and
+	string pages are recycled into the free lists.
+*/
+static enum cjsonError cjsonParser_DropStateStack(
 	struct cjsonParser* lpParser
 ) {
 	struct cjsonParser_StateStackElement* lpCurrentStack;
 	struct cjsonParser_StateStackElement* lpNextStack;
-	/*
-		If there is nothing to release we always signal
-		success ...
-	*/
-	if(lpParser == NULL) { return cjsonE_Ok; }
 
 	/* Release any dangling result */
 	if(lpParser->lpChildResult != NULL) {
@@ -1110,13 +1379,60 @@ enum cjsonError cjsonParserRelease(
 				return cjsonE_ImplementationError;
 		}
 
-		/* Release the descriptor */
-		cjsonParserFreeHelper(lpParser, (void*)lpCurrentStack);
+		/* Recycle the descriptor */
+		cjsonParser_StateRecycle(lpParser, lpCurrentStack);
 
 		/* And iterate ... */
 		lpCurrentStack = lpNextStack;
 	}
 	lpParser->lpStateStack = NULL;
+	lpParser->dwStateStackDepth = 0;
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonParserReset(
+	struct cjsonParser* lpParser
+) {
+	enum cjsonError e;
+
+	if(lpParser == NULL) { return cjsonE_InvalidParam; }
+
+	e = cjsonParser_DropStateStack(lpParser);
+	if(e != cjsonE_Ok) { return e; }
+
+	lpParser->dwFlags = lpParser->dwFlags & ~CJSON_PARSER_FLAG__INTERNAL_DONE;
+	memset(&(lpParser->stats), 0, sizeof(lpParser->stats));
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonParserRelease(
+	struct cjsonParser* lpParser
+) {
+	struct cjsonParser_StateStackElement* lpCurrentStack;
+	struct cjsonParser_BufferChain_Entry* lpCurrentPage;
+	enum cjsonError e;
+	unsigned long int i;
+	/*
+		If there is nothing to release we always signal
+		success ...
+	*/
+	if(lpParser == NULL) { return cjsonE_Ok; }
+
+	e = cjsonParser_DropStateStack(lpParser);
+	if(e != cjsonE_Ok) { return e; }
+
+	/* Now everything is in the free lists */
+	for(i = 0; i < cjsonParser_StateStackType__Count; i=i+1) {
+		while((lpCurrentStack = lpParser->lpFreeStates[i]) != NULL) {
+			lpParser->lpFreeStates[i] = lpCurrentStack->lpNext;
+			cjsonParserFreeHelper(lpParser, (void*)lpCurrentStack);
+		}
+	}
+	while((lpCurrentPage = lpParser->lpFreePages) != NULL) {
+		lpParser->lpFreePages = lpCurrentPage->lpNext;
+		cjsonParserFreeHelper(lpParser, (void*)lpCurrentPage);
+	}
+	lpParser->dwFreePages = 0;
 
 	cjsonParserFreeHelper(lpParser, (void*)lpParser);
 	return cjsonE_Ok;
@@ -0,0 +1,157 @@
+#ifndef _POSIX_C_SOURCE
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_PARSERPOOL_MAXPARSERS
+	#define CJSON_PARSERPOOL_MAXPARSERS 4				/* Parsers cached per thread, additional returned parsers are released */
+#endif
+
+/*
+	Every thread owns a list of reset parsers. The list head is
+	created on first use and released together with the cached
+	parsers by the thread specific data destructor.
+*/
+struct cjsonParserPool_Thread {
+	struct cjsonParser*							lpFirst;
+	unsigned long int							dwCount;
+};
+
+static pthread_once_t cjsonParserPool_KeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t cjsonParserPool_Key;
+static int cjsonParserPool_KeyValid = 0;
+
+static void cjsonParserPool_ReleaseThread(
+	void* lpParam
+) {
+	struct cjsonParserPool_Thread* lpThread = (struct cjsonParserPool_Thread*)lpParam;
+	struct cjsonParser* lpParser;
+
+	if(lpThread == NULL) { return; }
+	while((lpParser = lpThread->lpFirst) != NULL) {
+		lpThread->lpFirst = lpParser->lpPoolNext;
+		lpParser->lpPoolNext = NULL;
+		cjsonParserRelease(lpParser);
+	}
+	free(lpThread);
+}
+static void cjsonParserPool_CreateKey(void) {
+	if(pthread_key_create(&cjsonParserPool_Key, &cjsonParserPool_ReleaseThread) == 0) {
+		cjsonParserPool_KeyValid = 1;
+	}
+}
+static struct cjsonParserPool_Thread* cjsonParserPool_GetThread(
+	int bCreate
+) {
+	struct cjsonParserPool_Thread* lpThread;
+
+	pthread_once(&cjsonParserPool_KeyOnce, &cjsonParserPool_CreateKey);
+	if(cjsonParserPool_KeyValid == 0) { return NULL; }
+
+	lpThread = (struct cjsonParserPool_Thread*)pthread_getspecific(cjsonParserPool_Key);
+	if((lpThread == NULL) && (bCreate != 0)) {
+		lpThread = (struct cjsonParserPool_Thread*)malloc(sizeof(struct cjsonParserPool_Thread));
+		if(lpThread == NULL) { return NULL; }
+		lpThread->lpFirst = NULL;
+		lpThread->dwCount = 0;
+		if(pthread_setspecific(cjsonParserPool_Key, (void*)lpThread) != 0) {
+			free(lpThread);
+			return NULL;
+		}
+	}
+	return lpThread;
+}
+
+enum cjsonError cjsonParserPool_Acquire(
+	struct cjsonParser** lpOut,
+	uint32_t dwFlags,
+
+	lpfnCJSONCallback_DocumentReady callbackDocumentReady,
+	void* callbackDocumentReadyFreeParam,
+
+	struct cjsonSystemAPI* lpSystem
+) {
+	struct cjsonParserPool_Thread* lpThread;
+	struct cjsonParser* lpParser;
+	struct cjsonParser* lpPrev;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+
+	if((dwFlags & ~(CJSON_PARSER_FLAG__STREAMINGMODE|CJSON_PARSER_FLAG__ALLOWDUPLICATEKEYS|CJSON_PARSER_FLAG__STATISTICS)) != 0) { return cjsonE_InvalidParam; }
+	if(((dwFlags & CJSON_PARSER_FLAG__STREAMINGMODE) != 0) && (callbackDocumentReady == NULL)) { return cjsonE_InvalidParam; }
+
+	lpThread = cjsonParserPool_GetThread(0);
+	if(lpThread != NULL) {
+		lpPrev = NULL;
+		for(lpParser = lpThread->lpFirst; lpParser != NULL; lpParser = lpParser->lpPoolNext) {
+			if(lpParser->lpSystem == lpSystem) {
+				if(lpPrev == NULL) {
+					lpThread->lpFirst = lpParser->lpPoolNext;
+				} else {
+					lpPrev->lpPoolNext = lpParser->lpPoolNext;
+				}
+				lpThread->dwCount = lpThread->dwCount - 1;
+
+				/* Cached parsers have been reset when they were returned */
+				lpParser->lpPoolNext = NULL;
+				lpParser->dwFlags = dwFlags;
+				lpParser->callbackDocumentReady = callbackDocumentReady;
+				lpParser->callbackDocumentReadyFreeParam = callbackDocumentReadyFreeParam;
+				lpParser->lpSchema = NULL;
+
+				(*lpOut) = lpParser;
+				return cjsonE_Ok;
+			}
+			lpPrev = lpParser;
+		}
+	}
+
+	return cjsonParserCreate(lpOut, dwFlags, callbackDocumentReady, callbackDocumentReadyFreeParam, lpSystem);
+}
+
+enum cjsonError cjsonParserPool_Return(
+	struct cjsonParser* lpParser
+) {
+	struct cjsonParserPool_Thread* lpThread;
+	enum cjsonError e;
+
+	if(lpParser == NULL) { return cjsonE_InvalidParam; }
+
+	e = cjsonParserReset(lpParser);
+	if(e != cjsonE_Ok) {
+		cjsonParserRelease(lpParser);
+		return e;
+	}
+
+	lpThread = cjsonParserPool_GetThread(1);
+	if((lpThread == NULL) || (lpThread->dwCount >= CJSON_PARSERPOOL_MAXPARSERS)) {
+		return cjsonParserRelease(lpParser);
+	}
+
+	lpParser->lpPoolNext = lpThread->lpFirst;
+	lpThread->lpFirst = lpParser;
+	lpThread->dwCount = lpThread->dwCount + 1;
+	return cjsonE_Ok;
+}
+
+void cjsonParserPool_Flush(void) {
+	struct cjsonParserPool_Thread* lpThread;
+
+	lpThread = cjsonParserPool_GetThread(0);
+	if(lpThread == NULL) { return; }
+
+	pthread_setspecific(cjsonParserPool_Key, NULL);
+	cjsonParserPool_ReleaseThread((void*)lpThread);
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
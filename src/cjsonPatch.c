@@ -0,0 +1,1082 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <stdio.h>	/* used for snprintf */
+#include <string.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_PATCH_TOKENBUFFER
+	#define CJSON_PATCH_TOKENBUFFER 256				/* Pointers up to this length are decoded without allocation */
+#endif
+#ifndef CJSON_DIFF_LCSMAXCELLS
+	#define CJSON_DIFF_LCSMAXCELLS 1048576			/* Largest array section (elements A * elements B) diffed by LCS */
+#endif
+#ifndef CJSON_MERGEPATCH_STACKSEGMENT
+	#define CJSON_MERGEPATCH_STACKSEGMENT 32		/* Frames per segment of the merge patch stack */
+#endif
+#ifndef CJSON_DIFF_HASHSEED
+	#define CJSON_DIFF_HASHSEED 0x6a09e667f3bcc909ULL
+#endif
+
+/*
+	JSON pointer (RFC 6901) handling. Tokens are decoded into a
+	buffer that is at least as long as the whole pointer.
+*/
+static enum cjsonError cjsonPatch_NextToken(
+	const char* lpPath,
+	unsigned long int dwPathLength,
+	unsigned long int* lpPosition,
+	char* lpToken,
+	unsigned long int* lpTokenLength
+) {
+	unsigned long int dwPos = (*lpPosition);
+	unsigned long int dwLen = 0;
+
+	if((dwPos >= dwPathLength) || (lpPath[dwPos] != '/')) { return cjsonE_InvalidParam; }
+	dwPos = dwPos + 1;
+
+	while((dwPos < dwPathLength) && (lpPath[dwPos] != '/')) {
+		if(lpPath[dwPos] == '~') {
+			if(dwPos + 1 >= dwPathLength) { return cjsonE_InvalidParam; }
+			if(lpPath[dwPos+1] == '0') { lpToken[dwLen] = '~'; }
+			else if(lpPath[dwPos+1] == '1') { lpToken[dwLen] = '/'; }
+			else { return cjsonE_InvalidParam; }
+			dwPos = dwPos + 2;
+		} else {
+			lpToken[dwLen] = lpPath[dwPos];
+			dwPos = dwPos + 1;
+		}
+		dwLen = dwLen + 1;
+	}
+
+	(*lpPosition) = dwPos;
+	(*lpTokenLength) = dwLen;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonPatch_ParseIndex(
+	const char* lpToken,
+	unsigned long int dwTokenLength,
+	unsigned long int* lpIndexOut
+) {
+	unsigned long int i;
+	unsigned long int dwIndex = 0;
+
+	if(dwTokenLength == 0) { return cjsonE_InvalidParam; }
+	if((dwTokenLength > 1) && (lpToken[0] == '0')) { return cjsonE_InvalidParam; } /* No leading zeros */
+
+	for(i = 0; i < dwTokenLength; i=i+1) {
+		if((lpToken[i] < '0') || (lpToken[i] > '9')) { return cjsonE_InvalidParam; }
+		if(dwIndex > (~0UL - 9) / 10) { return cjsonE_IndexOutOfBounds; }
+		dwIndex = dwIndex * 10 + (unsigned long int)(lpToken[i] - '0');
+	}
+
+	(*lpIndexOut) = dwIndex;
+	return cjsonE_Ok;
+}
+
+/*
+	Looks up a single token. Mutable lookups unshare the child
+	so it can be modified in place.
+*/
+static enum cjsonError cjsonPatch_Child(
+	struct cjsonValue* lpContainer,
+	const char* lpToken,
+	unsigned long int dwTokenLength,
+	int bMutable,
+	struct cjsonValue** lpChildOut
+) {
+	enum cjsonError e;
+	unsigned long int dwIndex;
+
+	if(lpContainer->type == cjsonObject) {
+		if(bMutable != 0) { return cjsonObject_GetMutable(lpContainer, lpToken, dwTokenLength, lpChildOut); }
+		return cjsonObject_Get(lpContainer, lpToken, dwTokenLength, lpChildOut);
+	} else if(lpContainer->type == cjsonArray) {
+		e = cjsonPatch_ParseIndex(lpToken, dwTokenLength, &dwIndex);
+		if(e != cjsonE_Ok) { return e; }
+		if(bMutable != 0) { return cjsonArray_GetMutable(lpContainer, dwIndex, lpChildOut); }
+		return cjsonArray_Get(lpContainer, dwIndex, lpChildOut);
+	}
+	return cjsonE_IndexOutOfBounds;
+}
+
+/*
+	Resolves all but the last token of a non empty pointer. The
+	last token is returned in the token buffer.
+*/
+static enum cjsonError cjsonPatch_ResolveParent(
+	struct cjsonValue* lpRoot,
+	const char* lpPath,
+	unsigned long int dwPathLength,
+	int bMutable,
+	char* lpToken,
+	unsigned long int* lpTokenLength,
+	struct cjsonValue** lpParentOut
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpCur = lpRoot;
+	unsigned long int dwPos = 0;
+
+	e = cjsonPatch_NextToken(lpPath, dwPathLength, &dwPos, lpToken, lpTokenLength);
+	if(e != cjsonE_Ok) { return e; }
+
+	while(dwPos < dwPathLength) {
+		e = cjsonPatch_Child(lpCur, lpToken, (*lpTokenLength), bMutable, &lpCur);
+		if(e != cjsonE_Ok) { return e; }
+		if(lpCur == NULL) { return cjsonE_IndexOutOfBounds; }
+
+		e = cjsonPatch_NextToken(lpPath, dwPathLength, &dwPos, lpToken, lpTokenLength);
+		if(e != cjsonE_Ok) { return e; }
+	}
+
+	if((lpCur->type != cjsonObject) && (lpCur->type != cjsonArray)) { return cjsonE_IndexOutOfBounds; }
+
+	(*lpParentOut) = lpCur;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonPatch_Get(
+	struct cjsonValue* lpRoot,
+	const char* lpPath,
+	unsigned long int dwPathLength,
+	char* lpToken,
+	struct cjsonValue** lpOut
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpParent;
+	unsigned long int dwTokenLength;
+
+	if(dwPathLength == 0) { (*lpOut) = lpRoot; return cjsonE_Ok; }
+
+	e = cjsonPatch_ResolveParent(lpRoot, lpPath, dwPathLength, 0, lpToken, &dwTokenLength, &lpParent);
+	if(e != cjsonE_Ok) { return e; }
+
+	e = cjsonPatch_Child(lpParent, lpToken, dwTokenLength, 0, lpOut);
+	if(e != cjsonE_Ok) { return e; }
+	return ((*lpOut) == NULL) ? cjsonE_IndexOutOfBounds : cjsonE_Ok;
+}
+
+/*
+	Stores a value we own at the location. On failure the caller
+	still owns the value.
+*/
+static enum cjsonError cjsonPatch_AddOwned(
+	struct cjsonValue** lpTarget,
+	const char* lpPath,
+	unsigned long int dwPathLength,
+	char* lpToken,
+	struct cjsonValue* lpValue
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpParent;
+	unsigned long int dwTokenLength;
+	unsigned long int dwIndex;
+
+	if(dwPathLength == 0) {
+		cjsonReleaseValue(*lpTarget);
+		(*lpTarget) = lpValue;
+		return cjsonE_Ok;
+	}
+
+	e = cjsonPatch_ResolveParent((*lpTarget), lpPath, dwPathLength, 1, lpToken, &dwTokenLength, &lpParent);
+	if(e != cjsonE_Ok) { return e; }
+
+	if(lpParent->type == cjsonObject) {
+		return cjsonObject_Set(lpParent, lpToken, dwTokenLength, lpValue);
+	}
+
+	if((dwTokenLength == 1) && (lpToken[0] == '-')) {
+		dwIndex = cjsonArray_Length(lpParent);
+	} else {
+		e = cjsonPatch_ParseIndex(lpToken, dwTokenLength, &dwIndex);
+		if(e != cjsonE_Ok) { return e; }
+	}
+	return cjsonArray_Insert(lpParent, dwIndex, lpValue);
+}
+static enum cjsonError cjsonPatch_Replace(
+	struct cjsonValue** lpTarget,
+	const char* lpPath,
+	unsigned long int dwPathLength,
+	char* lpToken,
+	struct cjsonValue* lpValue
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpParent;
+	unsigned long int dwTokenLength;
+	unsigned long int dwIndex;
+
+	if(dwPathLength == 0) {
+		cjsonReleaseValue(*lpTarget);
+		(*lpTarget) = lpValue;
+		return cjsonE_Ok;
+	}
+
+	e = cjsonPatch_ResolveParent((*lpTarget), lpPath, dwPathLength, 1, lpToken, &dwTokenLength, &lpParent);
+	if(e != cjsonE_Ok) { return e; }
+
+	if(lpParent->type == cjsonObject) {
+		e = cjsonObject_HasKey(lpParent, lpToken, dwTokenLength);
+		if(e != cjsonE_Ok) { return e; }
+		return cjsonObject_Set(lpParent, lpToken, dwTokenLength, lpValue);
+	}
+
+	e = cjsonPatch_ParseIndex(lpToken, dwTokenLength, &dwIndex);
+	if(e != cjsonE_Ok) { return e; }
+	return cjsonArray_Set(lpParent, dwIndex, lpValue);
+}
+static enum cjsonError cjsonPatch_Remove(
+	struct cjsonValue** lpTarget,
+	const char* lpPath,
+	unsigned long int dwPathLength,
+	char* lpToken,
+	struct cjsonValue** lpDetachedOut		/* Released if NULL */
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpParent;
+	unsigned long int dwTokenLength;
+	unsigned long int dwIndex;
+
+	if(dwPathLength == 0) { return cjsonE_InvalidParam; }
+
+	e = cjsonPatch_ResolveParent((*lpTarget), lpPath, dwPathLength, 1, lpToken, &dwTokenLength, &lpParent);
+	if(e != cjsonE_Ok) { return e; }
+
+	if(lpParent->type == cjsonObject) {
+		return cjsonObject_Remove(lpParent, lpToken, dwTokenLength, lpDetachedOut);
+	}
+
+	e = cjsonPatch_ParseIndex(lpToken, dwTokenLength, &dwIndex);
+	if(e != cjsonE_Ok) { return e; }
+	return cjsonArray_Remove(lpParent, dwIndex, lpDetachedOut);
+}
+
+/*
+	Checks if the first pointer references a proper ancestor of the
+	location referenced by the second one
+*/
+static inline int cjsonPatch_IsAncestor(
+	const char* lpAncestor,
+	unsigned long int dwAncestorLength,
+	const char* lpPath,
+	unsigned long int dwPathLength
+) {
+	if(dwPathLength <= dwAncestorLength) { return 0; }
+	if(memcmp(lpAncestor, lpPath, dwAncestorLength) != 0) { return 0; }
+	return (lpPath[dwAncestorLength] == '/') ? 1 : 0;
+}
+
+static int cjsonPatch_IsOp(
+	const struct cjsonValue* lpOp,
+	const char* lpName
+) {
+	unsigned long int dwLength = strlen(lpName);
+	return ((((const struct cjsonString*)lpOp)->dwStrlen == dwLength) && (memcmp(((const struct cjsonString*)lpOp)->bData, lpName, dwLength) == 0)) ? 1 : 0;
+}
+
+static enum cjsonError cjsonPatch_ApplyOperation(
+	struct cjsonValue** lpTarget,
+	struct cjsonValue* lpOperation,
+	char* lpToken
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpOp;
+	struct cjsonValue* lpPath;
+	struct cjsonValue* lpFrom;
+	struct cjsonValue* lpValue;
+	struct cjsonValue* lpDetached;
+	const char* lpPathData;
+	const char* lpFromData;
+	unsigned long int dwPathLength;
+	unsigned long int dwFromLength;
+
+	if((lpOperation == NULL) || (lpOperation->type != cjsonObject)) { return cjsonE_InvalidParam; }
+
+	if((cjsonObject_Get(lpOperation, "op", 2, &lpOp) != cjsonE_Ok) || (lpOp->type != cjsonString)) { return cjsonE_InvalidParam; }
+	if((cjsonObject_Get(lpOperation, "path", 4, &lpPath) != cjsonE_Ok) || (lpPath->type != cjsonString)) { return cjsonE_InvalidParam; }
+	if(cjsonObject_Get(lpOperation, "value", 5, &lpValue) != cjsonE_Ok) { lpValue = NULL; }
+	if(cjsonObject_Get(lpOperation, "from", 4, &lpFrom) != cjsonE_Ok) { lpFrom = NULL; }
+
+	lpPathData = ((struct cjsonString*)lpPath)->bData;
+	dwPathLength = ((struct cjsonString*)lpPath)->dwStrlen;
+
+	if(cjsonPatch_IsOp(lpOp, "test") != 0) {
+		if(lpValue == NULL) { return cjsonE_InvalidParam; }
+		e = cjsonPatch_Get((*lpTarget), lpPathData, dwPathLength, lpToken, &lpDetached);
+		if(e != cjsonE_Ok) { return e; }
+		return (cjsonValue_Equals(lpDetached, lpValue) != 0) ? cjsonE_Ok : cjsonE_TestFailed;
+	}
+	if(cjsonPatch_IsOp(lpOp, "remove") != 0) {
+		return cjsonPatch_Remove(lpTarget, lpPathData, dwPathLength, lpToken, NULL);
+	}
+	if((cjsonPatch_IsOp(lpOp, "add") != 0) || (cjsonPatch_IsOp(lpOp, "replace") != 0)) {
+		if(lpValue == NULL) { return cjsonE_InvalidParam; }
+
+		/* Values are shared with the patch instead of being copied */
+		cjsonValue_Retain(lpValue);
+		if(cjsonPatch_IsOp(lpOp, "add") != 0) {
+			e = cjsonPatch_AddOwned(lpTarget, lpPathData, dwPathLength, lpToken, lpValue);
+		} else {
+			e = cjsonPatch_Replace(lpTarget, lpPathData, dwPathLength, lpToken, lpValue);
+		}
+		if(e != cjsonE_Ok) { cjsonReleaseValue(lpValue); }
+		return e;
+	}
+
+	if((lpFrom == NULL) || (lpFrom->type != cjsonString)) { return cjsonE_InvalidParam; }
+	lpFromData = ((struct cjsonString*)lpFrom)->bData;
+	dwFromLength = ((struct cjsonString*)lpFrom)->dwStrlen;
+
+	if(cjsonPatch_IsOp(lpOp, "copy") != 0) {
+		e = cjsonPatch_Get((*lpTarget), lpFromData, dwFromLength, lpToken, &lpDetached);
+		if(e != cjsonE_Ok) { return e; }
+
+		/*
+			Copying a value into one of its children stores a private
+			(shallow) copy, storing the value itself would create a cycle
+		*/
+		cjsonValue_Retain(lpDetached);
+		if(cjsonPatch_IsAncestor(lpFromData, dwFromLength, lpPathData, dwPathLength) != 0) {
+			e = cjsonValue_Unshare(&lpDetached);
+			if(e != cjsonE_Ok) { cjsonReleaseValue(lpDetached); return e; }
+		}
+		e = cjsonPatch_AddOwned(lpTarget, lpPathData, dwPathLength, lpToken, lpDetached);
+		if(e != cjsonE_Ok) { cjsonReleaseValue(lpDetached); }
+		return e;
+	}
+	if(cjsonPatch_IsOp(lpOp, "move") != 0) {
+		if((dwFromLength == dwPathLength) && (memcmp(lpFromData, lpPathData, dwPathLength) == 0)) { return cjsonE_Ok; }
+
+		/* A value cannot be moved into one of its children */
+		if(cjsonPatch_IsAncestor(lpFromData, dwFromLength, lpPathData, dwPathLength) != 0) { return cjsonE_InvalidParam; }
+
+		e = cjsonPatch_Remove(lpTarget, lpFromData, dwFromLength, lpToken, &lpDetached);
+		if(e != cjsonE_Ok) { return e; }
+
+		e = cjsonPatch_AddOwned(lpTarget, lpPathData, dwPathLength, lpToken, lpDetached);
+		if(e != cjsonE_Ok) { cjsonReleaseValue(lpDetached); }
+		return e;
+	}
+
+	return cjsonE_InvalidParam;
+}
+
+/*
+	Applies all operations in order. Operations modify the target in
+	place, values are shared with the patch document. Processing stops
+	at the first failing operation, previous operations stay applied.
+*/
+enum cjsonError cjsonPatch_Apply(
+	struct cjsonValue** lpTarget,
+	struct cjsonValue* lpPatch
+) {
+	enum cjsonError e;
+	struct cjsonArray_Page* lpPage;
+	unsigned long int i;
+	unsigned long int dwMaxPath;
+	struct cjsonValue* lpMember;
+	char bTokenBuffer[CJSON_PATCH_TOKENBUFFER];
+	char* lpToken;
+	struct cjsonSystemAPI* lpScratchSystem;
+
+	if(lpTarget == NULL) { return cjsonE_InvalidParam; }
+	if((*lpTarget) == NULL) { return cjsonE_InvalidParam; }
+	if(lpPatch == NULL) { return cjsonE_InvalidParam; }
+	if(lpPatch->type != cjsonArray) { return cjsonE_InvalidParam; }
+
+	/* Determine the longest pointer so a single token buffer suffices */
+	dwMaxPath = 0;
+	for(lpPage = ((struct cjsonArray*)lpPatch)->pageList.lpFirstPage; lpPage != NULL; lpPage = lpPage->pageList.lpNext) {
+		for(i = 0; i < lpPage->dwUsedEntries; i=i+1) {
+			if((lpPage->entries[i] == NULL) || (lpPage->entries[i]->type != cjsonObject)) { return cjsonE_InvalidParam; }
+			if((cjsonObject_Get(lpPage->entries[i], "path", 4, &lpMember) == cjsonE_Ok) && (lpMember->type == cjsonString)) {
+				if(((struct cjsonString*)lpMember)->dwStrlen > dwMaxPath) { dwMaxPath = ((struct cjsonString*)lpMember)->dwStrlen; }
+			}
+			if((cjsonObject_Get(lpPage->entries[i], "from", 4, &lpMember) == cjsonE_Ok) && (lpMember->type == cjsonString)) {
+				if(((struct cjsonString*)lpMember)->dwStrlen > dwMaxPath) { dwMaxPath = ((struct cjsonString*)lpMember)->dwStrlen; }
+			}
+		}
+	}
+
+	lpScratchSystem = cjsonScratch_System((*lpTarget)->lpSystem);
+	if(dwMaxPath <= CJSON_PATCH_TOKENBUFFER) {
+		lpToken = bTokenBuffer;
+	} else {
+		e = cjsonScratch_Alloc(lpScratchSystem, dwMaxPath, (void**)(&lpToken));
+		if(e != cjsonE_Ok) { return e; }
+	}
+
+	/*
+		The root is modified in place so it must not be shared. Operations
+		on the root pointer install a value shared with the patch, so the
+		root is checked again after every operation.
+	*/
+	e = cjsonValue_Unshare(lpTarget);
+
+	for(lpPage = ((struct cjsonArray*)lpPatch)->pageList.lpFirstPage; (lpPage != NULL) && (e == cjsonE_Ok); lpPage = lpPage->pageList.lpNext) {
+		for(i = 0; i < lpPage->dwUsedEntries; i=i+1) {
+			e = cjsonPatch_ApplyOperation(lpTarget, lpPage->entries[i], lpToken);
+			if(e == cjsonE_Ok) { e = cjsonValue_Unshare(lpTarget); }
+			if(e != cjsonE_Ok) { break; }
+		}
+	}
+
+	if(lpToken != bTokenBuffer) { cjsonScratch_Free(lpScratchSystem, (void*)lpToken); }
+	return e;
+}
+
+/*
+	Diff generation. Container pairs that differ are processed from
+	a work list; each pair emits operations for its direct children
+	and queues differing child containers of the same type. Operations
+	of a pair only touch array indices above those of queued children
+	so the order of processing does not matter.
+*/
+struct cjsonDiff_Pair {
+	const struct cjsonValue*					lpA;
+	struct cjsonValue*							lpB;
+	char*										lpPath;
+	unsigned long int							dwPathLength;
+};
+struct cjsonDiff_Context {
+	struct cjsonSystemAPI*						lpSystem;
+	struct cjsonSystemAPI*						lpScratchSystem;	/* Paths, work list and tables */
+	struct cjsonValue*							lpPatch;
+
+	struct cjsonDiff_Pair*						lpPairs;
+	unsigned long int							dwPairCount;
+	unsigned long int							dwPairCapacity;
+};
+
+/*
+	Creates the pointer of a child (parent pointer plus escaped token)
+*/
+static enum cjsonError cjsonDiff_ChildPath(
+	struct cjsonDiff_Context* lpCtx,
+	const char* lpParent,
+	unsigned long int dwParentLength,
+	const char* lpToken,
+	unsigned long int dwTokenLength,
+	char** lpPathOut,
+	unsigned long int* lpPathLengthOut
+) {
+	unsigned long int dwLength;
+	unsigned long int i;
+	char* lpNew;
+	enum cjsonError e;
+
+	dwLength = dwParentLength + 1 + dwTokenLength;
+	for(i = 0; i < dwTokenLength; i=i+1) {
+		if((lpToken[i] == '~') || (lpToken[i] == '/')) { dwLength = dwLength + 1; }
+	}
+
+	e = cjsonScratch_Alloc(lpCtx->lpScratchSystem, dwLength + 1, (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+
+	if(dwParentLength > 0) { memcpy(lpNew, lpParent, dwParentLength); }
+	dwLength = dwParentLength;
+	lpNew[dwLength] = '/';
+	dwLength = dwLength + 1;
+	for(i = 0; i < dwTokenLength; i=i+1) {
+		if(lpToken[i] == '~') { lpNew[dwLength] = '~'; lpNew[dwLength+1] = '0'; dwLength = dwLength + 2; }
+		else if(lpToken[i] == '/') { lpNew[dwLength] = '~'; lpNew[dwLength+1] = '1'; dwLength = dwLength + 2; }
+		else { lpNew[dwLength] = lpToken[i]; dwLength = dwLength + 1; }
+	}
+	lpNew[dwLength] = 0;
+
+	(*lpPathOut) = lpNew;
+	(*lpPathLengthOut) = dwLength;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonDiff_IndexPath(
+	struct cjsonDiff_Context* lpCtx,
+	const char* lpParent,
+	unsigned long int dwParentLength,
+	unsigned long int dwIndex,
+	char** lpPathOut,
+	unsigned long int* lpPathLengthOut
+) {
+	char bIndex[24];
+	int iLength;
+
+	iLength = snprintf(bIndex, sizeof(bIndex), "%lu", dwIndex);
+	return cjsonDiff_ChildPath(lpCtx, lpParent, dwParentLength, bIndex, (unsigned long int)iLength, lpPathOut, lpPathLengthOut);
+}
+
+static enum cjsonError cjsonDiff_Emit(
+	struct cjsonDiff_Context* lpCtx,
+	const char* lpOp,
+	const char* lpPath,
+	unsigned long int dwPathLength,
+	struct cjsonValue* lpValue				/* Shared with the patch, may be NULL */
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpOperation;
+	struct cjsonValue* lpString;
+
+	e = cjsonObject_CreateSized(&lpOperation, 3, lpCtx->lpSystem);
+	if(e != cjsonE_Ok) { return e; }
+
+	e = cjsonString_Create(&lpString, lpOp, strlen(lpOp), lpCtx->lpSystem);
+	if(e == cjsonE_Ok) {
+		e = cjsonObject_Set(lpOperation, "op", 2, lpString);
+		if(e != cjsonE_Ok) { cjsonReleaseValue(lpString); }
+	}
+	if(e == cjsonE_Ok) {
+		e = cjsonString_Create(&lpString, lpPath, dwPathLength, lpCtx->lpSystem);
+		if(e == cjsonE_Ok) {
+			e = cjsonObject_Set(lpOperation, "path", 4, lpString);
+			if(e != cjsonE_Ok) { cjsonReleaseValue(lpString); }
+		}
+	}
+	if((e == cjsonE_Ok) && (lpValue != NULL)) {
+		e = cjsonObject_SetShared(lpOperation, "value", 5, lpValue);
+	}
+	if(e == cjsonE_Ok) {
+		e = cjsonArray_Push(lpCtx->lpPatch, lpOperation);
+	}
+
+	if(e != cjsonE_Ok) { cjsonReleaseValue(lpOperation); }
+	return e;
+}
+
+static inline int cjsonDiff_Recurse(
+	const struct cjsonValue* lpA,
+	const struct cjsonValue* lpB
+) {
+	return ((lpA != NULL) && (lpB != NULL) && (lpA->type == lpB->type) && ((lpA->type == cjsonObject) || (lpA->type == cjsonArray))) ? 1 : 0;
+}
+static enum cjsonError cjsonDiff_Queue(
+	struct cjsonDiff_Context* lpCtx,
+	const struct cjsonValue* lpA,
+	struct cjsonValue* lpB,
+	char* lpPath,							/* Ownership is passed to the work list */
+	unsigned long int dwPathLength
+) {
+	struct cjsonDiff_Pair* lpNew;
+	unsigned long int dwNewCapacity;
+	enum cjsonError e;
+
+	if(lpCtx->dwPairCount == lpCtx->dwPairCapacity) {
+		dwNewCapacity = (lpCtx->dwPairCapacity == 0) ? 16 : lpCtx->dwPairCapacity * 2;
+		e = cjsonScratch_Alloc(lpCtx->lpScratchSystem, sizeof(struct cjsonDiff_Pair)*dwNewCapacity, (void**)(&lpNew));
+		if(e != cjsonE_Ok) { cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpPath); return e; }
+		if(lpCtx->dwPairCount > 0) { memcpy(lpNew, lpCtx->lpPairs, sizeof(struct cjsonDiff_Pair)*lpCtx->dwPairCount); }
+		cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)(lpCtx->lpPairs));
+		lpCtx->lpPairs = lpNew;
+		lpCtx->dwPairCapacity = dwNewCapacity;
+	}
+
+	lpCtx->lpPairs[lpCtx->dwPairCount].lpA = lpA;
+	lpCtx->lpPairs[lpCtx->dwPairCount].lpB = lpB;
+	lpCtx->lpPairs[lpCtx->dwPairCount].lpPath = lpPath;
+	lpCtx->lpPairs[lpCtx->dwPairCount].dwPathLength = dwPathLength;
+	lpCtx->dwPairCount = lpCtx->dwPairCount + 1;
+	return cjsonE_Ok;
+}
+
+/*
+	Handles a pair of children at the same location: nothing if equal,
+	queued if both are containers of the same type, replaced otherwise
+*/
+static enum cjsonError cjsonDiff_Child(
+	struct cjsonDiff_Context* lpCtx,
+	const struct cjsonValue* lpA,
+	struct cjsonValue* lpB,
+	char* lpPath,							/* Ownership is passed */
+	unsigned long int dwPathLength
+) {
+	enum cjsonError e;
+
+	if(cjsonDiff_Recurse(lpA, lpB) != 0) {
+		return cjsonDiff_Queue(lpCtx, lpA, lpB, lpPath, dwPathLength);
+	}
+	e = cjsonDiff_Emit(lpCtx, "replace", lpPath, dwPathLength, lpB);
+	cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpPath);
+	return e;
+}
+
+static enum cjsonError cjsonDiff_Objects(
+	struct cjsonDiff_Context* lpCtx,
+	const struct cjsonDiff_Pair* lpPair
+) {
+	enum cjsonError e;
+	const struct cjsonObject* lpA = (const struct cjsonObject*)(lpPair->lpA);
+	const struct cjsonObject* lpB = (const struct cjsonObject*)(lpPair->lpB);
+	const struct cjsonObject_BucketEntry* lpEntry;
+	struct cjsonValue* lpOther;
+	unsigned long int i;
+	char* lpPath;
+	unsigned long int dwPathLength;
+
+	for(i = 0; i < lpA->dwBucketCount; i=i+1) {
+		for(lpEntry = lpA->buckets[i]; lpEntry != NULL; lpEntry = lpEntry->bucketList.lpNext) {
+			if(cjsonObject_Get(lpPair->lpB, lpEntry->bKey, lpEntry->dwKeyLength, &lpOther) == cjsonE_Ok) {
+				if(cjsonValue_Equals(lpEntry->lpValue, lpOther) != 0) { continue; }
+
+				e = cjsonDiff_ChildPath(lpCtx, lpPair->lpPath, lpPair->dwPathLength, lpEntry->bKey, lpEntry->dwKeyLength, &lpPath, &dwPathLength);
+				if(e != cjsonE_Ok) { return e; }
+				e = cjsonDiff_Child(lpCtx, lpEntry->lpValue, lpOther, lpPath, dwPathLength);
+				if(e != cjsonE_Ok) { return e; }
+			} else {
+				e = cjsonDiff_ChildPath(lpCtx, lpPair->lpPath, lpPair->dwPathLength, lpEntry->bKey, lpEntry->dwKeyLength, &lpPath, &dwPathLength);
+				if(e != cjsonE_Ok) { return e; }
+				e = cjsonDiff_Emit(lpCtx, "remove", lpPath, dwPathLength, NULL);
+				cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpPath);
+				if(e != cjsonE_Ok) { return e; }
+			}
+		}
+	}
+
+	for(i = 0; i < lpB->dwBucketCount; i=i+1) {
+		for(lpEntry = lpB->buckets[i]; lpEntry != NULL; lpEntry = lpEntry->bucketList.lpNext) {
+			if(cjsonObject_HasKey(lpPair->lpA, lpEntry->bKey, lpEntry->dwKeyLength) == cjsonE_Ok) { continue; }
+
+			e = cjsonDiff_ChildPath(lpCtx, lpPair->lpPath, lpPair->dwPathLength, lpEntry->bKey, lpEntry->dwKeyLength, &lpPath, &dwPathLength);
+			if(e != cjsonE_Ok) { return e; }
+			e = cjsonDiff_Emit(lpCtx, "add", lpPath, dwPathLength, lpEntry->lpValue);
+			cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpPath);
+			if(e != cjsonE_Ok) { return e; }
+		}
+	}
+
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonDiff_Flatten(
+	struct cjsonDiff_Context* lpCtx,
+	const struct cjsonValue* lpArray,
+	struct cjsonValue*** lpEntriesOut
+) {
+	struct cjsonArray_Page* lpPage;
+	unsigned long int dwCount = 0;
+	unsigned long int i;
+	enum cjsonError e;
+
+	e = cjsonScratch_Alloc(lpCtx->lpScratchSystem, sizeof(struct cjsonValue*)*(((const struct cjsonArray*)lpArray)->dwElementCount + 1), (void**)lpEntriesOut);
+	if(e != cjsonE_Ok) { return e; }
+
+	for(lpPage = ((const struct cjsonArray*)lpArray)->pageList.lpFirstPage; lpPage != NULL; lpPage = lpPage->pageList.lpNext) {
+		for(i = 0; i < lpPage->dwUsedEntries; i=i+1) {
+			(*lpEntriesOut)[dwCount] = lpPage->entries[i];
+			dwCount = dwCount + 1;
+		}
+	}
+	return cjsonE_Ok;
+}
+
+/*
+	Arrays: common prefix and suffix are skipped. The remaining
+	sections are matched by the longest common subsequence over
+	element hashes (confirmed by equality) if they're small enough,
+	otherwise elements are paired by position.
+*/
+static enum cjsonError cjsonDiff_Arrays(
+	struct cjsonDiff_Context* lpCtx,
+	const struct cjsonDiff_Pair* lpPair
+) {
+	enum cjsonError e;
+	struct cjsonValue** lpEntriesA = NULL;
+	struct cjsonValue** lpEntriesB = NULL;
+	uint64_t* lpHashA = NULL;
+	uint64_t* lpHashB = NULL;
+	unsigned long int* lpLcs = NULL;
+	unsigned long int dwCountA = ((const struct cjsonArray*)(lpPair->lpA))->dwElementCount;
+	unsigned long int dwCountB = ((const struct cjsonArray*)(lpPair->lpB))->dwElementCount;
+	unsigned long int dwPrefix;
+	unsigned long int dwSuffix;
+	unsigned long int dwMidA;
+	unsigned long int dwMidB;
+	unsigned long int dwIndex;
+	unsigned long int i;
+	unsigned long int j;
+	unsigned long int dwCols;
+	char* lpPath;
+	unsigned long int dwPathLength;
+
+	e = cjsonDiff_Flatten(lpCtx, lpPair->lpA, &lpEntriesA);
+	if(e == cjsonE_Ok) { e = cjsonDiff_Flatten(lpCtx, lpPair->lpB, &lpEntriesB); }
+	if(e != cjsonE_Ok) { goto cleanup; }
+
+	dwPrefix = 0;
+	while((dwPrefix < dwCountA) && (dwPrefix < dwCountB) && (cjsonValue_Equals(lpEntriesA[dwPrefix], lpEntriesB[dwPrefix]) != 0)) { dwPrefix = dwPrefix + 1; }
+	dwSuffix = 0;
+	while((dwSuffix < dwCountA - dwPrefix) && (dwSuffix < dwCountB - dwPrefix) && (cjsonValue_Equals(lpEntriesA[dwCountA - 1 - dwSuffix], lpEntriesB[dwCountB - 1 - dwSuffix]) != 0)) { dwSuffix = dwSuffix + 1; }
+
+	dwMidA = dwCountA - dwPrefix - dwSuffix;
+	dwMidB = dwCountB - dwPrefix - dwSuffix;
+	dwIndex = dwPrefix;
+
+	if((dwMidA > 0) && (dwMidB > 0) && ((dwMidA + 1) <= CJSON_DIFF_LCSMAXCELLS / (dwMidB + 1))) {
+		e = cjsonScratch_Alloc(lpCtx->lpScratchSystem, sizeof(uint64_t)*dwMidA, (void**)(&lpHashA));
+		if(e == cjsonE_Ok) { e = cjsonScratch_Alloc(lpCtx->lpScratchSystem, sizeof(uint64_t)*dwMidB, (void**)(&lpHashB)); }
+		if(e == cjsonE_Ok) { e = cjsonScratch_Alloc(lpCtx->lpScratchSystem, sizeof(unsigned long int)*(dwMidA + 1)*(dwMidB + 1), (void**)(&lpLcs)); }
+		if(e != cjsonE_Ok) { goto cleanup; }
+
+		for(i = 0; i < dwMidA; i=i+1) { lpHashA[i] = cjsonValue_Hash(lpEntriesA[dwPrefix + i], CJSON_DIFF_HASHSEED); }
+		for(j = 0; j < dwMidB; j=j+1) { lpHashB[j] = cjsonValue_Hash(lpEntriesB[dwPrefix + j], CJSON_DIFF_HASHSEED); }
+
+		/* lpLcs[i][j] is the LCS length of the sections starting at i and j */
+		dwCols = dwMidB + 1;
+		for(i = dwMidA + 1; i > 0; i=i-1) {
+			for(j = dwMidB + 1; j > 0; j=j-1) {
+				if((i - 1 == dwMidA) || (j - 1 == dwMidB)) {
+					lpLcs[(i-1)*dwCols + (j-1)] = 0;
+				} else if((lpHashA[i-1] == lpHashB[j-1]) && (cjsonValue_Equals(lpEntriesA[dwPrefix+i-1], lpEntriesB[dwPrefix+j-1]) != 0)) {
+					lpLcs[(i-1)*dwCols + (j-1)] = lpLcs[i*dwCols + j] + 1;
+				} else {
+					lpLcs[(i-1)*dwCols + (j-1)] = (lpLcs[i*dwCols + (j-1)] >= lpLcs[(i-1)*dwCols + j]) ? lpLcs[i*dwCols + (j-1)] : lpLcs[(i-1)*dwCols + j];
+				}
+			}
+		}
+
+		/* Walk the table and emit operations at their current index */
+		i = 0;
+		j = 0;
+		while((i < dwMidA) || (j < dwMidB)) {
+			if((i < dwMidA) && (j < dwMidB) && (lpHashA[i] == lpHashB[j]) && (lpLcs[i*dwCols + j] == lpLcs[(i+1)*dwCols + (j+1)] + 1) && (cjsonValue_Equals(lpEntriesA[dwPrefix+i], lpEntriesB[dwPrefix+j]) != 0)) {
+				i = i + 1; j = j + 1; dwIndex = dwIndex + 1;
+			} else if((i < dwMidA) && (j < dwMidB) && (lpLcs[i*dwCols + j] == lpLcs[(i+1)*dwCols + (j+1)])) {
+				/* Substitution does not lose any match */
+				e = cjsonDiff_IndexPath(lpCtx, lpPair->lpPath, lpPair->dwPathLength, dwIndex, &lpPath, &dwPathLength);
+				if(e == cjsonE_Ok) { e = cjsonDiff_Child(lpCtx, lpEntriesA[dwPrefix+i], lpEntriesB[dwPrefix+j], lpPath, dwPathLength); }
+				if(e != cjsonE_Ok) { goto cleanup; }
+				i = i + 1; j = j + 1; dwIndex = dwIndex + 1;
+			} else if((j >= dwMidB) || ((i < dwMidA) && (lpLcs[(i+1)*dwCols + j] >= lpLcs[i*dwCols + (j+1)]))) {
+				e = cjsonDiff_IndexPath(lpCtx, lpPair->lpPath, lpPair->dwPathLength, dwIndex, &lpPath, &dwPathLength);
+				if(e != cjsonE_Ok) { goto cleanup; }
+				e = cjsonDiff_Emit(lpCtx, "remove", lpPath, dwPathLength, NULL);
+				cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpPath);
+				if(e != cjsonE_Ok) { goto cleanup; }
+				i = i + 1;
+			} else {
+				e = cjsonDiff_IndexPath(lpCtx, lpPair->lpPath, lpPair->dwPathLength, dwIndex, &lpPath, &dwPathLength);
+				if(e != cjsonE_Ok) { goto cleanup; }
+				e = cjsonDiff_Emit(lpCtx, "add", lpPath, dwPathLength, lpEntriesB[dwPrefix+j]);
+				cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpPath);
+				if(e != cjsonE_Ok) { goto cleanup; }
+				j = j + 1; dwIndex = dwIndex + 1;
+			}
+		}
+	} else {
+		/* Positional pairing, then removal or append of the remaining elements */
+		for(i = 0; (i < dwMidA) && (i < dwMidB); i=i+1) {
+			if(cjsonValue_Equals(lpEntriesA[dwPrefix+i], lpEntriesB[dwPrefix+i]) == 0) {
+				e = cjsonDiff_IndexPath(lpCtx, lpPair->lpPath, lpPair->dwPathLength, dwPrefix+i, &lpPath, &dwPathLength);
+				if(e == cjsonE_Ok) { e = cjsonDiff_Child(lpCtx, lpEntriesA[dwPrefix+i], lpEntriesB[dwPrefix+i], lpPath, dwPathLength); }
+				if(e != cjsonE_Ok) { goto cleanup; }
+			}
+		}
+		for(; i < dwMidA; i=i+1) {
+			e = cjsonDiff_IndexPath(lpCtx, lpPair->lpPath, lpPair->dwPathLength, dwPrefix+dwMidB, &lpPath, &dwPathLength);
+			if(e != cjsonE_Ok) { goto cleanup; }
+			e = cjsonDiff_Emit(lpCtx, "remove", lpPath, dwPathLength, NULL);
+			cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpPath);
+			if(e != cjsonE_Ok) { goto cleanup; }
+		}
+		for(; i < dwMidB; i=i+1) {
+			e = cjsonDiff_IndexPath(lpCtx, lpPair->lpPath, lpPair->dwPathLength, dwPrefix+i, &lpPath, &dwPathLength);
+			if(e != cjsonE_Ok) { goto cleanup; }
+			e = cjsonDiff_Emit(lpCtx, "add", lpPath, dwPathLength, lpEntriesB[dwPrefix+i]);
+			cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpPath);
+			if(e != cjsonE_Ok) { goto cleanup; }
+		}
+	}
+
+cleanup:
+	cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpLcs);
+	cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpHashA);
+	cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpHashB);
+	cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpEntriesA);
+	cjsonScratch_Free(lpCtx->lpScratchSystem, (void*)lpEntriesB);
+	return e;
+}
+
+enum cjsonError cjsonDiff(
+	const struct cjsonValue* lpA,
+	struct cjsonValue* lpB,
+	struct cjsonValue** lpPatchOut,
+	struct cjsonSystemAPI* lpSystem
+) {
+	enum cjsonError e;
+	struct cjsonDiff_Context ctx;
+	struct cjsonDiff_Pair pair;
+
+	if(lpPatchOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpPatchOut) = NULL;
+	if((lpA == NULL) || (lpB == NULL)) { return cjsonE_InvalidParam; }
+
+	ctx.lpSystem = lpSystem;
+	ctx.lpScratchSystem = cjsonScratch_System(lpSystem);
+	ctx.lpPairs = NULL;
+	ctx.dwPairCount = 0;
+	ctx.dwPairCapacity = 0;
+
+	e = cjsonArray_Create(&(ctx.lpPatch), lpSystem);
+	if(e != cjsonE_Ok) { return e; }
+
+	if(cjsonValue_Equals(lpA, lpB) == 0) {
+		if(cjsonDiff_Recurse(lpA, lpB) != 0) {
+			e = cjsonDiff_Queue(&ctx, lpA, lpB, NULL, 0);
+		} else {
+			e = cjsonDiff_Emit(&ctx, "replace", "", 0, lpB);
+		}
+	}
+
+	while((e == cjsonE_Ok) && (ctx.dwPairCount > 0)) {
+		ctx.dwPairCount = ctx.dwPairCount - 1;
+		pair = ctx.lpPairs[ctx.dwPairCount];
+
+		if(pair.lpA->type == cjsonObject) {
+			e = cjsonDiff_Objects(&ctx, &pair);
+		} else {
+			e = cjsonDiff_Arrays(&ctx, &pair);
+		}
+		cjsonScratch_Free(ctx.lpScratchSystem, (void*)pair.lpPath);
+	}
+
+	while(ctx.dwPairCount > 0) {
+		ctx.dwPairCount = ctx.dwPairCount - 1;
+		cjsonScratch_Free(ctx.lpScratchSystem, (void*)ctx.lpPairs[ctx.dwPairCount].lpPath);
+	}
+	cjsonScratch_Free(ctx.lpScratchSystem, (void*)ctx.lpPairs);
+
+	if(e != cjsonE_Ok) {
+		cjsonReleaseValue(ctx.lpPatch);
+		return e;
+	}
+
+	(*lpPatchOut) = ctx.lpPatch;
+	return cjsonE_Ok;
+}
+
+/*
+	JSON Merge Patch (RFC 7386). The patch is consumed while merging:
+
+	- Members of patch objects are detached and their bucket entries
+	  are attached to the target object, values replace target values
+	  directly. Nothing is copied.
+	- If both sides contain an object for a key the objects are merged
+	  recursively, the emptied patch object is released afterwards.
+	- Objects moved into the target without a counterpart are stripped
+	  of their null members (an RFC 7386 merge into an empty object).
+
+	Allocation only happens for shared values (copy on write), when
+	target and patch use different system APIs (entries have to be
+	reallocated) and for nesting deeper than one stack segment
+	(segments come from the scratch system of the target object).
+*/
+struct cjsonMergePatch_Frame {
+	struct cjsonValue*							lpTarget;
+	struct cjsonValue*							lpPatch;		/* NULL while stripping null members of lpTarget */
+	unsigned long int							dwBucket;
+	struct cjsonObject_BucketEntry*				lpEntry;		/* Next entry to strip */
+};
+static int cjsonMergePatch_Push(
+	struct cjsonScratch_Stack* lpStack,
+	struct cjsonValue* lpTarget,
+	struct cjsonValue* lpPatch
+) {
+	struct cjsonMergePatch_Frame* lpFrame;
+
+	lpFrame = (struct cjsonMergePatch_Frame*)cjsonScratch_Push(lpStack);
+	if(lpFrame == NULL) { return 0; }
+
+	lpFrame->lpTarget = lpTarget;
+	lpFrame->lpPatch = lpPatch;
+	lpFrame->dwBucket = 0;
+	lpFrame->lpEntry = NULL;
+	return 1;
+}
+static void cjsonMergePatch_FreeEntry(
+	struct cjsonSystemAPI* lpSystem,
+	struct cjsonObject_BucketEntry* lpEntry
+) {
+	if(lpSystem == NULL) {
+		free((void*)lpEntry);
+	} else {
+		lpSystem->free(lpSystem, (void*)lpEntry);
+	}
+}
+static inline int cjsonMergePatch_IsNull(
+	const struct cjsonValue* lpValue
+) {
+	return ((lpValue == NULL) || (lpValue->type == cjsonNull)) ? 1 : 0;
+}
+
+/*
+	Merges lpPatch into lpTarget (both unshared objects) or strips
+	null members from lpTarget if lpPatch is NULL. lpPatch is released
+	on success and on failure. Nested calls are only used if a stack
+	segment cannot be allocated.
+*/
+static enum cjsonError cjsonMergePatch_Run(
+	struct cjsonValue* lpTarget,
+	struct cjsonValue* lpPatch
+) {
+	enum cjsonError e = cjsonE_Ok;
+	struct cjsonMergePatch_Frame stackBase[CJSON_MERGEPATCH_STACKSEGMENT];
+	struct cjsonScratch_Stack stack;
+	struct cjsonMergePatch_Frame* lpFrame;
+	struct cjsonObject* lpObj;
+	struct cjsonObject_BucketEntry* lpEntry;
+	struct cjsonObject_BucketEntry* lpExisting;
+	struct cjsonValue* lpValue;
+
+	cjsonScratch_StackInit(&stack, (void*)stackBase, sizeof(struct cjsonMergePatch_Frame), CJSON_MERGEPATCH_STACKSEGMENT, lpTarget->lpSystem);
+	cjsonMergePatch_Push(&stack, lpTarget, lpPatch);
+
+	while(!CJSON_SCRATCH_EMPTY(&stack)) {
+		lpFrame = (struct cjsonMergePatch_Frame*)CJSON_SCRATCH_TOP(&stack);
+
+		if(lpFrame->lpPatch == NULL) {
+			/* Stripping: fetch the next entry of the target */
+			lpObj = (struct cjsonObject*)(lpFrame->lpTarget);
+			lpEntry = lpFrame->lpEntry;
+			while((lpEntry == NULL) && (lpFrame->dwBucket < lpObj->dwBucketCount)) {
+				lpEntry = lpObj->buckets[lpFrame->dwBucket];
+				lpFrame->dwBucket = lpFrame->dwBucket + 1;
+			}
+			if(lpEntry == NULL) {
+				cjsonScratch_Pop(&stack);
+				continue;
+			}
+			lpFrame->lpEntry = lpEntry->bucketList.lpNext;
+
+			if(cjsonMergePatch_IsNull(lpEntry->lpValue)) {
+				cjsonObject_DetachEntry(lpFrame->lpTarget, lpEntry);
+				if(lpEntry->lpValue != NULL) { cjsonReleaseValue(lpEntry->lpValue); }
+				cjsonMergePatch_FreeEntry(lpObj->base.lpSystem, lpEntry);
+			} else if(lpEntry->lpValue->type == cjsonObject) {
+				e = cjsonValue_Unshare(&(lpEntry->lpValue));
+				if(e != cjsonE_Ok) { break; }
+				if(cjsonMergePatch_Push(&stack, lpEntry->lpValue, NULL) == 0) {
+					e = cjsonMergePatch_Run(lpEntry->lpValue, NULL);
+					if(e != cjsonE_Ok) { break; }
+				}
+			}
+			continue;
+		}
+
+		/* Merging: consume the next member of the patch object */
+		lpObj = (struct cjsonObject*)(lpFrame->lpPatch);
+		while((lpFrame->dwBucket < lpObj->dwBucketCount) && (lpObj->buckets[lpFrame->dwBucket] == NULL)) {
+			lpFrame->dwBucket = lpFrame->dwBucket + 1;
+		}
+		if(lpFrame->dwBucket == lpObj->dwBucketCount) {
+			/* All members have been moved, only the empty object is left */
+			cjsonReleaseValue(lpFrame->lpPatch);
+			cjsonScratch_Pop(&stack);
+			continue;
+		}
+
+		lpEntry = lpObj->buckets[lpFrame->dwBucket];
+		cjsonObject_DetachEntry(lpFrame->lpPatch, lpEntry);
+		lpValue = lpEntry->lpValue;
+		lpExisting = cjsonObject_FindEntry(lpFrame->lpTarget, lpEntry->bKey, lpEntry->dwKeyLength);
+
+		if(cjsonMergePatch_IsNull(lpValue)) {
+			/* Null removes the member from the target */
+			if(lpExisting != NULL) {
+				cjsonObject_DetachEntry(lpFrame->lpTarget, lpExisting);
+				cjsonReleaseValue(lpExisting->lpValue);
+				cjsonMergePatch_FreeEntry(lpFrame->lpTarget->lpSystem, lpExisting);
+			}
+			if(lpValue != NULL) { cjsonReleaseValue(lpValue); }
+			cjsonMergePatch_FreeEntry(lpObj->base.lpSystem, lpEntry);
+			continue;
+		}
+
+		if((lpValue->type == cjsonObject) && (lpExisting != NULL) && (lpExisting->lpValue != NULL) && (lpExisting->lpValue->type == cjsonObject)) {
+			/* Both sides are objects, merge recursively */
+			cjsonMergePatch_FreeEntry(lpObj->base.lpSystem, lpEntry);
+			e = cjsonValue_Unshare(&(lpExisting->lpValue));
+			if(e == cjsonE_Ok) { e = cjsonValue_Unshare(&lpValue); }
+			if(e != cjsonE_Ok) { cjsonReleaseValue(lpValue); break; }
+
+			if(cjsonMergePatch_Push(&stack, lpExisting->lpValue, lpValue) == 0) {
+				e = cjsonMergePatch_Run(lpExisting->lpValue, lpValue);
+				if(e != cjsonE_Ok) { break; }
+			}
+			continue;
+		}
+
+		if(lpValue->type == cjsonObject) {
+			e = cjsonValue_Unshare(&lpValue);
+			if(e != cjsonE_Ok) {
+				cjsonReleaseValue(lpValue);
+				cjsonMergePatch_FreeEntry(lpObj->base.lpSystem, lpEntry);
+				break;
+			}
+		}
+
+		/* The patch value replaces the target value */
+		if(lpExisting != NULL) {
+			if(lpExisting->lpValue != NULL) { cjsonReleaseValue(lpExisting->lpValue); }
+			lpExisting->lpValue = lpValue;
+			cjsonMergePatch_FreeEntry(lpObj->base.lpSystem, lpEntry);
+		} else if(lpFrame->lpTarget->lpSystem == lpObj->base.lpSystem) {
+			lpEntry->lpValue = lpValue;
+			cjsonObject_AttachEntry(lpFrame->lpTarget, lpEntry);
+		} else {
+			/* Entries are owned by the system API of their object */
+			e = cjsonObject_SetPrehashed(lpFrame->lpTarget, lpEntry->bKey, lpEntry->dwKeyLength, lpEntry->dwKeyHash, lpValue);
+			cjsonMergePatch_FreeEntry(lpObj->base.lpSystem, lpEntry);
+			if(e != cjsonE_Ok) { cjsonReleaseValue(lpValue); break; }
+		}
+
+		if(lpValue->type == cjsonObject) {
+			if(cjsonMergePatch_Push(&stack, lpValue, NULL) == 0) {
+				e = cjsonMergePatch_Run(lpValue, NULL);
+				if(e != cjsonE_Ok) { break; }
+			}
+		}
+	}
+
+	if(e != cjsonE_Ok) {
+		/* The patch is consumed in any case */
+		while(!CJSON_SCRATCH_EMPTY(&stack)) {
+			lpFrame = (struct cjsonMergePatch_Frame*)CJSON_SCRATCH_TOP(&stack);
+			if(lpFrame->lpPatch != NULL) { cjsonReleaseValue(lpFrame->lpPatch); }
+			cjsonScratch_Pop(&stack);
+		}
+	}
+	return e;
+}
+
+enum cjsonError cjsonMergePatch(
+	struct cjsonValue** lpTarget,
+	struct cjsonValue* lpPatch
+) {
+	enum cjsonError e;
+
+	if(lpPatch == NULL) { return cjsonE_InvalidParam; }
+	if(lpTarget == NULL) { cjsonReleaseValue(lpPatch); return cjsonE_InvalidParam; }
+
+	if(lpPatch->type != cjsonObject) {
+		/* Anything except an object replaces the whole document */
+		if((*lpTarget) != NULL) { cjsonReleaseValue(*lpTarget); }
+		(*lpTarget) = lpPatch;
+		return cjsonE_Ok;
+	}
+
+	e = cjsonValue_Unshare(&lpPatch);
+	if(e != cjsonE_Ok) { cjsonReleaseValue(lpPatch); return e; }
+
+	if(((*lpTarget) == NULL) || ((*lpTarget)->type != cjsonObject)) {
+		/* Merging into an empty object only drops null members */
+		if((*lpTarget) != NULL) { cjsonReleaseValue(*lpTarget); }
+		(*lpTarget) = lpPatch;
+		return cjsonMergePatch_Run(lpPatch, NULL);
+	}
+
+	e = cjsonValue_Unshare(lpTarget);
+	if(e != cjsonE_Ok) { cjsonReleaseValue(lpPatch); return e; }
+
+	return cjsonMergePatch_Run(*lpTarget, lpPatch);
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
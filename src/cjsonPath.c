@@ -0,0 +1,633 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_PATH_STACKSEGMENT
+	#define CJSON_PATH_STACKSEGMENT 32				/* Frames per segment of the evaluation stack */
+#endif
+
+/*
+	A compiled path is a flat list of steps. Every step selects
+	zero or more children of the current value, keys of all steps
+	are stored (decoded) behind the step list in the same block.
+*/
+enum cjsonPath_StepType {
+	cjsonPath_StepType__Token,					/* JSON pointer token: object member or array index */
+	cjsonPath_StepType__Member,
+	cjsonPath_StepType__Index,
+	cjsonPath_StepType__Slice,					/* Also used for wildcards (with the object flag) */
+	cjsonPath_StepType__Descendants
+};
+
+#define CJSON_PATH_SLICE__START					0x00000001
+#define CJSON_PATH_SLICE__END					0x00000002
+#define CJSON_PATH_SLICE__OBJECTS				0x00000004	/* Wildcard, also selects all object members */
+
+struct cjsonPath_Step {
+	enum cjsonPath_StepType						type;
+	struct cjsonKey								key;		/* Token and Member */
+	signed long int								lIndex;		/* Index and slice start, -1 for tokens that are no array index */
+	signed long int								lEnd;		/* Slice */
+	unsigned long int							dwStride;	/* Slice */
+	uint32_t									dwFlags;	/* Slice */
+};
+
+struct cjsonPath {
+	struct cjsonSystemAPI*						lpSystem;
+	unsigned long int							dwStepCount;
+	char*										lpKeys;
+	struct cjsonPath_Step						steps[];
+};
+
+/*
+	Malloc and free abstraction
+*/
+static inline enum cjsonError cjsonPath_Alloc(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpSystem->alloc(lpSystem, dwSize, lpOut);
+	}
+}
+static inline void cjsonPath_Free(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpBlock == NULL) { return; }
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+
+/*
+	Compilation runs twice over the expression: the first pass
+	(lpPath is NULL) only validates and counts steps and key bytes,
+	the second one fills the allocated program.
+*/
+struct cjsonPath_CompileContext {
+	const char*									lpExpression;
+	unsigned long int							dwLength;
+	unsigned long int							dwPosition;
+
+	struct cjsonPath*							lpPath;
+	struct cjsonPath_Step						scratch;	/* Target of all steps while counting */
+	unsigned long int							dwSteps;
+	unsigned long int							dwKeyBytes;
+};
+
+static struct cjsonPath_Step* cjsonPath_AddStep(
+	struct cjsonPath_CompileContext* lpContext,
+	enum cjsonPath_StepType type
+) {
+	struct cjsonPath_Step* lpStep;
+
+	lpStep = (lpContext->lpPath != NULL) ? &(lpContext->lpPath->steps[lpContext->dwSteps]) : &(lpContext->scratch);
+	lpContext->dwSteps = lpContext->dwSteps + 1;
+
+	lpStep->type = type;
+	lpStep->key.lpKey = NULL;
+	lpStep->key.dwKeyLength = 0;
+	lpStep->key.dwKeyHash = 0;
+	lpStep->lIndex = -1;
+	lpStep->lEnd = 0;
+	lpStep->dwStride = 1;
+	lpStep->dwFlags = 0;
+	return lpStep;
+}
+static inline void cjsonPath_KeyByte(
+	struct cjsonPath_CompileContext* lpContext,
+	char bByte
+) {
+	if(lpContext->lpPath != NULL) { lpContext->lpPath->lpKeys[lpContext->dwKeyBytes] = bByte; }
+	lpContext->dwKeyBytes = lpContext->dwKeyBytes + 1;
+}
+static void cjsonPath_FinishKey(
+	struct cjsonPath_CompileContext* lpContext,
+	struct cjsonPath_Step* lpStep,
+	unsigned long int dwKeyStart
+) {
+	if(lpContext->lpPath == NULL) { return; }
+	cjsonKey_Init(&(lpStep->key), &(lpContext->lpPath->lpKeys[dwKeyStart]), lpContext->dwKeyBytes - dwKeyStart);
+}
+
+/*
+	Parses an optionally signed decimal number. Returns 0 if there
+	is no number at the current position.
+*/
+static enum cjsonError cjsonPath_ParseNumber(
+	struct cjsonPath_CompileContext* lpContext,
+	int* lpFound,
+	signed long int* lpOut
+) {
+	const char* lpExpr = lpContext->lpExpression;
+	unsigned long int dwPos = lpContext->dwPosition;
+	unsigned long int dwValue = 0;
+	int bNegative = 0;
+
+	(*lpFound) = 0;
+	if((dwPos < lpContext->dwLength) && (lpExpr[dwPos] == '-')) {
+		bNegative = 1;
+		dwPos = dwPos + 1;
+	}
+	if((dwPos >= lpContext->dwLength) || (lpExpr[dwPos] < '0') || (lpExpr[dwPos] > '9')) {
+		return (bNegative != 0) ? cjsonE_InvalidParam : cjsonE_Ok;
+	}
+
+	while((dwPos < lpContext->dwLength) && (lpExpr[dwPos] >= '0') && (lpExpr[dwPos] <= '9')) {
+		dwValue = dwValue * 10 + (unsigned long int)(lpExpr[dwPos] - '0');
+		if(dwValue > (unsigned long int)LONG_MAX) { return cjsonE_InvalidParam; }
+		dwPos = dwPos + 1;
+	}
+
+	lpContext->dwPosition = dwPos;
+	(*lpFound) = 1;
+	(*lpOut) = (bNegative != 0) ? -((signed long int)dwValue) : (signed long int)dwValue;
+	return cjsonE_Ok;
+}
+static inline void cjsonPath_SkipSpaces(
+	struct cjsonPath_CompileContext* lpContext
+) {
+	while((lpContext->dwPosition < lpContext->dwLength) && (lpContext->lpExpression[lpContext->dwPosition] == ' ')) {
+		lpContext->dwPosition = lpContext->dwPosition + 1;
+	}
+}
+
+static enum cjsonError cjsonPath_CompilePointer(
+	struct cjsonPath_CompileContext* lpContext
+) {
+	const char* lpExpr = lpContext->lpExpression;
+	struct cjsonPath_Step* lpStep;
+	unsigned long int dwKeyStart;
+	unsigned long int dwIndex;
+	unsigned long int i;
+
+	while(lpContext->dwPosition < lpContext->dwLength) {
+		if(lpExpr[lpContext->dwPosition] != '/') { return cjsonE_InvalidParam; }
+		lpContext->dwPosition = lpContext->dwPosition + 1;
+
+		lpStep = cjsonPath_AddStep(lpContext, cjsonPath_StepType__Token);
+		dwKeyStart = lpContext->dwKeyBytes;
+		while((lpContext->dwPosition < lpContext->dwLength) && (lpExpr[lpContext->dwPosition] != '/')) {
+			if(lpExpr[lpContext->dwPosition] == '~') {
+				if(lpContext->dwPosition + 1 >= lpContext->dwLength) { return cjsonE_InvalidParam; }
+				if(lpExpr[lpContext->dwPosition+1] == '0') { cjsonPath_KeyByte(lpContext, '~'); }
+				else if(lpExpr[lpContext->dwPosition+1] == '1') { cjsonPath_KeyByte(lpContext, '/'); }
+				else { return cjsonE_InvalidParam; }
+				lpContext->dwPosition = lpContext->dwPosition + 2;
+			} else {
+				cjsonPath_KeyByte(lpContext, lpExpr[lpContext->dwPosition]);
+				lpContext->dwPosition = lpContext->dwPosition + 1;
+			}
+		}
+		cjsonPath_FinishKey(lpContext, lpStep, dwKeyStart);
+
+		/* Tokens are array indices if they are decimal without leading zeros */
+		if((lpContext->lpPath == NULL) || (lpStep->key.dwKeyLength == 0)) { continue; }
+		if((lpStep->key.dwKeyLength > 1) && (lpStep->key.lpKey[0] == '0')) { continue; }
+		dwIndex = 0;
+		for(i = 0; i < lpStep->key.dwKeyLength; i=i+1) {
+			if((lpStep->key.lpKey[i] < '0') || (lpStep->key.lpKey[i] > '9')) { break; }
+			dwIndex = dwIndex * 10 + (unsigned long int)(lpStep->key.lpKey[i] - '0');
+			if(dwIndex > (unsigned long int)LONG_MAX) { break; }
+		}
+		if(i == lpStep->key.dwKeyLength) { lpStep->lIndex = (signed long int)dwIndex; }
+	}
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonPath_CompileBracket(
+	struct cjsonPath_CompileContext* lpContext
+) {
+	const char* lpExpr = lpContext->lpExpression;
+	struct cjsonPath_Step* lpStep;
+	unsigned long int dwKeyStart;
+	signed long int lValue;
+	int bFound;
+	char bQuote;
+	enum cjsonError e;
+
+	lpContext->dwPosition = lpContext->dwPosition + 1; /* [ */
+	cjsonPath_SkipSpaces(lpContext);
+	if(lpContext->dwPosition >= lpContext->dwLength) { return cjsonE_InvalidParam; }
+
+	if(lpExpr[lpContext->dwPosition] == '*') {
+		lpStep = cjsonPath_AddStep(lpContext, cjsonPath_StepType__Slice);
+		lpStep->dwFlags = CJSON_PATH_SLICE__OBJECTS;
+		lpContext->dwPosition = lpContext->dwPosition + 1;
+	} else if((lpExpr[lpContext->dwPosition] == '\'') || (lpExpr[lpContext->dwPosition] == '"')) {
+		bQuote = lpExpr[lpContext->dwPosition];
+		lpContext->dwPosition = lpContext->dwPosition + 1;
+
+		lpStep = cjsonPath_AddStep(lpContext, cjsonPath_StepType__Member);
+		dwKeyStart = lpContext->dwKeyBytes;
+		for(;;) {
+			if(lpContext->dwPosition >= lpContext->dwLength) { return cjsonE_InvalidParam; }
+			if(lpExpr[lpContext->dwPosition] == bQuote) { break; }
+			if(lpExpr[lpContext->dwPosition] == '\\') {
+				/* Only the quote and the backslash itself can be escaped */
+				lpContext->dwPosition = lpContext->dwPosition + 1;
+				if(lpContext->dwPosition >= lpContext->dwLength) { return cjsonE_InvalidParam; }
+				if((lpExpr[lpContext->dwPosition] != '\\') && (lpExpr[lpContext->dwPosition] != '\'') && (lpExpr[lpContext->dwPosition] != '"')) { return cjsonE_InvalidParam; }
+			}
+			cjsonPath_KeyByte(lpContext, lpExpr[lpContext->dwPosition]);
+			lpContext->dwPosition = lpContext->dwPosition + 1;
+		}
+		lpContext->dwPosition = lpContext->dwPosition + 1;
+		cjsonPath_FinishKey(lpContext, lpStep, dwKeyStart);
+	} else {
+		e = cjsonPath_ParseNumber(lpContext, &bFound, &lValue);
+		if(e != cjsonE_Ok) { return e; }
+		cjsonPath_SkipSpaces(lpContext);
+
+		if((lpContext->dwPosition < lpContext->dwLength) && (lpExpr[lpContext->dwPosition] == ':')) {
+			lpStep = cjsonPath_AddStep(lpContext, cjsonPath_StepType__Slice);
+			if(bFound != 0) {
+				lpStep->lIndex = lValue;
+				lpStep->dwFlags = lpStep->dwFlags | CJSON_PATH_SLICE__START;
+			}
+
+			lpContext->dwPosition = lpContext->dwPosition + 1;
+			cjsonPath_SkipSpaces(lpContext);
+			e = cjsonPath_ParseNumber(lpContext, &bFound, &lValue);
+			if(e != cjsonE_Ok) { return e; }
+			if(bFound != 0) {
+				lpStep->lEnd = lValue;
+				lpStep->dwFlags = lpStep->dwFlags | CJSON_PATH_SLICE__END;
+			}
+			cjsonPath_SkipSpaces(lpContext);
+
+			if((lpContext->dwPosition < lpContext->dwLength) && (lpExpr[lpContext->dwPosition] == ':')) {
+				lpContext->dwPosition = lpContext->dwPosition + 1;
+				cjsonPath_SkipSpaces(lpContext);
+				e = cjsonPath_ParseNumber(lpContext, &bFound, &lValue);
+				if(e != cjsonE_Ok) { return e; }
+				if(bFound != 0) {
+					if(lValue <= 0) { return cjsonE_InvalidParam; }
+					lpStep->dwStride = (unsigned long int)lValue;
+				}
+			}
+		} else {
+			if(bFound == 0) { return cjsonE_InvalidParam; }
+			lpStep = cjsonPath_AddStep(lpContext, cjsonPath_StepType__Index);
+			lpStep->lIndex = lValue;
+		}
+	}
+
+	cjsonPath_SkipSpaces(lpContext);
+	if((lpContext->dwPosition >= lpContext->dwLength) || (lpExpr[lpContext->dwPosition] != ']')) { return cjsonE_InvalidParam; }
+	lpContext->dwPosition = lpContext->dwPosition + 1;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonPath_CompileJSONPath(
+	struct cjsonPath_CompileContext* lpContext
+) {
+	const char* lpExpr = lpContext->lpExpression;
+	struct cjsonPath_Step* lpStep;
+	unsigned long int dwKeyStart;
+	enum cjsonError e;
+
+	lpContext->dwPosition = 1; /* $ */
+	while(lpContext->dwPosition < lpContext->dwLength) {
+		if(lpExpr[lpContext->dwPosition] == '[') {
+			e = cjsonPath_CompileBracket(lpContext);
+			if(e != cjsonE_Ok) { return e; }
+			continue;
+		}
+		if(lpExpr[lpContext->dwPosition] != '.') { return cjsonE_InvalidParam; }
+		lpContext->dwPosition = lpContext->dwPosition + 1;
+
+		if((lpContext->dwPosition < lpContext->dwLength) && (lpExpr[lpContext->dwPosition] == '.')) {
+			cjsonPath_AddStep(lpContext, cjsonPath_StepType__Descendants);
+			lpContext->dwPosition = lpContext->dwPosition + 1;
+			/* A selector has to follow, brackets are handled by the next iteration */
+			if(lpContext->dwPosition >= lpContext->dwLength) { return cjsonE_InvalidParam; }
+			if(lpExpr[lpContext->dwPosition] == '[') { continue; }
+		}
+		if(lpContext->dwPosition >= lpContext->dwLength) { return cjsonE_InvalidParam; }
+
+		if(lpExpr[lpContext->dwPosition] == '*') {
+			lpStep = cjsonPath_AddStep(lpContext, cjsonPath_StepType__Slice);
+			lpStep->dwFlags = CJSON_PATH_SLICE__OBJECTS;
+			lpContext->dwPosition = lpContext->dwPosition + 1;
+			continue;
+		}
+
+		lpStep = cjsonPath_AddStep(lpContext, cjsonPath_StepType__Member);
+		dwKeyStart = lpContext->dwKeyBytes;
+		while((lpContext->dwPosition < lpContext->dwLength) && (lpExpr[lpContext->dwPosition] != '.') && (lpExpr[lpContext->dwPosition] != '[')) {
+			cjsonPath_KeyByte(lpContext, lpExpr[lpContext->dwPosition]);
+			lpContext->dwPosition = lpContext->dwPosition + 1;
+		}
+		if(lpContext->dwKeyBytes == dwKeyStart) { return cjsonE_InvalidParam; }
+		cjsonPath_FinishKey(lpContext, lpStep, dwKeyStart);
+	}
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonPath_CompilePass(
+	struct cjsonPath_CompileContext* lpContext
+) {
+	lpContext->dwPosition = 0;
+	lpContext->dwSteps = 0;
+	lpContext->dwKeyBytes = 0;
+
+	if((lpContext->dwLength > 0) && (lpContext->lpExpression[0] == '$')) {
+		return cjsonPath_CompileJSONPath(lpContext);
+	}
+	return cjsonPath_CompilePointer(lpContext);
+}
+
+enum cjsonError cjsonPath_Compile(
+	struct cjsonPath** lpOut,
+	const char* lpExpression,
+	unsigned long int dwExpressionLength,
+	struct cjsonSystemAPI* lpSystem
+) {
+	struct cjsonPath_CompileContext context;
+	struct cjsonPath* lpNew;
+	enum cjsonError e;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+	if((lpExpression == NULL) && (dwExpressionLength > 0)) { return cjsonE_InvalidParam; }
+
+	context.lpExpression = lpExpression;
+	context.dwLength = dwExpressionLength;
+	context.lpPath = NULL;
+
+	e = cjsonPath_CompilePass(&context);
+	if(e != cjsonE_Ok) { return e; }
+
+	e = cjsonPath_Alloc(lpSystem, sizeof(struct cjsonPath) + sizeof(struct cjsonPath_Step) * context.dwSteps + context.dwKeyBytes, (void**)&lpNew);
+	if(e != cjsonE_Ok) { return e; }
+	lpNew->lpSystem = lpSystem;
+	lpNew->dwStepCount = context.dwSteps;
+	lpNew->lpKeys = (char*)(&(lpNew->steps[context.dwSteps]));
+
+	context.lpPath = lpNew;
+	e = cjsonPath_CompilePass(&context);
+	if(e != cjsonE_Ok) {
+		cjsonPath_Free(lpSystem, lpNew);
+		return cjsonE_ImplementationError; /* The first pass accepted the expression */
+	}
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+void cjsonPath_Release(
+	struct cjsonPath* lpPath
+) {
+	if(lpPath == NULL) { return; }
+	cjsonPath_Free(lpPath->lpSystem, lpPath);
+}
+
+/*
+	Evaluation
+
+	Steps that select a single child replace the value of their
+	frame, steps that select several children keep a cursor in
+	their frame and push one frame per selected child. Recursive
+	descent first pushes its own value for the following step
+	and then every child for itself again.
+*/
+struct cjsonPath_Frame {
+	struct cjsonValue*							lpValue;
+	unsigned long int							dwStep;
+	int											bStarted;
+
+	const struct cjsonArray_Page*				lpPage;		/* Arrays: page containing dwPosition (or before it) */
+	unsigned long int							dwPageBase;	/* Arrays: index of the first entry of lpPage */
+	const struct cjsonObject_BucketEntry*		lpEntry;	/* Objects: next entry of the current chain */
+	unsigned long int							dwPosition;	/* Arrays: next selected index, Objects: next bucket */
+	unsigned long int							dwEnd;		/* Arrays: end of the slice */
+	unsigned long int							dwStride;
+};
+static int cjsonPath_Push(
+	struct cjsonScratch_Stack* lpStack,
+	struct cjsonValue* lpValue,
+	unsigned long int dwStep
+) {
+	struct cjsonPath_Frame* lpFrame;
+
+	lpFrame = (struct cjsonPath_Frame*)cjsonScratch_Push(lpStack);
+	if(lpFrame == NULL) { return 0; }
+
+	lpFrame->lpValue = lpValue;
+	lpFrame->dwStep = dwStep;
+	lpFrame->bStarted = 0;
+	return 1;
+}
+
+/*
+	Random access that walks the page list from the nearer end
+*/
+static struct cjsonValue* cjsonPath_ArrayAt(
+	const struct cjsonArray* lpArray,
+	signed long int lIndex
+) {
+	const struct cjsonArray_Page* lpPage;
+	unsigned long int dwIndex;
+	unsigned long int dwBase;
+
+	if(lIndex < 0) {
+		if((unsigned long int)(-(lIndex + 1)) >= lpArray->dwElementCount) { return NULL; }
+		dwIndex = lpArray->dwElementCount - (unsigned long int)(-(lIndex + 1)) - 1;
+	} else {
+		if((unsigned long int)lIndex >= lpArray->dwElementCount) { return NULL; }
+		dwIndex = (unsigned long int)lIndex;
+	}
+
+	if(dwIndex < lpArray->dwElementCount / 2) {
+		dwBase = 0;
+		for(lpPage = lpArray->pageList.lpFirstPage; lpPage != NULL; lpPage = lpPage->pageList.lpNext) {
+			if(dwIndex < dwBase + lpPage->dwUsedEntries) { return lpPage->entries[dwIndex - dwBase]; }
+			dwBase = dwBase + lpPage->dwUsedEntries;
+		}
+	} else {
+		dwBase = lpArray->dwElementCount;
+		for(lpPage = lpArray->pageList.lpLastPage; lpPage != NULL; lpPage = lpPage->pageList.lpPrev) {
+			dwBase = dwBase - lpPage->dwUsedEntries;
+			if(dwIndex >= dwBase) { return lpPage->entries[dwIndex - dwBase]; }
+		}
+	}
+	return NULL;
+}
+
+static struct cjsonValue* cjsonPath_SelectOne(
+	const struct cjsonPath_Step* lpStep,
+	struct cjsonValue* lpValue
+) {
+	struct cjsonValue* lpChild;
+
+	if(lpValue->type == cjsonObject) {
+		if(lpStep->type == cjsonPath_StepType__Index) { return NULL; }
+		if(cjsonObject_GetKey(lpValue, &(lpStep->key), &lpChild) != cjsonE_Ok) { return NULL; }
+		return lpChild;
+	}
+	if(lpValue->type == cjsonArray) {
+		if(lpStep->type == cjsonPath_StepType__Member) { return NULL; }
+		if(lpStep->lIndex < 0) {
+			/* Negative indices only exist in JSONPath, tokens that are no index use -1 too */
+			if(lpStep->type == cjsonPath_StepType__Token) { return NULL; }
+		}
+		return cjsonPath_ArrayAt((const struct cjsonArray*)lpValue, lpStep->lIndex);
+	}
+	return NULL;
+}
+
+static inline unsigned long int cjsonPath_SliceBound(
+	signed long int lBound,
+	unsigned long int dwLength
+) {
+	if(lBound < 0) {
+		if((unsigned long int)(-(lBound + 1)) >= dwLength) { return 0; }
+		return dwLength - (unsigned long int)(-(lBound + 1)) - 1;
+	}
+	return ((unsigned long int)lBound > dwLength) ? dwLength : (unsigned long int)lBound;
+}
+static void cjsonPath_StartChildren(
+	struct cjsonPath_Frame* lpFrame,
+	const struct cjsonPath_Step* lpStep
+) {
+	const struct cjsonArray* lpArray;
+
+	lpFrame->bStarted = 1;
+	lpFrame->lpEntry = NULL;
+	lpFrame->dwPosition = 0;
+	lpFrame->dwEnd = 0;
+	lpFrame->dwStride = 1;
+	lpFrame->lpPage = NULL;
+	lpFrame->dwPageBase = 0;
+
+	if(lpFrame->lpValue->type != cjsonArray) { return; }
+
+	lpArray = (const struct cjsonArray*)lpFrame->lpValue;
+	lpFrame->lpPage = lpArray->pageList.lpFirstPage;
+	lpFrame->dwEnd = lpArray->dwElementCount;
+	if(lpStep->type != cjsonPath_StepType__Slice) { return; }
+
+	if((lpStep->dwFlags & CJSON_PATH_SLICE__START) != 0) { lpFrame->dwPosition = cjsonPath_SliceBound(lpStep->lIndex, lpArray->dwElementCount); }
+	if((lpStep->dwFlags & CJSON_PATH_SLICE__END) != 0) { lpFrame->dwEnd = cjsonPath_SliceBound(lpStep->lEnd, lpArray->dwElementCount); }
+	lpFrame->dwStride = lpStep->dwStride;
+}
+static struct cjsonValue* cjsonPath_NextChild(
+	struct cjsonPath_Frame* lpFrame,
+	const struct cjsonPath_Step* lpStep
+) {
+	const struct cjsonObject* lpObject;
+	struct cjsonValue* lpChild;
+
+	if(lpFrame->lpValue->type == cjsonArray) {
+		if(lpFrame->dwPosition >= lpFrame->dwEnd) { return NULL; }
+		while(lpFrame->dwPosition >= lpFrame->dwPageBase + lpFrame->lpPage->dwUsedEntries) {
+			lpFrame->dwPageBase = lpFrame->dwPageBase + lpFrame->lpPage->dwUsedEntries;
+			lpFrame->lpPage = lpFrame->lpPage->pageList.lpNext;
+		}
+		lpChild = lpFrame->lpPage->entries[lpFrame->dwPosition - lpFrame->dwPageBase];
+		lpFrame->dwPosition = (lpFrame->dwEnd - lpFrame->dwPosition > lpFrame->dwStride) ? lpFrame->dwPosition + lpFrame->dwStride : lpFrame->dwEnd;
+		return lpChild;
+	}
+
+	if(lpFrame->lpValue->type != cjsonObject) { return NULL; }
+	if((lpStep->type == cjsonPath_StepType__Slice) && ((lpStep->dwFlags & CJSON_PATH_SLICE__OBJECTS) == 0)) { return NULL; }
+
+	lpObject = (const struct cjsonObject*)lpFrame->lpValue;
+	while(lpFrame->lpEntry == NULL) {
+		if(lpFrame->dwPosition >= lpObject->dwBucketCount) { return NULL; }
+		lpFrame->lpEntry = lpObject->buckets[lpFrame->dwPosition];
+		lpFrame->dwPosition = lpFrame->dwPosition + 1;
+	}
+
+	lpChild = lpFrame->lpEntry->lpValue;
+	lpFrame->lpEntry = lpFrame->lpEntry->bucketList.lpNext;
+	if(lpFrame->lpEntry != NULL) { CJSON_PREFETCH(lpFrame->lpEntry); }
+	return lpChild;
+}
+
+enum cjsonError cjsonPath_Eval(
+	const struct cjsonPath* lpPath,
+	struct cjsonValue* lpRoot,
+	cjsonPath_Callback callback,
+	void* lpFreeParam
+) {
+	struct cjsonPath_Frame stackBase[CJSON_PATH_STACKSEGMENT];
+	struct cjsonScratch_Stack stack;
+	struct cjsonPath_Frame* lpFrame;
+	const struct cjsonPath_Step* lpStep;
+	struct cjsonValue* lpChild;
+	unsigned long int dwStep;
+	enum cjsonError e;
+
+	if((lpPath == NULL) || (lpRoot == NULL) || (callback == NULL)) { return cjsonE_InvalidParam; }
+
+	cjsonScratch_StackInit(&stack, (void*)stackBase, sizeof(struct cjsonPath_Frame), CJSON_PATH_STACKSEGMENT, lpPath->lpSystem);
+	cjsonPath_Push(&stack, lpRoot, 0);
+
+	while(!CJSON_SCRATCH_EMPTY(&stack)) {
+		lpFrame = (struct cjsonPath_Frame*)CJSON_SCRATCH_TOP(&stack);
+
+		if(lpFrame->dwStep == lpPath->dwStepCount) {
+			e = callback(lpFrame->lpValue, lpFreeParam);
+			cjsonScratch_Pop(&stack);
+			if(e != cjsonE_Ok) {
+				cjsonScratch_StackRelease(&stack);
+				return (e == cjsonE_Finished) ? cjsonE_Ok : e;
+			}
+			continue;
+		}
+
+		lpStep = &(lpPath->steps[lpFrame->dwStep]);
+		if((lpStep->type == cjsonPath_StepType__Token) || (lpStep->type == cjsonPath_StepType__Member) || (lpStep->type == cjsonPath_StepType__Index)) {
+			lpChild = cjsonPath_SelectOne(lpStep, lpFrame->lpValue);
+			if(lpChild == NULL) {
+				cjsonScratch_Pop(&stack);
+			} else {
+				lpFrame->lpValue = lpChild;
+				lpFrame->dwStep = lpFrame->dwStep + 1;
+			}
+			continue;
+		}
+
+		if(lpFrame->bStarted == 0) {
+			cjsonPath_StartChildren(lpFrame, lpStep);
+			if(lpStep->type == cjsonPath_StepType__Descendants) {
+				if(cjsonPath_Push(&stack, lpFrame->lpValue, lpFrame->dwStep + 1) == 0) {
+					cjsonScratch_StackRelease(&stack);
+					return cjsonE_OutOfMemory;
+				}
+			}
+			continue;
+		}
+
+		lpChild = cjsonPath_NextChild(lpFrame, lpStep);
+		if(lpChild == NULL) {
+			cjsonScratch_Pop(&stack);
+			continue;
+		}
+		dwStep = (lpStep->type == cjsonPath_StepType__Descendants) ? lpFrame->dwStep : lpFrame->dwStep + 1;
+		if(cjsonPath_Push(&stack, lpChild, dwStep) == 0) {
+			cjsonScratch_StackRelease(&stack);
+			return cjsonE_OutOfMemory;
+		}
+	}
+
+	return cjsonE_Ok;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,379 @@
+#ifndef _POSIX_C_SOURCE
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_PROFILER_INITIALSLOTS
+	#define CJSON_PROFILER_INITIALSLOTS 1024		/* Initial size of the table of sampled live blocks (power of two) */
+#endif
+
+/*
+	Sampled blocks that are still alive are kept in an open
+	addressing table (linear probing, backward shift deletion)
+	so the size and site are known again when they are freed.
+*/
+struct cjsonProfiler_Slot {
+	void*										lpBlock;		/* NULL if the slot is empty */
+	unsigned long int							dwSize;
+	enum cjsonAllocSite							eSite;
+};
+
+struct cjsonProfiler {
+	struct cjsonSystemAPI						base;			/* Has to be the first member, handed out as system API */
+	struct cjsonSystemAPI*						lpParentSystem;
+	unsigned long int							dwSampleRate;
+
+	pthread_mutex_t								lock;
+	struct cjsonProfiler_Slot*					lpSlots;
+	unsigned long int							dwSlotCount;
+	unsigned long int							dwSlotsUsed;
+
+	struct cjsonProfiler_Stats					stats;
+};
+
+static const char* cjsonProfiler_SiteNames[cjsonAllocSite__Count] = {
+	"other",
+	"object_create",
+	"object_set",
+	"array_push",
+	"string",
+	"parser_stack",
+	"parser_buffer",
+	"serializer_stack"
+};
+
+static inline enum cjsonError cjsonProfiler_ParentAlloc(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpSystem->alloc(lpSystem, dwSize, lpOut);
+	}
+}
+static inline void cjsonProfiler_ParentFree(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+
+static inline uint64_t cjsonProfiler_HashAddress(
+	const void* lpBlock
+) {
+	uint64_t qwHash = (uint64_t)((uintptr_t)lpBlock);
+
+	/* Finalizer of MurmurHash3, low bits of addresses are mostly constant */
+	qwHash = qwHash ^ (qwHash >> 33);
+	qwHash = qwHash * 0xFF51AFD7ED558CCDULL;
+	qwHash = qwHash ^ (qwHash >> 33);
+	qwHash = qwHash * 0xC4CEB9FE1A85EC53ULL;
+	qwHash = qwHash ^ (qwHash >> 33);
+	return qwHash;
+}
+static inline int cjsonProfiler_IsSampled(
+	const struct cjsonProfiler* lpProfiler,
+	const void* lpBlock
+) {
+	if(lpProfiler->dwSampleRate <= 1) { return 1; }
+	return (cjsonProfiler_HashAddress(lpBlock) % lpProfiler->dwSampleRate) == 0;
+}
+static inline unsigned long int cjsonProfiler_SlotIndex(
+	const void* lpBlock,
+	unsigned long int dwMask
+) {
+	/* Sampling constrains the low bits of the hash, the table uses the high bits */
+	return (unsigned long int)(cjsonProfiler_HashAddress(lpBlock) >> 32) & dwMask;
+}
+static inline unsigned long int cjsonProfiler_SizeClass(
+	unsigned long int dwSize
+) {
+	unsigned long int dwClass = 0;
+	unsigned long int dwLimit = 16;
+
+	while((dwSize > dwLimit) && (dwClass < CJSON_PROFILER_SIZECLASSES - 1)) {
+		dwLimit = dwLimit << 1;
+		dwClass = dwClass + 1;
+	}
+	return dwClass;
+}
+
+/*
+	Slot table (called with the lock held)
+*/
+static enum cjsonError cjsonProfiler_Grow(
+	struct cjsonProfiler* lpProfiler
+) {
+	enum cjsonError e;
+	struct cjsonProfiler_Slot* lpOld = lpProfiler->lpSlots;
+	struct cjsonProfiler_Slot* lpNew;
+	unsigned long int dwOldCount = lpProfiler->dwSlotCount;
+	unsigned long int dwNewCount = (dwOldCount == 0) ? CJSON_PROFILER_INITIALSLOTS : dwOldCount * 2;
+	unsigned long int i;
+	unsigned long int j;
+
+	e = cjsonProfiler_ParentAlloc(lpProfiler->lpParentSystem, sizeof(struct cjsonProfiler_Slot) * dwNewCount, (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+	memset(lpNew, 0, sizeof(struct cjsonProfiler_Slot) * dwNewCount);
+
+	for(i = 0; i < dwOldCount; i=i+1) {
+		if(lpOld[i].lpBlock == NULL) { continue; }
+		j = cjsonProfiler_SlotIndex(lpOld[i].lpBlock, dwNewCount - 1);
+		while(lpNew[j].lpBlock != NULL) { j = (j + 1) & (dwNewCount - 1); }
+		lpNew[j] = lpOld[i];
+	}
+
+	if(lpOld != NULL) { cjsonProfiler_ParentFree(lpProfiler->lpParentSystem, lpOld); }
+	lpProfiler->lpSlots = lpNew;
+	lpProfiler->dwSlotCount = dwNewCount;
+	return cjsonE_Ok;
+}
+static int cjsonProfiler_Insert(
+	struct cjsonProfiler* lpProfiler,
+	void* lpBlock,
+	unsigned long int dwSize,
+	enum cjsonAllocSite eSite
+) {
+	unsigned long int j;
+
+	if((lpProfiler->dwSlotsUsed + 1) * 2 > lpProfiler->dwSlotCount) {
+		if(cjsonProfiler_Grow(lpProfiler) != cjsonE_Ok) { return 0; }
+	}
+
+	j = cjsonProfiler_SlotIndex(lpBlock, lpProfiler->dwSlotCount - 1);
+	while(lpProfiler->lpSlots[j].lpBlock != NULL) { j = (j + 1) & (lpProfiler->dwSlotCount - 1); }
+	lpProfiler->lpSlots[j].lpBlock = lpBlock;
+	lpProfiler->lpSlots[j].dwSize = dwSize;
+	lpProfiler->lpSlots[j].eSite = eSite;
+	lpProfiler->dwSlotsUsed = lpProfiler->dwSlotsUsed + 1;
+	return 1;
+}
+static int cjsonProfiler_Remove(
+	struct cjsonProfiler* lpProfiler,
+	void* lpBlock,
+	struct cjsonProfiler_Slot* lpSlotOut
+) {
+	unsigned long int dwMask = lpProfiler->dwSlotCount - 1;
+	unsigned long int i;
+	unsigned long int j;
+	unsigned long int k;
+
+	if(lpProfiler->dwSlotCount == 0) { return 0; }
+
+	i = cjsonProfiler_SlotIndex(lpBlock, dwMask);
+	for(;;) {
+		if(lpProfiler->lpSlots[i].lpBlock == NULL) { return 0; }
+		if(lpProfiler->lpSlots[i].lpBlock == lpBlock) { break; }
+		i = (i + 1) & dwMask;
+	}
+	(*lpSlotOut) = lpProfiler->lpSlots[i];
+
+	/* Shift following entries of the cluster back into the gap */
+	j = i;
+	for(;;) {
+		lpProfiler->lpSlots[i].lpBlock = NULL;
+		for(;;) {
+			j = (j + 1) & dwMask;
+			if(lpProfiler->lpSlots[j].lpBlock == NULL) {
+				lpProfiler->dwSlotsUsed = lpProfiler->dwSlotsUsed - 1;
+				return 1;
+			}
+			k = cjsonProfiler_SlotIndex(lpProfiler->lpSlots[j].lpBlock, dwMask);
+			/* Entry at j may move to i if its home k is not cyclically inside (i, j] */
+			if((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) { continue; }
+			break;
+		}
+		lpProfiler->lpSlots[i] = lpProfiler->lpSlots[j];
+		i = j;
+	}
+}
+
+static enum cjsonError cjsonProfiler_Record(
+	struct cjsonProfiler* lpProfiler,
+	enum cjsonAllocSite eSite,
+	unsigned long int dwSize,
+	void** lpDataOut
+) {
+	enum cjsonError e;
+	struct cjsonProfiler_SiteStats* lpSite;
+
+	if(lpDataOut == NULL) { return cjsonE_InvalidParam; }
+	if((unsigned int)eSite >= (unsigned int)cjsonAllocSite__Count) { eSite = cjsonAllocSite__Other; }
+
+	e = cjsonProfiler_ParentAlloc(lpProfiler->lpParentSystem, dwSize, lpDataOut);
+	if(e != cjsonE_Ok) { return e; }
+	if(cjsonProfiler_IsSampled(lpProfiler, *lpDataOut) == 0) { return cjsonE_Ok; }
+
+	pthread_mutex_lock(&(lpProfiler->lock));
+	if(cjsonProfiler_Insert(lpProfiler, *lpDataOut, dwSize, eSite) != 0) {
+		lpSite = &(lpProfiler->stats.sites[eSite]);
+		lpSite->qwAllocations = lpSite->qwAllocations + 1;
+		lpSite->qwBytes = lpSite->qwBytes + dwSize;
+		lpSite->qwLiveBytes = lpSite->qwLiveBytes + dwSize;
+		if(lpSite->qwLiveBytes > lpSite->qwPeakLiveBytes) { lpSite->qwPeakLiveBytes = lpSite->qwLiveBytes; }
+		lpSite->qwSizeClasses[cjsonProfiler_SizeClass(dwSize)] = lpSite->qwSizeClasses[cjsonProfiler_SizeClass(dwSize)] + 1;
+
+		lpProfiler->stats.qwLiveBytes = lpProfiler->stats.qwLiveBytes + dwSize;
+		if(lpProfiler->stats.qwLiveBytes > lpProfiler->stats.qwPeakLiveBytes) { lpProfiler->stats.qwPeakLiveBytes = lpProfiler->stats.qwLiveBytes; }
+	}
+	pthread_mutex_unlock(&(lpProfiler->lock));
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonProfiler_Alloc(
+	struct cjsonSystemAPI* lpSelf,
+	unsigned long int dwSize,
+	void** lpDataOut
+) {
+	return cjsonProfiler_Record((struct cjsonProfiler*)lpSelf, cjsonAllocSite__Other, dwSize, lpDataOut);
+}
+static enum cjsonError cjsonProfiler_Free(
+	struct cjsonSystemAPI* lpSelf,
+	void* lpObject
+) {
+	struct cjsonProfiler* lpProfiler = (struct cjsonProfiler*)lpSelf;
+	struct cjsonProfiler_SiteStats* lpSite;
+	struct cjsonProfiler_Slot slot;
+
+	if(lpObject == NULL) { return cjsonE_Ok; }
+
+	if(cjsonProfiler_IsSampled(lpProfiler, lpObject) != 0) {
+		pthread_mutex_lock(&(lpProfiler->lock));
+		if(cjsonProfiler_Remove(lpProfiler, lpObject, &slot) != 0) {
+			lpSite = &(lpProfiler->stats.sites[slot.eSite]);
+			lpSite->qwFrees = lpSite->qwFrees + 1;
+			lpSite->qwLiveBytes = lpSite->qwLiveBytes - slot.dwSize;
+			lpProfiler->stats.qwLiveBytes = lpProfiler->stats.qwLiveBytes - slot.dwSize;
+		}
+		pthread_mutex_unlock(&(lpProfiler->lock));
+	}
+
+	cjsonProfiler_ParentFree(lpProfiler->lpParentSystem, lpObject);
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonSystemAPI_AllocAt(
+	struct cjsonSystemAPI* lpSystem,
+	enum cjsonAllocSite eSite,
+	unsigned long int dwSize,
+	void** lpDataOut
+) {
+	if(lpSystem == NULL) { return cjsonE_InvalidParam; }
+	if(lpSystem->alloc == &cjsonProfiler_Alloc) {
+		return cjsonProfiler_Record((struct cjsonProfiler*)lpSystem, eSite, dwSize, lpDataOut);
+	}
+	return lpSystem->alloc(lpSystem, dwSize, lpDataOut);
+}
+
+enum cjsonError cjsonProfiler_Create(
+	struct cjsonProfiler** lpOut,
+	unsigned long int dwSampleRate,
+	struct cjsonSystemAPI* lpParentSystem
+) {
+	enum cjsonError e;
+	struct cjsonProfiler* lpNew;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+	if(dwSampleRate == 0) { return cjsonE_InvalidParam; }
+
+	e = cjsonProfiler_ParentAlloc(lpParentSystem, sizeof(struct cjsonProfiler), (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+
+	if(pthread_mutex_init(&(lpNew->lock), NULL) != 0) {
+		cjsonProfiler_ParentFree(lpParentSystem, lpNew);
+		return cjsonE_OutOfMemory;
+	}
+
+	lpNew->base.alloc			= &cjsonProfiler_Alloc;
+	lpNew->base.free			= &cjsonProfiler_Free;
+	lpNew->lpParentSystem		= lpParentSystem;
+	lpNew->dwSampleRate			= dwSampleRate;
+	lpNew->lpSlots				= NULL;
+	lpNew->dwSlotCount			= 0;
+	lpNew->dwSlotsUsed			= 0;
+	memset(&(lpNew->stats), 0, sizeof(lpNew->stats));
+	lpNew->stats.dwSampleRate	= dwSampleRate;
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+struct cjsonSystemAPI* cjsonProfiler_System(
+	struct cjsonProfiler* lpProfiler
+) {
+	if(lpProfiler == NULL) { return NULL; }
+	return &(lpProfiler->base);
+}
+struct cjsonProfiler* cjsonProfiler_FromSystem(
+	struct cjsonSystemAPI* lpSystem
+) {
+	if((lpSystem == NULL) || (lpSystem->alloc != &cjsonProfiler_Alloc)) { return NULL; }
+	return (struct cjsonProfiler*)lpSystem;
+}
+enum cjsonError cjsonProfiler_GetStats(
+	struct cjsonProfiler* lpProfiler,
+	struct cjsonProfiler_Stats* lpStatsOut
+) {
+	if((lpProfiler == NULL) || (lpStatsOut == NULL)) { return cjsonE_InvalidParam; }
+
+	pthread_mutex_lock(&(lpProfiler->lock));
+	memcpy(lpStatsOut, &(lpProfiler->stats), sizeof(struct cjsonProfiler_Stats));
+	pthread_mutex_unlock(&(lpProfiler->lock));
+	return cjsonE_Ok;
+}
+void cjsonProfiler_Reset(
+	struct cjsonProfiler* lpProfiler
+) {
+	unsigned long int i;
+	struct cjsonProfiler_SiteStats* lpSite;
+
+	if(lpProfiler == NULL) { return; }
+
+	pthread_mutex_lock(&(lpProfiler->lock));
+	for(i = 0; i < cjsonAllocSite__Count; i=i+1) {
+		lpSite = &(lpProfiler->stats.sites[i]);
+		lpSite->qwAllocations = 0;
+		lpSite->qwFrees = 0;
+		lpSite->qwBytes = 0;
+		lpSite->qwPeakLiveBytes = lpSite->qwLiveBytes;
+		memset(lpSite->qwSizeClasses, 0, sizeof(lpSite->qwSizeClasses));
+	}
+	lpProfiler->stats.qwPeakLiveBytes = lpProfiler->stats.qwLiveBytes;
+	pthread_mutex_unlock(&(lpProfiler->lock));
+}
+const char* cjsonProfiler_SiteName(
+	enum cjsonAllocSite eSite
+) {
+	if((unsigned int)eSite >= (unsigned int)cjsonAllocSite__Count) { return NULL; }
+	return cjsonProfiler_SiteNames[eSite];
+}
+enum cjsonError cjsonProfiler_Release(
+	struct cjsonProfiler* lpProfiler
+) {
+	if(lpProfiler == NULL) { return cjsonE_InvalidParam; }
+
+	if(lpProfiler->lpSlots != NULL) { cjsonProfiler_ParentFree(lpProfiler->lpParentSystem, lpProfiler->lpSlots); }
+	pthread_mutex_destroy(&(lpProfiler->lock));
+	cjsonProfiler_ParentFree(lpProfiler->lpParentSystem, lpProfiler);
+	return cjsonE_Ok;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,567 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define CJSON_READER_NUMBERSIZE 512				/* Longest number copied to the stack for strtod, longer ones use a heap copy */
+
+/*
+	Powers of ten that are exactly representable as double. Used for
+	the fast path of cjsonReader_Double: a mantissa below 2^53 divided
+	or multiplied by an exact power of ten is correctly rounded.
+*/
+static const double cjsonReader_ExactPowersOfTen[23] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+uint32_t cjsonReader_HashKey(
+	const char* lpKey,
+	unsigned long int dwKeyLength
+) {
+	/* Same hash as object buckets so it can be passed to cjsonObject_GetPrehashed */
+	return cjsonObject_HashKey(lpKey, dwKeyLength);
+}
+
+static inline void cjsonReader_SkipWhitespace(
+	struct cjsonReader* lpReader
+) {
+	char bByte;
+
+	while(lpReader->dwPosition < lpReader->dwLength) {
+		bByte = lpReader->lpData[lpReader->dwPosition];
+		if((bByte != ' ') && (bByte != '\t') && (bByte != '\n') && (bByte != '\r')) { return; }
+		lpReader->dwPosition = lpReader->dwPosition + 1;
+	}
+}
+/*
+	Returns the next non whitespace character without consuming it
+	or -1 at the end of the input
+*/
+static inline int cjsonReader_Peek(
+	struct cjsonReader* lpReader
+) {
+	cjsonReader_SkipWhitespace(lpReader);
+	if(lpReader->dwPosition >= lpReader->dwLength) { return -1; }
+	return (int)((unsigned char)lpReader->lpData[lpReader->dwPosition]);
+}
+static inline int cjsonReader_IsDelimiter(
+	struct cjsonReader* lpReader
+) {
+	char bByte;
+
+	if(lpReader->dwPosition >= lpReader->dwLength) { return 1; }
+	bByte = lpReader->lpData[lpReader->dwPosition];
+	return ((bByte == ',') || (bByte == '}') || (bByte == ']') || (bByte == ':') || (bByte == ' ') || (bByte == '\t') || (bByte == '\n') || (bByte == '\r')) ? 1 : 0;
+}
+static int cjsonReader_Literal(
+	struct cjsonReader* lpReader,
+	const char* lpLiteral,
+	unsigned long int dwLiteralLength
+) {
+	if(lpReader->dwLength - lpReader->dwPosition < dwLiteralLength) { return 0; }
+	if(memcmp(&(lpReader->lpData[lpReader->dwPosition]), lpLiteral, dwLiteralLength) != 0) { return 0; }
+
+	lpReader->dwPosition = lpReader->dwPosition + dwLiteralLength;
+	if(cjsonReader_IsDelimiter(lpReader) == 0) {
+		lpReader->dwPosition = lpReader->dwPosition - dwLiteralLength;
+		return 0;
+	}
+	return 1;
+}
+
+static int cjsonReader_Hex4(
+	struct cjsonReader* lpReader,
+	uint32_t* lpOut
+) {
+	unsigned long int i;
+	char bByte;
+
+	if(lpReader->dwLength - lpReader->dwPosition < 4) { return 0; }
+
+	(*lpOut) = 0;
+	for(i = 0; i < 4; i=i+1) {
+		bByte = lpReader->lpData[lpReader->dwPosition + i];
+		if((bByte >= '0') && (bByte <= '9')) {
+			(*lpOut) = (*lpOut) * 16 + (uint32_t)(bByte - '0');
+		} else if((bByte >= 'a') && (bByte <= 'f')) {
+			(*lpOut) = (*lpOut) * 16 + (uint32_t)(bByte - 'a' + 10);
+		} else if((bByte >= 'A') && (bByte <= 'F')) {
+			(*lpOut) = (*lpOut) * 16 + (uint32_t)(bByte - 'A' + 10);
+		} else {
+			return 0;
+		}
+	}
+	lpReader->dwPosition = lpReader->dwPosition + 4;
+	return 1;
+}
+
+/*
+	Decodes a string starting after its opening quote up to and
+	including the closing quote. At most dwBufferSize bytes are
+	stored, the full decoded length is returned in any case.
+*/
+static enum cjsonError cjsonReader_DecodeString(
+	struct cjsonReader* lpReader,
+	char* lpBuffer,
+	unsigned long int dwBufferSize,
+	unsigned long int* lpLengthOut
+) {
+	unsigned long int dwLength = 0;
+	unsigned long int dwRun;
+	unsigned long int dwCopy;
+	uint32_t dwCodepoint;
+	uint32_t dwLow;
+	char bEncoded[4];
+	unsigned long int dwEncoded;
+	unsigned long int i;
+	char bByte;
+
+	for(;;) {
+		/* Copy runs of plain characters at once */
+		dwRun = lpReader->dwPosition;
+		while((dwRun < lpReader->dwLength) && (lpReader->lpData[dwRun] != '"') && (lpReader->lpData[dwRun] != '\\') && ((unsigned char)lpReader->lpData[dwRun] >= 0x20)) {
+			dwRun = dwRun + 1;
+		}
+		dwRun = dwRun - lpReader->dwPosition;
+		if(dwRun > 0) {
+			if(dwLength < dwBufferSize) {
+				dwCopy = ((dwBufferSize - dwLength) < dwRun) ? (dwBufferSize - dwLength) : dwRun;
+				memcpy(&(lpBuffer[dwLength]), &(lpReader->lpData[lpReader->dwPosition]), dwCopy);
+			}
+			dwLength = dwLength + dwRun;
+			lpReader->dwPosition = lpReader->dwPosition + dwRun;
+		}
+
+		if(lpReader->dwPosition >= lpReader->dwLength) { return cjsonE_EncodingError; }
+		bByte = lpReader->lpData[lpReader->dwPosition];
+		lpReader->dwPosition = lpReader->dwPosition + 1;
+
+		if(bByte == '"') {
+			(*lpLengthOut) = dwLength;
+			return cjsonE_Ok;
+		}
+		if(bByte != '\\') { return cjsonE_EncodingError; }		/* Control character */
+
+		if(lpReader->dwPosition >= lpReader->dwLength) { return cjsonE_EncodingError; }
+		bByte = lpReader->lpData[lpReader->dwPosition];
+		lpReader->dwPosition = lpReader->dwPosition + 1;
+
+		dwEncoded = 1;
+		switch(bByte) {
+			case '"':		bEncoded[0] = '"'; break;
+			case '\\':		bEncoded[0] = '\\'; break;
+			case '/':		bEncoded[0] = '/'; break;
+			case 'b':		bEncoded[0] = '\b'; break;
+			case 'f':		bEncoded[0] = '\f'; break;
+			case 'n':		bEncoded[0] = '\n'; break;
+			case 'r':		bEncoded[0] = '\r'; break;
+			case 't':		bEncoded[0] = '\t'; break;
+			case 'u':
+				if(cjsonReader_Hex4(lpReader, &dwCodepoint) == 0) { return cjsonE_EncodingError; }
+				if((dwCodepoint >= 0xDC00) && (dwCodepoint <= 0xDFFF)) { return cjsonE_EncodingError; }
+				if((dwCodepoint >= 0xD800) && (dwCodepoint <= 0xDBFF)) {
+					/* Surrogate pair */
+					if((lpReader->dwLength - lpReader->dwPosition < 2) || (lpReader->lpData[lpReader->dwPosition] != '\\') || (lpReader->lpData[lpReader->dwPosition + 1] != 'u')) { return cjsonE_EncodingError; }
+					lpReader->dwPosition = lpReader->dwPosition + 2;
+					if(cjsonReader_Hex4(lpReader, &dwLow) == 0) { return cjsonE_EncodingError; }
+					if((dwLow < 0xDC00) || (dwLow > 0xDFFF)) { return cjsonE_EncodingError; }
+					dwCodepoint = 0x10000 + ((dwCodepoint - 0xD800) << 10) + (dwLow - 0xDC00);
+				}
+
+				if(dwCodepoint <= 0x7F) {
+					bEncoded[0] = (char)dwCodepoint;
+				} else if(dwCodepoint <= 0x7FF) {
+					bEncoded[0] = (char)(0xC0 | (dwCodepoint >> 6));
+					bEncoded[1] = (char)(0x80 | (dwCodepoint & 0x3F));
+					dwEncoded = 2;
+				} else if(dwCodepoint <= 0xFFFF) {
+					bEncoded[0] = (char)(0xE0 | (dwCodepoint >> 12));
+					bEncoded[1] = (char)(0x80 | ((dwCodepoint >> 6) & 0x3F));
+					bEncoded[2] = (char)(0x80 | (dwCodepoint & 0x3F));
+					dwEncoded = 3;
+				} else {
+					bEncoded[0] = (char)(0xF0 | (dwCodepoint >> 18));
+					bEncoded[1] = (char)(0x80 | ((dwCodepoint >> 12) & 0x3F));
+					bEncoded[2] = (char)(0x80 | ((dwCodepoint >> 6) & 0x3F));
+					bEncoded[3] = (char)(0x80 | (dwCodepoint & 0x3F));
+					dwEncoded = 4;
+				}
+				break;
+			default:
+				return cjsonE_EncodingError;
+		}
+
+		for(i = 0; i < dwEncoded; i=i+1) {
+			if(dwLength < dwBufferSize) { lpBuffer[dwLength] = bEncoded[i]; }
+			dwLength = dwLength + 1;
+		}
+	}
+}
+
+void cjsonReader_Init(
+	struct cjsonReader* lpReader,
+	const char* lpData,
+	unsigned long int dwLength
+) {
+	lpReader->lpData = lpData;
+	lpReader->dwLength = dwLength;
+	lpReader->dwPosition = 0;
+}
+enum cjsonError cjsonReader_Finish(
+	struct cjsonReader* lpReader
+) {
+	if(lpReader == NULL) { return cjsonE_InvalidParam; }
+	return (cjsonReader_Peek(lpReader) == -1) ? cjsonE_Ok : cjsonE_EncodingError;
+}
+
+enum cjsonError cjsonReader_ObjectNext(
+	struct cjsonReader* lpReader,
+	unsigned long int* lpIndex,
+	const char** lpKeyOut,
+	unsigned long int* lpKeyLengthOut,
+	uint32_t* lpKeyHashOut
+) {
+	enum cjsonError e;
+	unsigned long int dwStart;
+	unsigned long int dwEnd;
+	unsigned long int dwLength;
+	int iNext;
+
+	iNext = cjsonReader_Peek(lpReader);
+	if((*lpIndex) == 0) {
+		if(iNext != '{') { return cjsonE_EncodingError; }
+		lpReader->dwPosition = lpReader->dwPosition + 1;
+		iNext = cjsonReader_Peek(lpReader);
+		if(iNext == '}') {
+			lpReader->dwPosition = lpReader->dwPosition + 1;
+			return cjsonE_Finished;
+		}
+	} else {
+		if(iNext == '}') {
+			lpReader->dwPosition = lpReader->dwPosition + 1;
+			return cjsonE_Finished;
+		}
+		if(iNext != ',') { return cjsonE_EncodingError; }
+		lpReader->dwPosition = lpReader->dwPosition + 1;
+		iNext = cjsonReader_Peek(lpReader);
+	}
+	if(iNext != '"') { return cjsonE_EncodingError; }
+	lpReader->dwPosition = lpReader->dwPosition + 1;
+
+	/* Unescaped keys are referenced in place */
+	dwStart = lpReader->dwPosition;
+	dwEnd = dwStart;
+	while((dwEnd < lpReader->dwLength) && (lpReader->lpData[dwEnd] != '"') && (lpReader->lpData[dwEnd] != '\\') && ((unsigned char)lpReader->lpData[dwEnd] >= 0x20)) {
+		dwEnd = dwEnd + 1;
+	}
+	if((dwEnd < lpReader->dwLength) && (lpReader->lpData[dwEnd] == '"')) {
+		(*lpKeyOut) = &(lpReader->lpData[dwStart]);
+		(*lpKeyLengthOut) = dwEnd - dwStart;
+		(*lpKeyHashOut) = cjsonReader_HashKey(&(lpReader->lpData[dwStart]), dwEnd - dwStart);
+		lpReader->dwPosition = dwEnd + 1;
+	} else {
+		e = cjsonReader_DecodeString(lpReader, lpReader->bKey, CJSON_READER_KEYSIZE, &dwLength);
+		if(e != cjsonE_Ok) { return e; }
+
+		(*lpKeyOut) = lpReader->bKey;
+		if(dwLength > CJSON_READER_KEYSIZE) {
+			(*lpKeyLengthOut) = CJSON_READER_KEYSIZE;
+			(*lpKeyHashOut) = 0;
+		} else {
+			(*lpKeyLengthOut) = dwLength;
+			(*lpKeyHashOut) = cjsonReader_HashKey(lpReader->bKey, dwLength);
+		}
+	}
+
+	if(cjsonReader_Peek(lpReader) != ':') { return cjsonE_EncodingError; }
+	lpReader->dwPosition = lpReader->dwPosition + 1;
+
+	(*lpIndex) = (*lpIndex) + 1;
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonReader_ArrayNext(
+	struct cjsonReader* lpReader,
+	unsigned long int* lpIndex
+) {
+	int iNext;
+
+	iNext = cjsonReader_Peek(lpReader);
+	if((*lpIndex) == 0) {
+		if(iNext != '[') { return cjsonE_EncodingError; }
+		lpReader->dwPosition = lpReader->dwPosition + 1;
+		if(cjsonReader_Peek(lpReader) == ']') {
+			lpReader->dwPosition = lpReader->dwPosition + 1;
+			return cjsonE_Finished;
+		}
+	} else {
+		if(iNext == ']') {
+			lpReader->dwPosition = lpReader->dwPosition + 1;
+			return cjsonE_Finished;
+		}
+		if(iNext != ',') { return cjsonE_EncodingError; }
+		lpReader->dwPosition = lpReader->dwPosition + 1;
+	}
+
+	(*lpIndex) = (*lpIndex) + 1;
+	return cjsonE_Ok;
+}
+
+int cjsonReader_IsNull(
+	struct cjsonReader* lpReader
+) {
+	if(cjsonReader_Peek(lpReader) != 'n') { return 0; }
+	return cjsonReader_Literal(lpReader, "null", 4);
+}
+
+/*
+	Reads the digits of an integer, rejects leading zeros as well as
+	fractions and exponents
+*/
+static enum cjsonError cjsonReader_Digits(
+	struct cjsonReader* lpReader,
+	unsigned long int dwLimit,
+	unsigned long int* lpOut
+) {
+	unsigned long int dwValue = 0;
+	unsigned long int dwDigit;
+	unsigned long int dwStart = lpReader->dwPosition;
+	char bByte;
+
+	while(lpReader->dwPosition < lpReader->dwLength) {
+		bByte = lpReader->lpData[lpReader->dwPosition];
+		if((bByte < '0') || (bByte > '9')) { break; }
+
+		dwDigit = (unsigned long int)(bByte - '0');
+		if(dwValue > (dwLimit - dwDigit) / 10) { return cjsonE_EncodingError; }
+		dwValue = dwValue * 10 + dwDigit;
+		lpReader->dwPosition = lpReader->dwPosition + 1;
+	}
+
+	if(lpReader->dwPosition == dwStart) { return cjsonE_EncodingError; }
+	if((lpReader->lpData[dwStart] == '0') && (lpReader->dwPosition - dwStart > 1)) { return cjsonE_EncodingError; }
+	if(cjsonReader_IsDelimiter(lpReader) == 0) { return cjsonE_EncodingError; }
+
+	(*lpOut) = dwValue;
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonReader_ULong(
+	struct cjsonReader* lpReader,
+	unsigned long int* lpOut
+) {
+	if(cjsonReader_Peek(lpReader) == -1) { return cjsonE_EncodingError; }
+	return cjsonReader_Digits(lpReader, ULONG_MAX, lpOut);
+}
+enum cjsonError cjsonReader_SLong(
+	struct cjsonReader* lpReader,
+	signed long int* lpOut
+) {
+	enum cjsonError e;
+	unsigned long int dwMagnitude;
+	int iNext;
+
+	iNext = cjsonReader_Peek(lpReader);
+	if(iNext == '-') {
+		lpReader->dwPosition = lpReader->dwPosition + 1;
+		e = cjsonReader_Digits(lpReader, ((unsigned long int)LONG_MAX) + 1, &dwMagnitude);
+		if(e != cjsonE_Ok) { return e; }
+		(*lpOut) = (dwMagnitude == ((unsigned long int)LONG_MAX) + 1) ? LONG_MIN : -((signed long int)dwMagnitude);
+		return cjsonE_Ok;
+	}
+
+	if(iNext == -1) { return cjsonE_EncodingError; }
+	e = cjsonReader_Digits(lpReader, (unsigned long int)LONG_MAX, &dwMagnitude);
+	if(e != cjsonE_Ok) { return e; }
+	(*lpOut) = (signed long int)dwMagnitude;
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonReader_Double(
+	struct cjsonReader* lpReader,
+	double* lpOut
+) {
+	unsigned long int dwStart;
+	unsigned long int dwPos;
+	uint64_t qwMantissa = 0;
+	unsigned long int dwDigits = 0;
+	long int iExponent = 0;
+	long int iExplicitExponent = 0;
+	int bNegative = 0;
+	int bNegativeExponent = 0;
+	int bExact = 1;
+	char bNumber[CJSON_READER_NUMBERSIZE];
+	char* lpNumber;
+
+	if(cjsonReader_Peek(lpReader) == -1) { return cjsonE_EncodingError; }
+
+	/* Validate the JSON number grammar and collect the mantissa on the way */
+	dwStart = lpReader->dwPosition;
+	dwPos = dwStart;
+	if(lpReader->lpData[dwPos] == '-') { bNegative = 1; dwPos = dwPos + 1; }
+
+	if((dwPos >= lpReader->dwLength) || (lpReader->lpData[dwPos] < '0') || (lpReader->lpData[dwPos] > '9')) { return cjsonE_EncodingError; }
+	if((lpReader->lpData[dwPos] == '0') && (dwPos + 1 < lpReader->dwLength) && (lpReader->lpData[dwPos + 1] >= '0') && (lpReader->lpData[dwPos + 1] <= '9')) { return cjsonE_EncodingError; }
+	while((dwPos < lpReader->dwLength) && (lpReader->lpData[dwPos] >= '0') && (lpReader->lpData[dwPos] <= '9')) {
+		if(dwDigits < 19) { qwMantissa = qwMantissa * 10 + (uint64_t)(lpReader->lpData[dwPos] - '0'); } else { bExact = 0; }
+		if((qwMantissa != 0) || (dwDigits != 0)) { dwDigits = dwDigits + 1; }
+		dwPos = dwPos + 1;
+	}
+	if((dwPos < lpReader->dwLength) && (lpReader->lpData[dwPos] == '.')) {
+		dwPos = dwPos + 1;
+		if((dwPos >= lpReader->dwLength) || (lpReader->lpData[dwPos] < '0') || (lpReader->lpData[dwPos] > '9')) { return cjsonE_EncodingError; }
+		while((dwPos < lpReader->dwLength) && (lpReader->lpData[dwPos] >= '0') && (lpReader->lpData[dwPos] <= '9')) {
+			if(dwDigits < 19) { qwMantissa = qwMantissa * 10 + (uint64_t)(lpReader->lpData[dwPos] - '0'); iExponent = iExponent - 1; } else { bExact = 0; }
+			if((qwMantissa != 0) || (dwDigits != 0)) { dwDigits = dwDigits + 1; }
+			dwPos = dwPos + 1;
+		}
+	}
+	if((dwPos < lpReader->dwLength) && ((lpReader->lpData[dwPos] == 'e') || (lpReader->lpData[dwPos] == 'E'))) {
+		dwPos = dwPos + 1;
+		if((dwPos < lpReader->dwLength) && ((lpReader->lpData[dwPos] == '+') || (lpReader->lpData[dwPos] == '-'))) {
+			bNegativeExponent = (lpReader->lpData[dwPos] == '-') ? 1 : 0;
+			dwPos = dwPos + 1;
+		}
+		if((dwPos >= lpReader->dwLength) || (lpReader->lpData[dwPos] < '0') || (lpReader->lpData[dwPos] > '9')) { return cjsonE_EncodingError; }
+		while((dwPos < lpReader->dwLength) && (lpReader->lpData[dwPos] >= '0') && (lpReader->lpData[dwPos] <= '9')) {
+			if(iExplicitExponent < 100000) { iExplicitExponent = iExplicitExponent * 10 + (long int)(lpReader->lpData[dwPos] - '0'); }
+			dwPos = dwPos + 1;
+		}
+		iExponent = iExponent + (bNegativeExponent ? -iExplicitExponent : iExplicitExponent);
+	}
+
+	lpReader->dwPosition = dwPos;
+	if(cjsonReader_IsDelimiter(lpReader) == 0) { return cjsonE_EncodingError; }
+
+	/* Fast path: exact mantissa and exact power of ten */
+	if((bExact != 0) && (qwMantissa < (1ULL << 53)) && (iExponent >= -22) && (iExponent <= 22)) {
+		if(iExponent < 0) {
+			(*lpOut) = (double)qwMantissa / cjsonReader_ExactPowersOfTen[-iExponent];
+		} else {
+			(*lpOut) = (double)qwMantissa * cjsonReader_ExactPowersOfTen[iExponent];
+		}
+		if(bNegative != 0) { (*lpOut) = -(*lpOut); }
+		return cjsonE_Ok;
+	}
+
+	/* strtod needs a terminated copy, very long numbers don't fit the stack buffer */
+	lpNumber = bNumber;
+	if(dwPos - dwStart >= CJSON_READER_NUMBERSIZE) {
+		lpNumber = (char*)malloc(dwPos - dwStart + 1);
+		if(lpNumber == NULL) { return cjsonE_OutOfMemory; }
+	}
+	memcpy(lpNumber, &(lpReader->lpData[dwStart]), dwPos - dwStart);
+	lpNumber[dwPos - dwStart] = 0;
+	(*lpOut) = strtod(lpNumber, NULL);
+	if(lpNumber != bNumber) { free(lpNumber); }
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonReader_Bool(
+	struct cjsonReader* lpReader,
+	int* lpOut
+) {
+	int iNext = cjsonReader_Peek(lpReader);
+
+	if((iNext == 't') && (cjsonReader_Literal(lpReader, "true", 4) != 0)) { (*lpOut) = 1; return cjsonE_Ok; }
+	if((iNext == 'f') && (cjsonReader_Literal(lpReader, "false", 5) != 0)) { (*lpOut) = 0; return cjsonE_Ok; }
+	return cjsonE_EncodingError;
+}
+enum cjsonError cjsonReader_String(
+	struct cjsonReader* lpReader,
+	char* lpBuffer,
+	unsigned long int dwBufferSize,
+	unsigned long int* lpLengthOut
+) {
+	enum cjsonError e;
+	unsigned long int dwLength;
+
+	if((lpBuffer == NULL) || (dwBufferSize == 0)) { return cjsonE_InvalidParam; }
+
+	if(cjsonReader_Peek(lpReader) != '"') { return cjsonE_EncodingError; }
+	lpReader->dwPosition = lpReader->dwPosition + 1;
+
+	e = cjsonReader_DecodeString(lpReader, lpBuffer, dwBufferSize - 1, &dwLength);
+	if(e != cjsonE_Ok) { return e; }
+	if(dwLength > dwBufferSize - 1) { return cjsonE_IndexOutOfBounds; }
+
+	lpBuffer[dwLength] = 0;
+	if(lpLengthOut != NULL) { (*lpLengthOut) = dwLength; }
+	return cjsonE_Ok;
+}
+
+/*
+	Skips a single value and validates it on the way. Containers are
+	walked with cjsonReader_ObjectNext and cjsonReader_ArrayNext, the
+	kind of every open container is kept in a bit stack so closing
+	brackets have to match. Literals and numbers are checked by the
+	same functions that read them.
+*/
+enum cjsonError cjsonReader_Skip(
+	struct cjsonReader* lpReader
+) {
+	enum cjsonError e;
+	uint8_t bObjects[CJSON_READER_SKIPDEPTH / 8];
+	unsigned long int dwDepth = 0;
+	unsigned long int dwIndex;
+	unsigned long int dwLength;
+	const char* lpKey;
+	uint32_t dwHash;
+	double dValue;
+	int bValue;
+	int iNext;
+
+	for(;;) {
+		iNext = cjsonReader_Peek(lpReader);
+		if((iNext == '{') || (iNext == '[')) {
+			if(dwDepth >= CJSON_READER_SKIPDEPTH) { return cjsonE_EncodingError; }
+			dwIndex = 0;
+			if(iNext == '{') {
+				e = cjsonReader_ObjectNext(lpReader, &dwIndex, &lpKey, &dwLength, &dwHash);
+			} else {
+				e = cjsonReader_ArrayNext(lpReader, &dwIndex);
+			}
+			if(e == cjsonE_Ok) {
+				if(iNext == '{') {
+					bObjects[dwDepth / 8] = bObjects[dwDepth / 8] | (uint8_t)(1 << (dwDepth % 8));
+				} else {
+					bObjects[dwDepth / 8] = bObjects[dwDepth / 8] & (uint8_t)~(1 << (dwDepth % 8));
+				}
+				dwDepth = dwDepth + 1;
+				continue;
+			}
+			if(e != cjsonE_Finished) { return e; }
+		} else if(iNext == '"') {
+			lpReader->dwPosition = lpReader->dwPosition + 1;
+			e = cjsonReader_DecodeString(lpReader, NULL, 0, &dwLength);
+			if(e != cjsonE_Ok) { return e; }
+		} else if((iNext == 't') || (iNext == 'f')) {
+			e = cjsonReader_Bool(lpReader, &bValue);
+			if(e != cjsonE_Ok) { return e; }
+		} else if(iNext == 'n') {
+			if(cjsonReader_IsNull(lpReader) == 0) { return cjsonE_EncodingError; }
+		} else {
+			e = cjsonReader_Double(lpReader, &dValue);
+			if(e != cjsonE_Ok) { return e; }
+		}
+
+		/* A value is complete, close finished containers up to the next member or element */
+		for(;;) {
+			if(dwDepth == 0) { return cjsonE_Ok; }
+			dwIndex = 1;
+			if((bObjects[(dwDepth - 1) / 8] & (1 << ((dwDepth - 1) % 8))) != 0) {
+				e = cjsonReader_ObjectNext(lpReader, &dwIndex, &lpKey, &dwLength, &dwHash);
+			} else {
+				e = cjsonReader_ArrayNext(lpReader, &dwIndex);
+			}
+			if(e == cjsonE_Ok) { break; }
+			if(e != cjsonE_Finished) { return e; }
+			dwDepth = dwDepth - 1;
+		}
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,646 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/*
+	A compiled schema is a table of nodes, nested schemas are
+	referenced by their index. Boolean schemas (and missing
+	keywords) are represented by CJSON_SCHEMA_NODE_ANY and
+	CJSON_SCHEMA_NODE_NONE so they never need a table entry.
+
+	Types are a bitmask indexed by enum cjsonElementType, "number"
+	sets all numeric types, "integer" a separate bit that accepts
+	numbers without fractional part.
+*/
+#define CJSON_SCHEMA_TYPE(_t)					(1UL << (_t))
+#define CJSON_SCHEMA_TYPE_NUMBER				(CJSON_SCHEMA_TYPE(cjsonNumber_UnsignedLong) | CJSON_SCHEMA_TYPE(cjsonNumber_SignedLong) | CJSON_SCHEMA_TYPE(cjsonNumber_Double))
+#define CJSON_SCHEMA_TYPE_INTEGER				(1UL << 16)
+#define CJSON_SCHEMA_TYPE_ALL					(CJSON_SCHEMA_TYPE(cjsonObject) | CJSON_SCHEMA_TYPE(cjsonArray) | CJSON_SCHEMA_TYPE(cjsonString) | CJSON_SCHEMA_TYPE_NUMBER | CJSON_SCHEMA_TYPE_INTEGER | CJSON_SCHEMA_TYPE(cjsonTrue) | CJSON_SCHEMA_TYPE(cjsonFalse) | CJSON_SCHEMA_TYPE(cjsonNull))
+
+#define CJSON_SCHEMA_FLAG_MINIMUM				0x00000001
+#define CJSON_SCHEMA_FLAG_MAXIMUM				0x00000002
+#define CJSON_SCHEMA_FLAG_EXCLUSIVEMINIMUM		0x00000004
+#define CJSON_SCHEMA_FLAG_EXCLUSIVEMAXIMUM		0x00000008
+#define CJSON_SCHEMA_FLAG_MAXLENGTH				0x00000010
+#define CJSON_SCHEMA_FLAG_ENUM					0x00000020
+
+#define CJSON_SCHEMA_NOTREQUIRED				(~0UL)
+
+struct cjsonSchema_Property {
+	uint32_t								dwHash;
+	char*									lpKey;
+	unsigned long int						dwKeyLength;
+	unsigned long int						dwNode;
+	unsigned long int						dwRequiredBit;		/* CJSON_SCHEMA_NOTREQUIRED if optional */
+};
+struct cjsonSchema_Node {
+	unsigned long int						dwTypes;
+	uint32_t								dwFlags;
+
+	double									dMinimum;
+	double									dMaximum;
+	double									dExclusiveMinimum;
+	double									dExclusiveMaximum;
+	unsigned long int						dwMaxLength;
+
+	struct cjsonValue**						lpEnum;				/* Private copies of the allowed values */
+	unsigned long int						dwEnumCount;
+
+	struct cjsonSchema_Property*			lpProperties;		/* Sorted by hash, length and key */
+	unsigned long int						dwPropertyCount;
+	unsigned long int						dwPropertyCapacity;
+	uint64_t								qwRequired;			/* Bits of all required properties */
+	unsigned long int						dwAdditional;
+
+	unsigned long int						dwItems;
+};
+struct cjsonSchema {
+	struct cjsonSystemAPI*					lpSystem;
+	struct cjsonSchema_Node*				lpNodes;
+	unsigned long int						dwNodeCount;
+	unsigned long int						dwNodeCapacity;
+};
+
+/*
+	Malloc and free abstraction
+*/
+static inline enum cjsonError cjsonSchema_Alloc(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpSystem->alloc(lpSystem, dwSize, lpOut);
+	}
+}
+static inline void cjsonSchema_Free(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpBlock == NULL) { return; }
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+
+static int cjsonSchema_CompareProperty(
+	uint32_t dwHash,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	const struct cjsonSchema_Property* lpProperty
+) {
+	if(dwHash != lpProperty->dwHash) { return (dwHash < lpProperty->dwHash) ? -1 : 1; }
+	if(dwKeyLength != lpProperty->dwKeyLength) { return (dwKeyLength < lpProperty->dwKeyLength) ? -1 : 1; }
+	if(dwKeyLength == 0) { return 0; }
+	return memcmp(lpKey, lpProperty->lpKey, dwKeyLength);
+}
+static struct cjsonSchema_Property* cjsonSchema_FindProperty(
+	const struct cjsonSchema_Node* lpNode,
+	const char* lpKey,
+	unsigned long int dwKeyLength
+) {
+	uint32_t dwHash = cjsonReader_HashKey(lpKey, dwKeyLength);
+	unsigned long int dwLow = 0;
+	unsigned long int dwHigh = lpNode->dwPropertyCount;
+	unsigned long int dwMid;
+	int iCmp;
+
+	while(dwLow < dwHigh) {
+		dwMid = dwLow + (dwHigh - dwLow) / 2;
+		iCmp = cjsonSchema_CompareProperty(dwHash, lpKey, dwKeyLength, &(lpNode->lpProperties[dwMid]));
+		if(iCmp == 0) { return &(lpNode->lpProperties[dwMid]); }
+		if(iCmp < 0) { dwHigh = dwMid; } else { dwLow = dwMid + 1; }
+	}
+	return NULL;
+}
+
+static inline int cjsonSchema_IsKey(
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	const char* lpKeyword
+) {
+	return ((strlen(lpKeyword) == dwKeyLength) && (memcmp(lpKey, lpKeyword, dwKeyLength) == 0)) ? 1 : 0;
+}
+static int cjsonSchema_GetNumber(
+	const struct cjsonValue* lpValue,
+	double* lpOut
+) {
+	if(!cjsonIsNumeric(lpValue)) { return 0; }
+	(*lpOut) = cjsonObject_GetAsDouble((struct cjsonValue*)lpValue);
+	return 1;
+}
+
+/*
+	Compilation
+*/
+struct cjsonSchema_CompileContext {
+	struct cjsonSchema*						lpSchema;
+	unsigned long int						dwNode;
+	unsigned long int						dwDepth;
+	const struct cjsonValue*				lpRequired;
+};
+
+static enum cjsonError cjsonSchema_CompileNode(struct cjsonSchema* lpSchema, const struct cjsonValue* lpDocument, unsigned long int dwDepth, unsigned long int* lpNodeOut);
+
+
+static enum cjsonError cjsonSchema_NewNode(
+	struct cjsonSchema* lpSchema,
+	unsigned long int* lpNodeOut
+) {
+	struct cjsonSchema_Node* lpNew;
+	struct cjsonSchema_Node* lpNode;
+	enum cjsonError e;
+
+	if(lpSchema->dwNodeCount == lpSchema->dwNodeCapacity) {
+		e = cjsonSchema_Alloc(lpSchema->lpSystem, sizeof(struct cjsonSchema_Node) * (lpSchema->dwNodeCapacity * 2 + 8), (void**)&lpNew);
+		if(e != cjsonE_Ok) { return e; }
+		if(lpSchema->dwNodeCount > 0) { memcpy(lpNew, lpSchema->lpNodes, sizeof(struct cjsonSchema_Node) * lpSchema->dwNodeCount); }
+		cjsonSchema_Free(lpSchema->lpSystem, lpSchema->lpNodes);
+		lpSchema->lpNodes = lpNew;
+		lpSchema->dwNodeCapacity = lpSchema->dwNodeCapacity * 2 + 8;
+	}
+
+	lpNode = &(lpSchema->lpNodes[lpSchema->dwNodeCount]);
+	lpNode->dwTypes = CJSON_SCHEMA_TYPE_ALL;
+	lpNode->dwFlags = 0;
+	lpNode->dMinimum = 0;
+	lpNode->dMaximum = 0;
+	lpNode->dExclusiveMinimum = 0;
+	lpNode->dExclusiveMaximum = 0;
+	lpNode->dwMaxLength = 0;
+	lpNode->lpEnum = NULL;
+	lpNode->dwEnumCount = 0;
+	lpNode->lpProperties = NULL;
+	lpNode->dwPropertyCount = 0;
+	lpNode->dwPropertyCapacity = 0;
+	lpNode->qwRequired = 0;
+	lpNode->dwAdditional = CJSON_SCHEMA_NODE_ANY;
+	lpNode->dwItems = CJSON_SCHEMA_NODE_ANY;
+
+	(*lpNodeOut) = lpSchema->dwNodeCount;
+	lpSchema->dwNodeCount = lpSchema->dwNodeCount + 1;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonSchema_AddProperty(
+	struct cjsonSchema* lpSchema,
+	unsigned long int dwNode,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	unsigned long int dwValueNode
+) {
+	struct cjsonSchema_Node* lpNode = &(lpSchema->lpNodes[dwNode]);
+	struct cjsonSchema_Property* lpNew;
+	uint32_t dwHash = cjsonReader_HashKey(lpKey, dwKeyLength);
+	char* lpKeyCopy;
+	unsigned long int dwPos;
+	enum cjsonError e;
+
+	if(lpNode->dwPropertyCount == lpNode->dwPropertyCapacity) {
+		e = cjsonSchema_Alloc(lpSchema->lpSystem, sizeof(struct cjsonSchema_Property) * (lpNode->dwPropertyCapacity * 2 + 4), (void**)&lpNew);
+		if(e != cjsonE_Ok) { return e; }
+		if(lpNode->dwPropertyCount > 0) { memcpy(lpNew, lpNode->lpProperties, sizeof(struct cjsonSchema_Property) * lpNode->dwPropertyCount); }
+		cjsonSchema_Free(lpSchema->lpSystem, lpNode->lpProperties);
+		lpNode->lpProperties = lpNew;
+		lpNode->dwPropertyCapacity = lpNode->dwPropertyCapacity * 2 + 4;
+	}
+
+	e = cjsonSchema_Alloc(lpSchema->lpSystem, dwKeyLength + 1, (void**)&lpKeyCopy);
+	if(e != cjsonE_Ok) { return e; }
+	if(dwKeyLength > 0) { memcpy(lpKeyCopy, lpKey, dwKeyLength); }
+	lpKeyCopy[dwKeyLength] = 0;
+
+	/* Insertion keeps the table sorted, property lists are short */
+	for(dwPos = lpNode->dwPropertyCount; dwPos > 0; dwPos = dwPos - 1) {
+		if(cjsonSchema_CompareProperty(dwHash, lpKey, dwKeyLength, &(lpNode->lpProperties[dwPos - 1])) > 0) { break; }
+	}
+	memmove(&(lpNode->lpProperties[dwPos + 1]), &(lpNode->lpProperties[dwPos]), sizeof(struct cjsonSchema_Property) * (lpNode->dwPropertyCount - dwPos));
+	lpNode->lpProperties[dwPos].dwHash = dwHash;
+	lpNode->lpProperties[dwPos].lpKey = lpKeyCopy;
+	lpNode->lpProperties[dwPos].dwKeyLength = dwKeyLength;
+	lpNode->lpProperties[dwPos].dwNode = dwValueNode;
+	lpNode->lpProperties[dwPos].dwRequiredBit = CJSON_SCHEMA_NOTREQUIRED;
+	lpNode->dwPropertyCount = lpNode->dwPropertyCount + 1;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonSchema_AddEnumValue(
+	struct cjsonSchema* lpSchema,
+	unsigned long int dwNode,
+	const struct cjsonValue* lpValue,
+	unsigned long int dwCapacity
+) {
+	struct cjsonSchema_Node* lpNode = &(lpSchema->lpNodes[dwNode]);
+	enum cjsonError e;
+
+	if(lpNode->lpEnum == NULL) {
+		e = cjsonSchema_Alloc(lpSchema->lpSystem, sizeof(struct cjsonValue*) * ((dwCapacity > 0) ? dwCapacity : 1), (void**)&(lpNode->lpEnum));
+		if(e != cjsonE_Ok) { return e; }
+		lpNode->dwFlags = lpNode->dwFlags | CJSON_SCHEMA_FLAG_ENUM;
+	}
+	if(lpValue == NULL) { return cjsonE_Ok; }
+
+	e = cjsonValue_Clone(lpValue, lpSchema->lpSystem, &(lpNode->lpEnum[lpNode->dwEnumCount]));
+	if(e != cjsonE_Ok) { return e; }
+	lpNode->dwEnumCount = lpNode->dwEnumCount + 1;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonSchema_TypeMask(
+	const struct cjsonValue* lpName,
+	unsigned long int* lpMaskInOut
+) {
+	const char* lpType;
+	unsigned long int dwLength;
+
+	if((lpName == NULL) || (lpName->type != cjsonString)) { return cjsonE_InvalidParam; }
+	lpType = cjsonString_Get((struct cjsonValue*)lpName);
+	dwLength = cjsonString_Strlen((struct cjsonValue*)lpName);
+
+	if(cjsonSchema_IsKey(lpType, dwLength, "null")) { (*lpMaskInOut) = (*lpMaskInOut) | CJSON_SCHEMA_TYPE(cjsonNull); }
+	else if(cjsonSchema_IsKey(lpType, dwLength, "boolean")) { (*lpMaskInOut) = (*lpMaskInOut) | CJSON_SCHEMA_TYPE(cjsonTrue) | CJSON_SCHEMA_TYPE(cjsonFalse); }
+	else if(cjsonSchema_IsKey(lpType, dwLength, "object")) { (*lpMaskInOut) = (*lpMaskInOut) | CJSON_SCHEMA_TYPE(cjsonObject); }
+	else if(cjsonSchema_IsKey(lpType, dwLength, "array")) { (*lpMaskInOut) = (*lpMaskInOut) | CJSON_SCHEMA_TYPE(cjsonArray); }
+	else if(cjsonSchema_IsKey(lpType, dwLength, "number")) { (*lpMaskInOut) = (*lpMaskInOut) | CJSON_SCHEMA_TYPE_NUMBER | CJSON_SCHEMA_TYPE_INTEGER; }
+	else if(cjsonSchema_IsKey(lpType, dwLength, "integer")) { (*lpMaskInOut) = (*lpMaskInOut) | CJSON_SCHEMA_TYPE_INTEGER; }
+	else if(cjsonSchema_IsKey(lpType, dwLength, "string")) { (*lpMaskInOut) = (*lpMaskInOut) | CJSON_SCHEMA_TYPE(cjsonString); }
+	else { return cjsonE_InvalidParam; }
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonSchema_CompileProperty(
+	char* lpKey,
+	unsigned long int dwKeyLength,
+	struct cjsonValue* lpValue,
+	void* lpFreeParam
+) {
+	struct cjsonSchema_CompileContext* lpContext = (struct cjsonSchema_CompileContext*)lpFreeParam;
+	unsigned long int dwValueNode;
+	enum cjsonError e;
+
+	e = cjsonSchema_CompileNode(lpContext->lpSchema, lpValue, lpContext->dwDepth + 1, &dwValueNode);
+	if(e != cjsonE_Ok) { return e; }
+	return cjsonSchema_AddProperty(lpContext->lpSchema, lpContext->dwNode, lpKey, dwKeyLength, dwValueNode);
+}
+
+static enum cjsonError cjsonSchema_CompileKeyword(
+	char* lpKey,
+	unsigned long int dwKeyLength,
+	struct cjsonValue* lpValue,
+	void* lpFreeParam
+) {
+	struct cjsonSchema_CompileContext* lpContext = (struct cjsonSchema_CompileContext*)lpFreeParam;
+	struct cjsonSchema* lpSchema = lpContext->lpSchema;
+	struct cjsonValue* lpElement;
+	unsigned long int dwMask;
+	unsigned long int dwChild;
+	unsigned long int i;
+	double dNumber;
+	enum cjsonError e;
+
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "type")) {
+		dwMask = 0;
+		if(lpValue->type == cjsonArray) {
+			for(i = 0; i < cjsonArray_Length(lpValue); i=i+1) {
+				if(cjsonArray_Get(lpValue, i, &lpElement) != cjsonE_Ok) { return cjsonE_InvalidParam; }
+				e = cjsonSchema_TypeMask(lpElement, &dwMask);
+				if(e != cjsonE_Ok) { return e; }
+			}
+		} else {
+			e = cjsonSchema_TypeMask(lpValue, &dwMask);
+			if(e != cjsonE_Ok) { return e; }
+		}
+		lpSchema->lpNodes[lpContext->dwNode].dwTypes = dwMask;
+		return cjsonE_Ok;
+	}
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "properties")) {
+		if(lpValue->type != cjsonObject) { return cjsonE_InvalidParam; }
+		return cjsonObject_Iterate(lpValue, &cjsonSchema_CompileProperty, lpFreeParam);
+	}
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "required")) {
+		/* Resolved after all properties are known */
+		if(lpValue->type != cjsonArray) { return cjsonE_InvalidParam; }
+		lpContext->lpRequired = lpValue;
+		return cjsonE_Ok;
+	}
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "additionalProperties")) {
+		e = cjsonSchema_CompileNode(lpSchema, lpValue, lpContext->dwDepth + 1, &dwChild);
+		if(e != cjsonE_Ok) { return e; }
+		lpSchema->lpNodes[lpContext->dwNode].dwAdditional = dwChild;
+		return cjsonE_Ok;
+	}
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "items")) {
+		/* Tuple validation (array of schemas) is not supported */
+		e = cjsonSchema_CompileNode(lpSchema, lpValue, lpContext->dwDepth + 1, &dwChild);
+		if(e != cjsonE_Ok) { return e; }
+		lpSchema->lpNodes[lpContext->dwNode].dwItems = dwChild;
+		return cjsonE_Ok;
+	}
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "enum") || cjsonSchema_IsKey(lpKey, dwKeyLength, "const")) {
+		/* Combining both is not supported */
+		if((lpSchema->lpNodes[lpContext->dwNode].dwFlags & CJSON_SCHEMA_FLAG_ENUM) != 0) { return cjsonE_InvalidParam; }
+		if(dwKeyLength == 5) { return cjsonSchema_AddEnumValue(lpSchema, lpContext->dwNode, lpValue, 1); }
+
+		if(lpValue->type != cjsonArray) { return cjsonE_InvalidParam; }
+		e = cjsonSchema_AddEnumValue(lpSchema, lpContext->dwNode, NULL, cjsonArray_Length(lpValue));
+		if(e != cjsonE_Ok) { return e; }
+		for(i = 0; i < cjsonArray_Length(lpValue); i=i+1) {
+			if(cjsonArray_Get(lpValue, i, &lpElement) != cjsonE_Ok) { return cjsonE_InvalidParam; }
+			e = cjsonSchema_AddEnumValue(lpSchema, lpContext->dwNode, lpElement, 0);
+			if(e != cjsonE_Ok) { return e; }
+		}
+		return cjsonE_Ok;
+	}
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "minimum")) {
+		if(cjsonSchema_GetNumber(lpValue, &dNumber) == 0) { return cjsonE_InvalidParam; }
+		lpSchema->lpNodes[lpContext->dwNode].dMinimum = dNumber;
+		lpSchema->lpNodes[lpContext->dwNode].dwFlags = lpSchema->lpNodes[lpContext->dwNode].dwFlags | CJSON_SCHEMA_FLAG_MINIMUM;
+		return cjsonE_Ok;
+	}
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "maximum")) {
+		if(cjsonSchema_GetNumber(lpValue, &dNumber) == 0) { return cjsonE_InvalidParam; }
+		lpSchema->lpNodes[lpContext->dwNode].dMaximum = dNumber;
+		lpSchema->lpNodes[lpContext->dwNode].dwFlags = lpSchema->lpNodes[lpContext->dwNode].dwFlags | CJSON_SCHEMA_FLAG_MAXIMUM;
+		return cjsonE_Ok;
+	}
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "exclusiveMinimum")) {
+		if(cjsonSchema_GetNumber(lpValue, &dNumber) == 0) { return cjsonE_InvalidParam; }
+		lpSchema->lpNodes[lpContext->dwNode].dExclusiveMinimum = dNumber;
+		lpSchema->lpNodes[lpContext->dwNode].dwFlags = lpSchema->lpNodes[lpContext->dwNode].dwFlags | CJSON_SCHEMA_FLAG_EXCLUSIVEMINIMUM;
+		return cjsonE_Ok;
+	}
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "exclusiveMaximum")) {
+		if(cjsonSchema_GetNumber(lpValue, &dNumber) == 0) { return cjsonE_InvalidParam; }
+		lpSchema->lpNodes[lpContext->dwNode].dExclusiveMaximum = dNumber;
+		lpSchema->lpNodes[lpContext->dwNode].dwFlags = lpSchema->lpNodes[lpContext->dwNode].dwFlags | CJSON_SCHEMA_FLAG_EXCLUSIVEMAXIMUM;
+		return cjsonE_Ok;
+	}
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "maxLength")) {
+		if(!cjsonIsULong(lpValue)) { return cjsonE_InvalidParam; }
+		lpSchema->lpNodes[lpContext->dwNode].dwMaxLength = cjsonObject_GetAsULong(lpValue);
+		lpSchema->lpNodes[lpContext->dwNode].dwFlags = lpSchema->lpNodes[lpContext->dwNode].dwFlags | CJSON_SCHEMA_FLAG_MAXLENGTH;
+		return cjsonE_Ok;
+	}
+
+	/* Annotations don't influence validation */
+	if(cjsonSchema_IsKey(lpKey, dwKeyLength, "$schema") || cjsonSchema_IsKey(lpKey, dwKeyLength, "$id") || cjsonSchema_IsKey(lpKey, dwKeyLength, "$comment")
+		|| cjsonSchema_IsKey(lpKey, dwKeyLength, "title") || cjsonSchema_IsKey(lpKey, dwKeyLength, "description") || cjsonSchema_IsKey(lpKey, dwKeyLength, "default")
+		|| cjsonSchema_IsKey(lpKey, dwKeyLength, "examples") || cjsonSchema_IsKey(lpKey, dwKeyLength, "format")) {
+		return cjsonE_Ok;
+	}
+
+	/* Silently skipping an unsupported assertion would accept invalid documents */
+	return cjsonE_InvalidParam;
+}
+
+static enum cjsonError cjsonSchema_CompileRequired(
+	struct cjsonSchema* lpSchema,
+	unsigned long int dwNode,
+	const struct cjsonValue* lpRequired
+) {
+	struct cjsonSchema_Property* lpProperty;
+	struct cjsonValue* lpName;
+	unsigned long int dwBit = 0;
+	unsigned long int i;
+	enum cjsonError e;
+
+	for(i = 0; i < cjsonArray_Length(lpRequired); i=i+1) {
+		if(cjsonArray_Get(lpRequired, i, &lpName) != cjsonE_Ok) { return cjsonE_InvalidParam; }
+		if((lpName == NULL) || (lpName->type != cjsonString)) { return cjsonE_InvalidParam; }
+
+		/*
+			Required keys without a property schema are validated by
+			additionalProperties like any other unlisted key
+		*/
+		lpProperty = cjsonSchema_FindProperty(&(lpSchema->lpNodes[dwNode]), cjsonString_Get(lpName), cjsonString_Strlen(lpName));
+		if(lpProperty == NULL) {
+			e = cjsonSchema_AddProperty(lpSchema, dwNode, cjsonString_Get(lpName), cjsonString_Strlen(lpName), lpSchema->lpNodes[dwNode].dwAdditional);
+			if(e != cjsonE_Ok) { return e; }
+			lpProperty = cjsonSchema_FindProperty(&(lpSchema->lpNodes[dwNode]), cjsonString_Get(lpName), cjsonString_Strlen(lpName));
+		}
+		if(lpProperty->dwRequiredBit != CJSON_SCHEMA_NOTREQUIRED) { continue; }
+
+		if(dwBit >= CJSON_SCHEMA_MAXREQUIRED) { return cjsonE_InvalidParam; }
+		lpProperty->dwRequiredBit = dwBit;
+		lpSchema->lpNodes[dwNode].qwRequired = lpSchema->lpNodes[dwNode].qwRequired | (((uint64_t)1) << dwBit);
+		dwBit = dwBit + 1;
+	}
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonSchema_CompileNode(
+	struct cjsonSchema* lpSchema,
+	const struct cjsonValue* lpDocument,
+	unsigned long int dwDepth,
+	unsigned long int* lpNodeOut
+) {
+	struct cjsonSchema_CompileContext context;
+	enum cjsonError e;
+
+	if(lpDocument == NULL) { return cjsonE_InvalidParam; }
+	if(lpDocument->type == cjsonTrue) { (*lpNodeOut) = CJSON_SCHEMA_NODE_ANY; return cjsonE_Ok; }
+	if(lpDocument->type == cjsonFalse) { (*lpNodeOut) = CJSON_SCHEMA_NODE_NONE; return cjsonE_Ok; }
+	if(lpDocument->type != cjsonObject) { return cjsonE_InvalidParam; }
+	if(dwDepth >= CJSON_SCHEMA_MAXDEPTH) { return cjsonE_InvalidParam; }
+
+	context.lpSchema = lpSchema;
+	context.dwDepth = dwDepth;
+	context.lpRequired = NULL;
+	e = cjsonSchema_NewNode(lpSchema, &(context.dwNode));
+	if(e != cjsonE_Ok) { return e; }
+
+	e = cjsonObject_Iterate(lpDocument, &cjsonSchema_CompileKeyword, (void*)&context);
+	if(e != cjsonE_Ok) { return e; }
+
+	if(context.lpRequired != NULL) {
+		e = cjsonSchema_CompileRequired(lpSchema, context.dwNode, context.lpRequired);
+		if(e != cjsonE_Ok) { return e; }
+	}
+
+	(*lpNodeOut) = context.dwNode;
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonSchema_Compile(
+	struct cjsonSchema** lpOut,
+	const struct cjsonValue* lpSchemaDocument,
+	struct cjsonSystemAPI* lpSystem
+) {
+	struct cjsonSchema* lpNew;
+	unsigned long int dwRoot;
+	enum cjsonError e;
+
+	if((lpOut == NULL) || (lpSchemaDocument == NULL)) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+
+	e = cjsonSchema_Alloc(lpSystem, sizeof(struct cjsonSchema), (void**)&lpNew);
+	if(e != cjsonE_Ok) { return e; }
+	lpNew->lpSystem = lpSystem;
+	lpNew->lpNodes = NULL;
+	lpNew->dwNodeCount = 0;
+	lpNew->dwNodeCapacity = 0;
+
+	/* The root always is node 0, boolean schemas get a node of their own */
+	e = cjsonSchema_CompileNode(lpNew, lpSchemaDocument, 0, &dwRoot);
+	if((e == cjsonE_Ok) && (lpNew->dwNodeCount == 0)) {
+		e = cjsonSchema_NewNode(lpNew, &dwRoot);
+		if((e == cjsonE_Ok) && (lpSchemaDocument->type == cjsonFalse)) { lpNew->lpNodes[dwRoot].dwTypes = 0; }
+	}
+	if(e != cjsonE_Ok) {
+		cjsonSchema_Release(lpNew);
+		return e;
+	}
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+void cjsonSchema_Release(
+	struct cjsonSchema* lpSchema
+) {
+	struct cjsonSchema_Node* lpNode;
+	unsigned long int i, j;
+
+	if(lpSchema == NULL) { return; }
+
+	for(i = 0; i < lpSchema->dwNodeCount; i=i+1) {
+		lpNode = &(lpSchema->lpNodes[i]);
+		for(j = 0; j < lpNode->dwPropertyCount; j=j+1) { cjsonSchema_Free(lpSchema->lpSystem, lpNode->lpProperties[j].lpKey); }
+		cjsonSchema_Free(lpSchema->lpSystem, lpNode->lpProperties);
+		for(j = 0; j < lpNode->dwEnumCount; j=j+1) { cjsonReleaseValue(lpNode->lpEnum[j]); }
+		cjsonSchema_Free(lpSchema->lpSystem, lpNode->lpEnum);
+	}
+	cjsonSchema_Free(lpSchema->lpSystem, lpSchema->lpNodes);
+	cjsonSchema_Free(lpSchema->lpSystem, lpSchema);
+}
+
+/*
+	Checks used by the parser
+*/
+enum cjsonError cjsonSchema_CheckStart(
+	const struct cjsonSchema* lpSchema,
+	unsigned long int dwNode,
+	enum cjsonElementType eType
+) {
+	unsigned long int dwTypes;
+
+	if(dwNode == CJSON_SCHEMA_NODE_ANY) { return cjsonE_Ok; }
+	if(dwNode == CJSON_SCHEMA_NODE_NONE) { return cjsonE_SchemaViolation; }
+
+	dwTypes = lpSchema->lpNodes[dwNode].dwTypes;
+	if((eType == cjsonNumber_UnsignedLong) || (eType == cjsonNumber_SignedLong) || (eType == cjsonNumber_Double)) {
+		return ((dwTypes & (CJSON_SCHEMA_TYPE_NUMBER | CJSON_SCHEMA_TYPE_INTEGER)) != 0) ? cjsonE_Ok : cjsonE_SchemaViolation;
+	}
+	return ((dwTypes & CJSON_SCHEMA_TYPE(eType)) != 0) ? cjsonE_Ok : cjsonE_SchemaViolation;
+}
+enum cjsonError cjsonSchema_CheckKey(
+	const struct cjsonSchema* lpSchema,
+	unsigned long int dwNode,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	unsigned long int* lpValueNodeOut,
+	uint64_t* lpRequiredSeenInOut
+) {
+	const struct cjsonSchema_Node* lpNode;
+	const struct cjsonSchema_Property* lpProperty;
+
+	if((dwNode == CJSON_SCHEMA_NODE_ANY) || (dwNode == CJSON_SCHEMA_NODE_NONE)) {
+		(*lpValueNodeOut) = dwNode;
+		return cjsonE_Ok;
+	}
+	lpNode = &(lpSchema->lpNodes[dwNode]);
+
+	lpProperty = (lpNode->dwPropertyCount > 0) ? cjsonSchema_FindProperty(lpNode, lpKey, dwKeyLength) : NULL;
+	if(lpProperty != NULL) {
+		(*lpValueNodeOut) = lpProperty->dwNode;
+		if(lpProperty->dwRequiredBit != CJSON_SCHEMA_NOTREQUIRED) { (*lpRequiredSeenInOut) = (*lpRequiredSeenInOut) | (((uint64_t)1) << lpProperty->dwRequiredBit); }
+	} else {
+		(*lpValueNodeOut) = lpNode->dwAdditional;
+	}
+
+	/* Rejected keys abort before their value is read */
+	return ((*lpValueNodeOut) == CJSON_SCHEMA_NODE_NONE) ? cjsonE_SchemaViolation : cjsonE_Ok;
+}
+enum cjsonError cjsonSchema_CheckRequired(
+	const struct cjsonSchema* lpSchema,
+	unsigned long int dwNode,
+	uint64_t qwRequiredSeen
+) {
+	uint64_t qwRequired;
+
+	if((dwNode == CJSON_SCHEMA_NODE_ANY) || (dwNode == CJSON_SCHEMA_NODE_NONE)) { return cjsonE_Ok; }
+	qwRequired = lpSchema->lpNodes[dwNode].qwRequired;
+	return ((qwRequiredSeen & qwRequired) == qwRequired) ? cjsonE_Ok : cjsonE_SchemaViolation;
+}
+enum cjsonError cjsonSchema_CheckValue(
+	const struct cjsonSchema* lpSchema,
+	unsigned long int dwNode,
+	const struct cjsonValue* lpValue
+) {
+	const struct cjsonSchema_Node* lpNode;
+	const unsigned char* lpString;
+	unsigned long int dwLength;
+	unsigned long int dwCodepoints;
+	unsigned long int i;
+	double dValue;
+
+	if(dwNode == CJSON_SCHEMA_NODE_ANY) { return cjsonE_Ok; }
+	if(dwNode == CJSON_SCHEMA_NODE_NONE) { return cjsonE_SchemaViolation; }
+	lpNode = &(lpSchema->lpNodes[dwNode]);
+
+	if(cjsonIsNumeric(lpValue)) {
+		dValue = cjsonObject_GetAsDouble((struct cjsonValue*)lpValue);
+
+		/* Only "integer" allowed, doubles above 2^52 never have a fractional part */
+		if(((lpNode->dwTypes & CJSON_SCHEMA_TYPE_NUMBER) == 0) && (lpValue->type == cjsonNumber_Double)) {
+			if(((dValue < 0) ? -dValue : dValue) < 4503599627370496.0) {
+				if((double)((int64_t)dValue) != dValue) { return cjsonE_SchemaViolation; }
+			}
+		}
+
+		if(((lpNode->dwFlags & CJSON_SCHEMA_FLAG_MINIMUM) != 0) && (dValue < lpNode->dMinimum)) { return cjsonE_SchemaViolation; }
+		if(((lpNode->dwFlags & CJSON_SCHEMA_FLAG_MAXIMUM) != 0) && (dValue > lpNode->dMaximum)) { return cjsonE_SchemaViolation; }
+		if(((lpNode->dwFlags & CJSON_SCHEMA_FLAG_EXCLUSIVEMINIMUM) != 0) && (dValue <= lpNode->dExclusiveMinimum)) { return cjsonE_SchemaViolation; }
+		if(((lpNode->dwFlags & CJSON_SCHEMA_FLAG_EXCLUSIVEMAXIMUM) != 0) && (dValue >= lpNode->dExclusiveMaximum)) { return cjsonE_SchemaViolation; }
+	} else if((lpValue->type == cjsonString) && ((lpNode->dwFlags & CJSON_SCHEMA_FLAG_MAXLENGTH) != 0)) {
+		lpString = (const unsigned char*)cjsonString_Get((struct cjsonValue*)lpValue);
+		dwLength = cjsonString_Strlen((struct cjsonValue*)lpValue);
+
+		/* The length is counted in code points, continuation bytes don't count */
+		if(dwLength > lpNode->dwMaxLength) {
+			dwCodepoints = 0;
+			for(i = 0; i < dwLength; i=i+1) {
+				if((lpString[i] & 0xC0) != 0x80) { dwCodepoints = dwCodepoints + 1; }
+			}
+			if(dwCodepoints > lpNode->dwMaxLength) { return cjsonE_SchemaViolation; }
+		}
+	}
+
+	if((lpNode->dwFlags & CJSON_SCHEMA_FLAG_ENUM) != 0) {
+		for(i = 0; i < lpNode->dwEnumCount; i=i+1) {
+			if(cjsonValue_Equals(lpNode->lpEnum[i], lpValue) != 0) { return cjsonE_Ok; }
+		}
+		return cjsonE_SchemaViolation;
+	}
+	return cjsonE_Ok;
+}
+unsigned long int cjsonSchema_Items(
+	const struct cjsonSchema* lpSchema,
+	unsigned long int dwNode
+) {
+	if((dwNode == CJSON_SCHEMA_NODE_ANY) || (dwNode == CJSON_SCHEMA_NODE_NONE)) { return dwNode; }
+	return lpSchema->lpNodes[dwNode].dwItems;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,111 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/*
+	Additional segments carry their frames directly behind the
+	header, the header is padded so the frames stay aligned
+*/
+#define CJSON_SCRATCH_SEGMENTHEADER CJSON_ARENA_ALIGN(sizeof(struct cjsonScratch_Segment))
+
+struct cjsonSystemAPI* cjsonScratch_System(
+	struct cjsonSystemAPI* lpSystem
+) {
+	if(cjsonArena_FromSystem(lpSystem) != NULL) { return NULL; }
+	return lpSystem;
+}
+
+enum cjsonError cjsonScratch_Alloc(
+	struct cjsonSystemAPI* lpScratchSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpScratchSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpScratchSystem->alloc(lpScratchSystem, dwSize, lpOut);
+	}
+}
+void cjsonScratch_Free(
+	struct cjsonSystemAPI* lpScratchSystem,
+	void* lpBlock
+) {
+	if(lpBlock == NULL) { return; }
+	if(lpScratchSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpScratchSystem->free(lpScratchSystem, lpBlock);
+	}
+}
+
+void cjsonScratch_StackInit(
+	struct cjsonScratch_Stack* lpStack,
+	void* lpFirstFrames,
+	unsigned long int dwFrameSize,
+	unsigned long int dwSegmentFrames,
+	struct cjsonSystemAPI* lpSystem
+) {
+	lpStack->base.lpPrev = NULL;
+	lpStack->base.lpSystem = NULL;
+	lpStack->base.lpFrames = (char*)lpFirstFrames;
+	lpStack->base.dwUsed = 0;
+	lpStack->base.dwCapacity = dwSegmentFrames;
+
+	lpStack->lpTop = &(lpStack->base);
+	lpStack->lpSystem = cjsonScratch_System(lpSystem);
+	lpStack->dwFrameSize = dwFrameSize;
+	lpStack->dwSegmentFrames = dwSegmentFrames;
+}
+
+void* cjsonScratch_Push(
+	struct cjsonScratch_Stack* lpStack
+) {
+	struct cjsonScratch_Segment* lpNew;
+	struct cjsonScratch_Segment* lpTop = lpStack->lpTop;
+
+	if(lpTop->dwUsed == lpTop->dwCapacity) {
+		if(cjsonScratch_Alloc(lpStack->lpSystem, CJSON_SCRATCH_SEGMENTHEADER + lpStack->dwFrameSize * lpStack->dwSegmentFrames, (void**)(&lpNew)) != cjsonE_Ok) { return NULL; }
+		lpNew->lpPrev = lpTop;
+		lpNew->lpSystem = lpStack->lpSystem;
+		lpNew->lpFrames = ((char*)lpNew) + CJSON_SCRATCH_SEGMENTHEADER;
+		lpNew->dwUsed = 0;
+		lpNew->dwCapacity = lpStack->dwSegmentFrames;
+		lpStack->lpTop = lpNew;
+		lpTop = lpNew;
+	}
+
+	lpTop->dwUsed = lpTop->dwUsed + 1;
+	return (void*)(lpTop->lpFrames + (lpTop->dwUsed - 1) * lpStack->dwFrameSize);
+}
+void cjsonScratch_Pop(
+	struct cjsonScratch_Stack* lpStack
+) {
+	struct cjsonScratch_Segment* lpOld = lpStack->lpTop;
+
+	lpOld->dwUsed = lpOld->dwUsed - 1;
+	if((lpOld->dwUsed == 0) && (lpOld->lpPrev != NULL)) {
+		lpStack->lpTop = lpOld->lpPrev;
+		cjsonScratch_Free(lpOld->lpSystem, (void*)lpOld);
+	}
+}
+void cjsonScratch_StackRelease(
+	struct cjsonScratch_Stack* lpStack
+) {
+	struct cjsonScratch_Segment* lpOld;
+
+	while(lpStack->lpTop->lpPrev != NULL) {
+		lpOld = lpStack->lpTop;
+		lpStack->lpTop = lpOld->lpPrev;
+		cjsonScratch_Free(lpOld->lpSystem, (void*)lpOld);
+	}
+	lpStack->base.dwUsed = 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
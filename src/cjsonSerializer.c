@@ -9,11 +9,24 @@
 	extern "C" {
 #endif
 
+#ifndef CJSON_SERIALIZER_PARALLEL_MINELEMENTS
+	#define CJSON_SERIALIZER_PARALLEL_MINELEMENTS 4096		/* Containers with less elements are always serialized sequentially */
+#endif
+#ifndef CJSON_SERIALIZER_PARALLEL_CHUNKELEMENTS
+	#define CJSON_SERIALIZER_PARALLEL_CHUNKELEMENTS 1024	/* Targeted number of elements per chunk */
+#endif
+#ifndef CJSON_SERIALIZER_PARALLEL_CHUNKBUFFER
+	#define CJSON_SERIALIZER_PARALLEL_CHUNKBUFFER 4096		/* Initial size of a chunk output buffer */
+#endif
+
+static enum cjsonError cjsonSerializer_PushParallel(struct cjsonSerializer* lpSerializer, struct cjsonValue* lpValue);
+
 /*
 	Malloc and free abstraction
 */
 static inline enum cjsonError cjsonSerializer_MallocHelper(
 	struct cjsonSerializer* lpSelf,
+	enum cjsonAllocSite eSite,
 	unsigned long int dwSize,
 	void** lpOut
 ) {
@@ -24,7 +37,7 @@ static inline enum cjsonError cjsonSerializer_MallocHelper(
 		}
 		return cjsonE_Ok;
 	} else {
-		return lpSelf->lpSystem->alloc(lpSelf->lpSystem, dwSize, lpOut);
+		return cjsonSystemAPI_AllocAt(lpSelf->lpSystem, eSite, dwSize, lpOut);
 	}
 }
 static inline void cjsonSerializer_FreeHelper(
@@ -55,7 +68,11 @@ static inline enum cjsonError cjsonSerializer_PushValue(
 
 	switch(lpValue->type) {
 		case cjsonObject:
-			e = cjsonSerializer_MallocHelper(lpSerializer, sizeof(struct cjsonSerializer_Object), (void**)(&lpNewObject));
+			if((lpSerializer->lpWorkerPool != NULL) && (((struct cjsonObject*)lpValue)->dwElementCount >= CJSON_SERIALIZER_PARALLEL_MINELEMENTS)) {
+				return cjsonSerializer_PushParallel(lpSerializer, lpValue);
+			}
+
+			e = cjsonSerializer_MallocHelper(lpSerializer, cjsonAllocSite__SerializerStack, sizeof(struct cjsonSerializer_Object), (void**)(&lpNewObject));
 			if(e != cjsonE_Ok) { return e; }
 
 			lpNewObject->base.type = cjsonSerializer_StackEntryType__Object;
@@ -70,7 +87,11 @@ static inline enum cjsonError cjsonSerializer_PushValue(
 			lpSerializer->dwStateStackDepth = lpSerializer->dwStateStackDepth + 1;
 			return cjsonE_Ok;
 		case cjsonArray:
-			e = cjsonSerializer_MallocHelper(lpSerializer, sizeof(struct cjsonSerializer_Array), (void**)(&lpNewArray));
+			if((lpSerializer->lpWorkerPool != NULL) && (((struct cjsonArray*)lpValue)->dwElementCount >= CJSON_SERIALIZER_PARALLEL_MINELEMENTS)) {
+				return cjsonSerializer_PushParallel(lpSerializer, lpValue);
+			}
+
+			e = cjsonSerializer_MallocHelper(lpSerializer, cjsonAllocSite__SerializerStack, sizeof(struct cjsonSerializer_Array), (void**)(&lpNewArray));
 			if(e != cjsonE_Ok) { return e; }
 
 			lpNewArray->base.type = cjsonSerializer_StackEntryType__Array;
@@ -84,7 +105,7 @@ static inline enum cjsonError cjsonSerializer_PushValue(
 			return cjsonE_Ok;
 
 		case cjsonString:
-			e = cjsonSerializer_MallocHelper(lpSerializer, sizeof(struct cjsonSerializer_String), (void**)(&lpNewString));
+			e = cjsonSerializer_MallocHelper(lpSerializer, cjsonAllocSite__SerializerStack, sizeof(struct cjsonSerializer_String), (void**)(&lpNewString));
 			if(e != cjsonE_Ok) { return e; }
 
 			lpNewString->base.type = cjsonSerializer_StackEntryType__String;
@@ -103,9 +124,9 @@ static inline enum cjsonError cjsonSerializer_PushValue(
 			for(;;) {
 				/* Repeat loop to cope with locale changes between both snprintf's */
 				dwLength = snprintf(NULL, 0, "%lu", ((struct cjsonNumber*)lpValue)->value.ulong);
-				e = cjsonSerializer_MallocHelper(lpSerializer, sizeof(struct cjsonSerializer_Number)+dwLength, (void**)(&lpNewNum));
+				e = cjsonSerializer_MallocHelper(lpSerializer, cjsonAllocSite__SerializerStack, sizeof(struct cjsonSerializer_Number)+dwLength+1, (void**)(&lpNewNum));
 				if(e != cjsonE_Ok) { return e; }
-				if(snprintf(&(lpNewNum->bString[0]), dwLength, "%lu", ((struct cjsonNumber*)lpValue)->value.ulong) != dwLength) {
+				if(snprintf(&(lpNewNum->bString[0]), dwLength+1, "%lu", ((struct cjsonNumber*)lpValue)->value.ulong) != dwLength) {
 					cjsonSerializer_FreeHelper(lpSerializer, (void*)lpNewNum);
 					continue;
 				}
@@ -124,9 +145,9 @@ static inline enum cjsonError cjsonSerializer_PushValue(
 			for(;;) {
 				/* Repeat loop to cope with locale changes between both snprintf's */
 				dwLength = snprintf(NULL, 0, "%ld", ((struct cjsonNumber*)lpValue)->value.slong);
-				e = cjsonSerializer_MallocHelper(lpSerializer, sizeof(struct cjsonSerializer_Number)+dwLength, (void**)(&lpNewNum));
+				e = cjsonSerializer_MallocHelper(lpSerializer, cjsonAllocSite__SerializerStack, sizeof(struct cjsonSerializer_Number)+dwLength+1, (void**)(&lpNewNum));
 				if(e != cjsonE_Ok) { return e; }
-				if(snprintf(lpNewNum->bString, dwLength, "%ld", ((struct cjsonNumber*)lpValue)->value.ulong) != dwLength) {
+				if(snprintf(lpNewNum->bString, dwLength+1, "%ld", ((struct cjsonNumber*)lpValue)->value.slong) != dwLength) {
 					cjsonSerializer_FreeHelper(lpSerializer, (void*)lpNewNum);
 					continue;
 				}
@@ -145,9 +166,9 @@ static inline enum cjsonError cjsonSerializer_PushValue(
 			for(;;) {
 				/* Repeat loop to cope with locale changes between both snprintf's */
 				dwLength = snprintf(NULL, 0, "%lf", ((struct cjsonNumber*)lpValue)->value.dbl);
-				e = cjsonSerializer_MallocHelper(lpSerializer, sizeof(struct cjsonSerializer_Number)+dwLength, (void**)(&lpNewNum));
+				e = cjsonSerializer_MallocHelper(lpSerializer, cjsonAllocSite__SerializerStack, sizeof(struct cjsonSerializer_Number)+dwLength+1, (void**)(&lpNewNum));
 				if(e != cjsonE_Ok) { return e; }
-				if(snprintf(lpNewNum->bString, dwLength, "%lf", ((struct cjsonNumber*)lpValue)->value.dbl) != dwLength) {
+				if(snprintf(lpNewNum->bString, dwLength+1, "%lf", ((struct cjsonNumber*)lpValue)->value.dbl) != dwLength) {
 					cjsonSerializer_FreeHelper(lpSerializer, (void*)lpNewNum);
 					continue;
 				}
@@ -165,7 +186,7 @@ static inline enum cjsonError cjsonSerializer_PushValue(
 		case cjsonTrue:
 		case cjsonFalse:
 		case cjsonNull:
-			e = cjsonSerializer_MallocHelper(lpSerializer, sizeof(struct cjsonSerializer_Constant), (void**)(&lpNewConst));
+			e = cjsonSerializer_MallocHelper(lpSerializer, cjsonAllocSite__SerializerStack, sizeof(struct cjsonSerializer_Constant), (void**)(&lpNewConst));
 			if(e != cjsonE_Ok) { return e; }
 
 			lpNewConst->base.type = cjsonSerializer_StackEntryType__Constant;
@@ -417,6 +438,10 @@ static inline enum cjsonError cjsonSerializer_Continue_Object(
 	*/
 
 	for(;;) {
+		if(lpCur->state == cjsonSerializer_Object_State__Trailer) {
+			/* Empty objects (or a resumed trailer) skip directly to the trailer */
+			break;
+		}
 		if(lpCur->state == cjsonSerializer_Object_State__Key) {
 			/* Check if we have to write indent ... */
 			while(lpCur->dwBytesWritten < dwIndentDepth) {
@@ -700,6 +725,388 @@ static inline enum cjsonError cjsonSerializer_Continue_String(
 	return cjsonSerializer_PopValue(lpSerializer);
 }
 
+/*
+	Parallel serialization of large containers
+*/
+static enum cjsonError cjsonSerializer_ReleaseStack(
+	struct cjsonSerializer* lpSerializer
+);
+
+static enum cjsonError cjsonSerializer_Parallel_Append(
+	struct cjsonSerializer_ParallelChunk* lpChunk,
+	const char* lpData,
+	unsigned long int dwLength
+) {
+	enum cjsonError e;
+	char* lpNewBuffer;
+	unsigned long int dwNewSize;
+
+	if(lpChunk->dwBufferUsed + dwLength > lpChunk->dwBufferSize) {
+		dwNewSize = (lpChunk->dwBufferSize == 0) ? CJSON_SERIALIZER_PARALLEL_CHUNKBUFFER : lpChunk->dwBufferSize * 2;
+		while(dwNewSize < lpChunk->dwBufferUsed + dwLength) { dwNewSize = dwNewSize * 2; }
+
+		e = cjsonSerializer_MallocHelper(lpChunk->lpSerializer, cjsonAllocSite__Other, dwNewSize, (void**)(&lpNewBuffer));
+		if(e != cjsonE_Ok) { return e; }
+
+		if(lpChunk->lpBuffer != NULL) {
+			memcpy(lpNewBuffer, lpChunk->lpBuffer, lpChunk->dwBufferUsed);
+			cjsonSerializer_FreeHelper(lpChunk->lpSerializer, (void*)(lpChunk->lpBuffer));
+		}
+		lpChunk->lpBuffer = lpNewBuffer;
+		lpChunk->dwBufferSize = dwNewSize;
+	}
+
+	memcpy(&(lpChunk->lpBuffer[lpChunk->dwBufferUsed]), lpData, dwLength);
+	lpChunk->dwBufferUsed = lpChunk->dwBufferUsed + dwLength;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonSerializer_Parallel_BufferWriter(
+	char*											lpData,
+	unsigned long int								dwBytesToWrite,
+	unsigned long int								*lpBytesWrittenOut,
+
+	void*											lpFreeParam
+) {
+	enum cjsonError e;
+
+	(*lpBytesWrittenOut) = 0;
+	e = cjsonSerializer_Parallel_Append((struct cjsonSerializer_ParallelChunk*)lpFreeParam, lpData, dwBytesToWrite);
+	if(e != cjsonE_Ok) { return e; }
+	(*lpBytesWrittenOut) = dwBytesToWrite;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonSerializer_Parallel_SerializeValue(
+	struct cjsonSerializer* lpSub,
+	struct cjsonValue* lpValue
+) {
+	enum cjsonError e;
+
+	e = cjsonSerializer_PushValue(lpSub, lpValue);
+	if(e != cjsonE_Ok) { return e; }
+	e = cjsonSerializer_Continue(lpSub);
+	if(e != cjsonE_Ok) {
+		cjsonSerializer_ReleaseStack(lpSub);
+		return e;
+	}
+	return cjsonE_Ok;
+}
+static void cjsonSerializer_Parallel_Worker(
+	void* lpParam
+) {
+	struct cjsonSerializer_ParallelChunk* lpChunk = (struct cjsonSerializer_ParallelChunk*)lpParam;
+	struct cjsonSerializer sub;
+	struct cjsonArray_Page* lpPage;
+	struct cjsonObject_BucketEntry* lpEntry;
+	struct cjsonValue* lpKey;
+	unsigned long int dwEntry;
+	unsigned long int dwDone;
+	unsigned long int dwBucket;
+	unsigned long int i;
+	int bPretty;
+	enum cjsonError e;
+
+	bPretty = ((lpChunk->lpSerializer->dwFlags & CJSON_SERIALIZER__FLAG__PRETTYPRINT) != 0) ? 1 : 0;
+
+	/*
+		The chunk is serialized by a private sequential serializer that
+		writes into our buffer. It starts at the depth of the container
+		so indention is the same as in the sequential path.
+	*/
+	sub.lpTopOfStack				= NULL;
+	sub.lpSystem					= lpChunk->lpSerializer->lpSystem;
+	sub.dwStateStackDepth			= lpChunk->dwDepth;
+	sub.dwFlags						= lpChunk->lpSerializer->dwFlags;
+	sub.callbackWriteBytes			= &cjsonSerializer_Parallel_BufferWriter;
+	sub.callbackWriteBytesParam		= (void*)lpChunk;
+	sub.lpWorkerPool				= NULL;
+
+	e = cjsonE_Ok;
+	if(lpChunk->lpContainer->type == cjsonArray) {
+		/* Elements are separated by comma (and linebreak) and indented by a single tab */
+		lpPage = lpChunk->lpFirstPage;
+		dwEntry = lpChunk->dwFirstEntry;
+		dwDone = 0;
+		while((dwDone < lpChunk->dwElementCount) && (lpPage != NULL)) {
+			if(dwEntry >= lpPage->dwUsedEntries) {
+				lpPage = lpPage->pageList.lpNext;
+				dwEntry = 0;
+				continue;
+			}
+
+			if(dwDone > 0) {
+				if((e = cjsonSerializer_Parallel_Append(lpChunk, ",\n", (bPretty != 0) ? 2 : 1)) != cjsonE_Ok) { break; }
+			}
+			if(bPretty != 0) {
+				if((e = cjsonSerializer_Parallel_Append(lpChunk, "\t", 1)) != cjsonE_Ok) { break; }
+			}
+			if((e = cjsonSerializer_Parallel_SerializeValue(&sub, lpPage->entries[dwEntry])) != cjsonE_Ok) { break; }
+
+			dwEntry = dwEntry + 1;
+			dwDone = dwDone + 1;
+		}
+	} else {
+		/* Every entry consists of indention, key, colon and value */
+		dwDone = 0;
+		for(dwBucket = lpChunk->dwFirstBucket; dwBucket < lpChunk->dwFirstBucket + lpChunk->dwBucketCount; dwBucket = dwBucket + 1) {
+			lpEntry = ((struct cjsonObject*)(lpChunk->lpContainer))->buckets[dwBucket];
+			while(lpEntry != NULL) {
+				if(dwDone > 0) {
+					if((e = cjsonSerializer_Parallel_Append(lpChunk, ",\n", (bPretty != 0) ? 2 : 1)) != cjsonE_Ok) { break; }
+				}
+				if(bPretty != 0) {
+					for(i = 0; i < lpChunk->dwDepth; i=i+1) {
+						if((e = cjsonSerializer_Parallel_Append(lpChunk, "\t", 1)) != cjsonE_Ok) { break; }
+					}
+					if(e != cjsonE_Ok) { break; }
+				}
+
+				if((e = cjsonString_Create(&lpKey, lpEntry->bKey, lpEntry->dwKeyLength, sub.lpSystem)) != cjsonE_Ok) { break; }
+				e = cjsonSerializer_Parallel_SerializeValue(&sub, lpKey);
+				cjsonReleaseValue(lpKey);
+				if(e != cjsonE_Ok) { break; }
+
+				if((e = cjsonSerializer_Parallel_Append(lpChunk, ":", 1)) != cjsonE_Ok) { break; }
+				if((e = cjsonSerializer_Parallel_SerializeValue(&sub, lpEntry->lpValue)) != cjsonE_Ok) { break; }
+
+				dwDone = dwDone + 1;
+				lpEntry = lpEntry->bucketList.lpNext;
+			}
+			if(e != cjsonE_Ok) { break; }
+		}
+	}
+
+	lpChunk->eResult = e;
+	return;
+}
+
+static enum cjsonError cjsonSerializer_PushParallel(
+	struct cjsonSerializer* lpSerializer,
+	struct cjsonValue* lpValue
+) {
+	enum cjsonError e;
+	struct cjsonSerializer_Parallel* lpNew;
+	unsigned long int dwChunkCount;
+	unsigned long int dwWindow;
+	unsigned long int i;
+
+	if(lpValue->type == cjsonArray) {
+		dwChunkCount = (((struct cjsonArray*)lpValue)->dwElementCount + CJSON_SERIALIZER_PARALLEL_CHUNKELEMENTS - 1) / CJSON_SERIALIZER_PARALLEL_CHUNKELEMENTS;
+	} else {
+		/* Objects can only be split at bucket boundaries */
+		dwChunkCount = ((struct cjsonObject*)lpValue)->dwElementCount / CJSON_SERIALIZER_PARALLEL_CHUNKELEMENTS;
+		if(dwChunkCount > ((struct cjsonObject*)lpValue)->dwBucketCount) { dwChunkCount = ((struct cjsonObject*)lpValue)->dwBucketCount; }
+	}
+	if(dwChunkCount < 1) { dwChunkCount = 1; }
+
+	/* Keep two chunks per worker in flight so the workers don't starve while we write */
+	dwWindow = 2 * cjsonWorkerPool_ThreadCount(lpSerializer->lpWorkerPool);
+	if(dwWindow < 2) { dwWindow = 2; }
+	if(dwWindow > dwChunkCount) { dwWindow = dwChunkCount; }
+
+	e = cjsonSerializer_MallocHelper(lpSerializer, cjsonAllocSite__Other, sizeof(struct cjsonSerializer_Parallel)+sizeof(struct cjsonSerializer_ParallelChunk)*dwWindow, (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpNew->base.type = cjsonSerializer_StackEntryType__Parallel;
+	lpNew->base.lpNext = lpSerializer->lpTopOfStack;
+	lpNew->lpContainer = lpValue;
+	lpNew->state = cjsonSerializer_Parallel_State__Header;
+	lpNew->dwBytesWritten = 0;
+	lpNew->bChunkWritten = 0;
+	lpNew->dwChunkCount = dwChunkCount;
+	lpNew->dwNextSubmit = 0;
+	lpNew->dwNextWrite = 0;
+	lpNew->lpCursorPage = (lpValue->type == cjsonArray) ? ((struct cjsonArray*)lpValue)->pageList.lpFirstPage : NULL;
+	lpNew->dwCursorEntry = 0;
+	lpNew->dwWindow = dwWindow;
+
+	for(i = 0; i < dwWindow; i=i+1) {
+		lpNew->chunks[i].lpBuffer = NULL;
+		lpNew->chunks[i].bSubmitted = 0;
+	}
+
+	lpSerializer->lpTopOfStack = (struct cjsonSerializer_StackEntry*)lpNew;
+	lpSerializer->dwStateStackDepth = lpSerializer->dwStateStackDepth + 1;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonSerializer_Parallel_SubmitChunk(
+	struct cjsonSerializer* lpSerializer,
+	struct cjsonSerializer_Parallel* lpCur
+) {
+	enum cjsonError e;
+	struct cjsonSerializer_ParallelChunk* lpChunk;
+	unsigned long int dwRemaining;
+	unsigned long int dwAvailable;
+	unsigned long int dwBucketCount;
+
+	lpChunk = &(lpCur->chunks[lpCur->dwNextSubmit % lpCur->dwWindow]);
+
+	lpChunk->lpSerializer = lpSerializer;
+	lpChunk->lpContainer = lpCur->lpContainer;
+	lpChunk->dwDepth = lpSerializer->dwStateStackDepth;
+	lpChunk->lpBuffer = NULL;
+	lpChunk->dwBufferSize = 0;
+	lpChunk->dwBufferUsed = 0;
+	lpChunk->eResult = cjsonE_Ok;
+
+	if(lpCur->lpContainer->type == cjsonArray) {
+		/* Cut the next range of elements and advance our page cursor behind it */
+		lpChunk->lpFirstPage = lpCur->lpCursorPage;
+		lpChunk->dwFirstEntry = lpCur->dwCursorEntry;
+		lpChunk->dwElementCount = ((struct cjsonArray*)(lpCur->lpContainer))->dwElementCount - lpCur->dwNextSubmit * CJSON_SERIALIZER_PARALLEL_CHUNKELEMENTS;
+		if(lpChunk->dwElementCount > CJSON_SERIALIZER_PARALLEL_CHUNKELEMENTS) { lpChunk->dwElementCount = CJSON_SERIALIZER_PARALLEL_CHUNKELEMENTS; }
+
+		dwRemaining = lpChunk->dwElementCount;
+		while((dwRemaining > 0) && (lpCur->lpCursorPage != NULL)) {
+			dwAvailable = lpCur->lpCursorPage->dwUsedEntries - lpCur->dwCursorEntry;
+			if(dwAvailable > dwRemaining) {
+				lpCur->dwCursorEntry = lpCur->dwCursorEntry + dwRemaining;
+				dwRemaining = 0;
+			} else {
+				dwRemaining = dwRemaining - dwAvailable;
+				lpCur->lpCursorPage = lpCur->lpCursorPage->pageList.lpNext;
+				lpCur->dwCursorEntry = 0;
+			}
+		}
+	} else {
+		dwBucketCount = ((struct cjsonObject*)(lpCur->lpContainer))->dwBucketCount;
+		lpChunk->dwFirstBucket = (lpCur->dwNextSubmit * dwBucketCount) / lpCur->dwChunkCount;
+		lpChunk->dwBucketCount = ((lpCur->dwNextSubmit + 1) * dwBucketCount) / lpCur->dwChunkCount - lpChunk->dwFirstBucket;
+	}
+
+	lpChunk->job.lpfnJob = &cjsonSerializer_Parallel_Worker;
+	lpChunk->job.lpParam = (void*)lpChunk;
+
+	e = cjsonWorkerPool_Submit(lpSerializer->lpWorkerPool, &(lpChunk->job));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpChunk->bSubmitted = 1;
+	lpCur->dwNextSubmit = lpCur->dwNextSubmit + 1;
+	return cjsonE_Ok;
+}
+static void cjsonSerializer_Parallel_Cleanup(
+	struct cjsonSerializer* lpSerializer,
+	struct cjsonSerializer_Parallel* lpCur
+) {
+	unsigned long int i;
+
+	/* Wait for all chunks that are still in flight and drop their output */
+	for(i = 0; i < lpCur->dwWindow; i=i+1) {
+		if(lpCur->chunks[i].bSubmitted != 0) {
+			cjsonWorkerPool_Wait(lpSerializer->lpWorkerPool, &(lpCur->chunks[i].job));
+			lpCur->chunks[i].bSubmitted = 0;
+		}
+		if(lpCur->chunks[i].lpBuffer != NULL) {
+			cjsonSerializer_FreeHelper(lpSerializer, (void*)(lpCur->chunks[i].lpBuffer));
+			lpCur->chunks[i].lpBuffer = NULL;
+		}
+	}
+}
+static inline enum cjsonError cjsonSerializer_Parallel_WriteSegment(
+	struct cjsonSerializer* lpSerializer,
+	struct cjsonSerializer_Parallel* lpCur,
+	const char* lpData,
+	unsigned long int dwLength
+) {
+	enum cjsonError e;
+	unsigned long int dwBytesWritten;
+
+	while(lpCur->dwBytesWritten < dwLength) {
+		dwBytesWritten = 0;
+		e = lpSerializer->callbackWriteBytes((char*)(&(lpData[lpCur->dwBytesWritten])), dwLength - lpCur->dwBytesWritten, &dwBytesWritten, lpSerializer->callbackWriteBytesParam);
+		lpCur->dwBytesWritten = lpCur->dwBytesWritten + dwBytesWritten;
+		if(e != cjsonE_Ok) { return e; }
+	}
+	return cjsonE_Ok;
+}
+static inline enum cjsonError cjsonSerializer_Continue_Parallel(
+	struct cjsonSerializer* lpSerializer
+) {
+	enum cjsonError e;
+	struct cjsonSerializer_Parallel* lpCur = (struct cjsonSerializer_Parallel*)(lpSerializer->lpTopOfStack);
+	struct cjsonSerializer_ParallelChunk* lpChunk;
+	unsigned long int dwBytesWritten;
+	unsigned long int dwDepth;
+	int bPretty;
+	char bHeader[2];
+	char bClose;
+	char bNext;
+
+	bPretty = ((lpSerializer->dwFlags & CJSON_SERIALIZER__FLAG__PRETTYPRINT) != 0) ? 1 : 0;
+	dwDepth = lpSerializer->dwStateStackDepth;
+	bClose = (lpCur->lpContainer->type == cjsonArray) ? ']' : '}';
+
+	while(lpCur->dwNextWrite < lpCur->dwChunkCount) {
+		/* Keep the window filled */
+		while((lpCur->dwNextSubmit < lpCur->dwChunkCount) && (lpCur->dwNextSubmit < lpCur->dwNextWrite + lpCur->dwWindow)) {
+			e = cjsonSerializer_Parallel_SubmitChunk(lpSerializer, lpCur);
+			if(e != cjsonE_Ok) { return e; }
+		}
+
+		if(lpCur->state == cjsonSerializer_Parallel_State__Header) {
+			bHeader[0] = (lpCur->lpContainer->type == cjsonArray) ? '[' : '{';
+			bHeader[1] = '\n';
+			e = cjsonSerializer_Parallel_WriteSegment(lpSerializer, lpCur, bHeader, (bPretty != 0) ? 2 : 1);
+			if(e != cjsonE_Ok) { return e; }
+			lpCur->state = cjsonSerializer_Parallel_State__Separator;
+			lpCur->dwBytesWritten = 0;
+		}
+
+		lpChunk = &(lpCur->chunks[lpCur->dwNextWrite % lpCur->dwWindow]);
+		cjsonWorkerPool_Wait(lpSerializer->lpWorkerPool, &(lpChunk->job));
+		if(lpChunk->eResult != cjsonE_Ok) { return lpChunk->eResult; }
+
+		if(lpCur->state == cjsonSerializer_Parallel_State__Separator) {
+			/* Empty chunks (buckets without entries) don't get a separator */
+			if((lpChunk->dwBufferUsed > 0) && (lpCur->bChunkWritten != 0)) {
+				e = cjsonSerializer_Parallel_WriteSegment(lpSerializer, lpCur, ",\n", (bPretty != 0) ? 2 : 1);
+				if(e != cjsonE_Ok) { return e; }
+			}
+			lpCur->state = cjsonSerializer_Parallel_State__Chunk;
+			lpCur->dwBytesWritten = 0;
+		}
+
+		e = cjsonSerializer_Parallel_WriteSegment(lpSerializer, lpCur, lpChunk->lpBuffer, lpChunk->dwBufferUsed);
+		if(e != cjsonE_Ok) { return e; }
+
+		if(lpChunk->dwBufferUsed > 0) { lpCur->bChunkWritten = 1; }
+		if(lpChunk->lpBuffer != NULL) {
+			cjsonSerializer_FreeHelper(lpSerializer, (void*)(lpChunk->lpBuffer));
+			lpChunk->lpBuffer = NULL;
+		}
+		lpChunk->bSubmitted = 0;
+
+		lpCur->dwNextWrite = lpCur->dwNextWrite + 1;
+		lpCur->state = cjsonSerializer_Parallel_State__Separator;
+		lpCur->dwBytesWritten = 0;
+	}
+
+	/*
+		Trailer is the same as in the sequential path:
+			linebreak (pretty print only)
+			indention (pretty print only)
+			closing bracket
+	*/
+	if(lpCur->state != cjsonSerializer_Parallel_State__Trailer) {
+		lpCur->state = cjsonSerializer_Parallel_State__Trailer;
+		lpCur->dwBytesWritten = 0;
+	}
+	if(bPretty != 0) {
+		while(lpCur->dwBytesWritten < dwDepth + 1) {
+			bNext = (lpCur->dwBytesWritten == 0) ? '\n' : ((lpCur->dwBytesWritten < dwDepth) ? '\t' : bClose);
+			dwBytesWritten = 0;
+			e = lpSerializer->callbackWriteBytes(&bNext, sizeof(bNext), &dwBytesWritten, lpSerializer->callbackWriteBytesParam);
+			if(dwBytesWritten > 0) { lpCur->dwBytesWritten = lpCur->dwBytesWritten + 1; }
+			if(e != cjsonE_Ok) { return e; }
+		}
+	} else {
+		e = cjsonSerializer_Parallel_WriteSegment(lpSerializer, lpCur, &bClose, 1);
+		if(e != cjsonE_Ok) { return e; }
+	}
+
+	cjsonSerializer_Parallel_Cleanup(lpSerializer, lpCur);
+	return cjsonSerializer_PopValue(lpSerializer);
+}
+
 
 
 
@@ -736,6 +1143,7 @@ enum cjsonError cjsonSerializer_Create(
 	lpNew->callbackWriteBytesParam 	= callbackFreeParam;
 	lpNew->dwStateStackDepth		= 0;
 	lpNew->dwFlags					= dwFlags;
+	lpNew->lpWorkerPool				= NULL;
 
 	(*lpOut) = lpNew;
 	return cjsonE_Ok;
@@ -773,6 +1181,7 @@ enum cjsonError cjsonSerializer_Continue(
 			case cjsonSerializer_StackEntryType__Number:			e = cjsonSerializer_Continue_Number(lpSerializer); 		break;
 			case cjsonSerializer_StackEntryType__Object:			e = cjsonSerializer_Continue_Object(lpSerializer);		break;
 			case cjsonSerializer_StackEntryType__String:			e = cjsonSerializer_Continue_String(lpSerializer);		break;
+			case cjsonSerializer_StackEntryType__Parallel:			e = cjsonSerializer_Continue_Parallel(lpSerializer);	break;
 			default:
 				return cjsonE_ImplementationError;
 		}
@@ -781,14 +1190,24 @@ enum cjsonError cjsonSerializer_Continue(
 
 	return cjsonE_Ok;
 }
-enum cjsonError cjsonSerializer_Release(
+enum cjsonError cjsonSerializer_SetWorkerPool(
+	struct cjsonSerializer* lpSerializer,
+	struct cjsonWorkerPool* lpPool
+) {
+	if(lpSerializer == NULL) { return cjsonE_InvalidParam; }
+
+	/* The pool cannot be exchanged while chunks may be in flight */
+	if(lpSerializer->lpTopOfStack != NULL) { return cjsonE_InvalidState; }
+
+	lpSerializer->lpWorkerPool = lpPool;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonSerializer_ReleaseStack(
 	struct cjsonSerializer* lpSerializer
 ) {
 	struct cjsonSerializer_StackEntry* lpCur;
 	struct cjsonSerializer_StackEntry* lpNext;
 
-	if(lpSerializer == NULL) { return cjsonE_InvalidParam; }
-
 	lpCur = lpSerializer->lpTopOfStack;
 	while(lpCur != NULL) {
 		lpNext = lpCur->lpNext;
@@ -796,7 +1215,7 @@ enum cjsonError cjsonSerializer_Release(
 		switch(lpCur->type) {
 			case cjsonSerializer_StackEntryType__Array:			cjsonSerializer_FreeHelper(lpSerializer, (void*)lpCur); break;
 			case cjsonSerializer_StackEntryType__Constant:		cjsonSerializer_FreeHelper(lpSerializer, (void*)lpCur); break;
-			case cjsonSerializer_StackEntryType__Number:		return cjsonE_ImplementationError;
+			case cjsonSerializer_StackEntryType__Number:		cjsonSerializer_FreeHelper(lpSerializer, (void*)lpCur); break;
 			case cjsonSerializer_StackEntryType__Object:
 				if(((struct cjsonSerializer_Object*)lpCur)->lpTempString != NULL) {
 					cjsonReleaseValue(((struct cjsonSerializer_Object*)lpCur)->lpTempString);
@@ -805,13 +1224,31 @@ enum cjsonError cjsonSerializer_Release(
 				cjsonSerializer_FreeHelper(lpSerializer, (void*)lpCur);
 				break;
 			case cjsonSerializer_StackEntryType__String:		cjsonSerializer_FreeHelper(lpSerializer, (void*)lpCur); break;
+			case cjsonSerializer_StackEntryType__Parallel:
+				cjsonSerializer_Parallel_Cleanup(lpSerializer, (struct cjsonSerializer_Parallel*)lpCur);
+				cjsonSerializer_FreeHelper(lpSerializer, (void*)lpCur);
+				break;
 			default:
 				return cjsonE_ImplementationError;
 		}
 
 		lpCur = lpNext;
+		lpSerializer->lpTopOfStack = lpCur;
+		lpSerializer->dwStateStackDepth = lpSerializer->dwStateStackDepth - 1;
 	}
 
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonSerializer_Release(
+	struct cjsonSerializer* lpSerializer
+) {
+	enum cjsonError e;
+
+	if(lpSerializer == NULL) { return cjsonE_InvalidParam; }
+
+	e = cjsonSerializer_ReleaseStack(lpSerializer);
+	if(e != cjsonE_Ok) { return e; }
+
 	cjsonSerializer_FreeHelper(lpSerializer, (void*)lpSerializer);
 	return cjsonE_Ok;
 }
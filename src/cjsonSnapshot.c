@@ -0,0 +1,840 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_SNAPSHOT_STACKSEGMENT
+	#define CJSON_SNAPSHOT_STACKSEGMENT 32			/* Frames per segment of the writer stack */
+#endif
+#ifndef CJSON_SNAPSHOT_BUFFERSIZE
+	#define CJSON_SNAPSHOT_BUFFERSIZE 8192			/* Writer output buffer */
+#endif
+
+/*
+	Image layout (all fields in host byte order, all nodes 8 byte aligned):
+
+		Header		char magic[8], uint32_t byte order marker, uint32_t reserved
+		Nodes		uint32_t type, uint32_t reserved, uint64_t argument, payload
+		Trailer		uint64_t root reference, uint64_t image size
+
+	Values are identified by 64 bit references. Since nodes are aligned
+	the lowest three bits of a node offset are zero, other tags carry
+	small values without any node:
+
+		tag 0		offset of a node
+		tag 1		unsigned integer below 2^61 in the upper bits
+		tag 2		signed integer in [-2^60, 2^60) in the upper bits
+		tag 3		constant, element type in the upper bits
+
+	The argument of double nodes holds the value bits, strings store
+	their length followed by the zero terminated data, arrays their
+	element count followed by the element references and objects their
+	entry count followed by entries sorted by key. Each entry consists
+	of the distance from its key to the object node (uint32_t), the key
+	length (uint32_t) and the value reference. The keys of an object are
+	stored in a block directly in front of its node.
+
+	Nodes are written in post order so the offsets of all children are
+	known when a container is written and the image can be streamed
+	without seeking. The root is the last node, the trailer points
+	to it.
+*/
+#define CJSON_SNAPSHOT_HEADERSIZE		16
+#define CJSON_SNAPSHOT_TRAILERSIZE		16
+#define CJSON_SNAPSHOT_NODESIZE			16
+#define CJSON_SNAPSHOT_ENTRYSIZE		16
+
+#define CJSON_SNAPSHOT_TAG_MASK			0x07
+#define CJSON_SNAPSHOT_TAG_NODE			0x00
+#define CJSON_SNAPSHOT_TAG_ULONG		0x01
+#define CJSON_SNAPSHOT_TAG_SLONG		0x02
+#define CJSON_SNAPSHOT_TAG_CONSTANT		0x03
+
+struct cjsonSnapshot_Entry {
+	const char*									lpKey;
+	unsigned long int							dwKeyLength;
+	uint64_t									qwValue;
+};
+struct cjsonSnapshot_Frame {
+	const struct cjsonValue*					lpSource;
+
+	const struct cjsonArray_Page*				lpPage;			/* Arrays: current page */
+	const struct cjsonObject_BucketEntry*		lpEntry;		/* Objects: next entry of the current chain */
+	unsigned long int							dwCursor;		/* Arrays: entry inside page, Objects: next bucket */
+
+	struct cjsonSnapshot_Entry*					lpEntries;		/* Children that have already been written */
+	unsigned long int							dwEntries;
+	unsigned long int							dwCapacity;
+};
+struct cjsonSnapshot_Writer {
+	cjsonSerializer_Callback_WriteBytes			callback;
+	void*										callbackFreeParam;
+	struct cjsonSystemAPI*						lpSystem;
+
+	uint64_t									qwOffset;		/* Offset of the next byte passed to Emit */
+	unsigned long int							dwBufferUsed;
+	char										bBuffer[CJSON_SNAPSHOT_BUFFERSIZE];
+};
+
+/*
+	Malloc and free abstraction
+*/
+static inline enum cjsonError cjsonSnapshot_Alloc(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpSystem->alloc(lpSystem, dwSize, lpOut);
+	}
+}
+static inline void cjsonSnapshot_Free(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+
+/*
+	Output
+*/
+static enum cjsonError cjsonSnapshot_WriteAll(
+	struct cjsonSnapshot_Writer* lpWriter,
+	const char* lpData,
+	unsigned long int dwLength
+) {
+	enum cjsonError e;
+	unsigned long int dwWritten;
+
+	while(dwLength > 0) {
+		dwWritten = 0;
+		e = lpWriter->callback((char*)lpData, dwLength, &dwWritten, lpWriter->callbackFreeParam);
+		if(e != cjsonE_Ok) { return e; }
+		if((dwWritten == 0) || (dwWritten > dwLength)) { return cjsonE_ImplementationError; }
+		lpData = lpData + dwWritten;
+		dwLength = dwLength - dwWritten;
+	}
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonSnapshot_Flush(
+	struct cjsonSnapshot_Writer* lpWriter
+) {
+	enum cjsonError e;
+
+	e = cjsonSnapshot_WriteAll(lpWriter, lpWriter->bBuffer, lpWriter->dwBufferUsed);
+	lpWriter->dwBufferUsed = 0;
+	return e;
+}
+static enum cjsonError cjsonSnapshot_Emit(
+	struct cjsonSnapshot_Writer* lpWriter,
+	const void* lpData,
+	unsigned long int dwLength
+) {
+	enum cjsonError e;
+
+	lpWriter->qwOffset = lpWriter->qwOffset + dwLength;
+	if(dwLength > CJSON_SNAPSHOT_BUFFERSIZE - lpWriter->dwBufferUsed) {
+		e = cjsonSnapshot_Flush(lpWriter);
+		if(e != cjsonE_Ok) { return e; }
+		if(dwLength >= CJSON_SNAPSHOT_BUFFERSIZE) { return cjsonSnapshot_WriteAll(lpWriter, (const char*)lpData, dwLength); }
+	}
+	memcpy(&(lpWriter->bBuffer[lpWriter->dwBufferUsed]), lpData, dwLength);
+	lpWriter->dwBufferUsed = lpWriter->dwBufferUsed + dwLength;
+	return cjsonE_Ok;
+}
+static enum cjsonError cjsonSnapshot_Align(
+	struct cjsonSnapshot_Writer* lpWriter
+) {
+	static const char bZero[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+	if((lpWriter->qwOffset % 8) == 0) { return cjsonE_Ok; }
+	return cjsonSnapshot_Emit(lpWriter, bZero, (unsigned long int)(8 - (lpWriter->qwOffset % 8)));
+}
+static enum cjsonError cjsonSnapshot_EmitNode(
+	struct cjsonSnapshot_Writer* lpWriter,
+	enum cjsonElementType type,
+	uint64_t qwArgument,
+	uint64_t* lpOffsetOut
+) {
+	uint32_t dwHeader[2];
+	enum cjsonError e;
+
+	dwHeader[0] = (uint32_t)type;
+	dwHeader[1] = 0;
+
+	(*lpOffsetOut) = lpWriter->qwOffset;
+	e = cjsonSnapshot_Emit(lpWriter, dwHeader, sizeof(dwHeader));
+	if(e != cjsonE_Ok) { return e; }
+	return cjsonSnapshot_Emit(lpWriter, &qwArgument, sizeof(qwArgument));
+}
+
+/*
+	Writes a value that is not a container (or returns its inline
+	reference). NULL array entries are stored as null.
+*/
+static enum cjsonError cjsonSnapshot_WriteScalar(
+	struct cjsonSnapshot_Writer* lpWriter,
+	const struct cjsonValue* lpValue,
+	uint64_t* lpOffsetOut
+) {
+	enum cjsonError e;
+	uint64_t qwBits;
+	int64_t iValue;
+	const struct cjsonString* lpString;
+
+	if(lpValue == NULL) {
+		(*lpOffsetOut) = (((uint64_t)cjsonNull) << 3) | CJSON_SNAPSHOT_TAG_CONSTANT;
+		return cjsonE_Ok;
+	}
+
+	switch(lpValue->type) {
+		case cjsonNumber_UnsignedLong:
+			qwBits = (uint64_t)(((const struct cjsonNumber*)lpValue)->value.ulong);
+			if(qwBits < (1ULL << 61)) {
+				(*lpOffsetOut) = (qwBits << 3) | CJSON_SNAPSHOT_TAG_ULONG;
+				return cjsonE_Ok;
+			}
+			return cjsonSnapshot_EmitNode(lpWriter, lpValue->type, qwBits, lpOffsetOut);
+		case cjsonNumber_SignedLong:
+			iValue = (int64_t)(((const struct cjsonNumber*)lpValue)->value.slong);
+			if((iValue >= -(1LL << 60)) && (iValue < (1LL << 60))) {
+				(*lpOffsetOut) = (((uint64_t)iValue) << 3) | CJSON_SNAPSHOT_TAG_SLONG;
+				return cjsonE_Ok;
+			}
+			return cjsonSnapshot_EmitNode(lpWriter, lpValue->type, (uint64_t)iValue, lpOffsetOut);
+		case cjsonNumber_Double:
+			memcpy(&qwBits, &(((const struct cjsonNumber*)lpValue)->value.dbl), sizeof(qwBits));
+			return cjsonSnapshot_EmitNode(lpWriter, lpValue->type, qwBits, lpOffsetOut);
+		case cjsonTrue:
+		case cjsonFalse:
+		case cjsonNull:
+			(*lpOffsetOut) = (((uint64_t)lpValue->type) << 3) | CJSON_SNAPSHOT_TAG_CONSTANT;
+			return cjsonE_Ok;
+		case cjsonString:
+			lpString = (const struct cjsonString*)lpValue;
+			e = cjsonSnapshot_EmitNode(lpWriter, cjsonString, lpString->dwStrlen, lpOffsetOut);
+			if(e != cjsonE_Ok) { return e; }
+			e = cjsonSnapshot_Emit(lpWriter, lpString->bData, lpString->dwStrlen);
+			if(e != cjsonE_Ok) { return e; }
+			e = cjsonSnapshot_Emit(lpWriter, "", 1);
+			if(e != cjsonE_Ok) { return e; }
+			return cjsonSnapshot_Align(lpWriter);
+		default:
+			return cjsonE_ImplementationError;
+	}
+}
+
+static int cjsonSnapshot_CompareKeys(
+	const char* lpKeyA,
+	unsigned long int dwKeyLengthA,
+	const char* lpKeyB,
+	unsigned long int dwKeyLengthB
+) {
+	unsigned long int dwCommon = (dwKeyLengthA < dwKeyLengthB) ? dwKeyLengthA : dwKeyLengthB;
+	int iResult;
+
+	if(dwCommon > 0) {
+		iResult = memcmp(lpKeyA, lpKeyB, dwCommon);
+		if(iResult != 0) { return iResult; }
+	}
+	if(dwKeyLengthA == dwKeyLengthB) { return 0; }
+	return (dwKeyLengthA < dwKeyLengthB) ? -1 : 1;
+}
+static int cjsonSnapshot_CompareEntries(
+	const void* lpA,
+	const void* lpB
+) {
+	const struct cjsonSnapshot_Entry* lpEntryA = (const struct cjsonSnapshot_Entry*)lpA;
+	const struct cjsonSnapshot_Entry* lpEntryB = (const struct cjsonSnapshot_Entry*)lpB;
+
+	return cjsonSnapshot_CompareKeys(lpEntryA->lpKey, lpEntryA->dwKeyLength, lpEntryB->lpKey, lpEntryB->dwKeyLength);
+}
+
+/*
+	Writes a container after all of its children have been written
+*/
+static enum cjsonError cjsonSnapshot_WriteContainer(
+	struct cjsonSnapshot_Writer* lpWriter,
+	struct cjsonSnapshot_Frame* lpFrame,
+	uint64_t* lpOffsetOut
+) {
+	enum cjsonError e;
+	unsigned long int i;
+	uint64_t qwKeyBlock;
+	uint64_t qwKeyBlockLength = 0;
+	uint32_t dwEntry[2];
+
+	if(lpFrame->lpSource->type == cjsonArray) {
+		e = cjsonSnapshot_EmitNode(lpWriter, cjsonArray, lpFrame->dwEntries, lpOffsetOut);
+		for(i = 0; (i < lpFrame->dwEntries) && (e == cjsonE_Ok); i=i+1) {
+			e = cjsonSnapshot_Emit(lpWriter, &(lpFrame->lpEntries[i].qwValue), sizeof(uint64_t));
+		}
+		return e;
+	}
+
+	if(lpFrame->dwEntries > 1) {
+		qsort(lpFrame->lpEntries, lpFrame->dwEntries, sizeof(struct cjsonSnapshot_Entry), &cjsonSnapshot_CompareEntries);
+	}
+
+	/* Key block in front of the node, keys are addressed by their 32 bit distance */
+	for(i = 0; i < lpFrame->dwEntries; i=i+1) {
+		qwKeyBlockLength = qwKeyBlockLength + lpFrame->lpEntries[i].dwKeyLength;
+	}
+	if(qwKeyBlockLength + 8 > (uint64_t)UINT32_MAX) { return cjsonE_EncodingError; }
+
+	qwKeyBlock = lpWriter->qwOffset;
+	for(i = 0; i < lpFrame->dwEntries; i=i+1) {
+		e = cjsonSnapshot_Emit(lpWriter, lpFrame->lpEntries[i].lpKey, lpFrame->lpEntries[i].dwKeyLength);
+		if(e != cjsonE_Ok) { return e; }
+	}
+	e = cjsonSnapshot_Align(lpWriter);
+	if(e != cjsonE_Ok) { return e; }
+
+	e = cjsonSnapshot_EmitNode(lpWriter, cjsonObject, lpFrame->dwEntries, lpOffsetOut);
+	for(i = 0; (i < lpFrame->dwEntries) && (e == cjsonE_Ok); i=i+1) {
+		dwEntry[0] = (uint32_t)((*lpOffsetOut) - qwKeyBlock);
+		dwEntry[1] = (uint32_t)(lpFrame->lpEntries[i].dwKeyLength);
+		qwKeyBlock = qwKeyBlock + lpFrame->lpEntries[i].dwKeyLength;
+		e = cjsonSnapshot_Emit(lpWriter, dwEntry, sizeof(dwEntry));
+		if(e == cjsonE_Ok) { e = cjsonSnapshot_Emit(lpWriter, &(lpFrame->lpEntries[i].qwValue), sizeof(uint64_t)); }
+	}
+	return e;
+}
+
+/*
+	Writer stack
+*/
+static enum cjsonError cjsonSnapshot_Push(
+	struct cjsonScratch_Stack* lpStack,
+	const struct cjsonValue* lpSource
+) {
+	enum cjsonError e;
+	struct cjsonSnapshot_Frame* lpFrame;
+	unsigned long int dwCount;
+
+	struct cjsonSnapshot_Entry* lpEntries = NULL;
+
+	dwCount = (lpSource->type == cjsonArray) ? ((const struct cjsonArray*)lpSource)->dwElementCount : ((const struct cjsonObject*)lpSource)->dwElementCount;
+	if(dwCount > 0) {
+		e = cjsonScratch_Alloc(lpStack->lpSystem, sizeof(struct cjsonSnapshot_Entry) * dwCount, (void**)(&lpEntries));
+		if(e != cjsonE_Ok) { return e; }
+	}
+
+	lpFrame = (struct cjsonSnapshot_Frame*)cjsonScratch_Push(lpStack);
+	if(lpFrame == NULL) {
+		cjsonScratch_Free(lpStack->lpSystem, (void*)lpEntries);
+		return cjsonE_OutOfMemory;
+	}
+
+	lpFrame->lpSource = lpSource;
+	lpFrame->lpPage = (lpSource->type == cjsonArray) ? ((const struct cjsonArray*)lpSource)->pageList.lpFirstPage : NULL;
+	lpFrame->lpEntry = NULL;
+	lpFrame->dwCursor = 0;
+	lpFrame->lpEntries = lpEntries;
+	lpFrame->dwEntries = 0;
+	lpFrame->dwCapacity = dwCount;
+	return cjsonE_Ok;
+}
+static void cjsonSnapshot_Pop(
+	struct cjsonScratch_Stack* lpStack
+) {
+	struct cjsonSnapshot_Frame* lpFrame;
+
+	lpFrame = (struct cjsonSnapshot_Frame*)CJSON_SCRATCH_TOP(lpStack);
+	cjsonScratch_Free(lpStack->lpSystem, (void*)(lpFrame->lpEntries));
+	cjsonScratch_Pop(lpStack);
+}
+
+/*
+	Fetches the next child of the frames container. Returns 0
+	if all children have been visited.
+*/
+static int cjsonSnapshot_NextChild(
+	struct cjsonSnapshot_Frame* lpFrame,
+	const char** lpKeyOut,
+	unsigned long int* lpKeyLengthOut,
+	const struct cjsonValue** lpChildOut
+) {
+	const struct cjsonObject* lpObject;
+
+	if(lpFrame->lpSource->type == cjsonArray) {
+		while(lpFrame->lpPage != NULL) {
+			if(lpFrame->dwCursor < lpFrame->lpPage->dwUsedEntries) {
+				(*lpKeyOut) = NULL;
+				(*lpKeyLengthOut) = 0;
+				(*lpChildOut) = lpFrame->lpPage->entries[lpFrame->dwCursor];
+				lpFrame->dwCursor = lpFrame->dwCursor + 1;
+				return 1;
+			}
+			lpFrame->lpPage = lpFrame->lpPage->pageList.lpNext;
+			lpFrame->dwCursor = 0;
+		}
+		return 0;
+	}
+
+	lpObject = (const struct cjsonObject*)(lpFrame->lpSource);
+	while(lpFrame->lpEntry == NULL) {
+		if(lpFrame->dwCursor >= lpObject->dwBucketCount) { return 0; }
+		lpFrame->lpEntry = lpObject->buckets[lpFrame->dwCursor];
+		lpFrame->dwCursor = lpFrame->dwCursor + 1;
+	}
+
+	(*lpKeyOut) = lpFrame->lpEntry->bKey;
+	(*lpKeyLengthOut) = lpFrame->lpEntry->dwKeyLength;
+	(*lpChildOut) = lpFrame->lpEntry->lpValue;
+	lpFrame->lpEntry = lpFrame->lpEntry->bucketList.lpNext;
+	if(lpFrame->lpEntry != NULL) { CJSON_PREFETCH(lpFrame->lpEntry); }
+	return 1;
+}
+
+static enum cjsonError cjsonSnapshot_WriteTree(
+	struct cjsonSnapshot_Writer* lpWriter,
+	const struct cjsonValue* lpRoot,
+	uint64_t* lpRootOut
+) {
+	enum cjsonError e;
+	struct cjsonSnapshot_Frame stackBase[CJSON_SNAPSHOT_STACKSEGMENT];
+	struct cjsonScratch_Stack stack;
+	struct cjsonSnapshot_Frame* lpFrame;
+	struct cjsonSnapshot_Entry* lpSlot;
+	const struct cjsonValue* lpChild;
+	const char* lpKey;
+	unsigned long int dwKeyLength;
+	uint64_t qwOffset;
+
+	if((lpRoot->type != cjsonArray) && (lpRoot->type != cjsonObject)) {
+		return cjsonSnapshot_WriteScalar(lpWriter, lpRoot, lpRootOut);
+	}
+
+	cjsonScratch_StackInit(&stack, (void*)stackBase, sizeof(struct cjsonSnapshot_Frame), CJSON_SNAPSHOT_STACKSEGMENT, lpWriter->lpSystem);
+	e = cjsonSnapshot_Push(&stack, lpRoot);
+	while((e == cjsonE_Ok) && !CJSON_SCRATCH_EMPTY(&stack)) {
+		lpFrame = (struct cjsonSnapshot_Frame*)CJSON_SCRATCH_TOP(&stack);
+
+		if(cjsonSnapshot_NextChild(lpFrame, &lpKey, &dwKeyLength, &lpChild) != 0) {
+			if(lpFrame->dwEntries >= lpFrame->dwCapacity) { e = cjsonE_ImplementationError; break; }
+
+			/* The key is remembered until the child has been written */
+			lpSlot = &(lpFrame->lpEntries[lpFrame->dwEntries]);
+			lpSlot->lpKey = lpKey;
+			lpSlot->dwKeyLength = dwKeyLength;
+
+			if((lpChild != NULL) && ((lpChild->type == cjsonArray) || (lpChild->type == cjsonObject))) {
+				e = cjsonSnapshot_Push(&stack, lpChild);
+			} else {
+				e = cjsonSnapshot_WriteScalar(lpWriter, lpChild, &(lpSlot->qwValue));
+				lpFrame->dwEntries = lpFrame->dwEntries + 1;
+			}
+			continue;
+		}
+
+		e = cjsonSnapshot_WriteContainer(lpWriter, lpFrame, &qwOffset);
+		cjsonSnapshot_Pop(&stack);
+		if(CJSON_SCRATCH_EMPTY(&stack)) {
+			(*lpRootOut) = qwOffset;
+		} else {
+			lpFrame = (struct cjsonSnapshot_Frame*)CJSON_SCRATCH_TOP(&stack);
+			lpFrame->lpEntries[lpFrame->dwEntries].qwValue = qwOffset;
+			lpFrame->dwEntries = lpFrame->dwEntries + 1;
+		}
+	}
+
+	while(!CJSON_SCRATCH_EMPTY(&stack)) { cjsonSnapshot_Pop(&stack); }
+	return e;
+}
+
+enum cjsonError cjsonSnapshot_Write(
+	const struct cjsonValue* lpRoot,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam,
+	struct cjsonSystemAPI* lpSystem
+) {
+	enum cjsonError e;
+	struct cjsonSnapshot_Writer* lpWriter;
+	uint32_t dwHeader[2];
+	uint64_t qwTrailer[2];
+
+	if(lpRoot == NULL) { return cjsonE_InvalidParam; }
+	if(callback == NULL) { return cjsonE_InvalidParam; }
+
+	/* The writer carries the output buffer and lives on the heap */
+	e = cjsonSnapshot_Alloc(lpSystem, sizeof(struct cjsonSnapshot_Writer), (void**)(&lpWriter));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpWriter->callback = callback;
+	lpWriter->callbackFreeParam = callbackFreeParam;
+	lpWriter->lpSystem = lpSystem;
+	lpWriter->qwOffset = 0;
+	lpWriter->dwBufferUsed = 0;
+
+	dwHeader[0] = CJSON_SNAPSHOT_BYTEORDER;
+	dwHeader[1] = 0;
+	e = cjsonSnapshot_Emit(lpWriter, CJSON_SNAPSHOT_MAGIC, 8);
+	if(e == cjsonE_Ok) { e = cjsonSnapshot_Emit(lpWriter, dwHeader, sizeof(dwHeader)); }
+	if(e == cjsonE_Ok) { e = cjsonSnapshot_WriteTree(lpWriter, lpRoot, &(qwTrailer[0])); }
+	if(e == cjsonE_Ok) {
+		qwTrailer[1] = lpWriter->qwOffset + sizeof(qwTrailer);
+		e = cjsonSnapshot_Emit(lpWriter, qwTrailer, sizeof(qwTrailer));
+	}
+	if(e == cjsonE_Ok) { e = cjsonSnapshot_Flush(lpWriter); }
+
+	cjsonSnapshot_Free(lpSystem, (void*)lpWriter);
+	return e;
+}
+
+/*
+	Reading. Every access validates that the referenced node lies
+	inside the image so a corrupted image can't cause reads outside
+	of the mapping.
+*/
+static inline uint64_t cjsonSnapshot_Load64(
+	const char* lpData
+) {
+	uint64_t qwValue;
+	memcpy(&qwValue, lpData, sizeof(qwValue));
+	return qwValue;
+}
+static inline uint32_t cjsonSnapshot_Load32(
+	const char* lpData
+) {
+	uint32_t dwValue;
+	memcpy(&dwValue, lpData, sizeof(dwValue));
+	return dwValue;
+}
+
+/*
+	Returns the node at qwValue if its header is inside the image and
+	it has the requested type (any type for cjsonUnknown)
+*/
+static inline const char* cjsonSnapshot_Node(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwValue,
+	enum cjsonElementType type
+) {
+	const char* lpNode;
+
+	if(lpSnapshot == NULL) { return NULL; }
+	if((qwValue & CJSON_SNAPSHOT_TAG_MASK) != CJSON_SNAPSHOT_TAG_NODE) { return NULL; }
+	if((qwValue < CJSON_SNAPSHOT_HEADERSIZE) || (qwValue > lpSnapshot->qwSize - CJSON_SNAPSHOT_TRAILERSIZE - CJSON_SNAPSHOT_NODESIZE)) { return NULL; }
+
+	lpNode = &(lpSnapshot->lpData[qwValue]);
+	if((type != cjsonUnknown) && (cjsonSnapshot_Load32(lpNode) != (uint32_t)type)) { return NULL; }
+	return lpNode;
+}
+static inline int cjsonSnapshot_PayloadFits(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwValue,
+	uint64_t qwCount,
+	uint64_t qwElementSize
+) {
+	uint64_t qwAvailable = lpSnapshot->qwSize - CJSON_SNAPSHOT_TRAILERSIZE - CJSON_SNAPSHOT_NODESIZE - qwValue;
+	return (qwCount <= qwAvailable / qwElementSize) ? 1 : 0;
+}
+
+enum cjsonError cjsonSnapshot_Open(
+	struct cjsonSnapshot* lpOut,
+	const void* lpData,
+	unsigned long int dwSize
+) {
+	const char* lpBytes = (const char*)lpData;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	lpOut->lpData = NULL;
+	lpOut->qwSize = 0;
+	lpOut->qwRoot = 0;
+
+	if(lpData == NULL) { return cjsonE_InvalidParam; }
+	if(((uintptr_t)lpData % 8) != 0) { return cjsonE_InvalidParam; }
+	if(dwSize < CJSON_SNAPSHOT_HEADERSIZE + CJSON_SNAPSHOT_TRAILERSIZE) { return cjsonE_EncodingError; }
+	if((dwSize % 8) != 0) { return cjsonE_EncodingError; }
+
+	if(memcmp(lpBytes, CJSON_SNAPSHOT_MAGIC, 8) != 0) { return cjsonE_EncodingError; }
+	if(cjsonSnapshot_Load32(&(lpBytes[8])) != CJSON_SNAPSHOT_BYTEORDER) { return cjsonE_EncodingError; }
+	if(cjsonSnapshot_Load64(&(lpBytes[dwSize - 8])) != (uint64_t)dwSize) { return cjsonE_EncodingError; }
+
+	lpOut->lpData = lpBytes;
+	lpOut->qwSize = dwSize;
+	lpOut->qwRoot = cjsonSnapshot_Load64(&(lpBytes[dwSize - CJSON_SNAPSHOT_TRAILERSIZE]));
+
+	if(cjsonSnapshot_Type(lpOut, lpOut->qwRoot) == cjsonUnknown) {
+		lpOut->lpData = NULL;
+		lpOut->qwSize = 0;
+		lpOut->qwRoot = 0;
+		return cjsonE_EncodingError;
+	}
+	return cjsonE_Ok;
+}
+
+enum cjsonElementType cjsonSnapshot_Type(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwValue
+) {
+	const char* lpNode;
+	uint64_t qwType;
+	uint32_t dwType;
+
+	switch(qwValue & CJSON_SNAPSHOT_TAG_MASK) {
+		case CJSON_SNAPSHOT_TAG_ULONG:		return cjsonNumber_UnsignedLong;
+		case CJSON_SNAPSHOT_TAG_SLONG:		return cjsonNumber_SignedLong;
+		case CJSON_SNAPSHOT_TAG_CONSTANT:
+			qwType = qwValue >> 3;
+			if((qwType != (uint64_t)cjsonTrue) && (qwType != (uint64_t)cjsonFalse) && (qwType != (uint64_t)cjsonNull)) { return cjsonUnknown; }
+			return (enum cjsonElementType)qwType;
+		case CJSON_SNAPSHOT_TAG_NODE:		break;
+		default:							return cjsonUnknown;
+	}
+
+	lpNode = cjsonSnapshot_Node(lpSnapshot, qwValue, cjsonUnknown);
+	if(lpNode == NULL) { return cjsonUnknown; }
+	dwType = cjsonSnapshot_Load32(lpNode);
+	if((dwType < (uint32_t)cjsonObject) || (dwType > (uint32_t)cjsonNull)) { return cjsonUnknown; }
+	return (enum cjsonElementType)dwType;
+}
+
+unsigned long int cjsonSnapshotArray_Length(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwArray
+) {
+	const char* lpNode = cjsonSnapshot_Node(lpSnapshot, qwArray, cjsonArray);
+
+	if(lpNode == NULL) { return 0; }
+	return (unsigned long int)cjsonSnapshot_Load64(&(lpNode[8]));
+}
+enum cjsonError cjsonSnapshotArray_Get(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwArray,
+	unsigned long int idx,
+	uint64_t* lpValueOut
+) {
+	const char* lpNode;
+	uint64_t qwCount;
+
+	if(lpValueOut == NULL) { return cjsonE_InvalidParam; }
+
+	lpNode = cjsonSnapshot_Node(lpSnapshot, qwArray, cjsonArray);
+	if(lpNode == NULL) { return cjsonE_InvalidParam; }
+
+	qwCount = cjsonSnapshot_Load64(&(lpNode[8]));
+	if(cjsonSnapshot_PayloadFits(lpSnapshot, qwArray, qwCount, 8) == 0) { return cjsonE_EncodingError; }
+	if(idx >= qwCount) { return cjsonE_IndexOutOfBounds; }
+
+	(*lpValueOut) = cjsonSnapshot_Load64(&(lpNode[CJSON_SNAPSHOT_NODESIZE + 8 * idx]));
+	return cjsonE_Ok;
+}
+
+unsigned long int cjsonSnapshotObject_Length(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwObject
+) {
+	const char* lpNode = cjsonSnapshot_Node(lpSnapshot, qwObject, cjsonObject);
+
+	if(lpNode == NULL) { return 0; }
+	return (unsigned long int)cjsonSnapshot_Load64(&(lpNode[8]));
+}
+static inline const char* cjsonSnapshot_EntryKey(
+	uint64_t qwObject,
+	const char* lpNode,
+	const char* lpEntry,
+	unsigned long int* lpKeyLengthOut
+) {
+	uint32_t dwDistance = cjsonSnapshot_Load32(lpEntry);
+	uint32_t dwKeyLength = cjsonSnapshot_Load32(&(lpEntry[4]));
+
+	/* Keys are located between the header and the object node */
+	if(((uint64_t)dwDistance > qwObject - CJSON_SNAPSHOT_HEADERSIZE) || (dwKeyLength > dwDistance)) { return NULL; }
+	(*lpKeyLengthOut) = (unsigned long int)dwKeyLength;
+	return lpNode - dwDistance;
+}
+enum cjsonError cjsonSnapshotObject_Get(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwObject,
+	const char* lpKey,
+	unsigned long int dwKeyLength,
+	uint64_t* lpValueOut
+) {
+	const char* lpNode;
+	const char* lpEntry;
+	const char* lpEntryKey;
+	unsigned long int dwEntryKeyLength;
+	uint64_t qwLow, qwHigh, qwMid;
+	int iCompare;
+
+	if(lpValueOut == NULL) { return cjsonE_InvalidParam; }
+	if((lpKey == NULL) && (dwKeyLength > 0)) { return cjsonE_InvalidParam; }
+
+	lpNode = cjsonSnapshot_Node(lpSnapshot, qwObject, cjsonObject);
+	if(lpNode == NULL) { return cjsonE_InvalidParam; }
+
+	qwHigh = cjsonSnapshot_Load64(&(lpNode[8]));
+	if(cjsonSnapshot_PayloadFits(lpSnapshot, qwObject, qwHigh, CJSON_SNAPSHOT_ENTRYSIZE) == 0) { return cjsonE_EncodingError; }
+
+	qwLow = 0;
+	while(qwLow < qwHigh) {
+		qwMid = qwLow + (qwHigh - qwLow) / 2;
+		lpEntry = &(lpNode[CJSON_SNAPSHOT_NODESIZE + CJSON_SNAPSHOT_ENTRYSIZE * qwMid]);
+
+		lpEntryKey = cjsonSnapshot_EntryKey(qwObject, lpNode, lpEntry, &dwEntryKeyLength);
+		if(lpEntryKey == NULL) { return cjsonE_EncodingError; }
+
+		iCompare = cjsonSnapshot_CompareKeys(lpKey, dwKeyLength, lpEntryKey, dwEntryKeyLength);
+		if(iCompare == 0) {
+			(*lpValueOut) = cjsonSnapshot_Load64(&(lpEntry[8]));
+			return cjsonE_Ok;
+		}
+		if(iCompare < 0) {
+			qwHigh = qwMid;
+		} else {
+			qwLow = qwMid + 1;
+		}
+	}
+	return cjsonE_IndexOutOfBounds;
+}
+enum cjsonError cjsonSnapshotObject_GetEntry(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwObject,
+	unsigned long int idx,
+	const char** lpKeyOut,
+	unsigned long int* lpKeyLengthOut,
+	uint64_t* lpValueOut
+) {
+	const char* lpNode;
+	const char* lpEntry;
+	const char* lpEntryKey;
+	unsigned long int dwEntryKeyLength;
+	uint64_t qwCount;
+
+	if((lpKeyOut == NULL) || (lpKeyLengthOut == NULL) || (lpValueOut == NULL)) { return cjsonE_InvalidParam; }
+
+	lpNode = cjsonSnapshot_Node(lpSnapshot, qwObject, cjsonObject);
+	if(lpNode == NULL) { return cjsonE_InvalidParam; }
+
+	qwCount = cjsonSnapshot_Load64(&(lpNode[8]));
+	if(cjsonSnapshot_PayloadFits(lpSnapshot, qwObject, qwCount, CJSON_SNAPSHOT_ENTRYSIZE) == 0) { return cjsonE_EncodingError; }
+	if(idx >= qwCount) { return cjsonE_IndexOutOfBounds; }
+
+	lpEntry = &(lpNode[CJSON_SNAPSHOT_NODESIZE + CJSON_SNAPSHOT_ENTRYSIZE * idx]);
+	lpEntryKey = cjsonSnapshot_EntryKey(qwObject, lpNode, lpEntry, &dwEntryKeyLength);
+	if(lpEntryKey == NULL) { return cjsonE_EncodingError; }
+
+	(*lpKeyOut) = lpEntryKey;
+	(*lpKeyLengthOut) = dwEntryKeyLength;
+	(*lpValueOut) = cjsonSnapshot_Load64(&(lpEntry[8]));
+	return cjsonE_Ok;
+}
+
+enum cjsonError cjsonSnapshotString_Get(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwString,
+	const char** lpDataOut,
+	unsigned long int* lpLengthOut
+) {
+	const char* lpNode;
+	uint64_t qwLength;
+
+	if((lpDataOut == NULL) || (lpLengthOut == NULL)) { return cjsonE_InvalidParam; }
+
+	lpNode = cjsonSnapshot_Node(lpSnapshot, qwString, cjsonString);
+	if(lpNode == NULL) { return cjsonE_InvalidParam; }
+
+	qwLength = cjsonSnapshot_Load64(&(lpNode[8]));
+	if(cjsonSnapshot_PayloadFits(lpSnapshot, qwString, qwLength, 1) == 0) { return cjsonE_EncodingError; }
+
+	(*lpDataOut) = &(lpNode[CJSON_SNAPSHOT_NODESIZE]);
+	(*lpLengthOut) = (unsigned long int)qwLength;
+	return cjsonE_Ok;
+}
+
+/*
+	Decodes an inline signed integer (sign extension of the upper 61 bits)
+*/
+static inline int64_t cjsonSnapshot_InlineSLong(
+	uint64_t qwValue
+) {
+	uint64_t qwBits = qwValue >> 3;
+
+	if((qwValue & 0x8000000000000000ULL) != 0) { qwBits = qwBits | 0xE000000000000000ULL; }
+	return (int64_t)qwBits;
+}
+
+enum cjsonError cjsonSnapshotNumber_GetULong(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwNumber,
+	unsigned long int* lpOut
+) {
+	const char* lpNode;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+
+	if((qwNumber & CJSON_SNAPSHOT_TAG_MASK) == CJSON_SNAPSHOT_TAG_ULONG) {
+		(*lpOut) = (unsigned long int)(qwNumber >> 3);
+		return cjsonE_Ok;
+	}
+
+	lpNode = cjsonSnapshot_Node(lpSnapshot, qwNumber, cjsonNumber_UnsignedLong);
+	if(lpNode == NULL) { return cjsonE_InvalidParam; }
+
+	(*lpOut) = (unsigned long int)cjsonSnapshot_Load64(&(lpNode[8]));
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonSnapshotNumber_GetSLong(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwNumber,
+	signed long int* lpOut
+) {
+	const char* lpNode;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+
+	if((qwNumber & CJSON_SNAPSHOT_TAG_MASK) == CJSON_SNAPSHOT_TAG_SLONG) {
+		(*lpOut) = (signed long int)cjsonSnapshot_InlineSLong(qwNumber);
+		return cjsonE_Ok;
+	}
+
+	lpNode = cjsonSnapshot_Node(lpSnapshot, qwNumber, cjsonNumber_SignedLong);
+	if(lpNode == NULL) { return cjsonE_InvalidParam; }
+
+	(*lpOut) = (signed long int)((int64_t)cjsonSnapshot_Load64(&(lpNode[8])));
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonSnapshotNumber_GetDouble(
+	const struct cjsonSnapshot* lpSnapshot,
+	uint64_t qwNumber,
+	double* lpOut
+) {
+	const char* lpNode;
+	uint64_t qwBits;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+
+	switch(qwNumber & CJSON_SNAPSHOT_TAG_MASK) {
+		case CJSON_SNAPSHOT_TAG_ULONG:	(*lpOut) = (double)(qwNumber >> 3); return cjsonE_Ok;
+		case CJSON_SNAPSHOT_TAG_SLONG:	(*lpOut) = (double)cjsonSnapshot_InlineSLong(qwNumber); return cjsonE_Ok;
+		default:						break;
+	}
+
+	lpNode = cjsonSnapshot_Node(lpSnapshot, qwNumber, cjsonUnknown);
+	if(lpNode == NULL) { return cjsonE_InvalidParam; }
+
+	qwBits = cjsonSnapshot_Load64(&(lpNode[8]));
+	switch(cjsonSnapshot_Load32(lpNode)) {
+		case cjsonNumber_UnsignedLong:	(*lpOut) = (double)qwBits; return cjsonE_Ok;
+		case cjsonNumber_SignedLong:	(*lpOut) = (double)((int64_t)qwBits); return cjsonE_Ok;
+		case cjsonNumber_Double:		memcpy(lpOut, &qwBits, sizeof(double)); return cjsonE_Ok;
+		default:						return cjsonE_InvalidParam;
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -25,14 +25,15 @@ enum cjsonError cjsonString_Create(
 			return cjsonE_OutOfMemory;
 		}
 	} else {
-		e = lpSystem->alloc(lpSystem, sizeof(struct cjsonString)+dwDataLength, (void**)(&lpNew));
+		e = cjsonSystemAPI_AllocAt(lpSystem, cjsonAllocSite__String, sizeof(struct cjsonString)+dwDataLength, (void**)(&lpNew));
 		if(e != cjsonE_Ok) { return e; }
 	}
 
 	lpNew->base.type = cjsonString;
 	lpNew->base.lpSystem = lpSystem;
+	lpNew->base.dwRefCount = 1;
 	lpNew->dwStrlen = dwDataLength;
-	memcpy(lpNew->bData, lpData, dwDataLength);
+	if(lpData != NULL) { memcpy(lpNew->bData, lpData, dwDataLength); }
 
 	(*lpStringOut) = (struct cjsonValue*)lpNew;
 	return cjsonE_Ok;
@@ -0,0 +1,513 @@
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_TRANSCODER_INITIALSTACK
+	#define CJSON_TRANSCODER_INITIALSTACK 8			/* Initial size of the nesting bit stack in bytes (64 levels) */
+#endif
+
+static const char cjsonTranscoder_Tabs[16] = { '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t' };
+
+/*
+	Malloc and free abstraction
+*/
+static inline enum cjsonError cjsonTranscoder_Alloc(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpSystem->alloc(lpSystem, dwSize, lpOut);
+	}
+}
+static inline void cjsonTranscoder_Free(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+
+/*
+	Character classes
+*/
+static inline int cjsonTranscoder_IsWhitespace(char bByte) {
+	return (bByte == ' ') || (bByte == '\n') || (bByte == '\r') || (bByte == '\t');
+}
+static inline int cjsonTranscoder_IsDigit(char bByte) {
+	return (bByte >= '0') && (bByte <= '9');
+}
+static inline int cjsonTranscoder_IsHex(char bByte) {
+	return ((bByte >= '0') && (bByte <= '9')) || ((bByte >= 'a') && (bByte <= 'f')) || ((bByte >= 'A') && (bByte <= 'F'));
+}
+static inline int cjsonTranscoder_IsPlain(char bByte) {
+	return (((unsigned char)bByte) >= 0x20) && (bByte != '"') && (bByte != '\\');
+}
+
+/*
+	Linebreak followed by one tab per level (pretty print only)
+*/
+static void cjsonTranscoder_Newline(
+	struct cjsonTranscoder* lpTranscoder,
+	unsigned long int dwLevel
+) {
+	unsigned long int dwChunk;
+
+	if((lpTranscoder->dwFlags & CJSON_SERIALIZER__FLAG__PRETTYPRINT) == 0) { return; }
+
+	cjsonWriter_Raw(&(lpTranscoder->writer), "\n", 1);
+	while(dwLevel > 0) {
+		dwChunk = (dwLevel > sizeof(cjsonTranscoder_Tabs)) ? sizeof(cjsonTranscoder_Tabs) : dwLevel;
+		cjsonWriter_Raw(&(lpTranscoder->writer), cjsonTranscoder_Tabs, dwChunk);
+		dwLevel = dwLevel - dwChunk;
+	}
+}
+
+/*
+	Nesting stack
+*/
+static enum cjsonError cjsonTranscoder_Push(
+	struct cjsonTranscoder* lpTranscoder,
+	int bObject
+) {
+	enum cjsonError e;
+	uint8_t* lpNew;
+	unsigned long int dwByte = lpTranscoder->dwDepth / 8;
+
+	if(dwByte >= lpTranscoder->dwStackSize) {
+		e = cjsonTranscoder_Alloc(lpTranscoder->lpSystem, lpTranscoder->dwStackSize * 2, (void**)(&lpNew));
+		if(e != cjsonE_Ok) { return e; }
+		memcpy(lpNew, lpTranscoder->lpStack, lpTranscoder->dwStackSize);
+		cjsonTranscoder_Free(lpTranscoder->lpSystem, lpTranscoder->lpStack);
+		lpTranscoder->lpStack = lpNew;
+		lpTranscoder->dwStackSize = lpTranscoder->dwStackSize * 2;
+	}
+
+	if(bObject != 0) {
+		lpTranscoder->lpStack[dwByte] = lpTranscoder->lpStack[dwByte] | (uint8_t)(1 << (lpTranscoder->dwDepth % 8));
+	} else {
+		lpTranscoder->lpStack[dwByte] = lpTranscoder->lpStack[dwByte] & (uint8_t)~(1 << (lpTranscoder->dwDepth % 8));
+	}
+	lpTranscoder->dwDepth = lpTranscoder->dwDepth + 1;
+	return cjsonE_Ok;
+}
+static inline int cjsonTranscoder_InObject(
+	struct cjsonTranscoder* lpTranscoder
+) {
+	unsigned long int dwTop = lpTranscoder->dwDepth - 1;
+	return (lpTranscoder->lpStack[dwTop / 8] & (1 << (dwTop % 8))) != 0;
+}
+
+/*
+	Pretty print layout of the serializer: object members are indented
+	by one tab per level, array elements by a single tab
+*/
+static inline unsigned long int cjsonTranscoder_MemberIndent(
+	struct cjsonTranscoder* lpTranscoder
+) {
+	return (cjsonTranscoder_InObject(lpTranscoder) != 0) ? lpTranscoder->dwDepth : 1;
+}
+
+/*
+	A value has been written completely
+*/
+static void cjsonTranscoder_ValueDone(
+	struct cjsonTranscoder* lpTranscoder
+) {
+	if(lpTranscoder->dwDepth > 0) {
+		lpTranscoder->state = cjsonTranscoder_State__CommaOrClose;
+		return;
+	}
+
+	lpTranscoder->dwDocuments = lpTranscoder->dwDocuments + 1;
+	if((lpTranscoder->dwFlags & CJSON_TRANSCODER_FLAG__STREAMINGMODE) != 0) {
+		cjsonWriter_Raw(&(lpTranscoder->writer), "\n", 1);
+		lpTranscoder->state = cjsonTranscoder_State__Value;
+	} else {
+		lpTranscoder->state = cjsonTranscoder_State__Done;
+	}
+}
+
+static enum cjsonError cjsonTranscoder_Close(
+	struct cjsonTranscoder* lpTranscoder,
+	char bByte,
+	int bEmpty
+) {
+	if(lpTranscoder->dwDepth == 0) { return cjsonE_EncodingError; }
+	if(bByte != ((cjsonTranscoder_InObject(lpTranscoder) != 0) ? '}' : ']')) { return cjsonE_EncodingError; }
+
+	lpTranscoder->dwDepth = lpTranscoder->dwDepth - 1;
+
+	/* Like the serializer empty arrays span two linebreaks, empty objects one */
+	if((bEmpty != 0) && (bByte == ']')) {
+		cjsonTranscoder_Newline(lpTranscoder, 0);
+	}
+	cjsonTranscoder_Newline(lpTranscoder, lpTranscoder->dwDepth);
+	cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+	cjsonTranscoder_ValueDone(lpTranscoder);
+	return cjsonE_Ok;
+}
+
+static enum cjsonError cjsonTranscoder_StartValue(
+	struct cjsonTranscoder* lpTranscoder,
+	char bByte
+) {
+	enum cjsonError e;
+
+	switch(bByte) {
+		case '{':
+			if((e = cjsonTranscoder_Push(lpTranscoder, 1)) != cjsonE_Ok) { return e; }
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			lpTranscoder->state = cjsonTranscoder_State__KeyOrClose;
+			return cjsonE_Ok;
+		case '[':
+			if((e = cjsonTranscoder_Push(lpTranscoder, 0)) != cjsonE_Ok) { return e; }
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			lpTranscoder->state = cjsonTranscoder_State__ValueOrClose;
+			return cjsonE_Ok;
+		case '"':
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			lpTranscoder->bKey = 0;
+			lpTranscoder->state = cjsonTranscoder_State__String;
+			return cjsonE_Ok;
+		case 't':	lpTranscoder->lpLiteral = "true"; break;
+		case 'f':	lpTranscoder->lpLiteral = "false"; break;
+		case 'n':	lpTranscoder->lpLiteral = "null"; break;
+		case '-':
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			lpTranscoder->state = cjsonTranscoder_State__NumberSign;
+			return cjsonE_Ok;
+		case '0':
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			lpTranscoder->state = cjsonTranscoder_State__NumberZero;
+			return cjsonE_Ok;
+		default:
+			if(cjsonTranscoder_IsDigit(bByte) == 0) { return cjsonE_EncodingError; }
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			lpTranscoder->state = cjsonTranscoder_State__NumberInt;
+			return cjsonE_Ok;
+	}
+
+	/* Literals are written after they have been matched completely */
+	lpTranscoder->dwAux = 1;
+	lpTranscoder->state = cjsonTranscoder_State__Literal;
+	return cjsonE_Ok;
+}
+static void cjsonTranscoder_StartKey(
+	struct cjsonTranscoder* lpTranscoder
+) {
+	cjsonWriter_Raw(&(lpTranscoder->writer), "\"", 1);
+	lpTranscoder->bKey = 1;
+	lpTranscoder->state = cjsonTranscoder_State__String;
+}
+
+/*
+	Single byte state machine. Returns cjsonE_OkRedeliver if a number
+	has been terminated by bByte and the byte has to be processed
+	again in the following state.
+*/
+static enum cjsonError cjsonTranscoder_Step(
+	struct cjsonTranscoder* lpTranscoder,
+	char bByte
+) {
+	switch(lpTranscoder->state) {
+		case cjsonTranscoder_State__String:
+			if(bByte == '"') {
+				cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+				if(lpTranscoder->bKey != 0) {
+					lpTranscoder->state = cjsonTranscoder_State__Colon;
+				} else {
+					cjsonTranscoder_ValueDone(lpTranscoder);
+				}
+				return cjsonE_Ok;
+			}
+			if(bByte == '\\') {
+				lpTranscoder->state = cjsonTranscoder_State__StringEscape;
+			} else if(((unsigned char)bByte) < 0x20) {
+				return cjsonE_EncodingError;
+			}
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			return cjsonE_Ok;
+
+		case cjsonTranscoder_State__StringEscape:
+			switch(bByte) {
+				case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+					lpTranscoder->state = cjsonTranscoder_State__String;
+					break;
+				case 'u':
+					lpTranscoder->dwAux = 0;
+					lpTranscoder->state = cjsonTranscoder_State__StringUnicode;
+					break;
+				default:
+					return cjsonE_EncodingError;
+			}
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			return cjsonE_Ok;
+
+		case cjsonTranscoder_State__StringUnicode:
+			if(cjsonTranscoder_IsHex(bByte) == 0) { return cjsonE_EncodingError; }
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			lpTranscoder->dwAux = lpTranscoder->dwAux + 1;
+			if(lpTranscoder->dwAux == 4) { lpTranscoder->state = cjsonTranscoder_State__String; }
+			return cjsonE_Ok;
+
+		case cjsonTranscoder_State__Literal:
+			if(bByte != lpTranscoder->lpLiteral[lpTranscoder->dwAux]) { return cjsonE_EncodingError; }
+			lpTranscoder->dwAux = lpTranscoder->dwAux + 1;
+			if(lpTranscoder->lpLiteral[lpTranscoder->dwAux] == 0) {
+				cjsonWriter_Raw(&(lpTranscoder->writer), lpTranscoder->lpLiteral, lpTranscoder->dwAux);
+				cjsonTranscoder_ValueDone(lpTranscoder);
+			}
+			return cjsonE_Ok;
+
+		/*
+			Numbers: -? (0 | [1-9][0-9]*) (. [0-9]+)? ([eE] [+-]? [0-9]+)?
+		*/
+		case cjsonTranscoder_State__NumberSign:
+			if(cjsonTranscoder_IsDigit(bByte) == 0) { return cjsonE_EncodingError; }
+			lpTranscoder->state = (bByte == '0') ? cjsonTranscoder_State__NumberZero : cjsonTranscoder_State__NumberInt;
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			return cjsonE_Ok;
+		case cjsonTranscoder_State__NumberZero:
+		case cjsonTranscoder_State__NumberInt:
+			if((lpTranscoder->state == cjsonTranscoder_State__NumberInt) && (cjsonTranscoder_IsDigit(bByte) != 0)) {
+				cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+				return cjsonE_Ok;
+			}
+			if(bByte == '.') {
+				lpTranscoder->state = cjsonTranscoder_State__NumberFracStart;
+				cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+				return cjsonE_Ok;
+			}
+			if((bByte == 'e') || (bByte == 'E')) {
+				lpTranscoder->state = cjsonTranscoder_State__NumberExpStart;
+				cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+				return cjsonE_Ok;
+			}
+			if(cjsonTranscoder_IsDigit(bByte) != 0) { return cjsonE_EncodingError; }		/* Leading zero */
+			cjsonTranscoder_ValueDone(lpTranscoder);
+			return cjsonE_OkRedeliver;
+		case cjsonTranscoder_State__NumberFracStart:
+			if(cjsonTranscoder_IsDigit(bByte) == 0) { return cjsonE_EncodingError; }
+			lpTranscoder->state = cjsonTranscoder_State__NumberFrac;
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			return cjsonE_Ok;
+		case cjsonTranscoder_State__NumberFrac:
+			if(cjsonTranscoder_IsDigit(bByte) != 0) {
+				cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+				return cjsonE_Ok;
+			}
+			if((bByte == 'e') || (bByte == 'E')) {
+				lpTranscoder->state = cjsonTranscoder_State__NumberExpStart;
+				cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+				return cjsonE_Ok;
+			}
+			cjsonTranscoder_ValueDone(lpTranscoder);
+			return cjsonE_OkRedeliver;
+		case cjsonTranscoder_State__NumberExpStart:
+			if((bByte == '+') || (bByte == '-')) {
+				lpTranscoder->state = cjsonTranscoder_State__NumberExpSign;
+				cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+				return cjsonE_Ok;
+			}
+			/* Fall through */
+		case cjsonTranscoder_State__NumberExpSign:
+			if(cjsonTranscoder_IsDigit(bByte) == 0) { return cjsonE_EncodingError; }
+			lpTranscoder->state = cjsonTranscoder_State__NumberExp;
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			return cjsonE_Ok;
+		case cjsonTranscoder_State__NumberExp:
+			if(cjsonTranscoder_IsDigit(bByte) != 0) {
+				cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+				return cjsonE_Ok;
+			}
+			cjsonTranscoder_ValueDone(lpTranscoder);
+			return cjsonE_OkRedeliver;
+
+		default:
+			break;
+	}
+
+	/* Structural states skip whitespace */
+	if(cjsonTranscoder_IsWhitespace(bByte) != 0) { return cjsonE_Ok; }
+
+	switch(lpTranscoder->state) {
+		case cjsonTranscoder_State__Value:
+			return cjsonTranscoder_StartValue(lpTranscoder, bByte);
+		case cjsonTranscoder_State__ValueOrClose:
+			if(bByte == ']') { return cjsonTranscoder_Close(lpTranscoder, bByte, 1); }
+			cjsonTranscoder_Newline(lpTranscoder, cjsonTranscoder_MemberIndent(lpTranscoder));
+			return cjsonTranscoder_StartValue(lpTranscoder, bByte);
+		case cjsonTranscoder_State__KeyOrClose:
+			if(bByte == '}') { return cjsonTranscoder_Close(lpTranscoder, bByte, 1); }
+			if(bByte != '"') { return cjsonE_EncodingError; }
+			cjsonTranscoder_Newline(lpTranscoder, lpTranscoder->dwDepth);
+			cjsonTranscoder_StartKey(lpTranscoder);
+			return cjsonE_Ok;
+		case cjsonTranscoder_State__Key:
+			if(bByte != '"') { return cjsonE_EncodingError; }
+			cjsonTranscoder_StartKey(lpTranscoder);
+			return cjsonE_Ok;
+		case cjsonTranscoder_State__Colon:
+			if(bByte != ':') { return cjsonE_EncodingError; }
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			lpTranscoder->state = cjsonTranscoder_State__Value;
+			return cjsonE_Ok;
+		case cjsonTranscoder_State__CommaOrClose:
+			if(bByte != ',') { return cjsonTranscoder_Close(lpTranscoder, bByte, 0); }
+			cjsonWriter_Raw(&(lpTranscoder->writer), &bByte, 1);
+			cjsonTranscoder_Newline(lpTranscoder, cjsonTranscoder_MemberIndent(lpTranscoder));
+			lpTranscoder->state = (cjsonTranscoder_InObject(lpTranscoder) != 0) ? cjsonTranscoder_State__Key : cjsonTranscoder_State__Value;
+			return cjsonE_Ok;
+		case cjsonTranscoder_State__Done:
+			return cjsonE_AlreadyFinished;
+		default:
+			return cjsonE_ImplementationError;
+	}
+}
+
+enum cjsonError cjsonTranscoder_Create(
+	struct cjsonTranscoder** lpOut,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam,
+	uint32_t dwFlags,
+	struct cjsonSystemAPI* lpSystem
+) {
+	enum cjsonError e;
+	struct cjsonTranscoder* lpNew;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+
+	if(callback == NULL) { return cjsonE_InvalidParam; }
+	if((dwFlags & ~(CJSON_SERIALIZER__FLAG__PRETTYPRINT|CJSON_TRANSCODER_FLAG__STREAMINGMODE)) != 0) { return cjsonE_InvalidParam; }
+
+	e = cjsonTranscoder_Alloc(lpSystem, sizeof(struct cjsonTranscoder), (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+	e = cjsonTranscoder_Alloc(lpSystem, CJSON_TRANSCODER_INITIALSTACK, (void**)(&(lpNew->lpStack)));
+	if(e != cjsonE_Ok) {
+		cjsonTranscoder_Free(lpSystem, lpNew);
+		return e;
+	}
+
+	cjsonWriter_Init(&(lpNew->writer), callback, callbackFreeParam);
+	lpNew->state							= cjsonTranscoder_State__Value;
+	lpNew->eStatus							= cjsonE_Ok;
+	lpNew->dwFlags							= dwFlags;
+	lpNew->bKey								= 0;
+	lpNew->lpLiteral						= NULL;
+	lpNew->dwAux							= 0;
+	lpNew->dwDepth							= 0;
+	lpNew->dwStackSize						= CJSON_TRANSCODER_INITIALSTACK;
+	lpNew->dwDocuments						= 0;
+	lpNew->lpSystem							= lpSystem;
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonTranscoder_ProcessByte(
+	struct cjsonTranscoder* lpTranscoder,
+	char bByte
+) {
+	if(lpTranscoder == NULL) { return cjsonE_InvalidParam; }
+	return cjsonTranscoder_ProcessBytes(lpTranscoder, &bByte, 1);
+}
+enum cjsonError cjsonTranscoder_ProcessBytes(
+	struct cjsonTranscoder* lpTranscoder,
+	const char* lpData,
+	unsigned long int dwDataLength
+) {
+	enum cjsonError e;
+	unsigned long int dwPos = 0;
+	unsigned long int dwRun;
+
+	if(lpTranscoder == NULL) { return cjsonE_InvalidParam; }
+	if((lpData == NULL) && (dwDataLength > 0)) { return cjsonE_InvalidParam; }
+	if(lpTranscoder->eStatus != cjsonE_Ok) { return lpTranscoder->eStatus; }
+
+	while(dwPos < dwDataLength) {
+		/*
+			Runs of plain string characters and digits are copied as a whole,
+			whitespace between tokens is skipped
+		*/
+		dwRun = dwPos;
+		if(lpTranscoder->state == cjsonTranscoder_State__String) {
+			while((dwRun < dwDataLength) && (cjsonTranscoder_IsPlain(lpData[dwRun]) != 0)) { dwRun = dwRun + 1; }
+		} else if((lpTranscoder->state == cjsonTranscoder_State__NumberInt) || (lpTranscoder->state == cjsonTranscoder_State__NumberFrac) || (lpTranscoder->state == cjsonTranscoder_State__NumberExp)) {
+			while((dwRun < dwDataLength) && (cjsonTranscoder_IsDigit(lpData[dwRun]) != 0)) { dwRun = dwRun + 1; }
+		} else if(lpTranscoder->state <= cjsonTranscoder_State__CommaOrClose) {
+			while((dwRun < dwDataLength) && (cjsonTranscoder_IsWhitespace(lpData[dwRun]) != 0)) { dwRun = dwRun + 1; }
+			dwPos = dwRun;
+		}
+		if(dwRun != dwPos) {
+			cjsonWriter_Raw(&(lpTranscoder->writer), &(lpData[dwPos]), dwRun - dwPos);
+			dwPos = dwRun;
+			continue;
+		}
+		if(dwPos == dwDataLength) { break; }
+
+		e = cjsonTranscoder_Step(lpTranscoder, lpData[dwPos]);
+		if(e == cjsonE_OkRedeliver) { continue; }
+		if(e != cjsonE_Ok) {
+			lpTranscoder->eStatus = e;
+			return e;
+		}
+		dwPos = dwPos + 1;
+	}
+
+	/* Writer errors are sticky, checking once per call is sufficient */
+	return lpTranscoder->writer.eStatus;
+}
+enum cjsonError cjsonTranscoder_Finish(
+	struct cjsonTranscoder* lpTranscoder
+) {
+	if(lpTranscoder == NULL) { return cjsonE_InvalidParam; }
+	if(lpTranscoder->eStatus != cjsonE_Ok) { return lpTranscoder->eStatus; }
+
+	/* A top level number is terminated by the end of input */
+	if(lpTranscoder->dwDepth == 0) {
+		switch(lpTranscoder->state) {
+			case cjsonTranscoder_State__NumberZero:
+			case cjsonTranscoder_State__NumberInt:
+			case cjsonTranscoder_State__NumberFrac:
+			case cjsonTranscoder_State__NumberExp:
+				cjsonTranscoder_ValueDone(lpTranscoder);
+				break;
+			default:
+				break;
+		}
+	}
+
+	if(lpTranscoder->state != cjsonTranscoder_State__Done) {
+		if(((lpTranscoder->dwFlags & CJSON_TRANSCODER_FLAG__STREAMINGMODE) == 0) || (lpTranscoder->state != cjsonTranscoder_State__Value) || (lpTranscoder->dwDepth != 0)) {
+			lpTranscoder->eStatus = cjsonE_EncodingError;
+			return lpTranscoder->eStatus;
+		}
+	}
+
+	return cjsonWriter_Flush(&(lpTranscoder->writer));
+}
+enum cjsonError cjsonTranscoder_Release(
+	struct cjsonTranscoder* lpTranscoder
+) {
+	if(lpTranscoder == NULL) { return cjsonE_InvalidParam; }
+
+	cjsonTranscoder_Free(lpTranscoder->lpSystem, lpTranscoder->lpStack);
+	cjsonTranscoder_Free(lpTranscoder->lpSystem, lpTranscoder);
+	return cjsonE_Ok;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
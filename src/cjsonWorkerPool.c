@@ -0,0 +1,305 @@
+#ifndef _POSIX_C_SOURCE
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../include/cjson.h"
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef CJSON_WORKERPOOL_DEFAULTTHREADS
+	#define CJSON_WORKERPOOL_DEFAULTTHREADS 4
+#endif
+
+/*
+	The worker pool is a fixed set of threads that process
+	jobs from a single FIFO queue. Jobs are owned by the
+	submitter which has to wait for completion before
+	releasing the job descriptor (detached jobs are owned
+	by the pool and released after they've been run).
+*/
+struct cjsonWorkerPool {
+	struct cjsonSystemAPI*						lpSystem;
+
+	pthread_mutex_t								lock;
+	pthread_cond_t								condWork;		/* Signalled whenever a job has been queued or shutdown is requested */
+	pthread_cond_t								condDone;		/* Broadcasted whenever a job has finished */
+
+	struct {
+		struct cjsonWorkerPool_Job*				lpFirst;
+		struct cjsonWorkerPool_Job*				lpLast;
+	} queue;
+
+	int											bShutdown;
+	unsigned long int							dwThreadCount;
+	pthread_t									threads[];
+};
+
+/*
+	Detached jobs carry their own descriptor
+*/
+struct cjsonWorkerPool_DetachedJob {
+	struct cjsonWorkerPool_Job					base;
+	struct cjsonWorkerPool*						lpPool;
+	cjsonWorkerPool_JobFunction					lpfnJob;
+	void*										lpParam;
+};
+
+static inline enum cjsonError cjsonWorkerPool_MallocHelper(
+	struct cjsonSystemAPI* lpSystem,
+	unsigned long int dwSize,
+	void** lpOut
+) {
+	if(lpSystem == NULL) {
+		(*lpOut) = malloc(dwSize);
+		if((*lpOut) == NULL) { return cjsonE_OutOfMemory; }
+		return cjsonE_Ok;
+	} else {
+		return lpSystem->alloc(lpSystem, dwSize, lpOut);
+	}
+}
+static inline void cjsonWorkerPool_FreeHelper(
+	struct cjsonSystemAPI* lpSystem,
+	void* lpBlock
+) {
+	if(lpSystem == NULL) {
+		free(lpBlock);
+	} else {
+		lpSystem->free(lpSystem, lpBlock);
+	}
+}
+
+static void* cjsonWorkerPool_ThreadMain(
+	void* lpParam
+) {
+	struct cjsonWorkerPool* lpPool = (struct cjsonWorkerPool*)lpParam;
+	struct cjsonWorkerPool_Job* lpJob;
+	int bDetached;
+
+	pthread_mutex_lock(&(lpPool->lock));
+	for(;;) {
+		while((lpPool->queue.lpFirst == NULL) && (lpPool->bShutdown == 0)) {
+			pthread_cond_wait(&(lpPool->condWork), &(lpPool->lock));
+		}
+		if(lpPool->queue.lpFirst == NULL) {
+			/* Shutdown has been requested and the queue has been drained */
+			break;
+		}
+
+		lpJob = lpPool->queue.lpFirst;
+		lpPool->queue.lpFirst = lpJob->lpNext;
+		if(lpPool->queue.lpFirst == NULL) { lpPool->queue.lpLast = NULL; }
+		lpJob->lpNext = NULL;
+		bDetached = lpJob->bDetached;
+		pthread_mutex_unlock(&(lpPool->lock));
+
+		lpJob->lpfnJob(lpJob->lpParam);
+
+		/*
+			Detached jobs are released by us, nobody waits
+			for them. Other jobs are handed back to the waiter
+		*/
+		if(bDetached != 0) {
+			cjsonWorkerPool_FreeHelper(lpPool->lpSystem, (void*)lpJob);
+			pthread_mutex_lock(&(lpPool->lock));
+		} else {
+			pthread_mutex_lock(&(lpPool->lock));
+			lpJob->bDone = 1;
+			pthread_cond_broadcast(&(lpPool->condDone));
+		}
+	}
+	pthread_mutex_unlock(&(lpPool->lock));
+	return NULL;
+}
+
+enum cjsonError cjsonWorkerPool_Create(
+	struct cjsonWorkerPool** lpOut,
+	unsigned long int dwThreadCount,
+	struct cjsonSystemAPI* lpSystem
+) {
+	enum cjsonError e;
+	struct cjsonWorkerPool* lpNew;
+	unsigned long int i;
+	#ifdef _SC_NPROCESSORS_ONLN
+		long int dwOnline;
+	#endif
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	(*lpOut) = NULL;
+
+	if(dwThreadCount == 0) {
+		/* Use one thread per online processor if we can determine that */
+		dwThreadCount = CJSON_WORKERPOOL_DEFAULTTHREADS;
+		#ifdef _SC_NPROCESSORS_ONLN
+			dwOnline = sysconf(_SC_NPROCESSORS_ONLN);
+			if(dwOnline > 0) { dwThreadCount = (unsigned long int)dwOnline; }
+		#endif
+	}
+
+	e = cjsonWorkerPool_MallocHelper(lpSystem, sizeof(struct cjsonWorkerPool)+sizeof(pthread_t)*dwThreadCount, (void**)(&lpNew));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpNew->lpSystem = lpSystem;
+	lpNew->queue.lpFirst = NULL;
+	lpNew->queue.lpLast = NULL;
+	lpNew->bShutdown = 0;
+	lpNew->dwThreadCount = 0;
+
+	if(pthread_mutex_init(&(lpNew->lock), NULL) != 0) {
+		cjsonWorkerPool_FreeHelper(lpSystem, (void*)lpNew);
+		return cjsonE_OutOfMemory;
+	}
+	if(pthread_cond_init(&(lpNew->condWork), NULL) != 0) {
+		pthread_mutex_destroy(&(lpNew->lock));
+		cjsonWorkerPool_FreeHelper(lpSystem, (void*)lpNew);
+		return cjsonE_OutOfMemory;
+	}
+	if(pthread_cond_init(&(lpNew->condDone), NULL) != 0) {
+		pthread_cond_destroy(&(lpNew->condWork));
+		pthread_mutex_destroy(&(lpNew->lock));
+		cjsonWorkerPool_FreeHelper(lpSystem, (void*)lpNew);
+		return cjsonE_OutOfMemory;
+	}
+
+	for(i = 0; i < dwThreadCount; i=i+1) {
+		if(pthread_create(&(lpNew->threads[i]), NULL, &cjsonWorkerPool_ThreadMain, (void*)lpNew) != 0) {
+			/* Shutdown the threads we've already started */
+			cjsonWorkerPool_Release(lpNew);
+			return cjsonE_OutOfMemory;
+		}
+		lpNew->dwThreadCount = lpNew->dwThreadCount + 1;
+	}
+
+	(*lpOut) = lpNew;
+	return cjsonE_Ok;
+}
+unsigned long int cjsonWorkerPool_ThreadCount(
+	const struct cjsonWorkerPool* lpPool
+) {
+	if(lpPool == NULL) { return 0; }
+	return lpPool->dwThreadCount;
+}
+enum cjsonError cjsonWorkerPool_Submit(
+	struct cjsonWorkerPool* lpPool,
+	struct cjsonWorkerPool_Job* lpJob
+) {
+	if(lpPool == NULL) { return cjsonE_InvalidParam; }
+	if(lpJob == NULL) { return cjsonE_InvalidParam; }
+	if(lpJob->lpfnJob == NULL) { return cjsonE_InvalidParam; }
+
+	lpJob->lpNext = NULL;
+	lpJob->bDone = 0;
+	lpJob->bDetached = 0;
+
+	pthread_mutex_lock(&(lpPool->lock));
+	if(lpPool->bShutdown != 0) {
+		pthread_mutex_unlock(&(lpPool->lock));
+		return cjsonE_InvalidState;
+	}
+	if(lpPool->queue.lpLast == NULL) {
+		lpPool->queue.lpFirst = lpJob;
+	} else {
+		lpPool->queue.lpLast->lpNext = lpJob;
+	}
+	lpPool->queue.lpLast = lpJob;
+	pthread_cond_signal(&(lpPool->condWork));
+	pthread_mutex_unlock(&(lpPool->lock));
+
+	return cjsonE_Ok;
+}
+static void cjsonWorkerPool_DetachedTrampoline(
+	void* lpParam
+) {
+	struct cjsonWorkerPool_DetachedJob* lpJob = (struct cjsonWorkerPool_DetachedJob*)lpParam;
+	lpJob->lpfnJob(lpJob->lpParam);
+}
+enum cjsonError cjsonWorkerPool_SubmitDetached(
+	struct cjsonWorkerPool* lpPool,
+	cjsonWorkerPool_JobFunction lpfnJob,
+	void* lpParam
+) {
+	enum cjsonError e;
+	struct cjsonWorkerPool_DetachedJob* lpJob;
+
+	if(lpPool == NULL) { return cjsonE_InvalidParam; }
+	if(lpfnJob == NULL) { return cjsonE_InvalidParam; }
+
+	e = cjsonWorkerPool_MallocHelper(lpPool->lpSystem, sizeof(struct cjsonWorkerPool_DetachedJob), (void**)(&lpJob));
+	if(e != cjsonE_Ok) { return e; }
+
+	lpJob->base.lpNext = NULL;
+	lpJob->base.lpfnJob = &cjsonWorkerPool_DetachedTrampoline;
+	lpJob->base.lpParam = (void*)lpJob;
+	lpJob->base.bDone = 0;
+	lpJob->base.bDetached = 1;
+	lpJob->lpPool = lpPool;
+	lpJob->lpfnJob = lpfnJob;
+	lpJob->lpParam = lpParam;
+
+	pthread_mutex_lock(&(lpPool->lock));
+	if(lpPool->bShutdown != 0) {
+		pthread_mutex_unlock(&(lpPool->lock));
+		cjsonWorkerPool_FreeHelper(lpPool->lpSystem, (void*)lpJob);
+		return cjsonE_InvalidState;
+	}
+	if(lpPool->queue.lpLast == NULL) {
+		lpPool->queue.lpFirst = &(lpJob->base);
+	} else {
+		lpPool->queue.lpLast->lpNext = &(lpJob->base);
+	}
+	lpPool->queue.lpLast = &(lpJob->base);
+	pthread_cond_signal(&(lpPool->condWork));
+	pthread_mutex_unlock(&(lpPool->lock));
+
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonWorkerPool_Wait(
+	struct cjsonWorkerPool* lpPool,
+	struct cjsonWorkerPool_Job* lpJob
+) {
+	if(lpPool == NULL) { return cjsonE_InvalidParam; }
+	if(lpJob == NULL) { return cjsonE_InvalidParam; }
+
+	pthread_mutex_lock(&(lpPool->lock));
+	while(lpJob->bDone == 0) {
+		pthread_cond_wait(&(lpPool->condDone), &(lpPool->lock));
+	}
+	pthread_mutex_unlock(&(lpPool->lock));
+
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonWorkerPool_Release(
+	struct cjsonWorkerPool* lpPool
+) {
+	unsigned long int i;
+
+	if(lpPool == NULL) { return cjsonE_Ok; }
+
+	/*
+		Request shutdown. The workers drain the queue before
+		they exit so no submitted job gets lost
+	*/
+	pthread_mutex_lock(&(lpPool->lock));
+	lpPool->bShutdown = 1;
+	pthread_cond_broadcast(&(lpPool->condWork));
+	pthread_mutex_unlock(&(lpPool->lock));
+
+	for(i = 0; i < lpPool->dwThreadCount; i=i+1) {
+		pthread_join(lpPool->threads[i], NULL);
+	}
+
+	pthread_cond_destroy(&(lpPool->condDone));
+	pthread_cond_destroy(&(lpPool->condWork));
+	pthread_mutex_destroy(&(lpPool->lock));
+
+	cjsonWorkerPool_FreeHelper(lpPool->lpSystem, (void*)lpPool);
+	return cjsonE_Ok;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
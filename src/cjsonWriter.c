@@ -0,0 +1,161 @@
+#include "../include/cjson.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+static const char cjsonWriter_HexDigits[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+
+static enum cjsonError cjsonWriter_WriteAll(
+	struct cjsonWriter* lpWriter,
+	const char* lpData,
+	unsigned long int dwLength
+) {
+	enum cjsonError e;
+	unsigned long int dwWritten;
+
+	while(dwLength > 0) {
+		dwWritten = 0;
+		e = lpWriter->callback((char*)lpData, dwLength, &dwWritten, lpWriter->callbackFreeParam);
+		if(e != cjsonE_Ok) { return e; }
+		if((dwWritten == 0) || (dwWritten > dwLength)) { return cjsonE_ImplementationError; }
+		lpData = lpData + dwWritten;
+		dwLength = dwLength - dwWritten;
+	}
+	return cjsonE_Ok;
+}
+
+void cjsonWriter_Init(
+	struct cjsonWriter* lpWriter,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam
+) {
+	lpWriter->callback = callback;
+	lpWriter->callbackFreeParam = callbackFreeParam;
+	lpWriter->eStatus = (callback == NULL) ? cjsonE_InvalidParam : cjsonE_Ok;
+	lpWriter->dwBufferUsed = 0;
+}
+enum cjsonError cjsonWriter_Flush(
+	struct cjsonWriter* lpWriter
+) {
+	if(lpWriter->eStatus != cjsonE_Ok) { return lpWriter->eStatus; }
+
+	lpWriter->eStatus = cjsonWriter_WriteAll(lpWriter, lpWriter->bBuffer, lpWriter->dwBufferUsed);
+	lpWriter->dwBufferUsed = 0;
+	return lpWriter->eStatus;
+}
+enum cjsonError cjsonWriter_Raw(
+	struct cjsonWriter* lpWriter,
+	const char* lpData,
+	unsigned long int dwLength
+) {
+	if(lpWriter->eStatus != cjsonE_Ok) { return lpWriter->eStatus; }
+
+	if(dwLength > CJSON_WRITER_BUFFERSIZE - lpWriter->dwBufferUsed) {
+		if(cjsonWriter_Flush(lpWriter) != cjsonE_Ok) { return lpWriter->eStatus; }
+		if(dwLength >= CJSON_WRITER_BUFFERSIZE) {
+			lpWriter->eStatus = cjsonWriter_WriteAll(lpWriter, lpData, dwLength);
+			return lpWriter->eStatus;
+		}
+	}
+	memcpy(&(lpWriter->bBuffer[lpWriter->dwBufferUsed]), lpData, dwLength);
+	lpWriter->dwBufferUsed = lpWriter->dwBufferUsed + dwLength;
+	return cjsonE_Ok;
+}
+enum cjsonError cjsonWriter_String(
+	struct cjsonWriter* lpWriter,
+	const char* lpData,
+	unsigned long int dwLength
+) {
+	unsigned long int dwRun = 0;
+	unsigned long int i;
+	unsigned char bByte;
+	char bEscape[6];
+
+	cjsonWriter_Raw(lpWriter, "\"", 1);
+	for(i = 0; i < dwLength; i=i+1) {
+		bByte = (unsigned char)lpData[i];
+		if((bByte >= 0x20) && (bByte != '"') && (bByte != '\\')) { continue; }
+
+		/* Pass the run of plain characters, then the escape sequence */
+		cjsonWriter_Raw(lpWriter, &(lpData[dwRun]), i - dwRun);
+		dwRun = i + 1;
+
+		bEscape[0] = '\\';
+		switch(bByte) {
+			case '"':	bEscape[1] = '"'; cjsonWriter_Raw(lpWriter, bEscape, 2); break;
+			case '\\':	bEscape[1] = '\\'; cjsonWriter_Raw(lpWriter, bEscape, 2); break;
+			case '\b':	bEscape[1] = 'b'; cjsonWriter_Raw(lpWriter, bEscape, 2); break;
+			case '\f':	bEscape[1] = 'f'; cjsonWriter_Raw(lpWriter, bEscape, 2); break;
+			case '\n':	bEscape[1] = 'n'; cjsonWriter_Raw(lpWriter, bEscape, 2); break;
+			case '\r':	bEscape[1] = 'r'; cjsonWriter_Raw(lpWriter, bEscape, 2); break;
+			case '\t':	bEscape[1] = 't'; cjsonWriter_Raw(lpWriter, bEscape, 2); break;
+			default:
+				bEscape[1] = 'u';
+				bEscape[2] = '0';
+				bEscape[3] = '0';
+				bEscape[4] = cjsonWriter_HexDigits[bByte >> 4];
+				bEscape[5] = cjsonWriter_HexDigits[bByte & 0x0F];
+				cjsonWriter_Raw(lpWriter, bEscape, 6);
+				break;
+		}
+	}
+	cjsonWriter_Raw(lpWriter, &(lpData[dwRun]), dwLength - dwRun);
+	return cjsonWriter_Raw(lpWriter, "\"", 1);
+}
+enum cjsonError cjsonWriter_ULong(
+	struct cjsonWriter* lpWriter,
+	unsigned long int dwValue
+) {
+	char bDigits[24];
+	unsigned long int dwPos = sizeof(bDigits);
+
+	do {
+		dwPos = dwPos - 1;
+		bDigits[dwPos] = (char)('0' + (dwValue % 10));
+		dwValue = dwValue / 10;
+	} while(dwValue != 0);
+	return cjsonWriter_Raw(lpWriter, &(bDigits[dwPos]), sizeof(bDigits) - dwPos);
+}
+enum cjsonError cjsonWriter_SLong(
+	struct cjsonWriter* lpWriter,
+	signed long int iValue
+) {
+	if(iValue >= 0) { return cjsonWriter_ULong(lpWriter, (unsigned long int)iValue); }
+
+	cjsonWriter_Raw(lpWriter, "-", 1);
+	return cjsonWriter_ULong(lpWriter, 0UL - (unsigned long int)iValue);
+}
+enum cjsonError cjsonWriter_Double(
+	struct cjsonWriter* lpWriter,
+	double dValue
+) {
+	char bNumber[32];
+	int iLength;
+
+	/* NaN and infinities have no JSON representation */
+	if((dValue != dValue) || ((dValue - dValue) != 0)) { return cjsonWriter_Raw(lpWriter, "null", 4); }
+
+	iLength = snprintf(bNumber, sizeof(bNumber), "%.15g", dValue);
+	if((iLength > 0) && (strtod(bNumber, NULL) != dValue)) {
+		iLength = snprintf(bNumber, sizeof(bNumber), "%.17g", dValue);
+	}
+	if((iLength <= 0) || (iLength >= (int)sizeof(bNumber))) {
+		lpWriter->eStatus = cjsonE_ImplementationError;
+		return lpWriter->eStatus;
+	}
+	return cjsonWriter_Raw(lpWriter, bNumber, (unsigned long int)iLength);
+}
+enum cjsonError cjsonWriter_Bool(
+	struct cjsonWriter* lpWriter,
+	int bValue
+) {
+	return (bValue != 0) ? cjsonWriter_Raw(lpWriter, "true", 4) : cjsonWriter_Raw(lpWriter, "false", 5);
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+struct outputBuffer {
+	char*					lpData;
+	unsigned long int		dwUsed;
+	unsigned long int		dwSize;
+	unsigned long int		dwMaxPerCall;	/* Simulates partial writes if not 0 */
+};
+
+static enum cjsonError outputWriterRoutine(
+	char*											lpData,
+	unsigned long int								dwBytesToWrite,
+	unsigned long int								*lpBytesWrittenOut,
+
+	void*											lpFreeParam
+) {
+	struct outputBuffer* lpOut = (struct outputBuffer*)lpFreeParam;
+	char* lpNew;
+
+	(*lpBytesWrittenOut) = 0;
+	if((lpOut->dwMaxPerCall != 0) && (dwBytesToWrite > lpOut->dwMaxPerCall)) { dwBytesToWrite = lpOut->dwMaxPerCall; }
+
+	if(lpOut->dwUsed + dwBytesToWrite > lpOut->dwSize) {
+		lpNew = realloc(lpOut->lpData, (lpOut->dwUsed + dwBytesToWrite) * 2);
+		if(lpNew == NULL) { return cjsonE_OutOfMemory; }
+		lpOut->lpData = lpNew;
+		lpOut->dwSize = (lpOut->dwUsed + dwBytesToWrite) * 2;
+	}
+	memcpy(&(lpOut->lpData[lpOut->dwUsed]), lpData, dwBytesToWrite);
+	lpOut->dwUsed = lpOut->dwUsed + dwBytesToWrite;
+	(*lpBytesWrittenOut) = dwBytesToWrite;
+
+	return cjsonE_Ok;
+}
+
+static struct cjsonValue* buildRecord(unsigned long int dwIndex) {
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpValue;
+	char bKey[32];
+
+	cjsonObject_Create(&lpRecord, NULL);
+
+	cjsonNumber_Create(&lpValue, NULL);
+	cjsonNumber_SetULong(lpValue, dwIndex);
+	cjsonObject_Set(lpRecord, "id", 2, lpValue);
+
+	sprintf(bKey, "name %lu \"quoted\"", dwIndex);
+	cjsonString_Create(&lpValue, bKey, strlen(bKey), NULL);
+	cjsonObject_Set(lpRecord, "name", 4, lpValue);
+
+	if((dwIndex % 2) == 0) { cjsonTrue_Create(&lpValue, NULL); } else { cjsonNull_Create(&lpValue, NULL); }
+	cjsonObject_Set(lpRecord, "flag", 4, lpValue);
+
+	cjsonArray_Create(&lpValue, NULL);
+	cjsonObject_Set(lpRecord, "empty", 5, lpValue);
+
+	return lpRecord;
+}
+
+static struct cjsonValue* buildDocument(unsigned long int dwElements) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpArray;
+	struct cjsonValue* lpObject;
+	unsigned long int i;
+	char bKey[32];
+
+	cjsonObject_Create(&lpRoot, NULL);
+
+	cjsonArray_Create(&lpArray, NULL);
+	for(i = 0; i < dwElements; i=i+1) {
+		cjsonArray_Push(lpArray, buildRecord(i));
+	}
+	cjsonObject_Set(lpRoot, "records", 7, lpArray);
+
+	cjsonObject_Create(&lpObject, NULL);
+	for(i = 0; i < dwElements; i=i+1) {
+		sprintf(bKey, "key%lu", i);
+		cjsonObject_Set(lpObject, bKey, strlen(bKey), buildRecord(i));
+	}
+	cjsonObject_Set(lpRoot, "index", 5, lpObject);
+
+	return lpRoot;
+}
+
+static int serializeInto(struct cjsonValue* lpValue, uint32_t dwFlags, struct cjsonWorkerPool* lpPool, struct outputBuffer* lpOut) {
+	struct cjsonSerializer* lpSerializer;
+	enum cjsonError e;
+
+	e = cjsonSerializer_Create(&lpSerializer, &outputWriterRoutine, (void*)lpOut, dwFlags, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create serializer (code %u)\n", __FILE__, __LINE__, e); return 0; }
+
+	e = cjsonSerializer_SetWorkerPool(lpSerializer, lpPool);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to attach worker pool (code %u)\n", __FILE__, __LINE__, e); cjsonSerializer_Release(lpSerializer); return 0; }
+
+	e = cjsonSerializer_Serialize(lpSerializer, lpValue);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to serialize (code %u)\n", __FILE__, __LINE__, e); cjsonSerializer_Release(lpSerializer); return 0; }
+
+	cjsonSerializer_Release(lpSerializer);
+	return 1;
+}
+
+static int runCompareTest(struct cjsonValue* lpDocument, uint32_t dwFlags, struct cjsonWorkerPool* lpPool, unsigned long int dwMaxPerCall) {
+	struct outputBuffer seq;
+	struct outputBuffer par;
+	int bResult;
+
+	memset(&seq, 0, sizeof(seq));
+	memset(&par, 0, sizeof(par));
+	par.dwMaxPerCall = dwMaxPerCall;
+
+	bResult = serializeInto(lpDocument, dwFlags, NULL, &seq) && serializeInto(lpDocument, dwFlags, lpPool, &par);
+	if(bResult) {
+		if((seq.dwUsed != par.dwUsed) || (memcmp(seq.lpData, par.lpData, seq.dwUsed) != 0)) {
+			printf("%s:%u Output differs (flags %u, sequential %lu bytes, parallel %lu bytes)\n", __FILE__, __LINE__, dwFlags, seq.dwUsed, par.dwUsed);
+			bResult = 0;
+		} else {
+			printf("%s:%u Output identical (flags %u, %lu bytes)\n", __FILE__, __LINE__, dwFlags, seq.dwUsed);
+		}
+	}
+
+	free(seq.lpData);
+	free(par.lpData);
+	return bResult;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonWorkerPool* lpPool;
+	struct cjsonValue* lpDocument;
+	int bOk;
+
+	e = cjsonWorkerPool_Create(&lpPool, 4, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create worker pool (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	lpDocument = buildDocument(20000);
+
+	bOk = 1;
+	bOk = runCompareTest(lpDocument, 0, lpPool, 0) && bOk;
+	bOk = runCompareTest(lpDocument, CJSON_SERIALIZER__FLAG__PRETTYPRINT, lpPool, 0) && bOk;
+	bOk = runCompareTest(lpDocument, CJSON_SERIALIZER__FLAG__PRETTYPRINT, lpPool, 7) && bOk;
+
+	cjsonReleaseValue(lpDocument);
+	cjsonWorkerPool_Release(lpPool);
+
+	if(bOk) {
+		printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+		return 0;
+	} else {
+		printf("%s:%u Failed\n", __FILE__, __LINE__);
+		return 1;
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
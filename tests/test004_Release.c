@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/*
+	Builds a chain of nested containers (alternating arrays
+	and objects) that would overflow the C stack when
+	released recursively
+*/
+static struct cjsonValue* buildDeepDocument(unsigned long int dwDepth, struct cjsonSystemAPI* lpSystem) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpCur;
+	struct cjsonValue* lpNext;
+	struct cjsonValue* lpLeaf;
+	unsigned long int i;
+
+	cjsonArray_Create(&lpRoot, lpSystem);
+	lpCur = lpRoot;
+	for(i = 0; i < dwDepth; i=i+1) {
+		if((i % 2) == 0) { cjsonObject_Create(&lpNext, lpSystem); } else { cjsonArray_Create(&lpNext, lpSystem); }
+
+		cjsonString_Create(&lpLeaf, "leaf", 4, lpSystem);
+		if(lpCur->type == cjsonArray) {
+			cjsonArray_Push(lpCur, lpLeaf);
+			cjsonArray_Push(lpCur, lpNext);
+		} else {
+			cjsonObject_Set(lpCur, "leaf", 4, lpLeaf);
+			cjsonObject_Set(lpCur, "next", 4, lpNext);
+		}
+		lpCur = lpNext;
+	}
+	return lpRoot;
+}
+
+static struct cjsonValue* buildWideDocument(unsigned long int dwWidth) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpValue;
+	unsigned long int i;
+
+	cjsonArray_Create(&lpRoot, NULL);
+	for(i = 0; i < dwWidth; i=i+1) {
+		cjsonObject_Create(&lpRecord, NULL);
+		cjsonNumber_Create(&lpValue, NULL);
+		cjsonNumber_SetULong(lpValue, i);
+		cjsonObject_Set(lpRecord, "id", 2, lpValue);
+		cjsonArray_Create(&lpValue, NULL);
+		cjsonObject_Set(lpRecord, "tags", 4, lpValue);
+		cjsonArray_Push(lpRoot, lpRecord);
+	}
+	return lpRoot;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonWorkerPool* lpReclaimer;
+	struct cjsonProfiler* lpProfiler;
+	struct cjsonProfiler_Stats stats;
+	struct cjsonValue* lpDocument;
+	struct cjsonArena* lpArena;
+	unsigned long int dwBytesUsed;
+	uint64_t qwScratch;
+
+	printf("%s:%u Releasing deeply nested document\n", __FILE__, __LINE__);
+	cjsonReleaseValue(buildDeepDocument(200000, NULL));
+
+	/* Additional stack segments come from the system API of the released values */
+	printf("%s:%u Releasing deeply nested document with a system API\n", __FILE__, __LINE__);
+	e = cjsonProfiler_Create(&lpProfiler, 1, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create profiler (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	lpDocument = buildDeepDocument(10000, cjsonProfiler_System(lpProfiler));
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	qwScratch = stats.sites[cjsonAllocSite__Other].qwAllocations;
+	cjsonReleaseValue(lpDocument);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.sites[cjsonAllocSite__Other].qwAllocations == qwScratch) { printf("%s:%u Stack segments bypassed the system API\n", __FILE__, __LINE__); return 1; }
+	if(stats.qwLiveBytes != 0) { printf("%s:%u %lu bytes still allocated after release\n", __FILE__, __LINE__, (unsigned long int)stats.qwLiveBytes); return 1; }
+	cjsonProfiler_Release(lpProfiler);
+
+	/* Arenas never return single blocks, releasing must not consume arena memory */
+	printf("%s:%u Releasing deeply nested document inside an arena\n", __FILE__, __LINE__);
+	e = cjsonArena_Create(&lpArena, 65536, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create arena (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	lpDocument = buildDeepDocument(10000, cjsonArena_System(lpArena));
+	dwBytesUsed = cjsonArena_BytesUsed(lpArena);
+	cjsonReleaseValue(lpDocument);
+	if(cjsonArena_BytesUsed(lpArena) != dwBytesUsed) { printf("%s:%u Stack segments have been allocated from the arena\n", __FILE__, __LINE__); return 1; }
+	cjsonArena_Release(lpArena);
+
+	printf("%s:%u Releasing wide document\n", __FILE__, __LINE__);
+	cjsonReleaseValue(buildWideDocument(100000));
+
+	printf("%s:%u Releasing documents asynchronously\n", __FILE__, __LINE__);
+	e = cjsonWorkerPool_Create(&lpReclaimer, 1, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create reclaimer (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	e = cjsonReleaseValueAsync(buildDeepDocument(100000, NULL), lpReclaimer);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to queue release (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = cjsonReleaseValueAsync(buildWideDocument(100000), lpReclaimer);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to queue release (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	/* Releasing the pool drains all queued releases */
+	cjsonWorkerPool_Release(lpReclaimer);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,234 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+static struct cjsonValue* buildDocument(unsigned long int dwElements) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpArray;
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpValue;
+	unsigned long int i;
+	char bKey[32];
+
+	cjsonObject_Create(&lpRoot, NULL);
+	cjsonArray_Create(&lpArray, NULL);
+	for(i = 0; i < dwElements; i=i+1) {
+		cjsonObject_Create(&lpRecord, NULL);
+
+		cjsonNumber_Create(&lpValue, NULL);
+		cjsonNumber_SetULong(lpValue, i);
+		cjsonObject_Set(lpRecord, "id", 2, lpValue);
+
+		cjsonNumber_Create(&lpValue, NULL);
+		cjsonNumber_SetSLong(lpValue, -((signed long int)i));
+		cjsonObject_Set(lpRecord, "neg", 3, lpValue);
+
+		cjsonNumber_Create(&lpValue, NULL);
+		cjsonNumber_SetDouble(lpValue, (double)i / 4.0);
+		cjsonObject_Set(lpRecord, "quarter", 7, lpValue);
+
+		sprintf(bKey, "record %lu", i);
+		cjsonString_Create(&lpValue, bKey, strlen(bKey), NULL);
+		cjsonObject_Set(lpRecord, "name", 4, lpValue);
+
+		if((i % 3) == 0) { cjsonTrue_Create(&lpValue, NULL); } else if((i % 3) == 1) { cjsonFalse_Create(&lpValue, NULL); } else { cjsonNull_Create(&lpValue, NULL); }
+		cjsonObject_Set(lpRecord, "flag", 4, lpValue);
+
+		cjsonArray_Create(&lpValue, NULL);
+		cjsonObject_Set(lpRecord, "empty", 5, lpValue);
+
+		cjsonArray_Push(lpArray, lpRecord);
+	}
+	cjsonObject_Set(lpRoot, "records", 7, lpArray);
+
+	cjsonObject_Create(&lpValue, NULL);
+	cjsonObject_Set(lpRoot, "emptyObject", 11, lpValue);
+
+	return lpRoot;
+}
+
+/*
+	Structural comparison (the clone may use a different
+	bucket count, so iteration order of objects differs)
+*/
+struct compareContext {
+	const struct cjsonValue* lpOther;
+	int bEqual;
+};
+static int compareValues(const struct cjsonValue* lpA, const struct cjsonValue* lpB);
+
+static enum cjsonError compareObjectEntry(char* lpKey, unsigned long int dwKeyLength, struct cjsonValue* lpValue, void* lpFreeParam) {
+	struct compareContext* lpCtx = (struct compareContext*)lpFreeParam;
+	struct cjsonValue* lpOtherValue;
+
+	if(cjsonObject_Get(lpCtx->lpOther, lpKey, dwKeyLength, &lpOtherValue) != cjsonE_Ok) { lpCtx->bEqual = 0; return cjsonE_Finished; }
+	if(compareValues(lpValue, lpOtherValue) == 0) { lpCtx->bEqual = 0; return cjsonE_Finished; }
+	return cjsonE_Ok;
+}
+static int compareValues(const struct cjsonValue* lpA, const struct cjsonValue* lpB) {
+	struct compareContext ctx;
+	struct cjsonValue* lpEntryA;
+	struct cjsonValue* lpEntryB;
+	unsigned long int i;
+
+	if((lpA == NULL) || (lpB == NULL)) { return (lpA == lpB) ? 1 : 0; }
+	if(lpA == lpB) { return 0; } /* A clone never shares nodes */
+	if(lpA->type != lpB->type) { return 0; }
+
+	switch(lpA->type) {
+		case cjsonString:
+			if(((struct cjsonString*)lpA)->dwStrlen != ((struct cjsonString*)lpB)->dwStrlen) { return 0; }
+			return (memcmp(((struct cjsonString*)lpA)->bData, ((struct cjsonString*)lpB)->bData, ((struct cjsonString*)lpA)->dwStrlen) == 0) ? 1 : 0;
+		case cjsonNumber_UnsignedLong:	return (((struct cjsonNumber*)lpA)->value.ulong == ((struct cjsonNumber*)lpB)->value.ulong) ? 1 : 0;
+		case cjsonNumber_SignedLong:	return (((struct cjsonNumber*)lpA)->value.slong == ((struct cjsonNumber*)lpB)->value.slong) ? 1 : 0;
+		case cjsonNumber_Double:		return (((struct cjsonNumber*)lpA)->value.dbl == ((struct cjsonNumber*)lpB)->value.dbl) ? 1 : 0;
+		case cjsonArray:
+			if(cjsonArray_Length(lpA) != cjsonArray_Length(lpB)) { return 0; }
+			for(i = 0; i < cjsonArray_Length(lpA); i=i+1) {
+				cjsonArray_Get(lpA, i, &lpEntryA);
+				cjsonArray_Get(lpB, i, &lpEntryB);
+				if(compareValues(lpEntryA, lpEntryB) == 0) { return 0; }
+			}
+			return 1;
+		case cjsonObject:
+			if(((struct cjsonObject*)lpA)->dwElementCount != ((struct cjsonObject*)lpB)->dwElementCount) { return 0; }
+			ctx.lpOther = lpB;
+			ctx.bEqual = 1;
+			cjsonObject_Iterate(lpA, &compareObjectEntry, (void*)&ctx);
+			return ctx.bEqual;
+		default:
+			return 1;
+	}
+}
+
+static struct cjsonValue* buildDeepDocument(unsigned long int dwDepth) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpCur;
+	struct cjsonValue* lpNext;
+	unsigned long int i;
+
+	cjsonArray_Create(&lpRoot, NULL);
+	lpCur = lpRoot;
+	for(i = 0; i < dwDepth; i=i+1) {
+		if((i % 2) == 0) { cjsonObject_Create(&lpNext, NULL); } else { cjsonArray_Create(&lpNext, NULL); }
+		if(lpCur->type == cjsonArray) { cjsonArray_Push(lpCur, lpNext); } else { cjsonObject_Set(lpCur, "next", 4, lpNext); }
+		lpCur = lpNext;
+	}
+	return lpRoot;
+}
+static unsigned long int measureDepth(struct cjsonValue* lpValue) {
+	unsigned long int dwDepth = 0;
+	struct cjsonValue* lpNext;
+
+	for(;;) {
+		if(lpValue->type == cjsonArray) {
+			if(cjsonArray_Get(lpValue, 0, &lpNext) != cjsonE_Ok) { return dwDepth; }
+		} else {
+			if(cjsonObject_Get(lpValue, "next", 4, &lpNext) != cjsonE_Ok) { return dwDepth; }
+		}
+		lpValue = lpNext;
+		dwDepth = dwDepth + 1;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonValue* lpDocument;
+	struct cjsonValue* lpHeapClone;
+	struct cjsonValue* lpArenaClone;
+	struct cjsonArena* lpArena;
+	struct cjsonProfiler* lpProfiler;
+	struct cjsonProfiler_Stats stats;
+	struct cjsonValue* lpValue;
+	const struct cjsonArray_Page* lpPage;
+	unsigned long int dwBytesUsed;
+	unsigned long int dwPages;
+	unsigned long int i;
+
+	lpDocument = buildDocument(5000);
+
+	printf("%s:%u Cloning into heap\n", __FILE__, __LINE__);
+	e = cjsonValue_Clone(lpDocument, NULL, &lpHeapClone);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to clone (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(compareValues(lpDocument, lpHeapClone) == 0) { printf("%s:%u Heap clone differs\n", __FILE__, __LINE__); return 1; }
+
+	printf("%s:%u Cloning into arena\n", __FILE__, __LINE__);
+	e = cjsonArena_Create(&lpArena, 4096, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create arena (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	e = cjsonValue_Clone(lpDocument, cjsonArena_System(lpArena), &lpArenaClone);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to clone (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(compareValues(lpDocument, lpArenaClone) == 0) { printf("%s:%u Arena clone differs\n", __FILE__, __LINE__); return 1; }
+
+	/* The whole copy has been served from the reserved block, releasing does not free anything */
+	dwBytesUsed = cjsonArena_BytesUsed(lpArena);
+	printf("%s:%u Arena clone uses %lu bytes\n", __FILE__, __LINE__, dwBytesUsed);
+	cjsonReleaseValue(lpArenaClone);
+
+	/* Copies have to be independent of the source */
+	cjsonReleaseValue(lpDocument);
+	lpDocument = NULL;
+	e = cjsonValue_Clone(lpHeapClone, NULL, &lpDocument);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to clone (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(compareValues(lpDocument, lpHeapClone) == 0) { printf("%s:%u Clone of clone differs\n", __FILE__, __LINE__); return 1; }
+	cjsonReleaseValue(lpDocument);
+	cjsonReleaseValue(lpHeapClone);
+
+	/* The size of the source only sizes the first page of a cloned array, later pages use the default size */
+	printf("%s:%u Growing a cloned single element array\n", __FILE__, __LINE__);
+	cjsonArray_Create(&lpDocument, NULL);
+	cjsonNull_Create(&lpValue, NULL);
+	cjsonArray_Push(lpDocument, lpValue);
+	e = cjsonValue_Clone(lpDocument, NULL, &lpHeapClone);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to clone (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < 1000; i=i+1) {
+		cjsonNull_Create(&lpValue, NULL);
+		e = cjsonArray_Push(lpHeapClone, lpValue);
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to push (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	}
+	dwPages = 0;
+	for(lpPage = ((struct cjsonArray*)lpHeapClone)->pageList.lpFirstPage; lpPage != NULL; lpPage = lpPage->pageList.lpNext) { dwPages = dwPages + 1; }
+	if(((struct cjsonArray*)lpHeapClone)->pageList.lpFirstPage->dwCapacity != 1) { printf("%s:%u First page is not sized by the source\n", __FILE__, __LINE__); return 1; }
+	if((((struct cjsonArray*)lpHeapClone)->dwPageSize < 2) || (dwPages > 1 + (1000 + ((struct cjsonArray*)lpHeapClone)->dwPageSize - 1) / ((struct cjsonArray*)lpHeapClone)->dwPageSize)) { printf("%s:%u Cloned array grows with %lu pages\n", __FILE__, __LINE__, dwPages); return 1; }
+	cjsonReleaseValue(lpDocument);
+	cjsonReleaseValue(lpHeapClone);
+
+	printf("%s:%u Cloning deeply nested document\n", __FILE__, __LINE__);
+	lpDocument = buildDeepDocument(200000);
+	cjsonArena_Reset(lpArena);
+	e = cjsonValue_Clone(lpDocument, cjsonArena_System(lpArena), &lpArenaClone);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to clone (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(measureDepth(lpArenaClone) != 200000) { printf("%s:%u Deep clone has wrong depth\n", __FILE__, __LINE__); return 1; }
+	cjsonReleaseValue(lpDocument);
+
+	/* Additional stack segments come from the target system API, cloning itself never frees */
+	printf("%s:%u Cloning deeply nested document with a system API\n", __FILE__, __LINE__);
+	e = cjsonProfiler_Create(&lpProfiler, 1, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create profiler (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	lpDocument = buildDeepDocument(10000);
+	e = cjsonValue_Clone(lpDocument, cjsonProfiler_System(lpProfiler), &lpHeapClone);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to clone (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.sites[cjsonAllocSite__Other].qwFrees == 0) { printf("%s:%u Stack segments bypassed the system API\n", __FILE__, __LINE__); return 1; }
+	if(measureDepth(lpHeapClone) != 10000) { printf("%s:%u Deep clone has wrong depth\n", __FILE__, __LINE__); return 1; }
+	cjsonReleaseValue(lpHeapClone);
+	cjsonReleaseValue(lpDocument);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.qwLiveBytes != 0) { printf("%s:%u %lu bytes still allocated after release\n", __FILE__, __LINE__, (unsigned long int)stats.qwLiveBytes); return 1; }
+	cjsonProfiler_Release(lpProfiler);
+
+	cjsonArena_Release(lpArena);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define SHARED_DOCUMENTS 1000
+
+static struct cjsonValue* buildFragment(void) {
+	struct cjsonValue* lpFragment;
+	struct cjsonValue* lpLimits;
+	struct cjsonValue* lpValue;
+
+	cjsonObject_Create(&lpFragment, NULL);
+	cjsonObject_Create(&lpLimits, NULL);
+
+	cjsonNumber_Create(&lpValue, NULL);
+	cjsonNumber_SetULong(lpValue, 100);
+	cjsonObject_Set(lpLimits, "requests", 8, lpValue);
+	cjsonObject_Set(lpFragment, "limits", 6, lpLimits);
+
+	cjsonString_Create(&lpValue, "eu-west", 7, NULL);
+	cjsonObject_Set(lpFragment, "region", 6, lpValue);
+
+	return lpFragment;
+}
+static struct cjsonValue* buildDeepFragment(unsigned long int dwDepth, struct cjsonSystemAPI* lpSystem) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpCur;
+	struct cjsonValue* lpNext;
+	unsigned long int i;
+
+	cjsonArray_Create(&lpRoot, lpSystem);
+	lpCur = lpRoot;
+	for(i = 0; i < dwDepth; i=i+1) {
+		cjsonArray_Create(&lpNext, lpSystem);
+		cjsonArray_Push(lpCur, lpNext);
+		lpCur = lpNext;
+	}
+	return lpRoot;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonValue* lpFragment;
+	struct cjsonValue* lpDocuments[SHARED_DOCUMENTS];
+	struct cjsonValue* lpList;
+	struct cjsonValue* lpConfig;
+	struct cjsonValue* lpLimits;
+	struct cjsonValue* lpValue;
+	struct cjsonWorkerPool* lpReclaimer;
+	struct cjsonProfiler* lpProfiler;
+	struct cjsonProfiler_Stats stats;
+	uint64_t qwScratch;
+	unsigned long int i;
+
+	lpFragment = buildFragment();
+
+	printf("%s:%u Sharing fragment between %u documents\n", __FILE__, __LINE__, SHARED_DOCUMENTS);
+	for(i = 0; i < SHARED_DOCUMENTS; i=i+1) {
+		cjsonObject_Create(&(lpDocuments[i]), NULL);
+		e = cjsonObject_SetShared(lpDocuments[i], "config", 6, lpFragment);
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to share fragment (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	}
+	cjsonArray_Create(&lpList, NULL);
+	cjsonArray_PushShared(lpList, lpFragment);
+	cjsonArray_PushShared(lpList, lpFragment);
+
+	if(cjsonValue_RefCount(lpFragment) != SHARED_DOCUMENTS + 3) { printf("%s:%u Unexpected reference count %lu\n", __FILE__, __LINE__, cjsonValue_RefCount(lpFragment)); return 1; }
+
+	/* Releasing a container only drops its references */
+	cjsonReleaseValue(lpList);
+	if(cjsonValue_RefCount(lpFragment) != SHARED_DOCUMENTS + 1) { printf("%s:%u Unexpected reference count %lu\n", __FILE__, __LINE__, cjsonValue_RefCount(lpFragment)); return 1; }
+
+	printf("%s:%u Modifying one document (copy on write)\n", __FILE__, __LINE__);
+	e = cjsonObject_GetMutable(lpDocuments[0], "config", 6, &lpConfig);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to unshare (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(lpConfig == lpFragment) { printf("%s:%u Shared value has not been copied\n", __FILE__, __LINE__); return 1; }
+
+	e = cjsonObject_GetMutable(lpConfig, "limits", 6, &lpLimits);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to unshare (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonNumber_Create(&lpValue, NULL);
+	cjsonNumber_SetULong(lpValue, 5);
+	cjsonObject_Set(lpLimits, "requests", 8, lpValue);
+
+	/* The shared fragment has to be unchanged */
+	cjsonObject_Get(lpFragment, "limits", 6, &lpLimits);
+	cjsonObject_Get(lpLimits, "requests", 8, &lpValue);
+	if(cjsonObject_GetAsULong(lpValue) != 100) { printf("%s:%u Shared fragment has been modified\n", __FILE__, __LINE__); return 1; }
+	if(cjsonValue_RefCount(lpFragment) != SHARED_DOCUMENTS) { printf("%s:%u Unexpected reference count %lu\n", __FILE__, __LINE__, cjsonValue_RefCount(lpFragment)); return 1; }
+
+	/* The unmodified region string is still shared between the copy and the fragment */
+	cjsonObject_Get(lpFragment, "region", 6, &lpValue);
+	if(cjsonValue_RefCount(lpValue) != 2) { printf("%s:%u Unexpected reference count %lu\n", __FILE__, __LINE__, cjsonValue_RefCount(lpValue)); return 1; }
+
+	/* Unsharing an exclusively owned value does nothing */
+	lpValue = lpConfig;
+	cjsonValue_Unshare(&lpValue);
+	if(lpValue != lpConfig) { printf("%s:%u Exclusive value has been copied\n", __FILE__, __LINE__); return 1; }
+
+	printf("%s:%u Releasing documents concurrently\n", __FILE__, __LINE__);
+	e = cjsonWorkerPool_Create(&lpReclaimer, 4, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create reclaimer (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < SHARED_DOCUMENTS; i=i+1) {
+		cjsonReleaseValueAsync(lpDocuments[i], lpReclaimer);
+	}
+	cjsonWorkerPool_Release(lpReclaimer);
+
+	if(cjsonValue_RefCount(lpFragment) != 1) { printf("%s:%u Unexpected reference count %lu\n", __FILE__, __LINE__, cjsonValue_RefCount(lpFragment)); return 1; }
+	cjsonReleaseValue(lpFragment);
+
+	/* Dropping the last reference releases the fragment with stack segments from its system API */
+	printf("%s:%u Releasing deeply nested shared fragment\n", __FILE__, __LINE__);
+	e = cjsonProfiler_Create(&lpProfiler, 1, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create profiler (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	lpFragment = buildDeepFragment(10000, cjsonProfiler_System(lpProfiler));
+	cjsonArray_Create(&lpList, NULL);
+	cjsonArray_PushShared(lpList, lpFragment);
+	cjsonArray_PushShared(lpList, lpFragment);
+	cjsonReleaseValue(lpFragment);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	qwScratch = stats.sites[cjsonAllocSite__Other].qwAllocations;
+	cjsonReleaseValue(lpList);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.sites[cjsonAllocSite__Other].qwAllocations == qwScratch) { printf("%s:%u Stack segments bypassed the system API\n", __FILE__, __LINE__); return 1; }
+	if(stats.qwLiveBytes != 0) { printf("%s:%u %lu bytes still allocated after release\n", __FILE__, __LINE__, (unsigned long int)stats.qwLiveBytes); return 1; }
+	cjsonProfiler_Release(lpProfiler);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
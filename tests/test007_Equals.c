@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define HASH_SEED 0x5eed
+
+static struct cjsonValue* makeULong(unsigned long int v) { struct cjsonValue* lpNew; cjsonNumber_Create(&lpNew, NULL); cjsonNumber_SetULong(lpNew, v); return lpNew; }
+static struct cjsonValue* makeSLong(signed long int v) { struct cjsonValue* lpNew; cjsonNumber_Create(&lpNew, NULL); cjsonNumber_SetSLong(lpNew, v); return lpNew; }
+static struct cjsonValue* makeDouble(double v) { struct cjsonValue* lpNew; cjsonNumber_Create(&lpNew, NULL); cjsonNumber_SetDouble(lpNew, v); return lpNew; }
+
+/*
+	Builds the same logical document with different insertion
+	order, bucket counts and number representations
+*/
+static struct cjsonValue* buildDocument(unsigned long int dwRecords, int bVariant) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpArray;
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpValue;
+	unsigned long int i;
+	char bName[32];
+
+	if(bVariant == 0) { cjsonObject_Create(&lpRoot, NULL); } else { cjsonObject_CreateSized(&lpRoot, 2, NULL); }
+	cjsonArray_Create(&lpArray, NULL);
+
+	for(i = 0; i < dwRecords; i=i+1) {
+		if(bVariant == 0) { cjsonObject_Create(&lpRecord, NULL); } else { cjsonObject_CreateSized(&lpRecord, 1, NULL); }
+		sprintf(bName, "record %lu", i);
+		cjsonString_Create(&lpValue, bName, strlen(bName), NULL);
+
+		if(bVariant == 0) {
+			cjsonObject_Set(lpRecord, "id", 2, makeULong(i));
+			cjsonObject_Set(lpRecord, "delta", 5, makeSLong(-((signed long int)i)));
+			cjsonObject_Set(lpRecord, "name", 4, lpValue);
+			cjsonObject_Set(lpRecord, "ratio", 5, makeDouble((double)i + 0.5));
+		} else {
+			cjsonObject_Set(lpRecord, "ratio", 5, makeDouble((double)i + 0.5));
+			cjsonObject_Set(lpRecord, "name", 4, lpValue);
+			cjsonObject_Set(lpRecord, "delta", 5, makeDouble(-((double)i)));
+			cjsonObject_Set(lpRecord, "id", 2, makeSLong((signed long int)i));
+		}
+		cjsonArray_Push(lpArray, lpRecord);
+	}
+
+	if(bVariant == 0) {
+		cjsonObject_Set(lpRoot, "records", 7, lpArray);
+		cjsonTrue_Create(&lpValue, NULL);
+		cjsonObject_Set(lpRoot, "valid", 5, lpValue);
+	} else {
+		cjsonTrue_Create(&lpValue, NULL);
+		cjsonObject_Set(lpRoot, "valid", 5, lpValue);
+		cjsonObject_Set(lpRoot, "records", 7, lpArray);
+	}
+	return lpRoot;
+}
+
+static int expectNumbers(struct cjsonValue* lpA, struct cjsonValue* lpB, int bEqual, unsigned int dwLine) {
+	int bResult = 1;
+
+	if(cjsonValue_Equals(lpA, lpB) != bEqual) {
+		printf("%s:%u Number comparison returned wrong result\n", __FILE__, dwLine);
+		bResult = 0;
+	}
+	if((bEqual != 0) && (cjsonValue_Hash(lpA, HASH_SEED) != cjsonValue_Hash(lpB, HASH_SEED))) {
+		printf("%s:%u Equal numbers hash differently\n", __FILE__, dwLine);
+		bResult = 0;
+	}
+	cjsonReleaseValue(lpA);
+	cjsonReleaseValue(lpB);
+	return bResult;
+}
+
+int main(int argc, char* argv[]) {
+	struct cjsonValue* lpA;
+	struct cjsonValue* lpB;
+	struct cjsonValue* lpRecords;
+	struct cjsonValue* lpRecord;
+	struct cjsonProfiler* lpProfiler;
+	struct cjsonProfiler_Stats stats;
+	uint64_t qwScratch;
+	unsigned long int i;
+	int bOk = 1;
+
+	printf("%s:%u Comparing numbers\n", __FILE__, __LINE__);
+	bOk = expectNumbers(makeULong(1), makeSLong(1), 1, __LINE__) && bOk;
+	bOk = expectNumbers(makeULong(1), makeDouble(1.0), 1, __LINE__) && bOk;
+	bOk = expectNumbers(makeSLong(-7), makeDouble(-7.0), 1, __LINE__) && bOk;
+	bOk = expectNumbers(makeULong(0), makeDouble(-0.0), 1, __LINE__) && bOk;
+	bOk = expectNumbers(makeSLong(-1), makeULong((unsigned long int)-1), 0, __LINE__) && bOk;
+	bOk = expectNumbers(makeULong(3), makeDouble(3.25), 0, __LINE__) && bOk;
+	bOk = expectNumbers(makeDouble(2.5), makeDouble(2.5), 1, __LINE__) && bOk;
+
+	printf("%s:%u Comparing documents with different layout\n", __FILE__, __LINE__);
+	lpA = buildDocument(10000, 0);
+	lpB = buildDocument(10000, 1);
+	if(cjsonValue_Equals(lpA, lpB) == 0) { printf("%s:%u Documents differ\n", __FILE__, __LINE__); bOk = 0; }
+	if(cjsonValue_Hash(lpA, HASH_SEED) != cjsonValue_Hash(lpB, HASH_SEED)) { printf("%s:%u Hashes differ\n", __FILE__, __LINE__); bOk = 0; }
+	if(cjsonValue_Hash(lpA, HASH_SEED) == cjsonValue_Hash(lpA, HASH_SEED + 1)) { printf("%s:%u Seed is ignored\n", __FILE__, __LINE__); bOk = 0; }
+
+	printf("%s:%u Comparing modified document\n", __FILE__, __LINE__);
+	cjsonObject_Get(lpB, "records", 7, &lpRecords);
+	cjsonArray_Get(lpRecords, 9999, &lpRecord);
+	cjsonObject_Set(lpRecord, "id", 2, makeULong(1));
+	if(cjsonValue_Equals(lpA, lpB) != 0) { printf("%s:%u Modified documents compare equal\n", __FILE__, __LINE__); bOk = 0; }
+	if(cjsonValue_Hash(lpA, HASH_SEED) == cjsonValue_Hash(lpB, HASH_SEED)) { printf("%s:%u Modified documents hash equal\n", __FILE__, __LINE__); bOk = 0; }
+
+	/* Swapping two array elements has to change equality and hash */
+	cjsonObject_Set(lpRecord, "id", 2, makeULong(9999));
+	cjsonArray_Get(lpRecords, 0, &lpRecord);
+	cjsonObject_Set(lpRecord, "name", 4, makeULong(0));
+	if(cjsonValue_Equals(lpA, lpB) != 0) { printf("%s:%u Modified documents compare equal\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonReleaseValue(lpA);
+	cjsonReleaseValue(lpB);
+
+	printf("%s:%u Comparing deeply nested documents\n", __FILE__, __LINE__);
+	cjsonArray_Create(&lpA, NULL);
+	lpRecord = lpA;
+	for(i = 0; i < 200000; i=i+1) {
+		cjsonArray_Create(&lpRecords, NULL);
+		cjsonArray_Push(lpRecord, lpRecords);
+		lpRecord = lpRecords;
+	}
+	cjsonValue_Clone(lpA, NULL, &lpB);
+	if(cjsonValue_Equals(lpA, lpB) == 0) { printf("%s:%u Deep clone differs\n", __FILE__, __LINE__); bOk = 0; }
+	if(cjsonValue_Hash(lpA, HASH_SEED) != cjsonValue_Hash(lpB, HASH_SEED)) { printf("%s:%u Deep clone hash differs\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonArray_Push(lpRecord, makeULong(1));
+	if(cjsonValue_Equals(lpA, lpB) != 0) { printf("%s:%u Modified deep documents compare equal\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonReleaseValue(lpA);
+	cjsonReleaseValue(lpB);
+
+	/* Additional stack segments come from the system API of the compared values */
+	printf("%s:%u Comparing deeply nested documents with a system API\n", __FILE__, __LINE__);
+	if(cjsonProfiler_Create(&lpProfiler, 1, NULL) != cjsonE_Ok) { printf("%s:%u Failed to create profiler\n", __FILE__, __LINE__); return 1; }
+	cjsonArray_Create(&lpA, cjsonProfiler_System(lpProfiler));
+	lpRecord = lpA;
+	for(i = 0; i < 10000; i=i+1) {
+		cjsonArray_Create(&lpRecords, cjsonProfiler_System(lpProfiler));
+		cjsonArray_Push(lpRecord, lpRecords);
+		lpRecord = lpRecords;
+	}
+	cjsonValue_Clone(lpA, cjsonProfiler_System(lpProfiler), &lpB);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	qwScratch = stats.sites[cjsonAllocSite__Other].qwAllocations;
+	if(cjsonValue_Equals(lpA, lpB) == 0) { printf("%s:%u Deep clone differs\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.sites[cjsonAllocSite__Other].qwAllocations == qwScratch) { printf("%s:%u Compare stack segments bypassed the system API\n", __FILE__, __LINE__); bOk = 0; }
+	qwScratch = stats.sites[cjsonAllocSite__Other].qwAllocations;
+	if(cjsonValue_Hash(lpA, HASH_SEED) != cjsonValue_Hash(lpB, HASH_SEED)) { printf("%s:%u Deep clone hash differs\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.sites[cjsonAllocSite__Other].qwAllocations == qwScratch) { printf("%s:%u Hash stack segments bypassed the system API\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonReleaseValue(lpA);
+	cjsonReleaseValue(lpB);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.qwLiveBytes != 0) { printf("%s:%u %lu bytes still allocated after release\n", __FILE__, __LINE__, (unsigned long int)stats.qwLiveBytes); bOk = 0; }
+	cjsonProfiler_Release(lpProfiler);
+
+	if(bOk) {
+		printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+		return 0;
+	} else {
+		printf("%s:%u Failed\n", __FILE__, __LINE__);
+		return 1;
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,325 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+static enum cjsonError documentCallback(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpDocument;
+	return cjsonE_Ok;
+}
+static struct cjsonValue* parseWithSystem(const char* lpJson, struct cjsonSystemAPI* lpSystem) {
+	struct cjsonParser* lpParser;
+	struct cjsonValue* lpResult = NULL;
+	unsigned long int i;
+
+	if(cjsonParserCreate(&lpParser, 0, &documentCallback, (void*)&lpResult, lpSystem) != cjsonE_Ok) { return NULL; }
+	for(i = 0; i < strlen(lpJson); i=i+1) {
+		if(cjsonParserProcessByte(lpParser, lpJson[i]) != cjsonE_Ok) { break; }
+	}
+	cjsonParserRelease(lpParser);
+	return lpResult;
+}
+static struct cjsonValue* parse(const char* lpJson) {
+	return parseWithSystem(lpJson, NULL);
+}
+
+/*
+	System API that counts allocations and frees
+*/
+static unsigned long int dwAllocations = 0;
+static unsigned long int dwFrees = 0;
+
+static enum cjsonError countingAlloc(struct cjsonSystemAPI* lpSelf, unsigned long int dwSize, void** lpDataOut) {
+	(*lpDataOut) = malloc(dwSize);
+	if((*lpDataOut) == NULL) { return cjsonE_OutOfMemory; }
+	dwAllocations = dwAllocations + 1;
+	return cjsonE_Ok;
+}
+static enum cjsonError countingFree(struct cjsonSystemAPI* lpSelf, void* lpObject) {
+	free(lpObject);
+	dwFrees = dwFrees + 1;
+	return cjsonE_Ok;
+}
+
+/*
+	Applies the patch to the document and compares with the expected result
+*/
+static int runPatchTest(const char* lpDocument, const char* lpPatch, const char* lpExpected, enum cjsonError eExpected, unsigned int dwLine) {
+	struct cjsonValue* lpTarget = parse(lpDocument);
+	struct cjsonValue* lpOps = parse(lpPatch);
+	struct cjsonValue* lpOriginalOps = parse(lpPatch);
+	struct cjsonValue* lpResult;
+	enum cjsonError e;
+	int bOk = 1;
+
+	if((lpTarget == NULL) || (lpOps == NULL) || (lpOriginalOps == NULL)) { printf("%s:%u Failed to parse test input\n", __FILE__, dwLine); return 0; }
+
+	e = cjsonPatch_Apply(&lpTarget, lpOps);
+	if(e != eExpected) {
+		printf("%s:%u Patch returned %u instead of %u\n", __FILE__, dwLine, e, eExpected);
+		bOk = 0;
+	} else if(lpExpected != NULL) {
+		lpResult = parse(lpExpected);
+		if(cjsonValue_Equals(lpTarget, lpResult) == 0) { printf("%s:%u Patched document differs\n", __FILE__, dwLine); bOk = 0; }
+		cjsonReleaseValue(lpResult);
+	}
+
+	/* Values are shared with the target, modifying the target must not modify the patch */
+	if(cjsonValue_Equals(lpOps, lpOriginalOps) == 0) { printf("%s:%u Patch has been modified\n", __FILE__, dwLine); bOk = 0; }
+	cjsonReleaseValue(lpOriginalOps);
+
+	/* The patch may be released before the target (values are shared) */
+	cjsonReleaseValue(lpOps);
+	cjsonReleaseValue(lpTarget);
+	return bOk;
+}
+
+/*
+	Diffs both documents, applies the diff to the first one and
+	checks the result against the second one
+*/
+static int runDiffTest(struct cjsonValue* lpA, struct cjsonValue* lpB, unsigned long int dwMaxOperations, unsigned int dwLine) {
+	struct cjsonValue* lpPatch;
+	struct cjsonValue* lpCopy;
+	enum cjsonError e;
+	int bOk = 1;
+
+	e = cjsonDiff(lpA, lpB, &lpPatch, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Diff failed (code %u)\n", __FILE__, dwLine, e); return 0; }
+
+	if(cjsonArray_Length(lpPatch) > dwMaxOperations) {
+		printf("%s:%u Diff has %lu operations (expected at most %lu)\n", __FILE__, dwLine, cjsonArray_Length(lpPatch), dwMaxOperations);
+		bOk = 0;
+	}
+
+	cjsonValue_Clone(lpA, NULL, &lpCopy);
+	e = cjsonPatch_Apply(&lpCopy, lpPatch);
+	if(e != cjsonE_Ok) { printf("%s:%u Applying diff failed (code %u)\n", __FILE__, dwLine, e); bOk = 0; }
+	else if(cjsonValue_Equals(lpCopy, lpB) == 0) { printf("%s:%u Patched document differs\n", __FILE__, dwLine); bOk = 0; }
+
+	cjsonReleaseValue(lpCopy);
+	cjsonReleaseValue(lpPatch);
+	return bOk;
+}
+static int runDiffTextTest(const char* lpA, const char* lpB, unsigned long int dwMaxOperations, unsigned int dwLine) {
+	struct cjsonValue* lpDocA = parse(lpA);
+	struct cjsonValue* lpDocB = parse(lpB);
+	int bOk;
+
+	if((lpDocA == NULL) || (lpDocB == NULL)) { printf("%s:%u Failed to parse test input\n", __FILE__, dwLine); return 0; }
+	bOk = runDiffTest(lpDocA, lpDocB, dwMaxOperations, dwLine);
+	cjsonReleaseValue(lpDocA);
+	cjsonReleaseValue(lpDocB);
+	return bOk;
+}
+
+static struct cjsonValue* buildNestedObjects(unsigned long int dwDepth, const char* lpLeafKey, struct cjsonSystemAPI* lpSystem) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpCurrent;
+	struct cjsonValue* lpChild;
+	unsigned long int i;
+
+	cjsonObject_Create(&lpRoot, lpSystem);
+	lpCurrent = lpRoot;
+	for(i = 0; i < dwDepth; i=i+1) {
+		cjsonObject_Create(&lpChild, lpSystem);
+		cjsonObject_Set(lpCurrent, "n", 1, lpChild);
+		lpCurrent = lpChild;
+	}
+	cjsonTrue_Create(&lpChild, lpSystem);
+	cjsonObject_Set(lpCurrent, lpLeafKey, strlen(lpLeafKey), lpChild);
+	return lpRoot;
+}
+
+static int runMergeTest(const char* lpDocument, const char* lpPatch, const char* lpExpected, unsigned int dwLine) {
+	struct cjsonValue* lpTarget = parse(lpDocument);
+	struct cjsonValue* lpMerge = parse(lpPatch);
+	struct cjsonValue* lpResult = parse(lpExpected);
+	enum cjsonError e;
+	int bOk = 1;
+
+	if((lpTarget == NULL) || (lpMerge == NULL) || (lpResult == NULL)) { printf("%s:%u Failed to parse test input\n", __FILE__, dwLine); return 0; }
+
+	/* The merge patch is consumed */
+	e = cjsonMergePatch(&lpTarget, lpMerge);
+	if(e != cjsonE_Ok) { printf("%s:%u Merge failed (code %u)\n", __FILE__, dwLine, e); bOk = 0; }
+	else if(cjsonValue_Equals(lpTarget, lpResult) == 0) { printf("%s:%u Merged document differs\n", __FILE__, dwLine); bOk = 0; }
+
+	cjsonReleaseValue(lpResult);
+	cjsonReleaseValue(lpTarget);
+	return bOk;
+}
+
+static struct cjsonValue* buildLargeDocument(unsigned long int dwRecords, unsigned long int dwSkip) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpValue;
+	unsigned long int i;
+
+	cjsonArray_Create(&lpRoot, NULL);
+	for(i = 0; i < dwRecords; i=i+1) {
+		if(i == dwSkip) { continue; }
+		cjsonObject_Create(&lpRecord, NULL);
+		cjsonNumber_Create(&lpValue, NULL);
+		cjsonNumber_SetULong(lpValue, i);
+		cjsonObject_Set(lpRecord, "id", 2, lpValue);
+		cjsonArray_Push(lpRoot, lpRecord);
+	}
+	return lpRoot;
+}
+
+int main(int argc, char* argv[]) {
+	struct cjsonValue* lpA;
+	struct cjsonValue* lpB;
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpValue;
+	struct cjsonValue* lpDefaults;
+	struct cjsonValue* lpOverrides;
+	struct cjsonValue* lpResult;
+	struct cjsonSystemAPI sysCounting;
+	unsigned long int dwBefore;
+	char bLongKey[301];
+	char bLongJson[1024];
+	int bOk = 1;
+
+	printf("%s:%u Applying patches\n", __FILE__, __LINE__);
+	bOk = runPatchTest("{\"foo\":\"bar\"}", "[{\"op\":\"add\",\"path\":\"/baz\",\"value\":\"qux\"}]", "{\"baz\":\"qux\",\"foo\":\"bar\"}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"foo\":[\"bar\",\"baz\"]}", "[{\"op\":\"add\",\"path\":\"/foo/1\",\"value\":\"qux\"}]", "{\"foo\":[\"bar\",\"qux\",\"baz\"]}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"foo\":[\"bar\"]}", "[{\"op\":\"add\",\"path\":\"/foo/-\",\"value\":[\"abc\",\"def\"]}]", "{\"foo\":[\"bar\",[\"abc\",\"def\"]]}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"baz\":\"qux\",\"foo\":\"bar\"}", "[{\"op\":\"remove\",\"path\":\"/baz\"}]", "{\"foo\":\"bar\"}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"foo\":[\"bar\",\"qux\",\"baz\"]}", "[{\"op\":\"remove\",\"path\":\"/foo/1\"}]", "{\"foo\":[\"bar\",\"baz\"]}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"baz\":\"qux\",\"foo\":\"bar\"}", "[{\"op\":\"replace\",\"path\":\"/baz\",\"value\":\"boo\"}]", "{\"baz\":\"boo\",\"foo\":\"bar\"}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"foo\":{\"bar\":\"baz\",\"waldo\":\"fred\"},\"qux\":{\"corge\":\"grault\"}}", "[{\"op\":\"move\",\"from\":\"/foo/waldo\",\"path\":\"/qux/thud\"}]", "{\"foo\":{\"bar\":\"baz\"},\"qux\":{\"corge\":\"grault\",\"thud\":\"fred\"}}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"foo\":[\"all\",\"grass\",\"cows\",\"eat\"]}", "[{\"op\":\"move\",\"from\":\"/foo/1\",\"path\":\"/foo/3\"}]", "{\"foo\":[\"all\",\"cows\",\"eat\",\"grass\"]}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"a\":{\"b\":1}}", "[{\"op\":\"copy\",\"from\":\"/a\",\"path\":\"/c\"},{\"op\":\"replace\",\"path\":\"/c/b\",\"value\":2}]", "{\"a\":{\"b\":1},\"c\":{\"b\":2}}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"baz\":\"qux\",\"foo\":[\"a\",2,\"c\"]}", "[{\"op\":\"test\",\"path\":\"/baz\",\"value\":\"qux\"},{\"op\":\"test\",\"path\":\"/foo/1\",\"value\":2.0}]", "{\"baz\":\"qux\",\"foo\":[\"a\",2,\"c\"]}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"baz\":\"qux\"}", "[{\"op\":\"test\",\"path\":\"/baz\",\"value\":\"bar\"}]", NULL, cjsonE_TestFailed, __LINE__) && bOk;
+	bOk = runPatchTest("{\"/\":1,\"m~n\":2}", "[{\"op\":\"replace\",\"path\":\"/~1\",\"value\":3},{\"op\":\"remove\",\"path\":\"/m~0n\"}]", "{\"/\":3}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"foo\":\"bar\"}", "[{\"op\":\"add\",\"path\":\"/baz/bat\",\"value\":\"qux\"}]", NULL, cjsonE_IndexOutOfBounds, __LINE__) && bOk;
+	bOk = runPatchTest("{\"foo\":\"bar\"}", "[{\"op\":\"replace\",\"path\":\"\",\"value\":[1,2]}]", "[1,2]", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"a\":{\"b\":{}}}", "[{\"op\":\"move\",\"from\":\"/a\",\"path\":\"/a/b/c\"}]", NULL, cjsonE_InvalidParam, __LINE__) && bOk;
+
+	/* Copies into a child of the source must not create cycles */
+	bOk = runPatchTest("{\"a\":1}", "[{\"op\":\"copy\",\"from\":\"\",\"path\":\"/x\"}]", "{\"a\":1,\"x\":{\"a\":1}}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"a\":{\"c\":[1]}}", "[{\"op\":\"copy\",\"from\":\"/a\",\"path\":\"/a/b\"},{\"op\":\"add\",\"path\":\"/a/b/c/-\",\"value\":2}]", "{\"a\":{\"c\":[1],\"b\":{\"c\":[1,2]}}}", cjsonE_Ok, __LINE__) && bOk;
+
+	/* A replaced root is shared with the patch, later operations must not modify the patch */
+	bOk = runPatchTest("{\"a\":1}", "[{\"op\":\"replace\",\"path\":\"\",\"value\":{\"b\":{\"c\":1}}},{\"op\":\"add\",\"path\":\"/c\",\"value\":2},{\"op\":\"replace\",\"path\":\"/b/c\",\"value\":3}]", "{\"b\":{\"c\":3},\"c\":2}", cjsonE_Ok, __LINE__) && bOk;
+	bOk = runPatchTest("{\"a\":1}", "[{\"op\":\"add\",\"path\":\"\",\"value\":[1]},{\"op\":\"add\",\"path\":\"/-\",\"value\":2}]", "[1,2]", cjsonE_Ok, __LINE__) && bOk;
+
+	/* Pointers exceeding the token buffer are decoded into a block of the targets system API */
+	sysCounting.alloc = &countingAlloc;
+	sysCounting.free = &countingFree;
+	memset(bLongKey, 'k', sizeof(bLongKey) - 1);
+	bLongKey[sizeof(bLongKey) - 1] = 0;
+	snprintf(bLongJson, sizeof(bLongJson), "{\"%s\":1}", bLongKey);
+	lpA = parseWithSystem(bLongJson, &sysCounting);
+	snprintf(bLongJson, sizeof(bLongJson), "[{\"op\":\"test\",\"path\":\"/%s\",\"value\":1}]", bLongKey);
+	lpB = parse(bLongJson);
+	if((lpA == NULL) || (lpB == NULL)) { printf("%s:%u Failed to parse test input\n", __FILE__, __LINE__); return 1; }
+	dwBefore = dwFrees;
+	if(cjsonPatch_Apply(&lpA, lpB) != cjsonE_Ok) { printf("%s:%u Patch with long pointer failed\n", __FILE__, __LINE__); bOk = 0; }
+	if(dwFrees == dwBefore) { printf("%s:%u Token buffer bypassed the system API\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonReleaseValue(lpA);
+	cjsonReleaseValue(lpB);
+
+	printf("%s:%u Applying merge patches\n", __FILE__, __LINE__);
+	bOk = runMergeTest("{\"a\":\"b\"}", "{\"a\":\"c\"}", "{\"a\":\"c\"}", __LINE__) && bOk;
+	bOk = runMergeTest("{\"a\":\"b\"}", "{\"b\":\"c\"}", "{\"a\":\"b\",\"b\":\"c\"}", __LINE__) && bOk;
+	bOk = runMergeTest("{\"a\":\"b\"}", "{\"a\":null}", "{}", __LINE__) && bOk;
+	bOk = runMergeTest("{\"a\":\"b\",\"b\":\"c\"}", "{\"a\":null}", "{\"b\":\"c\"}", __LINE__) && bOk;
+	bOk = runMergeTest("{\"a\":[\"b\"]}", "{\"a\":\"c\"}", "{\"a\":\"c\"}", __LINE__) && bOk;
+	bOk = runMergeTest("{\"a\":\"c\"}", "{\"a\":[\"b\"]}", "{\"a\":[\"b\"]}", __LINE__) && bOk;
+	bOk = runMergeTest("{\"a\":{\"b\":\"c\"}}", "{\"a\":{\"b\":\"d\",\"c\":null}}", "{\"a\":{\"b\":\"d\"}}", __LINE__) && bOk;
+	bOk = runMergeTest("{\"a\":[{\"b\":\"c\"}]}", "{\"a\":[1]}", "{\"a\":[1]}", __LINE__) && bOk;
+	bOk = runMergeTest("[\"a\",\"b\"]", "[\"c\",\"d\"]", "[\"c\",\"d\"]", __LINE__) && bOk;
+	bOk = runMergeTest("{\"a\":\"b\"}", "[\"c\"]", "[\"c\"]", __LINE__) && bOk;
+	bOk = runMergeTest("{\"e\":null}", "{\"a\":1}", "{\"e\":null,\"a\":1}", __LINE__) && bOk;
+	bOk = runMergeTest("[1,2]", "{\"a\":\"b\",\"c\":null}", "{\"a\":\"b\"}", __LINE__) && bOk;
+	bOk = runMergeTest("{}", "{\"a\":{\"bb\":{\"ccc\":null}}}", "{\"a\":{\"bb\":{}}}", __LINE__) && bOk;
+	bOk = runMergeTest("{\"a\":{\"b\":{\"c\":1,\"d\":[null]},\"e\":true}}", "{\"a\":{\"b\":{\"c\":null,\"f\":{\"g\":null,\"h\":2}}}}", "{\"a\":{\"b\":{\"d\":[null],\"f\":{\"h\":2}},\"e\":true}}", __LINE__) && bOk;
+
+	/* Merging documents of the same system API does not allocate */
+	lpDefaults = parseWithSystem("{\"timeout\":30,\"limits\":{\"requests\":100,\"burst\":10},\"tags\":[\"a\"],\"debug\":false}", &sysCounting);
+	lpOverrides = parseWithSystem("{\"limits\":{\"burst\":20,\"window\":{\"size\":5,\"unit\":null}},\"tags\":[\"b\",\"c\"],\"debug\":null,\"region\":\"eu\"}", &sysCounting);
+	lpResult = parse("{\"timeout\":30,\"limits\":{\"requests\":100,\"burst\":20,\"window\":{\"size\":5}},\"tags\":[\"b\",\"c\"],\"region\":\"eu\"}");
+
+	dwBefore = dwAllocations;
+	if(cjsonMergePatch(&lpDefaults, lpOverrides) != cjsonE_Ok) { printf("%s:%u Merge failed\n", __FILE__, __LINE__); bOk = 0; }
+	if(dwAllocations != dwBefore) { printf("%s:%u Merge allocated %lu blocks\n", __FILE__, __LINE__, dwAllocations - dwBefore); bOk = 0; }
+	if(cjsonValue_Equals(lpDefaults, lpResult) == 0) { printf("%s:%u Merged document differs\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonReleaseValue(lpDefaults);
+	cjsonReleaseValue(lpResult);
+
+	/* Deeply nested merge */
+	lpDefaults = buildNestedObjects(100000, "a", NULL);
+	lpOverrides = buildNestedObjects(100000, "b", NULL);
+	if(cjsonMergePatch(&lpDefaults, lpOverrides) != cjsonE_Ok) { printf("%s:%u Merge failed\n", __FILE__, __LINE__); bOk = 0; }
+	lpValue = lpDefaults;
+	while(cjsonObject_Get(lpValue, "n", 1, &lpRecord) == cjsonE_Ok) { lpValue = lpRecord; }
+	if((cjsonObject_HasKey(lpValue, "a", 1) != cjsonE_Ok) || (cjsonObject_HasKey(lpValue, "b", 1) != cjsonE_Ok)) { printf("%s:%u Nested merge failed\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonReleaseValue(lpDefaults);
+
+	/* Deeply nested merge of the same system API only allocates stack segments, from that system API */
+	lpDefaults = buildNestedObjects(1000, "a", &sysCounting);
+	lpOverrides = buildNestedObjects(1000, "b", &sysCounting);
+	dwBefore = dwAllocations;
+	if(cjsonMergePatch(&lpDefaults, lpOverrides) != cjsonE_Ok) { printf("%s:%u Merge failed\n", __FILE__, __LINE__); bOk = 0; }
+	if(dwAllocations == dwBefore) { printf("%s:%u Merge stack segments bypassed the system API\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonReleaseValue(lpDefaults);
+
+	printf("%s:%u Creating and applying diffs\n", __FILE__, __LINE__);
+	bOk = runDiffTextTest("{\"a\":1,\"b\":[1,2,3],\"c\":{\"d\":true}}", "{\"a\":1,\"b\":[1,2,3],\"c\":{\"d\":true}}", 0, __LINE__) && bOk;
+	bOk = runDiffTextTest("{\"a\":1,\"b\":[1,2,3],\"c\":{\"d\":true}}", "{\"a\":2,\"b\":[1,3],\"c\":{\"d\":true,\"e/f\":null}}", 3, __LINE__) && bOk;
+	bOk = runDiffTextTest("[1,2,3,4,5,6]", "[0,1,2,4,5,7,6]", 3, __LINE__) && bOk;
+	bOk = runDiffTextTest("[\"x\",\"y\"]", "{\"x\":\"y\"}", 1, __LINE__) && bOk;
+	bOk = runDiffTextTest("[[1,2],[3,4],{\"k~\":[5]}]", "[[1,2,9],[3],{\"k~\":[6]},8]", 4, __LINE__) && bOk;
+
+	/* Paths, work list and tables of the diff come from the patches system API, the patch itself is never freed */
+	lpA = parse("[[1,2],[3,4],{\"k~\":[5]}]");
+	lpB = parse("[[1,2,9],[3],{\"k~\":[6]},8]");
+	dwBefore = dwFrees;
+	if(cjsonDiff(lpA, lpB, &lpResult, &sysCounting) != cjsonE_Ok) { printf("%s:%u Diff failed\n", __FILE__, __LINE__); bOk = 0; }
+	else {
+		if(dwFrees == dwBefore) { printf("%s:%u Diff scratch memory bypassed the system API\n", __FILE__, __LINE__); bOk = 0; }
+		cjsonReleaseValue(lpResult);
+	}
+	cjsonReleaseValue(lpA);
+	cjsonReleaseValue(lpB);
+
+	/* A single change in a large document results in a single operation */
+	lpA = buildLargeDocument(20000, 20000);
+	lpB = buildLargeDocument(20000, 20000);
+	cjsonArray_Get(lpB, 12345, &lpRecord);
+	cjsonString_Create(&lpValue, "changed", 7, NULL);
+	cjsonObject_Set(lpRecord, "state", 5, lpValue);
+	bOk = runDiffTest(lpA, lpB, 1, __LINE__) && bOk;
+	cjsonReleaseValue(lpB);
+
+	/* Removal in the middle of a large array (exceeds the LCS limit) */
+	lpB = buildLargeDocument(20000, 777);
+	bOk = runDiffTest(lpA, lpB, 1, __LINE__) && bOk;
+	bOk = runDiffTest(lpB, lpA, 1, __LINE__) && bOk;
+	cjsonReleaseValue(lpB);
+	cjsonReleaseValue(lpA);
+
+	if(bOk) {
+		printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+		return 0;
+	} else {
+		printf("%s:%u Failed\n", __FILE__, __LINE__);
+		return 1;
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
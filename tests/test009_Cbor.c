@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define BENCH_RECORDS 20000
+
+/*
+	Growing output buffer used by serializer and encoder. If
+	dwChunkLimit is set only that many bytes are accepted per call
+	and the writer reports an error to test resumption.
+*/
+struct outputBuffer {
+	char* lpData;
+	unsigned long int dwUsed;
+	unsigned long int dwSize;
+	unsigned long int dwChunkLimit;
+};
+
+static enum cjsonError bufferWriter(
+	char* lpData,
+	unsigned long int dwBytesToWrite,
+	unsigned long int* lpBytesWrittenOut,
+	void* lpFreeParam
+) {
+	struct outputBuffer* lpBuffer = (struct outputBuffer*)lpFreeParam;
+	enum cjsonError e = cjsonE_Ok;
+
+	if((lpBuffer->dwChunkLimit != 0) && (dwBytesToWrite > lpBuffer->dwChunkLimit)) {
+		dwBytesToWrite = lpBuffer->dwChunkLimit;
+		e = cjsonE_InvalidState;
+	}
+	while(lpBuffer->dwUsed + dwBytesToWrite > lpBuffer->dwSize) {
+		lpBuffer->dwSize = (lpBuffer->dwSize == 0) ? 4096 : lpBuffer->dwSize * 2;
+		lpBuffer->lpData = (char*)realloc(lpBuffer->lpData, lpBuffer->dwSize);
+	}
+	memcpy(&(lpBuffer->lpData[lpBuffer->dwUsed]), lpData, dwBytesToWrite);
+	lpBuffer->dwUsed = lpBuffer->dwUsed + dwBytesToWrite;
+	(*lpBytesWrittenOut) = dwBytesToWrite;
+	return e;
+}
+
+static enum cjsonError documentCallback(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpDocument;
+	return cjsonE_Ok;
+}
+
+static struct cjsonValue* decodeBytes(const char* lpData, unsigned long int dwLength, int bBytewise) {
+	struct cjsonCborDecoder* lpDecoder;
+	struct cjsonValue* lpResult = NULL;
+	enum cjsonError e = cjsonE_Ok;
+	unsigned long int i;
+
+	if(cjsonCborDecoder_Create(&lpDecoder, 0, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { return NULL; }
+	if(bBytewise != 0) {
+		for(i = 0; (i < dwLength) && (e == cjsonE_Ok); i=i+1) {
+			e = cjsonCborDecoder_ProcessByte(lpDecoder, lpData[i]);
+		}
+	} else {
+		e = cjsonCborDecoder_ProcessBytes(lpDecoder, lpData, dwLength);
+	}
+	cjsonCborDecoder_Release(lpDecoder);
+	if(e != cjsonE_Ok) {
+		if(lpResult != NULL) { cjsonReleaseValue(lpResult); }
+		return NULL;
+	}
+	return lpResult;
+}
+static enum cjsonError decodeError(const char* lpData, unsigned long int dwLength) {
+	struct cjsonCborDecoder* lpDecoder;
+	struct cjsonValue* lpResult = NULL;
+	enum cjsonError e;
+
+	if(cjsonCborDecoder_Create(&lpDecoder, 0, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { return cjsonE_ImplementationError; }
+	e = cjsonCborDecoder_ProcessBytes(lpDecoder, lpData, dwLength);
+	cjsonCborDecoder_Release(lpDecoder);
+	if(lpResult != NULL) { cjsonReleaseValue(lpResult); }
+	return e;
+}
+static int encode(struct cjsonValue* lpValue, struct outputBuffer* lpOut) {
+	struct cjsonCborEncoder* lpEncoder;
+	enum cjsonError e;
+
+	if(cjsonCborEncoder_Create(&lpEncoder, &bufferWriter, (void*)lpOut, 0, NULL) != cjsonE_Ok) { return 0; }
+	e = cjsonCborEncoder_Encode(lpEncoder, lpValue);
+	while(e == cjsonE_InvalidState) {
+		/* Writer signaled backpressure, resume */
+		e = cjsonCborEncoder_Continue(lpEncoder);
+	}
+	cjsonCborEncoder_Release(lpEncoder);
+	return (e == cjsonE_Ok) ? 1 : 0;
+}
+
+static struct cjsonValue* parseText(const char* lpJson, unsigned long int dwLength) {
+	struct cjsonParser* lpParser;
+	struct cjsonValue* lpResult = NULL;
+	unsigned long int i;
+
+	if(cjsonParserCreate(&lpParser, 0, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { return NULL; }
+	for(i = 0; i < dwLength; i=i+1) {
+		if(cjsonParserProcessByte(lpParser, lpJson[i]) != cjsonE_Ok) { break; }
+	}
+	cjsonParserRelease(lpParser);
+	return lpResult;
+}
+
+static struct cjsonValue* buildDocument(unsigned long int dwRecords) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpTags;
+	struct cjsonValue* lpValue;
+	unsigned long int i;
+	char bName[64];
+
+	cjsonArray_Create(&lpRoot, NULL);
+	for(i = 0; i < dwRecords; i=i+1) {
+		cjsonObject_Create(&lpRecord, NULL);
+
+		cjsonNumber_Create(&lpValue, NULL); cjsonNumber_SetULong(lpValue, i * 977);
+		cjsonObject_Set(lpRecord, "id", 2, lpValue);
+		cjsonNumber_Create(&lpValue, NULL); cjsonNumber_SetSLong(lpValue, -((signed long int)i));
+		cjsonObject_Set(lpRecord, "delta", 5, lpValue);
+		cjsonNumber_Create(&lpValue, NULL); cjsonNumber_SetDouble(lpValue, (double)i * 0.5);
+		cjsonObject_Set(lpRecord, "half", 4, lpValue);
+		cjsonNumber_Create(&lpValue, NULL); cjsonNumber_SetDouble(lpValue, (double)i / 3.0);
+		cjsonObject_Set(lpRecord, "third", 5, lpValue);
+
+		sprintf(bName, "record number %lu", i);
+		cjsonString_Create(&lpValue, bName, strlen(bName), NULL);
+		cjsonObject_Set(lpRecord, "name", 4, lpValue);
+
+		cjsonArray_Create(&lpTags, NULL);
+		cjsonTrue_Create(&lpValue, NULL); cjsonArray_Push(lpTags, lpValue);
+		cjsonFalse_Create(&lpValue, NULL); cjsonArray_Push(lpTags, lpValue);
+		cjsonNull_Create(&lpValue, NULL); cjsonArray_Push(lpTags, lpValue);
+		cjsonObject_Set(lpRecord, "flags", 5, lpTags);
+
+		cjsonArray_Push(lpRoot, lpRecord);
+	}
+	return lpRoot;
+}
+
+static int expectDecoded(const char* lpCbor, unsigned long int dwCborLength, const char* lpJson, unsigned int dwLine) {
+	struct cjsonValue* lpDecoded;
+	struct cjsonValue* lpExpected;
+	int bOk = 1;
+
+	lpExpected = parseText(lpJson, strlen(lpJson));
+	lpDecoded = decodeBytes(lpCbor, dwCborLength, 1);
+	if((lpDecoded == NULL) || (lpExpected == NULL)) {
+		printf("%s:%u Failed to decode\n", __FILE__, dwLine);
+		bOk = 0;
+	} else if(cjsonValue_Equals(lpDecoded, lpExpected) == 0) {
+		printf("%s:%u Decoded value differs\n", __FILE__, dwLine);
+		bOk = 0;
+	}
+	if(lpDecoded != NULL) { cjsonReleaseValue(lpDecoded); }
+	if(lpExpected != NULL) { cjsonReleaseValue(lpExpected); }
+	return bOk;
+}
+static int expectEncoded(const char* lpJson, const char* lpCbor, unsigned long int dwCborLength, unsigned int dwLine) {
+	struct cjsonValue* lpValue = parseText(lpJson, strlen(lpJson));
+	struct outputBuffer out = { NULL, 0, 0, 0 };
+	int bOk = 1;
+
+	if((lpValue == NULL) || (encode(lpValue, &out) == 0)) {
+		printf("%s:%u Failed to encode\n", __FILE__, dwLine);
+		bOk = 0;
+	} else if((out.dwUsed != dwCborLength) || (memcmp(out.lpData, lpCbor, dwCborLength) != 0)) {
+		printf("%s:%u Encoded bytes differ\n", __FILE__, dwLine);
+		bOk = 0;
+	}
+	if(lpValue != NULL) { cjsonReleaseValue(lpValue); }
+	free(out.lpData);
+	return bOk;
+}
+
+int main(int argc, char* argv[]) {
+	struct cjsonValue* lpDocument;
+	struct cjsonValue* lpDecoded;
+	struct cjsonSerializer* lpSerializer;
+	struct outputBuffer outText = { NULL, 0, 0, 0 };
+	struct outputBuffer outCbor = { NULL, 0, 0, 0 };
+	struct outputBuffer outSlow = { NULL, 0, 0, 3 };
+	clock_t tStart;
+	double dTextEncode, dTextDecode, dCborEncode, dCborDecode;
+	int bOk = 1;
+
+	printf("%s:%u Decoding RFC 8949 examples\n", __FILE__, __LINE__);
+	bOk = expectDecoded("\x81\x19\x03\xe8", 4, "[1000]", __LINE__) && bOk;
+	bOk = expectDecoded("\x81\x39\x03\xe7", 4, "[-1000]", __LINE__) && bOk;
+	bOk = expectDecoded("\x81\xf9\x3c\x00", 4, "[1.0]", __LINE__) && bOk;
+	bOk = expectDecoded("\x81\xf9\x7b\xff", 4, "[65504.0]", __LINE__) && bOk;
+	bOk = expectDecoded("\x81\xfa\x47\xc3\x50\x00", 6, "[100000.0]", __LINE__) && bOk;
+	bOk = expectDecoded("\x81\xfb\x3f\xf1\x99\x99\x99\x99\x99\x9a", 10, "[1.1]", __LINE__) && bOk;
+	bOk = expectDecoded("\x64\x49\x45\x54\x46", 5, "\"IETF\"", __LINE__) && bOk;
+	bOk = expectDecoded("\x7f\x65\x73\x74\x72\x65\x61\x64\x6d\x69\x6e\x67\xff", 13, "\"streaming\"", __LINE__) && bOk;
+	bOk = expectDecoded("\x83\x01\x82\x02\x03\x82\x04\x05", 8, "[1,[2,3],[4,5]]", __LINE__) && bOk;
+	bOk = expectDecoded("\x9f\x01\x82\x02\x03\x9f\x04\x05\xff\xff", 10, "[1,[2,3],[4,5]]", __LINE__) && bOk;
+	bOk = expectDecoded("\xa2\x61\x61\x01\x61\x62\x82\x02\x03", 9, "{\"a\":1,\"b\":[2,3]}", __LINE__) && bOk;
+	bOk = expectDecoded("\xbf\x63\x46\x75\x6e\xf5\x63\x41\x6d\x74\x21\xff", 12, "{\"Fun\":true,\"Amt\":-2}", __LINE__) && bOk;
+	bOk = expectDecoded("\x81\xc1\x1a\x51\x4b\x67\xb0", 7, "[1363896240]", __LINE__) && bOk;
+	bOk = expectDecoded("\x83\xf4\xf5\xf6", 4, "[false,true,null]", __LINE__) && bOk;
+
+	if(decodeBytes("\x42\x01\x02", 3, 1) != NULL) { printf("%s:%u Byte string has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(decodeBytes("\xa1\x01\x02", 3, 1) != NULL) { printf("%s:%u Integer key has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(decodeBytes("\xff", 1, 1) != NULL) { printf("%s:%u Stray break has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+
+	/* Hostile lengths are rejected before anything is allocated */
+	if(decodeError("\x7b\xff\xff\xff\xff\xff\xff\xff\xff", 9) != cjsonE_EncodingError) { printf("%s:%u Huge text length has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(decodeError("\x7a\x04\x00\x00\x01", 5) != cjsonE_EncodingError) { printf("%s:%u Text above the length limit has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(decodeError("\x7f\x61\x61\x7b\x7f\xff\xff\xff\xff\xff\xff\xff", 12) != cjsonE_EncodingError) { printf("%s:%u Huge text chunk has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(decodeError("\x7f\x61\x61\x7b\xff\xff\xff\xff\xff\xff\xff\xff", 12) != cjsonE_EncodingError) { printf("%s:%u Overflowing text chunk has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+
+	printf("%s:%u Encoding values\n", __FILE__, __LINE__);
+	bOk = expectEncoded("[1000,-1000,0.5,1.1]", "\x84\x19\x03\xe8\x39\x03\xe7\xfa\x3f\x00\x00\x00\xfb\x3f\xf1\x99\x99\x99\x99\x99\x9a", 21, __LINE__) && bOk;
+	bOk = expectEncoded("{\"a\":[true,false,null,\"IETF\"]}", "\xa1\x61\x61\x84\xf5\xf4\xf6\x64\x49\x45\x54\x46", 12, __LINE__) && bOk;
+	bOk = expectEncoded("[[],{}]", "\x82\x80\xa0", 3, __LINE__) && bOk;
+
+	printf("%s:%u Round trip of a large document\n", __FILE__, __LINE__);
+	lpDocument = buildDocument(BENCH_RECORDS);
+
+	tStart = clock();
+	if(cjsonSerializer_Create(&lpSerializer, &bufferWriter, (void*)&outText, 0, NULL) != cjsonE_Ok) { printf("%s:%u Failed to create serializer\n", __FILE__, __LINE__); return 1; }
+	if(cjsonSerializer_Serialize(lpSerializer, lpDocument) != cjsonE_Ok) { printf("%s:%u Failed to serialize\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonSerializer_Release(lpSerializer);
+	dTextEncode = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+
+	tStart = clock();
+	lpDecoded = parseText(outText.lpData, outText.dwUsed);
+	dTextDecode = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+	if((lpDecoded == NULL) || (cjsonArray_Length(lpDecoded) != BENCH_RECORDS)) { printf("%s:%u Text round trip failed\n", __FILE__, __LINE__); bOk = 0; }
+	if(lpDecoded != NULL) { cjsonReleaseValue(lpDecoded); }
+
+	tStart = clock();
+	if(encode(lpDocument, &outCbor) == 0) { printf("%s:%u Failed to encode\n", __FILE__, __LINE__); bOk = 0; }
+	dCborEncode = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+
+	tStart = clock();
+	lpDecoded = decodeBytes(outCbor.lpData, outCbor.dwUsed, 0);
+	dCborDecode = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+
+	if((lpDecoded == NULL) || (cjsonValue_Equals(lpDocument, lpDecoded) == 0)) { printf("%s:%u Round trip differs\n", __FILE__, __LINE__); bOk = 0; }
+	if(lpDecoded != NULL) { cjsonReleaseValue(lpDecoded); }
+
+	printf("%s:%u Text: %lu bytes, serialize %.3fs, parse %.3fs\n", __FILE__, __LINE__, outText.dwUsed, dTextEncode, dTextDecode);
+	printf("%s:%u CBOR: %lu bytes, encode %.3fs, decode %.3fs\n", __FILE__, __LINE__, outCbor.dwUsed, dCborEncode, dCborDecode);
+
+	/* Resumed output and bytewise input produce the same result */
+	if(encode(lpDocument, &outSlow) == 0) { printf("%s:%u Failed to encode with backpressure\n", __FILE__, __LINE__); bOk = 0; }
+	if((outSlow.dwUsed != outCbor.dwUsed) || (memcmp(outSlow.lpData, outCbor.lpData, outCbor.dwUsed) != 0)) { printf("%s:%u Resumed output differs\n", __FILE__, __LINE__); bOk = 0; }
+	lpDecoded = decodeBytes(outSlow.lpData, outSlow.dwUsed, 1);
+	if((lpDecoded == NULL) || (cjsonValue_Equals(lpDocument, lpDecoded) == 0)) { printf("%s:%u Bytewise decoding differs\n", __FILE__, __LINE__); bOk = 0; }
+	if(lpDecoded != NULL) { cjsonReleaseValue(lpDecoded); }
+
+	/* Truncated input never delivers a document */
+	lpDecoded = decodeBytes(outCbor.lpData, outCbor.dwUsed - 1, 0);
+	if(lpDecoded != NULL) { printf("%s:%u Truncated input delivered a document\n", __FILE__, __LINE__); cjsonReleaseValue(lpDecoded); bOk = 0; }
+
+	cjsonReleaseValue(lpDocument);
+	free(outText.lpData);
+	free(outCbor.lpData);
+	free(outSlow.lpData);
+
+	if(bOk) {
+		printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+		return 0;
+	} else {
+		printf("%s:%u Failed\n", __FILE__, __LINE__);
+		return 1;
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,303 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define BENCH_RECORDS 20000
+
+/*
+	Growing output buffer used by the encoder. If dwChunkLimit is set
+	only that many bytes are accepted per call and the writer reports
+	an error to test resumption.
+*/
+struct outputBuffer {
+	char* lpData;
+	unsigned long int dwUsed;
+	unsigned long int dwSize;
+	unsigned long int dwChunkLimit;
+};
+
+static enum cjsonError bufferWriter(
+	char* lpData,
+	unsigned long int dwBytesToWrite,
+	unsigned long int* lpBytesWrittenOut,
+	void* lpFreeParam
+) {
+	struct outputBuffer* lpBuffer = (struct outputBuffer*)lpFreeParam;
+	enum cjsonError e = cjsonE_Ok;
+
+	if((lpBuffer->dwChunkLimit != 0) && (dwBytesToWrite > lpBuffer->dwChunkLimit)) {
+		dwBytesToWrite = lpBuffer->dwChunkLimit;
+		e = cjsonE_InvalidState;
+	}
+	while(lpBuffer->dwUsed + dwBytesToWrite > lpBuffer->dwSize) {
+		lpBuffer->dwSize = (lpBuffer->dwSize == 0) ? 4096 : lpBuffer->dwSize * 2;
+		lpBuffer->lpData = (char*)realloc(lpBuffer->lpData, lpBuffer->dwSize);
+	}
+	memcpy(&(lpBuffer->lpData[lpBuffer->dwUsed]), lpData, dwBytesToWrite);
+	lpBuffer->dwUsed = lpBuffer->dwUsed + dwBytesToWrite;
+	(*lpBytesWrittenOut) = dwBytesToWrite;
+	return e;
+}
+
+static enum cjsonError documentCallback(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpDocument;
+	return cjsonE_Ok;
+}
+
+static struct cjsonValue* decodeBytes(const char* lpData, unsigned long int dwLength, int bBytewise) {
+	struct cjsonMsgpackDecoder* lpDecoder;
+	struct cjsonValue* lpResult = NULL;
+	enum cjsonError e = cjsonE_Ok;
+	unsigned long int i;
+
+	if(cjsonMsgpackDecoder_Create(&lpDecoder, 0, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { return NULL; }
+	if(bBytewise != 0) {
+		for(i = 0; (i < dwLength) && (e == cjsonE_Ok); i=i+1) {
+			e = cjsonMsgpackDecoder_ProcessByte(lpDecoder, lpData[i]);
+		}
+	} else {
+		e = cjsonMsgpackDecoder_ProcessBytes(lpDecoder, lpData, dwLength);
+	}
+	cjsonMsgpackDecoder_Release(lpDecoder);
+	if(e != cjsonE_Ok) {
+		if(lpResult != NULL) { cjsonReleaseValue(lpResult); }
+		return NULL;
+	}
+	return lpResult;
+}
+static enum cjsonError decodeError(const char* lpData, unsigned long int dwLength) {
+	struct cjsonMsgpackDecoder* lpDecoder;
+	struct cjsonValue* lpResult = NULL;
+	enum cjsonError e;
+
+	if(cjsonMsgpackDecoder_Create(&lpDecoder, 0, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { return cjsonE_ImplementationError; }
+	e = cjsonMsgpackDecoder_ProcessBytes(lpDecoder, lpData, dwLength);
+	cjsonMsgpackDecoder_Release(lpDecoder);
+	if(lpResult != NULL) { cjsonReleaseValue(lpResult); }
+	return e;
+}
+static int encode(struct cjsonValue* lpValue, struct outputBuffer* lpOut) {
+	struct cjsonMsgpackEncoder* lpEncoder;
+	enum cjsonError e;
+
+	if(cjsonMsgpackEncoder_Create(&lpEncoder, &bufferWriter, (void*)lpOut, 0, NULL) != cjsonE_Ok) { return 0; }
+	e = cjsonMsgpackEncoder_Encode(lpEncoder, lpValue);
+	while(e == cjsonE_InvalidState) {
+		/* Writer signaled backpressure, resume */
+		e = cjsonMsgpackEncoder_Continue(lpEncoder);
+	}
+	cjsonMsgpackEncoder_Release(lpEncoder);
+	return (e == cjsonE_Ok) ? 1 : 0;
+}
+
+static struct cjsonValue* parseText(const char* lpJson, unsigned long int dwLength) {
+	struct cjsonParser* lpParser;
+	struct cjsonValue* lpResult = NULL;
+	unsigned long int i;
+
+	if(cjsonParserCreate(&lpParser, 0, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { return NULL; }
+	for(i = 0; i < dwLength; i=i+1) {
+		if(cjsonParserProcessByte(lpParser, lpJson[i]) != cjsonE_Ok) { break; }
+	}
+	cjsonParserRelease(lpParser);
+	return lpResult;
+}
+
+static struct cjsonValue* buildDocument(unsigned long int dwRecords) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpTags;
+	struct cjsonValue* lpValue;
+	unsigned long int i;
+	char bName[64];
+
+	cjsonArray_Create(&lpRoot, NULL);
+	for(i = 0; i < dwRecords; i=i+1) {
+		cjsonObject_Create(&lpRecord, NULL);
+
+		cjsonNumber_Create(&lpValue, NULL); cjsonNumber_SetULong(lpValue, i * 977);
+		cjsonObject_Set(lpRecord, "id", 2, lpValue);
+		cjsonNumber_Create(&lpValue, NULL); cjsonNumber_SetSLong(lpValue, -((signed long int)i));
+		cjsonObject_Set(lpRecord, "delta", 5, lpValue);
+		cjsonNumber_Create(&lpValue, NULL); cjsonNumber_SetDouble(lpValue, (double)i * 0.5);
+		cjsonObject_Set(lpRecord, "half", 4, lpValue);
+		cjsonNumber_Create(&lpValue, NULL); cjsonNumber_SetDouble(lpValue, (double)i / 3.0);
+		cjsonObject_Set(lpRecord, "third", 5, lpValue);
+
+		sprintf(bName, "record number %lu", i);
+		cjsonString_Create(&lpValue, bName, strlen(bName), NULL);
+		cjsonObject_Set(lpRecord, "name", 4, lpValue);
+
+		cjsonArray_Create(&lpTags, NULL);
+		cjsonTrue_Create(&lpValue, NULL); cjsonArray_Push(lpTags, lpValue);
+		cjsonFalse_Create(&lpValue, NULL); cjsonArray_Push(lpTags, lpValue);
+		cjsonNull_Create(&lpValue, NULL); cjsonArray_Push(lpTags, lpValue);
+		cjsonObject_Set(lpRecord, "flags", 5, lpTags);
+
+		cjsonArray_Push(lpRoot, lpRecord);
+	}
+
+	/* A string longer than the encoder buffer is written directly */
+	cjsonString_Create(&lpValue, NULL, 3 * CJSON_MSGPACK_BUFFERSIZE + 17, NULL);
+	memset(((struct cjsonString*)lpValue)->bData, 'x', 3 * CJSON_MSGPACK_BUFFERSIZE + 17);
+	cjsonArray_Push(lpRoot, lpValue);
+	return lpRoot;
+}
+
+static int expectDecoded(const char* lpMsgpack, unsigned long int dwLength, const char* lpJson, unsigned int dwLine) {
+	struct cjsonValue* lpDecoded;
+	struct cjsonValue* lpExpected;
+	int bOk = 1;
+
+	lpExpected = parseText(lpJson, strlen(lpJson));
+	lpDecoded = decodeBytes(lpMsgpack, dwLength, 1);
+	if((lpDecoded == NULL) || (lpExpected == NULL)) {
+		printf("%s:%u Failed to decode\n", __FILE__, dwLine);
+		bOk = 0;
+	} else if(cjsonValue_Equals(lpDecoded, lpExpected) == 0) {
+		printf("%s:%u Decoded value differs\n", __FILE__, dwLine);
+		bOk = 0;
+	}
+	if(lpDecoded != NULL) { cjsonReleaseValue(lpDecoded); }
+	if(lpExpected != NULL) { cjsonReleaseValue(lpExpected); }
+	return bOk;
+}
+static int expectEncoded(const char* lpJson, const char* lpMsgpack, unsigned long int dwLength, unsigned int dwLine) {
+	struct cjsonValue* lpValue = parseText(lpJson, strlen(lpJson));
+	struct outputBuffer out = { NULL, 0, 0, 0 };
+	int bOk = 1;
+
+	if((lpValue == NULL) || (encode(lpValue, &out) == 0)) {
+		printf("%s:%u Failed to encode\n", __FILE__, dwLine);
+		bOk = 0;
+	} else if((out.dwUsed != dwLength) || (memcmp(out.lpData, lpMsgpack, dwLength) != 0)) {
+		printf("%s:%u Encoded bytes differ\n", __FILE__, dwLine);
+		bOk = 0;
+	}
+	if(lpValue != NULL) { cjsonReleaseValue(lpValue); }
+	free(out.lpData);
+	return bOk;
+}
+
+/*
+	Integers keep their signedness instead of passing through double
+*/
+static int expectInteger(const char* lpMsgpack, unsigned long int dwLength, enum cjsonElementType type, unsigned long int dwUnsigned, signed long int iSigned, unsigned int dwLine) {
+	struct cjsonValue* lpDecoded = decodeBytes(lpMsgpack, dwLength, 0);
+	struct cjsonValue* lpNumber = NULL;
+	int bOk = 1;
+
+	if((lpDecoded == NULL) || (cjsonArray_Get(lpDecoded, 0, &lpNumber) != cjsonE_Ok) || (lpNumber->type != type)) {
+		printf("%s:%u Integer type not preserved\n", __FILE__, dwLine);
+		bOk = 0;
+	} else if((type == cjsonNumber_UnsignedLong) && (((struct cjsonNumber*)lpNumber)->value.ulong != dwUnsigned)) {
+		printf("%s:%u Unsigned value differs\n", __FILE__, dwLine);
+		bOk = 0;
+	} else if((type == cjsonNumber_SignedLong) && (((struct cjsonNumber*)lpNumber)->value.slong != iSigned)) {
+		printf("%s:%u Signed value differs\n", __FILE__, dwLine);
+		bOk = 0;
+	}
+	if(lpDecoded != NULL) { cjsonReleaseValue(lpDecoded); }
+	return bOk;
+}
+
+int main(int argc, char* argv[]) {
+	struct cjsonValue* lpDocument;
+	struct cjsonValue* lpDecoded;
+	struct outputBuffer outMsgpack = { NULL, 0, 0, 0 };
+	struct outputBuffer outSlow = { NULL, 0, 0, 3 };
+	clock_t tStart;
+	double dEncode, dDecode;
+	int bOk = 1;
+
+	printf("%s:%u Decoding format examples\n", __FILE__, __LINE__);
+	bOk = expectDecoded("\x91\x7f", 2, "[127]", __LINE__) && bOk;
+	bOk = expectDecoded("\x91\xe0", 2, "[-32]", __LINE__) && bOk;
+	bOk = expectDecoded("\x91\xcd\x03\xe8", 4, "[1000]", __LINE__) && bOk;
+	bOk = expectDecoded("\x91\xd1\xfc\x18", 4, "[-1000]", __LINE__) && bOk;
+	bOk = expectDecoded("\x91\xca\x3f\x00\x00\x00", 6, "[0.5]", __LINE__) && bOk;
+	bOk = expectDecoded("\x91\xcb\x3f\xf1\x99\x99\x99\x99\x99\x9a", 10, "[1.1]", __LINE__) && bOk;
+	bOk = expectDecoded("\xa4\x49\x45\x54\x46", 5, "\"IETF\"", __LINE__) && bOk;
+	bOk = expectDecoded("\xd9\x04\x49\x45\x54\x46", 6, "\"IETF\"", __LINE__) && bOk;
+	bOk = expectDecoded("\x93\x01\x92\x02\x03\xdc\x00\x02\x04\x05", 10, "[1,[2,3],[4,5]]", __LINE__) && bOk;
+	bOk = expectDecoded("\x82\xa1\x61\x01\xa1\x62\x92\x02\x03", 9, "{\"a\":1,\"b\":[2,3]}", __LINE__) && bOk;
+	bOk = expectDecoded("\xde\x00\x01\xa3\x46\x75\x6e\xc3", 8, "{\"Fun\":true}", __LINE__) && bOk;
+	bOk = expectDecoded("\x93\xc2\xc3\xc0", 4, "[false,true,null]", __LINE__) && bOk;
+
+	if(decodeBytes("\xc4\x01\x02", 3, 1) != NULL) { printf("%s:%u Binary has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(decodeBytes("\xd4\x01\x02", 3, 1) != NULL) { printf("%s:%u Extension has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(decodeBytes("\x81\x01\x02", 3, 1) != NULL) { printf("%s:%u Integer key has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(decodeBytes("\xc1", 1, 1) != NULL) { printf("%s:%u Reserved format has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(decodeError("\xdb\xff\xff\xff\xf0", 5) != cjsonE_EncodingError) { printf("%s:%u Huge string length has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(decodeError("\x81\xdb\x04\x00\x00\x01", 6) != cjsonE_EncodingError) { printf("%s:%u Key above the length limit has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+
+	printf("%s:%u Integer types\n", __FILE__, __LINE__);
+	bOk = expectInteger("\x91\xce\xff\xff\xff\xff", 6, cjsonNumber_UnsignedLong, 4294967295UL, 0, __LINE__) && bOk;
+	bOk = expectInteger("\x91\xd0\x80", 3, cjsonNumber_SignedLong, 0, -128, __LINE__) && bOk;
+	bOk = expectInteger("\x91\xd2\x80\x00\x00\x00", 6, cjsonNumber_SignedLong, 0, -2147483647L - 1, __LINE__) && bOk;
+	bOk = expectInteger("\x91\xd3\x00\x00\x00\x00\x00\x00\x00\x05", 10, cjsonNumber_SignedLong, 0, 5, __LINE__) && bOk;
+	if(sizeof(unsigned long int) >= 8) {
+		bOk = expectInteger("\x91\xcf\xff\xff\xff\xff\xff\xff\xff\xff", 10, cjsonNumber_UnsignedLong, ULONG_MAX, 0, __LINE__) && bOk;
+		bOk = expectInteger("\x91\xd3\x80\x00\x00\x00\x00\x00\x00\x00", 10, cjsonNumber_SignedLong, 0, LONG_MIN, __LINE__) && bOk;
+	}
+
+	printf("%s:%u Encoding values\n", __FILE__, __LINE__);
+	bOk = expectEncoded("[1000,-1000,0.5,1.1]", "\x94\xcd\x03\xe8\xd1\xfc\x18\xca\x3f\x00\x00\x00\xcb\x3f\xf1\x99\x99\x99\x99\x99\x9a", 21, __LINE__) && bOk;
+	bOk = expectEncoded("[127,-32,255,-33]", "\x94\x7f\xe0\xcc\xff\xd0\xdf", 7, __LINE__) && bOk;
+	bOk = expectEncoded("{\"a\":[true,false,null,\"IETF\"]}", "\x81\xa1\x61\x94\xc3\xc2\xc0\xa4\x49\x45\x54\x46", 12, __LINE__) && bOk;
+	bOk = expectEncoded("[[],{}]", "\x92\x90\x80", 3, __LINE__) && bOk;
+
+	printf("%s:%u Round trip of a large document\n", __FILE__, __LINE__);
+	lpDocument = buildDocument(BENCH_RECORDS);
+
+	tStart = clock();
+	if(encode(lpDocument, &outMsgpack) == 0) { printf("%s:%u Failed to encode\n", __FILE__, __LINE__); bOk = 0; }
+	dEncode = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+
+	tStart = clock();
+	lpDecoded = decodeBytes(outMsgpack.lpData, outMsgpack.dwUsed, 0);
+	dDecode = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+
+	if((lpDecoded == NULL) || (cjsonValue_Equals(lpDocument, lpDecoded) == 0)) { printf("%s:%u Round trip differs\n", __FILE__, __LINE__); bOk = 0; }
+	if(lpDecoded != NULL) { cjsonReleaseValue(lpDecoded); }
+
+	printf("%s:%u MessagePack: %lu bytes, encode %.3fs, decode %.3fs\n", __FILE__, __LINE__, outMsgpack.dwUsed, dEncode, dDecode);
+
+	/* Resumed output and bytewise input produce the same result */
+	if(encode(lpDocument, &outSlow) == 0) { printf("%s:%u Failed to encode with backpressure\n", __FILE__, __LINE__); bOk = 0; }
+	if((outSlow.dwUsed != outMsgpack.dwUsed) || (memcmp(outSlow.lpData, outMsgpack.lpData, outMsgpack.dwUsed) != 0)) { printf("%s:%u Resumed output differs\n", __FILE__, __LINE__); bOk = 0; }
+	lpDecoded = decodeBytes(outSlow.lpData, outSlow.dwUsed, 1);
+	if((lpDecoded == NULL) || (cjsonValue_Equals(lpDocument, lpDecoded) == 0)) { printf("%s:%u Bytewise decoding differs\n", __FILE__, __LINE__); bOk = 0; }
+	if(lpDecoded != NULL) { cjsonReleaseValue(lpDecoded); }
+
+	/* Truncated input never delivers a document */
+	lpDecoded = decodeBytes(outMsgpack.lpData, outMsgpack.dwUsed - 1, 0);
+	if(lpDecoded != NULL) { printf("%s:%u Truncated input delivered a document\n", __FILE__, __LINE__); cjsonReleaseValue(lpDecoded); bOk = 0; }
+
+	cjsonReleaseValue(lpDocument);
+	free(outMsgpack.lpData);
+	free(outSlow.lpData);
+
+	if(bOk) {
+		printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+		return 0;
+	} else {
+		printf("%s:%u Failed\n", __FILE__, __LINE__);
+		return 1;
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
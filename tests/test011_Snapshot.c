@@ -0,0 +1,326 @@
+#ifndef _POSIX_C_SOURCE
+	#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define BENCH_RECORDS 20000
+#define DEEP_NESTING 1000
+
+struct outputBuffer {
+	char* lpData;
+	unsigned long int dwUsed;
+	unsigned long int dwSize;
+};
+
+static enum cjsonError bufferWriter(
+	char* lpData,
+	unsigned long int dwBytesToWrite,
+	unsigned long int* lpBytesWrittenOut,
+	void* lpFreeParam
+) {
+	struct outputBuffer* lpBuffer = (struct outputBuffer*)lpFreeParam;
+
+	while(lpBuffer->dwUsed + dwBytesToWrite > lpBuffer->dwSize) {
+		lpBuffer->dwSize = (lpBuffer->dwSize == 0) ? 4096 : lpBuffer->dwSize * 2;
+		lpBuffer->lpData = (char*)realloc(lpBuffer->lpData, lpBuffer->dwSize);
+	}
+	memcpy(&(lpBuffer->lpData[lpBuffer->dwUsed]), lpData, dwBytesToWrite);
+	lpBuffer->dwUsed = lpBuffer->dwUsed + dwBytesToWrite;
+	(*lpBytesWrittenOut) = dwBytesToWrite;
+	return cjsonE_Ok;
+}
+static enum cjsonError fileWriter(
+	char* lpData,
+	unsigned long int dwBytesToWrite,
+	unsigned long int* lpBytesWrittenOut,
+	void* lpFreeParam
+) {
+	(*lpBytesWrittenOut) = (unsigned long int)fwrite(lpData, 1, dwBytesToWrite, (FILE*)lpFreeParam);
+	return ((*lpBytesWrittenOut) == dwBytesToWrite) ? cjsonE_Ok : cjsonE_InvalidState;
+}
+
+static enum cjsonError documentCallback(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpDocument;
+	return cjsonE_Ok;
+}
+static struct cjsonValue* parseText(const char* lpJson, unsigned long int dwLength) {
+	struct cjsonParser* lpParser;
+	struct cjsonValue* lpResult = NULL;
+	unsigned long int i;
+
+	if(cjsonParserCreate(&lpParser, 0, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { return NULL; }
+	for(i = 0; i < dwLength; i=i+1) {
+		if(cjsonParserProcessByte(lpParser, lpJson[i]) != cjsonE_Ok) { break; }
+	}
+	cjsonParserRelease(lpParser);
+	return lpResult;
+}
+
+static struct cjsonValue* buildDocument(unsigned long int dwRecords) {
+	struct cjsonValue* lpRoot;
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpValue;
+	unsigned long int i;
+	char bName[64];
+
+	cjsonArray_Create(&lpRoot, NULL);
+	for(i = 0; i < dwRecords; i=i+1) {
+		cjsonObject_Create(&lpRecord, NULL);
+
+		cjsonNumber_Create(&lpValue, NULL); cjsonNumber_SetULong(lpValue, i * 977);
+		cjsonObject_Set(lpRecord, "id", 2, lpValue);
+		cjsonNumber_Create(&lpValue, NULL); cjsonNumber_SetSLong(lpValue, -((signed long int)i));
+		cjsonObject_Set(lpRecord, "delta", 5, lpValue);
+		cjsonNumber_Create(&lpValue, NULL); cjsonNumber_SetDouble(lpValue, (double)i / 3.0);
+		cjsonObject_Set(lpRecord, "third", 5, lpValue);
+
+		sprintf(bName, "record number %lu", i);
+		cjsonString_Create(&lpValue, bName, strlen(bName), NULL);
+		cjsonObject_Set(lpRecord, "name", 4, lpValue);
+
+		cjsonArray_Push(lpRoot, lpRecord);
+	}
+	return lpRoot;
+}
+
+/*
+	Recursively compares a tree with its snapshot
+*/
+static int compareSnapshot(const struct cjsonSnapshot* lpSnapshot, uint64_t qwValue, const struct cjsonValue* lpValue) {
+	struct cjsonValue* lpChild;
+	uint64_t qwChild;
+	const char* lpKey;
+	const char* lpPrevKey = NULL;
+	unsigned long int dwKeyLength;
+	unsigned long int dwPrevKeyLength = 0;
+	unsigned long int i;
+	unsigned long int dwULong;
+	signed long int iSLong;
+	double dValue;
+
+	if(cjsonSnapshot_Type(lpSnapshot, qwValue) != lpValue->type) { return 0; }
+
+	switch(lpValue->type) {
+		case cjsonNumber_UnsignedLong:
+			return ((cjsonSnapshotNumber_GetULong(lpSnapshot, qwValue, &dwULong) == cjsonE_Ok) && (dwULong == ((struct cjsonNumber*)lpValue)->value.ulong)) ? 1 : 0;
+		case cjsonNumber_SignedLong:
+			return ((cjsonSnapshotNumber_GetSLong(lpSnapshot, qwValue, &iSLong) == cjsonE_Ok) && (iSLong == ((struct cjsonNumber*)lpValue)->value.slong)) ? 1 : 0;
+		case cjsonNumber_Double:
+			return ((cjsonSnapshotNumber_GetDouble(lpSnapshot, qwValue, &dValue) == cjsonE_Ok) && (dValue == ((struct cjsonNumber*)lpValue)->value.dbl)) ? 1 : 0;
+		case cjsonString:
+			if(cjsonSnapshotString_Get(lpSnapshot, qwValue, &lpKey, &dwKeyLength) != cjsonE_Ok) { return 0; }
+			if(dwKeyLength != ((struct cjsonString*)lpValue)->dwStrlen) { return 0; }
+			if(lpKey[dwKeyLength] != 0) { return 0; }
+			return (memcmp(lpKey, ((struct cjsonString*)lpValue)->bData, dwKeyLength) == 0) ? 1 : 0;
+		case cjsonArray:
+			if(cjsonSnapshotArray_Length(lpSnapshot, qwValue) != cjsonArray_Length(lpValue)) { return 0; }
+			for(i = 0; i < cjsonArray_Length(lpValue); i=i+1) {
+				if(cjsonSnapshotArray_Get(lpSnapshot, qwValue, i, &qwChild) != cjsonE_Ok) { return 0; }
+				if(cjsonArray_Get(lpValue, i, &lpChild) != cjsonE_Ok) { return 0; }
+				if(compareSnapshot(lpSnapshot, qwChild, lpChild) == 0) { return 0; }
+			}
+			return 1;
+		case cjsonObject:
+			if(cjsonSnapshotObject_Length(lpSnapshot, qwValue) != ((struct cjsonObject*)lpValue)->dwElementCount) { return 0; }
+			for(i = 0; i < ((struct cjsonObject*)lpValue)->dwElementCount; i=i+1) {
+				if(cjsonSnapshotObject_GetEntry(lpSnapshot, qwValue, i, &lpKey, &dwKeyLength, &qwChild) != cjsonE_Ok) { return 0; }
+
+				/* Entries are sorted */
+				if((lpPrevKey != NULL) && (memcmp(lpPrevKey, lpKey, (dwPrevKeyLength < dwKeyLength) ? dwPrevKeyLength : dwKeyLength) > 0)) { return 0; }
+				lpPrevKey = lpKey;
+				dwPrevKeyLength = dwKeyLength;
+
+				if(cjsonObject_Get(lpValue, lpKey, dwKeyLength, &lpChild) != cjsonE_Ok) { return 0; }
+				if(compareSnapshot(lpSnapshot, qwChild, lpChild) == 0) { return 0; }
+
+				/* Lookup finds the same entry */
+				if(cjsonSnapshotObject_Get(lpSnapshot, qwValue, lpKey, dwKeyLength, &qwChild) != cjsonE_Ok) { return 0; }
+				if(compareSnapshot(lpSnapshot, qwChild, lpChild) == 0) { return 0; }
+			}
+			return 1;
+		default:
+			return 1;
+	}
+}
+
+static int snapshotRoundtrip(const char* lpJson, unsigned int dwLine) {
+	struct cjsonValue* lpValue = parseText(lpJson, strlen(lpJson));
+	struct outputBuffer out = { NULL, 0, 0 };
+	struct cjsonSnapshot snapshot;
+	int bOk = 1;
+
+	if(lpValue == NULL) {
+		printf("%s:%u Failed to parse\n", __FILE__, dwLine);
+		return 0;
+	}
+	if(cjsonSnapshot_Write(lpValue, &bufferWriter, (void*)&out, NULL) != cjsonE_Ok) {
+		printf("%s:%u Failed to write snapshot\n", __FILE__, dwLine);
+		bOk = 0;
+	} else if(cjsonSnapshot_Open(&snapshot, out.lpData, out.dwUsed) != cjsonE_Ok) {
+		printf("%s:%u Failed to open snapshot\n", __FILE__, dwLine);
+		bOk = 0;
+	} else if(compareSnapshot(&snapshot, snapshot.qwRoot, lpValue) == 0) {
+		printf("%s:%u Snapshot differs\n", __FILE__, dwLine);
+		bOk = 0;
+	}
+	cjsonReleaseValue(lpValue);
+	free(out.lpData);
+	return bOk;
+}
+
+int main(int argc, char* argv[]) {
+	struct cjsonValue* lpDocument;
+	struct cjsonValue* lpDecoded;
+	struct cjsonSerializer* lpSerializer;
+	struct outputBuffer out = { NULL, 0, 0 };
+	struct outputBuffer outText = { NULL, 0, 0 };
+	struct cjsonSnapshot snapshot;
+	uint64_t qwRecord, qwValue;
+	unsigned long int dwULong;
+	const char* lpString;
+	unsigned long int dwLength;
+	char* lpJson;
+	char* lpCorrupt;
+	clock_t tStart;
+	double dParse, dOpen;
+	unsigned long int i;
+	int bOk = 1;
+
+	printf("%s:%u Snapshots of small documents\n", __FILE__, __LINE__);
+	bOk = snapshotRoundtrip("[1]", __LINE__) && bOk;
+	bOk = snapshotRoundtrip("\"root string\"", __LINE__) && bOk;
+	bOk = snapshotRoundtrip("[[],{},\"\",null,true,false,-5,1.5]", __LINE__) && bOk;
+	bOk = snapshotRoundtrip("true", __LINE__) && bOk;
+	bOk = snapshotRoundtrip("[18446744073709551615,-9223372036854775807,1152921504606846975,-1152921504606846976,2305843009213693952]", __LINE__) && bOk;
+	bOk = snapshotRoundtrip("{\"b\":1,\"a\":{\"z\":[1,2,{\"\":\"empty key\"}],\"y\":\"text\"},\"ab\":-3,\"aa\":2.25}", __LINE__) && bOk;
+
+	/* Deep nesting exceeds the first stack segment */
+	lpJson = (char*)malloc(2 * DEEP_NESTING + 2);
+	for(i = 0; i < DEEP_NESTING; i=i+1) { lpJson[i] = '['; lpJson[DEEP_NESTING + 1 + i] = ']'; }
+	lpJson[DEEP_NESTING] = '1';
+	lpJson[2 * DEEP_NESTING + 1] = 0;
+	bOk = snapshotRoundtrip(lpJson, __LINE__) && bOk;
+	free(lpJson);
+
+	printf("%s:%u Snapshot of a large document\n", __FILE__, __LINE__);
+	lpDocument = buildDocument(BENCH_RECORDS);
+	if(cjsonSnapshot_Write(lpDocument, &bufferWriter, (void*)&out, NULL) != cjsonE_Ok) { printf("%s:%u Failed to write snapshot\n", __FILE__, __LINE__); return 1; }
+
+	if(cjsonSerializer_Create(&lpSerializer, &bufferWriter, (void*)&outText, 0, NULL) != cjsonE_Ok) { printf("%s:%u Failed to create serializer\n", __FILE__, __LINE__); return 1; }
+	if(cjsonSerializer_Serialize(lpSerializer, lpDocument) != cjsonE_Ok) { printf("%s:%u Failed to serialize\n", __FILE__, __LINE__); bOk = 0; }
+	cjsonSerializer_Release(lpSerializer);
+
+	tStart = clock();
+	lpDecoded = parseText(outText.lpData, outText.dwUsed);
+	dParse = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+	if(lpDecoded != NULL) { cjsonReleaseValue(lpDecoded); }
+
+	tStart = clock();
+	if(cjsonSnapshot_Open(&snapshot, out.lpData, out.dwUsed) != cjsonE_Ok) { printf("%s:%u Failed to open snapshot\n", __FILE__, __LINE__); return 1; }
+	if((cjsonSnapshotArray_Get(&snapshot, snapshot.qwRoot, BENCH_RECORDS / 2, &qwRecord) != cjsonE_Ok)
+		|| (cjsonSnapshotObject_Get(&snapshot, qwRecord, "id", 2, &qwValue) != cjsonE_Ok)
+		|| (cjsonSnapshotNumber_GetULong(&snapshot, qwValue, &dwULong) != cjsonE_Ok)
+		|| (dwULong != (BENCH_RECORDS / 2) * 977)) {
+		printf("%s:%u Lookup failed\n", __FILE__, __LINE__);
+		bOk = 0;
+	}
+	dOpen = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+
+	printf("%s:%u Text: %lu bytes, parse %.3fs\n", __FILE__, __LINE__, outText.dwUsed, dParse);
+	printf("%s:%u Snapshot: %lu bytes, open and lookup %.6fs\n", __FILE__, __LINE__, out.dwUsed, dOpen);
+
+	if(compareSnapshot(&snapshot, snapshot.qwRoot, lpDocument) == 0) { printf("%s:%u Snapshot differs\n", __FILE__, __LINE__); bOk = 0; }
+
+	/* Errors */
+	if(cjsonSnapshotObject_Get(&snapshot, qwRecord, "missing", 7, &qwValue) != cjsonE_IndexOutOfBounds) { printf("%s:%u Missing key has been found\n", __FILE__, __LINE__); bOk = 0; }
+	if(cjsonSnapshotArray_Get(&snapshot, snapshot.qwRoot, BENCH_RECORDS, &qwValue) != cjsonE_IndexOutOfBounds) { printf("%s:%u Index out of bounds has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(cjsonSnapshotString_Get(&snapshot, qwRecord, &lpString, &dwLength) != cjsonE_InvalidParam) { printf("%s:%u Wrong type has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(cjsonSnapshot_Type(&snapshot, snapshot.qwSize) != cjsonUnknown) { printf("%s:%u Invalid reference has been accepted\n", __FILE__, __LINE__); bOk = 0; }
+	if(cjsonSnapshot_Open(&snapshot, out.lpData, out.dwUsed - 8) != cjsonE_EncodingError) { printf("%s:%u Truncated snapshot has been opened\n", __FILE__, __LINE__); bOk = 0; }
+
+	lpCorrupt = (char*)malloc(out.dwUsed);
+	memcpy(lpCorrupt, out.lpData, out.dwUsed);
+	lpCorrupt[0] = 'X';
+	if(cjsonSnapshot_Open(&snapshot, lpCorrupt, out.dwUsed) != cjsonE_EncodingError) { printf("%s:%u Corrupted snapshot has been opened\n", __FILE__, __LINE__); bOk = 0; }
+	free(lpCorrupt);
+
+	#ifndef _WIN32
+	{
+		char bPath[] = "/tmp/test011_SnapshotXXXXXX";
+		struct stat fileInfo;
+		FILE* fSnapshot;
+		void* lpMapping;
+		int hFile;
+
+		/* Write the snapshot to a file, map it read-only and query the mapping */
+		printf("%s:%u Querying a mapped snapshot file\n", __FILE__, __LINE__);
+		hFile = mkstemp(bPath);
+		if((hFile < 0) || ((fSnapshot = fdopen(hFile, "wb")) == NULL)) { printf("%s:%u Failed to create temporary file\n", __FILE__, __LINE__); return 1; }
+		if(cjsonSnapshot_Write(lpDocument, &fileWriter, (void*)fSnapshot, NULL) != cjsonE_Ok) { printf("%s:%u Failed to write snapshot file\n", __FILE__, __LINE__); bOk = 0; }
+		if(fclose(fSnapshot) != 0) { printf("%s:%u Failed to close snapshot file\n", __FILE__, __LINE__); bOk = 0; }
+
+		hFile = open(bPath, O_RDONLY);
+		if((hFile < 0) || (fstat(hFile, &fileInfo) != 0)) {
+			printf("%s:%u Failed to open snapshot file\n", __FILE__, __LINE__);
+			bOk = 0;
+		} else if((unsigned long int)fileInfo.st_size != out.dwUsed) {
+			printf("%s:%u Snapshot file has %lu bytes instead of %lu\n", __FILE__, __LINE__, (unsigned long int)fileInfo.st_size, out.dwUsed);
+			bOk = 0;
+		} else {
+			lpMapping = mmap(NULL, (size_t)fileInfo.st_size, PROT_READ, MAP_SHARED, hFile, 0);
+			if(lpMapping == MAP_FAILED) {
+				printf("%s:%u Failed to map snapshot\n", __FILE__, __LINE__);
+				bOk = 0;
+			} else {
+				if(memcmp(lpMapping, out.lpData, out.dwUsed) != 0) {
+					printf("%s:%u Mapped image differs from the written image\n", __FILE__, __LINE__);
+					bOk = 0;
+				}
+				if((cjsonSnapshot_Open(&snapshot, lpMapping, (unsigned long int)fileInfo.st_size) != cjsonE_Ok) || (compareSnapshot(&snapshot, snapshot.qwRoot, lpDocument) == 0)) {
+					printf("%s:%u Mapped snapshot differs\n", __FILE__, __LINE__);
+					bOk = 0;
+				}
+				munmap(lpMapping, (size_t)fileInfo.st_size);
+			}
+		}
+		if(hFile >= 0) { close(hFile); }
+		unlink(bPath);
+	}
+	#endif
+
+	cjsonReleaseValue(lpDocument);
+	free(out.lpData);
+	free(outText.lpData);
+
+	if(bOk) {
+		printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+		return 0;
+	} else {
+		printf("%s:%u Failed\n", __FILE__, __LINE__);
+		return 1;
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
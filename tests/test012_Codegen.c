@@ -0,0 +1,250 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/cjson.h"
+#include "../tmp/test012_Codegen_gen.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define BENCH_RECORDS 20000
+
+struct outputBuffer {
+	char* lpData;
+	unsigned long int dwUsed;
+	unsigned long int dwSize;
+};
+
+static enum cjsonError bufferWriter(
+	char* lpData,
+	unsigned long int dwBytesToWrite,
+	unsigned long int* lpBytesWrittenOut,
+	void* lpFreeParam
+) {
+	struct outputBuffer* lpBuffer = (struct outputBuffer*)lpFreeParam;
+
+	while(lpBuffer->dwUsed + dwBytesToWrite > lpBuffer->dwSize) {
+		lpBuffer->dwSize = (lpBuffer->dwSize == 0) ? 4096 : lpBuffer->dwSize * 2;
+		lpBuffer->lpData = (char*)realloc(lpBuffer->lpData, lpBuffer->dwSize);
+	}
+	memcpy(&(lpBuffer->lpData[lpBuffer->dwUsed]), lpData, dwBytesToWrite);
+	lpBuffer->dwUsed = lpBuffer->dwUsed + dwBytesToWrite;
+	(*lpBytesWrittenOut) = dwBytesToWrite;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError documentCallback(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpDocument;
+	return cjsonE_Ok;
+}
+static struct cjsonValue* parseText(const char* lpJson, unsigned long int dwLength) {
+	struct cjsonParser* lpParser;
+	struct cjsonValue* lpResult = NULL;
+	unsigned long int i;
+
+	if(cjsonParserCreate(&lpParser, 0, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { return NULL; }
+	for(i = 0; i < dwLength; i=i+1) {
+		if(cjsonParserProcessByte(lpParser, lpJson[i]) != cjsonE_Ok) { break; }
+	}
+	cjsonParserRelease(lpParser);
+	return lpResult;
+}
+
+static int expectError(const char* lpJson, enum cjsonError eExpected, unsigned int dwLine) {
+	struct request req;
+	enum cjsonError e;
+
+	e = request_Parse(&req, lpJson, strlen(lpJson));
+	if(e != eExpected) {
+		printf("%s:%u Parsing %s returned %u instead of %u\n", __FILE__, dwLine, lpJson, e, eExpected);
+		return 0;
+	}
+	return 1;
+}
+
+/*
+	Field extraction from a DOM tree the way an application would do
+	it without generated code
+*/
+static int extractRequest(struct cjsonValue* lpRoot, struct request* lpOut) {
+	struct cjsonValue* lpValue;
+	struct cjsonValue* lpElement;
+	unsigned long int i;
+
+	memset(lpOut, 0, sizeof(struct request));
+	if(cjsonObject_Get(lpRoot, "id", 2, &lpValue) == cjsonE_Ok) { lpOut->id = cjsonObject_GetAsULong(lpValue); }
+	if(cjsonObject_Get(lpRoot, "delta", 5, &lpValue) == cjsonE_Ok) { lpOut->delta = cjsonObject_GetAsSLong(lpValue); }
+	if(cjsonObject_Get(lpRoot, "price", 5, &lpValue) == cjsonE_Ok) { lpOut->price = cjsonObject_GetAsDouble(lpValue); }
+	if(cjsonObject_Get(lpRoot, "active", 6, &lpValue) == cjsonE_Ok) { lpOut->active = cjsonIsTrue(lpValue) ? 1 : 0; }
+	if(cjsonObject_Get(lpRoot, "name", 4, &lpValue) == cjsonE_Ok) {
+		lpOut->nameLength = cjsonString_Strlen(lpValue);
+		if(lpOut->nameLength >= sizeof(lpOut->name)) { return 0; }
+		memcpy(lpOut->name, cjsonString_Get(lpValue), lpOut->nameLength);
+	}
+	if(cjsonObject_Get(lpRoot, "origin", 6, &lpValue) == cjsonE_Ok) {
+		if(cjsonObject_Get(lpValue, "x", 1, &lpElement) == cjsonE_Ok) { lpOut->origin.x = cjsonObject_GetAsDouble(lpElement); }
+		if(cjsonObject_Get(lpValue, "y", 1, &lpElement) == cjsonE_Ok) { lpOut->origin.y = cjsonObject_GetAsDouble(lpElement); }
+	}
+	if(cjsonObject_Get(lpRoot, "samples", 7, &lpValue) == cjsonE_Ok) {
+		lpOut->samplesCount = cjsonArray_Length(lpValue);
+		if(lpOut->samplesCount > 8) { return 0; }
+		for(i = 0; i < lpOut->samplesCount; i=i+1) {
+			if(cjsonArray_Get(lpValue, i, &lpElement) != cjsonE_Ok) { return 0; }
+			lpOut->samples[i] = cjsonObject_GetAsDouble(lpElement);
+		}
+	}
+	return 1;
+}
+
+int main(int argc, char* argv[]) {
+	struct request req;
+	struct request reqCopy;
+	struct outputBuffer out = { NULL, 0, 0 };
+	struct outputBuffer bench = { NULL, 0, 0 };
+	unsigned long int* lpOffsets;
+	struct cjsonValue* lpRoot;
+	clock_t tStart;
+	double dDom, dGenerated;
+	unsigned long int dwChecksumDom = 0;
+	unsigned long int dwChecksumGenerated = 0;
+	unsigned long int i;
+	const char* lpEscaped;
+	char bLongNumber[1024];
+	int bOk = 1;
+
+	const char* lpFull = " { \"id\" : 42, \"delta\":-17, \"price\":19.99, \"active\":true, \"name\":\"widget\",\n"
+		"\"extra\":{\"nested\":[1,{\"deep\":\"}\"}],\"more\":null}, \"origin\":{\"x\":1.5,\"y\":-2e3},\n"
+		"\"samples\":[0.5, 1, 2.25e1], \"flags\":[true,false,true], \"unused\":\"value\" } ";
+
+	printf("%s:%u Parsing a complete record\n", __FILE__, __LINE__);
+	if(request_Parse(&req, lpFull, strlen(lpFull)) != cjsonE_Ok) { printf("%s:%u Failed to parse record\n", __FILE__, __LINE__); return 1; }
+	if((req.id != 42) || (req.delta != -17) || (req.price != 19.99) || (req.active != 1)
+		|| (req.nameLength != 6) || (strcmp(req.name, "widget") != 0)
+		|| (req.origin.x != 1.5) || (req.origin.y != -2000.0)
+		|| (req.samplesCount != 3) || (req.samples[0] != 0.5) || (req.samples[1] != 1.0) || (req.samples[2] != 22.5)
+		|| (req.flagsCount != 3) || (req.flags[0] != 1) || (req.flags[1] != 0) || (req.flags[2] != 1)) {
+		printf("%s:%u Parsed values differ\n", __FILE__, __LINE__);
+		bOk = 0;
+	}
+	if(req.qwPresent != (REQUEST_FIELD_ID | REQUEST_FIELD_DELTA | REQUEST_FIELD_PRICE | REQUEST_FIELD_ACTIVE | REQUEST_FIELD_NAME | REQUEST_FIELD_ORIGIN | REQUEST_FIELD_SAMPLES | REQUEST_FIELD_FLAGS)) {
+		printf("%s:%u Wrong presence mask %llx\n", __FILE__, __LINE__, (unsigned long long)req.qwPresent);
+		bOk = 0;
+	}
+	if(req.origin.qwPresent != (POINT_FIELD_X | POINT_FIELD_Y)) { printf("%s:%u Wrong nested presence mask\n", __FILE__, __LINE__); bOk = 0; }
+
+	printf("%s:%u Missing fields, null and escapes\n", __FILE__, __LINE__);
+	lpEscaped = "{\"id\":null,\"name\":\"a\\\"b\\\\\\u00e9\\ud83d\\ude00\\n\"}";
+	if(request_Parse(&req, lpEscaped, strlen(lpEscaped)) != cjsonE_Ok) { printf("%s:%u Failed to parse record\n", __FILE__, __LINE__); bOk = 0; }
+	if((req.qwPresent != REQUEST_FIELD_NAME) || (req.id != 0) || (req.nameLength != 11) || (memcmp(req.name, "a\"b\\\xc3\xa9\xf0\x9f\x98\x80\n", 12) != 0)) {
+		printf("%s:%u Escaped string or null field decoded incorrectly\n", __FILE__, __LINE__);
+		bOk = 0;
+	}
+	if((request_Parse(&req, "{}", 2) != cjsonE_Ok) || (req.qwPresent != 0)) { printf("%s:%u Empty object failed\n", __FILE__, __LINE__); bOk = 0; }
+
+	printf("%s:%u Numbers longer than the stack buffer\n", __FILE__, __LINE__);
+	strcpy(bLongNumber, "{\"price\":1.");
+	memset(&(bLongNumber[11]), '0', 900);
+	strcpy(&(bLongNumber[911]), "25e2}");
+	if(request_Parse(&req, bLongNumber, strlen(bLongNumber)) != cjsonE_Ok) { printf("%s:%u Failed to parse long number\n", __FILE__, __LINE__); bOk = 0; }
+	else if(req.price != 100.0) { printf("%s:%u Long number decoded as %f\n", __FILE__, __LINE__, req.price); bOk = 0; }
+
+	printf("%s:%u Typed number and structure errors\n", __FILE__, __LINE__);
+	bOk = expectError("{\"id\":-1}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"id\":1.5}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"id\":18446744073709551616}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"id\":01}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"delta\":-9223372036854775809}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"price\":\"1\"}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"active\":1}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"name\":\"012345678901234567890123456789012\"}", cjsonE_IndexOutOfBounds, __LINE__) && bOk;
+	bOk = expectError("{\"samples\":[1,2,3,4,5,6,7,8,9]}", cjsonE_IndexOutOfBounds, __LINE__) && bOk;
+	bOk = expectError("{\"id\":1,}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"id\":1", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"id\":1} x", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("[]", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"unknown\":[1,2}", cjsonE_EncodingError, __LINE__) && bOk;
+
+	printf("%s:%u Skipped values are validated\n", __FILE__, __LINE__);
+	bOk = expectError("{\"id\":1,\"junk\":[1 2 3]}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":{]}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":[}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":xyz}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":{\"a\":}}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":{\"a\" 1}}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":{\"a\":1,}}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":[1,]}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":[tru]}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":nulls}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":1.2.3}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":-}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":[[[]]}", cjsonE_EncodingError, __LINE__) && bOk;
+	bOk = expectError("{\"junk\":{\"a\":[{},[],\"x\",-1.5e3,true,false,null]},\"id\":7}", cjsonE_Ok, __LINE__) && bOk;
+
+	printf("%s:%u Serializing and parsing back\n", __FILE__, __LINE__);
+	if(request_Parse(&req, lpFull, strlen(lpFull)) != cjsonE_Ok) { printf("%s:%u Failed to parse record\n", __FILE__, __LINE__); return 1; }
+	req.price = 0.1;
+	strcpy(req.name, "tab\tquote\"");
+	req.nameLength = 10;
+	if(request_Serialize(&req, &bufferWriter, (void*)&out) != cjsonE_Ok) { printf("%s:%u Failed to serialize\n", __FILE__, __LINE__); return 1; }
+	if(request_Parse(&reqCopy, out.lpData, out.dwUsed) != cjsonE_Ok) { printf("%s:%u Failed to parse serialized record %.*s\n", __FILE__, __LINE__, (int)out.dwUsed, out.lpData); return 1; }
+	if(memcmp(&req, &reqCopy, sizeof(struct request)) != 0) { printf("%s:%u Roundtrip differs: %.*s\n", __FILE__, __LINE__, (int)out.dwUsed, out.lpData); bOk = 0; }
+
+	printf("%s:%u Generated parser vs. DOM parse and field extraction\n", __FILE__, __LINE__);
+	lpOffsets = (unsigned long int*)malloc(sizeof(unsigned long int) * (BENCH_RECORDS + 1));
+	for(i = 0; i < BENCH_RECORDS; i=i+1) {
+		memset(&req, 0, sizeof(req));
+		req.id = i * 977;
+		req.delta = -(signed long int)i;
+		req.price = (double)i / 8.0;
+		req.active = (int)(i & 1);
+		req.nameLength = (unsigned long int)sprintf(req.name, "record %lu", i);
+		req.origin.x = (double)i;
+		req.origin.y = 0.25;
+		req.samplesCount = 4;
+		req.samples[0] = 1.0; req.samples[1] = 2.5; req.samples[2] = (double)i; req.samples[3] = -4.0;
+		lpOffsets[i] = bench.dwUsed;
+		if(request_Serialize(&req, &bufferWriter, (void*)&bench) != cjsonE_Ok) { printf("%s:%u Failed to serialize\n", __FILE__, __LINE__); return 1; }
+	}
+	lpOffsets[BENCH_RECORDS] = bench.dwUsed;
+
+	tStart = clock();
+	for(i = 0; i < BENCH_RECORDS; i=i+1) {
+		lpRoot = parseText(&(bench.lpData[lpOffsets[i]]), lpOffsets[i+1] - lpOffsets[i]);
+		if((lpRoot == NULL) || (extractRequest(lpRoot, &req) == 0)) { printf("%s:%u DOM parse failed\n", __FILE__, __LINE__); bOk = 0; break; }
+		dwChecksumDom = dwChecksumDom + req.id + req.nameLength + req.samplesCount;
+		cjsonReleaseValue(lpRoot);
+	}
+	dDom = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+
+	tStart = clock();
+	for(i = 0; i < BENCH_RECORDS; i=i+1) {
+		if(request_Parse(&req, &(bench.lpData[lpOffsets[i]]), lpOffsets[i+1] - lpOffsets[i]) != cjsonE_Ok) { printf("%s:%u Generated parse failed\n", __FILE__, __LINE__); bOk = 0; break; }
+		dwChecksumGenerated = dwChecksumGenerated + req.id + req.nameLength + req.samplesCount;
+	}
+	dGenerated = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+
+	printf("%s:%u %u records, %lu bytes: DOM %.3fs, generated %.3fs\n", __FILE__, __LINE__, BENCH_RECORDS, bench.dwUsed, dDom, dGenerated);
+	if(dwChecksumDom != dwChecksumGenerated) { printf("%s:%u Checksums differ\n", __FILE__, __LINE__); bOk = 0; }
+
+	free(lpOffsets);
+	free(bench.lpData);
+	free(out.lpData);
+
+	if(bOk) {
+		printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+		return 0;
+	} else {
+		printf("%s:%u Failed\n", __FILE__, __LINE__);
+		return 1;
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
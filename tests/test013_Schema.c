@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+static const char* lpSchemaText = "{"
+	"\"$schema\":\"https://json-schema.org/draft/2020-12/schema\","
+	"\"title\":\"Order\","
+	"\"type\":\"object\","
+	"\"required\":[\"id\",\"status\",\"items\"],"
+	"\"additionalProperties\":false,"
+	"\"properties\":{"
+		"\"id\":{\"type\":\"integer\",\"minimum\":1},"
+		"\"status\":{\"enum\":[\"open\",\"closed\",null]},"
+		"\"note\":{\"type\":\"string\",\"maxLength\":4},"
+		"\"discount\":{\"type\":\"number\",\"exclusiveMinimum\":0,\"maximum\":0.5},"
+		"\"express\":{\"type\":\"boolean\"},"
+		"\"items\":{\"type\":\"array\",\"items\":{"
+			"\"type\":\"object\",\"required\":[\"sku\"],"
+			"\"properties\":{\"sku\":{\"type\":\"string\"},\"qty\":{\"type\":\"integer\",\"exclusiveMaximum\":100}}"
+		"}},"
+		"\"meta\":{\"type\":[\"object\",\"null\"],\"additionalProperties\":{\"type\":\"string\"}},"
+		"\"version\":{\"const\":2}"
+	"}"
+"}";
+
+static enum cjsonError documentCallback(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	struct cjsonValue** lpResult = (struct cjsonValue**)lpFreeParam;
+
+	if((*lpResult) != NULL) { cjsonReleaseValue(*lpResult); }
+	(*lpResult) = lpDocument;
+	return cjsonE_Ok;
+}
+static struct cjsonValue* parseText(const char* lpJson) {
+	struct cjsonParser* lpParser;
+	struct cjsonValue* lpResult = NULL;
+	unsigned long int i;
+
+	if(cjsonParserCreate(&lpParser, 0, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { return NULL; }
+	for(i = 0; lpJson[i] != 0; i=i+1) {
+		if(cjsonParserProcessByte(lpParser, lpJson[i]) != cjsonE_Ok) { break; }
+	}
+	cjsonParserRelease(lpParser);
+	return lpResult;
+}
+
+/*
+	Parses the text with the schema attached and reports the result
+	as well as the offset of the byte that has been rejected
+*/
+static enum cjsonError parseValidated(const struct cjsonSchema* lpSchema, const char* lpJson, unsigned long int* lpOffsetOut, int* lpDocumentOut) {
+	struct cjsonParser* lpParser;
+	struct cjsonValue* lpResult = NULL;
+	enum cjsonError e = cjsonE_Ok;
+	unsigned long int i;
+
+	if(cjsonParserCreate(&lpParser, 0, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { return cjsonE_OutOfMemory; }
+	if(cjsonParserSetSchema(lpParser, lpSchema) != cjsonE_Ok) { cjsonParserRelease(lpParser); return cjsonE_ImplementationError; }
+	for(i = 0; lpJson[i] != 0; i=i+1) {
+		e = cjsonParserProcessByte(lpParser, lpJson[i]);
+		if(e != cjsonE_Ok) { break; }
+	}
+	cjsonParserRelease(lpParser);
+
+	if(lpOffsetOut != NULL) { (*lpOffsetOut) = i; }
+	if(lpDocumentOut != NULL) { (*lpDocumentOut) = (lpResult != NULL) ? 1 : 0; }
+	if(lpResult != NULL) { cjsonReleaseValue(lpResult); }
+	return e;
+}
+
+static int expectValid(const struct cjsonSchema* lpSchema, const char* lpJson, unsigned int dwLine) {
+	enum cjsonError e;
+	int bDocument;
+
+	e = parseValidated(lpSchema, lpJson, NULL, &bDocument);
+	if((e != cjsonE_Ok) || (bDocument == 0)) {
+		printf("%s:%u Valid document %s has been rejected (%u)\n", __FILE__, dwLine, lpJson, e);
+		return 0;
+	}
+	return 1;
+}
+static int expectViolation(const struct cjsonSchema* lpSchema, const char* lpJson, const char* lpRejectedAt, unsigned int dwLine) {
+	enum cjsonError e;
+	unsigned long int dwOffset;
+	int bDocument;
+
+	e = parseValidated(lpSchema, lpJson, &dwOffset, &bDocument);
+	if((e != cjsonE_SchemaViolation) || (bDocument != 0)) {
+		printf("%s:%u Invalid document %s returned %u\n", __FILE__, dwLine, lpJson, e);
+		return 0;
+	}
+	/* The parse has to stop at the first byte that allows to detect the violation */
+	if((lpRejectedAt != NULL) && (dwOffset != (unsigned long int)(strstr(lpJson, lpRejectedAt) - lpJson))) {
+		printf("%s:%u Violation in %s detected at offset %lu instead of %lu\n", __FILE__, dwLine, lpJson, dwOffset, (unsigned long int)(strstr(lpJson, lpRejectedAt) - lpJson));
+		return 0;
+	}
+	return 1;
+}
+static int expectCompileError(const char* lpText, unsigned int dwLine) {
+	struct cjsonValue* lpDocument = parseText(lpText);
+	struct cjsonSchema* lpSchema = NULL;
+	enum cjsonError e;
+
+	if(lpDocument == NULL) { printf("%s:%u Failed to parse %s\n", __FILE__, dwLine, lpText); return 0; }
+	e = cjsonSchema_Compile(&lpSchema, lpDocument, NULL);
+	cjsonReleaseValue(lpDocument);
+	if(e != cjsonE_InvalidParam) {
+		printf("%s:%u Schema %s compiled with result %u\n", __FILE__, dwLine, lpText, e);
+		cjsonSchema_Release(lpSchema);
+		return 0;
+	}
+	return 1;
+}
+static struct cjsonSchema* compile(const char* lpText) {
+	struct cjsonValue* lpDocument = parseText(lpText);
+	struct cjsonSchema* lpSchema = NULL;
+
+	if(lpDocument == NULL) { return NULL; }
+	if(cjsonSchema_Compile(&lpSchema, lpDocument, NULL) != cjsonE_Ok) { lpSchema = NULL; }
+	cjsonReleaseValue(lpDocument);
+	return lpSchema;
+}
+
+int main(int argc, char* argv[]) {
+	struct cjsonSchema* lpSchema;
+	struct cjsonSchema* lpBoolean;
+	struct cjsonParser* lpParser;
+	struct cjsonValue* lpResult = NULL;
+	const char* lpStream;
+	unsigned long int dwDocuments;
+	enum cjsonError e;
+	unsigned long int i;
+	int bOk = 1;
+
+	printf("%s:%u Compiling schema\n", __FILE__, __LINE__);
+	lpSchema = compile(lpSchemaText);
+	if(lpSchema == NULL) { printf("%s:%u Failed to compile schema\n", __FILE__, __LINE__); return 1; }
+
+	printf("%s:%u Valid documents\n", __FILE__, __LINE__);
+	bOk = expectValid(lpSchema, "{\"id\":1,\"status\":\"open\",\"items\":[]}", __LINE__) && bOk;
+	bOk = expectValid(lpSchema, "{ \"items\" : [ {\"sku\":\"a\",\"qty\":99}, {\"sku\":\"b\"} ], \"status\" : null, \"id\" : 7.0 }", __LINE__) && bOk;
+	bOk = expectValid(lpSchema, "{\"id\":3,\"status\":\"closed\",\"items\":[],\"note\":\"\\u00e4\\u00f6\\u00fc\\u00df\",\"discount\":0.5,\"express\":false,\"meta\":{\"a\":\"b\"},\"version\":2.0}", __LINE__) && bOk;
+	bOk = expectValid(lpSchema, "{\"id\":3,\"status\":\"closed\",\"items\":[],\"meta\":null}", __LINE__) && bOk;
+
+	printf("%s:%u Violations abort at the first offending byte\n", __FILE__, __LINE__);
+	bOk = expectViolation(lpSchema, "[{\"id\":1}]", "[", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"bogus\":[1,2,3],\"status\":\"open\",\"items\":[]}", "\":[1", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":\"1\",\"status\":\"open\",\"items\":[]}", "\"1\"", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":0,\"status\":\"open\",\"items\":[]}", ",\"status", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1.5,\"status\":\"open\",\"items\":[]}", ",\"status", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"pending\",\"items\":[]}", "\",\"items", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"open\"}", "}", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"open\",\"items\":[{\"qty\":1}]}", "}]", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"open\",\"items\":[{\"sku\":\"a\",\"qty\":100}]}", "}]", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"open\",\"items\":[\"a\"]}", "\"a\"]", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"open\",\"items\":[],\"note\":\"abcde\"}", "\"}", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"open\",\"items\":[],\"discount\":0}", "}", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"open\",\"items\":[],\"discount\":0.75}", "}", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"open\",\"items\":[],\"express\":null}", "null", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"open\",\"items\":[],\"meta\":{\"a\":1}}", "1}}", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"open\",\"items\":[],\"meta\":[]}", "[]}", __LINE__) && bOk;
+	bOk = expectViolation(lpSchema, "{\"id\":1,\"status\":\"open\",\"items\":[],\"version\":3}", "}", __LINE__) && bOk;
+
+	printf("%s:%u Streaming mode validates every document\n", __FILE__, __LINE__);
+	if(cjsonParserCreate(&lpParser, CJSON_PARSER_FLAG__STREAMINGMODE, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { printf("%s:%u Failed to create parser\n", __FILE__, __LINE__); return 1; }
+	if(cjsonParserSetSchema(lpParser, lpSchema) != cjsonE_Ok) { printf("%s:%u Failed to set schema\n", __FILE__, __LINE__); bOk = 0; }
+	lpStream = "{\"id\":1,\"status\":\"open\",\"items\":[]}\n{\"id\":2,\"status\":\"closed\",\"items\":[]}\n{\"id\":3,\"status\":\"open\"}\n";
+	dwDocuments = 0;
+	e = cjsonE_Ok;
+	for(i = 0; (lpStream[i] != 0) && (e == cjsonE_Ok); i=i+1) {
+		e = cjsonParserProcessByte(lpParser, lpStream[i]);
+		if(lpResult != NULL) {
+			dwDocuments = dwDocuments + 1;
+			cjsonReleaseValue(lpResult);
+			lpResult = NULL;
+		}
+		if((e == cjsonE_Ok) && (lpStream[i] == '{') && (cjsonParserSetSchema(lpParser, NULL) != cjsonE_InvalidState)) {
+			printf("%s:%u Schema could be changed inside a document\n", __FILE__, __LINE__);
+			bOk = 0;
+		}
+	}
+	if((e != cjsonE_SchemaViolation) || (dwDocuments != 2)) { printf("%s:%u Stream returned %u after %lu documents\n", __FILE__, __LINE__, e, dwDocuments); bOk = 0; }
+	cjsonParserRelease(lpParser);
+
+	printf("%s:%u Boolean schemas\n", __FILE__, __LINE__);
+	lpBoolean = compile("true");
+	if(lpBoolean == NULL) { printf("%s:%u Failed to compile true schema\n", __FILE__, __LINE__); bOk = 0; }
+	else { bOk = expectValid(lpBoolean, "[1,\"a\",{\"b\":null}]", __LINE__) && bOk; cjsonSchema_Release(lpBoolean); }
+	lpBoolean = compile("false");
+	if(lpBoolean == NULL) { printf("%s:%u Failed to compile false schema\n", __FILE__, __LINE__); bOk = 0; }
+	else { bOk = expectViolation(lpBoolean, "{}", "{", __LINE__) && bOk; cjsonSchema_Release(lpBoolean); }
+	lpBoolean = compile("{\"type\":\"array\",\"items\":false}");
+	if(lpBoolean == NULL) { printf("%s:%u Failed to compile items schema\n", __FILE__, __LINE__); bOk = 0; }
+	else {
+		bOk = expectValid(lpBoolean, "[ ]", __LINE__) && bOk;
+		bOk = expectViolation(lpBoolean, "[ {} ]", "{", __LINE__) && bOk;
+		cjsonSchema_Release(lpBoolean);
+	}
+
+	printf("%s:%u Unsupported schemas\n", __FILE__, __LINE__);
+	bOk = expectCompileError("{\"$ref\":\"#/definitions/a\"}", __LINE__) && bOk;
+	bOk = expectCompileError("{\"type\":\"text\"}", __LINE__) && bOk;
+	bOk = expectCompileError("{\"maxLength\":-1}", __LINE__) && bOk;
+	bOk = expectCompileError("{\"items\":[{\"type\":\"string\"}]}", __LINE__) && bOk;
+	bOk = expectCompileError("{\"properties\":{\"a\":{\"minimum\":\"1\"}}}", __LINE__) && bOk;
+	bOk = expectCompileError("{\"required\":[1]}", __LINE__) && bOk;
+	bOk = expectCompileError("[]", __LINE__) && bOk;
+
+	cjsonSchema_Release(lpSchema);
+
+	if(bOk) {
+		printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+		return 0;
+	} else {
+		printf("%s:%u Failed\n", __FILE__, __LINE__);
+		return 1;
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
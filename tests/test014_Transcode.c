@@ -0,0 +1,317 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define BENCH_RECORDS 50000
+
+struct outputBuffer {
+	char* lpData;
+	unsigned long int dwUsed;
+	unsigned long int dwSize;
+};
+
+static enum cjsonError bufferWriter(
+	char* lpData,
+	unsigned long int dwBytesToWrite,
+	unsigned long int* lpBytesWrittenOut,
+	void* lpFreeParam
+) {
+	struct outputBuffer* lpBuffer = (struct outputBuffer*)lpFreeParam;
+
+	while(lpBuffer->dwUsed + dwBytesToWrite + 1 > lpBuffer->dwSize) {
+		lpBuffer->dwSize = (lpBuffer->dwSize == 0) ? 4096 : lpBuffer->dwSize * 2;
+		lpBuffer->lpData = (char*)realloc(lpBuffer->lpData, lpBuffer->dwSize);
+	}
+	memcpy(&(lpBuffer->lpData[lpBuffer->dwUsed]), lpData, dwBytesToWrite);
+	lpBuffer->dwUsed = lpBuffer->dwUsed + dwBytesToWrite;
+	lpBuffer->lpData[lpBuffer->dwUsed] = 0;
+	(*lpBytesWrittenOut) = dwBytesToWrite;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError documentCallback(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpDocument;
+	return cjsonE_Ok;
+}
+static struct cjsonValue* parseText(const char* lpJson, unsigned long int dwLength) {
+	struct cjsonParser* lpParser;
+	struct cjsonValue* lpResult = NULL;
+	unsigned long int i;
+
+	if(cjsonParserCreate(&lpParser, 0, &documentCallback, (void*)&lpResult, NULL) != cjsonE_Ok) { return NULL; }
+	for(i = 0; i < dwLength; i=i+1) {
+		if(cjsonParserProcessByte(lpParser, lpJson[i]) != cjsonE_Ok) { break; }
+	}
+	cjsonParserRelease(lpParser);
+	return lpResult;
+}
+
+/*
+	Transcodes the text either in one call or byte by byte
+*/
+static enum cjsonError transcode(const char* lpJson, unsigned long int dwLength, uint32_t dwFlags, int bBytewise, struct outputBuffer* lpOut) {
+	struct cjsonTranscoder* lpTranscoder;
+	enum cjsonError e = cjsonE_Ok;
+	unsigned long int i;
+
+	lpOut->dwUsed = 0;
+	if((e = cjsonTranscoder_Create(&lpTranscoder, &bufferWriter, (void*)lpOut, dwFlags, NULL)) != cjsonE_Ok) { return e; }
+	if(bBytewise != 0) {
+		for(i = 0; (i < dwLength) && (e == cjsonE_Ok); i=i+1) {
+			e = cjsonTranscoder_ProcessByte(lpTranscoder, lpJson[i]);
+		}
+	} else {
+		e = cjsonTranscoder_ProcessBytes(lpTranscoder, lpJson, dwLength);
+	}
+	if(e == cjsonE_Ok) { e = cjsonTranscoder_Finish(lpTranscoder); }
+	cjsonTranscoder_Release(lpTranscoder);
+	return e;
+}
+
+static int expectOutput(const char* lpJson, uint32_t dwFlags, const char* lpExpected, unsigned int dwLine) {
+	struct outputBuffer out = { NULL, 0, 0 };
+	int bBytewise;
+	int bOk = 1;
+
+	for(bBytewise = 0; bBytewise < 2; bBytewise=bBytewise+1) {
+		if(transcode(lpJson, strlen(lpJson), dwFlags, bBytewise, &out) != cjsonE_Ok) {
+			printf("%s:%u Failed to transcode\n", __FILE__, dwLine);
+			bOk = 0;
+		} else if((out.dwUsed != strlen(lpExpected)) || ((out.dwUsed > 0) && (memcmp(out.lpData, lpExpected, out.dwUsed) != 0))) {
+			printf("%s:%u Unexpected output %.*s\n", __FILE__, dwLine, (int)out.dwUsed, out.lpData);
+			bOk = 0;
+		}
+	}
+	free(out.lpData);
+	return bOk;
+}
+static int expectError(const char* lpJson, uint32_t dwFlags, enum cjsonError eExpected, unsigned int dwLine) {
+	struct outputBuffer out = { NULL, 0, 0 };
+	enum cjsonError e;
+	int bBytewise;
+	int bOk = 1;
+
+	for(bBytewise = 0; bBytewise < 2; bBytewise=bBytewise+1) {
+		e = transcode(lpJson, strlen(lpJson), dwFlags, bBytewise, &out);
+		if(e != eExpected) {
+			printf("%s:%u Expected error %u, got %u\n", __FILE__, dwLine, (unsigned int)eExpected, (unsigned int)e);
+			bOk = 0;
+		}
+	}
+	free(out.lpData);
+	return bOk;
+}
+
+static enum cjsonError serializeTree(struct cjsonValue* lpValue, uint32_t dwFlags, struct outputBuffer* lpOut) {
+	struct cjsonSerializer* lpSerializer;
+	enum cjsonError e;
+
+	lpOut->dwUsed = 0;
+	if((e = cjsonSerializer_Create(&lpSerializer, &bufferWriter, (void*)lpOut, dwFlags, NULL)) != cjsonE_Ok) { return e; }
+	e = cjsonSerializer_Serialize(lpSerializer, lpValue);
+	cjsonSerializer_Release(lpSerializer);
+	return e;
+}
+
+/*
+	Pretty printing the serializers minified output has to yield exactly
+	the serializers pretty output (the minified text is used as input
+	so member order and number formatting are the same)
+*/
+static int expectSerializerLayout(struct cjsonValue* lpValue, unsigned int dwLine) {
+	struct outputBuffer minified = { NULL, 0, 0 };
+	struct outputBuffer serialized = { NULL, 0, 0 };
+	struct outputBuffer transcoded = { NULL, 0, 0 };
+	int bOk = 1;
+
+	if((serializeTree(lpValue, 0, &minified) != cjsonE_Ok) || (serializeTree(lpValue, CJSON_SERIALIZER__FLAG__PRETTYPRINT, &serialized) != cjsonE_Ok)) {
+		printf("%s:%u Failed to serialize\n", __FILE__, dwLine);
+		bOk = 0;
+	} else if(transcode(minified.lpData, minified.dwUsed, CJSON_SERIALIZER__FLAG__PRETTYPRINT, 0, &transcoded) != cjsonE_Ok) {
+		printf("%s:%u Failed to transcode\n", __FILE__, dwLine);
+		bOk = 0;
+	} else if((transcoded.dwUsed != serialized.dwUsed) || (memcmp(transcoded.lpData, serialized.lpData, serialized.dwUsed) != 0)) {
+		printf("%s:%u Pretty output differs from the serializer\n", __FILE__, dwLine);
+		bOk = 0;
+	}
+
+	free(minified.lpData);
+	free(serialized.lpData);
+	free(transcoded.lpData);
+	return bOk;
+}
+static int expectSerializerLayoutText(const char* lpJson, unsigned int dwLine) {
+	struct cjsonValue* lpValue;
+	int bOk;
+
+	lpValue = parseText(lpJson, strlen(lpJson));
+	if(lpValue == NULL) {
+		printf("%s:%u Failed to parse\n", __FILE__, dwLine);
+		return 0;
+	}
+	bOk = expectSerializerLayout(lpValue, dwLine);
+	cjsonReleaseValue(lpValue);
+	return bOk;
+}
+
+static void buildDocument(struct outputBuffer* lpOut, unsigned long int dwRecords) {
+	unsigned long int i;
+	unsigned long int dwWritten;
+	char bRecord[256];
+
+	bufferWriter("[\n", 2, &dwWritten, (void*)lpOut);
+	for(i = 0; i < dwRecords; i=i+1) {
+		sprintf(bRecord, "%s  { \"id\": %lu, \"delta\": -%lu, \"ratio\": %lu.25e-3, \"name\": \"record \\\"%lu\\\" \\u00e4\", \"flags\": [true, false, null], \"empty\": {} }",
+			(i == 0) ? "" : ",\n", i * 977, i, i, i);
+		bufferWriter(bRecord, strlen(bRecord), &dwWritten, (void*)lpOut);
+	}
+	bufferWriter("\n]", 2, &dwWritten, (void*)lpOut);
+}
+
+int main(int argc, char* argv[]) {
+	struct outputBuffer document = { NULL, 0, 0 };
+	struct outputBuffer minified = { NULL, 0, 0 };
+	struct outputBuffer pretty = { NULL, 0, 0 };
+	struct outputBuffer again = { NULL, 0, 0 };
+	struct cjsonValue* lpOriginal;
+	struct cjsonValue* lpMinified;
+	struct cjsonValue* lpPretty;
+	struct cjsonSerializer* lpSerializer;
+	enum cjsonError e;
+	clock_t tStart;
+	double dTranscode, dParse, dMemcpy;
+	char* lpCopy;
+	int bOk = 1;
+
+	/* Minified output */
+	if(expectOutput("{ \"a\" : [ 1 , -0.5e+3 , \"x\\ny\" ] , \"b\" : { } , \"c\" : [ ] }", 0, "{\"a\":[1,-0.5e+3,\"x\\ny\"],\"b\":{},\"c\":[]}", __LINE__) == 0) { bOk = 0; }
+	if(expectOutput(" [true,false,null] ", 0, "[true,false,null]", __LINE__) == 0) { bOk = 0; }
+	if(expectOutput("\"\\u00E4\\/\"", 0, "\"\\u00E4\\/\"", __LINE__) == 0) { bOk = 0; }
+	if(expectOutput("  42 ", 0, "42", __LINE__) == 0) { bOk = 0; }
+	if(expectOutput("-0", 0, "-0", __LINE__) == 0) { bOk = 0; }
+	if(expectOutput("[[[[]]]]", 0, "[[[[]]]]", __LINE__) == 0) { bOk = 0; }
+
+	/* Pretty printing */
+	if(expectOutput("{\"a\":1,\"b\":[true,{}],\"c\":{\"d\":\"e\"}}", CJSON_SERIALIZER__FLAG__PRETTYPRINT,
+		"{\n\t\"a\":1,\n\t\"b\":[\n\ttrue,\n\t{\n\t\t}\n\t],\n\t\"c\":{\n\t\t\"d\":\"e\"\n\t}\n}", __LINE__) == 0) { bOk = 0; }
+	if(expectOutput("[]", CJSON_SERIALIZER__FLAG__PRETTYPRINT, "[\n\n]", __LINE__) == 0) { bOk = 0; }
+	if(expectOutput("{}", CJSON_SERIALIZER__FLAG__PRETTYPRINT, "{\n}", __LINE__) == 0) { bOk = 0; }
+	if(expectOutput("[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]]", CJSON_SERIALIZER__FLAG__PRETTYPRINT,
+		"[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t[\n\t1\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t]\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t]\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t]\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t]\n\t\t\t\t\t\t\t\t\t\t\t\t\t]\n\t\t\t\t\t\t\t\t\t\t\t\t]\n\t\t\t\t\t\t\t\t\t\t\t]\n\t\t\t\t\t\t\t\t\t\t]\n\t\t\t\t\t\t\t\t\t]\n\t\t\t\t\t\t\t\t]\n\t\t\t\t\t\t\t]\n\t\t\t\t\t\t]\n\t\t\t\t\t]\n\t\t\t\t]\n\t\t\t]\n\t\t]\n\t]\n]", __LINE__) == 0) { bOk = 0; }
+
+	/* Same layout as the serializer */
+	if(expectSerializerLayoutText("{\"a\":1,\"b\":[true,{}],\"c\":{\"d\":\"e\"}}", __LINE__) == 0) { bOk = 0; }
+	if(expectSerializerLayoutText("[[],{},[[1,2],[]],{\"x\":{}}]", __LINE__) == 0) { bOk = 0; }
+	if(expectSerializerLayoutText("[{\"a\":[1,{\"b\":null,\"c\":[\"d\"]}]}]", __LINE__) == 0) { bOk = 0; }
+	if(expectSerializerLayoutText("{}", __LINE__) == 0) { bOk = 0; }
+	if(expectSerializerLayoutText("[]", __LINE__) == 0) { bOk = 0; }
+
+	/* Streaming mode writes NDJSON */
+	if(expectOutput("{\"a\":1}\n[2] 3 \"x\"true", CJSON_TRANSCODER_FLAG__STREAMINGMODE, "{\"a\":1}\n[2]\n3\n\"x\"\ntrue\n", __LINE__) == 0) { bOk = 0; }
+	if(expectOutput("   ", CJSON_TRANSCODER_FLAG__STREAMINGMODE, "", __LINE__) == 0) { bOk = 0; }
+
+	/* Invalid input is rejected */
+	if(expectError("[1,]", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("{\"a\":1,}", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("{\"a\" 1}", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("{1:2}", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[1}", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("01", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[1.]", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[1e]", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[-]", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[tru]", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("\"a\\x\"", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("\"\\u12G4\"", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("\"a\tb\"", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[1,2", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("]", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[1 2", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[1 2]", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[1 x", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[[1 x]", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[\"a\" @", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[true null]", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("{\"a\":1 \"b\":2}", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("{\"a\":1]", 0, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+	if(expectError("[1] [2]", 0, cjsonE_AlreadyFinished, __LINE__) == 0) { bOk = 0; }
+	if(expectError("{\"a\":", CJSON_TRANSCODER_FLAG__STREAMINGMODE, cjsonE_EncodingError, __LINE__) == 0) { bOk = 0; }
+
+	/* Large document: both formats describe the same tree as the input */
+	buildDocument(&document, BENCH_RECORDS);
+	if(transcode(document.lpData, document.dwUsed, 0, 0, &minified) != cjsonE_Ok) { printf("%s:%u Failed to minify\n", __FILE__, __LINE__); bOk = 0; }
+	if(transcode(document.lpData, document.dwUsed, CJSON_SERIALIZER__FLAG__PRETTYPRINT, 0, &pretty) != cjsonE_Ok) { printf("%s:%u Failed to pretty print\n", __FILE__, __LINE__); bOk = 0; }
+	if(transcode(pretty.lpData, pretty.dwUsed, 0, 1, &again) != cjsonE_Ok) { printf("%s:%u Failed to minify bytewise\n", __FILE__, __LINE__); bOk = 0; }
+	if((again.dwUsed != minified.dwUsed) || (memcmp(again.lpData, minified.lpData, minified.dwUsed) != 0)) {
+		printf("%s:%u Minified pretty output differs\n", __FILE__, __LINE__);
+		bOk = 0;
+	}
+
+	lpOriginal = parseText(document.lpData, document.dwUsed);
+	lpMinified = parseText(minified.lpData, minified.dwUsed);
+	lpPretty = parseText(pretty.lpData, pretty.dwUsed);
+	if((lpOriginal == NULL) || (lpMinified == NULL) || (lpPretty == NULL)) {
+		printf("%s:%u Failed to parse\n", __FILE__, __LINE__);
+		bOk = 0;
+	} else if((cjsonValue_Equals(lpOriginal, lpMinified) == 0) || (cjsonValue_Equals(lpOriginal, lpPretty) == 0)) {
+		printf("%s:%u Transcoded documents differ\n", __FILE__, __LINE__);
+		bOk = 0;
+	}
+	if((lpOriginal != NULL) && (expectSerializerLayout(lpOriginal, __LINE__) == 0)) { bOk = 0; }
+
+	/* Compare against memcpy and against parsing and serializing the tree */
+	lpCopy = (char*)malloc(document.dwUsed);
+	tStart = clock();
+	memcpy(lpCopy, document.lpData, document.dwUsed);
+	dMemcpy = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+	free(lpCopy);
+
+	tStart = clock();
+	transcode(document.lpData, document.dwUsed, 0, 0, &minified);
+	dTranscode = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+
+	tStart = clock();
+	if(lpMinified != NULL) { cjsonReleaseValue(lpMinified); }
+	lpMinified = parseText(document.lpData, document.dwUsed);
+	again.dwUsed = 0;
+	e = cjsonSerializer_Create(&lpSerializer, &bufferWriter, (void*)&again, 0, NULL);
+	if((e == cjsonE_Ok) && (lpMinified != NULL)) {
+		e = cjsonSerializer_Serialize(lpSerializer, lpMinified);
+		cjsonSerializer_Release(lpSerializer);
+	}
+	dParse = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+	if(e != cjsonE_Ok) { printf("%s:%u Serializer failed\n", __FILE__, __LINE__); bOk = 0; }
+
+	printf("%s:%u %lu bytes: memcpy %.4fs, transcode %.4fs, parse and serialize %.4fs\n", __FILE__, __LINE__, document.dwUsed, dMemcpy, dTranscode, dParse);
+
+	if(lpOriginal != NULL) { cjsonReleaseValue(lpOriginal); }
+	if(lpMinified != NULL) { cjsonReleaseValue(lpMinified); }
+	if(lpPretty != NULL) { cjsonReleaseValue(lpPretty); }
+	free(document.lpData);
+	free(minified.lpData);
+	free(pretty.lpData);
+	free(again.lpData);
+
+	if(bOk != 0) {
+		printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+		return 0;
+	} else {
+		printf("%s:%u Failed\n", __FILE__, __LINE__);
+		return 1;
+	}
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
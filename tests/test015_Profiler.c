@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define PROFILER_THREADJOBS 64
+
+static const char* lpTestDocument = "{\"name\":\"profiler\",\"tags\":[\"a\",\"b\",\"c\"],\"nested\":{\"values\":[1,2,3,4.5,-6],\"flag\":true,\"empty\":null},\"text\":\"a somewhat longer string value\"}";
+
+static enum cjsonError documentReady(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpDocument;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError countingWriter(
+	char* lpData,
+	unsigned long int dwBytesToWrite,
+	unsigned long int* lpBytesWrittenOut,
+	void* lpFreeParam
+) {
+	(*((unsigned long int*)lpFreeParam)) += dwBytesToWrite;
+	(*lpBytesWrittenOut) = dwBytesToWrite;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError parseDocument(
+	struct cjsonSystemAPI* lpSystem,
+	struct cjsonValue** lpOut
+) {
+	struct cjsonParser* lpParser;
+	enum cjsonError e;
+	unsigned long int i;
+
+	(*lpOut) = NULL;
+	e = cjsonParserCreate(&lpParser, 0, &documentReady, (void*)lpOut, lpSystem);
+	if(e != cjsonE_Ok) { return e; }
+	for(i = 0; i < strlen(lpTestDocument); i=i+1) {
+		e = cjsonParserProcessByte(lpParser, lpTestDocument[i]);
+		if((e != cjsonE_Ok) && (e != cjsonE_Finished)) { break; }
+	}
+	cjsonParserRelease(lpParser);
+	if((*lpOut) == NULL) { return cjsonE_EncodingError; }
+	return cjsonE_Ok;
+}
+
+static void parseJob(
+	void* lpParam
+) {
+	struct cjsonValue* lpDocument;
+
+	if(parseDocument((struct cjsonSystemAPI*)lpParam, &lpDocument) == cjsonE_Ok) {
+		cjsonReleaseValue(lpDocument);
+	}
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonProfiler* lpProfiler;
+	struct cjsonProfiler* lpSampled;
+	struct cjsonProfiler_Stats stats;
+	struct cjsonProfiler_Stats sampledStats;
+	struct cjsonSerializer* lpSerializer;
+	struct cjsonWorkerPool* lpPool;
+	struct cjsonValue* lpDocument;
+	unsigned long int dwWritten = 0;
+	unsigned long long int qwTotal;
+	unsigned long long int qwSampledTotal;
+	unsigned long int i;
+	unsigned long int j;
+
+	e = cjsonProfiler_Create(&lpProfiler, 1, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create profiler (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(cjsonProfiler_FromSystem(cjsonProfiler_System(lpProfiler)) != lpProfiler) { printf("%s:%u FromSystem did not return the profiler\n", __FILE__, __LINE__); return 1; }
+	if(cjsonProfiler_FromSystem(NULL) != NULL) { printf("%s:%u FromSystem accepted NULL\n", __FILE__, __LINE__); return 1; }
+
+	printf("%s:%u Parsing and serializing with a profiler\n", __FILE__, __LINE__);
+	e = parseDocument(cjsonProfiler_System(lpProfiler), &lpDocument);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = cjsonSerializer_Create(&lpSerializer, &countingWriter, (void*)&dwWritten, 0, cjsonProfiler_System(lpProfiler));
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create serializer (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = cjsonSerializer_Serialize(lpSerializer, lpDocument);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to serialize (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonSerializer_Release(lpSerializer);
+
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.dwSampleRate != 1) { printf("%s:%u Unexpected sample rate %lu\n", __FILE__, __LINE__, stats.dwSampleRate); return 1; }
+	if(stats.qwLiveBytes == 0) { printf("%s:%u Document is not accounted as live\n", __FILE__, __LINE__); return 1; }
+	if(stats.sites[cjsonAllocSite__ObjectCreate].qwAllocations != 2) { printf("%s:%u Unexpected number of object allocations %llu\n", __FILE__, __LINE__, (unsigned long long int)stats.sites[cjsonAllocSite__ObjectCreate].qwAllocations); return 1; }
+	if(stats.sites[cjsonAllocSite__ObjectSet].qwAllocations != 7) { printf("%s:%u Unexpected number of object entries %llu\n", __FILE__, __LINE__, (unsigned long long int)stats.sites[cjsonAllocSite__ObjectSet].qwAllocations); return 1; }
+	if(stats.sites[cjsonAllocSite__String].qwAllocations < 5) { printf("%s:%u Strings have not been recorded\n", __FILE__, __LINE__); return 1; }
+	if(stats.sites[cjsonAllocSite__ArrayPush].qwAllocations == 0) { printf("%s:%u Array pages have not been recorded\n", __FILE__, __LINE__); return 1; }
+	if(stats.sites[cjsonAllocSite__ParserStack].qwAllocations == 0) { printf("%s:%u Parser stack has not been recorded\n", __FILE__, __LINE__); return 1; }
+	if(stats.sites[cjsonAllocSite__ParserStack].qwLiveBytes != 0) { printf("%s:%u Parser stack has not been released\n", __FILE__, __LINE__); return 1; }
+	if(stats.sites[cjsonAllocSite__SerializerStack].qwAllocations == 0) { printf("%s:%u Serializer stack has not been recorded\n", __FILE__, __LINE__); return 1; }
+	if(stats.sites[cjsonAllocSite__SerializerStack].qwPeakLiveBytes == 0) { printf("%s:%u Serializer peak has not been recorded\n", __FILE__, __LINE__); return 1; }
+
+	for(i = 0; i < cjsonAllocSite__Count; i=i+1) {
+		qwTotal = 0;
+		for(j = 0; j < CJSON_PROFILER_SIZECLASSES; j=j+1) { qwTotal = qwTotal + stats.sites[i].qwSizeClasses[j]; }
+		if(qwTotal != stats.sites[i].qwAllocations) { printf("%s:%u Size classes of site %s do not add up\n", __FILE__, __LINE__, cjsonProfiler_SiteName((enum cjsonAllocSite)i)); return 1; }
+		printf("%s:%u\t%-16s %6llu allocations %8llu bytes\n", __FILE__, __LINE__, cjsonProfiler_SiteName((enum cjsonAllocSite)i), (unsigned long long int)stats.sites[i].qwAllocations, (unsigned long long int)stats.sites[i].qwBytes);
+	}
+
+	cjsonReleaseValue(lpDocument);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.qwLiveBytes != 0) { printf("%s:%u %llu bytes are still live after release\n", __FILE__, __LINE__, (unsigned long long int)stats.qwLiveBytes); return 1; }
+	if(stats.qwPeakLiveBytes == 0) { printf("%s:%u Peak has not been recorded\n", __FILE__, __LINE__); return 1; }
+
+	/* Reset keeps nothing since nothing is live */
+	cjsonProfiler_Reset(lpProfiler);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if((stats.qwPeakLiveBytes != 0) || (stats.sites[cjsonAllocSite__String].qwAllocations != 0)) { printf("%s:%u Reset did not clear the counters\n", __FILE__, __LINE__); return 1; }
+
+	printf("%s:%u Parsing concurrently\n", __FILE__, __LINE__);
+	e = cjsonWorkerPool_Create(&lpPool, 4, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create worker pool (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < PROFILER_THREADJOBS; i=i+1) {
+		cjsonWorkerPool_SubmitDetached(lpPool, &parseJob, (void*)cjsonProfiler_System(lpProfiler));
+	}
+	cjsonWorkerPool_Release(lpPool);
+
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.qwLiveBytes != 0) { printf("%s:%u %llu bytes are still live after concurrent parsing\n", __FILE__, __LINE__, (unsigned long long int)stats.qwLiveBytes); return 1; }
+	if(stats.sites[cjsonAllocSite__ObjectCreate].qwAllocations != 2 * PROFILER_THREADJOBS) { printf("%s:%u Lost allocations while parsing concurrently (%llu)\n", __FILE__, __LINE__, (unsigned long long int)stats.sites[cjsonAllocSite__ObjectCreate].qwAllocations); return 1; }
+	if(stats.sites[cjsonAllocSite__ObjectCreate].qwFrees != 2 * PROFILER_THREADJOBS) { printf("%s:%u Lost frees while parsing concurrently (%llu)\n", __FILE__, __LINE__, (unsigned long long int)stats.sites[cjsonAllocSite__ObjectCreate].qwFrees); return 1; }
+
+	printf("%s:%u Sampling\n", __FILE__, __LINE__);
+	e = cjsonProfiler_Create(&lpSampled, 8, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create profiler (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < PROFILER_THREADJOBS; i=i+1) {
+		parseJob((void*)cjsonProfiler_System(lpSampled));
+	}
+	cjsonProfiler_GetStats(lpSampled, &sampledStats);
+	if(sampledStats.qwLiveBytes != 0) { printf("%s:%u %llu sampled bytes are still live\n", __FILE__, __LINE__, (unsigned long long int)sampledStats.qwLiveBytes); return 1; }
+	qwTotal = 0;
+	qwSampledTotal = 0;
+	for(i = 0; i < cjsonAllocSite__Count; i=i+1) {
+		qwTotal = qwTotal + stats.sites[i].qwAllocations;
+		qwSampledTotal = qwSampledTotal + sampledStats.sites[i].qwAllocations;
+	}
+	if((qwSampledTotal == 0) || (qwSampledTotal >= qwTotal)) { printf("%s:%u Sampled %llu of %llu allocations\n", __FILE__, __LINE__, qwSampledTotal, qwTotal); return 1; }
+	printf("%s:%u Sampled %llu of %llu allocations\n", __FILE__, __LINE__, qwSampledTotal, qwTotal);
+
+	cjsonProfiler_Release(lpSampled);
+	cjsonProfiler_Release(lpProfiler);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+static const char* lpTestDocuments = "{\"name\":\"stats\",\"list\":[1,-2,3.5,true,false,null,[[\"deep\"]]],\"empty\":{}}\n[42]\n\"text\"\n";
+
+static enum cjsonError documentReady(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((unsigned long int*)lpFreeParam)) += 1;
+	cjsonReleaseValue(lpDocument);
+	return cjsonE_Ok;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonParser* lpParser;
+	struct cjsonParser_Stats stats;
+	unsigned long int dwDocuments = 0;
+	unsigned long int i;
+
+	e = cjsonParserCreate(&lpParser, CJSON_PARSER_FLAG__STREAMINGMODE, &documentReady, (void*)&dwDocuments, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create parser (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(cjsonParser_GetStats(lpParser, &stats) != cjsonE_InvalidState) { printf("%s:%u Statistics available without being enabled\n", __FILE__, __LINE__); return 1; }
+	cjsonParserRelease(lpParser);
+
+	printf("%s:%u Parsing with statistics\n", __FILE__, __LINE__);
+	e = cjsonParserCreate(&lpParser, CJSON_PARSER_FLAG__STREAMINGMODE | CJSON_PARSER_FLAG__STATISTICS, &documentReady, (void*)&dwDocuments, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create parser (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < strlen(lpTestDocuments); i=i+1) {
+		e = cjsonParserProcessByte(lpParser, lpTestDocuments[i]);
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	}
+	e = cjsonParser_GetStats(lpParser, &stats);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to query statistics (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	if(stats.qwBytes != strlen(lpTestDocuments)) { printf("%s:%u Unexpected byte count %llu\n", __FILE__, __LINE__, (unsigned long long int)stats.qwBytes); return 1; }
+	if((stats.qwDocuments != 3) || (dwDocuments != 3)) { printf("%s:%u Unexpected document count %llu\n", __FILE__, __LINE__, (unsigned long long int)stats.qwDocuments); return 1; }
+	if(stats.qwKeys != 3) { printf("%s:%u Unexpected key count %llu\n", __FILE__, __LINE__, (unsigned long long int)stats.qwKeys); return 1; }
+	if(stats.qwValues[cjsonObject] != 2) { printf("%s:%u Unexpected object count %llu\n", __FILE__, __LINE__, (unsigned long long int)stats.qwValues[cjsonObject]); return 1; }
+	if(stats.qwValues[cjsonArray] != 4) { printf("%s:%u Unexpected array count %llu\n", __FILE__, __LINE__, (unsigned long long int)stats.qwValues[cjsonArray]); return 1; }
+	if(stats.qwValues[cjsonString] != 3) { printf("%s:%u Unexpected string count %llu\n", __FILE__, __LINE__, (unsigned long long int)stats.qwValues[cjsonString]); return 1; }
+	if((stats.qwValues[cjsonNumber_UnsignedLong] != 2) || (stats.qwValues[cjsonNumber_SignedLong] != 1) || (stats.qwValues[cjsonNumber_Double] != 1)) { printf("%s:%u Unexpected number counts\n", __FILE__, __LINE__); return 1; }
+	if((stats.qwValues[cjsonTrue] != 1) || (stats.qwValues[cjsonFalse] != 1) || (stats.qwValues[cjsonNull] != 1)) { printf("%s:%u Unexpected constant counts\n", __FILE__, __LINE__); return 1; }
+	if(stats.qwStringBytes != 4 + 5 + 4 + 5 + 4 + 4) { printf("%s:%u Unexpected string bytes %llu\n", __FILE__, __LINE__, (unsigned long long int)stats.qwStringBytes); return 1; }
+	if(stats.qwRedeliveries != 2 * 4) { printf("%s:%u Unexpected redeliveries %llu\n", __FILE__, __LINE__, (unsigned long long int)stats.qwRedeliveries); return 1; }
+	if(stats.dwMaxStateStackDepth != 5) { printf("%s:%u Unexpected maximum depth %lu\n", __FILE__, __LINE__, stats.dwMaxStateStackDepth); return 1; }
+	if(lpParser->dwStateStackDepth != 0) { printf("%s:%u State stack depth is %lu between documents\n", __FILE__, __LINE__, lpParser->dwStateStackDepth); return 1; }
+
+	for(i = 0; i < CJSON_PARSER_STATS_HANDLERS; i=i+1) {
+		printf("%s:%u\thandler %lu: %llu calls %llu cycles\n", __FILE__, __LINE__, i, (unsigned long long int)stats.qwHandlerCalls[i], (unsigned long long int)stats.qwHandlerCycles[i]);
+	}
+
+	cjsonParserRelease(lpParser);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define NDJSON_RECORDS 60000
+
+struct ndjsonResult {
+	unsigned long int dwDocuments;
+	unsigned long int dwNextId;
+	int bOutOfOrder;
+	unsigned char* lpSeen;
+};
+
+static unsigned long int recordId(
+	struct cjsonValue* lpDocument
+) {
+	struct cjsonValue* lpId;
+
+	if(lpDocument->type != cjsonObject) { return NDJSON_RECORDS; }
+	if(cjsonObject_Get(lpDocument, "id", 2, &lpId) != cjsonE_Ok) { return NDJSON_RECORDS; }
+	return cjsonObject_GetAsULong(lpId);
+}
+
+static enum cjsonError orderedReady(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	struct ndjsonResult* lpResult = (struct ndjsonResult*)lpFreeParam;
+
+	if(recordId(lpDocument) != lpResult->dwNextId) { lpResult->bOutOfOrder = 1; }
+	lpResult->dwNextId = lpResult->dwNextId + 1;
+	lpResult->dwDocuments = lpResult->dwDocuments + 1;
+	cjsonReleaseValue(lpDocument);
+	return cjsonE_Ok;
+}
+static enum cjsonError unorderedReady(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	struct ndjsonResult* lpResult = (struct ndjsonResult*)lpFreeParam;
+	unsigned long int dwId;
+
+	/* Called concurrently, every record only touches its own slot */
+	dwId = recordId(lpDocument);
+	if(dwId < NDJSON_RECORDS) { lpResult->lpSeen[dwId] = lpResult->lpSeen[dwId] + 1; }
+	cjsonReleaseValue(lpDocument);
+	return cjsonE_Ok;
+}
+
+static char* buildRecords(
+	unsigned long int* lpLengthOut
+) {
+	char* lpData;
+	unsigned long int dwUsed = 0;
+	unsigned long int i;
+
+	lpData = (char*)malloc(NDJSON_RECORDS * 128);
+	if(lpData == NULL) { return NULL; }
+	for(i = 0; i < NDJSON_RECORDS; i=i+1) {
+		if((i % 1000) == 999) {
+			/* The parser tolerates raw newlines inside strings, they must not be used as boundary */
+			dwUsed = dwUsed + sprintf(&(lpData[dwUsed]), "{\"id\":%lu,\"msg\":\"line\nbreak \\\"quoted\\\\\"}\n", i);
+		} else {
+			dwUsed = dwUsed + sprintf(&(lpData[dwUsed]), "{\"id\":%lu,\"msg\":\"record \\\"%lu\\\"\",\"tags\":[\"a\",\"b\"],\"v\":%lu.5}\n", i, i, i % 97);
+		}
+	}
+	(*lpLengthOut) = dwUsed;
+	return lpData;
+}
+
+/*
+	Copy of the records with a linebreak after the id of one record,
+	the record is valid JSON but spans two lines
+*/
+static char* splitRecord(
+	const char* lpData,
+	unsigned long int dwLength,
+	unsigned long int dwRecord,
+	unsigned long int* lpLengthOut
+) {
+	char* lpSplit;
+	char bPrefix[32];
+	const char* lpRecord;
+	unsigned long int dwOffset;
+
+	sprintf(bPrefix, "{\"id\":%lu,", dwRecord);
+	lpRecord = strstr(lpData, bPrefix);
+	if(lpRecord == NULL) { return NULL; }
+	dwOffset = (unsigned long int)(lpRecord - lpData) + strlen(bPrefix);
+
+	lpSplit = (char*)malloc(dwLength + 1);
+	if(lpSplit == NULL) { return NULL; }
+	memcpy(lpSplit, lpData, dwOffset);
+	lpSplit[dwOffset] = '\n';
+	memcpy(&(lpSplit[dwOffset + 1]), &(lpData[dwOffset]), dwLength - dwOffset);
+	(*lpLengthOut) = dwLength + 1;
+	return lpSplit;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonWorkerPool* lpPool;
+	struct ndjsonResult result;
+	unsigned long int dwLength;
+	unsigned long int dwSplitLength;
+	unsigned long int i;
+	char* lpData;
+	char* lpSplit;
+	clock_t tStart;
+
+	lpData = buildRecords(&dwLength);
+	if(lpData == NULL) { printf("%s:%u Out of memory\n", __FILE__, __LINE__); return 1; }
+
+	e = cjsonWorkerPool_Create(&lpPool, 4, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create worker pool (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	printf("%s:%u Parsing %lu bytes sequentially\n", __FILE__, __LINE__, dwLength);
+	memset(&result, 0, sizeof(result));
+	tStart = clock();
+	e = cjsonParallelParser_ParseNdjson(lpData, dwLength, CJSON_PARALLELPARSER_FLAG__ORDERED, &orderedReady, (void*)&result, NULL, NULL);
+	printf("%s:%u\t%lf seconds CPU\n", __FILE__, __LINE__, (double)(clock() - tStart) / CLOCKS_PER_SEC);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if((result.dwDocuments != NDJSON_RECORDS) || (result.bOutOfOrder != 0)) { printf("%s:%u Received %lu documents (out of order: %d)\n", __FILE__, __LINE__, result.dwDocuments, result.bOutOfOrder); return 1; }
+
+	printf("%s:%u Parsing in parallel, ordered\n", __FILE__, __LINE__);
+	memset(&result, 0, sizeof(result));
+	tStart = clock();
+	e = cjsonParallelParser_ParseNdjson(lpData, dwLength, CJSON_PARALLELPARSER_FLAG__ORDERED, &orderedReady, (void*)&result, lpPool, NULL);
+	printf("%s:%u\t%lf seconds CPU\n", __FILE__, __LINE__, (double)(clock() - tStart) / CLOCKS_PER_SEC);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if((result.dwDocuments != NDJSON_RECORDS) || (result.bOutOfOrder != 0)) { printf("%s:%u Received %lu documents (out of order: %d)\n", __FILE__, __LINE__, result.dwDocuments, result.bOutOfOrder); return 1; }
+
+	printf("%s:%u Parsing in parallel, unordered\n", __FILE__, __LINE__);
+	memset(&result, 0, sizeof(result));
+	result.lpSeen = (unsigned char*)calloc(NDJSON_RECORDS, 1);
+	if(result.lpSeen == NULL) { printf("%s:%u Out of memory\n", __FILE__, __LINE__); return 1; }
+	e = cjsonParallelParser_ParseNdjson(lpData, dwLength, 0, &unorderedReady, (void*)&result, lpPool, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < NDJSON_RECORDS; i=i+1) {
+		if(result.lpSeen[i] != 1) { printf("%s:%u Record %lu delivered %u times\n", __FILE__, __LINE__, i, (unsigned int)result.lpSeen[i]); return 1; }
+	}
+	free(result.lpSeen);
+
+	printf("%s:%u Parsing a truncated record\n", __FILE__, __LINE__);
+	memset(&result, 0, sizeof(result));
+	e = cjsonParallelParser_ParseNdjson(lpData, dwLength - 10, CJSON_PARALLELPARSER_FLAG__ORDERED, &orderedReady, (void*)&result, lpPool, NULL);
+	if(e != cjsonE_EncodingError) { printf("%s:%u Truncated input has not been rejected (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	printf("%s:%u Parsing a trailing number without newline\n", __FILE__, __LINE__);
+	memset(&result, 0, sizeof(result));
+	e = cjsonParallelParser_ParseNdjson("{\"id\":0}\n1", 10, CJSON_PARALLELPARSER_FLAG__ORDERED, &orderedReady, (void*)&result, lpPool, NULL);
+	if((e != cjsonE_Ok) || (result.dwDocuments != 2)) { printf("%s:%u Failed to parse trailing number (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	/*
+		A record spanning two lines is rejected no matter whether the
+		linebreak is inside a chunk or the buffer is a single chunk
+	*/
+	printf("%s:%u Parsing a record spanning two lines\n", __FILE__, __LINE__);
+	for(i = 1; i < NDJSON_RECORDS; i = i + NDJSON_RECORDS / 4) {
+		lpSplit = splitRecord(lpData, dwLength, i, &dwSplitLength);
+		if(lpSplit == NULL) { printf("%s:%u Failed to build input\n", __FILE__, __LINE__); return 1; }
+
+		memset(&result, 0, sizeof(result));
+		e = cjsonParallelParser_ParseNdjson(lpSplit, dwSplitLength, CJSON_PARALLELPARSER_FLAG__ORDERED, &orderedReady, (void*)&result, NULL, NULL);
+		if(e != cjsonE_EncodingError) { printf("%s:%u Record %lu spanning lines accepted in a single chunk (code %u)\n", __FILE__, __LINE__, i, e); return 1; }
+
+		memset(&result, 0, sizeof(result));
+		e = cjsonParallelParser_ParseNdjson(lpSplit, dwSplitLength, CJSON_PARALLELPARSER_FLAG__ORDERED, &orderedReady, (void*)&result, lpPool, NULL);
+		if(e != cjsonE_EncodingError) { printf("%s:%u Record %lu spanning lines accepted in parallel (code %u)\n", __FILE__, __LINE__, i, e); return 1; }
+
+		free(lpSplit);
+	}
+	memset(&result, 0, sizeof(result));
+	e = cjsonParallelParser_ParseNdjson("{\"id\":0,\n\"v\":1}\n", 16, CJSON_PARALLELPARSER_FLAG__ORDERED, &orderedReady, (void*)&result, lpPool, NULL);
+	if(e != cjsonE_EncodingError) { printf("%s:%u Short record spanning lines accepted (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	cjsonWorkerPool_Release(lpPool);
+	free(lpData);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
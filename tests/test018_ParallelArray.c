@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define ARRAY_ELEMENTS 50000
+
+struct arrayResult {
+	unsigned long int dwElements;
+	unsigned long int dwNextId;
+	int bOutOfOrder;
+	unsigned char* lpSeen;
+};
+
+static enum cjsonError documentReady(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpDocument;
+	return cjsonE_Ok;
+}
+
+static unsigned long int elementId(
+	struct cjsonValue* lpElement
+) {
+	struct cjsonValue* lpId;
+
+	if(lpElement->type != cjsonObject) { return ARRAY_ELEMENTS; }
+	if(cjsonObject_Get(lpElement, "id", 2, &lpId) != cjsonE_Ok) { return ARRAY_ELEMENTS; }
+	return cjsonObject_GetAsULong(lpId);
+}
+
+static enum cjsonError orderedReady(
+	struct cjsonValue* lpElement,
+	void* lpFreeParam
+) {
+	struct arrayResult* lpResult = (struct arrayResult*)lpFreeParam;
+
+	if(elementId(lpElement) != lpResult->dwNextId) { lpResult->bOutOfOrder = 1; }
+	lpResult->dwNextId = lpResult->dwNextId + 1;
+	lpResult->dwElements = lpResult->dwElements + 1;
+	cjsonReleaseValue(lpElement);
+	return cjsonE_Ok;
+}
+static enum cjsonError unorderedReady(
+	struct cjsonValue* lpElement,
+	void* lpFreeParam
+) {
+	struct arrayResult* lpResult = (struct arrayResult*)lpFreeParam;
+	unsigned long int dwId;
+
+	/* Called concurrently, every element only touches its own slot */
+	dwId = elementId(lpElement);
+	if(dwId < ARRAY_ELEMENTS) { lpResult->lpSeen[dwId] = lpResult->lpSeen[dwId] + 1; }
+	cjsonReleaseValue(lpElement);
+	return cjsonE_Ok;
+}
+
+static char* buildArray(
+	unsigned long int* lpLengthOut
+) {
+	char* lpData;
+	unsigned long int dwUsed = 0;
+	unsigned long int i;
+
+	lpData = (char*)malloc(ARRAY_ELEMENTS * 128 + 16);
+	if(lpData == NULL) { return NULL; }
+	dwUsed = dwUsed + sprintf(&(lpData[dwUsed]), " \n[");
+	for(i = 0; i < ARRAY_ELEMENTS; i=i+1) {
+		/* Commas and brackets inside strings and nested containers must not be used as boundary */
+		dwUsed = dwUsed + sprintf(&(lpData[dwUsed]), "%s{\"id\":%lu,\"msg\":\"a, [b], {c} \\\"%lu,\\\\\",\"nested\":[[1,2],{\"k\":[3,\",\"]}]}", (i == 0) ? "" : ((i % 7) == 0) ? ",\n\t" : ",", i, i);
+	}
+	dwUsed = dwUsed + sprintf(&(lpData[dwUsed]), "]\n");
+	(*lpLengthOut) = dwUsed;
+	return lpData;
+}
+
+static enum cjsonError parseSequential(
+	const char* lpData,
+	unsigned long int dwLength,
+	struct cjsonValue** lpOut
+) {
+	struct cjsonParser* lpParser;
+	enum cjsonError e = cjsonE_Ok;
+	unsigned long int i;
+
+	(*lpOut) = NULL;
+	e = cjsonParserCreate(&lpParser, 0, &documentReady, (void*)lpOut, NULL);
+	if(e != cjsonE_Ok) { return e; }
+	for(i = 0; i < dwLength; i=i+1) {
+		e = cjsonParserProcessByte(lpParser, lpData[i]);
+		if(e != cjsonE_Ok) { break; }
+	}
+	cjsonParserRelease(lpParser);
+	if((*lpOut) == NULL) { return cjsonE_EncodingError; }
+	return cjsonE_Ok;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonWorkerPool* lpPool;
+	struct cjsonValue* lpExpected;
+	struct cjsonValue* lpArray;
+	struct arrayResult result;
+	unsigned long int dwLength;
+	unsigned long int i;
+	char* lpData;
+	char* lpStray;
+	clock_t tStart;
+	static const char* lpInvalid[] = { "", "[", "{}", "[1,]", "[,1]", "[\"open]", "[[1]", "[1]]" };
+
+	lpData = buildArray(&dwLength);
+	if(lpData == NULL) { printf("%s:%u Out of memory\n", __FILE__, __LINE__); return 1; }
+
+	e = cjsonWorkerPool_Create(&lpPool, 4, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create worker pool (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	printf("%s:%u Parsing %lu bytes sequentially\n", __FILE__, __LINE__, dwLength);
+	tStart = clock();
+	e = parseSequential(lpData, dwLength, &lpExpected);
+	printf("%s:%u\t%lf seconds CPU\n", __FILE__, __LINE__, (double)(clock() - tStart) / CLOCKS_PER_SEC);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	printf("%s:%u Parsing in parallel into one array\n", __FILE__, __LINE__);
+	tStart = clock();
+	e = cjsonParallelParser_ParseArray(lpData, dwLength, 0, &lpArray, NULL, NULL, lpPool, NULL);
+	printf("%s:%u\t%lf seconds CPU\n", __FILE__, __LINE__, (double)(clock() - tStart) / CLOCKS_PER_SEC);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(cjsonArray_Length(lpArray) != ARRAY_ELEMENTS) { printf("%s:%u Received %lu elements\n", __FILE__, __LINE__, cjsonArray_Length(lpArray)); return 1; }
+	if(cjsonValue_Equals(lpArray, lpExpected) == 0) { printf("%s:%u Stitched array differs from sequential result\n", __FILE__, __LINE__); return 1; }
+	cjsonReleaseValue(lpArray);
+
+	printf("%s:%u Parsing without worker pool\n", __FILE__, __LINE__);
+	e = cjsonParallelParser_ParseArray(lpData, dwLength, 0, &lpArray, NULL, NULL, NULL, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(cjsonValue_Equals(lpArray, lpExpected) == 0) { printf("%s:%u Array differs from sequential result\n", __FILE__, __LINE__); return 1; }
+	cjsonReleaseValue(lpArray);
+	cjsonReleaseValue(lpExpected);
+
+	printf("%s:%u Streaming elements, ordered\n", __FILE__, __LINE__);
+	memset(&result, 0, sizeof(result));
+	e = cjsonParallelParser_ParseArray(lpData, dwLength, CJSON_PARALLELPARSER_FLAG__ORDERED, NULL, &orderedReady, (void*)&result, lpPool, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if((result.dwElements != ARRAY_ELEMENTS) || (result.bOutOfOrder != 0)) { printf("%s:%u Received %lu elements (out of order: %d)\n", __FILE__, __LINE__, result.dwElements, result.bOutOfOrder); return 1; }
+
+	printf("%s:%u Streaming elements, unordered\n", __FILE__, __LINE__);
+	memset(&result, 0, sizeof(result));
+	result.lpSeen = (unsigned char*)calloc(ARRAY_ELEMENTS, 1);
+	if(result.lpSeen == NULL) { printf("%s:%u Out of memory\n", __FILE__, __LINE__); return 1; }
+	e = cjsonParallelParser_ParseArray(lpData, dwLength, 0, NULL, &unorderedReady, (void*)&result, lpPool, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < ARRAY_ELEMENTS; i=i+1) {
+		if(result.lpSeen[i] != 1) { printf("%s:%u Element %lu delivered %u times\n", __FILE__, __LINE__, i, (unsigned int)result.lpSeen[i]); return 1; }
+	}
+	free(result.lpSeen);
+
+	printf("%s:%u Parsing a truncated array\n", __FILE__, __LINE__);
+	e = cjsonParallelParser_ParseArray(lpData, dwLength - 3, 0, &lpArray, NULL, NULL, lpPool, NULL);
+	if(e != cjsonE_EncodingError) { printf("%s:%u Truncated input has not been rejected (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	printf("%s:%u Parsing a stray comma in a large array\n", __FILE__, __LINE__);
+	lpStray = strstr(&(lpData[dwLength / 2]), ",\n\t{");
+	lpStray[1] = ',';
+	e = cjsonParallelParser_ParseArray(lpData, dwLength, 0, &lpArray, NULL, NULL, lpPool, NULL);
+	if(e != cjsonE_EncodingError) { printf("%s:%u Damaged input has not been rejected (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	printf("%s:%u Parsing small arrays\n", __FILE__, __LINE__);
+	e = cjsonParallelParser_ParseArray(" [ ] ", 5, 0, &lpArray, NULL, NULL, lpPool, NULL);
+	if((e != cjsonE_Ok) || (cjsonArray_Length(lpArray) != 0)) { printf("%s:%u Failed to parse empty array (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonReleaseValue(lpArray);
+	e = cjsonParallelParser_ParseArray("[1,\"two\",3.5]", 13, 0, &lpArray, NULL, NULL, lpPool, NULL);
+	if((e != cjsonE_Ok) || (cjsonArray_Length(lpArray) != 3)) { printf("%s:%u Failed to parse small array (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonReleaseValue(lpArray);
+	for(i = 0; i < sizeof(lpInvalid) / sizeof(lpInvalid[0]); i=i+1) {
+		e = cjsonParallelParser_ParseArray(lpInvalid[i], strlen(lpInvalid[i]), 0, &lpArray, NULL, NULL, lpPool, NULL);
+		if(e == cjsonE_Ok) { printf("%s:%u Invalid array %s has been accepted\n", __FILE__, __LINE__, lpInvalid[i]); return 1; }
+	}
+
+	cjsonWorkerPool_Release(lpPool);
+	free(lpData);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+static const char* lpTestDocument = "{\"name\":\"reset\",\"list\":[1,-2,3.5,true,false,null,[[\"deep\"]]],\"nested\":{\"text\":\"some longer string value\"}}";
+
+static enum cjsonError documentReady(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpDocument;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError feed(
+	struct cjsonParser* lpParser,
+	const char* lpData,
+	unsigned long int dwLength
+) {
+	enum cjsonError e = cjsonE_Ok;
+	unsigned long int i;
+
+	for(i = 0; i < dwLength; i=i+1) {
+		e = cjsonParserProcessByte(lpParser, lpData[i]);
+		if(e != cjsonE_Ok) { break; }
+	}
+	return e;
+}
+
+static unsigned long long int scratchAllocations(
+	struct cjsonProfiler* lpProfiler
+) {
+	struct cjsonProfiler_Stats stats;
+
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	return stats.sites[cjsonAllocSite__ParserStack].qwAllocations + stats.sites[cjsonAllocSite__ParserBuffer].qwAllocations;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonProfiler* lpProfiler;
+	struct cjsonProfiler_Stats stats;
+	struct cjsonParser_Stats parserStats;
+	struct cjsonParser* lpParser;
+	struct cjsonParser* lpPooled;
+	struct cjsonParser* lpOther;
+	struct cjsonValue* lpDocument = NULL;
+	unsigned long long int qwScratch;
+	unsigned long int dwLongLength;
+	char* lpLong;
+
+	e = cjsonProfiler_Create(&lpProfiler, 1, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create profiler (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	printf("%s:%u Parsing, resetting and parsing again\n", __FILE__, __LINE__);
+	e = cjsonParserCreate(&lpParser, CJSON_PARSER_FLAG__STATISTICS, &documentReady, (void*)&lpDocument, cjsonProfiler_System(lpProfiler));
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create parser (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = feed(lpParser, lpTestDocument, strlen(lpTestDocument));
+	if((e != cjsonE_Ok) || (lpDocument == NULL)) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonReleaseValue(lpDocument); lpDocument = NULL;
+	if(cjsonParserProcessByte(lpParser, '[') != cjsonE_AlreadyFinished) { printf("%s:%u Parser accepted a second document\n", __FILE__, __LINE__); return 1; }
+
+	e = cjsonParserReset(lpParser);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to reset (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonParser_GetStats(lpParser, &parserStats);
+	if(parserStats.qwBytes != 0) { printf("%s:%u Statistics have not been cleared\n", __FILE__, __LINE__); return 1; }
+
+	qwScratch = scratchAllocations(lpProfiler);
+	e = feed(lpParser, lpTestDocument, strlen(lpTestDocument));
+	if((e != cjsonE_Ok) || (lpDocument == NULL)) { printf("%s:%u Failed to parse after reset (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonReleaseValue(lpDocument); lpDocument = NULL;
+
+	/* Object keys are copied per key, everything else has to come from the free lists */
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.sites[cjsonAllocSite__ParserStack].qwAllocations == 0) { printf("%s:%u State stack has not been recorded\n", __FILE__, __LINE__); return 1; }
+	if(scratchAllocations(lpProfiler) - qwScratch != 4) { printf("%s:%u Warm parser allocated %llu scratch blocks\n", __FILE__, __LINE__, scratchAllocations(lpProfiler) - qwScratch); return 1; }
+
+	printf("%s:%u Resetting in the middle of a document\n", __FILE__, __LINE__);
+	cjsonParserReset(lpParser);
+	e = feed(lpParser, lpTestDocument, strlen(lpTestDocument) / 2);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonParserReset(lpParser);
+	if((lpParser->lpStateStack != NULL) || (lpParser->dwStateStackDepth != 0)) { printf("%s:%u Reset did not drop the partial document\n", __FILE__, __LINE__); return 1; }
+	e = feed(lpParser, lpTestDocument, strlen(lpTestDocument));
+	if((e != cjsonE_Ok) || (lpDocument == NULL)) { printf("%s:%u Failed to parse after reset (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonReleaseValue(lpDocument); lpDocument = NULL;
+
+	printf("%s:%u Parsing a string longer than the kept pages\n", __FILE__, __LINE__);
+	dwLongLength = 64 * 1024;
+	lpLong = (char*)malloc(dwLongLength);
+	if(lpLong == NULL) { printf("%s:%u Out of memory\n", __FILE__, __LINE__); return 1; }
+	memset(lpLong, 'x', dwLongLength);
+	lpLong[0] = '"';
+	lpLong[dwLongLength - 1] = '"';
+	cjsonParserReset(lpParser);
+	e = feed(lpParser, lpLong, dwLongLength);
+	if((e != cjsonE_Ok) || (lpDocument == NULL) || (cjsonString_Strlen(lpDocument) != dwLongLength - 2)) { printf("%s:%u Failed to parse long string (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonReleaseValue(lpDocument); lpDocument = NULL;
+	free(lpLong);
+
+	cjsonParserRelease(lpParser);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.qwLiveBytes != 0) { printf("%s:%u %llu bytes are still live after release\n", __FILE__, __LINE__, (unsigned long long int)stats.qwLiveBytes); return 1; }
+
+	printf("%s:%u Using the thread local parser pool\n", __FILE__, __LINE__);
+	e = cjsonParserPool_Acquire(&lpPooled, 0, &documentReady, (void*)&lpDocument, cjsonProfiler_System(lpProfiler));
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to acquire parser (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = feed(lpPooled, lpTestDocument, strlen(lpTestDocument));
+	if((e != cjsonE_Ok) || (lpDocument == NULL)) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonReleaseValue(lpDocument); lpDocument = NULL;
+	cjsonParserPool_Return(lpPooled);
+
+	e = cjsonParserPool_Acquire(&lpParser, 0, &documentReady, (void*)&lpDocument, cjsonProfiler_System(lpProfiler));
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to acquire parser (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(lpParser != lpPooled) { printf("%s:%u Returned parser has not been reused\n", __FILE__, __LINE__); return 1; }
+	e = cjsonParserPool_Acquire(&lpOther, 0, &documentReady, (void*)&lpDocument, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to acquire parser (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(lpOther == lpParser) { printf("%s:%u Parser handed out twice\n", __FILE__, __LINE__); return 1; }
+
+	qwScratch = scratchAllocations(lpProfiler);
+	e = feed(lpParser, lpTestDocument, strlen(lpTestDocument));
+	if((e != cjsonE_Ok) || (lpDocument == NULL)) { printf("%s:%u Failed to parse with pooled parser (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonReleaseValue(lpDocument); lpDocument = NULL;
+	if(scratchAllocations(lpProfiler) - qwScratch != 4) { printf("%s:%u Pooled parser allocated %llu scratch blocks\n", __FILE__, __LINE__, scratchAllocations(lpProfiler) - qwScratch); return 1; }
+
+	cjsonParserPool_Return(lpParser);
+	cjsonParserPool_Return(lpOther);
+	cjsonParserPool_Flush();
+
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.qwLiveBytes != 0) { printf("%s:%u %llu bytes are still live after flushing the pool\n", __FILE__, __LINE__, (unsigned long long int)stats.qwLiveBytes); return 1; }
+	cjsonProfiler_Release(lpProfiler);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
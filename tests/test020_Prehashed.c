@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+static const char* lpTestDocument = "{\"user_id\":42,\"name\":\"hash\",\"esc\\\"aped\":true,\"uni\\u00e9\":null,\"nested\":{\"user_id\":7}}";
+
+static enum cjsonError documentReady(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpDocument;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError checkHashes(
+	char* lpKey,
+	unsigned long int dwKeyLength,
+	struct cjsonValue* lpValue,
+	void* lpFreeParam
+) {
+	struct cjsonValue* lpObject = (struct cjsonValue*)lpFreeParam;
+	struct cjsonObject_BucketEntry* lpEntry;
+
+	lpEntry = cjsonObject_FindEntry(lpObject, lpKey, dwKeyLength);
+	if(lpEntry == NULL) { return cjsonE_ImplementationError; }
+	if(lpEntry->dwKeyHash != cjsonObject_HashKey(lpKey, dwKeyLength)) { return cjsonE_ImplementationError; }
+	if(lpValue->type == cjsonObject) { return cjsonObject_Iterate(lpValue, &checkHashes, (void*)lpValue); }
+	return cjsonE_Ok;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonParser* lpParser;
+	struct cjsonValue* lpDocument = NULL;
+	struct cjsonValue* lpObject;
+	struct cjsonValue* lpValue;
+	struct cjsonValue* lpNumber;
+	uint32_t dwUserId;
+	char bKey[16];
+	unsigned long int i;
+
+	printf("%s:%u Parsing with hashes computed while scanning\n", __FILE__, __LINE__);
+	e = cjsonParserCreate(&lpParser, 0, &documentReady, (void*)&lpDocument, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create parser (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < strlen(lpTestDocument); i=i+1) {
+		e = cjsonParserProcessByte(lpParser, lpTestDocument[i]);
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	}
+	cjsonParserRelease(lpParser);
+	if(lpDocument == NULL) { printf("%s:%u No document\n", __FILE__, __LINE__); return 1; }
+
+	/* Escaped keys are hashed after decoding */
+	e = cjsonObject_Iterate(lpDocument, &checkHashes, (void*)lpDocument);
+	if(e != cjsonE_Ok) { printf("%s:%u Key hash of the parser differs from cjsonObject_HashKey\n", __FILE__, __LINE__); return 1; }
+	if(cjsonObject_HasKey(lpDocument, "esc\"aped", 8) != cjsonE_Ok) { printf("%s:%u Escaped key not found\n", __FILE__, __LINE__); return 1; }
+
+	printf("%s:%u Looking up prehashed keys\n", __FILE__, __LINE__);
+	dwUserId = cjsonObject_HashKey("user_id", 7);
+	if(dwUserId != cjsonReader_HashKey("user_id", 7)) { printf("%s:%u Reader and object hashes differ\n", __FILE__, __LINE__); return 1; }
+	e = cjsonObject_GetPrehashed(lpDocument, "user_id", 7, dwUserId, &lpValue);
+	if((e != cjsonE_Ok) || (cjsonObject_GetAsULong(lpValue) != 42)) { printf("%s:%u Prehashed lookup failed (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = cjsonObject_Get(lpDocument, "nested", 6, &lpObject);
+	if(e != cjsonE_Ok) { printf("%s:%u Nested object not found\n", __FILE__, __LINE__); return 1; }
+	e = cjsonObject_GetPrehashed(lpObject, "user_id", 7, dwUserId, &lpValue);
+	if((e != cjsonE_Ok) || (cjsonObject_GetAsULong(lpValue) != 7)) { printf("%s:%u Prehashed lookup in another object failed (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = cjsonObject_GetPrehashed(lpDocument, "user_ie", 7, dwUserId, &lpValue);
+	if(e != cjsonE_IndexOutOfBounds) { printf("%s:%u Matching hash with different key has been accepted\n", __FILE__, __LINE__); return 1; }
+	cjsonReleaseValue(lpDocument);
+
+	printf("%s:%u Inserting prehashed keys\n", __FILE__, __LINE__);
+	e = cjsonObject_CreateSized(&lpObject, 4, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create object (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < 1000; i=i+1) {
+		sprintf(bKey, "key%lu", i);
+		e = cjsonNumber_Create(&lpNumber, NULL);
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to create number (code %u)\n", __FILE__, __LINE__, e); return 1; }
+		cjsonNumber_SetULong(lpNumber, i);
+		e = cjsonObject_SetPrehashed(lpObject, bKey, strlen(bKey), cjsonObject_HashKey(bKey, strlen(bKey)), lpNumber);
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to insert (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	}
+	for(i = 0; i < 1000; i=i+1) {
+		sprintf(bKey, "key%lu", i);
+		e = cjsonObject_Get(lpObject, bKey, strlen(bKey), &lpValue);
+		if((e != cjsonE_Ok) || (cjsonObject_GetAsULong(lpValue) != i)) { printf("%s:%u Lost key %s\n", __FILE__, __LINE__, bKey); return 1; }
+	}
+	cjsonReleaseValue(lpObject);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define KEYHANDLES_LOOKUPS 1000000
+
+static enum cjsonError fillObject(
+	struct cjsonValue* lpObject,
+	unsigned long int dwCount
+) {
+	enum cjsonError e;
+	struct cjsonValue* lpNumber;
+	char bKey[32];
+	unsigned long int i;
+
+	for(i = 0; i < dwCount; i=i+1) {
+		sprintf(bKey, "field%lu", i);
+		e = cjsonNumber_Create(&lpNumber, NULL);
+		if(e != cjsonE_Ok) { return e; }
+		cjsonNumber_SetULong(lpNumber, i);
+		e = cjsonObject_Set(lpObject, bKey, strlen(bKey), lpNumber);
+		if(e != cjsonE_Ok) { return e; }
+	}
+	return cjsonE_Ok;
+}
+
+static int checkBatch(
+	struct cjsonValue* lpObject,
+	unsigned long int dwElements
+) {
+	struct cjsonKey keys[4];
+	struct cjsonValue* values[4];
+	enum cjsonError e;
+
+	cjsonKey_Init(&(keys[0]), "field3", 6);
+	cjsonKey_Init(&(keys[1]), "field0", 6);
+	cjsonKey_Init(&(keys[2]), "field1", 6);
+	cjsonKey_Init(&(keys[3]), "field2", 6);
+	e = cjsonObject_GetKeys(lpObject, keys, 3, values);
+	if(e != cjsonE_Ok) { printf("%s:%u Batch lookup on %lu elements failed (code %u)\n", __FILE__, __LINE__, dwElements, e); return 1; }
+	if((cjsonObject_GetAsULong(values[0]) != 3) || (cjsonObject_GetAsULong(values[1]) != 0) || (cjsonObject_GetAsULong(values[2]) != 1)) { printf("%s:%u Batch lookup on %lu elements returned wrong values\n", __FILE__, __LINE__, dwElements); return 1; }
+
+	cjsonKey_Init(&(keys[1]), "missing", 7);
+	e = cjsonObject_GetKeys(lpObject, keys, 4, values);
+	if(e != cjsonE_IndexOutOfBounds) { printf("%s:%u Missing key has not been reported (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if((values[1] != NULL) || (cjsonObject_GetAsULong(values[0]) != 3) || (cjsonObject_GetAsULong(values[3]) != 2)) { printf("%s:%u Batch lookup with missing key returned wrong values\n", __FILE__, __LINE__); return 1; }
+	return 0;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonValue* lpObject;
+	struct cjsonValue* lpValue;
+	struct cjsonValue* lpNumber;
+	struct cjsonKey userId;
+	unsigned long int dwSum;
+	unsigned long int i;
+	clock_t tStart;
+
+	e = cjsonObject_Create(&lpObject, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create object (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = fillObject(lpObject, 8);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to fill object (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	printf("%s:%u Using key handles\n", __FILE__, __LINE__);
+	cjsonKey_Init(&userId, "user_id", 7);
+	if(cjsonObject_ContainsKey(lpObject, &userId) != cjsonE_IndexOutOfBounds) { printf("%s:%u Key reported before it has been set\n", __FILE__, __LINE__); return 1; }
+	e = cjsonNumber_Create(&lpNumber, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create number (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonNumber_SetULong(lpNumber, 1234);
+	e = cjsonObject_SetKey(lpObject, &userId, lpNumber);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to set key (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(cjsonObject_ContainsKey(lpObject, &userId) != cjsonE_Ok) { printf("%s:%u Key not found\n", __FILE__, __LINE__); return 1; }
+	if((cjsonObject_Get(lpObject, "user_id", 7, &lpValue) != cjsonE_Ok) || (cjsonObject_GetAsULong(lpValue) != 1234)) { printf("%s:%u Key handle and plain key differ\n", __FILE__, __LINE__); return 1; }
+
+	tStart = clock();
+	dwSum = 0;
+	for(i = 0; i < KEYHANDLES_LOOKUPS; i=i+1) {
+		cjsonObject_Get(lpObject, "user_id", 7, &lpValue);
+		dwSum = dwSum + cjsonObject_GetAsULong(lpValue);
+	}
+	printf("%s:%u\t%lf seconds CPU for %u plain lookups\n", __FILE__, __LINE__, (double)(clock() - tStart) / CLOCKS_PER_SEC, KEYHANDLES_LOOKUPS);
+	tStart = clock();
+	for(i = 0; i < KEYHANDLES_LOOKUPS; i=i+1) {
+		cjsonObject_GetKey(lpObject, &userId, &lpValue);
+		dwSum = dwSum - cjsonObject_GetAsULong(lpValue);
+	}
+	printf("%s:%u\t%lf seconds CPU for %u handle lookups\n", __FILE__, __LINE__, (double)(clock() - tStart) / CLOCKS_PER_SEC, KEYHANDLES_LOOKUPS);
+	if(dwSum != 0) { printf("%s:%u Handle lookups returned different values\n", __FILE__, __LINE__); return 1; }
+
+	printf("%s:%u Batch lookup on a small object\n", __FILE__, __LINE__);
+	if(checkBatch(lpObject, 9) != 0) { return 1; }
+	cjsonReleaseValue(lpObject);
+
+	printf("%s:%u Batch lookup on a large object\n", __FILE__, __LINE__);
+	e = cjsonObject_CreateSized(&lpObject, 1000, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create object (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = fillObject(lpObject, 1000);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to fill object (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(checkBatch(lpObject, 1000) != 0) { return 1; }
+	cjsonReleaseValue(lpObject);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+static const char* lpTestDocument = "{\"store\":{\"book\":[{\"author\":\"A\",\"price\":8},{\"author\":\"B\",\"price\":12},{\"author\":\"C\",\"price\":9,\"isbn\":\"x\"},{\"author\":\"D\",\"price\":22}],\"bicycle\":{\"color\":\"red\",\"price\":19}},\"a/b\":{\"m~n\":1},\"it's\":2,\"list\":[10,11,12]}";
+
+struct matchContext {
+	unsigned long int dwMatches;
+	unsigned long int dwLimit;
+	char bText[64];			/* First character of every matched string or the number of every matched number */
+};
+
+static enum cjsonError documentReady(
+	struct cjsonValue* lpDocument,
+	void* lpFreeParam
+) {
+	(*((struct cjsonValue**)lpFreeParam)) = lpDocument;
+	return cjsonE_Ok;
+}
+
+static enum cjsonError collect(
+	struct cjsonValue* lpValue,
+	void* lpFreeParam
+) {
+	struct matchContext* lpContext = (struct matchContext*)lpFreeParam;
+	unsigned long int dwLength = strlen(lpContext->bText);
+
+	if(dwLength + 4 >= sizeof(lpContext->bText)) { return cjsonE_OutOfMemory; }
+	if(lpValue->type == cjsonString) {
+		lpContext->bText[dwLength] = ((struct cjsonString*)lpValue)->bData[0];
+		lpContext->bText[dwLength+1] = 0;
+	} else if(cjsonIsNumeric(lpValue)) {
+		sprintf(&(lpContext->bText[dwLength]), "%lu,", cjsonObject_GetAsULong(lpValue));
+	} else {
+		lpContext->bText[dwLength] = (lpValue->type == cjsonObject) ? 'o' : ((lpValue->type == cjsonArray) ? 'a' : '?');
+		lpContext->bText[dwLength+1] = 0;
+	}
+
+	lpContext->dwMatches = lpContext->dwMatches + 1;
+	if(lpContext->dwMatches == lpContext->dwLimit) { return cjsonE_Finished; }
+	return cjsonE_Ok;
+}
+
+static enum cjsonError countMatches(
+	struct cjsonValue* lpValue,
+	void* lpFreeParam
+) {
+	(*((unsigned long int*)lpFreeParam)) = (*((unsigned long int*)lpFreeParam)) + 1;
+	return cjsonE_Ok;
+}
+
+static int checkPath(
+	struct cjsonValue* lpDocument,
+	const char* lpExpression,
+	const char* lpExpected
+) {
+	struct cjsonPath* lpPath;
+	struct matchContext context;
+	enum cjsonError e;
+
+	e = cjsonPath_Compile(&lpPath, lpExpression, strlen(lpExpression), NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to compile %s (code %u)\n", __FILE__, __LINE__, lpExpression, e); return 1; }
+
+	context.dwMatches = 0;
+	context.dwLimit = 0;
+	context.bText[0] = 0;
+	e = cjsonPath_Eval(lpPath, lpDocument, &collect, (void*)&context);
+	cjsonPath_Release(lpPath);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to evaluate %s (code %u)\n", __FILE__, __LINE__, lpExpression, e); return 1; }
+	if(strcmp(context.bText, lpExpected) != 0) { printf("%s:%u %s matched \"%s\" instead of \"%s\"\n", __FILE__, __LINE__, lpExpression, context.bText, lpExpected); return 1; }
+	return 0;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonParser* lpParser;
+	struct cjsonValue* lpDocument = NULL;
+	struct cjsonValue* lpArray;
+	struct cjsonValue* lpNumber;
+	struct cjsonValue* lpExpected;
+	struct cjsonPath* lpPath;
+	struct matchContext context;
+	struct cjsonProfiler* lpProfiler;
+	struct cjsonProfiler_Stats stats;
+	uint64_t qwScratch;
+	unsigned long int dwMatches;
+	unsigned long int i;
+	const char* lpInvalid[] = { "store", "/a~2", "$store", "$.", "$..", "$[", "$[1", "$['x]", "$[a]", "$[::0]", "$[::-1]", "$[-]", "$.a[*", NULL };
+
+	e = cjsonParserCreate(&lpParser, 0, &documentReady, (void*)&lpDocument, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create parser (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < strlen(lpTestDocument); i=i+1) {
+		e = cjsonParserProcessByte(lpParser, lpTestDocument[i]);
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to parse (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	}
+	cjsonParserRelease(lpParser);
+	if(lpDocument == NULL) { printf("%s:%u No document\n", __FILE__, __LINE__); return 1; }
+
+	printf("%s:%u JSON pointers\n", __FILE__, __LINE__);
+	if(checkPath(lpDocument, "", "o") != 0) { return 1; }
+	if(checkPath(lpDocument, "/store/book/1/author", "B") != 0) { return 1; }
+	if(checkPath(lpDocument, "/store/book/3/price", "22,") != 0) { return 1; }
+	if(checkPath(lpDocument, "/a~1b/m~0n", "1,") != 0) { return 1; }
+	if(checkPath(lpDocument, "/list/-", "") != 0) { return 1; }
+	if(checkPath(lpDocument, "/list/01", "") != 0) { return 1; }
+	if(checkPath(lpDocument, "/list/3", "") != 0) { return 1; }
+	if(checkPath(lpDocument, "/store/missing", "") != 0) { return 1; }
+
+	printf("%s:%u JSONPath\n", __FILE__, __LINE__);
+	if(checkPath(lpDocument, "$", "o") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.store.book[*].author", "ABCD") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.store.book[-1].author", "D") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.store.book[1:3].author", "BC") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.store.book[::2].author", "AC") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.store.book[-2:].author", "CD") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.store.book[ :-3 ].author", "A") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.store.book[5:].author", "") != 0) { return 1; }
+	if(checkPath(lpDocument, "$['a/b']['m~n']", "1,") != 0) { return 1; }
+	if(checkPath(lpDocument, "$[\"it's\"]", "2,") != 0) { return 1; }
+	if(checkPath(lpDocument, "$['it\\'s']", "2,") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.list[*]", "10,11,12,") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.list.*", "10,11,12,") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.list[0:5]", "10,11,12,") != 0) { return 1; }
+	if(checkPath(lpDocument, "$['a/b'].*", "1,") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.store[0]", "") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.list.x", "") != 0) { return 1; }
+	if(checkPath(lpDocument, "$..isbn", "x") != 0) { return 1; }
+	if(checkPath(lpDocument, "$..book[2].author", "C") != 0) { return 1; }
+	if(checkPath(lpDocument, "$..[0].author", "A") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.store.book..author", "ABCD") != 0) { return 1; }
+	if(checkPath(lpDocument, "$.list..*", "10,11,12,") != 0) { return 1; }
+
+	printf("%s:%u Invalid expressions\n", __FILE__, __LINE__);
+	for(i = 0; lpInvalid[i] != NULL; i=i+1) {
+		e = cjsonPath_Compile(&lpPath, lpInvalid[i], strlen(lpInvalid[i]), NULL);
+		if(e != cjsonE_InvalidParam) { printf("%s:%u %s has been accepted\n", __FILE__, __LINE__, lpInvalid[i]); return 1; }
+		if(lpPath != NULL) { printf("%s:%u Output not cleared\n", __FILE__, __LINE__); return 1; }
+	}
+
+	printf("%s:%u Stopping and failing callbacks\n", __FILE__, __LINE__);
+	e = cjsonPath_Compile(&lpPath, "$..price", 8, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to compile (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	context.dwMatches = 0;
+	context.dwLimit = 2;
+	context.bText[0] = 0;
+	e = cjsonPath_Eval(lpPath, lpDocument, &collect, (void*)&context);
+	if((e != cjsonE_Ok) || (context.dwMatches != 2)) { printf("%s:%u Evaluation did not stop (code %u, %lu matches)\n", __FILE__, __LINE__, e, context.dwMatches); return 1; }
+	context.dwMatches = 0;
+	context.dwLimit = 0;
+	strcpy(context.bText, "0123456789012345678901234567890123456789012345678901234567");
+	e = cjsonPath_Eval(lpPath, lpDocument, &collect, (void*)&context);
+	if(e != cjsonE_OutOfMemory) { printf("%s:%u Callback error has not been returned (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonPath_Release(lpPath);
+	cjsonReleaseValue(lpDocument);
+
+	printf("%s:%u Slices across pages\n", __FILE__, __LINE__);
+	e = cjsonArray_CreateSized(&lpArray, 7, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create array (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < 1000; i=i+1) {
+		e = cjsonNumber_Create(&lpNumber, NULL);
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to create number (code %u)\n", __FILE__, __LINE__, e); return 1; }
+		cjsonNumber_SetULong(lpNumber, i);
+		e = cjsonArray_Push(lpArray, lpNumber);
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to push (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	}
+	e = cjsonPath_Compile(&lpPath, "$[990:]", 7, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to compile (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	context.dwMatches = 0;
+	context.dwLimit = 0;
+	context.bText[0] = 0;
+	e = cjsonPath_Eval(lpPath, lpArray, &collect, (void*)&context);
+	if((e != cjsonE_Ok) || (strcmp(context.bText, "990,991,992,993,994,995,996,997,998,999,") != 0)) { printf("%s:%u Slice returned %s\n", __FILE__, __LINE__, context.bText); return 1; }
+	cjsonPath_Release(lpPath);
+	for(i = 0; i < 1000; i=i+37) {
+		cjsonArray_Get(lpArray, i, &lpExpected);
+		sprintf(context.bText, "/%lu", i);
+		e = cjsonPath_Compile(&lpPath, context.bText, strlen(context.bText), NULL);
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to compile (code %u)\n", __FILE__, __LINE__, e); return 1; }
+		context.dwMatches = 0;
+		context.dwLimit = 0;
+		context.bText[0] = 0;
+		e = cjsonPath_Eval(lpPath, lpArray, &collect, (void*)&context);
+		cjsonPath_Release(lpPath);
+		if((e != cjsonE_Ok) || (context.dwMatches != 1) || (strtoul(context.bText, NULL, 10) != cjsonObject_GetAsULong(lpExpected))) { printf("%s:%u Index %lu returned %s\n", __FILE__, __LINE__, i, context.bText); return 1; }
+	}
+	cjsonReleaseValue(lpArray);
+
+	/* Deeper evaluation stacks come from the system API of the path */
+	printf("%s:%u Descending into a deeply nested document\n", __FILE__, __LINE__);
+	cjsonArray_Create(&lpArray, NULL);
+	lpExpected = lpArray;
+	for(i = 0; i < 1000; i=i+1) {
+		cjsonArray_Create(&lpNumber, NULL);
+		cjsonArray_Push(lpExpected, lpNumber);
+		lpExpected = lpNumber;
+	}
+	e = cjsonProfiler_Create(&lpProfiler, 1, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create profiler (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = cjsonPath_Compile(&lpPath, "$..*", 4, cjsonProfiler_System(lpProfiler));
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to compile (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	qwScratch = stats.sites[cjsonAllocSite__Other].qwAllocations;
+	dwMatches = 0;
+	e = cjsonPath_Eval(lpPath, lpArray, &countMatches, (void*)&dwMatches);
+	if((e != cjsonE_Ok) || (dwMatches != 1000)) { printf("%s:%u Descendants returned %lu matches (code %u)\n", __FILE__, __LINE__, dwMatches, e); return 1; }
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.sites[cjsonAllocSite__Other].qwAllocations == qwScratch) { printf("%s:%u Stack segments bypassed the system API\n", __FILE__, __LINE__); return 1; }
+	cjsonPath_Release(lpPath);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.qwLiveBytes != 0) { printf("%s:%u %lu bytes still allocated after release\n", __FILE__, __LINE__, (unsigned long int)stats.qwLiveBytes); return 1; }
+	cjsonProfiler_Release(lpProfiler);
+	cjsonReleaseValue(lpArray);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
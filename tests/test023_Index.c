@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define INDEX_RECORDS 10000
+
+static enum cjsonError createRecord(
+	unsigned long int dwId,
+	struct cjsonValue** lpOut
+) {
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpValue;
+	char bName[32];
+	enum cjsonError e;
+
+	e = cjsonObject_Create(&lpRecord, NULL);
+	if(e != cjsonE_Ok) { return e; }
+	e = cjsonNumber_Create(&lpValue, NULL);
+	if(e != cjsonE_Ok) { return e; }
+	cjsonNumber_SetULong(lpValue, dwId);
+	e = cjsonObject_Set(lpRecord, "id", 2, lpValue);
+	if(e != cjsonE_Ok) { return e; }
+	sprintf(bName, "n%lu", dwId);
+	e = cjsonString_Create(&lpValue, bName, strlen(bName), NULL);
+	if(e != cjsonE_Ok) { return e; }
+	e = cjsonObject_Set(lpRecord, "name", 4, lpValue);
+	if(e != cjsonE_Ok) { return e; }
+
+	(*lpOut) = lpRecord;
+	return cjsonE_Ok;
+}
+
+static int expectRecord(
+	struct cjsonIndex* lpIndex,
+	unsigned long int dwId,
+	struct cjsonValue* lpExpected,		/* NULL if the lookup has to fail */
+	unsigned int dwLine
+) {
+	struct cjsonValue* lpKey;
+	struct cjsonValue* lpFound;
+	enum cjsonError e;
+
+	if(cjsonNumber_Create(&lpKey, NULL) != cjsonE_Ok) { printf("%s:%u Failed to create number\n", __FILE__, dwLine); return 1; }
+	cjsonNumber_SetULong(lpKey, dwId);
+	e = cjsonIndex_Lookup(lpIndex, lpKey, &lpFound);
+	cjsonReleaseValue(lpKey);
+
+	if(lpExpected == NULL) {
+		if(e != cjsonE_IndexOutOfBounds) { printf("%s:%u Found id %lu (code %u)\n", __FILE__, dwLine, dwId, e); return 1; }
+		return 0;
+	}
+	if(e != cjsonE_Ok) { printf("%s:%u Lookup of id %lu failed (code %u)\n", __FILE__, dwLine, dwId, e); return 1; }
+	if(lpFound != lpExpected) { printf("%s:%u Lookup of id %lu returned the wrong element\n", __FILE__, dwLine, dwId); return 1; }
+	return 0;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonValue* lpArray;
+	struct cjsonValue* lpOther;
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpMutable;
+	struct cjsonValue* lpValue;
+	struct cjsonValue* lpFound;
+	struct cjsonIndex* lpIndex;
+	struct cjsonIndex* lpNames;
+	unsigned long int i;
+
+	printf("%s:%u Building an index over %u records\n", __FILE__, __LINE__, INDEX_RECORDS);
+	e = cjsonArray_Create(&lpArray, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create array (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < INDEX_RECORDS; i=i+1) {
+		e = createRecord(i, &lpRecord);
+		if(e == cjsonE_Ok) { e = cjsonArray_Push(lpArray, lpRecord); }
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to create record (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	}
+	e = cjsonIndex_Build(&lpIndex, lpArray, "/id", 3, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to build index (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = cjsonIndex_Build(&lpNames, lpArray, "$.name", 6, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to build index (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	for(i = 0; i < INDEX_RECORDS; i=i+1) {
+		cjsonArray_Get(lpArray, i, &lpRecord);
+		if(expectRecord(lpIndex, i, lpRecord, __LINE__) != 0) { return 1; }
+	}
+	if(expectRecord(lpIndex, INDEX_RECORDS, NULL, __LINE__) != 0) { return 1; }
+
+	/* Keys match by numeric value */
+	cjsonArray_Get(lpArray, 42, &lpRecord);
+	cjsonNumber_Create(&lpValue, NULL);
+	cjsonNumber_SetDouble(lpValue, 42.0);
+	e = cjsonIndex_Lookup(lpIndex, lpValue, &lpFound);
+	cjsonReleaseValue(lpValue);
+	if((e != cjsonE_Ok) || (lpFound != lpRecord)) { printf("%s:%u Double key did not match (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonString_Create(&lpValue, "n42", 3, NULL);
+	e = cjsonIndex_Lookup(lpNames, lpValue, &lpFound);
+	cjsonReleaseValue(lpValue);
+	if((e != cjsonE_Ok) || (lpFound != lpRecord)) { printf("%s:%u String key did not match (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	printf("%s:%u Incremental maintenance\n", __FILE__, __LINE__);
+	createRecord(INDEX_RECORDS, &lpRecord);
+	cjsonArray_Push(lpArray, lpRecord);
+	if(expectRecord(lpIndex, INDEX_RECORDS, lpRecord, __LINE__) != 0) { return 1; }
+
+	createRecord(INDEX_RECORDS + 1, &lpRecord);
+	cjsonArray_Set(lpArray, 7, lpRecord);
+	if(expectRecord(lpIndex, 7, NULL, __LINE__) != 0) { return 1; }
+	if(expectRecord(lpIndex, INDEX_RECORDS + 1, lpRecord, __LINE__) != 0) { return 1; }
+
+	createRecord(INDEX_RECORDS + 2, &lpRecord);
+	cjsonArray_Insert(lpArray, 3, lpRecord);
+	if(expectRecord(lpIndex, INDEX_RECORDS + 2, lpRecord, __LINE__) != 0) { return 1; }
+
+	cjsonArray_Get(lpArray, 101, &lpRecord);
+	if(expectRecord(lpIndex, 100, lpRecord, __LINE__) != 0) { return 1; }
+	cjsonArray_Remove(lpArray, 101, NULL);
+	if(expectRecord(lpIndex, 100, NULL, __LINE__) != 0) { return 1; }
+	cjsonArray_Get(lpArray, 101, &lpRecord);
+	if(expectRecord(lpIndex, 101, lpRecord, __LINE__) != 0) { return 1; }
+
+	cjsonArray_Create(&lpOther, NULL);
+	for(i = 0; i < 200; i=i+1) {
+		createRecord(2 * INDEX_RECORDS + i, &lpRecord);
+		cjsonArray_Push(lpOther, lpRecord);
+	}
+	cjsonArray_Concat(lpArray, lpOther);
+	cjsonArray_Get(lpArray, cjsonArray_Length(lpArray) - 1, &lpRecord);
+	if(expectRecord(lpIndex, 2 * INDEX_RECORDS + 199, lpRecord, __LINE__) != 0) { return 1; }
+
+	/* Unsharing an element replaces it inside the array */
+	cjsonArray_Get(lpArray, 0, &lpRecord);
+	cjsonValue_Retain(lpRecord);
+	e = cjsonArray_GetMutable(lpArray, 0, &lpMutable);
+	if((e != cjsonE_Ok) || (lpMutable == lpRecord)) { printf("%s:%u Shared element has not been copied (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(expectRecord(lpIndex, 0, lpMutable, __LINE__) != 0) { return 1; }
+	cjsonReleaseValue(lpRecord);
+
+	printf("%s:%u Rebuilding after modified keys\n", __FILE__, __LINE__);
+	cjsonObject_Get(lpMutable, "id", 2, &lpValue);
+	cjsonNumber_SetULong(lpValue, 3 * INDEX_RECORDS);
+	e = cjsonIndex_Rebuild(lpIndex);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to rebuild (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(expectRecord(lpIndex, 0, NULL, __LINE__) != 0) { return 1; }
+	if(expectRecord(lpIndex, 3 * INDEX_RECORDS, lpMutable, __LINE__) != 0) { return 1; }
+
+	printf("%s:%u Releasing the array before the index\n", __FILE__, __LINE__);
+	cjsonIndex_Release(lpNames);
+	cjsonReleaseValue(lpArray);
+	cjsonNumber_Create(&lpValue, NULL);
+	e = cjsonIndex_Lookup(lpIndex, lpValue, &lpFound);
+	cjsonReleaseValue(lpValue);
+	if(e != cjsonE_InvalidState) { printf("%s:%u Lookup on released array returned %u\n", __FILE__, __LINE__, e); return 1; }
+	cjsonIndex_Release(lpIndex);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define COLUMNS_RECORDS 1000
+
+/*
+	Records with an unsigned id, a signed delta, a double price
+	(every 10th is null), a name, a flag, an optional tag (only
+	even rows) and a mixed column
+*/
+static enum cjsonError createRecord(
+	unsigned long int dwId,
+	struct cjsonValue** lpOut
+) {
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpValue;
+	char bName[32];
+	enum cjsonError e;
+
+	e = cjsonObject_Create(&lpRecord, NULL);
+	if(e != cjsonE_Ok) { return e; }
+
+	cjsonNumber_Create(&lpValue, NULL);
+	cjsonNumber_SetULong(lpValue, dwId);
+	e = cjsonObject_Set(lpRecord, "id", 2, lpValue);
+	if(e != cjsonE_Ok) { return e; }
+
+	cjsonNumber_Create(&lpValue, NULL);
+	cjsonNumber_SetSLong(lpValue, (signed long int)dwId - 500);
+	e = cjsonObject_Set(lpRecord, "delta", 5, lpValue);
+	if(e != cjsonE_Ok) { return e; }
+
+	if((dwId % 10) == 0) {
+		cjsonNull_Create(&lpValue, NULL);
+	} else {
+		cjsonNumber_Create(&lpValue, NULL);
+		cjsonNumber_SetDouble(lpValue, (double)dwId + 0.5);
+	}
+	e = cjsonObject_Set(lpRecord, "price", 5, lpValue);
+	if(e != cjsonE_Ok) { return e; }
+
+	sprintf(bName, "n%lu", dwId % 7);
+	cjsonString_Create(&lpValue, bName, strlen(bName), NULL);
+	e = cjsonObject_Set(lpRecord, "name", 4, lpValue);
+	if(e != cjsonE_Ok) { return e; }
+
+	if((dwId % 3) == 0) { cjsonTrue_Create(&lpValue, NULL); } else { cjsonFalse_Create(&lpValue, NULL); }
+	e = cjsonObject_Set(lpRecord, "flag", 4, lpValue);
+	if(e != cjsonE_Ok) { return e; }
+
+	if((dwId % 2) == 0) {
+		cjsonString_Create(&lpValue, "even", 4, NULL);
+		e = cjsonObject_Set(lpRecord, "tag", 3, lpValue);
+		if(e != cjsonE_Ok) { return e; }
+	}
+
+	if((dwId % 2) == 0) {
+		cjsonString_Create(&lpValue, "s", 1, NULL);
+	} else {
+		cjsonNumber_Create(&lpValue, NULL);
+		cjsonNumber_SetULong(lpValue, dwId);
+	}
+	e = cjsonObject_Set(lpRecord, "mixed", 5, lpValue);
+	if(e != cjsonE_Ok) { return e; }
+
+	(*lpOut) = lpRecord;
+	return cjsonE_Ok;
+}
+
+static const struct cjsonColumn* expectColumn(
+	const struct cjsonColumns* lpColumns,
+	const char* lpName,
+	enum cjsonColumn_Type type,
+	unsigned long int dwValueCount
+) {
+	const struct cjsonColumn* lpColumn;
+
+	lpColumn = cjsonColumns_Find(lpColumns, lpName, strlen(lpName));
+	if(lpColumn == NULL) { printf("%s:%u Column %s not found\n", __FILE__, __LINE__, lpName); return NULL; }
+	if(lpColumn->type != type) { printf("%s:%u Column %s has type %u, expected %u\n", __FILE__, __LINE__, lpName, lpColumn->type, type); return NULL; }
+	if(lpColumn->dwValueCount != dwValueCount) { printf("%s:%u Column %s has %lu values, expected %lu\n", __FILE__, __LINE__, lpName, lpColumn->dwValueCount, dwValueCount); return NULL; }
+	return lpColumn;
+}
+
+/*
+	Converts two rows {"a":lpFirst} and {"a":lpSecond} (the values are
+	consumed) and checks the column type and the round trip
+*/
+static int expectMixedNumbers(
+	struct cjsonValue* lpFirst,
+	struct cjsonValue* lpSecond,
+	enum cjsonColumn_Type type,
+	unsigned int dwLine
+) {
+	struct cjsonValue* lpArray;
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpRestored;
+	struct cjsonColumns* lpColumns;
+	int bOk = 1;
+
+	cjsonArray_Create(&lpArray, NULL);
+	cjsonObject_Create(&lpRecord, NULL);
+	cjsonObject_Set(lpRecord, "a", 1, lpFirst);
+	cjsonArray_Push(lpArray, lpRecord);
+	cjsonObject_Create(&lpRecord, NULL);
+	cjsonObject_Set(lpRecord, "a", 1, lpSecond);
+	cjsonArray_Push(lpArray, lpRecord);
+
+	if(cjsonColumns_FromArray(&lpColumns, lpArray, NULL) != cjsonE_Ok) { printf("%s:%u Conversion failed\n", __FILE__, dwLine); cjsonReleaseValue(lpArray); return 0; }
+	if(lpColumns->lpColumns[0].type != type) { printf("%s:%u Column has type %u, expected %u\n", __FILE__, dwLine, lpColumns->lpColumns[0].type, type); bOk = 0; }
+	if(cjsonColumns_ToArray(lpColumns, &lpRestored, NULL) != cjsonE_Ok) {
+		printf("%s:%u Inverse conversion failed\n", __FILE__, dwLine);
+		bOk = 0;
+	} else {
+		if(cjsonValue_Equals(lpArray, lpRestored) == 0) { printf("%s:%u Restored array differs from the original\n", __FILE__, dwLine); bOk = 0; }
+		cjsonReleaseValue(lpRestored);
+	}
+
+	cjsonColumns_Release(lpColumns);
+	cjsonReleaseValue(lpArray);
+	return bOk;
+}
+static struct cjsonValue* createULong(unsigned long int dwValue) {
+	struct cjsonValue* lpValue;
+	cjsonNumber_Create(&lpValue, NULL);
+	cjsonNumber_SetULong(lpValue, dwValue);
+	return lpValue;
+}
+static struct cjsonValue* createSLong(signed long int iValue) {
+	struct cjsonValue* lpValue;
+	cjsonNumber_Create(&lpValue, NULL);
+	cjsonNumber_SetSLong(lpValue, iValue);
+	return lpValue;
+}
+static struct cjsonValue* createDouble(double dValue) {
+	struct cjsonValue* lpValue;
+	cjsonNumber_Create(&lpValue, NULL);
+	cjsonNumber_SetDouble(lpValue, dValue);
+	return lpValue;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonValue* lpArray;
+	struct cjsonValue* lpRestored;
+	struct cjsonValue* lpRecord;
+	struct cjsonValue* lpValue;
+	struct cjsonColumns* lpColumns;
+	const struct cjsonColumn* lpId;
+	const struct cjsonColumn* lpPrice;
+	const struct cjsonColumn* lpName;
+	const struct cjsonColumn* lpFlag;
+	const struct cjsonColumn* lpTag;
+	struct cjsonColumn_Aggregate aggregate;
+	struct cjsonProfiler* lpProfiler;
+	struct cjsonProfiler_Stats stats;
+	uint8_t bSelection[CJSON_COLUMN_BITMAPBYTES(COLUMNS_RECORDS)];
+	unsigned long int dwSelected;
+	unsigned long int dwExpected;
+	double dExpected;
+	unsigned long int i;
+
+	printf("%s:%u Converting %u records\n", __FILE__, __LINE__, COLUMNS_RECORDS);
+	e = cjsonArray_Create(&lpArray, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create array (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	for(i = 0; i < COLUMNS_RECORDS; i=i+1) {
+		e = createRecord(i, &lpRecord);
+		if(e == cjsonE_Ok) { e = cjsonArray_Push(lpArray, lpRecord); }
+		if(e != cjsonE_Ok) { printf("%s:%u Failed to create record (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	}
+
+	e = cjsonColumns_FromArray(&lpColumns, lpArray, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Conversion failed (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if((lpColumns->dwRowCount != COLUMNS_RECORDS) || (lpColumns->dwColumnCount != 7)) { printf("%s:%u Got %lu rows and %lu columns\n", __FILE__, __LINE__, lpColumns->dwRowCount, lpColumns->dwColumnCount); return 1; }
+	if(cjsonColumns_Find(lpColumns, "none", 4) != NULL) { printf("%s:%u Found a column that does not exist\n", __FILE__, __LINE__); return 1; }
+
+	if((lpId = expectColumn(lpColumns, "id", cjsonColumn_Type__UnsignedLong, COLUMNS_RECORDS)) == NULL) { return 1; }
+	if(expectColumn(lpColumns, "delta", cjsonColumn_Type__SignedLong, COLUMNS_RECORDS) == NULL) { return 1; }
+	if((lpPrice = expectColumn(lpColumns, "price", cjsonColumn_Type__Double, COLUMNS_RECORDS - COLUMNS_RECORDS / 10)) == NULL) { return 1; }
+	if((lpName = expectColumn(lpColumns, "name", cjsonColumn_Type__String, COLUMNS_RECORDS)) == NULL) { return 1; }
+	if((lpFlag = expectColumn(lpColumns, "flag", cjsonColumn_Type__Boolean, COLUMNS_RECORDS)) == NULL) { return 1; }
+	if((lpTag = expectColumn(lpColumns, "tag", cjsonColumn_Type__String, COLUMNS_RECORDS / 2)) == NULL) { return 1; }
+	if(expectColumn(lpColumns, "mixed", cjsonColumn_Type__Value, COLUMNS_RECORDS) == NULL) { return 1; }
+	if((lpTag->lpMissing == NULL) || (CJSON_COLUMN_ISSET(lpTag->lpMissing, 1) == 0) || (CJSON_COLUMN_ISSET(lpTag->lpMissing, 2) != 0)) { printf("%s:%u Missing bitmap of tag is wrong\n", __FILE__, __LINE__); return 1; }
+	if((lpPrice->lpMissing != NULL) || (lpPrice->lpValid == NULL) || CJSON_COLUMN_HASVALUE(lpPrice, 20) || !CJSON_COLUMN_HASVALUE(lpPrice, 21)) { printf("%s:%u Validity bitmap of price is wrong\n", __FILE__, __LINE__); return 1; }
+	if((lpName->data.lpStringOffsets[10] - lpName->data.lpStringOffsets[9] != 2) || (memcmp(&(lpName->lpStringBlob[lpName->data.lpStringOffsets[9]]), "n2", 2) != 0)) { printf("%s:%u String column content is wrong\n", __FILE__, __LINE__); return 1; }
+
+	printf("%s:%u Aggregates\n", __FILE__, __LINE__);
+	e = cjsonColumn_Aggregate(lpId, NULL, &aggregate);
+	if((e != cjsonE_Ok) || (aggregate.dwCount != COLUMNS_RECORDS) || (aggregate.dSum != (double)(COLUMNS_RECORDS * (COLUMNS_RECORDS - 1) / 2)) || (aggregate.dMin != 0) || (aggregate.dMax != COLUMNS_RECORDS - 1)) {
+		printf("%s:%u Aggregate of id is wrong (code %u)\n", __FILE__, __LINE__, e);
+		return 1;
+	}
+	dExpected = 0;
+	for(i = 0; i < COLUMNS_RECORDS; i=i+1) { if((i % 10) != 0) { dExpected = dExpected + (double)i + 0.5; } }
+	e = cjsonColumn_Aggregate(lpPrice, NULL, &aggregate);
+	if((e != cjsonE_Ok) || (aggregate.dwCount != COLUMNS_RECORDS - COLUMNS_RECORDS / 10) || (aggregate.dSum != dExpected) || (aggregate.dMin != 1.5) || (aggregate.dMax != COLUMNS_RECORDS - 0.5)) {
+		printf("%s:%u Aggregate of price is wrong (code %u)\n", __FILE__, __LINE__, e);
+		return 1;
+	}
+	if(cjsonColumn_Aggregate(lpName, NULL, &aggregate) != cjsonE_InvalidParam) { printf("%s:%u Aggregated a string column\n", __FILE__, __LINE__); return 1; }
+
+	printf("%s:%u Filters\n", __FILE__, __LINE__);
+	memset(bSelection, 0xFF, sizeof(bSelection));
+	e = cjsonColumn_FilterNumber(lpPrice, cjsonColumn_Compare__Less, 100, bSelection, &dwSelected);
+	if((e != cjsonE_Ok) || (dwSelected != 90)) { printf("%s:%u Selected %lu rows instead of 90 (code %u)\n", __FILE__, __LINE__, dwSelected, e); return 1; }
+	e = cjsonColumn_FilterNumber(lpFlag, cjsonColumn_Compare__Equal, 1, bSelection, &dwSelected);
+	dwExpected = 0;
+	for(i = 0; i < 100; i=i+1) { if(((i % 10) != 0) && ((i % 3) == 0)) { dwExpected = dwExpected + 1; } }
+	if((e != cjsonE_Ok) || (dwSelected != dwExpected)) { printf("%s:%u Selected %lu rows instead of %lu (code %u)\n", __FILE__, __LINE__, dwSelected, dwExpected, e); return 1; }
+	e = cjsonColumn_FilterString(lpTag, "even", 4, 1, bSelection, &dwSelected);
+	dwExpected = 0;
+	dExpected = 0;
+	for(i = 0; i < 100; i=i+1) { if(((i % 10) != 0) && ((i % 6) == 0)) { dwExpected = dwExpected + 1; dExpected = dExpected + (double)i + 0.5; } }
+	if((e != cjsonE_Ok) || (dwSelected != dwExpected)) { printf("%s:%u Selected %lu rows instead of %lu (code %u)\n", __FILE__, __LINE__, dwSelected, dwExpected, e); return 1; }
+	e = cjsonColumn_Aggregate(lpPrice, bSelection, &aggregate);
+	if((e != cjsonE_Ok) || (aggregate.dwCount != dwExpected) || (aggregate.dSum != dExpected)) { printf("%s:%u Aggregate of the selection is wrong (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	memset(bSelection, 0xFF, sizeof(bSelection));
+	e = cjsonColumn_FilterString(lpName, "n3", 2, 0, bSelection, &dwSelected);
+	dwExpected = 0;
+	for(i = 0; i < COLUMNS_RECORDS; i=i+1) { if((i % 7) != 3) { dwExpected = dwExpected + 1; } }
+	if((e != cjsonE_Ok) || (dwSelected != dwExpected)) { printf("%s:%u Selected %lu rows instead of %lu (code %u)\n", __FILE__, __LINE__, dwSelected, dwExpected, e); return 1; }
+
+	printf("%s:%u Converting back\n", __FILE__, __LINE__);
+	e = cjsonColumns_ToArray(lpColumns, &lpRestored, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Inverse conversion failed (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(cjsonValue_Equals(lpArray, lpRestored) == 0) { printf("%s:%u Restored array differs from the original\n", __FILE__, __LINE__); return 1; }
+	cjsonArray_Get(lpRestored, 1, &lpRecord);
+	if(cjsonObject_HasKey(lpRecord, "tag", 3) == cjsonE_Ok) { printf("%s:%u Missing key has been restored\n", __FILE__, __LINE__); return 1; }
+	cjsonArray_Get(lpRestored, 10, &lpRecord);
+	if((cjsonObject_Get(lpRecord, "price", 5, &lpValue) != cjsonE_Ok) || (lpValue->type != cjsonNull)) { printf("%s:%u Null has not been restored\n", __FILE__, __LINE__); return 1; }
+	cjsonReleaseValue(lpRestored);
+
+	cjsonColumns_Release(lpColumns);
+
+	/* Scratch memory of the conversion comes from the system API of the result and is freed before returning */
+	printf("%s:%u Converting with a system API\n", __FILE__, __LINE__);
+	e = cjsonProfiler_Create(&lpProfiler, 1, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create profiler (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	e = cjsonColumns_FromArray(&lpColumns, lpArray, cjsonProfiler_System(lpProfiler));
+	if(e != cjsonE_Ok) { printf("%s:%u Conversion failed (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.sites[cjsonAllocSite__Other].qwFrees == 0) { printf("%s:%u Scratch memory bypassed the system API\n", __FILE__, __LINE__); return 1; }
+	cjsonColumns_Release(lpColumns);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.qwLiveBytes != 0) { printf("%s:%u %lu bytes still allocated after release\n", __FILE__, __LINE__, (unsigned long int)stats.qwLiveBytes); return 1; }
+	cjsonProfiler_Release(lpProfiler);
+
+	/* Mixes of numbers are only narrowed to double if that is lossless */
+	printf("%s:%u Converting mixed numbers\n", __FILE__, __LINE__);
+	if(expectMixedNumbers(createULong(3), createDouble(0.5), cjsonColumn_Type__Double, __LINE__) == 0) { return 1; }
+	if(expectMixedNumbers(createSLong(-3), createULong(3), cjsonColumn_Type__SignedLong, __LINE__) == 0) { return 1; }
+	if(sizeof(unsigned long int) >= 8) {
+		if(expectMixedNumbers(createULong((unsigned long int)9007199254740992.0 + 1), createDouble(0.5), cjsonColumn_Type__Value, __LINE__) == 0) { return 1; }
+		if(expectMixedNumbers(createSLong(-((signed long int)9007199254740992.0) - 1), createDouble(0.5), cjsonColumn_Type__Value, __LINE__) == 0) { return 1; }
+		if(expectMixedNumbers(createULong(ULONG_MAX), createSLong(-1), cjsonColumn_Type__Value, __LINE__) == 0) { return 1; }
+	}
+
+	printf("%s:%u Rejecting arrays of non objects\n", __FILE__, __LINE__);
+	cjsonNumber_Create(&lpValue, NULL);
+	cjsonArray_Push(lpArray, lpValue);
+	e = cjsonColumns_FromArray(&lpColumns, lpArray, NULL);
+	if((e != cjsonE_InvalidParam) || (lpColumns != NULL)) { printf("%s:%u Conversion returned %u\n", __FILE__, __LINE__, e); return 1; }
+	cjsonReleaseValue(lpArray);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
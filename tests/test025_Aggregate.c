@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define AGGREGATE_SMALL 1000
+#define AGGREGATE_LARGE 300000		/* Above CJSON_AGGREGATE_PARALLELMINELEMENTS */
+
+/*
+	Element i is i as unsigned long, -i as signed long for every
+	3rd and i as double for every 5th element. Every 7th element
+	is a string that has to be skipped.
+*/
+static enum cjsonError fillArray(
+	struct cjsonValue* lpArray,
+	unsigned long int dwCount,
+	int bMixed
+) {
+	struct cjsonValue* lpValue;
+	unsigned long int i;
+	enum cjsonError e;
+
+	for(i = 0; i < dwCount; i=i+1) {
+		if((bMixed != 0) && ((i % 7) == 0)) {
+			e = cjsonString_Create(&lpValue, "skip", 4, NULL);
+		} else {
+			e = cjsonNumber_Create(&lpValue, NULL);
+			if(e != cjsonE_Ok) { return e; }
+			if(bMixed == 0) {
+				cjsonNumber_SetDouble(lpValue, (double)i);
+			} else if((i % 3) == 0) {
+				cjsonNumber_SetSLong(lpValue, -(signed long int)i);
+			} else if((i % 5) == 0) {
+				cjsonNumber_SetDouble(lpValue, (double)i);
+			} else {
+				cjsonNumber_SetULong(lpValue, i);
+			}
+		}
+		if(e != cjsonE_Ok) { return e; }
+		e = cjsonArray_Push(lpArray, lpValue);
+		if(e != cjsonE_Ok) { return e; }
+	}
+	return cjsonE_Ok;
+}
+
+static int checkArray(
+	struct cjsonValue* lpArray,
+	struct cjsonWorkerPool* lpPool,
+	unsigned long int dwCount,
+	int bMixed,
+	unsigned int dwLine
+) {
+	struct cjsonColumn_Aggregate aggregate;
+	unsigned long int dwExpectedCount = 0;
+	unsigned long int dwExpectedMatches = 0;
+	unsigned long int dwResult;
+	double dExpectedSum = 0;
+	double dExpectedMin = 0;
+	double dExpectedMax = 0;
+	double dValue;
+	double dResult;
+	unsigned long int i;
+	enum cjsonError e;
+
+	for(i = 0; i < dwCount; i=i+1) {
+		if((bMixed != 0) && ((i % 7) == 0)) { continue; }
+		dValue = ((bMixed != 0) && ((i % 3) == 0)) ? -(double)i : (double)i;
+		if((dwExpectedCount == 0) || (dValue < dExpectedMin)) { dExpectedMin = dValue; }
+		if((dwExpectedCount == 0) || (dValue > dExpectedMax)) { dExpectedMax = dValue; }
+		if(dValue >= 100) { dwExpectedMatches = dwExpectedMatches + 1; }
+		dExpectedSum = dExpectedSum + dValue;
+		dwExpectedCount = dwExpectedCount + 1;
+	}
+
+	e = cjsonArray_Aggregate(lpArray, lpPool, &aggregate);
+	if(e != cjsonE_Ok) { printf("%s:%u Aggregate failed (code %u)\n", __FILE__, dwLine, e); return 1; }
+	if((aggregate.dwCount != dwExpectedCount) || (aggregate.dSum != dExpectedSum) || (aggregate.dMin != dExpectedMin) || (aggregate.dMax != dExpectedMax)) {
+		printf("%s:%u Aggregate returned count %lu, sum %f, min %f, max %f\n", __FILE__, dwLine, aggregate.dwCount, aggregate.dSum, aggregate.dMin, aggregate.dMax);
+		return 1;
+	}
+
+	if((cjsonArray_Sum(lpArray, lpPool, &dResult) != cjsonE_Ok) || (dResult != dExpectedSum)) { printf("%s:%u Sum is wrong\n", __FILE__, dwLine); return 1; }
+	if((cjsonArray_Min(lpArray, lpPool, &dResult) != cjsonE_Ok) || (dResult != dExpectedMin)) { printf("%s:%u Min is wrong\n", __FILE__, dwLine); return 1; }
+	if((cjsonArray_Max(lpArray, lpPool, &dResult) != cjsonE_Ok) || (dResult != dExpectedMax)) { printf("%s:%u Max is wrong\n", __FILE__, dwLine); return 1; }
+	if((cjsonArray_Mean(lpArray, lpPool, &dResult) != cjsonE_Ok) || (dResult != dExpectedSum / (double)dwExpectedCount)) { printf("%s:%u Mean is wrong\n", __FILE__, dwLine); return 1; }
+	if((cjsonArray_Count(lpArray, lpPool, &dwResult) != cjsonE_Ok) || (dwResult != dwExpectedCount)) { printf("%s:%u Count is wrong (%lu)\n", __FILE__, dwLine, dwResult); return 1; }
+	if((cjsonArray_CountIf(lpArray, lpPool, cjsonColumn_Compare__GreaterEqual, 100, &dwResult) != cjsonE_Ok) || (dwResult != dwExpectedMatches)) { printf("%s:%u CountIf returned %lu instead of %lu\n", __FILE__, dwLine, dwResult, dwExpectedMatches); return 1; }
+	return 0;
+}
+
+int main(int argc, char* argv[]) {
+	enum cjsonError e;
+	struct cjsonValue* lpArray;
+	struct cjsonValue* lpValue;
+	struct cjsonWorkerPool* lpPool;
+	struct cjsonProfiler* lpProfiler;
+	struct cjsonProfiler_Stats stats;
+	double dResult;
+	unsigned long int dwResult;
+
+	printf("%s:%u Homogeneous array\n", __FILE__, __LINE__);
+	cjsonArray_Create(&lpArray, NULL);
+	if((e = fillArray(lpArray, AGGREGATE_SMALL, 0)) != cjsonE_Ok) { printf("%s:%u Failed to fill array (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(checkArray(lpArray, NULL, AGGREGATE_SMALL, 0, __LINE__) != 0) { return 1; }
+	cjsonReleaseValue(lpArray);
+
+	printf("%s:%u Mixed array\n", __FILE__, __LINE__);
+	cjsonArray_Create(&lpArray, NULL);
+	if((e = fillArray(lpArray, AGGREGATE_SMALL, 1)) != cjsonE_Ok) { printf("%s:%u Failed to fill array (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(checkArray(lpArray, NULL, AGGREGATE_SMALL, 1, __LINE__) != 0) { return 1; }
+	cjsonReleaseValue(lpArray);
+
+	printf("%s:%u Empty and non numeric arrays\n", __FILE__, __LINE__);
+	cjsonArray_Create(&lpArray, NULL);
+	if((cjsonArray_Sum(lpArray, NULL, &dResult) != cjsonE_Ok) || (dResult != 0)) { printf("%s:%u Sum of empty array is wrong\n", __FILE__, __LINE__); return 1; }
+	if(cjsonArray_Mean(lpArray, NULL, &dResult) != cjsonE_IndexOutOfBounds) { printf("%s:%u Mean of empty array succeeded\n", __FILE__, __LINE__); return 1; }
+	cjsonNull_Create(&lpValue, NULL);
+	cjsonArray_Push(lpArray, lpValue);
+	if(cjsonArray_Min(lpArray, NULL, &dResult) != cjsonE_IndexOutOfBounds) { printf("%s:%u Min without numbers succeeded\n", __FILE__, __LINE__); return 1; }
+	if((cjsonArray_Count(lpArray, NULL, &dwResult) != cjsonE_Ok) || (dwResult != 0)) { printf("%s:%u Counted a null\n", __FILE__, __LINE__); return 1; }
+	cjsonReleaseValue(lpArray);
+	cjsonObject_Create(&lpValue, NULL);
+	if(cjsonArray_Sum(lpValue, NULL, &dResult) != cjsonE_InvalidParam) { printf("%s:%u Aggregated an object\n", __FILE__, __LINE__); return 1; }
+	cjsonReleaseValue(lpValue);
+
+	printf("%s:%u Parallel aggregation of %u elements\n", __FILE__, __LINE__, AGGREGATE_LARGE);
+	e = cjsonWorkerPool_Create(&lpPool, 4, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create worker pool (code %u)\n", __FILE__, __LINE__, e); return 1; }
+
+	cjsonArray_Create(&lpArray, NULL);
+	if((e = fillArray(lpArray, AGGREGATE_LARGE, 1)) != cjsonE_Ok) { printf("%s:%u Failed to fill array (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(checkArray(lpArray, lpPool, AGGREGATE_LARGE, 1, __LINE__) != 0) { return 1; }
+	cjsonReleaseValue(lpArray);
+
+	/* A single page is split into several ranges */
+	cjsonArray_CreateSized(&lpArray, AGGREGATE_LARGE, NULL);
+	if((e = fillArray(lpArray, AGGREGATE_LARGE, 0)) != cjsonE_Ok) { printf("%s:%u Failed to fill array (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if(checkArray(lpArray, lpPool, AGGREGATE_LARGE, 0, __LINE__) != 0) { return 1; }
+	cjsonReleaseValue(lpArray);
+
+	/* The chunk table comes from the system API of the array */
+	e = cjsonProfiler_Create(&lpProfiler, 1, NULL);
+	if(e != cjsonE_Ok) { printf("%s:%u Failed to create profiler (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	cjsonArray_CreateSized(&lpArray, AGGREGATE_LARGE, cjsonProfiler_System(lpProfiler));
+	if((e = fillArray(lpArray, AGGREGATE_LARGE, 0)) != cjsonE_Ok) { printf("%s:%u Failed to fill array (code %u)\n", __FILE__, __LINE__, e); return 1; }
+	if((cjsonArray_Sum(lpArray, lpPool, &dResult) != cjsonE_Ok) || (dResult != (double)AGGREGATE_LARGE * (AGGREGATE_LARGE - 1) / 2)) { printf("%s:%u Sum is wrong\n", __FILE__, __LINE__); return 1; }
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.sites[cjsonAllocSite__Other].qwFrees == 0) { printf("%s:%u Chunk table bypassed the system API\n", __FILE__, __LINE__); return 1; }
+	cjsonReleaseValue(lpArray);
+	cjsonProfiler_GetStats(lpProfiler, &stats);
+	if(stats.qwLiveBytes != 0) { printf("%s:%u %lu bytes still allocated after release\n", __FILE__, __LINE__, (unsigned long int)stats.qwLiveBytes); return 1; }
+	cjsonProfiler_Release(lpProfiler);
+
+	cjsonWorkerPool_Release(lpPool);
+
+	printf("%s:%u Done successfully\n", __FILE__, __LINE__);
+	return 0;
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
@@ -0,0 +1,270 @@
+/* Generated by cjsongen from test012_Codegen.schema, do not edit */
+#include "test012_Codegen_gen.h"
+#include <string.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+enum cjsonError point_Read(
+	struct cjsonReader* lpReader,
+	struct point* lpOut
+) {
+	enum cjsonError e;
+	unsigned long int dwIndex = 0;
+	const char* lpKey;
+	unsigned long int dwKeyLength;
+	uint32_t dwKeyHash;
+
+	memset(lpOut, 0, sizeof(struct point));
+	for(;;) {
+		e = cjsonReader_ObjectNext(lpReader, &dwIndex, &lpKey, &dwKeyLength, &dwKeyHash);
+		if(e == cjsonE_Finished) { return cjsonE_Ok; }
+		if(e != cjsonE_Ok) { return e; }
+
+		/* null is treated like a missing field */
+		if(cjsonReader_IsNull(lpReader) != 0) { continue; }
+
+		switch(dwKeyHash) {
+			case 0xfc0c4ef4U:
+				if((dwKeyLength == 1) && (memcmp(lpKey, "y", 1) == 0)) {
+					e = cjsonReader_Double(lpReader, &(lpOut->y));
+					if(e != cjsonE_Ok) { return e; }
+					lpOut->qwPresent = lpOut->qwPresent | POINT_FIELD_Y;
+					continue;
+				}
+				break;
+			case 0xfd0c5087U:
+				if((dwKeyLength == 1) && (memcmp(lpKey, "x", 1) == 0)) {
+					e = cjsonReader_Double(lpReader, &(lpOut->x));
+					if(e != cjsonE_Ok) { return e; }
+					lpOut->qwPresent = lpOut->qwPresent | POINT_FIELD_X;
+					continue;
+				}
+				break;
+			default:
+				break;
+		}
+
+		/* Unknown key */
+		e = cjsonReader_Skip(lpReader);
+		if(e != cjsonE_Ok) { return e; }
+	}
+}
+enum cjsonError point_Parse(
+	struct point* lpOut,
+	const char* lpData,
+	unsigned long int dwLength
+) {
+	struct cjsonReader reader;
+	enum cjsonError e;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	if((lpData == NULL) && (dwLength > 0)) { return cjsonE_InvalidParam; }
+
+	cjsonReader_Init(&reader, lpData, dwLength);
+	e = point_Read(&reader, lpOut);
+	if(e != cjsonE_Ok) { return e; }
+	return cjsonReader_Finish(&reader);
+}
+void point_Write(
+	struct cjsonWriter* lpWriter,
+	const struct point* lpIn
+) {
+	cjsonWriter_Raw(lpWriter, "{\"x\":", 5);
+	cjsonWriter_Double(lpWriter, lpIn->x);
+	cjsonWriter_Raw(lpWriter, ",\"y\":", 5);
+	cjsonWriter_Double(lpWriter, lpIn->y);
+	cjsonWriter_Raw(lpWriter, "}", 1);
+}
+enum cjsonError point_Serialize(
+	const struct point* lpIn,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam
+) {
+	struct cjsonWriter writer;
+
+	if(lpIn == NULL) { return cjsonE_InvalidParam; }
+
+	cjsonWriter_Init(&writer, callback, callbackFreeParam);
+	point_Write(&writer, lpIn);
+	return cjsonWriter_Flush(&writer);
+}
+
+enum cjsonError request_Read(
+	struct cjsonReader* lpReader,
+	struct request* lpOut
+) {
+	enum cjsonError e;
+	unsigned long int dwIndex = 0;
+	unsigned long int dwElement;
+	const char* lpKey;
+	unsigned long int dwKeyLength;
+	uint32_t dwKeyHash;
+
+	memset(lpOut, 0, sizeof(struct request));
+	for(;;) {
+		e = cjsonReader_ObjectNext(lpReader, &dwIndex, &lpKey, &dwKeyLength, &dwKeyHash);
+		if(e == cjsonE_Finished) { return cjsonE_Ok; }
+		if(e != cjsonE_Ok) { return e; }
+
+		/* null is treated like a missing field */
+		if(cjsonReader_IsNull(lpReader) != 0) { continue; }
+
+		switch(dwKeyHash) {
+			case 0x0b44452aU:
+				if((dwKeyLength == 5) && (memcmp(lpKey, "price", 5) == 0)) {
+					e = cjsonReader_Double(lpReader, &(lpOut->price));
+					if(e != cjsonE_Ok) { return e; }
+					lpOut->qwPresent = lpOut->qwPresent | REQUEST_FIELD_PRICE;
+					continue;
+				}
+				break;
+			case 0x37386ae0U:
+				if((dwKeyLength == 2) && (memcmp(lpKey, "id", 2) == 0)) {
+					e = cjsonReader_ULong(lpReader, &(lpOut->id));
+					if(e != cjsonE_Ok) { return e; }
+					lpOut->qwPresent = lpOut->qwPresent | REQUEST_FIELD_ID;
+					continue;
+				}
+				break;
+			case 0x5c26f3bcU:
+				if((dwKeyLength == 7) && (memcmp(lpKey, "samples", 7) == 0)) {
+					dwElement = 0;
+					for(;;) {
+						e = cjsonReader_ArrayNext(lpReader, &dwElement);
+						if(e == cjsonE_Finished) { break; }
+						if(e != cjsonE_Ok) { return e; }
+						if(dwElement > 8) { return cjsonE_IndexOutOfBounds; }
+						e = cjsonReader_Double(lpReader, &(lpOut->samples[dwElement - 1]));
+						if(e != cjsonE_Ok) { return e; }
+					}
+					lpOut->samplesCount = dwElement;
+					lpOut->qwPresent = lpOut->qwPresent | REQUEST_FIELD_SAMPLES;
+					continue;
+				}
+				break;
+			case 0x6b017c21U:
+				if((dwKeyLength == 5) && (memcmp(lpKey, "delta", 5) == 0)) {
+					e = cjsonReader_SLong(lpReader, &(lpOut->delta));
+					if(e != cjsonE_Ok) { return e; }
+					lpOut->qwPresent = lpOut->qwPresent | REQUEST_FIELD_DELTA;
+					continue;
+				}
+				break;
+			case 0x8d39bde6U:
+				if((dwKeyLength == 4) && (memcmp(lpKey, "name", 4) == 0)) {
+					e = cjsonReader_String(lpReader, lpOut->name, sizeof(lpOut->name), &(lpOut->nameLength));
+					if(e != cjsonE_Ok) { return e; }
+					lpOut->qwPresent = lpOut->qwPresent | REQUEST_FIELD_NAME;
+					continue;
+				}
+				break;
+			case 0x9c677a2cU:
+				if((dwKeyLength == 5) && (memcmp(lpKey, "flags", 5) == 0)) {
+					dwElement = 0;
+					for(;;) {
+						e = cjsonReader_ArrayNext(lpReader, &dwElement);
+						if(e == cjsonE_Finished) { break; }
+						if(e != cjsonE_Ok) { return e; }
+						if(dwElement > 4) { return cjsonE_IndexOutOfBounds; }
+						e = cjsonReader_Bool(lpReader, &(lpOut->flags[dwElement - 1]));
+						if(e != cjsonE_Ok) { return e; }
+					}
+					lpOut->flagsCount = dwElement;
+					lpOut->qwPresent = lpOut->qwPresent | REQUEST_FIELD_FLAGS;
+					continue;
+				}
+				break;
+			case 0xd975992fU:
+				if((dwKeyLength == 6) && (memcmp(lpKey, "active", 6) == 0)) {
+					e = cjsonReader_Bool(lpReader, &(lpOut->active));
+					if(e != cjsonE_Ok) { return e; }
+					lpOut->qwPresent = lpOut->qwPresent | REQUEST_FIELD_ACTIVE;
+					continue;
+				}
+				break;
+			case 0xd97f9a4fU:
+				if((dwKeyLength == 6) && (memcmp(lpKey, "origin", 6) == 0)) {
+					e = point_Read(lpReader, &(lpOut->origin));
+					if(e != cjsonE_Ok) { return e; }
+					lpOut->qwPresent = lpOut->qwPresent | REQUEST_FIELD_ORIGIN;
+					continue;
+				}
+				break;
+			default:
+				break;
+		}
+
+		/* Unknown key */
+		e = cjsonReader_Skip(lpReader);
+		if(e != cjsonE_Ok) { return e; }
+	}
+}
+enum cjsonError request_Parse(
+	struct request* lpOut,
+	const char* lpData,
+	unsigned long int dwLength
+) {
+	struct cjsonReader reader;
+	enum cjsonError e;
+
+	if(lpOut == NULL) { return cjsonE_InvalidParam; }
+	if((lpData == NULL) && (dwLength > 0)) { return cjsonE_InvalidParam; }
+
+	cjsonReader_Init(&reader, lpData, dwLength);
+	e = request_Read(&reader, lpOut);
+	if(e != cjsonE_Ok) { return e; }
+	return cjsonReader_Finish(&reader);
+}
+void request_Write(
+	struct cjsonWriter* lpWriter,
+	const struct request* lpIn
+) {
+	unsigned long int i;
+
+	cjsonWriter_Raw(lpWriter, "{\"id\":", 6);
+	cjsonWriter_ULong(lpWriter, lpIn->id);
+	cjsonWriter_Raw(lpWriter, ",\"delta\":", 9);
+	cjsonWriter_SLong(lpWriter, lpIn->delta);
+	cjsonWriter_Raw(lpWriter, ",\"price\":", 9);
+	cjsonWriter_Double(lpWriter, lpIn->price);
+	cjsonWriter_Raw(lpWriter, ",\"active\":", 10);
+	cjsonWriter_Bool(lpWriter, lpIn->active);
+	cjsonWriter_Raw(lpWriter, ",\"name\":", 8);
+	cjsonWriter_String(lpWriter, lpIn->name, (lpIn->nameLength < sizeof(lpIn->name)) ? lpIn->nameLength : sizeof(lpIn->name) - 1);
+	cjsonWriter_Raw(lpWriter, ",\"origin\":", 10);
+	point_Write(lpWriter, &(lpIn->origin));
+	cjsonWriter_Raw(lpWriter, ",\"samples\":", 11);
+	cjsonWriter_Raw(lpWriter, "[", 1);
+	for(i = 0; (i < lpIn->samplesCount) && (i < 8); i=i+1) {
+		if(i > 0) { cjsonWriter_Raw(lpWriter, ",", 1); }
+		cjsonWriter_Double(lpWriter, lpIn->samples[i]);
+	}
+	cjsonWriter_Raw(lpWriter, "]", 1);
+	cjsonWriter_Raw(lpWriter, ",\"flags\":", 9);
+	cjsonWriter_Raw(lpWriter, "[", 1);
+	for(i = 0; (i < lpIn->flagsCount) && (i < 4); i=i+1) {
+		if(i > 0) { cjsonWriter_Raw(lpWriter, ",", 1); }
+		cjsonWriter_Bool(lpWriter, lpIn->flags[i]);
+	}
+	cjsonWriter_Raw(lpWriter, "]", 1);
+	cjsonWriter_Raw(lpWriter, "}", 1);
+}
+enum cjsonError request_Serialize(
+	const struct request* lpIn,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam
+) {
+	struct cjsonWriter writer;
+
+	if(lpIn == NULL) { return cjsonE_InvalidParam; }
+
+	cjsonWriter_Init(&writer, callback, callbackFreeParam);
+	request_Write(&writer, lpIn);
+	return cjsonWriter_Flush(&writer);
+}
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
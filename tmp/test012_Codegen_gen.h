@@ -0,0 +1,86 @@
+/* Generated by cjsongen from test012_Codegen.schema, do not edit */
+#ifndef __is_included__cjsongen_test012_Codegen_gen
+#define __is_included__cjsongen_test012_Codegen_gen 1
+
+#include "../include/cjson.h"
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+struct point {
+	double x;
+	double y;
+
+	uint64_t qwPresent;	/* POINT_FIELD_* of all fields that have been parsed and were not null */
+};
+#define POINT_FIELD_X 0x0000000000000001ULL
+#define POINT_FIELD_Y 0x0000000000000002ULL
+
+enum cjsonError point_Parse(
+	struct point* lpOut,
+	const char* lpData,
+	unsigned long int dwLength
+);
+enum cjsonError point_Read(
+	struct cjsonReader* lpReader,
+	struct point* lpOut
+);
+enum cjsonError point_Serialize(
+	const struct point* lpIn,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam
+);
+void point_Write(
+	struct cjsonWriter* lpWriter,
+	const struct point* lpIn
+);
+
+struct request {
+	unsigned long int id;
+	signed long int delta;
+	double price;
+	int active;
+	char name[33];
+	unsigned long int nameLength;
+	struct point origin;
+	double samples[8];
+	unsigned long int samplesCount;
+	int flags[4];
+	unsigned long int flagsCount;
+
+	uint64_t qwPresent;	/* REQUEST_FIELD_* of all fields that have been parsed and were not null */
+};
+#define REQUEST_FIELD_ID 0x0000000000000001ULL
+#define REQUEST_FIELD_DELTA 0x0000000000000002ULL
+#define REQUEST_FIELD_PRICE 0x0000000000000004ULL
+#define REQUEST_FIELD_ACTIVE 0x0000000000000008ULL
+#define REQUEST_FIELD_NAME 0x0000000000000010ULL
+#define REQUEST_FIELD_ORIGIN 0x0000000000000020ULL
+#define REQUEST_FIELD_SAMPLES 0x0000000000000040ULL
+#define REQUEST_FIELD_FLAGS 0x0000000000000080ULL
+
+enum cjsonError request_Parse(
+	struct request* lpOut,
+	const char* lpData,
+	unsigned long int dwLength
+);
+enum cjsonError request_Read(
+	struct cjsonReader* lpReader,
+	struct request* lpOut
+);
+enum cjsonError request_Serialize(
+	const struct request* lpIn,
+	cjsonSerializer_Callback_WriteBytes callback,
+	void* callbackFreeParam
+);
+void request_Write(
+	struct cjsonWriter* lpWriter,
+	const struct request* lpIn
+);
+
+#ifdef __cplusplus
+	} /* extern "C" { */
+#endif
+
+#endif /* #ifndef __is_included__cjsongen_test012_Codegen_gen */
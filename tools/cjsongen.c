@@ -0,0 +1,563 @@
+/*
+	cjsongen - generates specialized parsers and serializers for
+	fixed shape JSON documents from a schema description.
+
+	Usage: cjsongen <schema> <output basename> [cjson.h include path]
+
+	Writes <output basename>.h and <output basename>.c. The schema
+	lists structures with one field per line:
+
+		# Comment
+		struct point
+			x double
+			y double
+		end
+
+		struct request
+			id uint
+			delta int
+			price double
+			active bool
+			name string 64
+			origin point
+			samples double[16]
+		end
+
+	Field types are uint (unsigned long int), int (signed long int),
+	double, bool (int), string <maximum length>, the name of a
+	previously defined structure and fixed capacity arrays of the
+	scalar types (uint[N], int[N], double[N], bool[N]). Field names are
+	used as JSON keys and C member names.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "../include/cjson.h"
+
+#define CJSONGEN_MAXNAME 64
+#define CJSONGEN_MAXFIELDS 64					/* One presence bit per field */
+#define CJSONGEN_MAXSTRUCTS 256
+#define CJSONGEN_MAXLINE 1024
+
+enum cjsongenType {
+	cjsongenType_ULong,
+	cjsongenType_SLong,
+	cjsongenType_Double,
+	cjsongenType_Bool,
+	cjsongenType_String,
+	cjsongenType_Struct
+};
+
+struct cjsongenField {
+	char									bName[CJSONGEN_MAXNAME];
+	enum cjsongenType						type;
+	unsigned long int						dwCapacity;		/* Maximum string length or array capacity */
+	int										bArray;
+	unsigned long int						dwStruct;		/* Index of the nested structure */
+	uint32_t								dwHash;
+};
+struct cjsongenStruct {
+	char									bName[CJSONGEN_MAXNAME];
+	struct cjsongenField					fields[CJSONGEN_MAXFIELDS];
+	unsigned long int						dwFieldCount;
+};
+struct cjsongenSchema {
+	struct cjsongenStruct					structs[CJSONGEN_MAXSTRUCTS];
+	unsigned long int						dwStructCount;
+};
+
+static const char* cjsongen_Keywords[] = {
+	"auto", "break", "case", "char", "const", "continue", "default", "do", "double", "else", "enum",
+	"extern", "float", "for", "goto", "if", "inline", "int", "long", "register", "restrict", "return",
+	"short", "signed", "sizeof", "static", "struct", "switch", "typedef", "union", "unsigned", "void",
+	"volatile", "while", "qwPresent", NULL
+};
+
+static int cjsongen_IsIdentifier(
+	const char* lpName
+) {
+	unsigned long int i;
+
+	if((lpName[0] == 0) || (strlen(lpName) >= CJSONGEN_MAXNAME - 8)) { return 0; }
+	if(!(isalpha((unsigned char)lpName[0]) || (lpName[0] == '_'))) { return 0; }
+	for(i = 1; lpName[i] != 0; i=i+1) {
+		if(!(isalnum((unsigned char)lpName[i]) || (lpName[i] == '_'))) { return 0; }
+	}
+	for(i = 0; cjsongen_Keywords[i] != NULL; i=i+1) {
+		if(strcmp(lpName, cjsongen_Keywords[i]) == 0) { return 0; }
+	}
+	return 1;
+}
+static void cjsongen_Upper(
+	char* lpOut,
+	const char* lpName
+) {
+	unsigned long int i;
+
+	for(i = 0; lpName[i] != 0; i=i+1) { lpOut[i] = (char)toupper((unsigned char)lpName[i]); }
+	lpOut[i] = 0;
+}
+static long int cjsongen_FindStruct(
+	const struct cjsongenSchema* lpSchema,
+	const char* lpName
+) {
+	unsigned long int i;
+
+	for(i = 0; i < lpSchema->dwStructCount; i=i+1) {
+		if(strcmp(lpSchema->structs[i].bName, lpName) == 0) { return (long int)i; }
+	}
+	return -1;
+}
+
+/*
+	Generated member names of a field (the field itself and its
+	length or count member) must not collide within a structure
+*/
+static int cjsongen_MemberExists(
+	const struct cjsongenStruct* lpStruct,
+	const char* lpMember
+) {
+	unsigned long int i;
+	char bMember[CJSONGEN_MAXNAME + 8];
+
+	for(i = 0; i < lpStruct->dwFieldCount; i=i+1) {
+		if(strcmp(lpStruct->fields[i].bName, lpMember) == 0) { return 1; }
+		if((lpStruct->fields[i].type == cjsongenType_String) || (lpStruct->fields[i].bArray != 0)) {
+			sprintf(bMember, "%s%s", lpStruct->fields[i].bName, (lpStruct->fields[i].bArray != 0) ? "Count" : "Length");
+			if(strcmp(bMember, lpMember) == 0) { return 1; }
+		}
+	}
+	return 0;
+}
+
+static int cjsongen_ParseField(
+	struct cjsongenSchema* lpSchema,
+	struct cjsongenStruct* lpStruct,
+	char* lpTokens[],
+	unsigned long int dwTokens,
+	const char* lpFile,
+	unsigned long int dwLine
+) {
+	struct cjsongenField* lpField;
+	char bType[CJSONGEN_MAXNAME];
+	char bMember[CJSONGEN_MAXNAME + 8];
+	char* lpBracket;
+	char* lpEnd;
+	long int iStruct;
+
+	if(lpStruct->dwFieldCount >= CJSONGEN_MAXFIELDS) { fprintf(stderr, "%s:%lu: too many fields in %s\n", lpFile, dwLine, lpStruct->bName); return 0; }
+	if((dwTokens < 2) || (dwTokens > 3)) { fprintf(stderr, "%s:%lu: expected <name> <type>\n", lpFile, dwLine); return 0; }
+	if(cjsongen_IsIdentifier(lpTokens[0]) == 0) { fprintf(stderr, "%s:%lu: invalid field name %s\n", lpFile, dwLine, lpTokens[0]); return 0; }
+	if(strlen(lpTokens[1]) >= CJSONGEN_MAXNAME) { fprintf(stderr, "%s:%lu: invalid type %s\n", lpFile, dwLine, lpTokens[1]); return 0; }
+
+	lpField = &(lpStruct->fields[lpStruct->dwFieldCount]);
+	strcpy(lpField->bName, lpTokens[0]);
+	lpField->dwCapacity = 0;
+	lpField->bArray = 0;
+	lpField->dwStruct = 0;
+	lpField->dwHash = cjsonReader_HashKey(lpField->bName, strlen(lpField->bName));
+
+	strcpy(bType, lpTokens[1]);
+	lpBracket = strchr(bType, '[');
+	if(lpBracket != NULL) {
+		lpField->dwCapacity = strtoul(lpBracket + 1, &lpEnd, 10);
+		if((lpField->dwCapacity == 0) || (lpEnd[0] != ']') || (lpEnd[1] != 0)) { fprintf(stderr, "%s:%lu: invalid array capacity in %s\n", lpFile, dwLine, lpTokens[1]); return 0; }
+		lpField->bArray = 1;
+		(*lpBracket) = 0;
+	}
+
+	if(strcmp(bType, "uint") == 0) {
+		lpField->type = cjsongenType_ULong;
+	} else if(strcmp(bType, "int") == 0) {
+		lpField->type = cjsongenType_SLong;
+	} else if(strcmp(bType, "double") == 0) {
+		lpField->type = cjsongenType_Double;
+	} else if(strcmp(bType, "bool") == 0) {
+		lpField->type = cjsongenType_Bool;
+	} else if(strcmp(bType, "string") == 0) {
+		lpField->type = cjsongenType_String;
+		if(lpField->bArray != 0) { fprintf(stderr, "%s:%lu: arrays of strings are not supported\n", lpFile, dwLine); return 0; }
+		if(dwTokens != 3) { fprintf(stderr, "%s:%lu: string requires a maximum length\n", lpFile, dwLine); return 0; }
+		lpField->dwCapacity = strtoul(lpTokens[2], &lpEnd, 10);
+		if((lpField->dwCapacity == 0) || (lpEnd[0] != 0)) { fprintf(stderr, "%s:%lu: invalid string length %s\n", lpFile, dwLine, lpTokens[2]); return 0; }
+	} else {
+		iStruct = cjsongen_FindStruct(lpSchema, bType);
+		if(iStruct < 0) { fprintf(stderr, "%s:%lu: unknown type %s\n", lpFile, dwLine, bType); return 0; }
+		if(lpField->bArray != 0) { fprintf(stderr, "%s:%lu: arrays of structures are not supported\n", lpFile, dwLine); return 0; }
+		lpField->type = cjsongenType_Struct;
+		lpField->dwStruct = (unsigned long int)iStruct;
+	}
+	if((lpField->type != cjsongenType_String) && (dwTokens != 2)) { fprintf(stderr, "%s:%lu: unexpected %s\n", lpFile, dwLine, lpTokens[2]); return 0; }
+
+	if(cjsongen_MemberExists(lpStruct, lpField->bName) != 0) { fprintf(stderr, "%s:%lu: duplicate member %s\n", lpFile, dwLine, lpField->bName); return 0; }
+	if((lpField->type == cjsongenType_String) || (lpField->bArray != 0)) {
+		sprintf(bMember, "%s%s", lpField->bName, (lpField->bArray != 0) ? "Count" : "Length");
+		if(cjsongen_MemberExists(lpStruct, bMember) != 0) { fprintf(stderr, "%s:%lu: duplicate member %s\n", lpFile, dwLine, bMember); return 0; }
+	}
+
+	lpStruct->dwFieldCount = lpStruct->dwFieldCount + 1;
+	return 1;
+}
+
+static int cjsongen_ParseSchema(
+	struct cjsongenSchema* lpSchema,
+	const char* lpFile
+) {
+	FILE* fSchema;
+	char bLine[CJSONGEN_MAXLINE];
+	char* lpTokens[4];
+	unsigned long int dwTokens;
+	unsigned long int dwLine = 0;
+	struct cjsongenStruct* lpStruct = NULL;
+	char* lpToken;
+	int bOk = 1;
+
+	fSchema = fopen(lpFile, "r");
+	if(fSchema == NULL) { fprintf(stderr, "%s: can't open schema\n", lpFile); return 0; }
+
+	lpSchema->dwStructCount = 0;
+	while((bOk != 0) && (fgets(bLine, sizeof(bLine), fSchema) != NULL)) {
+		dwLine = dwLine + 1;
+		if(strchr(bLine, '#') != NULL) { (*strchr(bLine, '#')) = 0; }
+
+		dwTokens = 0;
+		for(lpToken = strtok(bLine, " \t\r\n"); lpToken != NULL; lpToken = strtok(NULL, " \t\r\n")) {
+			if(dwTokens == 4) { fprintf(stderr, "%s:%lu: too many tokens\n", lpFile, dwLine); bOk = 0; break; }
+			lpTokens[dwTokens] = lpToken;
+			dwTokens = dwTokens + 1;
+		}
+		if((bOk == 0) || (dwTokens == 0)) { continue; }
+
+		if(strcmp(lpTokens[0], "struct") == 0) {
+			if(lpStruct != NULL) { fprintf(stderr, "%s:%lu: nested struct definition\n", lpFile, dwLine); bOk = 0; continue; }
+			if((dwTokens != 2) || (cjsongen_IsIdentifier(lpTokens[1]) == 0)) { fprintf(stderr, "%s:%lu: expected struct <name>\n", lpFile, dwLine); bOk = 0; continue; }
+			if(cjsongen_FindStruct(lpSchema, lpTokens[1]) >= 0) { fprintf(stderr, "%s:%lu: duplicate struct %s\n", lpFile, dwLine, lpTokens[1]); bOk = 0; continue; }
+			if(lpSchema->dwStructCount >= CJSONGEN_MAXSTRUCTS) { fprintf(stderr, "%s:%lu: too many structures\n", lpFile, dwLine); bOk = 0; continue; }
+
+			lpStruct = &(lpSchema->structs[lpSchema->dwStructCount]);
+			strcpy(lpStruct->bName, lpTokens[1]);
+			lpStruct->dwFieldCount = 0;
+		} else if(strcmp(lpTokens[0], "end") == 0) {
+			if((lpStruct == NULL) || (dwTokens != 1)) { fprintf(stderr, "%s:%lu: unexpected end\n", lpFile, dwLine); bOk = 0; continue; }
+			lpSchema->dwStructCount = lpSchema->dwStructCount + 1;
+			lpStruct = NULL;
+		} else {
+			if(lpStruct == NULL) { fprintf(stderr, "%s:%lu: field outside of a structure\n", lpFile, dwLine); bOk = 0; continue; }
+			bOk = cjsongen_ParseField(lpSchema, lpStruct, lpTokens, dwTokens, lpFile, dwLine);
+		}
+	}
+	fclose(fSchema);
+
+	if((bOk != 0) && (lpStruct != NULL)) { fprintf(stderr, "%s: missing end of %s\n", lpFile, lpStruct->bName); bOk = 0; }
+	if((bOk != 0) && (lpSchema->dwStructCount == 0)) { fprintf(stderr, "%s: no structures defined\n", lpFile); bOk = 0; }
+	return bOk;
+}
+
+/*
+	Code emission
+*/
+static const char* cjsongen_CType(
+	enum cjsongenType type
+) {
+	switch(type) {
+		case cjsongenType_ULong:	return "unsigned long int";
+		case cjsongenType_SLong:	return "signed long int";
+		case cjsongenType_Double:	return "double";
+		case cjsongenType_Bool:		return "int";
+		default:					return "char";
+	}
+}
+static const char* cjsongen_ReaderFunction(
+	enum cjsongenType type
+) {
+	switch(type) {
+		case cjsongenType_ULong:	return "cjsonReader_ULong";
+		case cjsongenType_SLong:	return "cjsonReader_SLong";
+		case cjsongenType_Double:	return "cjsonReader_Double";
+		default:					return "cjsonReader_Bool";
+	}
+}
+static const char* cjsongen_WriterFunction(
+	enum cjsongenType type
+) {
+	switch(type) {
+		case cjsongenType_ULong:	return "cjsonWriter_ULong";
+		case cjsongenType_SLong:	return "cjsonWriter_SLong";
+		case cjsongenType_Double:	return "cjsonWriter_Double";
+		default:					return "cjsonWriter_Bool";
+	}
+}
+
+static void cjsongen_EmitHeader(
+	FILE* fOut,
+	const struct cjsongenSchema* lpSchema,
+	const char* lpSchemaFile,
+	const char* lpGuard,
+	const char* lpInclude
+) {
+	const struct cjsongenStruct* lpStruct;
+	const struct cjsongenField* lpField;
+	char bUpperStruct[CJSONGEN_MAXNAME];
+	char bUpperField[CJSONGEN_MAXNAME];
+	unsigned long int i, j;
+
+	fprintf(fOut, "/* Generated by cjsongen from %s, do not edit */\n", lpSchemaFile);
+	fprintf(fOut, "#ifndef %s\n#define %s 1\n\n", lpGuard, lpGuard);
+	fprintf(fOut, "#include \"%s\"\n\n", lpInclude);
+	fprintf(fOut, "#ifdef __cplusplus\n\textern \"C\" {\n#endif\n\n");
+
+	for(i = 0; i < lpSchema->dwStructCount; i=i+1) {
+		lpStruct = &(lpSchema->structs[i]);
+		cjsongen_Upper(bUpperStruct, lpStruct->bName);
+
+		fprintf(fOut, "struct %s {\n", lpStruct->bName);
+		for(j = 0; j < lpStruct->dwFieldCount; j=j+1) {
+			lpField = &(lpStruct->fields[j]);
+			if(lpField->type == cjsongenType_String) {
+				fprintf(fOut, "\tchar %s[%lu];\n", lpField->bName, lpField->dwCapacity + 1);
+				fprintf(fOut, "\tunsigned long int %sLength;\n", lpField->bName);
+			} else if(lpField->type == cjsongenType_Struct) {
+				fprintf(fOut, "\tstruct %s %s;\n", lpSchema->structs[lpField->dwStruct].bName, lpField->bName);
+			} else if(lpField->bArray != 0) {
+				fprintf(fOut, "\t%s %s[%lu];\n", cjsongen_CType(lpField->type), lpField->bName, lpField->dwCapacity);
+				fprintf(fOut, "\tunsigned long int %sCount;\n", lpField->bName);
+			} else {
+				fprintf(fOut, "\t%s %s;\n", cjsongen_CType(lpField->type), lpField->bName);
+			}
+		}
+		fprintf(fOut, "\n\tuint64_t qwPresent;\t/* %s_FIELD_* of all fields that have been parsed and were not null */\n};\n", bUpperStruct);
+		for(j = 0; j < lpStruct->dwFieldCount; j=j+1) {
+			cjsongen_Upper(bUpperField, lpStruct->fields[j].bName);
+			fprintf(fOut, "#define %s_FIELD_%s 0x%016llxULL\n", bUpperStruct, bUpperField, 1ULL << j);
+		}
+		fprintf(fOut, "\n");
+
+		fprintf(fOut, "enum cjsonError %s_Parse(\n\tstruct %s* lpOut,\n\tconst char* lpData,\n\tunsigned long int dwLength\n);\n", lpStruct->bName, lpStruct->bName);
+		fprintf(fOut, "enum cjsonError %s_Read(\n\tstruct cjsonReader* lpReader,\n\tstruct %s* lpOut\n);\n", lpStruct->bName, lpStruct->bName);
+		fprintf(fOut, "enum cjsonError %s_Serialize(\n\tconst struct %s* lpIn,\n\tcjsonSerializer_Callback_WriteBytes callback,\n\tvoid* callbackFreeParam\n);\n", lpStruct->bName, lpStruct->bName);
+		fprintf(fOut, "void %s_Write(\n\tstruct cjsonWriter* lpWriter,\n\tconst struct %s* lpIn\n);\n\n", lpStruct->bName, lpStruct->bName);
+	}
+
+	fprintf(fOut, "#ifdef __cplusplus\n\t} /* extern \"C\" { */\n#endif\n\n");
+	fprintf(fOut, "#endif /* #ifndef %s */\n", lpGuard);
+}
+
+static void cjsongen_EmitReadField(
+	FILE* fOut,
+	const struct cjsongenSchema* lpSchema,
+	const struct cjsongenStruct* lpStruct,
+	const struct cjsongenField* lpField
+) {
+	char bUpperStruct[CJSONGEN_MAXNAME];
+	char bUpperField[CJSONGEN_MAXNAME];
+
+	cjsongen_Upper(bUpperStruct, lpStruct->bName);
+	cjsongen_Upper(bUpperField, lpField->bName);
+
+	fprintf(fOut, "\t\t\t\tif((dwKeyLength == %lu) && (memcmp(lpKey, \"%s\", %lu) == 0)) {\n", (unsigned long int)strlen(lpField->bName), lpField->bName, (unsigned long int)strlen(lpField->bName));
+	if(lpField->type == cjsongenType_String) {
+		fprintf(fOut, "\t\t\t\t\te = cjsonReader_String(lpReader, lpOut->%s, sizeof(lpOut->%s), &(lpOut->%sLength));\n", lpField->bName, lpField->bName, lpField->bName);
+		fprintf(fOut, "\t\t\t\t\tif(e != cjsonE_Ok) { return e; }\n");
+	} else if(lpField->type == cjsongenType_Struct) {
+		fprintf(fOut, "\t\t\t\t\te = %s_Read(lpReader, &(lpOut->%s));\n", lpSchema->structs[lpField->dwStruct].bName, lpField->bName);
+		fprintf(fOut, "\t\t\t\t\tif(e != cjsonE_Ok) { return e; }\n");
+	} else if(lpField->bArray != 0) {
+		fprintf(fOut, "\t\t\t\t\tdwElement = 0;\n");
+		fprintf(fOut, "\t\t\t\t\tfor(;;) {\n");
+		fprintf(fOut, "\t\t\t\t\t\te = cjsonReader_ArrayNext(lpReader, &dwElement);\n");
+		fprintf(fOut, "\t\t\t\t\t\tif(e == cjsonE_Finished) { break; }\n");
+		fprintf(fOut, "\t\t\t\t\t\tif(e != cjsonE_Ok) { return e; }\n");
+		fprintf(fOut, "\t\t\t\t\t\tif(dwElement > %lu) { return cjsonE_IndexOutOfBounds; }\n", lpField->dwCapacity);
+		fprintf(fOut, "\t\t\t\t\t\te = %s(lpReader, &(lpOut->%s[dwElement - 1]));\n", cjsongen_ReaderFunction(lpField->type), lpField->bName);
+		fprintf(fOut, "\t\t\t\t\t\tif(e != cjsonE_Ok) { return e; }\n");
+		fprintf(fOut, "\t\t\t\t\t}\n");
+		fprintf(fOut, "\t\t\t\t\tlpOut->%sCount = dwElement;\n", lpField->bName);
+	} else {
+		fprintf(fOut, "\t\t\t\t\te = %s(lpReader, &(lpOut->%s));\n", cjsongen_ReaderFunction(lpField->type), lpField->bName);
+		fprintf(fOut, "\t\t\t\t\tif(e != cjsonE_Ok) { return e; }\n");
+	}
+	fprintf(fOut, "\t\t\t\t\tlpOut->qwPresent = lpOut->qwPresent | %s_FIELD_%s;\n", bUpperStruct, bUpperField);
+	fprintf(fOut, "\t\t\t\t\tcontinue;\n");
+	fprintf(fOut, "\t\t\t\t}\n");
+}
+
+static void cjsongen_EmitWriteField(
+	FILE* fOut,
+	const struct cjsongenSchema* lpSchema,
+	const struct cjsongenField* lpField,
+	int bFirst
+) {
+	char bKey[CJSONGEN_MAXNAME + 8];
+
+	sprintf(bKey, "%s\\\"%s\\\":", (bFirst != 0) ? "{" : ",", lpField->bName);
+	fprintf(fOut, "\tcjsonWriter_Raw(lpWriter, \"%s\", %lu);\n", bKey, (unsigned long int)strlen(lpField->bName) + 4);
+
+	if(lpField->type == cjsongenType_String) {
+		fprintf(fOut, "\tcjsonWriter_String(lpWriter, lpIn->%s, (lpIn->%sLength < sizeof(lpIn->%s)) ? lpIn->%sLength : sizeof(lpIn->%s) - 1);\n", lpField->bName, lpField->bName, lpField->bName, lpField->bName, lpField->bName);
+	} else if(lpField->type == cjsongenType_Struct) {
+		fprintf(fOut, "\t%s_Write(lpWriter, &(lpIn->%s));\n", lpSchema->structs[lpField->dwStruct].bName, lpField->bName);
+	} else if(lpField->bArray != 0) {
+		fprintf(fOut, "\tcjsonWriter_Raw(lpWriter, \"[\", 1);\n");
+		fprintf(fOut, "\tfor(i = 0; (i < lpIn->%sCount) && (i < %lu); i=i+1) {\n", lpField->bName, lpField->dwCapacity);
+		fprintf(fOut, "\t\tif(i > 0) { cjsonWriter_Raw(lpWriter, \",\", 1); }\n");
+		fprintf(fOut, "\t\t%s(lpWriter, lpIn->%s[i]);\n", cjsongen_WriterFunction(lpField->type), lpField->bName);
+		fprintf(fOut, "\t}\n");
+		fprintf(fOut, "\tcjsonWriter_Raw(lpWriter, \"]\", 1);\n");
+	} else {
+		fprintf(fOut, "\t%s(lpWriter, lpIn->%s);\n", cjsongen_WriterFunction(lpField->type), lpField->bName);
+	}
+}
+
+static int cjsongen_CompareHash(
+	const void* lpA,
+	const void* lpB
+) {
+	uint32_t dwA = (*(const struct cjsongenField* const*)lpA)->dwHash;
+	uint32_t dwB = (*(const struct cjsongenField* const*)lpB)->dwHash;
+
+	if(dwA == dwB) { return 0; }
+	return (dwA < dwB) ? -1 : 1;
+}
+
+static void cjsongen_EmitSource(
+	FILE* fOut,
+	const struct cjsongenSchema* lpSchema,
+	const char* lpSchemaFile,
+	const char* lpHeaderName
+) {
+	const struct cjsongenStruct* lpStruct;
+	const struct cjsongenField* lpSorted[CJSONGEN_MAXFIELDS];
+	unsigned long int i, j;
+	int bArrays;
+
+	fprintf(fOut, "/* Generated by cjsongen from %s, do not edit */\n", lpSchemaFile);
+	fprintf(fOut, "#include \"%s\"\n#include <string.h>\n\n", lpHeaderName);
+	fprintf(fOut, "#ifdef __cplusplus\n\textern \"C\" {\n#endif\n\n");
+
+	for(i = 0; i < lpSchema->dwStructCount; i=i+1) {
+		lpStruct = &(lpSchema->structs[i]);
+
+		bArrays = 0;
+		for(j = 0; j < lpStruct->dwFieldCount; j=j+1) {
+			if(lpStruct->fields[j].bArray != 0) { bArrays = 1; }
+			lpSorted[j] = &(lpStruct->fields[j]);
+		}
+
+		/* Fields with colliding key hashes share a case label */
+		qsort((void*)lpSorted, lpStruct->dwFieldCount, sizeof(lpSorted[0]), &cjsongen_CompareHash);
+
+		/* Reader */
+		fprintf(fOut, "enum cjsonError %s_Read(\n\tstruct cjsonReader* lpReader,\n\tstruct %s* lpOut\n) {\n", lpStruct->bName, lpStruct->bName);
+		fprintf(fOut, "\tenum cjsonError e;\n");
+		fprintf(fOut, "\tunsigned long int dwIndex = 0;\n");
+		if(bArrays != 0) { fprintf(fOut, "\tunsigned long int dwElement;\n"); }
+		fprintf(fOut, "\tconst char* lpKey;\n\tunsigned long int dwKeyLength;\n\tuint32_t dwKeyHash;\n\n");
+		fprintf(fOut, "\tmemset(lpOut, 0, sizeof(struct %s));\n", lpStruct->bName);
+		fprintf(fOut, "\tfor(;;) {\n");
+		fprintf(fOut, "\t\te = cjsonReader_ObjectNext(lpReader, &dwIndex, &lpKey, &dwKeyLength, &dwKeyHash);\n");
+		fprintf(fOut, "\t\tif(e == cjsonE_Finished) { return cjsonE_Ok; }\n");
+		fprintf(fOut, "\t\tif(e != cjsonE_Ok) { return e; }\n\n");
+		fprintf(fOut, "\t\t/* null is treated like a missing field */\n");
+		fprintf(fOut, "\t\tif(cjsonReader_IsNull(lpReader) != 0) { continue; }\n\n");
+		if(lpStruct->dwFieldCount > 0) {
+			fprintf(fOut, "\t\tswitch(dwKeyHash) {\n");
+			for(j = 0; j < lpStruct->dwFieldCount; j=j+1) {
+				if((j == 0) || (lpSorted[j]->dwHash != lpSorted[j-1]->dwHash)) {
+					fprintf(fOut, "\t\t\tcase 0x%08lxU:\n", (unsigned long int)lpSorted[j]->dwHash);
+				}
+				cjsongen_EmitReadField(fOut, lpSchema, lpStruct, lpSorted[j]);
+				if((j + 1 == lpStruct->dwFieldCount) || (lpSorted[j+1]->dwHash != lpSorted[j]->dwHash)) {
+					fprintf(fOut, "\t\t\t\tbreak;\n");
+				}
+			}
+			fprintf(fOut, "\t\t\tdefault:\n\t\t\t\tbreak;\n");
+			fprintf(fOut, "\t\t}\n\n");
+		}
+		fprintf(fOut, "\t\t/* Unknown key */\n");
+		fprintf(fOut, "\t\te = cjsonReader_Skip(lpReader);\n");
+		fprintf(fOut, "\t\tif(e != cjsonE_Ok) { return e; }\n");
+		fprintf(fOut, "\t}\n}\n");
+
+		fprintf(fOut, "enum cjsonError %s_Parse(\n\tstruct %s* lpOut,\n\tconst char* lpData,\n\tunsigned long int dwLength\n) {\n", lpStruct->bName, lpStruct->bName);
+		fprintf(fOut, "\tstruct cjsonReader reader;\n\tenum cjsonError e;\n\n");
+		fprintf(fOut, "\tif(lpOut == NULL) { return cjsonE_InvalidParam; }\n");
+		fprintf(fOut, "\tif((lpData == NULL) && (dwLength > 0)) { return cjsonE_InvalidParam; }\n\n");
+		fprintf(fOut, "\tcjsonReader_Init(&reader, lpData, dwLength);\n");
+		fprintf(fOut, "\te = %s_Read(&reader, lpOut);\n", lpStruct->bName);
+		fprintf(fOut, "\tif(e != cjsonE_Ok) { return e; }\n");
+		fprintf(fOut, "\treturn cjsonReader_Finish(&reader);\n}\n");
+
+		/* Writer */
+		fprintf(fOut, "void %s_Write(\n\tstruct cjsonWriter* lpWriter,\n\tconst struct %s* lpIn\n) {\n", lpStruct->bName, lpStruct->bName);
+		if(bArrays != 0) { fprintf(fOut, "\tunsigned long int i;\n\n"); }
+		for(j = 0; j < lpStruct->dwFieldCount; j=j+1) {
+			cjsongen_EmitWriteField(fOut, lpSchema, &(lpStruct->fields[j]), (j == 0) ? 1 : 0);
+		}
+		if(lpStruct->dwFieldCount == 0) {
+			fprintf(fOut, "\tcjsonWriter_Raw(lpWriter, \"{}\", 2);\n}\n");
+		} else {
+			fprintf(fOut, "\tcjsonWriter_Raw(lpWriter, \"}\", 1);\n}\n");
+		}
+
+		fprintf(fOut, "enum cjsonError %s_Serialize(\n\tconst struct %s* lpIn,\n\tcjsonSerializer_Callback_WriteBytes callback,\n\tvoid* callbackFreeParam\n) {\n", lpStruct->bName, lpStruct->bName);
+		fprintf(fOut, "\tstruct cjsonWriter writer;\n\n");
+		fprintf(fOut, "\tif(lpIn == NULL) { return cjsonE_InvalidParam; }\n\n");
+		fprintf(fOut, "\tcjsonWriter_Init(&writer, callback, callbackFreeParam);\n");
+		fprintf(fOut, "\t%s_Write(&writer, lpIn);\n", lpStruct->bName);
+		fprintf(fOut, "\treturn cjsonWriter_Flush(&writer);\n}\n\n");
+	}
+
+	fprintf(fOut, "#ifdef __cplusplus\n\t} /* extern \"C\" { */\n#endif\n");
+}
+
+int main(int argc, char* argv[]) {
+	static struct cjsongenSchema schema;
+	char* lpFileName;
+	char* lpBaseName;
+	char* lpGuard;
+	const char* lpInclude;
+	FILE* fOut;
+	unsigned long int i;
+
+	if((argc < 3) || (argc > 4)) {
+		fprintf(stderr, "Usage: %s <schema> <output basename> [cjson.h include path]\n", argv[0]);
+		return 1;
+	}
+	lpInclude = (argc == 4) ? argv[3] : "cjson.h";
+
+	if(cjsongen_ParseSchema(&schema, argv[1]) == 0) { return 1; }
+
+	lpFileName = (char*)malloc(strlen(argv[2]) + 3);
+	lpGuard = (char*)malloc(strlen(argv[2]) + 32);
+	if((lpFileName == NULL) || (lpGuard == NULL)) { fprintf(stderr, "Out of memory\n"); return 1; }
+
+	/* Include guard and header name are derived from the file name without directories */
+	lpBaseName = argv[2];
+	for(i = 0; argv[2][i] != 0; i=i+1) {
+		if((argv[2][i] == '/') || (argv[2][i] == '\\')) { lpBaseName = &(argv[2][i+1]); }
+	}
+	strcpy(lpGuard, "__is_included__cjsongen_");
+	for(i = 0; lpBaseName[i] != 0; i=i+1) {
+		lpGuard[24 + i] = isalnum((unsigned char)lpBaseName[i]) ? lpBaseName[i] : '_';
+	}
+	lpGuard[24 + i] = 0;
+
+	sprintf(lpFileName, "%s.h", argv[2]);
+	fOut = fopen(lpFileName, "w");
+	if(fOut == NULL) { fprintf(stderr, "%s: can't create file\n", lpFileName); return 1; }
+	cjsongen_EmitHeader(fOut, &schema, argv[1], lpGuard, lpInclude);
+	if(fclose(fOut) != 0) { fprintf(stderr, "%s: write failed\n", lpFileName); return 1; }
+
+	sprintf(lpFileName, "%s.c", argv[2]);
+	fOut = fopen(lpFileName, "w");
+	if(fOut == NULL) { fprintf(stderr, "%s: can't create file\n", lpFileName); return 1; }
+	sprintf(lpGuard, "%s.h", lpBaseName);
+	cjsongen_EmitSource(fOut, &schema, argv[1], lpGuard);
+	if(fclose(fOut) != 0) { fprintf(stderr, "%s: write failed\n", lpFileName); return 1; }
+
+	free(lpFileName);
+	free(lpGuard);
+	return 0;
+}